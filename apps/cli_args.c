@@ -146,6 +146,7 @@ static const char *sdr_type_str(sdr_backend_type_t t)
     switch (t) {
         case SDR_TYPE_UHD:    return "uhd (B2xx)";
         case SDR_TYPE_RTLSDR: return "rtl-sdr";
+        case SDR_TYPE_FILE:   return "file (replay / synthetic bursts)";
         case SDR_TYPE_AUTO:   /* fall through */
         default:              return "auto (probe UHD, then RTL-SDR)";
     }
@@ -237,6 +238,12 @@ void self_test_report(const state_t *state, FILE *out, int argc, char **argv)
     fprintf(out, "downlink-nominal-mhz: %.6f\n",
             state->track.nominal_downlink_frequency_hz / 1e6);
     fprintf(out, "rx-lo-offset-khz: %+.3f\n", state->sdr.rx_lo_offset_hz / 1000.0);
+    fprintf(out, "iq-recording: %s\n", state->sdr.raw_iq ? ".iq (--raw-iq)" : ".sso-iq");
+    fprintf(out, "rx-burst-gate: %s\n", state->sdr.no_burst_gate ? "off (--no-burst-gate)" : "on");
+    for (int k = 0; k < state->sdr.n_rx_channels; k++) {
+        fprintf(out, "rx-channel: %s @ %.6f MHz\n",
+                state->sdr.rx_channels[k].name, state->sdr.rx_channels[k].freq_hz / 1e6);
+    }
 
     // TX safety / staging gates the operator might have set.
     fprintf(out, "tx-no-tx: %s\n", state->tx.no_tx ? "on (--no-tx)" : "off");
@@ -271,6 +278,24 @@ void self_test_report(const state_t *state, FILE *out, int argc, char **argv)
     }
 
     fprintf(out, "sdr-type: %s\n", sdr_type_str(state->sdr.sdr_type));
+    if (state->sdr.rtl_xfers == 0)
+        fprintf(out, "rtl-usb: default (32 x 64 KiB)\n");
+    else if (state->sdr.rtl_xfer_kib == 0)
+        fprintf(out, "rtl-usb: %d x 64 KiB\n", state->sdr.rtl_xfers);
+    else
+        fprintf(out, "rtl-usb: %d x %d KiB\n", state->sdr.rtl_xfers, state->sdr.rtl_xfer_kib);
+    if (state->sdr.sdr_type == SDR_TYPE_FILE) {
+        const sdr_replay_params_t *rp = &state->sdr.replay;
+        char speed[32], noise[32];
+        if (rp->speed == 0.0) snprintf(speed, sizeof speed, "max");
+        else                  snprintf(speed, sizeof speed, "%gx", rp->speed);
+        if (rp->noise_dbfs < 0.0) snprintf(noise, sizeof noise, "%.1f dBFS", rp->noise_dbfs);
+        else                      snprintf(noise, sizeof noise, "none");
+        fprintf(out, "replay: %s, speed %s%s, noise %s, doppler %+.0f Hz %+.1f Hz/s\n",
+                state->sdr.replay_path[0] ? state->sdr.replay_path : "synthetic bursts",
+                speed, rp->once ? ", once" : "", noise,
+                rp->doppler_hz, rp->doppler_rate_hz_s);
+    }
 #ifdef SSO_WITH_SDR
     if (state->sdr.rx_session) {
         double actual_freq_hz = 0.0;
@@ -471,6 +496,7 @@ int apply_args(state_t *state, int argc, char **argv, double jul_utc, int help)
         // swing stays inside the 48 kHz post-decim half-band.
         state->sdr.rx_lo_offset_hz = -25000.0;
         state->sdr.rx_gain_db      = 30.0;
+        state->sdr.replay.speed    = 1.0;
         // AD9361 background tracking. The visible ~51 Hz comb of impulsive
         // spikes at mid-range gain is from the IQ-balance loop (discrete
         // phase-rotation steps applied to the captured IQ); the DC-offset
@@ -612,13 +638,13 @@ int apply_args(state_t *state, int argc, char **argv, double jul_utc, int help)
         }
 #ifdef SSO_WITH_SDR
         if (strncmp("--sdr-type=", arg, 11) == 0 || help) {
-            if (help) parse_help_line(OPTW, "--sdr-type=uhd|rtlsdr|auto",
-                "SDR backend (default auto; RTL-SDR is RX-only)");
+            if (help) parse_help_line(OPTW, "--sdr-type=uhd|rtlsdr|file|auto",
+                "SDR backend (default auto; RTL-SDR and file are RX-only)");
             else {
                 state->app.n_options++;
                 if (sdr_backend_type_from_string(arg + 11, &state->sdr.sdr_type) != 0) {
                     fprintf(stderr, "--sdr-type: unknown '%s' "
-                            "(want uhd | rtlsdr | auto)\n", arg + 11);
+                            "(want uhd | rtlsdr | file | auto)\n", arg + 11);
                     return PARSE_ERROR;
                 }
             }
@@ -633,6 +659,126 @@ int apply_args(state_t *state, int argc, char **argv, double jul_utc, int help)
             }
             matched = 1;
         }
+        if (strncmp("--rtl-usb=", arg, 10) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--rtl-usb=<n>[x<KiB>]",
+                "RTL-SDR USB transfers kept queued, and their size (default 32x64)");
+            else {
+                state->app.n_options++;
+                int n = 0, kib = 0;
+                int got = sscanf(arg + 10, "%dx%d", &n, &kib);
+                if (got < 1 || n < 2 || n > 256
+                    || (got == 2 && (kib < 1 || kib > 4096))) {
+                    fprintf(stderr, "--rtl-usb: want <n>[x<KiB>] with n 2..256, "
+                            "KiB 1..4096 (got '%s')\n", arg + 10);
+                    return PARSE_ERROR;
+                }
+                state->sdr.rtl_xfers    = n;
+                state->sdr.rtl_xfer_kib = got == 2 ? kib : 0;
+            }
+            matched = 1;
+        }
+        if (strncmp("--replay=", arg, 9) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--replay=<file>|synth",
+                "no radio: stream a .sso-iq/.iq, or synthetic beacon bursts");
+            else {
+                state->app.n_options++;
+                state->sdr.sdr_type = SDR_TYPE_FILE;
+                if (strcmp(arg + 9, "synth") == 0) {
+                    state->sdr.replay_path[0] = '\0';
+                } else if (arg[9] == '\0') {
+                    fprintf(stderr, "--replay: want a recording path or 'synth'\n");
+                    return PARSE_ERROR;
+                } else {
+                    snprintf(state->sdr.replay_path, sizeof state->sdr.replay_path,
+                             "%s", arg + 9);
+                }
+            }
+            matched = 1;
+        }
+        if (strncmp("--replay-speed=", arg, 15) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--replay-speed=<x>|max",
+                "replay pacing: 1 = real time (default), max = unpaced");
+            else {
+                state->app.n_options++;
+                double x = 0.0;
+                if (strcmp(arg + 15, "max") == 0) {
+                    state->sdr.replay.speed = 0.0;
+                } else if (parse_arg_double(arg + 15, &x) != 0 || !(x > 0.0) || x > 1000.0) {
+                    fprintf(stderr, "--replay-speed: want 0 < x <= 1000 or 'max' "
+                            "(got '%s')\n", arg + 15);
+                    return PARSE_ERROR;
+                } else {
+                    state->sdr.replay.speed = x;
+                }
+            }
+            matched = 1;
+        }
+        if (strcmp("--replay-once", arg) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--replay-once",
+                "end the stream at the end of the recording instead of looping");
+            else { state->app.n_options++; state->sdr.replay.once = 1; }
+            matched = 1;
+        }
+        if (strncmp("--replay-burst=", arg, 15) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--replay-burst=<s>",
+                "synthetic: one beacon every <s> seconds (default 1)");
+            else {
+                state->app.n_options++;
+                double sec = 0.0;
+                if (parse_arg_double(arg + 15, &sec) != 0 || sec < 0.2 || sec > 3600.0) {
+                    fprintf(stderr, "--replay-burst: want 0.2..3600 s (got '%s')\n", arg + 15);
+                    return PARSE_ERROR;
+                }
+                state->sdr.replay.burst_s = sec;
+            }
+            matched = 1;
+        }
+        if (strncmp("--replay-rate=", arg, 14) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--replay-rate=<Hz>",
+                "synthetic: native sample rate (default 480000)");
+            else {
+                state->app.n_options++;
+                double hz = 0.0;
+                if (parse_arg_double(arg + 14, &hz) != 0 || hz < 96000.0 || hz > 20e6) {
+                    fprintf(stderr, "--replay-rate: want 96000..20e6 Hz (got '%s')\n", arg + 14);
+                    return PARSE_ERROR;
+                }
+                state->sdr.replay.rate_hz = hz;
+            }
+            matched = 1;
+        }
+        if (strncmp("--replay-noise=", arg, 15) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--replay-noise=<dBFS>",
+                "add complex Gaussian noise at this power (e.g. -30)");
+            else {
+                state->app.n_options++;
+                double db = 0.0;
+                if (parse_arg_double(arg + 15, &db) != 0 || db >= 0.0 || db < -120.0) {
+                    fprintf(stderr, "--replay-noise: want -120..<0 dBFS (got '%s')\n", arg + 15);
+                    return PARSE_ERROR;
+                }
+                state->sdr.replay.noise_dbfs = db;
+            }
+            matched = 1;
+        }
+        if (strncmp("--replay-doppler=", arg, 17) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--replay-doppler=<Hz>[,<Hz/s>]",
+                "add a frequency shift, optionally ramping");
+            else {
+                state->app.n_options++;
+                double hz = 0.0, rate = 0.0;
+                char extra = 0;
+                int got = sscanf(arg + 17, "%lf,%lf%c", &hz, &rate, &extra);
+                if (got < 1 || got > 2 || fabs(hz) > 45000.0 || fabs(rate) > 1000.0) {
+                    fprintf(stderr, "--replay-doppler: want <Hz>[,<Hz/s>] within "
+                            "+-45 kHz, +-1 kHz/s (got '%s')\n", arg + 17);
+                    return PARSE_ERROR;
+                }
+                state->sdr.replay.doppler_hz        = hz;
+                state->sdr.replay.doppler_rate_hz_s = got == 2 ? rate : 0.0;
+            }
+            matched = 1;
+        }
         if (strncmp("--uhd-args=", arg, 11) == 0 || help) {
             if (help) parse_help_line(OPTW, "--uhd-args=<args>",
                 "UHD device-args verbatim; overrides detection");
@@ -670,6 +816,46 @@ int apply_args(state_t *state, int argc, char **argv, double jul_utc, int help)
             else { state->app.n_options++; state->sdr.always_record = 1; }
             matched = 1;
         }
+        if (strcmp("--raw-iq", arg) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--raw-iq",
+                "record the headerless int16 .iq instead of the compressed .sso-iq");
+            else { state->app.n_options++; state->sdr.raw_iq = 1; }
+            matched = 1;
+        }
+        if (strcmp("--no-burst-gate", arg) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--no-burst-gate",
+                "demodulate every RX window, not only where burst energy is seen");
+            else { state->app.n_options++; state->sdr.no_burst_gate = 1; }
+            matched = 1;
+        }
+        if (strncmp("--rx-channel=", arg, 13) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--rx-channel=<sat>@<MHz>",
+                "also decode <sat> on its downlink from the same SDR stream (repeatable, max 4)");
+            else {
+                state->app.n_options++;
+                // Split at the last '@' so a catalog name may contain one.
+                const char *spec = arg + 13;
+                const char *at = strrchr(spec, '@');
+                double mhz;
+                size_t name_len = at != NULL ? (size_t)(at - spec) : 0;
+                if (at == NULL || name_len == 0
+                    || name_len >= sizeof state->sdr.rx_channels[0].name
+                    || parse_arg_double(at + 1, &mhz) != 0 || !(mhz > 0.0)) {
+                    fprintf(stderr, "Unable to parse %s\n", arg);
+                    return PARSE_ERROR;
+                }
+                if (state->sdr.n_rx_channels >= SDR_RX_CHANNELS_MAX) {
+                    fprintf(stderr, "At most %d --rx-channel options\n",
+                            SDR_RX_CHANNELS_MAX);
+                    return PARSE_ERROR;
+                }
+                sdr_rx_channel_t *rc = &state->sdr.rx_channels[state->sdr.n_rx_channels++];
+                memcpy(rc->name, spec, name_len);
+                rc->name[name_len] = '\0';
+                rc->freq_hz = mhz * 1e6;
+            }
+            matched = 1;
+        }
         if (strcmp("--testing", arg) == 0 || help) {
             if (help) parse_help_line(OPTW, "--testing",
                 "bench mode: pass folder under Testing/ at current local time, no TLE");
@@ -17,6 +17,14 @@
     product. Each object's TLE age is printed so a stale element set is
     obvious.
 
+    With --catalog it screens instead: the named object against every object
+    in a catalog file (one-vs-many), or, with no object named, every pair in
+    the catalog (all-vs-all). All objects are propagated on a shared time grid
+    by worker threads, pairs whose radial shells never meet are dropped, and a
+    3-D spatial hash at each grid time finds the pairs close enough to
+    matter; only their grid minima are refined to a TCA and scored, and every
+    encounter below the threshold is listed.
+
     Read-only and observer-independent: a conjunction is a fact about the
     two orbits, not about any ground station, so it takes no location. Build
     needs only the SGP4SDP4 library (no ncurses, no UHD, no ALSA), so it runs
@@ -43,23 +51,27 @@
 #include "duration_fmt.h"
 #include "prediction.h"
 #include "sso_version.h"
+#include "tle_io.h"
 
 #include <sgp4sdp4.h>
 
 #include <math.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 #define OPTW 26
 
 // One object: its loaded + once-converted elements, deep-space verdict, and
-// TLE epoch. Mirrors the multi-satellite handling in tle_compare.c: the
-// sgp4sdp4 library keeps the chosen ephemeris in module-level globals, so when
-// two satellites share the process we restore the converted elements and
-// re-assert the deep-space flag (without re-running the destructive
-// select_ephemeris) before each propagation.
+// TLE epoch, plus the batch-propagation context built from them. select_ephemeris
+// rewrites the elements in place and must run exactly once, so setup_object
+// converts them once and every propagation goes through the context, which
+// carries its own copy of the SGP4 constants: no shared flags to re-assert
+// between objects, and worker threads may propagate shared objects at once.
 typedef struct {
     const char  *file;          // TLE file this object is read from
     const char  *name;          // requested name prefix (case-sensitive)
@@ -67,7 +79,13 @@ typedef struct {
     tle_t        tle_ready;     // converted elements, captured once
     int          deep_space;    // 1 if select_ephemeris flagged SDP4
     double       epoch_jul;     // TLE epoch as a Julian date
+    sgp4_ctx_t   ctx;           // batch propagation of tle_ready
     char         namebuf[64];   // backing store for pred.satellite_ephem.name
+    // Mean-element orbit size, for the screening shell filter: semi-major
+    // axis (km), eccentricity, and the drag-driven da/dt (km/day, <= 0).
+    double       sma_km;
+    double       ecc;
+    double       dadt_km_day;
 } object_t;
 
 typedef struct {
@@ -87,6 +105,9 @@ typedef struct {
     const char *plot_out;       // output base / PNG path (NULL => "conjunction")
     double plot_window_sec;     // half-window around TCA shown in the plot
     int    n_positional;        // count of bare (non-option) tokens seen
+    const char *catalog;        // --catalog: screen against this TLE file
+    int    threads;             // scan / screening worker threads (0 => online CPUs)
+    int    threshold_set;       // --threshold-km given explicitly
 } args_t;
 
 // Default per-object 1-sigma position uncertainty (metres, RTN). A placeholder
@@ -97,6 +118,26 @@ typedef struct {
 #define DEF_SIG_C 200.0
 #define DEF_HBR_M 20.0
 
+// Screening defaults. A catalog screen lists every encounter, so the gate is
+// much tighter than the two-object search's 100 km.
+#define DEF_SCREEN_THRESHOLD_KM 5.0
+
+#define GM_KM3_S2 398600.4418   // Earth gravitational parameter (WGS84)
+
+// TCA tolerance, seconds. At a ~15 km/s closing speed every 0.01 s of TCA
+// error is ~150 m of relative travel along the velocity, which tilts the miss
+// vector off perpendicular and corrupts the radial/along/cross split (and,
+// for a close miss, the miss magnitude). Refine to ~0.1 ms (~1.5 m), just
+// above the floor a double-precision Julian date imposes: a JD near 2.46e6
+// resolves to ~5e-10 day (~0.7 m at this speed), and sat_state's
+// tsince = (jul - epoch) subtraction inherits that granularity, so chasing a
+// tighter tolerance would only be tracking floating-point noise.
+#define TCA_TOL_SEC 1.0e-4
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 // ---- time helpers ----------------------------------------------------------
 
 static double now_jul_utc(void)
@@ -185,37 +226,31 @@ static void fmt_mag(double km, char *buf, size_t n)
 // copy + the deep-space verdict + the epoch. Must run exactly once.
 static void setup_object(object_t *o)
 {
+    // Orbit size from the raw elements (mean motion rev/day, ndot/2 in
+    // rev/day^2), before select_ephemeris rewrites their units.
+    const tle_t *raw = &o->pred.satellite_ephem.tle;
+    if (raw->xno > 0.0) {
+        double n_rad_s = raw->xno * 2.0 * M_PI / 86400.0;
+        o->sma_km = cbrt(GM_KM3_S2 / (n_rad_s * n_rad_s));
+        // a ~ n^(-2/3): da/dt = -(2/3) a (dn/dt) / n, dn/dt = 2 * (ndot/2).
+        o->dadt_km_day = -(2.0 / 3.0) * o->sma_km * (2.0 * raw->xndt2o) / raw->xno;
+        if (o->dadt_km_day > 0.0) o->dadt_km_day = 0.0;
+    }
+    o->ecc = raw->eo;
+
     ClearFlag(ALL_FLAGS);
     select_ephemeris(&o->pred.satellite_ephem.tle);
     o->deep_space = isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0;
     o->tle_ready  = o->pred.satellite_ephem.tle;
     o->epoch_jul  = Julian_Date_of_Epoch(o->tle_ready.epoch);
-}
-
-// Restore this object's once-converted elements and re-assert its deep-space
-// flag before propagating it, WITHOUT re-running select_ephemeris (which is
-// not idempotent). ClearFlag also drops the *_INITIALIZED bits so the
-// propagator re-derives its constants for this object on the next call.
-static void prep_object(object_t *o)
-{
-    o->pred.satellite_ephem.tle = o->tle_ready;
-    ClearFlag(ALL_FLAGS);
-    if (o->deep_space) SetFlag(DEEP_SPACE_EPHEM_FLAG);
+    sgp4_ctx_init(&o->ctx, &o->tle_ready, o->deep_space);
 }
 
 // ECI position + velocity (km, km/s) at a Julian date, straight from the
-// propagator. Calls prep_object first so it is safe to interleave with the
-// other object in the same process.
-static void sat_state(object_t *o, double jul, double r[3], double v[3])
+// propagator. A one-time grid has the same x, y, z layout as r and v.
+static void sat_state(const object_t *o, double jul, double r[3], double v[3])
 {
-    prep_object(o);
-    double tsince = (jul - o->epoch_jul) * 1440.0;
-    vector_t pos = {0}, vel = {0};
-    if (o->deep_space) SDP4(tsince, &o->pred.satellite_ephem.tle, &pos, &vel);
-    else               SGP4(tsince, &o->pred.satellite_ephem.tle, &pos, &vel);
-    Convert_Sat_State(&pos, &vel);
-    r[0] = pos.x; r[1] = pos.y; r[2] = pos.z;
-    v[0] = vel.x; v[1] = vel.y; v[2] = vel.z;
+    sgp4_propagate_times(&o->ctx, &jul, 1, r, v);
 }
 
 // 3-D separation (km) between the two objects at a Julian date.
@@ -229,25 +264,16 @@ static double separation_km(object_t *a, object_t *b, double jul)
 }
 
 // Golden-section minimisation of separation_km over a bracket [lo, hi] (days)
-// that contains a single minimum. Returns the time (Julian date) of closest
-// approach. The relative-distance curve is smooth and unimodal across one
-// encounter, so this converges to the true TCA well below the coarse step.
-static double refine_tca(object_t *a, object_t *b, double lo, double hi)
+// that contains a single minimum. The fallback for refine_tca when the range
+// rate does not change sign across the bracket.
+static double refine_tca_golden(object_t *a, object_t *b, double lo, double hi)
 {
     const double GR = 0.6180339887498949;   // 1/phi
     double c = hi - GR * (hi - lo);
     double d = lo + GR * (hi - lo);
     double fc = separation_km(a, b, c);
     double fd = separation_km(a, b, d);
-    // Tolerance in Julian days. At a ~15 km/s closing speed every 0.01 s of TCA
-    // error is ~150 m of relative travel along the velocity, which tilts the
-    // miss vector off perpendicular and corrupts the radial/along/cross split
-    // (and, for a close miss, the miss magnitude). Refine to ~0.1 ms (~1.5 m),
-    // just above the floor a double-precision Julian date imposes: a JD near
-    // 2.46e6 resolves to ~5e-10 day (~0.7 m at this speed), and sat_state's
-    // tsince = (jul - epoch) subtraction inherits that granularity, so chasing
-    // a tighter tolerance would only be tracking floating-point noise.
-    const double tol = 1.0e-4 / 86400.0;
+    const double tol = TCA_TOL_SEC / 86400.0;
     int iter = 0;
     while ((hi - lo) > tol && iter++ < 200) {
         if (fc < fd) {
@@ -263,21 +289,63 @@ static double refine_tca(object_t *a, object_t *b, double lo, double hi)
     return 0.5 * (lo + hi);
 }
 
+// Range rate r_rel . v_rel (km^2/s) at t seconds past the bracket start.
+typedef struct {
+    object_t *a, *b;
+    double    jul0;
+} range_rate_ctx_t;
+
+static double range_rate_at(double t_sec, void *vctx)
+{
+    const range_rate_ctx_t *c = vctx;
+    double jul = c->jul0 + t_sec / 86400.0;
+    double ra[3], va[3], rb[3], vb[3];
+    sat_state(c->a, jul, ra, va);
+    sat_state(c->b, jul, rb, vb);
+    double f = 0.0;
+    for (int k = 0; k < 3; ++k) f += (rb[k] - ra[k]) * (vb[k] - va[k]);
+    return f;
+}
+
+// Time of closest approach (Julian date) inside a bracket [lo, hi] around one
+// coarse local minimum. The relative-distance curve is smooth across one
+// encounter, so its minimum is the range rate's zero crossing from below;
+// Brent's method on that crossing needs a handful of propagations where
+// golden-section search on the distance needs ~25. A bracket the range rate
+// does not cross upward (a grazing minimum at the bracket edge) falls back to
+// golden-section.
+static double refine_tca(object_t *a, object_t *b, double lo, double hi)
+{
+    range_rate_ctx_t c = { a, b, lo };
+    double span = (hi - lo) * 86400.0;
+    double flo = range_rate_at(0.0, &c);
+    double fhi = range_rate_at(span, &c);
+    if (!(flo <= 0.0 && fhi >= 0.0)) return refine_tca_golden(a, b, lo, hi);
+    double t = conj_brent_root(range_rate_at, &c, 0.0, span, flo, fhi, TCA_TOL_SEC, 100);
+    return lo + t / 86400.0;
+}
+
 // ---- per-event report ------------------------------------------------------
 
-static void report_event(const args_t *cfg, object_t *a, object_t *b,
-                         double jul_tca, double jul_now, int index)
+// The numbers reported for one encounter at its TCA.
+typedef struct {
+    double range, radial, along, cross;   // km, in the primary's RTN frame
+    double rel_speed;                     // km/s
+    double pc;                            // Foster (1992)
+} encounter_t;
+
+static void encounter_at(const args_t *cfg, object_t *a, object_t *b,
+                         double jul_tca, encounter_t *e)
 {
     double ra[3], va[3], rb[3], vb[3];
     sat_state(a, jul_tca, ra, va);
     sat_state(b, jul_tca, rb, vb);
 
-    double radial, along, cross, range;
-    conj_rtn_components(ra, va, rb, &radial, &along, &cross, &range);
+    conj_rtn_components(ra, va, rb, &e->radial, &e->along, &e->cross, &e->range);
 
     double rrel[3] = { rb[0] - ra[0], rb[1] - ra[1], rb[2] - ra[2] };
     double vrel[3] = { vb[0] - va[0], vb[1] - va[1], vb[2] - va[2] };
-    double rel_speed = sqrt(vrel[0] * vrel[0] + vrel[1] * vrel[1] + vrel[2] * vrel[2]);
+    e->rel_speed = sqrt(vrel[0] * vrel[0] + vrel[1] * vrel[1] + vrel[2] * vrel[2]);
 
     // Combined ECI covariance (km^2): each object's RTN sigmas rotated into
     // ECI at TCA, then summed.
@@ -287,7 +355,16 @@ static void report_event(const args_t *cfg, object_t *a, object_t *b,
     conj_cov_rtn_to_eci(rb, vb, cfg->sig2_r / 1000.0, cfg->sig2_a / 1000.0,
                         cfg->sig2_c / 1000.0, cov2);
     for (int i = 0; i < 9; ++i) cov[i] = cov1[i] + cov2[i];
-    double pc = conj_foster_pc(rrel, vrel, cov, cfg->hbr_m / 1000.0);
+    e->pc = conj_foster_pc(rrel, vrel, cov, cfg->hbr_m / 1000.0);
+}
+
+static void report_event(const args_t *cfg, object_t *a, object_t *b,
+                         double jul_tca, double jul_now, int index)
+{
+    encounter_t e;
+    encounter_at(cfg, a, b, jul_tca, &e);
+    double radial = e.radial, along = e.along, cross = e.cross, range = e.range;
+    double rel_speed = e.rel_speed, pc = e.pc;
 
     char utc[40], loc[40], until[40], miss[32], cr[32], ca[32], cc[32];
     fmt_utc_ms(jul_tca, utc, sizeof utc);
@@ -361,24 +438,20 @@ static int write_conjunction_plot(const args_t *cfg, object_t *a, object_t *b,
                      + (vb[2] - va[2]) * (vb[2] - va[2]));
 
     double win = cfg->plot_window_sec;
-    const int N = 401;
+    enum { N = 401 };
 
     FILE *df = fopen(datp, "w");
     if (!df) { fprintf(stderr, "conjunction: cannot write %s\n", datp); return -1; }
+    // Both tracks over the window in one grid propagation each (SoA).
+    static double ta[3 * N], tb[3 * N];
+    sgp4_propagate_grid(&a->ctx, jul_tca - win / 86400.0, 2.0 * win / (double) (N - 1), N, ta, NULL);
+    sgp4_propagate_grid(&b->ctx, jul_tca - win / 86400.0, 2.0 * win / (double) (N - 1), N, tb, NULL);
     fprintf(df, "# index 0: %s track  (X Y Z km, recentred on encounter midpoint)\n", a->name);
-    for (int i = 0; i < N; ++i) {
-        double s = -win + 2.0 * win * (double) i / (double) (N - 1);
-        double r[3], v[3];
-        sat_state(a, jul_tca + s / 86400.0, r, v);
-        fprintf(df, "%.6f %.6f %.6f\n", r[0] - mid[0], r[1] - mid[1], r[2] - mid[2]);
-    }
+    for (int i = 0; i < N; ++i)
+        fprintf(df, "%.6f %.6f %.6f\n", ta[i] - mid[0], ta[N + i] - mid[1], ta[2 * N + i] - mid[2]);
     fprintf(df, "\n\n# index 1: %s track\n", b->name);
-    for (int i = 0; i < N; ++i) {
-        double s = -win + 2.0 * win * (double) i / (double) (N - 1);
-        double r[3], v[3];
-        sat_state(b, jul_tca + s / 86400.0, r, v);
-        fprintf(df, "%.6f %.6f %.6f\n", r[0] - mid[0], r[1] - mid[1], r[2] - mid[2]);
-    }
+    for (int i = 0; i < N; ++i)
+        fprintf(df, "%.6f %.6f %.6f\n", tb[i] - mid[0], tb[N + i] - mid[1], tb[2 * N + i] - mid[2]);
     fprintf(df, "\n\n# index 2: closest-approach points\n");
     fprintf(df, "%.6f %.6f %.6f\n", ra[0] - mid[0], ra[1] - mid[1], ra[2] - mid[2]);
     fprintf(df, "%.6f %.6f %.6f\n", rb[0] - mid[0], rb[1] - mid[1], rb[2] - mid[2]);
@@ -513,8 +586,8 @@ static int parse_args(args_t *a, int argc, char **argv, int help)
             matched = 1;
         }
         if (strncmp(arg, "--threshold-km=", 15) == 0 || help) {
-            if (help) parse_help_line(OPTW, "--threshold-km=<km>", "conjunction distance gate (default 100)");
-            else a->threshold_km = atof(arg + 15);
+            if (help) parse_help_line(OPTW, "--threshold-km=<km>", "conjunction distance gate (default 100; 5 with --catalog)");
+            else { a->threshold_km = atof(arg + 15); a->threshold_set = 1; }
             matched = 1;
         }
         if (strcmp(arg, "--all") == 0 || help) {
@@ -552,6 +625,16 @@ static int parse_args(args_t *a, int argc, char **argv, int help)
             }
             matched = 1;
         }
+        if (strncmp(arg, "--catalog=", 10) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--catalog=<path>", "screen <name1> (or every pair, if none) against a TLE catalog");
+            else a->catalog = arg + 10;
+            matched = 1;
+        }
+        if (strncmp(arg, "--threads=", 10) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--threads=<N>", "worker threads for the scan and the catalog screen (default: online CPUs)");
+            else a->threads = atoi(arg + 10);
+            matched = 1;
+        }
         if (strcmp(arg, "--plot") == 0 || help) {
             if (help) parse_help_line(OPTW, "--plot", "render a gnuplot 3-D view of the encounter (PNG)");
             else a->plot = 1;
@@ -587,6 +670,10 @@ static int parse_args(args_t *a, int argc, char **argv, int help)
         printf("  conjunction unit_tests/fixtures/conjunction.tle FrontierSat SPACEMOBILE-004 --days=14 --step=5 --threshold-km=25\n");
         printf("  # Secondary from a different file, with a supplied covariance:\n");
         printf("  conjunction ours.tle FrontierSat --tle2=other.tle DEBRIS-123 --sigma2-rtn=500,3000,500\n");
+        printf("  # Screen FrontierSat against a full catalog for approaches inside 5 km:\n");
+        printf("  conjunction ours.tle FrontierSat --catalog=active.tle\n");
+        printf("  # All-vs-all screen of a catalog, 2 km gate, 8 threads:\n");
+        printf("  conjunction --catalog=active.tle --threshold-km=2 --threads=8\n");
     }
     return PARSE_OK;
 }
@@ -604,6 +691,616 @@ static int load_object(object_t *o, const char *file, const char *name)
     return 0;
 }
 
+// ---- catalog screening -----------------------------------------------------
+
+// Read every object in a TLE catalog and set each one up for propagation.
+// Handles 3-line groups, the "0 " 3LE name prefix, and nameless 2-line sets
+// (named by NORAD ID), validating each with Good_Elements like load_tle does.
+// Returns 0 with out/count filled, -1 if the file can't be opened or memory
+// runs out.
+static int load_catalog(const char *path, object_t **out, size_t *count)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    object_t *arr = NULL;
+    size_t n = 0, cap = 0;
+    char name[160], l1[160], l2[160];
+    while (tle_io_read_line(fp, name, sizeof name)) {
+        const char *nm = name;
+        if (tle_io_is_element_line(name, '1')) {
+            snprintf(l1, sizeof l1, "%s", name);
+            if (!tle_io_read_line(fp, l2, sizeof l2)) break;
+            nm = "";
+        } else {
+            if (nm[0] == '0' && nm[1] == ' ') nm += 2;
+            if (!tle_io_read_line(fp, l1, sizeof l1)) break;
+            if (!tle_io_read_line(fp, l2, sizeof l2)) break;
+        }
+
+        // sgp4sdp4 wants card 1 at [0..68] and card 2 at [69..137].
+        char set[139];
+        memset(set, 0, sizeof set);
+        size_t la = strlen(l1), lb = strlen(l2);
+        if (la > 69) la = 69;
+        if (lb > 69) lb = 69;
+        memcpy(set, l1, la);
+        memcpy(set + 69, l2, lb);
+        set[138] = '\0';
+        if (!Good_Elements(set)) continue;   // skip a malformed group
+
+        if (n == cap) {
+            size_t ncap = cap ? cap * 2 : 256;
+            object_t *grown = realloc(arr, ncap * sizeof *arr);
+            if (!grown) { free(arr); fclose(fp); return -1; }
+            arr = grown;
+            cap = ncap;
+        }
+        object_t *o = &arr[n];
+        memset(o, 0, sizeof *o);
+        o->file = path;
+        Convert_Satellite_Data(set, &o->pred.satellite_ephem.tle);
+        if (nm[0] != '\0')
+            snprintf(o->namebuf, sizeof o->namebuf, "%.*s",
+                     (int) (sizeof o->namebuf - 1), nm);
+        else
+            snprintf(o->namebuf, sizeof o->namebuf, "NORAD %d",
+                     o->pred.satellite_ephem.tle.catnr);
+        snprintf(o->pred.satellite_ephem.tle.sat_name,
+                 sizeof o->pred.satellite_ephem.tle.sat_name, "%s", o->namebuf);
+        setup_object(o);
+        n++;
+    }
+    fclose(fp);
+    // Names point into namebuf, so wire them up once the array stops moving.
+    for (size_t i = 0; i < n; ++i) {
+        arr[i].name = arr[i].namebuf;
+        arr[i].pred.satellite_ephem.name = arr[i].namebuf;
+    }
+    *out = arr;
+    *count = n;
+    return 0;
+}
+
+// Upper bound on the closing speed of two Earth orbiters (two LEO objects
+// head-on is ~15.5 km/s). Sets the spatial-hash cell: between grid samples
+// no pair can close by more than this times the step.
+#define SCREEN_VREL_MAX_KM_S  16.0
+// Bound on the relative acceleration of two orbiters (twice surface gravity).
+// Over one step a straight-line relative path is off by at most a*dt^2/2.
+#define SCREEN_ACCEL_MAX_KM_S2 0.02
+// Mean-element apsides vs the osculating radius SGP4 actually produces
+// (J2 short-periodics, a few km, plus margin); added to each shell.
+#define SCREEN_SHELL_SLACK_KM 50.0
+// Per-thread position buffer budget in floats (16 MiB); sets how many grid
+// times each propagation block covers for a given catalog size.
+#define SCREEN_BLOCK_FLOATS   (4u << 20)
+
+// One pair whose grid separation has a local minimum at grid index k that
+// could dip below the threshold between the neighbouring samples.
+typedef struct {
+    uint32_t i, j;
+    uint32_t k;
+} screen_cand_t;
+
+typedef struct {
+    uint32_t    i, j;
+    double      tca;
+    encounter_t e;
+} screen_event_t;
+
+// Shared screen setup plus one worker's private buffers. Workers split the
+// grid into blocks round-robin: each propagates every object across its block
+// (object-major, one sgp4_propagate_grid call per object per block) into pos,
+// then walks the block's grid times looking for close pairs.
+typedef struct {
+    const args_t  *cfg;
+    object_t     **obj;          // screened objects; [0] = primary if one_vs_many
+    size_t         n;
+    const double  *peri, *apo;   // shell radii per object (km), slack included
+    int            one_vs_many;
+    double         jul0, step_jul;
+    uint32_t       n_steps;      // grid times 0 .. n_steps-1
+    size_t         block;        // interior grid times per block
+    double         cell_km;
+    double         chord_slack_km;  // curvature allowance on the chord miss
+    int            index, n_threads;
+
+    float         *pos;          // (block + 2) rows x n objects x 3, km
+    double        *scratch;      // one object's block, SoA (3 x (block + 2))
+    conj_grid_t   *grid;
+    size_t         row;          // current row in pos (1 .. rows-2)
+    uint32_t       k;            // its global grid index
+    screen_cand_t *cand;
+    size_t         n_cand, cap_cand;
+    int            failed;
+} screen_worker_t;
+
+static void screen_pair(size_t i, size_t j, void *ctx)
+{
+    screen_worker_t *w = ctx;
+    double thr = w->cfg->threshold_km;
+    if (!w->one_vs_many
+        && !conj_shells_overlap(w->peri[i], w->apo[i], w->peri[j], w->apo[j], thr))
+        return;
+
+    // Relative position at the previous, current and next grid times. A
+    // candidate is a grid local minimum whose closest approach, taken along
+    // the relative velocity estimated from the neighbours, could reach the
+    // gate once the curvature that straight line ignores is allowed for.
+    const size_t stride = w->n * 3;
+    const float *pm = w->pos + (w->row - 1) * stride;
+    const float *p0 = pm + stride;
+    const float *pp = p0 + stride;
+    double rm[3], r0[3], rp[3];
+    for (int c = 0; c < 3; ++c) {
+        rm[c] = (double) pm[3 * j + c] - (double) pm[3 * i + c];
+        r0[c] = (double) p0[3 * j + c] - (double) p0[3 * i + c];
+        rp[c] = (double) pp[3 * j + c] - (double) pp[3 * i + c];
+    }
+    double dm = rm[0] * rm[0] + rm[1] * rm[1] + rm[2] * rm[2];
+    double d0 = r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2];
+    double dp = rp[0] * rp[0] + rp[1] * rp[1] + rp[2] * rp[2];
+    if (!(d0 <= dm && d0 < dp)) return;
+    double v[3] = { 0.5 * (rp[0] - rm[0]), 0.5 * (rp[1] - rm[1]), 0.5 * (rp[2] - rm[2]) };
+    double vv  = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    double tau = vv > 0.0 ? -(r0[0] * v[0] + r0[1] * v[1] + r0[2] * v[2]) / vv : 0.0;
+    if (tau < -1.0) tau = -1.0;
+    if (tau >  1.0) tau =  1.0;
+    double m[3] = { r0[0] + tau * v[0], r0[1] + tau * v[1], r0[2] + tau * v[2] };
+    double miss = sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+    if (miss > thr + w->chord_slack_km) return;
+
+    if (w->n_cand == w->cap_cand) {
+        size_t ncap = w->cap_cand ? w->cap_cand * 2 : 1024;
+        screen_cand_t *grown = realloc(w->cand, ncap * sizeof *grown);
+        if (!grown) { w->failed = 1; return; }
+        w->cand = grown;
+        w->cap_cand = ncap;
+    }
+    w->cand[w->n_cand++] = (screen_cand_t) { (uint32_t) i, (uint32_t) j, w->k };
+}
+
+static void *screen_worker_fn(void *arg)
+{
+    screen_worker_t *w = arg;
+    const size_t n = w->n;
+    // Interior grid times 1 .. n_steps-2 (each needs both neighbours).
+    uint32_t interior = w->n_steps - 2;
+    size_t n_blocks = (interior + w->block - 1) / w->block;
+    for (size_t b = (size_t) w->index; b < n_blocks && !w->failed;
+         b += (size_t) w->n_threads) {
+        uint32_t k_lo = 1 + (uint32_t) (b * w->block);
+        uint32_t k_hi = k_lo + (uint32_t) w->block;
+        if (k_hi > w->n_steps - 1) k_hi = w->n_steps - 1;
+        size_t rows = (size_t) (k_hi - k_lo) + 2;   // k_lo-1 .. k_hi
+
+        double jul_lo = w->jul0 + (double) (k_lo - 1) * w->step_jul;
+        for (size_t o = 0; o < n; ++o) {
+            sgp4_propagate_grid(&w->obj[o]->ctx, jul_lo, w->cfg->step_sec,
+                                (int) rows, w->scratch, NULL);
+            for (size_t r = 0; r < rows; ++r) {
+                float *dst = w->pos + (r * n + o) * 3;
+                dst[0] = (float) w->scratch[r];
+                dst[1] = (float) w->scratch[rows + r];
+                dst[2] = (float) w->scratch[2 * rows + r];
+            }
+        }
+
+        for (size_t r = 1; r + 1 < rows; ++r) {
+            w->row = r;
+            w->k   = k_lo - 1 + (uint32_t) r;
+            if (w->one_vs_many) {
+                for (size_t j = 1; j < n; ++j) screen_pair(0, j, w);
+            } else {
+                conj_grid_pairs(w->grid, w->pos + r * n * 3, n, w->cell_km,
+                                screen_pair, w);
+            }
+        }
+    }
+    return NULL;
+}
+
+// Refinement workers: TCA refinement + scoring for a strided share of
+// the candidates, keeping the encounters that land inside the gate.
+typedef struct {
+    const args_t        *cfg;
+    object_t           **obj;
+    const screen_cand_t *cand;
+    size_t               n_cand;
+    double               jul0, step_jul;
+    int                  index, n_threads;
+    screen_event_t      *ev;
+    size_t               n_ev, cap_ev;
+    int                  failed;
+} refine_worker_t;
+
+static void *refine_worker_fn(void *arg)
+{
+    refine_worker_t *w = arg;
+    for (size_t c = (size_t) w->index; c < w->n_cand; c += (size_t) w->n_threads) {
+        const screen_cand_t *sc = &w->cand[c];
+        object_t *a = w->obj[sc->i], *b = w->obj[sc->j];
+        double lo = w->jul0 + (double) (sc->k - 1) * w->step_jul;
+        double hi = w->jul0 + (double) (sc->k + 1) * w->step_jul;
+        double tca = refine_tca(a, b, lo, hi);
+        encounter_t e;
+        encounter_at(w->cfg, a, b, tca, &e);
+        if (!(e.range <= w->cfg->threshold_km)) continue;
+        if (w->n_ev == w->cap_ev) {
+            size_t ncap = w->cap_ev ? w->cap_ev * 2 : 64;
+            screen_event_t *grown = realloc(w->ev, ncap * sizeof *grown);
+            if (!grown) { w->failed = 1; return NULL; }
+            w->ev = grown;
+            w->cap_ev = ncap;
+        }
+        w->ev[w->n_ev++] = (screen_event_t) { sc->i, sc->j, tca, e };
+    }
+    return NULL;
+}
+
+static int cmp_event_tca(const void *pa, const void *pb)
+{
+    const screen_event_t *a = pa, *b = pb;
+    return (a->tca > b->tca) - (a->tca < b->tca);
+}
+
+static double mono_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+// Screen the primary (cfg->file1 / cfg->name1) against the catalog, or every
+// catalog pair when no primary is named. Returns the process exit status:
+// 0 if any encounter falls inside the gate, 2 if none, 1 on error.
+static int run_screen(const args_t *cfg)
+{
+    object_t *cat = NULL;
+    size_t n_cat = 0;
+    if (load_catalog(cfg->catalog, &cat, &n_cat) != 0) {
+        fprintf(stderr, "conjunction: cannot read catalog %s\n", cfg->catalog);
+        return 1;
+    }
+    object_t primary;
+    int one_vs_many = cfg->name1 != NULL;
+    if (one_vs_many && load_object(&primary, cfg->file1, cfg->name1) != 0) {
+        free(cat);
+        return 1;
+    }
+
+    double jul_now = now_jul_utc();
+    double step_jul = cfg->step_sec / 86400.0;
+    double steps = floor(cfg->days / step_jul) + 1.0;
+    if (steps < 3.0 || steps > (double) UINT32_MAX) {
+        fprintf(stderr, "conjunction: --days / --step give %.0f grid times; "
+                        "need 3 .. %u\n", steps, UINT32_MAX);
+        free(cat);
+        return 1;
+    }
+
+    // Shell per object: mean-element apsides, widened by the SGP4 slack and
+    // by how far drag can lower the orbit over the window.
+    size_t n_max = n_cat + 1;
+    object_t **obj = malloc(n_max * sizeof *obj);
+    double *peri = malloc(n_max * sizeof *peri);
+    double *apo  = malloc(n_max * sizeof *apo);
+    if (!obj || !peri || !apo) {
+        fprintf(stderr, "conjunction: out of memory\n");
+        free(obj); free(peri); free(apo); free(cat);
+        return 1;
+    }
+    size_t n = 0;
+    if (one_vs_many) obj[n++] = &primary;
+    for (size_t c = 0; c < n_cat; ++c) {
+        if (one_vs_many && cat[c].tle_ready.catnr == primary.tle_ready.catnr)
+            continue;   // the primary's own entry in the catalog
+        obj[n++] = &cat[c];
+    }
+    for (size_t o = 0; o < n; ++o) {
+        double decay = -obj[o]->dadt_km_day * (cfg->days + (jul_now - obj[o]->epoch_jul));
+        peri[o] = obj[o]->sma_km * (1.0 - obj[o]->ecc) - SCREEN_SHELL_SLACK_KM - decay;
+        apo[o]  = obj[o]->sma_km * (1.0 + obj[o]->ecc) + SCREEN_SHELL_SLACK_KM;
+    }
+    // One-vs-many: the shell filter runs once here, so the workers propagate
+    // only the objects that could ever reach the primary.
+    if (one_vs_many) {
+        size_t kept = 1;
+        for (size_t o = 1; o < n; ++o) {
+            if (!conj_shells_overlap(peri[0], apo[0], peri[o], apo[o], cfg->threshold_km))
+                continue;
+            obj[kept] = obj[o]; peri[kept] = peri[o]; apo[kept] = apo[o];
+            kept++;
+        }
+        n = kept;
+    }
+
+    int n_threads = cfg->threads;
+    if (n_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        n_threads = cpus > 0 ? (int) cpus : 1;
+    }
+    size_t block = n > 0 ? SCREEN_BLOCK_FLOATS / (3 * n) : 0;
+    block = block > 2 ? block - 2 : 1;
+    if (block > 720) block = 720;
+    if (block < 8) block = 8;
+
+    char now_s[40];
+    fmt_utc(jul_now, now_s, sizeof now_s);
+    printf("Conjunction screen\n");
+    printf("  now                %s\n", now_s);
+    if (one_vs_many) {
+        char e1[40], age1[32];
+        fmt_utc(primary.epoch_jul, e1, sizeof e1);
+        format_age_compact((jul_now - primary.epoch_jul) * 86400.0, age1, sizeof age1);
+        printf("  primary            %s  (NORAD %d)\n",
+               primary.tle_ready.sat_name, primary.tle_ready.catnr);
+        printf("    TLE epoch        %s   (age %s)\n", e1, age1);
+        printf("  catalog            %s  (%zu objects, %zu pass the apogee/perigee filter)\n",
+               cfg->catalog, n_cat, n - 1);
+    } else {
+        printf("  mode               all-vs-all\n");
+        printf("  catalog            %s  (%zu objects)\n", cfg->catalog, n_cat);
+    }
+    printf("  window             %.3g days   step %.3g s   threshold %.3g km   threads %d\n",
+           cfg->days, cfg->step_sec, cfg->threshold_km, n_threads);
+    fflush(stdout);
+
+    double t_start = mono_seconds();
+    screen_worker_t *sw = calloc((size_t) n_threads, sizeof *sw);
+    pthread_t *tid = calloc((size_t) n_threads, sizeof *tid);
+    int failed = (sw == NULL || tid == NULL);
+    for (int t = 0; t < n_threads && !failed && n >= 2; ++t) {
+        screen_worker_t *w = &sw[t];
+        w->cfg = cfg; w->obj = obj; w->n = n; w->peri = peri; w->apo = apo;
+        w->one_vs_many = one_vs_many;
+        w->jul0 = jul_now; w->step_jul = step_jul; w->n_steps = (uint32_t) steps;
+        w->block = block;
+        w->cell_km = cfg->threshold_km + SCREEN_VREL_MAX_KM_S * cfg->step_sec;
+        w->chord_slack_km = 0.5 * SCREEN_ACCEL_MAX_KM_S2 * cfg->step_sec * cfg->step_sec;
+        w->index = t; w->n_threads = n_threads;
+        w->pos = malloc((block + 2) * n * 3 * sizeof *w->pos);
+        w->scratch = malloc((block + 2) * 3 * sizeof *w->scratch);
+        w->grid = one_vs_many ? NULL : conj_grid_new(n);
+        if (w->pos == NULL || w->scratch == NULL
+            || (!one_vs_many && w->grid == NULL)) failed = 1;
+    }
+    int started = 0;
+    for (int t = 0; t < n_threads && !failed && n >= 2; ++t, ++started)
+        if (pthread_create(&tid[t], NULL, screen_worker_fn, &sw[t]) != 0) { failed = 1; break; }
+    for (int t = 0; t < started; ++t) pthread_join(tid[t], NULL);
+
+    // Gather the candidates and refine them on the same number of threads.
+    size_t n_cand = 0;
+    for (int t = 0; sw && t < n_threads; ++t) {
+        failed |= sw[t].failed;
+        n_cand += sw[t].n_cand;
+    }
+    screen_cand_t *cand = n_cand ? malloc(n_cand * sizeof *cand) : NULL;
+    if (n_cand && cand == NULL) failed = 1;
+    for (int t = 0, off = 0; sw && t < n_threads; ++t) {
+        if (cand && sw[t].n_cand)
+            memcpy(cand + off, sw[t].cand, sw[t].n_cand * sizeof *cand);
+        off += (int) sw[t].n_cand;
+        free(sw[t].cand);
+        free(sw[t].pos);
+        free(sw[t].scratch);
+        conj_grid_free(sw[t].grid);
+    }
+    free(sw);
+
+    refine_worker_t *rw = calloc((size_t) n_threads, sizeof *rw);
+    if (rw == NULL) failed = 1;
+    started = 0;
+    for (int t = 0; t < n_threads && !failed && n_cand > 0; ++t, ++started) {
+        rw[t] = (refine_worker_t) { cfg, obj, cand, n_cand, jul_now, step_jul,
+                                    t, n_threads, NULL, 0, 0, 0 };
+        if (pthread_create(&tid[t], NULL, refine_worker_fn, &rw[t]) != 0) { failed = 1; break; }
+    }
+    for (int t = 0; t < started; ++t) pthread_join(tid[t], NULL);
+    free(tid);
+
+    size_t n_ev = 0;
+    for (int t = 0; rw && t < n_threads; ++t) {
+        failed |= rw[t].failed;
+        n_ev += rw[t].n_ev;
+    }
+    screen_event_t *ev = n_ev ? malloc(n_ev * sizeof *ev) : NULL;
+    if (n_ev && ev == NULL) failed = 1;
+    for (size_t t = 0, off = 0; rw && t < (size_t) n_threads; ++t) {
+        if (ev && rw[t].n_ev) memcpy(ev + off, rw[t].ev, rw[t].n_ev * sizeof *ev);
+        off += rw[t].n_ev;
+        free(rw[t].ev);
+    }
+    free(rw);
+    free(cand);
+
+    if (failed) {
+        fprintf(stderr, "conjunction: screen failed (out of memory or threads)\n");
+        free(ev); free(obj); free(peri); free(apo); free(cat);
+        return 1;
+    }
+    if (ev) qsort(ev, n_ev, sizeof *ev, cmp_event_tca);
+
+    printf("  screened in        %.1f s   %zu candidates refined   %zu encounters\n\n",
+           mono_seconds() - t_start, n_cand, n_ev);
+    if (n_ev == 0) {
+        printf("No conjunction within %.3g km over the next %.3g days.\n",
+               cfg->threshold_km, cfg->days);
+    } else {
+        printf("CONJUNCTIONS FOUND (within %.3g km)\n", cfg->threshold_km);
+        printf("  %-27s  %-10s  %-11s  %-11s  %-11s  %6s  %-9s  %s\n",
+               "TCA", "miss", "radial", "along", "cross", "v km/s", "Pc", "objects");
+        for (size_t e = 0; e < n_ev; ++e) {
+            char utc[40], miss[32], cr[32], ca[32], cc[32];
+            fmt_utc_ms(ev[e].tca, utc, sizeof utc);
+            fmt_mag(ev[e].e.range, miss, sizeof miss);
+            fmt_len(ev[e].e.radial, cr, sizeof cr);
+            fmt_len(ev[e].e.along,  ca, sizeof ca);
+            fmt_len(ev[e].e.cross,  cc, sizeof cc);
+            printf("  %-27s  %-10s  %-11s  %-11s  %-11s  %6.3f  %-9.2e  %s  x  %s\n",
+                   utc, miss, cr, ca, cc, ev[e].e.rel_speed, ev[e].e.pc,
+                   obj[ev[e].i]->tle_ready.sat_name, obj[ev[e].j]->tle_ready.sat_name);
+        }
+    }
+    int found = n_ev > 0;
+    free(ev); free(obj); free(peri); free(apo); free(cat);
+    return found ? 0 : 2;
+}
+
+// ---- two-object scan -------------------------------------------------------
+
+// The two-object search cuts its coarse grid into blocks of SCAN_BLOCK_STEPS
+// grid times. Worker threads claim blocks in time order, propagate both
+// objects across a block with one batch call each, and refine the block's
+// local minima to TCA. In first-match mode a block holding a reportable
+// encounter stops the claiming of later blocks, so the scan does little more
+// work past the first event than a serial scan would.
+#define SCAN_BLOCK_STEPS 2048
+
+typedef struct {
+    double tca, d_tca;      // refined local minimum: Julian date, km
+} scan_min_t;
+
+typedef struct {
+    scan_min_t *mins;       // in time order
+    size_t      n_mins, cap_mins;
+    double      coarse_min, coarse_min_t;   // smallest grid sample, km / JD
+} scan_block_t;
+
+typedef struct {
+    const args_t   *cfg;
+    object_t       *a, *b;
+    double          jul0, step_jul;
+    long            n_steps;        // grid times 0 .. n_steps-1
+    long            n_blocks;
+    scan_block_t   *blocks;
+    pthread_mutex_t mu;
+    long            next_block;     // next block to claim (under mu)
+    long            stop_block;     // earliest block with an event (first-match, under mu)
+    int             failed;         // under mu
+} scan_t;
+
+// Scan grid times [k_lo, k_hi) of one block. Samples k_lo-1 .. k_hi are
+// propagated so every local minimum in the block has both neighbours.
+static void scan_block(scan_t *s, long blk, double *pa, double *pb, double *dist)
+{
+    scan_block_t *out = &s->blocks[blk];
+    long k_lo = blk * SCAN_BLOCK_STEPS;
+    long k_hi = k_lo + SCAN_BLOCK_STEPS;
+    if (k_hi > s->n_steps) k_hi = s->n_steps;
+    long r_lo = k_lo > 0 ? k_lo - 1 : 0;
+    long r_hi = k_hi < s->n_steps ? k_hi : s->n_steps - 1;
+    int rows = (int) (r_hi - r_lo + 1);
+    double jul_lo = s->jul0 + (double) r_lo * s->step_jul;
+    sgp4_propagate_grid(&s->a->ctx, jul_lo, s->cfg->step_sec, rows, pa, NULL);
+    sgp4_propagate_grid(&s->b->ctx, jul_lo, s->cfg->step_sec, rows, pb, NULL);
+    for (int r = 0; r < rows; ++r) {
+        double dx = pb[r] - pa[r];
+        double dy = pb[rows + r] - pa[rows + r];
+        double dz = pb[2 * rows + r] - pa[2 * rows + r];
+        dist[r] = sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    out->coarse_min = 1e300;
+    for (long k = k_lo; k < k_hi; ++k) {
+        const double *d = dist + (k - r_lo);
+        if (d[0] < out->coarse_min) {
+            out->coarse_min = d[0];
+            out->coarse_min_t = s->jul0 + (double) k * s->step_jul;
+        }
+        // Interior local minimum: the sample is the lowest of three.
+        if (k < 1 || k + 1 >= s->n_steps || !(d[0] <= d[-1] && d[0] <= d[1]))
+            continue;
+        double tca = refine_tca(s->a, s->b, s->jul0 + (double) (k - 1) * s->step_jul,
+                                s->jul0 + (double) (k + 1) * s->step_jul);
+        double d_tca = separation_km(s->a, s->b, tca);
+        if (out->n_mins == out->cap_mins) {
+            size_t ncap = out->cap_mins ? out->cap_mins * 2 : 16;
+            scan_min_t *grown = realloc(out->mins, ncap * sizeof *grown);
+            if (!grown) {
+                pthread_mutex_lock(&s->mu);
+                s->failed = 1;
+                pthread_mutex_unlock(&s->mu);
+                return;
+            }
+            out->mins = grown;
+            out->cap_mins = ncap;
+        }
+        out->mins[out->n_mins++] = (scan_min_t) { tca, d_tca };
+        if (d_tca <= s->cfg->threshold_km && !s->cfg->all) {
+            pthread_mutex_lock(&s->mu);
+            if (blk < s->stop_block) s->stop_block = blk;
+            pthread_mutex_unlock(&s->mu);
+            return;
+        }
+    }
+}
+
+static void *scan_worker_fn(void *arg)
+{
+    scan_t *s = arg;
+    size_t cap = SCAN_BLOCK_STEPS + 2;
+    double *pa = malloc(3 * cap * sizeof *pa);
+    double *pb = malloc(3 * cap * sizeof *pb);
+    double *dist = malloc(cap * sizeof *dist);
+    int ok = pa && pb && dist;
+    for (;;) {
+        pthread_mutex_lock(&s->mu);
+        if (!ok) s->failed = 1;
+        long blk = s->next_block++;
+        int done = s->failed || blk >= s->n_blocks || blk > s->stop_block;
+        pthread_mutex_unlock(&s->mu);
+        if (done) break;
+        scan_block(s, blk, pa, pb, dist);
+    }
+    free(pa);
+    free(pb);
+    free(dist);
+    return NULL;
+}
+
+// Scan cfg->days of the a-b separation from jul0 on n_threads workers. On
+// return s->blocks[0 .. min(stop_block, n_blocks-1)] hold the results; the
+// caller frees them with scan_free. Returns 0, or -1 on allocation failure.
+static int run_scan(scan_t *s, const args_t *cfg, object_t *a, object_t *b,
+                    double jul0, int n_threads)
+{
+    memset(s, 0, sizeof *s);
+    s->cfg = cfg; s->a = a; s->b = b;
+    s->jul0 = jul0;
+    s->step_jul = cfg->step_sec / 86400.0;
+    // Grid times jul0 + k*step for k = 0 .. n_steps-1, the last within half
+    // a step of the window end.
+    s->n_steps = (long) floor(cfg->days / s->step_jul + 0.5) + 1;
+    s->n_blocks = (s->n_steps + SCAN_BLOCK_STEPS - 1) / SCAN_BLOCK_STEPS;
+    s->stop_block = s->n_blocks;
+    s->blocks = calloc((size_t) s->n_blocks, sizeof *s->blocks);
+    if (s->blocks == NULL) return -1;
+    pthread_mutex_init(&s->mu, NULL);
+
+    if (n_threads > s->n_blocks) n_threads = (int) s->n_blocks;
+    pthread_t *tid = calloc((size_t) n_threads, sizeof *tid);
+    int started = 0;
+    for (int t = 0; tid && t < n_threads; ++t, ++started)
+        if (pthread_create(&tid[t], NULL, scan_worker_fn, s) != 0) break;
+    for (int t = 0; t < started; ++t) pthread_join(tid[t], NULL);
+    free(tid);
+    // No thread could start: scan on this one.
+    if (started == 0) scan_worker_fn(s);
+    pthread_mutex_destroy(&s->mu);
+    return s->failed ? -1 : 0;
+}
+
+static void scan_free(scan_t *s)
+{
+    for (long blk = 0; s->blocks && blk < s->n_blocks; ++blk)
+        free(s->blocks[blk].mins);
+    free(s->blocks);
+    s->blocks = NULL;
+}
+
 int main(int argc, char **argv)
 {
     if (sso_version_handle(argc, argv, "conjunction")) return 0;
@@ -623,6 +1320,20 @@ int main(int argc, char **argv)
         case PARSE_ERROR: return 1;
     }
 
+    if (cfg.catalog) {
+        if (!cfg.threshold_set) cfg.threshold_km = DEF_SCREEN_THRESHOLD_KM;
+        if (cfg.name2 || cfg.file2 || (cfg.file1 && !cfg.name1)) {
+            fprintf(stderr, "Usage: conjunction [<tle-file> <name1>] --catalog=<file> [options]\n"
+                            "       (try --help)\n");
+            return 1;
+        }
+        if (cfg.plot) { fprintf(stderr, "conjunction: --plot is not available with --catalog\n"); return 1; }
+        if (!(cfg.days > 0.0))      { fprintf(stderr, "conjunction: --days must be > 0\n"); return 1; }
+        if (!(cfg.step_sec > 0.0))  { fprintf(stderr, "conjunction: --step must be > 0\n"); return 1; }
+        if (!(cfg.threshold_km > 0.0)) { fprintf(stderr, "conjunction: --threshold-km must be > 0\n"); return 1; }
+        if (cfg.threads < 0) { fprintf(stderr, "conjunction: --threads must be >= 0\n"); return 1; }
+        return run_screen(&cfg);
+    }
     if (!cfg.file1 || !cfg.name1 || !cfg.name2) {
         fprintf(stderr, "Usage: conjunction <tle-file> <name1> <name2> [options]\n"
                         "       (try --help)\n");
@@ -632,13 +1343,18 @@ int main(int argc, char **argv)
     if (!(cfg.step_sec > 0.0))  { fprintf(stderr, "conjunction: --step must be > 0\n"); return 1; }
     if (!(cfg.threshold_km > 0.0)) { fprintf(stderr, "conjunction: --threshold-km must be > 0\n"); return 1; }
     if (!(cfg.plot_window_sec > 0.0)) { fprintf(stderr, "conjunction: --plot-window-sec must be > 0\n"); return 1; }
+    if (cfg.threads < 0) { fprintf(stderr, "conjunction: --threads must be >= 0\n"); return 1; }
 
     object_t a, b;
     if (load_object(&a, cfg.file1, cfg.name1) != 0) return 1;
     if (load_object(&b, cfg.file2 ? cfg.file2 : cfg.file1, cfg.name2) != 0) return 1;
 
     double jul_now = now_jul_utc();
-    double jul_end = jul_now + cfg.days;
+    int n_threads = cfg.threads;
+    if (n_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        n_threads = cpus > 0 ? (int) cpus : 1;
+    }
 
     // Header: who, how stale, and the search setup.
     char now_s[40], e1[40], e2[40], age1[32], age2[32];
@@ -654,38 +1370,42 @@ int main(int argc, char **argv)
     printf("    TLE epoch        %s   (age %s)\n", e1, age1);
     printf("  secondary          %s  (NORAD %d)\n", b.tle_ready.sat_name, b.tle_ready.catnr);
     printf("    TLE epoch        %s   (age %s)\n", e2, age2);
-    printf("  window             %.3g days   step %.3g s   threshold %.3g km\n",
-           cfg.days, cfg.step_sec, cfg.threshold_km);
+    printf("  window             %.3g days   step %.3g s   threshold %.3g km   threads %d\n",
+           cfg.days, cfg.step_sec, cfg.threshold_km, n_threads);
     if (a.tle_ready.catnr == b.tle_ready.catnr)
         printf("  NOTE: both objects share NORAD ID %d -- comparing an object with itself?\n",
                a.tle_ready.catnr);
     printf("\n");
 
-    // Coarse scan tracking the previous two samples to spot a local minimum.
-    // Every coarse local minimum is refined to the true time of closest
-    // approach with golden-section search; the first refined minimum below the
-    // threshold is reported (continuing only when --all is set). The smallest
-    // refined minimum over the whole window is kept too, so the "no
-    // conjunction" path can report the real closest approach -- the coarse
-    // sample nearest a fast pass can sit several km off the true minimum, so
-    // we must report the refined value, not the nearest sample.
-    double step_jul = cfg.step_sec / 86400.0;
-    double t_prev2 = 0.0, t_prev1 = 0.0;
-    double d_prev2 = 0.0, d_prev1 = 0.0;
-    int    have2 = 0, have1 = 0;
+    // Coarse scan for local minima of the separation. Every coarse local
+    // minimum is refined to the true time of closest approach; the first
+    // refined minimum below the threshold is reported (continuing only when
+    // --all is set). The smallest refined minimum over the whole window is
+    // kept too, so the "no conjunction" path can report the real closest
+    // approach -- the coarse sample nearest a fast pass can sit several km
+    // off the true minimum, so we must report the refined value, not the
+    // nearest sample. The scan runs on worker threads (run_scan); walking its
+    // blocks in time order here gives the same events a serial scan would.
+    scan_t scan;
+    if (run_scan(&scan, &cfg, &a, &b, jul_now, n_threads) != 0) {
+        fprintf(stderr, "conjunction: scan failed (out of memory)\n");
+        scan_free(&scan);
+        return 1;
+    }
     double best_min = 1e300, best_min_t = jul_now;   // smallest refined minimum
     int    have_best = 0;
     double coarse_min = 1e300, coarse_min_t = jul_now;  // safety net if no local min
     int    found = 0, event_index = 0;
-
-    for (double t = jul_now; t <= jul_end + 0.5 * step_jul; t += step_jul) {
-        double d = separation_km(&a, &b, t);
-        if (d < coarse_min) { coarse_min = d; coarse_min_t = t; }
-
-        // Interior local minimum: middle sample is the lowest of three.
-        if (have2 && have1 && d_prev1 <= d_prev2 && d_prev1 <= d) {
-            double tca = refine_tca(&a, &b, t_prev2, t);
-            double d_tca = separation_km(&a, &b, tca);
+    long   last_block = scan.stop_block < scan.n_blocks ? scan.stop_block
+                                                        : scan.n_blocks - 1;
+    for (long blk = 0; blk <= last_block && !(found && !cfg.all); ++blk) {
+        const scan_block_t *sb = &scan.blocks[blk];
+        if (sb->coarse_min < coarse_min) {
+            coarse_min = sb->coarse_min;
+            coarse_min_t = sb->coarse_min_t;
+        }
+        for (size_t m = 0; m < sb->n_mins; ++m) {
+            double tca = sb->mins[m].tca, d_tca = sb->mins[m].d_tca;
             if (d_tca < best_min) { best_min = d_tca; best_min_t = tca; have_best = 1; }
             if (d_tca <= cfg.threshold_km) {
                 if (!found)
@@ -695,10 +1415,8 @@ int main(int argc, char **argv)
                 if (!cfg.all) break;
             }
         }
-
-        t_prev2 = t_prev1; d_prev2 = d_prev1; have2 = have1;
-        t_prev1 = t;       d_prev1 = d;       have1 = 1;
     }
+    scan_free(&scan);
 
     // The time we plot is the closest refined approach in the window (which,
     // in default first-match mode, is exactly the conjunction we reported);
@@ -19,25 +19,26 @@
 */
 
 #include "argparse.h"
+#include "decay.h"
 #include "prediction.h"
 #include "tle_csv.h"
+#include "tle_io.h"
 
 #include <ctype.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 #include <sgp4sdp4.h>
 
-// Returns the first match on prediction->satellite_ephem.name
-double lifetime(prediction_t *prediction, double jul_utc_start, double delta_t_minutes, double max_years, double min_alt_km)
-{
-    (void) load_tle(prediction);
-    ClearFlag(ALL_FLAGS);
-    select_ephemeris(&prediction->satellite_ephem.tle);
-    double jul_utc = jul_utc_start;
-    update_satellite_position(prediction, jul_utc);
-    double years = 0.0;
+// Steps propagated per sgp4_propagate_grid call.
+#define LIFETIME_BLOCK 1024
 
+// Open /tmp/lifetime_<name>.dat for the satellite's altitude series.
+static FILE *open_series(const prediction_t *prediction, char *filename, size_t cap)
+{
     // Sanitize the satellite name before it lands in a /tmp path: a name with
     // '/' or '..' would otherwise escape the intended file. Keep alnum / . / -
     // and map everything else to '_'.
@@ -49,20 +50,50 @@ double lifetime(prediction_t *prediction, double jul_utc_start, double delta_t_m
         safe[j++] = (isalnum(ch) || ch == '.' || ch == '-') ? (char) ch : '_';
     }
     if (j == 0) safe[0] = '_';
-    char filename[FILENAME_MAX] = {0};
-    snprintf(filename, FILENAME_MAX, "/tmp/lifetime_%s.dat", safe);
+    snprintf(filename, cap, "/tmp/lifetime_%s.dat", safe);
     FILE *file = fopen(filename, "w");
-    if (file == NULL) {
-        fprintf(stderr, "Unable to open %s for writing\n", filename);
-        return -1;
-    }
+    if (file == NULL) fprintf(stderr, "Unable to open %s for writing\n", filename);
+    return file;
+}
+
+// The original minute-by-minute walk, kept behind --brute-force as the
+// reference the adaptive engine is checked against. Writes every step.
+// Returns the first match on prediction->satellite_ephem.name
+static double lifetime_brute_force(prediction_t *prediction, double jul_utc_start, double delta_t_minutes, double max_years, double min_alt_km)
+{
+    if (load_tle(prediction) != 0) return -1;
+    ClearFlag(ALL_FLAGS);
+    select_ephemeris(&prediction->satellite_ephem.tle);
+    double jul_utc = jul_utc_start;
+    update_satellite_position(prediction, jul_utc);
+    double years = 0.0;
+
+    char filename[FILENAME_MAX] = {0};
+    FILE *file = open_series(prediction, filename, sizeof filename);
+    if (file == NULL) return -1;
 
-    while (years < max_years && prediction->satellite_ephem.altitude_km > min_alt_km) {
-        update_satellite_position(prediction, jul_utc);
-        fprintf(file, "%.6f %6.2f\n", years, prediction->satellite_ephem.altitude_km);
-        jul_utc += delta_t_minutes / 1440.0;
-        // Approx, sufficient for this problem
-        years = (jul_utc - jul_utc_start) / 365.25;
+    // Only the altitude is wanted, so propagate LIFETIME_BLOCK steps at a
+    // time on the batch path (SGP4 constants derived once, not per step)
+    // and skip the observer geometry update_satellite_position would add.
+    sgp4_ctx_t ctx;
+    sgp4_ctx_init(&ctx, &prediction->satellite_ephem.tle, isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0);
+    static double pos[3 * LIFETIME_BLOCK];
+    double step_days = delta_t_minutes / 1440.0;
+    double altitude_km = prediction->satellite_ephem.altitude_km;
+    long step = 0;
+    while (years < max_years && altitude_km > min_alt_km) {
+        sgp4_propagate_grid(&ctx, jul_utc, delta_t_minutes * 60.0, LIFETIME_BLOCK, pos, NULL);
+        for (int k = 0; k < LIFETIME_BLOCK && years < max_years && altitude_km > min_alt_km; ++k) {
+            vector_t p = { pos[k], pos[LIFETIME_BLOCK + k], pos[2 * LIFETIME_BLOCK + k], 0.0 };
+            geodetic_t geo;
+            Calculate_LatLonAlt(jul_utc_start + (double) step * step_days, &p, &geo);
+            altitude_km = geo.alt;
+            fprintf(file, "%.6f %6.2f\n", years, altitude_km);
+            step++;
+            // Approx, sufficient for this problem
+            years = (double) step * step_days / 365.25;
+        }
+        jul_utc = jul_utc_start + (double) step * step_days;
     }
 
     fflush(file);
@@ -71,6 +102,193 @@ double lifetime(prediction_t *prediction, double jul_utc_start, double delta_t_m
     return years;
 }
 
+// Adaptive-step estimate through src/orbit/decay.c: one sampled revolution
+// per step, a step per ~1 km of decay, and a delta_t_minutes scan to pin the
+// re-entry. Writes one "years min mean max" altitude line per step.
+// Returns the first match on prediction->satellite_ephem.name
+static double lifetime(prediction_t *prediction, double jul_utc_start, double delta_t_minutes, double max_years, double min_alt_km)
+{
+    if (load_tle(prediction) != 0) return -1;
+    ClearFlag(ALL_FLAGS);
+    select_ephemeris(&prediction->satellite_ephem.tle);
+    sgp4_ctx_t ctx;
+    sgp4_ctx_init(&ctx, &prediction->satellite_ephem.tle, isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0);
+
+    decay_opts_t opts = { .max_years = max_years, .min_alt_km = min_alt_km,
+                          .scan_step_min = delta_t_minutes };
+    decay_result_t res;
+    if (decay_lifetime(&ctx, jul_utc_start, &opts, &res) != 0) {
+        fprintf(stderr, "lifetime: decay estimate failed\n");
+        return -1;
+    }
+
+    char filename[FILENAME_MAX] = {0};
+    FILE *file = open_series(prediction, filename, sizeof filename);
+    if (file == NULL) {
+        decay_result_free(&res);
+        return -1;
+    }
+    for (size_t i = 0; i < res.n_samples; ++i) {
+        const decay_sample_t *s = &res.samples[i];
+        fprintf(file, "%.6f %6.2f %6.2f %6.2f\n", s->years, s->alt_min_km, s->alt_mean_km, s->alt_max_km);
+    }
+    fclose(file);
+
+    double years = res.years;
+    decay_result_free(&res);
+    return years;
+}
+
+// One element set of an --all run.
+typedef struct {
+    char name[64];
+    tle_t tle;          // as Convert_Satellite_Data left it
+    double epoch_jul;
+    double years;       // result; < 0 on failure
+    int reentered;
+} lifetime_job_t;
+
+typedef struct {
+    lifetime_job_t *jobs;
+    size_t n_jobs;
+    int index, n_threads;
+    double max_years, min_alt_km, delta_t_minutes;
+} lifetime_worker_t;
+
+// Each worker takes every n_threads-th job. The SGP4/SDP4 flags and state
+// are per thread, so select_ephemeris and the engine need no locking.
+static void *lifetime_worker_fn(void *arg)
+{
+    lifetime_worker_t *w = arg;
+    for (size_t i = (size_t) w->index; i < w->n_jobs; i += (size_t) w->n_threads) {
+        lifetime_job_t *job = &w->jobs[i];
+        tle_t tle = job->tle;
+        ClearFlag(ALL_FLAGS);
+        select_ephemeris(&tle);
+        sgp4_ctx_t ctx;
+        sgp4_ctx_init(&ctx, &tle, isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0);
+        decay_opts_t opts = { .max_years = w->max_years, .min_alt_km = w->min_alt_km,
+                              .scan_step_min = w->delta_t_minutes };
+        decay_result_t res;
+        job->years = -1.0;
+        if (decay_lifetime(&ctx, job->epoch_jul, &opts, &res) == 0) {
+            job->years = res.years;
+            job->reentered = res.reentered;
+            decay_result_free(&res);
+        }
+    }
+    return NULL;
+}
+
+// Every element set in path whose name starts with name_prefix, in file
+// order: a TLE history for one object gives one job per epoch.
+static int load_jobs(const char *path, const char *name_prefix, lifetime_job_t **out, size_t *count)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error opening %s\n", path);
+        return -1;
+    }
+    lifetime_job_t *jobs = NULL;
+    size_t n = 0, cap = 0;
+    size_t plen = strlen(name_prefix);
+    char name[160], l1[160], l2[160];
+    while (tle_io_read_line(fp, name, sizeof name)) {
+        if (tle_io_is_element_line(name, '1') || tle_io_is_element_line(name, '2')) continue;
+        if (strncmp(name, name_prefix, plen) != 0) continue;
+        if (!tle_io_read_line(fp, l1, sizeof l1) || !tle_io_read_line(fp, l2, sizeof l2)) break;
+
+        // sgp4sdp4 wants card 1 at [0..68] and card 2 at [69..137].
+        char set[139] = {0};
+        size_t la = strlen(l1), lb = strlen(l2);
+        if (la > 69) la = 69;
+        if (lb > 69) lb = 69;
+        memcpy(set, l1, la);
+        memcpy(set + 69, l2, lb);
+        if (!Good_Elements(set)) continue;
+
+        if (n == cap) {
+            size_t ncap = cap ? cap * 2 : 64;
+            lifetime_job_t *grown = realloc(jobs, ncap * sizeof *grown);
+            if (grown == NULL) { free(jobs); fclose(fp); return -1; }
+            jobs = grown;
+            cap = ncap;
+        }
+        lifetime_job_t *job = &jobs[n++];
+        memset(job, 0, sizeof *job);
+        snprintf(job->name, sizeof job->name, "%.*s", (int) (sizeof job->name - 1), name);
+        Convert_Satellite_Data(set, &job->tle);
+        job->epoch_jul = Julian_Date_of_Epoch(job->tle.epoch);
+    }
+    fclose(fp);
+    *out = jobs;
+    *count = n;
+    return 0;
+}
+
+static void format_jul(double jul, char *buf, size_t cap)
+{
+    struct tm t;
+    Date_Time(jul, &t);
+    strftime(buf, cap, "%Y-%m-%d %H:%M", &t);
+}
+
+// --all: estimate from each matching element set's own epoch, in parallel,
+// and tabulate epoch against predicted re-entry date for trend analysis.
+static int lifetime_all(const char *path, const char *name_prefix, int n_threads,
+                        double delta_t_minutes, double max_years, double min_alt_km)
+{
+    lifetime_job_t *jobs = NULL;
+    size_t n_jobs = 0;
+    if (load_jobs(path, name_prefix, &jobs, &n_jobs) != 0) return -1;
+    if (n_jobs == 0) {
+        fprintf(stderr, "Satellite '%s' not found in %s\n", name_prefix, path);
+        free(jobs);
+        return -1;
+    }
+
+    if (n_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        n_threads = cpus > 0 ? (int) cpus : 1;
+    }
+    if ((size_t) n_threads > n_jobs) n_threads = (int) n_jobs;
+    lifetime_worker_t *w = calloc((size_t) n_threads, sizeof *w);
+    pthread_t *tid = calloc((size_t) n_threads, sizeof *tid);
+    int *running = calloc((size_t) n_threads, sizeof *running);
+    if (w == NULL || tid == NULL || running == NULL) {
+        free(running); free(tid); free(w); free(jobs);
+        return -1;
+    }
+    for (int t = 0; t < n_threads; ++t) {
+        w[t] = (lifetime_worker_t) { jobs, n_jobs, t, n_threads, max_years, min_alt_km, delta_t_minutes };
+        running[t] = pthread_create(&tid[t], NULL, lifetime_worker_fn, &w[t]) == 0;
+    }
+    // A share whose thread could not start runs here instead.
+    for (int t = 0; t < n_threads; ++t) {
+        if (running[t]) pthread_join(tid[t], NULL);
+        else lifetime_worker_fn(&w[t]);
+    }
+    free(running);
+    free(tid);
+    free(w);
+
+    printf("%-24s %-16s %9s  %-16s\n", "Name", "Epoch (UTC)", "Years", "Below (UTC)");
+    for (size_t i = 0; i < n_jobs; ++i) {
+        const lifetime_job_t *job = &jobs[i];
+        char epoch[32], reentry[32];
+        format_jul(job->epoch_jul, epoch, sizeof epoch);
+        if (job->years < 0.0)
+            snprintf(reentry, sizeof reentry, "failed");
+        else if (job->reentered)
+            format_jul(job->epoch_jul + job->years * 365.25, reentry, sizeof reentry);
+        else
+            snprintf(reentry, sizeof reentry, "> %.1f years", max_years);
+        printf("%-24.24s %-16s %9.3f  %-16s\n", job->name, epoch, job->years, reentry);
+    }
+    free(jobs);
+    return 0;
+}
+
 // Parsed command-line configuration. parse_args() fills this; main() copies
 // the fields out into the working locals below so the propagation body is
 // unchanged.
@@ -78,6 +296,9 @@ typedef struct {
     const char *satellite_name;  // positional 1: name prefix to match in the TLE
     const char *max_years_arg;   // positional 2: stop after this many years
     char *tle_path;              // --tle=<path>, run through tle_path_resolve
+    int all;                     // --all: every matching element set, from its epoch
+    int threads;                 // --threads=<N> for --all (0 => online CPUs)
+    int brute_force;             // --brute-force: the minute-by-minute walk
 } lifetime_args_t;
 
 // Option column width: the widest label below ("<satellite_name>") + a small
@@ -131,6 +352,22 @@ static int parse_args(lifetime_args_t *a, int argc, char **argv, int help)
             matched = 1;
         }
 
+        if (strcmp(arg, "--all") == 0 || help) {
+            if (help) parse_help_line(OPTW, "--all", "every element set matching the name, each from its own epoch, in parallel");
+            else a->all = 1;
+            matched = 1;
+        }
+        if (strncmp(arg, "--threads=", 10) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--threads=<N>", "worker threads for --all (default: online CPUs)");
+            else a->threads = atoi(arg + 10);
+            matched = 1;
+        }
+        if (strcmp(arg, "--brute-force") == 0 || help) {
+            if (help) parse_help_line(OPTW, "--brute-force", "propagate every minute instead of adaptively (slow; for checking)");
+            else a->brute_force = 1;
+            matched = 1;
+        }
+
         if (!matched && !help) {
             fprintf(stderr, "Unable to parse option '%s'\n", arg);
             return PARSE_ERROR;
@@ -144,16 +381,29 @@ static int parse_args(lifetime_args_t *a, int argc, char **argv, int help)
             "The TLE's empirical drag term is used; do not treat the result as\n"
             "an engineering-grade lifetime prediction.\n"
             "\n"
+            "Steps are adaptive: one revolution is sampled per step, and the step\n"
+            "is sized so the orbit-mean altitude drops about 1 km (at most 10\n"
+            "days), shrinking to single revolutions within 25 km of the threshold.\n"
+            "The crossing is then pinned on a 1-minute grid, so the answer agrees\n"
+            "with --brute-force to the minute unless a dip falls between sampled\n"
+            "revolutions.\n"
+            "\n"
             "OUTPUT\n"
             "\n"
             "  Prints `Years above 100.0 km: <years>` to stdout.\n"
-            "  Writes /tmp/lifetime_<name>.dat with time,altitude samples.\n"
+            "  Writes /tmp/lifetime_<name>.dat with one `years min mean max` line\n"
+            "  per step (altitude over the sampled revolution, km); --brute-force\n"
+            "  writes a `years altitude` line per minute instead.\n"
+            "  --all prints one row per element set (epoch, years, date below the\n"
+            "  threshold) and writes no file.\n"
             "\n"
             "EXAMPLE\n"
             "\n"
             "  lifetime 'ISS (ZARYA)' 20 --tle=TLEs/amateur.tle\n"
             "  # then plot the result:\n"
             "  gnuplot -p -e \"plot '/tmp/lifetime_ISS (ZARYA).dat' with lines\"\n"
+            "  # re-entry trend across a TLE history for one object:\n"
+            "  lifetime 'ISS (ZARYA)' 20 --all --tle=iss_history.tle\n"
             "\n"
             "ACCURACY CAVEATS\n"
             "\n"
@@ -189,7 +439,12 @@ int main(int argc, char **argv)
         case PARSE_ERROR: return EXIT_FAILURE;
     }
     if (cfg.satellite_name == NULL || cfg.max_years_arg == NULL) {
-        fprintf(stderr, "usage: lifetime <satellite_name> <max_years> [--tle=<path>] (try --help)\n");
+        fprintf(stderr, "usage: lifetime <satellite_name> <max_years> [--tle=<path>] [--all] (try --help)\n");
+        return EXIT_FAILURE;
+    }
+
+    if (cfg.threads < 0) {
+        fprintf(stderr, "lifetime: --threads must be >= 0\n");
         return EXIT_FAILURE;
     }
 
@@ -216,7 +471,14 @@ int main(int argc, char **argv)
     UTC_Calendar_Now(&utc, &tv);
     double jul_utc = Julian_Date(&utc, &tv);
 
-    double years = lifetime(&prediction, jul_utc, 1.0, max_years, min_alt_km);
+    if (cfg.all)
+        return lifetime_all(prediction.tles_filename, cfg.satellite_name, cfg.threads,
+                            1.0, max_years, min_alt_km) == 0 ? 0 : EXIT_FAILURE;
+
+    double years = cfg.brute_force
+        ? lifetime_brute_force(&prediction, jul_utc, 1.0, max_years, min_alt_km)
+        : lifetime(&prediction, jul_utc, 1.0, max_years, min_alt_km);
+    if (years < 0.0) return EXIT_FAILURE;
     printf("Years above %.1f km: %.3f\n", min_alt_km, years);
 
     return 0;
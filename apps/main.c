@@ -41,6 +41,7 @@
 #include "auto_tcmd.h"
 #include "cmd_line.h"
 #include "input.h"
+#include "lat_trace.h"
 #include "live_waterfall.h"
 #include "tx_compose.h"
 #include "viewer.h"
@@ -345,7 +346,11 @@ int main(int argc, char **argv)
         double t_now = monotonic_seconds();
         UTC_Calendar_Now(&utc, &tv);
         jul_utc = Julian_Date(&utc, &tv);
+        tracking_refresh_pass_cache(&state, jul_utc);
         update_satellite_position(&state.track.prediction, jul_utc);
+        // Fold the worker / DB-writer latency marks into the histograms
+        // so their per-thread rings never fill (lat_trace.h).
+        lat_trace_collect();
 
         // Drain whatever the T/R switch emitted since the last tick.
         // Non-blocking; the firmware beats every ~2.5 s so most ticks
@@ -423,6 +428,7 @@ int main(int argc, char **argv)
                     rx_session_request_wav_stop(state.sdr.rx_session);
                     t_recording_close_at = 0.0;
                     sso_audit_event("rec-stop", "trigger=postroll-expired");
+                    pass_session_write_latency(&state);
                 }
             }
         }
@@ -483,7 +489,7 @@ int main(int argc, char **argv)
             refresh();
             int show_hw_cursor = 0;
             if (state.tx.tx_compose_active && state.tx.tx_compose_win) {
-                touchwin(state.tx.tx_compose_win);
+                touchwin((WINDOW *) state.tx.tx_compose_win);
                 wrefresh(state.tx.tx_compose_win);
                 tx_field_t f = state.tx.tx_compose.focus;
                 show_hw_cursor = (f == TXF_PAYLOAD || f == TXF_POWER);
@@ -494,7 +500,7 @@ int main(int argc, char **argv)
                 // stale. Gated to the 2 Hz redraw cadence (this block itself
                 // runs every tick while a modal is open). See ui/auto_tcmd.c.
                 if (redraw_due) auto_tcmd_refresh(&state);
-                touchwin(state.tx.auto_tcmd_win);
+                touchwin((WINDOW *) state.tx.auto_tcmd_win);
                 wrefresh(state.tx.auto_tcmd_win);
                 show_hw_cursor = (state.tx.auto_tcmd.state != AUTO_STATE_RUNNING)
                               && auto_field_is_text(state.tx.auto_tcmd.focus);
@@ -534,7 +540,39 @@ int main(int argc, char **argv)
         // lived here previously fired every 1–10 seconds during a
         // pass and caused brief phase resets in the coherent demod
         // chain; this loop runs every tick at full precision.
-        if (state.sdr.rx_session && state.track.doppler_correction_enabled) {
+        //
+        // During a pass the worker owns the correction instead: the whole
+        // pass's Doppler curve is handed over once (and again whenever the
+        // pass table is rebuilt) and the pump ramps the NCO from its own
+        // sample clock, so UI load no longer moves the RF frequency. The
+        // per-tick offset below only fills in outside that trajectory.
+        if (state.sdr.rx_session && state.track.doppler_track_stale) {
+            double t0_unix = 0.0;
+            double *offsets = NULL;
+            size_t n = tracking_doppler_trajectory(&state.track,
+                                                   DOPPLER_TRACK_STEP_S,
+                                                   &t0_unix, &offsets);
+            if (rx_session_set_doppler_track(state.sdr.rx_session, t0_unix,
+                                             DOPPLER_TRACK_STEP_S,
+                                             offsets, n) == 0) {
+                state.track.doppler_track_stale = 0;
+            }
+            free(offsets);
+            // --rx-channel satellites: their own curves over the same
+            // window. Outside it a channel runs uncorrected.
+            for (int k = 0; k < state.sdr.n_rx_channels; k++) {
+                n = tracking_channel_doppler_trajectory(&state.track,
+                        state.sdr.rx_channels[k].name,
+                        state.sdr.rx_channels[k].freq_hz,
+                        DOPPLER_TRACK_STEP_S, &t0_unix, &offsets);
+                rx_session_set_channel_doppler_track(state.sdr.rx_session, k,
+                                                     t0_unix, DOPPLER_TRACK_STEP_S,
+                                                     offsets, n);
+                free(offsets);
+            }
+        }
+        if (state.sdr.rx_session && state.track.doppler_correction_enabled
+            && !rx_session_doppler_track_live(state.sdr.rx_session)) {
             double offset = state.track.doppler_downlink_frequency_hz
                           - state.track.nominal_downlink_frequency_hz;
             rx_session_set_doppler_offset(state.sdr.rx_session, offset);
@@ -640,6 +678,7 @@ int main(int argc, char **argv)
     // Free any plan that survived (mid-pass exit / crash on a key
     // before the LOS branch had a chance to clear it).
     main_pursuit_clear_plan(&state.rot);
+    prediction_free_pass_cache(&state.track.prediction);
     if (state.op.ipc) {
         sso_ipc_server_close(state.op.ipc);
         state.op.ipc = NULL;
@@ -667,6 +706,7 @@ int main(int argc, char **argv)
         rx_session_request_wav_stop(state.sdr.rx_session);
         rx_session_close(state.sdr.rx_session);
         state.sdr.rx_session = NULL;
+        pass_session_write_latency(&state);
     }
 
     // Any in-flight `:spectrum N` worker is touching the same WAV / IQ
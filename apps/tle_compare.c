@@ -39,6 +39,7 @@
 #include <ncurses.h>
 
 #include <math.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -46,14 +47,15 @@
 #include <time.h>
 #include <unistd.h>
 
-#define MAX_OBJECTS        8
+#define MAX_OBJECTS        40       // a rideshare's worth of catalog objects
+#define MAX_THREADS        16
 #define LIGHT_KM_S         299792.458
 #define GM_KM3_S2          398600.4418   // Earth standard gravitational parameter
 #define EARTH_RADIUS_KM    6378.137      // WGS84 equatorial radius
 #define DEFAULT_FREQ_MHZ   436.150
 #define DEFAULT_WINDOW_MIN 1440.0   // 24 h forward search for the next pass
 #define NAME_COL           16       // table label width
-#define PASS_REFRESH_S     10       // recompute next-pass cadence (seconds)
+#define PASS_REFRESH_S     10       // no-pass retry and drift-block cadence (seconds)
 
 typedef struct {
     char         name[64];      // requested name prefix, matched in the file
@@ -64,11 +66,14 @@ typedef struct {
     double az, el, range_km, rr_km_s, lat, lon, alt_km, speed_km_s;
     double doppler_hz;
 
-    // Next pass, refreshed on the PASS_REFRESH_S cadence.
+    // Next pass. Held until its LOS goes by; with no pass in the window
+    // the search is retried on the PASS_REFRESH_S cadence.
     int    has_pass;            // a pass was found in the window
     int    in_pass;             // currently above the horizon
     double aos_jul, los_jul;    // crossings, to ~1 s
     double max_el, aos_az, dur_min;
+    double pass_search_jul;     // when find_pass last ran; 0 = never
+    unsigned pass_gen;          // bumps each time find_pass runs
 
     // select_ephemeris() converts the TLE units in place and must run
     // exactly once. We run it once at setup, capture the converted
@@ -77,6 +82,7 @@ typedef struct {
     // re-converts (and thus corrupts) the elements.
     tle_t  tle_ready;
     int    deep_space;
+    sgp4_ctx_t ctx;             // batch-propagation copy of tle_ready
 
     // Orbit shape from the elements (constant for the loaded TLE),
     // computed once at setup. Apogee/perigee as altitudes above the
@@ -89,7 +95,10 @@ typedef struct {
     // Worst-case on-sky angle (deg) from object 0 over object 0's next
     // pass; the pointing error if we tracked object 0 but this object
     // was really our bird. -1 until computed (object 0 itself: unused).
+    // Only depends on object 0's pass, so it is kept until that changes.
     double pass_max_sep_deg;
+    unsigned sep_for_gen;       // objs[0].pass_gen it was computed for
+    int    sep_valid;
 
     // Signed along-track time offset vs object 0 (seconds): the time for
     // this object to reach object 0's current track point (+ = trails,
@@ -212,6 +221,7 @@ static void setup_object(obj_t *o)
     // tle.epoch is the raw YYDDD.ddddd field (select_ephemeris leaves it
     // alone); Julian_Date_of_Epoch turns it into a Julian date.
     o->epoch_jul = Julian_Date_of_Epoch(o->tle_ready.epoch);
+    sgp4_ctx_init(&o->ctx, &o->tle_ready, o->deep_space);
 }
 
 // sgp4sdp4 keeps the chosen ephemeris and its init state in module-level
@@ -313,98 +323,110 @@ static void find_pass(obj_t *o, double jul_now, double window_min)
 // objects over [j0, j1], in degrees. This is the on-sky angle the
 // antenna would have to swing through if it tracked one object while
 // the other was the real target — i.e. the worst-case pointing error
-// over the pass. Both predictions are left propagated at an arbitrary
-// time; the caller restores live state next tick.
+// over the pass. Both objects are propagated over the 5 s grid on the
+// batch path and turned into look angles directly, so neither
+// prediction's live state is touched.
+#define SEP_STEP_S 5.0
 static double max_sep_over(obj_t *a, obj_t *b, double j0, double j1)
 {
+    int n = (int) floor((j1 - j0) * 86400.0 / SEP_STEP_S) + 1;
+    if (n < 1) return -1.0;
+    double *buf = malloc((size_t) n * 12 * sizeof *buf);
+    if (buf == NULL) return -1.0;
+    double *pa = buf, *va = buf + 3 * n, *pb = buf + 6 * n, *vb = buf + 9 * n;
+    sgp4_propagate_grid(&a->ctx, j0, SEP_STEP_S, n, pa, va);
+    sgp4_propagate_grid(&b->ctx, j0, SEP_STEP_S, n, pb, vb);
+
     double maxsep = -1.0;
-    for (double t = j0; t <= j1; t += 5.0 / 86400.0) {   // 5 s steps
-        prep_object(a);
-        update_satellite_position(&a->pred, t);
-        double az1 = a->pred.satellite_ephem.azimuth;
-        double el1 = a->pred.satellite_ephem.elevation;
-        prep_object(b);
-        update_satellite_position(&b->pred, t);
-        double az2 = b->pred.satellite_ephem.azimuth;
-        double el2 = b->pred.satellite_ephem.elevation;
-        double s = separation_deg(az1, el1, az2, el2);
+    for (int k = 0; k < n; ++k) {
+        double t = j0 + (double) k * SEP_STEP_S / 86400.0;
+        vector_t obs1, obs2;
+        vector_t r1 = { pa[k], pa[n + k], pa[2 * n + k], 0.0 };
+        vector_t v1 = { va[k], va[n + k], va[2 * n + k], 0.0 };
+        vector_t r2 = { pb[k], pb[n + k], pb[2 * n + k], 0.0 };
+        vector_t v2 = { vb[k], vb[n + k], vb[2 * n + k], 0.0 };
+        geodetic_t g1 = a->pred.observer_ephem.position_geodetic;
+        geodetic_t g2 = b->pred.observer_ephem.position_geodetic;
+        Calculate_Obs(t, &r1, &v1, &g1, &obs1);
+        Calculate_Obs(t, &r2, &v2, &g2, &obs2);
+        double s = separation_deg(Degrees(obs1.x), Degrees(obs1.y),
+                                  Degrees(obs2.x), Degrees(obs2.y));
         if (s > maxsep) maxsep = s;
     }
+    free(buf);
     return maxsep;
 }
 
-// Fill each subsequent object's worst-case on-sky separation from the
-// first object across the FIRST object's next pass. Requires find_pass
-// to have run for all objects already. -1 means not computed.
-static void compute_pass_separations(obj_t *objs, int n)
+// Object b's worst-case on-sky separation from object a across a's next
+// pass, recomputed only when a's pass has changed since the last time.
+// find_pass must have run for a already. -1 means no pass to measure.
+static void pass_separation(obj_t *a, obj_t *b)
 {
-    for (int i = 1; i < n; ++i) objs[i].pass_max_sep_deg = -1.0;
-    if (n < 2 || !objs[0].loaded || !objs[0].has_pass) return;
-    for (int i = 1; i < n; ++i) {
-        if (!objs[i].loaded) continue;
-        objs[i].pass_max_sep_deg =
-            max_sep_over(&objs[0], &objs[i], objs[0].aos_jul, objs[0].los_jul);
-    }
+    if (b->sep_valid && b->sep_for_gen == a->pass_gen) return;
+    b->pass_max_sep_deg = -1.0;
+    if (a->has_pass)
+        b->pass_max_sep_deg = max_sep_over(a, b, a->aos_jul, a->los_jul);
+    b->sep_for_gen = a->pass_gen;
+    b->sep_valid = 1;
 }
 
-// ECI position + velocity (km, km/s) at a Julian date, straight from
-// SGP4/SDP4. We call the propagator directly rather than going through
-// update_satellite_position because that routine overwrites the
-// satellite position vector with the observer's (it reuses the field),
-// and the along-track time offset below needs the true satellite state.
-static void sat_state(obj_t *o, double jul, vector_t *pos, vector_t *vel)
+// ECI positions (km) and velocities (km/s) of one object at n grid times
+// t0 + k*step_days, straight from SGP4/SDP4 on the batch path, as
+// structure-of-arrays (see sgp4_propagate_grid). We propagate directly
+// rather than going through update_satellite_position because that routine
+// overwrites the satellite position vector with the observer's (it reuses
+// the field), and the along-track time offset below needs the true state.
+static void sat_grid(const obj_t *o, double t0, double step_days, int n,
+                     double *pos, double *vel)
 {
-    prep_object(o);
-    double jul_epoch = Julian_Date_of_Epoch(o->tle_ready.epoch);
-    double tsince = (jul - jul_epoch) * 1440.0;
-    if (o->deep_space) SDP4(tsince, &o->pred.satellite_ephem.tle, pos, vel);
-    else               SGP4(tsince, &o->pred.satellite_ephem.tle, pos, vel);
-    Convert_Sat_State(pos, vel);            // canonical units -> km, km/s
+    sgp4_propagate_grid(&o->ctx, t0, step_days * 86400.0, n, pos, vel);
 }
 
 // Signed along-track time offset (seconds) of object b relative to a at
 // one instant: the dt that brings b (moving along its velocity) closest
 // to a's current position. dt = (r_a - r_b) . v_b / |v_b|^2. Positive
 // means b must advance to reach a's track point, i.e. b trails a.
-static double along_track_dtsec(const vector_t *ra,
-                                const vector_t *rb, const vector_t *vb)
+// Inputs are element k of sat_grid's n-long SoA arrays.
+static double along_track_dtsec(const double *ra, const double *rb,
+                                const double *vb, int n, int k)
 {
-    double vv = vb->x * vb->x + vb->y * vb->y + vb->z * vb->z;
+    double vv = vb[k] * vb[k] + vb[n + k] * vb[n + k] + vb[2 * n + k] * vb[2 * n + k];
     if (vv <= 0.0) return 0.0;
-    double dot = (ra->x - rb->x) * vb->x
-               + (ra->y - rb->y) * vb->y
-               + (ra->z - rb->z) * vb->z;
+    double dot = (ra[k] - rb[k]) * vb[k]
+               + (ra[n + k] - rb[n + k]) * vb[n + k]
+               + (ra[2 * n + k] - rb[2 * n + k]) * vb[2 * n + k];
     return dot / vv;
 }
 
-// For each subsequent object, the min and max signed along-track time
-// offset vs object 0, sampled across object 0's full orbital period.
-static void compute_orbit_dtsec(obj_t *objs, int n, double jul_now)
+// Object 0's positions over its full orbital period from now, sampled
+// ORBIT_DT_N times: the reference track every other object's along-track
+// offset is measured against. Returns 0, or -1 with no usable period.
+enum { ORBIT_DT_N = 601 };
+static int orbit_track(const obj_t *a, double jul_now, double *pa, double *step_days)
 {
-    for (int i = 1; i < n; ++i) objs[i].dtsec_valid = 0;
-    if (n < 2 || !objs[0].loaded) return;
-    double xno = objs[0].tle_ready.xno;             // rad/min
-    if (!(xno > 0.0)) return;
+    double xno = a->tle_ready.xno;                  // rad/min
+    if (!(xno > 0.0)) return -1;
     double period_days = (2.0 * M_PI / xno) / 1440.0;
+    *step_days = period_days / (double) (ORBIT_DT_N - 1);
+    sat_grid(a, jul_now, *step_days, ORBIT_DT_N, pa, NULL);
+    return 0;
+}
 
-    const int N = 600;
-    double step = period_days / (double) N;
-    for (int i = 1; i < n; ++i) {
-        if (!objs[i].loaded) continue;
-        double mn = 1e30, mx = -1e30;
-        for (int k = 0; k <= N; ++k) {
-            double t = jul_now + (double) k * step;
-            vector_t pa, va, pb, vb;
-            sat_state(&objs[0], t, &pa, &va);
-            sat_state(&objs[i], t, &pb, &vb);
-            double dt = along_track_dtsec(&pa, &pb, &vb);
-            if (dt < mn) mn = dt;
-            if (dt > mx) mx = dt;
-        }
-        objs[i].dtsec_min = mn;
-        objs[i].dtsec_max = mx;
-        objs[i].dtsec_valid = (mx >= mn);
+// Object b's min and max signed along-track time offset vs object 0,
+// sampled along object 0's track from orbit_track.
+static void orbit_dtsec(obj_t *b, const double *pa, double jul_now, double step_days)
+{
+    double pb[3 * ORBIT_DT_N], vb[3 * ORBIT_DT_N];
+    sat_grid(b, jul_now, step_days, ORBIT_DT_N, pb, vb);
+    double mn = 1e30, mx = -1e30;
+    for (int k = 0; k < ORBIT_DT_N; ++k) {
+        double dt = along_track_dtsec(pa, pb, vb, ORBIT_DT_N, k);
+        if (dt < mn) mn = dt;
+        if (dt > mx) mx = dt;
     }
+    b->dtsec_min = mn;
+    b->dtsec_max = mx;
+    b->dtsec_valid = (mx >= mn);
 }
 
 // Mean signed along-track offset (seconds) of b vs a over one orbit of
@@ -412,45 +434,38 @@ static void compute_orbit_dtsec(obj_t *objs, int n, double jul_now)
 // wobble and leaves the secular offset that drifts day to day.
 static double orbit_mean_dtsec(obj_t *a, obj_t *b, double jul, double period_days)
 {
-    const int K = 48;
+    enum { K = 48 };
+    double pa[3 * K], pb[3 * K], vb[3 * K];
+    sat_grid(a, jul, period_days / (double) K, K, pa, NULL);
+    sat_grid(b, jul, period_days / (double) K, K, pb, vb);
     double sum = 0.0;
-    for (int k = 0; k < K; ++k) {
-        double t = jul + period_days * (double) k / (double) K;
-        vector_t pa, va, pb, vb;
-        sat_state(a, t, &pa, &va);
-        sat_state(b, t, &pb, &vb);
-        sum += along_track_dtsec(&pa, &pb, &vb);
-    }
+    for (int k = 0; k < K; ++k)
+        sum += along_track_dtsec(pa, pb, vb, K, k);
     return sum / (double) K;
 }
 
-// For each subsequent object, linear-fit the orbit-mean along-track
-// offset vs object 0 over a window centred on now (-days .. +days), so
-// we can see whether it has been and is drifting apart or closing on
-// average. Fills trend_start/now/end/rate.
-static void compute_alongtrack_trend(obj_t *objs, int n, double jul_now, double days)
+// The orbit-mean along-track offset of b vs object 0 over a window
+// centred on now (-days .. +days), so we can see whether it has been and
+// is drifting apart or closing on average. Fills trend_start/now/end/rate.
+static void alongtrack_trend(obj_t *a, obj_t *b, double jul_now, double days)
 {
-    for (int i = 1; i < n; ++i) objs[i].trend_valid = 0;
-    if (n < 2 || !objs[0].loaded || days <= 0.0) return;
-    double xno = objs[0].tle_ready.xno;             // rad/min
-    if (!(xno > 0.0)) return;
+    b->trend_valid = 0;
+    double xno = a->tle_ready.xno;                  // rad/min
+    if (days <= 0.0 || !(xno > 0.0)) return;
     double period_days = (2.0 * M_PI / xno) / 1440.0;
 
     // Sample the actual orbit-mean offset at -days, now, and +days rather
     // than least-squares fitting: for a fast-drifting object the offset is
     // not linear over the window, and a fit intercept would disagree with
     // the instantaneous value. The endpoints give an honest average rate.
-    for (int i = 1; i < n; ++i) {
-        if (!objs[i].loaded) continue;
-        double ys = orbit_mean_dtsec(&objs[0], &objs[i], jul_now - days, period_days);
-        double yn = orbit_mean_dtsec(&objs[0], &objs[i], jul_now,        period_days);
-        double ye = orbit_mean_dtsec(&objs[0], &objs[i], jul_now + days, period_days);
-        objs[i].trend_start_s        = ys;
-        objs[i].trend_now_s          = yn;
-        objs[i].trend_end_s          = ye;
-        objs[i].trend_rate_s_per_day = (ye - ys) / (2.0 * days);
-        objs[i].trend_valid          = 1;
-    }
+    double ys = orbit_mean_dtsec(a, b, jul_now - days, period_days);
+    double yn = orbit_mean_dtsec(a, b, jul_now,        period_days);
+    double ye = orbit_mean_dtsec(a, b, jul_now + days, period_days);
+    b->trend_start_s        = ys;
+    b->trend_now_s          = yn;
+    b->trend_end_s          = ye;
+    b->trend_rate_s_per_day = (ye - ys) / (2.0 * days);
+    b->trend_valid          = 1;
 }
 
 // Verdict over the trend window from its endpoints. A sign flip means the
@@ -480,6 +495,109 @@ static void compute_live(obj_t *o, double jul_now, double freq_hz)
     o->doppler_hz = -(e->range_rate_km_s / LIGHT_KM_S) * freq_hz;
 }
 
+// ---- per-tick update -------------------------------------------------------
+
+// One tick's work, shared by every worker. Objects are independent once
+// set up: propagation state lives in each object's own prediction_t and
+// sgp4_ctx_t (sgp4sdp4's flags are per thread), so worker w takes objects
+// w, w + n_threads, ... exactly as the lifetime and conjunction workers
+// stride their jobs.
+typedef struct {
+    obj_t        *objs;
+    int           n;
+    double        jul_now, freq_hz, window_min;
+    int           slow;         // PASS_REFRESH_S cadence: dtsec, trend, pass retry
+    const double *track;        // object 0's orbit_track, NULL if unusable
+    double        track_step;
+} tick_t;
+
+typedef struct {
+    tick_t *tick;
+    int     index, n_threads;
+    void  (*fn)(tick_t *, int);
+} tick_worker_t;
+
+// Phase 1, one object: live state, and its next pass when the held one
+// has gone by (or, with none in the window, on the slow cadence).
+static void tick_object(tick_t *tk, int i)
+{
+    obj_t *o = &tk->objs[i];
+    if (!o->loaded) return;
+    double now = tk->jul_now;
+    prep_object(o);
+    compute_live(o, now, tk->freq_hz);
+    if (o->pass_search_jul == 0.0 || (o->has_pass && now > o->los_jul)
+        || (!o->has_pass && tk->slow)) {
+        prep_object(o);
+        find_pass(o, now, tk->window_min);
+        o->pass_search_jul = now;
+        o->pass_gen++;
+    }
+    o->in_pass = o->has_pass && now >= o->aos_jul && now <= o->los_jul;
+}
+
+// Phase 2, one object after the first: the blocks measured against
+// object 0, which phase 1 has brought up to date.
+static void tick_pair(tick_t *tk, int i)
+{
+    obj_t *a = &tk->objs[0], *b = &tk->objs[i];
+    if (i == 0 || !b->loaded) return;
+    pass_separation(a, b);
+    if (!tk->slow) return;
+    b->dtsec_valid = 0;
+    if (tk->track != NULL) orbit_dtsec(b, tk->track, tk->jul_now, tk->track_step);
+    alongtrack_trend(a, b, tk->jul_now, g_trend_days);
+}
+
+static void *tick_worker_fn(void *arg)
+{
+    tick_worker_t *w = arg;
+    for (int i = w->index; i < w->tick->n; i += w->n_threads) w->fn(w->tick, i);
+    return NULL;
+}
+
+// Run fn over every object on n_threads workers; a share whose thread
+// can't be started runs here instead.
+static void tick_run(tick_t *tk, void (*fn)(tick_t *, int), int n_threads)
+{
+    if (n_threads > tk->n) n_threads = tk->n;
+    if (n_threads < 1) n_threads = 1;
+    tick_worker_t w[MAX_THREADS];
+    pthread_t tid[MAX_THREADS];
+    int started[MAX_THREADS] = {0};
+    for (int t = 0; t < n_threads; ++t) {
+        w[t] = (tick_worker_t) { tk, t, n_threads, fn };
+        if (t > 0) started[t] = (pthread_create(&tid[t], NULL, tick_worker_fn, &w[t]) == 0);
+    }
+    tick_worker_fn(&w[0]);
+    for (int t = 1; t < n_threads; ++t) {
+        if (started[t]) pthread_join(tid[t], NULL);
+        else tick_worker_fn(&w[t]);
+    }
+}
+
+// Bring every object up to jul_now: live state each call, passes as they
+// expire, and (slow != 0) the along-track blocks. Separations follow
+// object 0's pass and are redone only when it changes.
+static void update_all(obj_t *objs, int n, double jul_now, double freq_hz,
+                       double window_min, int slow, int n_threads)
+{
+    tick_t tk = { objs, n, jul_now, freq_hz, window_min, slow, NULL, 0.0 };
+    tick_run(&tk, tick_object, n_threads);
+    if (!objs[0].loaded) {
+        for (int i = 1; i < n; ++i) {
+            objs[i].pass_max_sep_deg = -1.0;
+            objs[i].dtsec_valid = 0;
+            objs[i].trend_valid = 0;
+        }
+        return;
+    }
+    double track[3 * ORBIT_DT_N];
+    if (slow && orbit_track(&objs[0], jul_now, track, &tk.track_step) == 0)
+        tk.track = track;
+    tick_run(&tk, tick_pair, n_threads);
+}
+
 // ---- drawing ---------------------------------------------------------------
 
 static void draw(obj_t *objs, int n, double jul_now, double freq_hz,
@@ -650,7 +768,7 @@ static void draw(obj_t *objs, int n, double jul_now, double freq_hz,
         row++;
     }
 
-    mvprintw(row++, 0, "q quit    (live 1 Hz, next pass every %d s)", PASS_REFRESH_S);
+    mvprintw(row++, 0, "q quit    (live 1 Hz, passes held to LOS, drift every %d s)", PASS_REFRESH_S);
     refresh();
 }
 
@@ -790,6 +908,7 @@ typedef struct {
     double      freq_hz;
     double      window_min;
     int         once;
+    int         threads;        // 0 = one per online CPU
     const char *names[MAX_OBJECTS];
     int         n_names;
 } tle_compare_args_t;
@@ -898,6 +1017,15 @@ static int parse_args(tle_compare_args_t *a, int argc, char **argv, int help)
             else g_trend_days = atof(arg + 13);
             matched = 1;
         }
+        if (strcmp(arg, "--threads") == 0 || help) {
+            if (help) { parse_help_line(OPTW, "--threads <N>", "worker threads for the per-object updates (default: online CPUs)"); matched = 1; }
+            else if (t + 1 < ntokens) { a->threads = atoi(argv[(++t) + 1]); matched = 1; }
+        }
+        if (strncmp(arg, "--threads=", 10) == 0 || help) {
+            if (help) parse_help_line(OPTW, "--threads=<N>", "worker threads (= form)");
+            else a->threads = atoi(arg + 10);
+            matched = 1;
+        }
         if (strcmp(arg, "--once") == 0 || help) {
             if (help) parse_help_line(OPTW, "--once", "print one snapshot as plain text and exit (no UI)");
             else a->once = 1;
@@ -938,6 +1066,12 @@ int main(int argc, char **argv)
     double freq_hz = cfg.freq_hz;
     double window_min = cfg.window_min;
     int once = cfg.once;
+    int n_threads = cfg.threads;
+    if (n_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        n_threads = cpus > 0 ? (int) cpus : 1;
+    }
+    if (n_threads > MAX_THREADS) n_threads = MAX_THREADS;
 
     obj_t objs[MAX_OBJECTS];
     memset(objs, 0, sizeof objs);
@@ -977,16 +1111,7 @@ int main(int argc, char **argv)
     // Non-interactive snapshot: compute once, print plain text, exit.
     if (once) {
         double jul_now = now_jul_utc();
-        for (int i = 0; i < n; ++i) {
-            if (!objs[i].loaded) continue;
-            prep_object(&objs[i]);
-            compute_live(&objs[i], jul_now, freq_hz);
-            prep_object(&objs[i]);
-            find_pass(&objs[i], jul_now, window_min);
-        }
-        compute_pass_separations(objs, n);
-        compute_orbit_dtsec(objs, n, jul_now);
-        compute_alongtrack_trend(objs, n, jul_now, g_trend_days);
+        update_all(objs, n, jul_now, freq_hz, window_min, 1, n_threads);
         print_text(objs, n, jul_now, freq_hz, tle_path, lat, lon, alt_m);
         return EXIT_SUCCESS;
     }
@@ -1001,7 +1126,7 @@ int main(int argc, char **argv)
     nodelay(stdscr, TRUE);
     keypad(stdscr, TRUE);
 
-    time_t last_live = 0, last_pass = 0;
+    time_t last_live = 0, last_slow = 0;
     while (!g_quit) {
         int ch = getch();
         if (ch == 'q' || ch == 'Q') break;
@@ -1011,23 +1136,9 @@ int main(int argc, char **argv)
 
         if (wall != last_live) {
             last_live = wall;
-            for (int i = 0; i < n; ++i) {
-                if (!objs[i].loaded) continue;
-                prep_object(&objs[i]);
-                compute_live(&objs[i], jul_now, freq_hz);
-            }
-        }
-
-        if (last_pass == 0 || wall - last_pass >= PASS_REFRESH_S) {
-            last_pass = wall;
-            for (int i = 0; i < n; ++i) {
-                if (!objs[i].loaded) continue;
-                prep_object(&objs[i]);
-                find_pass(&objs[i], jul_now, window_min);
-            }
-            compute_pass_separations(objs, n);
-            compute_orbit_dtsec(objs, n, jul_now);
-            compute_alongtrack_trend(objs, n, jul_now, g_trend_days);
+            int slow = (last_slow == 0 || wall - last_slow >= PASS_REFRESH_S);
+            if (slow) last_slow = wall;
+            update_all(objs, n, jul_now, freq_hz, window_min, slow, n_threads);
         }
 
         draw(objs, n, jul_now, freq_hz, tle_path, lat, lon, alt_m);
@@ -150,8 +150,8 @@ PY
 # Decide whether `src` should be skipped because it's already decoded.
 # Mirrors the original incremental logic exactly: skip when SKIP_DECODED
 # is on, a sibling `.decoded` marker exists and is at least as new as the
-# audio, UNLESS a sibling .iq is newer than the marker (a fresh IQ drop
-# the marker run didn't cover). Returns 0 to SKIP, 1 to process.
+# audio, UNLESS a sibling .sso-iq / .iq is newer than the marker (a fresh
+# IQ drop the marker run didn't cover). Returns 0 to SKIP, 1 to process.
 skip_marker_test() {
     local src="$1"
     [[ "$SKIP_DECODED" -eq 1 ]] || return 1
@@ -159,7 +159,8 @@ skip_marker_test() {
     [[ -f "$marker" && ! "$src" -nt "$marker" ]] || return 1
     local iqc=""
     if [[ "${src,,}" == *.wav ]]; then
-        iqc="${src%.wav}.iq"
+        iqc="${src%.wav}.sso-iq"
+        [[ -r "$iqc" ]] || iqc="${src%.wav}.iq"
         [[ -r "$iqc" ]] || iqc=""
     fi
     if [[ -n "$iqc" && "$iqc" -nt "$marker" ]]; then
@@ -239,12 +240,14 @@ process_one_file() {
     local pos=$((10#$idx))
     : > "$out"
 
-    # Compute the .iq sidecar path up front. We prefer it for decode when
-    # present (the IQ-domain Viterbi decoder pulls more frames out of
-    # low-SNR passes). It doesn't exist for SatNOGS .ogg or rtl_fm WAV.
+    # Compute the IQ sidecar path up front (.sso-iq, or a legacy .iq). We
+    # prefer it for decode when present (the IQ-domain Viterbi decoder
+    # pulls more frames out of low-SNR passes). It doesn't exist for
+    # SatNOGS .ogg or rtl_fm WAV.
     local iq_candidate=""
     if [[ "${src,,}" == *.wav ]]; then
-        iq_candidate="${src%.wav}.iq"
+        iq_candidate="${src%.wav}.sso-iq"
+        [[ -r "$iq_candidate" ]] || iq_candidate="${src%.wav}.iq"
         [[ -r "$iq_candidate" ]] || iq_candidate=""
     fi
 
@@ -39,9 +39,11 @@ fi
 # label | type | filename inside test/decode_regression
 # Type chooses the rx_replay command line:
 #   iq   = headerless I,Q pairs (int16 interleaved) at 96 kHz
+#   iqj  = the same, decoded segment-parallel (--jobs=4); must match iq
 #   wav  = mono 48 kHz WAV (FM-audio path, what SatNOGS dumps look like)
 FIXTURES=(
     "iq_localpass | iq  | iq_snippet.iq"
+    "iq_jobs      | iqj | iq_snippet.iq"
     "wav_satnogs  | wav | audio_snippet.wav"
 )
 
@@ -69,6 +71,7 @@ run_one() {
     local args=("--no-db")
     case "$kind" in
         iq)  args+=("--rate=96000") ;;
+        iqj) args+=("--rate=96000" "--jobs=4") ;;
         wav) args+=("--channels=1") ;;
         *)   printf "%-14s UNKNOWN_KIND_%s\n" "$label" "$kind"
              rm -rf "$tmpdir"; return ;;
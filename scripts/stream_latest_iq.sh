@@ -1,5 +1,5 @@
 #!/usr/bin/env bash
-# Stream the most-recently-modified .iq from the operations tree on
+# Stream the most-recently-modified .sso-iq / .iq from the operations tree on
 # the remote ground station into a local file, for use with
 # `decode_inspector LOCAL_PATH --live`.
 #
@@ -33,11 +33,12 @@ HOST="${HOST:-rao}"
 REMOTE_ROOT="${REMOTE_ROOT:-/FrontierSat/Operations}"
 LOCAL_PATH="${1:-live.iq}"
 
-# Find the latest .iq under REMOTE_ROOT (mtime descending). -printf is
-# a GNU find feature so this assumes the remote is Linux (RAO is). The
-# tab separator keeps paths-with-spaces intact through cut.
+# Find the latest IQ recording under REMOTE_ROOT (mtime descending).
+# -printf is a GNU find feature so this assumes the remote is Linux (RAO
+# is). The tab separator keeps paths-with-spaces intact through cut. The
+# local name doesn't matter: decode_inspector tells a .sso-iq by content.
 REMOTE_PATH=$(ssh "$HOST" \
-    "find '$REMOTE_ROOT' -name '*.iq' -type f -printf '%T@\\t%p\\n' 2>/dev/null \
+    "find '$REMOTE_ROOT' \\( -name '*.iq' -o -name '*.sso-iq' \\) -type f -printf '%T@\\t%p\\n' 2>/dev/null \
         | sort -nr | head -n1 | cut -f2-")
 
 if [ -z "$REMOTE_PATH" ]; then
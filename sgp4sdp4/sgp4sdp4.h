@@ -147,8 +147,29 @@ typedef struct
 #define SAT_ECLIPSED_FLAG      0x004000
 
 
+/* Near-earth constants SGP4 derives once per element set */
+typedef struct
+{
+  double
+	aodp,aycof,c1,c4,c5,cosio,d2,d3,d4,delmo,omgcof,
+	eta,omgdot,sinio,xnodp,sinmo,t2cof,t3cof,t4cof,t5cof,
+	x1mth2,x3thm1,x7thm1,xmcof,xmdot,xnodcf,xnodot,xlcof;
+  int simple;     /* perigee < 220 km: truncated drag terms */
+} sgp4_init_t;
+
+/* One object prepared for batch propagation by sgp4_ctx_init() */
+typedef struct
+{
+  tle_t tle;          /* elements as converted by select_ephemeris */
+  int deep_space;     /* 1 => SDP4 (scalar fallback)              */
+  double epoch_jul;   /* TLE epoch, Julian date                    */
+  sgp4_init_t init;   /* near-earth constants (SGP4 only)          */
+} sgp4_ctx_t;
+
 /* Funtion prototypes produced by cproto */
 /* sgp4sdp4.c */
+void SGP4_Init(tle_t *tle, sgp4_init_t *init);
+void SGP4_Batch(const sgp4_init_t *init, const tle_t *tle, const double *tsince, int n, double *pos, double *vel);
 void SGP4(double tsince, tle_t *tle, vector_t *pos, vector_t *vel);
 void SDP4(double tsince, tle_t *tle, vector_t *pos, vector_t *vel);
 void Deep(int ientry, tle_t *tle, deep_arg_t *deep_arg);
@@ -156,6 +177,11 @@ int isFlagSet(int flag);
 int isFlagClear(int flag);
 void SetFlag(int flag);
 void ClearFlag(int flag);
+/* sgp_grid.c */
+void sgp4_ctx_init(sgp4_ctx_t *ctx, const tle_t *tle, int deep_space);
+void sgp4_propagate_grid(const sgp4_ctx_t *ctx, double t0_jul, double dt_sec, int n, double *pos, double *vel);
+void sgp4_propagate_times(const sgp4_ctx_t *ctx, const double *jul, int n, double *pos, double *vel);
+void sgp4_propagate_multi(const sgp4_ctx_t *ctx, int m, double jul, double *pos, double *vel);
 /* sgp_in.c */
 int Checksum_Good(char *tle_set);
 int Good_Elements(char *tle_set);
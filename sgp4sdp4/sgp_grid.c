@@ -0,0 +1,194 @@
+/*
+ * Unit SGP_Grid
+ *
+ * Batch propagation of one object over a grid of times, or of many
+ * objects at one time, on top of the SGP4_Init/SGP4_Batch split in
+ * sgp4sdp4.c. The near-earth constants are derived once per object
+ * (sgp4_ctx_init) instead of on every call, and results come back
+ * as structure-of-arrays in km and km/s: pos[0..n-1] holds x,
+ * pos[n..2n-1] y and pos[2n..3n-1] z; vel is laid out alike and may
+ * be NULL. Deep-space objects fall back to the scalar SDP4 path.
+ */
+
+#define SGP4SDP4_CONSTANTS
+#include "sgp4sdp4.h"
+
+/* Times are handed to SGP4_Batch in blocks of this many */
+#define GRID_BLOCK 64
+
+/* sgp4_ctx_init */
+/* Prepares ctx for batch propagation. tle must already have    */
+/* been through select_ephemeris, and deep_space is its verdict */
+/* (DEEP_SPACE_EPHEM_FLAG). The elements are copied, so tle may */
+/* change or go away afterwards.                                */
+  void
+sgp4_ctx_init(sgp4_ctx_t *ctx, const tle_t *tle, int deep_space)
+{
+  ctx->tle = *tle;
+  ctx->deep_space = deep_space ? 1 : 0;
+  ctx->epoch_jul = Julian_Date_of_Epoch(tle->epoch);
+  if (!ctx->deep_space)
+	SGP4_Init(&ctx->tle, &ctx->init);
+} /* sgp4_ctx_init */
+
+/*------------------------------------------------------------------*/
+
+/* Scale SGP4's earth radii and er/min to km and km/s in place */
+  static void
+to_km(double *pos, double *vel, int n)
+{
+  int k;
+  for (k = 0; k < 3*n; k++)
+	pos[k] *= xkmper;
+  if (vel != NULL)
+	for (k = 0; k < 3*n; k++)
+	  vel[k] *= xkmper*xmnpda/secday;
+} /* to_km */
+
+/* Deep-space objects go through SDP4 one time at a time. Its    */
+/* constants live in the per-thread propagator state behind the  */
+/* flags word, so sdp4_begin sets the flags up for this object   */
+/* and sdp4_end restores the caller's, minus SDP4_INITIALIZED:   */
+/* the next scalar SDP4 call must re-derive its own object's     */
+/* state. A whole grid runs between one begin/end pair, since    */
+/* SDP4 carries its lunar-solar terms from call to call.         */
+  static int
+sdp4_begin(void)
+{
+  int saved = isFlagSet(ALL_FLAGS);
+  ClearFlag(ALL_FLAGS);
+  SetFlag(DEEP_SPACE_EPHEM_FLAG);
+  return saved;
+} /* sdp4_begin */
+
+  static void
+sdp4_end(int saved)
+{
+  ClearFlag(ALL_FLAGS);
+  SetFlag(saved & ~SDP4_INITIALIZED_FLAG);
+} /* sdp4_end */
+
+/* Propagate ctx at tsince[0..n-1] (minutes since epoch) into */
+/* pos/vel, converted to km and km/s. Deep-space objects must */
+/* be inside sdp4_begin/sdp4_end.                             */
+  static void
+propagate_tsince(const sgp4_ctx_t *ctx, const double *tsince, int n,
+	double *pos, double *vel)
+{
+  if (ctx->deep_space)
+  {
+	tle_t tle = ctx->tle;
+	vector_t p, v;
+	int k;
+	for (k = 0; k < n; k++)
+	{
+	  SDP4(tsince[k], &tle, &p, &v);
+	  pos[k] = p.x;
+	  pos[n+k] = p.y;
+	  pos[2*n+k] = p.z;
+	  if (vel != NULL)
+	  {
+		vel[k] = v.x;
+		vel[n+k] = v.y;
+		vel[2*n+k] = v.z;
+	  }
+	}
+  }
+  else
+	SGP4_Batch(&ctx->init, &ctx->tle, tsince, n, pos, vel);
+  to_km(pos, vel, n);
+} /* propagate_tsince */
+
+/*------------------------------------------------------------------*/
+
+/* sgp4_propagate_grid */
+/* Propagates one object at the n evenly spaced times            */
+/* t0_jul + k*dt_sec (k = 0..n-1), as described at the top.      */
+  void
+sgp4_propagate_grid(const sgp4_ctx_t *ctx, double t0_jul, double dt_sec,
+	int n, double *pos, double *vel)
+{
+  double tsince[GRID_BLOCK], p[3*GRID_BLOCK], v[3*GRID_BLOCK];
+  double t0 = (t0_jul-ctx->epoch_jul)*xmnpda;
+  double dt = dt_sec/60.0;
+  int base, m, k, c, saved = 0;
+
+  if (ctx->deep_space)
+	saved = sdp4_begin();
+  for (base = 0; base < n; base += GRID_BLOCK)
+  {
+	m = n-base < GRID_BLOCK ? n-base : GRID_BLOCK;
+	for (k = 0; k < m; k++)
+	  tsince[k] = t0+(double)(base+k)*dt;
+	propagate_tsince(ctx, tsince, m, p, vel != NULL ? v : NULL);
+	for (c = 0; c < 3; c++)
+	  for (k = 0; k < m; k++)
+	  {
+		pos[c*n+base+k] = p[c*m+k];
+		if (vel != NULL)
+		  vel[c*n+base+k] = v[c*m+k];
+	  }
+  }
+  if (ctx->deep_space)
+	sdp4_end(saved);
+} /* sgp4_propagate_grid */
+
+/* sgp4_propagate_times */
+/* As sgp4_propagate_grid, at n arbitrary Julian dates jul[]. */
+  void
+sgp4_propagate_times(const sgp4_ctx_t *ctx, const double *jul, int n,
+	double *pos, double *vel)
+{
+  double tsince[GRID_BLOCK], p[3*GRID_BLOCK], v[3*GRID_BLOCK];
+  int base, m, k, c, saved = 0;
+
+  if (ctx->deep_space)
+	saved = sdp4_begin();
+  for (base = 0; base < n; base += GRID_BLOCK)
+  {
+	m = n-base < GRID_BLOCK ? n-base : GRID_BLOCK;
+	for (k = 0; k < m; k++)
+	  tsince[k] = (jul[base+k]-ctx->epoch_jul)*xmnpda;
+	propagate_tsince(ctx, tsince, m, p, vel != NULL ? v : NULL);
+	for (c = 0; c < 3; c++)
+	  for (k = 0; k < m; k++)
+	  {
+		pos[c*n+base+k] = p[c*m+k];
+		if (vel != NULL)
+		  vel[c*n+base+k] = v[c*m+k];
+	  }
+  }
+  if (ctx->deep_space)
+	sdp4_end(saved);
+} /* sgp4_propagate_times */
+
+/* sgp4_propagate_multi */
+/* Propagates m objects ctx[0..m-1] to one Julian date. Output  */
+/* is structure-of-arrays across the objects: pos[0..m-1] holds */
+/* x, pos[m..2m-1] y and pos[2m..3m-1] z, km; vel alike, km/s.  */
+  void
+sgp4_propagate_multi(const sgp4_ctx_t *ctx, int m, double jul,
+	double *pos, double *vel)
+{
+  double tsince, p[3], v[3];
+  int j, c;
+
+  for (j = 0; j < m; j++)
+  {
+	tsince = (jul-ctx[j].epoch_jul)*xmnpda;
+	if (ctx[j].deep_space)
+	{
+	  int saved = sdp4_begin();
+	  propagate_tsince(&ctx[j], &tsince, 1, p, vel != NULL ? v : NULL);
+	  sdp4_end(saved);
+	}
+	else
+	  propagate_tsince(&ctx[j], &tsince, 1, p, vel != NULL ? v : NULL);
+	for (c = 0; c < 3; c++)
+	{
+	  pos[c*m+j] = p[c];
+	  if (vel != NULL)
+		vel[c*m+j] = v[c];
+	}
+  }
+} /* sgp4_propagate_multi */
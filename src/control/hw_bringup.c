@@ -204,6 +204,13 @@ void hw_sdr_open(state_t *state)
         // sustained-write rate at 96 kHz·2·2 = 384 kB/s, a 10-minute
         // pass produces ~230 MB which the laptop SSD has no trouble
         // with.
+        // File backend: the recording named by --replay, or synthetic
+        // bursts on the nominal downlink so they land where a real
+        // beacon would after the LO offset.
+        sdr_replay_params_t replay = state->sdr.replay;
+        replay.path = state->sdr.replay_path[0] ? state->sdr.replay_path : NULL;
+        if (replay.carrier_hz == 0.0)
+            replay.carrier_hz = state->track.nominal_downlink_frequency_hz;
         b210_rx_tx_core_params_t cp = {
             // Tune the SDR LO off the nominal carrier so the corrected
             // signal lands well off DC. rx_lo_offset_hz is SIGNED:
@@ -254,6 +261,9 @@ void hw_sdr_open(state_t *state)
             .fpga_image_path     = state->sdr.sdr_fpga[0] ? state->sdr.sdr_fpga : NULL,
             // RTL-SDR dongle index (UHD ignores it; for UHD use --uhd-args).
             .device_index        = state->sdr.sdr_device[0] ? atoi(state->sdr.sdr_device) : 0,
+            .rtl_xfers           = state->sdr.rtl_xfers,
+            .rtl_xfer_bytes      = state->sdr.rtl_xfer_kib * 1024,
+            .replay              = &replay,
         };
         b210_rx_tx_core_t *core = NULL;
         if (b210_rx_tx_core_open(&cp, &core) != 0) {
@@ -287,13 +297,24 @@ void hw_sdr_open(state_t *state)
                 .show_packet_headers = 0,
                 .pass_folder       = state->op.pass_folder[0] ? state->op.pass_folder : NULL,
                 .want_wav          = 1,
+                .raw_iq            = state->sdr.raw_iq,
                 .tle_path          = state->track.prediction.tles_filename,
                 .sat_name          = state->track.prediction.satellite_ephem.tle.sat_name[0]
                                      ? state->track.prediction.satellite_ephem.tle.sat_name
                                      : NULL,
                 .session_dir       = state->op.pass_folder[0] ? state->op.pass_folder : NULL,
                 .lo_offset_hz      = state->sdr.rx_lo_offset_hz,
+                .no_burst_gate     = state->sdr.no_burst_gate,
             };
+            // --rx-channel: placed relative to the primary carrier; the
+            // core rejects any whose band falls outside the capture.
+            for (int k = 0; k < state->sdr.n_rx_channels
+                            && k < RX_SESSION_CHANNELS_MAX; k++) {
+                rxp.channels[k].sat_name  = state->sdr.rx_channels[k].name;
+                rxp.channels[k].offset_hz = state->sdr.rx_channels[k].freq_hz
+                                          - state->track.nominal_downlink_frequency_hz;
+                rxp.n_channels = k + 1;
+            }
             if (rx_session_open(&state->sdr.rx_session, &rxp, core) != 0) {
                 fprintf(stderr,
                     "simple_sat_ops: rx_session_open failed — closing B210\n");
@@ -31,6 +31,10 @@
 #include "tui.h"             // tui_install_yield_handler
 #include "viewer.h"          // read_operator_pid
 
+#ifdef SSO_WITH_SDR
+#include "rx_session.h"      // rx_session_trace_delivered
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>          // EXIT_FAILURE
 #include <string.h>
@@ -60,6 +64,16 @@ static void ipc_fill_rx_panel(state_t *state, sso_event_t *evt)
     snprintf(evt->rx_last_frame_summary,
              sizeof evt->rx_last_frame_summary, "%s", d.last_frame_summary);
     evt->rx_age_s = d.age_s;
+    evt->rx_bk_active    = d.bulk_active;
+    evt->rx_bk_file      = d.bulk_file_no;
+    evt->rx_bk_eof       = d.bulk_eof_known;
+    evt->rx_bk_present   = d.bulk_present;
+    evt->rx_bk_extent    = d.bulk_extent;
+    evt->rx_bk_conflicts = d.bulk_conflicts;
+    evt->rx_bk_gaps      = d.bulk_n_ranges;
+    evt->rx_bk_rate      = d.bulk_rate_Bps;
+    snprintf(evt->rx_bk_missing, sizeof evt->rx_bk_missing,
+             "%s", d.bulk_missing);
     int slots = RX_PANEL_PT_COUNT < SSO_RX_PT_SLOTS
               ? RX_PANEL_PT_COUNT : SSO_RX_PT_SLOTS;
     for (int s = 0; s < slots; ++s) {
@@ -162,6 +176,11 @@ void ipc_broadcast_state(state_t *s,
     char buf[SSO_IPC_LINE_MAX];
     if (sso_event_encode(&evt, buf, sizeof(buf)) == 0) {
         sso_ipc_server_broadcast(s->op.ipc, buf);
+#ifdef SSO_WITH_SDR
+        // Frames that just went out to viewers in the RX panel fields.
+        if (s->sdr.rx_session != NULL && sso_ipc_server_client_count(s->op.ipc) > 0)
+            rx_session_trace_delivered(s->sdr.rx_session, LAT_IPC);
+#endif
     } else {
         fprintf(stderr, "operator_ipc: STATE encode overflow -- "
                 "dropped (roster too large?)\n");
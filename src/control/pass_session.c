@@ -21,6 +21,7 @@
 #include "pass_session.h"
 #include "state.h"
 
+#include "lat_trace.h"
 #include "prediction.h"
 #include "sso_audit.h"
 #include "sso_paths.h"
@@ -472,13 +473,24 @@ void generate_pass_plot(state_t *state, const char *pass_folder,
         : 15.0;
     const int n_steps = (int)(duration_min / step_min) + 1;
 
+    // The whole track in one batch propagation rather than a full
+    // update_satellite_position per sample.
+    double *track_az = malloc(2 * (size_t)(n_steps + 1) * sizeof *track_az);
+    if (track_az == NULL
+        || prediction_look_angles(&pred, aos_jul, step_min * 60.0, n_steps + 1,
+                                  track_az, track_az + n_steps + 1) != 0) {
+        free(track_az);
+        fclose(f);
+        return;
+    }
+    const double *track_el = track_az + n_steps + 1;
+
     int wrote = 0;
     for (int i = 0; i <= n_steps; ++i) {
         double t_min = i * step_min;
         double sample_jul = aos_jul + t_min / 1440.0;
-        update_satellite_position(&pred, sample_jul);
-        double sat_az = pred.satellite_ephem.azimuth;
-        double sat_el = pred.satellite_ephem.elevation;
+        double sat_az = track_az[i];
+        double sat_el = track_el[i];
         if (sat_el < 0.0) continue;
 
         double mech_az = sat_az;
@@ -509,6 +521,7 @@ void generate_pass_plot(state_t *state, const char *pass_folder,
                 t_min, sat_az, sat_el, beam_az, beam_el);
         ++wrote;
     }
+    free(track_az);
     fclose(f);
 
     if (wrote == 0) {
@@ -627,3 +640,37 @@ int pass_session_load_orbit(state_t *state)
     }
     return 0;
 }
+
+void pass_session_write_latency(state_t *state)
+{
+    lat_summary_t win;
+    lat_trace_summary(LAT_WINDOW, &win);
+    if (!state->op.pass_folder[0] || win.count == 0) return;
+
+    char path[512];
+    int n = snprintf(path, sizeof path, "%s/latency.txt", state->op.pass_folder);
+    if (n <= 0 || (size_t)n >= sizeof path) return;
+    const char *sat_name =
+        (state->track.prediction.satellite_ephem.name
+         && state->track.prediction.satellite_ephem.name[0])
+            ? state->track.prediction.satellite_ephem.name : "satellite";
+    char title[128], stamp[32];
+    time_t now = time(NULL);
+    struct tm tm_utc;
+    gmtime_r(&now, &tm_utc);
+    strftime(stamp, sizeof stamp, "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+    snprintf(title, sizeof title, "%s, written %s", sat_name, stamp);
+
+    if (lat_trace_write_report(path, title) != 0) {
+        fprintf(stderr, "simple_sat_ops: could not write %s: %s\n",
+                path, strerror(errno));
+        return;
+    }
+    lat_summary_t panel;
+    lat_trace_summary(LAT_PANEL, &panel);
+    char det[128];
+    snprintf(det, sizeof det, "frames=%llu panel_p50_ms=%.1f panel_p99_ms=%.1f",
+             (unsigned long long) win.count, panel.p50_ms, panel.p99_ms);
+    sso_audit_event("latency-report", det);
+    lat_trace_reset();
+}
@@ -63,6 +63,11 @@ void generate_pass_plot(state_t *state, const char *pass_folder, double jul_utc_
 // non-zero status on failure.
 int pass_session_load_orbit(state_t *state);
 
+// LOS / shutdown: write the frame-latency histograms gathered since the
+// last dump (lat_trace.h) to <pass_folder>/latency.txt, then reset them
+// for the next pass. No-op without a pass folder or a traced frame.
+void pass_session_write_latency(state_t *state);
+
 #ifdef __cplusplus
 }
 #endif
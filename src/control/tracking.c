@@ -29,10 +29,12 @@
 #include "scan_sky.h"
 #include "cmd_line.h"
 #include "sso_audit.h"
+#include "tle_catalog.h"
 #include "tle_io.h"
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
@@ -128,12 +130,14 @@ static int pursuit_track_lookup(double jul, double *az, double *el, void *ctx)
         if (el) *el = trk->el[trk->n - 1];
         return 0;
     }
-    size_t lo = 0, hi = trk->n - 1;
-    while (hi - lo > 1) {
-        size_t mid = (lo + hi) / 2;
-        if (trk->t_jul[mid] <= jul) lo = mid;
-        else hi = mid;
-    }
+    // Samples are evenly spaced (pursuit_track_build), so the bracketing
+    // index is direct; the nudge loops only absorb rounding at the edges.
+    double span = trk->t_jul[trk->n - 1] - trk->t_jul[0];
+    size_t lo = (size_t) ((jul - trk->t_jul[0]) / span * (double) (trk->n - 1));
+    if (lo > trk->n - 2) lo = trk->n - 2;
+    while (lo > 0 && trk->t_jul[lo] > jul) --lo;
+    while (lo + 2 < trk->n && trk->t_jul[lo + 1] <= jul) ++lo;
+    size_t hi = lo + 1;
     double frac = (jul - trk->t_jul[lo])
                 / (trk->t_jul[hi] - trk->t_jul[lo]);
     if (az) *az = trk->az_unwrapped[lo]
@@ -382,6 +386,11 @@ int retarget_to_tle(state_t *state, const char *path)
     state->track.prediction.satellite_ephem.name = state->track.target_name;
     ClearFlag(ALL_FLAGS);
     select_ephemeris(&state->track.prediction.satellite_ephem.tle);
+    // The worker's Doppler trajectory was sampled from the old target's
+    // pass table; flag it so main.c replaces it (with nothing, until the
+    // new target's table is built) instead of ramping the old curve.
+    prediction_free_pass_cache(&state->track.prediction);
+    state->track.doppler_track_stale = 1;
 
     // Recompute pass geometry for the new target. Reset max-elevation to
     // the sentinel so compute_predictions walks back to AOS when we're
@@ -577,6 +586,121 @@ void update_doppler_shifted_frequencies(track_t *track,
     track->doppler_downlink_frequency_hz = downlink_freq * doppler_factor;
 }
 
+// Slack on either side of the predicted pass window covered by the
+// per-pass ephemeris table, so AOS/LOS refinements from the next
+// compute_predictions don't immediately force a rebuild.
+#define PASS_CACHE_MARGIN_S 120.0
+
+// Keep the tracked prediction's pass table in step with the upcoming
+// pass: build it once we are inside the tracking prep window (or already
+// past AOS), rebuild when the predicted window drifts outside it, and
+// drop it after LOS. Outside that window update_satellite_position
+// simply runs SGP4/SDP4 as before. Dropping a table that was held marks
+// the worker's Doppler trajectory stale, so it falls back to the per-tick
+// offset; with no table there is nothing to replace.
+void tracking_refresh_pass_cache(state_t *state, double jul_utc)
+{
+    prediction_t *p = &state->track.prediction;
+    double aos = p->predicted_ascension_jul_utc;
+    double los = p->predicted_descent_jul_utc;
+    double margin = PASS_CACHE_MARGIN_S / 86400.0;
+
+    if (aos <= 0.0 || los <= aos || jul_utc > los + margin) {
+        if (p->pass_cache != NULL) state->track.doppler_track_stale = 1;
+        prediction_free_pass_cache(p);
+        return;
+    }
+    double prep = state->rot.antenna_rotator.tracking_prep_time_minutes;
+    if (prep < 0.0) prep = 0.0;
+    if (jul_utc < aos - prep / 1440.0) return;
+
+    if (prediction_pass_cache_covers(p, jul_utc, los)) return;
+    double start = (jul_utc < aos ? jul_utc : aos) - margin;
+    int had_cache = p->pass_cache != NULL;
+    if (prediction_build_pass_cache(p, start, los + margin) != 0) {
+        // OEM-backed or out of memory: the uncached path keeps working.
+        prediction_free_pass_cache(p);
+        if (had_cache) state->track.doppler_track_stale = 1;
+        return;
+    }
+    state->track.doppler_track_stale = 1;
+}
+
+size_t tracking_doppler_trajectory(const track_t *track, double step_s,
+                                   double *out_t0_unix_s,
+                                   double **out_offset_hz)
+{
+    *out_offset_hz = NULL;
+    double jul_start, jul_stop;
+    if (!track->doppler_correction_enabled || !(step_s > 0.0)) return 0;
+    if (prediction_pass_cache_window(&track->prediction,
+                                     &jul_start, &jul_stop) != 0) return 0;
+    size_t n = (size_t) floor((jul_stop - jul_start) * 86400.0 / step_s) + 1;
+    if (n < 2) return 0;
+    double *offset = malloc(n * sizeof *offset);
+    if (offset == NULL) return 0;
+
+    // Same arithmetic as update_doppler_shifted_frequencies, on a scratch
+    // copy so the live satellite_ephem is not disturbed. The copy shares
+    // the pass table read-only, so each sample is an interpolation.
+    prediction_t scratch;
+    memcpy(&scratch, &track->prediction, sizeof scratch);
+    double f = track->nominal_downlink_frequency_hz;
+    for (size_t i = 0; i < n; ++i) {
+        update_satellite_position(&scratch,
+                                  jul_start + (double) i * step_s / 86400.0);
+        offset[i] = -f * scratch.satellite_ephem.range_rate_km_s / 299792.458;
+    }
+    *out_t0_unix_s = (jul_start - 2440587.5) * 86400.0;
+    *out_offset_hz = offset;
+    return n;
+}
+
+size_t tracking_channel_doppler_trajectory(const track_t *track,
+                                           const char *sat_name,
+                                           double freq_hz, double step_s,
+                                           double *out_t0_unix_s,
+                                           double **out_offset_hz)
+{
+    *out_offset_hz = NULL;
+    double jul_start, jul_stop;
+    if (!track->doppler_correction_enabled || !(step_s > 0.0)) return 0;
+    if (sat_name == NULL || track->prediction.tles_filename == NULL) return 0;
+    if (prediction_pass_cache_window(&track->prediction,
+                                     &jul_start, &jul_stop) != 0) return 0;
+    const tle_catalog_t *cat = tle_catalog_get(track->prediction.tles_filename);
+    long idx = cat != NULL ? tle_catalog_first_prefix(cat, sat_name) : -1;
+    const tle_catalog_rec_t *rec = idx >= 0 ? tle_catalog_rec(cat, (size_t) idx) : NULL;
+    if (rec == NULL || !rec->good) return 0;
+    size_t n = (size_t) floor((jul_stop - jul_start) * 86400.0 / step_s) + 1;
+    if (n < 2) return 0;
+    double *offset = malloc(n * sizeof *offset);
+    if (offset == NULL) return 0;
+
+    // A scratch prediction carrying the channel's elements instead of the
+    // tracked ones; no pass table or OEM, so every sample runs SGP4. The
+    // SGP4 library's deep-space flag is global: set it for this object
+    // and put the tracked object's back afterwards.
+    prediction_t scratch;
+    memcpy(&scratch, &track->prediction, sizeof scratch);
+    scratch.satellite_ephem.tle = rec->ephem;
+    scratch.oem        = NULL;
+    scratch.pass_cache = NULL;
+    int was_deep = isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0;
+    ClearFlag(ALL_FLAGS);
+    if (rec->deep_space) SetFlag(DEEP_SPACE_EPHEM_FLAG);
+    for (size_t i = 0; i < n; ++i) {
+        update_satellite_position(&scratch,
+                                  jul_start + (double) i * step_s / 86400.0);
+        offset[i] = -freq_hz * scratch.satellite_ephem.range_rate_km_s / 299792.458;
+    }
+    ClearFlag(ALL_FLAGS);
+    if (was_deep) SetFlag(DEEP_SPACE_EPHEM_FLAG);
+    *out_t0_unix_s = (jul_start - 2440587.5) * 86400.0;
+    *out_offset_hz = offset;
+    return n;
+}
+
 
 // HOME_ECHO_TOLERANCE_DEG: how close a STATUS azimuth must be to the
 // just-commanded home waypoint to be treated as the controller's post-SET
@@ -72,6 +72,33 @@ int  point_to_stationary_target(state_t *state, double azimuth, double elevation
 // from the current range rate.
 void update_doppler_shifted_frequencies(track_t *track, double uplink_freq, double downlink_freq);
 
+// Build / refresh / drop the tracked prediction's per-pass ephemeris
+// table (prediction_build_pass_cache) around the upcoming pass. Call
+// once per tick before update_satellite_position.
+void tracking_refresh_pass_cache(state_t *state, double jul_utc);
+
+// Sample the downlink Doppler offset (Hz from nominal, the value main.c
+// feeds rx_session_set_doppler_offset) every step_s across the per-pass
+// table's window, for the RX worker's NCO trajectory. Returns the
+// sample count and a malloc'd array in *out_offset_hz (caller frees),
+// with the first sample's UNIX time in *out_t0_unix_s; 0 (and NULL)
+// when there is no pass table or Doppler correction is off.
+#define DOPPLER_TRACK_STEP_S 1.0
+size_t tracking_doppler_trajectory(const track_t *track, double step_s,
+                                   double *out_t0_unix_s,
+                                   double **out_offset_hz);
+
+// The same trajectory for an extra receive channel (--rx-channel):
+// satellite `sat_name` from the tracked TLE file, downlink freq_hz,
+// sampled over the tracked pass's table window (the channel rides
+// along with the primary pass). Propagates with SGP4 directly. 0 (and
+// NULL) also when the satellite is not in the TLE file.
+size_t tracking_channel_doppler_trajectory(const track_t *track,
+                                           const char *sat_name,
+                                           double freq_hz, double step_s,
+                                           double *out_t0_unix_s,
+                                           double **out_offset_hz);
+
 // Per-tick antenna pointing: motion-settle detection, the two-step home's
 // second leg, an active sky scan, and the satellite-tracking / pursuit aim
 // loop (or rotator release at LOS). jul_utc is the current Julian date,
@@ -0,0 +1,275 @@
+/*
+
+    Simple Satellite Operations  chunk_reasm.c
+
+    Offset-addressed file reassembly. See chunk_reasm.h.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "chunk_reasm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int reasm_bulk_chunk(const uint8_t *pl, int pl_len,
+                     long *off, const uint8_t **data, long *dlen)
+{
+    if (pl == NULL || pl_len < REASM_BULK_HEADER_SIZE + 1) return -1;
+    long o = (long) pl[1] | ((long) pl[2] << 8)
+           | ((long) pl[3] << 16) | ((long) pl[4] << 24);
+    long n = pl_len - REASM_BULK_HEADER_SIZE;
+    if (n > REASM_BULK_MAX_DATA) n = REASM_BULK_MAX_DATA;   // drop CSP CRC32 trailer
+    if (o < 0 || o > REASM_BULK_MAX_PLAUSIBLE || o + n > REASM_BULK_MAX_PLAUSIBLE)
+        return -1;                                          // bit-flipped offset
+    *off = o;
+    *data = pl + REASM_BULK_HEADER_SIZE;
+    *dlen = n;
+    return 0;
+}
+
+// ------------------------------------------------------------------ offset map
+
+void reasm_map_init(reasm_map_t *m, uint8_t fill)
+{
+    memset(m, 0, sizeof *m);
+    m->fill = fill;
+    m->min_off = -1;
+}
+
+void reasm_map_free(reasm_map_t *m)
+{
+    free(m->bytes);
+    free(m->runs);
+    reasm_map_init(m, m->fill);
+}
+
+// Extend the byte store to cover [0, end), new bytes set to the fill value.
+static int grow_bytes(reasm_map_t *m, long end)
+{
+    if (end > m->cap) {
+        long ncap = m->cap ? m->cap : 4096;
+        while (ncap < end) ncap *= 2;
+        uint8_t *grown = realloc(m->bytes, (size_t) ncap);
+        if (grown == NULL) return -1;
+        m->bytes = grown;
+        m->cap = ncap;
+    }
+    if (end > m->size) {
+        memset(m->bytes + m->size, m->fill, (size_t) (end - m->size));
+        m->size = end;
+    }
+    return 0;
+}
+
+// Index of the first run whose end is at or after pos (runs are sorted and
+// disjoint, so their ends ascend too).
+static size_t first_run_reaching(const reasm_map_t *m, long pos)
+{
+    size_t lo = 0, hi = m->n_runs;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (m->runs[mid].end < pos) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Append [start, end) to a piece list, merging into the previous piece when
+// they touch with the same quality.
+static void push_piece(reasm_run_t *p, size_t *np, long start, long end, int clean)
+{
+    if (end <= start) return;
+    if (*np > 0 && p[*np - 1].end == start && p[*np - 1].clean == clean) {
+        p[*np - 1].end = end;
+        return;
+    }
+    p[*np].start = start;
+    p[*np].end = end;
+    p[*np].clean = clean;
+    (*np)++;
+}
+
+long reasm_map_insert(reasm_map_t *m, long off, const uint8_t *data, long len, int clean)
+{
+    if (len <= 0) return 0;
+    long end = off + len;
+    if (grow_bytes(m, end) != 0) return -1;
+    if (m->min_off < 0 || off < m->min_off) m->min_off = off;
+
+    // Runs [i, j) overlap or touch [off, end); everything else is untouched.
+    size_t i = first_run_reaching(m, off);
+    size_t j = i;
+    while (j < m->n_runs && m->runs[j].start <= end) j++;
+
+    // Each old run contributes at most a prefix, a middle and a suffix, plus
+    // one gap piece before each run and one after the last.
+    reasm_run_t *pieces = malloc((3 * (j - i) + 2) * sizeof *pieces);
+    if (pieces == NULL) return -1;
+    size_t np = 0;
+
+    long newly = 0, pos = off;
+    if (i < j && m->runs[i].start < off)
+        push_piece(pieces, &np, m->runs[i].start, off, m->runs[i].clean);
+    for (size_t k = i; k < j && pos < end; ++k) {
+        const reasm_run_t *r = &m->runs[k];
+        if (r->end <= pos) continue;                // touches on the left only
+        long gap_end = r->start < end ? r->start : end;
+        if (gap_end > pos) {
+            memcpy(m->bytes + pos, data + (pos - off), (size_t) (gap_end - pos));
+            newly += gap_end - pos;
+            push_piece(pieces, &np, pos, gap_end, clean);
+            pos = gap_end;
+        }
+        if (pos >= end) break;
+        long b = r->end < end ? r->end : end;
+        if (clean) {
+            // Clean data replaces whatever is there; two clean chunks that
+            // disagree mean the window holds more than one file here.
+            if (r->clean)
+                for (long q = pos; q < b; ++q)
+                    if (m->bytes[q] != data[q - off]) m->conflicts++;
+            memcpy(m->bytes + pos, data + (pos - off), (size_t) (b - pos));
+        }
+        // Uncorrectable data never clobbers bytes that are already present.
+        push_piece(pieces, &np, pos, b, clean ? 1 : r->clean);
+        pos = b;
+    }
+    if (pos < end) {
+        memcpy(m->bytes + pos, data + (pos - off), (size_t) (end - pos));
+        newly += end - pos;
+        push_piece(pieces, &np, pos, end, clean);
+    }
+    if (j > i && m->runs[j - 1].end > end)
+        push_piece(pieces, &np, end, m->runs[j - 1].end, m->runs[j - 1].clean);
+    m->present += newly;
+
+    // Splice the pieces in place of runs [i, j).
+    size_t n_after = m->n_runs - (j - i) + np;
+    if (n_after > m->cap_runs) {
+        size_t ncap = m->cap_runs ? m->cap_runs : 64;
+        while (ncap < n_after) ncap *= 2;
+        reasm_run_t *grown = realloc(m->runs, ncap * sizeof *grown);
+        if (grown == NULL) { free(pieces); return -1; }
+        m->runs = grown;
+        m->cap_runs = ncap;
+    }
+    memmove(m->runs + i + np, m->runs + j, (m->n_runs - j) * sizeof *m->runs);
+    memcpy(m->runs + i, pieces, np * sizeof *pieces);
+    m->n_runs = n_after;
+    free(pieces);
+    return newly;
+}
+
+long reasm_map_next_gap(const reasm_map_t *m, long from, long *gap_end)
+{
+    if (from < 0) from = 0;
+    size_t k = first_run_reaching(m, from + 1);   // first run with end > from
+    // A clean run may touch an uncorrectable one, so skip every run that
+    // starts at or before the cursor.
+    while (k < m->n_runs && m->runs[k].start <= from) {
+        if (m->runs[k].end > from) from = m->runs[k].end;
+        ++k;
+    }
+    if (from >= m->size) return -1;
+    *gap_end = k < m->n_runs ? m->runs[k].start : m->size;
+    return from;
+}
+
+// ------------------------------------------------------------------ sessions
+
+// First index in ts[lo, hi) whose value is >= v (strict: > v).
+static size_t bound(const double *ts, size_t lo, size_t hi, double v, int strict)
+{
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strict ? ts[mid] <= v : ts[mid] < v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+long reasm_sessions(const double *ts_ms, const unsigned char *marked, size_t n,
+                    double gap_ms, double margin_ms, reasm_session_t **out)
+{
+    reasm_session_t *ss = NULL;
+    size_t ns = 0, cap = 0;
+    size_t i = 0;
+    while (i < n) {
+        if (!marked[i]) { i++; continue; }
+        size_t first = i, last = i;
+        for (size_t k = i + 1; k < n; ++k) {
+            if (!marked[k]) continue;
+            if (ts_ms[k] - ts_ms[last] > gap_ms) break;
+            last = k;
+        }
+        if (ns == cap) {
+            size_t ncap = cap ? cap * 2 : 16;
+            reasm_session_t *grown = realloc(ss, ncap * sizeof *grown);
+            if (grown == NULL) { free(ss); *out = NULL; return -1; }
+            ss = grown;
+            cap = ncap;
+        }
+        reasm_session_t *s = &ss[ns++];
+        s->first_mark = first;
+        s->last_mark = last;
+        s->lo = bound(ts_ms, 0, first, ts_ms[first] - margin_ms, 0);
+        s->hi = bound(ts_ms, last + 1, n, ts_ms[last] + margin_ms, 1);
+        i = last + 1;
+    }
+    *out = ss;
+    return (long) ns;
+}
+
+// ------------------------------------------------------------------ cursor
+
+#ifdef WITH_SQLITE3
+
+int reasm_cursor_open(reasm_cursor_t *cur, sqlite3 *db, const char *sql, const char *who)
+{
+    memset(cur, 0, sizeof *cur);
+    if (sqlite3_prepare_v2(db, sql, -1, &cur->st, NULL) != SQLITE_OK) {
+        if (who) fprintf(stderr, "%s: query failed: %s\n", who, sqlite3_errmsg(db));
+        cur->st = NULL;
+        return -1;
+    }
+    cur->ncols = sqlite3_column_count(cur->st);
+    return 0;
+}
+
+int reasm_cursor_next(reasm_cursor_t *cur)
+{
+    int rc = sqlite3_step(cur->st);
+    if (rc == SQLITE_DONE) return 0;
+    if (rc != SQLITE_ROW) return -1;
+    cur->id = (long long) sqlite3_column_int64(cur->st, 0);
+    cur->ts_received = (const char *) sqlite3_column_text(cur->st, 1);
+    cur->payload = (const uint8_t *) sqlite3_column_blob(cur->st, 2);
+    cur->payload_len = sqlite3_column_bytes(cur->st, 2);
+    cur->rs_errs = cur->ncols > 3 ? sqlite3_column_int(cur->st, 3) : 0;
+    cur->ts_ms = cur->ncols > 4 ? sqlite3_column_double(cur->st, 4) : 0.0;
+    cur->aux = cur->ncols > 5 ? (long long) sqlite3_column_int64(cur->st, 5) : 0;
+    return 1;
+}
+
+void reasm_cursor_close(reasm_cursor_t *cur)
+{
+    if (cur->st) sqlite3_finalize(cur->st);
+    cur->st = NULL;
+}
+
+#endif // WITH_SQLITE3
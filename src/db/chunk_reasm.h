@@ -0,0 +1,135 @@
+/*
+
+    Simple Satellite Operations  chunk_reasm.h
+
+    Offset-addressed file reassembly shared by the tools that rebuild a
+    downlinked file from the packets in the packet DB. mpi_reconstruct uses
+    all of it; cam_reconstruct's --patch uses the bulk payload parse and
+    gnss_reports streams its fragments through the cursor.
+
+      - reasm_bulk_chunk: the bulk_file payload geometry
+        ([packet_type:1][file_offset:4 LE][data...]) and its sanity checks.
+      - reasm_map_t: a byte store indexed by a sorted run list, keyed by file
+        offset. Overlapping inserts resolve the way the tools always have --
+        RS-clean data beats uncorrectable data, a later clean chunk replaces
+        an earlier one (a disagreement is counted as a conflict), and
+        uncorrectable data only fills bytes still missing -- so the result
+        does not depend on insertion order. Gaps are found from the run list
+        without a per-byte scan.
+      - reasm_sessions: split time-ordered chunks into download sessions
+        around the marker-bearing ones, with binary-searched window edges
+        (O(n log n) overall instead of a rescan of every chunk per session).
+      - reasm_cursor_t (sqlite3 builds): a streaming cursor over a
+        time-ordered packet query, handing out each row's payload in place
+        instead of copying every chunk into memory first.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHUNK_REASM_H
+#define CHUNK_REASM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bulk-file packet geometry (mirrors packet_browser.c / beacon_cts1.h). The
+// firmware sends at most 195 file bytes per packet; the ground appends a
+// 4-byte CSP CRC32 trailer, dropped by clamping the data to 195. Offsets past
+// REASM_BULK_MAX_PLAUSIBLE are bit flips (the firmware caps a download at
+// 1 MB).
+#define REASM_BULK_PACKET_TYPE      16
+#define REASM_BULK_HEADER_SIZE      5
+#define REASM_BULK_MAX_DATA         195
+#define REASM_BULK_MAX_PLAUSIBLE    (2 * 1024 * 1024)
+
+// Split a bulk_file payload into its file offset and data bytes (clamped to
+// REASM_BULK_MAX_DATA). Returns 0, or -1 for a payload with no data or an
+// implausible offset. *data points into pl.
+int reasm_bulk_chunk(const uint8_t *pl, int pl_len,
+                     long *off, const uint8_t **data, long *dlen);
+
+// One run of present bytes [start, end), all clean or all uncorrectable.
+typedef struct {
+    long start, end;
+    int  clean;
+} reasm_run_t;
+
+typedef struct {
+    uint8_t     *bytes;      // [0, size); missing bytes hold `fill`
+    long         size;       // highest inserted end
+    long         cap;
+    uint8_t      fill;
+    reasm_run_t *runs;       // sorted, disjoint; neighbours of equal quality merged
+    size_t       n_runs, cap_runs;
+    long         present;    // bytes holding data
+    long         conflicts;  // clean bytes replaced by a different clean byte
+    long         min_off;    // lowest inserted offset, -1 while empty
+} reasm_map_t;
+
+void reasm_map_init(reasm_map_t *m, uint8_t fill);
+void reasm_map_free(reasm_map_t *m);
+
+// Lay len bytes at file offset off. Returns how many of them were missing
+// before (newly present), or -1 on allocation failure.
+long reasm_map_insert(reasm_map_t *m, long off, const uint8_t *data, long len, int clean);
+
+// First missing byte at or after `from` within [0, size), or -1. The gap
+// runs to *gap_end (exclusive).
+long reasm_map_next_gap(const reasm_map_t *m, long from, long *gap_end);
+
+// A download session: chunks [lo, hi) of the time-ordered input, gathered
+// around the marker-bearing chunks first_mark .. last_mark.
+typedef struct {
+    size_t lo, hi;
+    size_t first_mark, last_mark;
+} reasm_session_t;
+
+// Cluster the marked chunks of ts_ms[0..n) (unix ms, ascending) into
+// sessions: a gap over gap_ms between two marked chunks starts a new one.
+// Each session's window is its marked span padded by margin_ms on both
+// sides. Returns the session count with a malloc'd array in *out, or -1.
+long reasm_sessions(const double *ts_ms, const unsigned char *marked, size_t n,
+                    double gap_ms, double margin_ms, reasm_session_t **out);
+
+#ifdef WITH_SQLITE3
+#include <sqlite3.h>
+
+// Streaming cursor over a packet query whose result columns are, in order,
+//   id, ts_received, payload [, rs_errs [, ts_ms [, aux]]]
+// (the trailing ones optional). Bind parameters on cur.st after open.
+// The row fields are valid until the next reasm_cursor_next.
+typedef struct {
+    sqlite3_stmt  *st;
+    int            ncols;
+    long long      id;
+    const char    *ts_received;
+    const uint8_t *payload;
+    int            payload_len;
+    int            rs_errs;      // 0 when the query has no such column
+    double         ts_ms;        // 0 when the query has no such column
+    long long      aux;          // query-defined; 0 when absent
+} reasm_cursor_t;
+
+// Returns 0, or -1 with the sqlite error printed under `who` (silent when
+// who is NULL, for a caller that falls back to another query).
+int  reasm_cursor_open(reasm_cursor_t *cur, sqlite3 *db, const char *sql, const char *who);
+// 1 with the next row loaded, 0 at the end, -1 on error.
+int  reasm_cursor_next(reasm_cursor_t *cur);
+void reasm_cursor_close(reasm_cursor_t *cur);
+
+#endif // WITH_SQLITE3
+
+#endif // CHUNK_REASM_H
@@ -20,7 +20,9 @@
 
 #include "packet_db.h"
 
+#include "lat_trace.h"
 #include "sso_paths.h"
+#include "tcmd_response.h"
 
 #include <errno.h>
 #include <fcntl.h>
@@ -111,6 +113,59 @@ int packet_db_default_path(char *buf, size_t cap)
     return 0;
 }
 
+// Byte length of the UTF-8 sequence starting at `s` (1 for ASCII and for
+// a stray continuation byte, so a malformed string still advances).
+static size_t utf8_len(const unsigned char *s)
+{
+    if (*s < 0xC0) return 1;
+    size_t n = (*s >= 0xF0) ? 4 : (*s >= 0xE0) ? 3 : 2;
+    for (size_t i = 1; i < n; i++)
+        if ((s[i] & 0xC0) != 0x80) return i;
+    return n;
+}
+
+int packet_db_fts_match(const char *like_pattern, const char *columns,
+                        char *out, size_t cap)
+{
+    if (like_pattern == NULL || out == NULL || cap == 0) return -1;
+    size_t off = 0;
+    int phrases = 0;
+    out[0] = '\0';
+    const unsigned char *p = (const unsigned char *) like_pattern;
+    while (*p != '\0') {
+        // One literal run: everything up to the next LIKE wildcard.
+        const unsigned char *run = p;
+        int chars = 0;
+        while (*p != '\0' && *p != '%' && *p != '_') {
+            p += utf8_len(p);
+            chars++;
+        }
+        const unsigned char *end = p;
+        if (*p != '\0') p++;
+        // The trigram tokenizer can't look up fewer than 3 characters.
+        if (chars < 3) continue;
+
+        int n = snprintf(out + off, cap - off, "%s%s%s%s\"",
+                         phrases > 0 ? " AND " : "",
+                         columns ? "{" : "", columns ? columns : "",
+                         columns ? "} : " : "");
+        if (n < 0 || (size_t) n >= cap - off) return -1;
+        off += (size_t) n;
+        for (const unsigned char *c = run; c < end; c++) {
+            // FTS5 string syntax: a literal '"' is written twice.
+            size_t need = (*c == '"') ? 2 : 1;
+            if (off + need + 1 >= cap) return -1;
+            if (*c == '"') out[off++] = '"';
+            out[off++] = (char) *c;
+        }
+        if (off + 2 > cap) return -1;
+        out[off++] = '"';
+        out[off] = '\0';
+        phrases++;
+    }
+    return phrases;
+}
+
 #ifdef WITH_SQLITE3
 
 // SHA1 via the EVP_* API — the legacy SHA1_Init/Update/Final and the
@@ -118,22 +173,28 @@ int packet_db_default_path(char *buf, size_t cap)
 // (Ubuntu 22.04 etc.). EVP is the supported successor and works on
 // older OpenSSL too.
 #include <openssl/evp.h>
+#include <pthread.h>
 #include <sqlite3.h>
 
 #define PACKET_DB_SHA1_LEN 20
 
-static void sha1_digest(const void *data, size_t len, uint8_t out[PACKET_DB_SHA1_LEN])
+// `ctx` is the handle's long-lived digest context (packet_db_t.sha_ctx):
+// EVP_DigestInit_ex re-arms it per payload, so the insert and backfill hot
+// paths don't pay an EVP_MD_CTX_new/free (two allocations plus the method
+// fetch on OpenSSL 3) per row. NULL falls back to a one-shot context.
+static void sha1_digest(EVP_MD_CTX *ctx, const void *data, size_t len,
+                        uint8_t out[PACKET_DB_SHA1_LEN])
 {
     // Zero first so out is defined even if anything below fails -- this is on
     // the dedup hot path, so a NULL ctx (allocation failure) must not deref.
     memset(out, 0, PACKET_DB_SHA1_LEN);
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (ctx == NULL) return;
+    EVP_MD_CTX *own = NULL;
+    if (ctx == NULL && (ctx = own = EVP_MD_CTX_new()) == NULL) return;
     if (EVP_DigestInit_ex(ctx, EVP_sha1(), NULL) == 1
         && EVP_DigestUpdate(ctx, data, len) == 1) {
         EVP_DigestFinal_ex(ctx, out, NULL);
     }
-    EVP_MD_CTX_free(ctx);
+    EVP_MD_CTX_free(own);
 }
 
 struct packet_db {
@@ -145,6 +206,14 @@ struct packet_db {
     sqlite3_stmt *register_tle_stmt;
     sqlite3_stmt *select_tle_id_stmt;
     sqlite3_stmt *insert_sent_tcmd_stmt;
+    // packet_db_update_observer_many's temp-table statements, prepared on
+    // first use (the temp table only exists once that has run).
+    sqlite3_stmt *bulk_insert_stmt;
+    sqlite3_stmt *bulk_gaps_stmt;
+    sqlite3_stmt *bulk_force_stmt;
+    sqlite3_stmt *bulk_replay_ts_stmt;
+    sqlite3_stmt *bulk_clear_stmt;
+    EVP_MD_CTX   *sha_ctx;
     // Batch mode (see packet_db_set_batch). When batch_mode is set,
     // packet_db_insert deep-copies the record into `batch` instead of
     // writing it; packet_db_flush writes the whole array in one
@@ -153,6 +222,11 @@ struct packet_db {
     packet_db_record_t  *batch;
     size_t               batch_count;
     size_t               batch_cap;
+    // Async writer (see packet_db_start_writer). While non-NULL,
+    // packet_db_insert queues onto it instead of writing. writer_last keeps
+    // the counters of the most recent writer once it has been stopped.
+    struct packet_db_writer  *writer;
+    packet_db_writer_stats_t  writer_last;
 };
 
 // Fresh-DB schema. Existing DBs from user_version=1 get the new columns
@@ -281,6 +355,140 @@ static const char *const MIGRATION_V4_STEPS[] = {
     NULL
 };
 
+// V4 -> V5 migration: an FTS5 full-text index over the text columns the
+// free-text searches (packet_query's bare tokens, packet_browser's `/`)
+// match, so a substring search is an index probe instead of a LIKE scan
+// of every row. The trigram tokenizer is what makes it a drop-in for
+// LIKE '%term%': every run of 3 characters is indexed, so a term matches
+// mid-word, mid-date or mid-number exactly where the substring LIKE did
+// (and case-folded like LIKE). It's an external-content table - the text
+// stays in `packet`, the index holds only the trigrams - kept current by
+// the three triggers; id and tle_id are indexed as text so a search for
+// an id still hits. The last step backfills the existing rows.
+//
+// This step is optional: a sqlite built without FTS5 (or older than
+// 3.34, which added trigram) fails the CREATE, the whole block rolls
+// back, the DB stays at V4, and the tools keep their LIKE scans. See
+// packet_db_fts_match() for how callers use the index.
+#define FTS_COLS \
+    "ts_received, satellite, packet_type_name, decoded_summary, " \
+    "source_tool, source_run, session_dir, capture_origin, id, tle_id"
+#define FTS_COLS_OLD \
+    "old.ts_received, old.satellite, old.packet_type_name, " \
+    "old.decoded_summary, old.source_tool, old.source_run, " \
+    "old.session_dir, old.capture_origin, old.id, old.tle_id"
+#define FTS_COLS_NEW \
+    "new.ts_received, new.satellite, new.packet_type_name, " \
+    "new.decoded_summary, new.source_tool, new.source_run, " \
+    "new.session_dir, new.capture_origin, new.id, new.tle_id"
+static const char *const MIGRATION_V5_STEPS[] = {
+    "CREATE VIRTUAL TABLE IF NOT EXISTS " PACKET_DB_FTS_TABLE " USING fts5("
+    FTS_COLS ", content='packet', content_rowid='id', tokenize='trigram')",
+    "CREATE TRIGGER IF NOT EXISTS packet_fts_ai AFTER INSERT ON packet BEGIN "
+    "  INSERT INTO " PACKET_DB_FTS_TABLE "(rowid, " FTS_COLS ") "
+    "    VALUES (new.id, " FTS_COLS_NEW "); "
+    "END",
+    "CREATE TRIGGER IF NOT EXISTS packet_fts_ad AFTER DELETE ON packet BEGIN "
+    "  INSERT INTO " PACKET_DB_FTS_TABLE "(" PACKET_DB_FTS_TABLE ", rowid, " FTS_COLS ") "
+    "    VALUES ('delete', old.id, " FTS_COLS_OLD "); "
+    "END",
+    "CREATE TRIGGER IF NOT EXISTS packet_fts_au AFTER UPDATE OF "
+    "  ts_received, satellite, packet_type_name, decoded_summary, "
+    "  source_tool, source_run, session_dir, capture_origin, tle_id "
+    "ON packet BEGIN "
+    "  INSERT INTO " PACKET_DB_FTS_TABLE "(" PACKET_DB_FTS_TABLE ", rowid, " FTS_COLS ") "
+    "    VALUES ('delete', old.id, " FTS_COLS_OLD "); "
+    "  INSERT INTO " PACKET_DB_FTS_TABLE "(rowid, " FTS_COLS ") "
+    "    VALUES (new.id, " FTS_COLS_NEW "); "
+    "END",
+    "INSERT INTO " PACKET_DB_FTS_TABLE "(" PACKET_DB_FTS_TABLE ") VALUES ('rebuild')",
+    NULL
+};
+
+// V5 -> V6 migration: store a tcmd_response's ts_sent (payload bytes
+// 1..8, LE unix-ms) in its own column. Every "responses to this command"
+// lookup used to match the computed TCMD_RESP_SQL_TS_SENT blob, which no
+// index covers, so each one scanned every tcmd_response row; with the
+// column and the partial index it's a range seek, and the per-command
+// counts tcmd_browser shows are one grouped index-only query. The index
+// carries ts_received so the report tools' "ORDER BY key, ts_received"
+// walks it without a sort, and it's partial because the key is NULL on
+// every non-response row. Step 1's "duplicate column name" is caught
+// like V4's; step 2 backfills through packet_db_resp_ts_sent(), the
+// SQL function packet_db_open registers (see resp_ts_sent_fn).
+static const char *const MIGRATION_V6_STEPS[] = {
+    "ALTER TABLE packet ADD COLUMN " PACKET_DB_RESP_TS_COL " INTEGER",
+    "UPDATE packet SET " PACKET_DB_RESP_TS_COL " = packet_db_resp_ts_sent(payload) "
+    "  WHERE " TCMD_RESP_SQL_IS " AND " PACKET_DB_RESP_TS_COL " IS NULL",
+    "CREATE INDEX IF NOT EXISTS idx_packet_resp_ts "
+    "  ON packet(" PACKET_DB_RESP_TS_COL ", ts_received) "
+    "  WHERE " PACKET_DB_RESP_TS_COL " IS NOT NULL",
+    NULL
+};
+
+// V6 -> V7 migration: fill the V6 join key in the database itself, so
+// a row written by anything that doesn't know the column - an older
+// build still running against the upgraded file, a hand-run INSERT -
+// gets it too instead of a NULL that every "responses to this command"
+// lookup silently misses. The insert path below still binds the value
+// and the trigger's WHEN skips those rows. The decode is spelled in
+// plain SQL rather than through packet_db_resp_ts_sent(): that function
+// exists only on connections opened here, and a trigger calling it
+// would make an older writer's INSERT fail with "no such function".
+// RESP_TS_SQL(p) is the LE 8-byte read as one nibble lookup per hex
+// digit; SQLite's << wraps like a u64, which is the same (int64) cast
+// resp_ts_sent_ms() applies. Step 2 picks up the rows such writers
+// stored between V6 and now.
+#define RESP_TS_NIB(p, i) \
+    "(instr('0123456789ABCDEF', substr(hex(substr(" p ", 2, 8)), " i ", 1)) - 1)"
+#define RESP_TS_BYTE(p, hi, lo, sh) \
+    "((" RESP_TS_NIB(p, hi) " * 16 + " RESP_TS_NIB(p, lo) ") << " sh ")"
+#define RESP_TS_SQL(p) \
+    "(" RESP_TS_BYTE(p, "1", "2", "0") " | " RESP_TS_BYTE(p, "3", "4", "8") \
+    " | " RESP_TS_BYTE(p, "5", "6", "16") " | " RESP_TS_BYTE(p, "7", "8", "24") \
+    " | " RESP_TS_BYTE(p, "9", "10", "32") " | " RESP_TS_BYTE(p, "11", "12", "40") \
+    " | " RESP_TS_BYTE(p, "13", "14", "48") " | " RESP_TS_BYTE(p, "15", "16", "56") ")"
+static const char *const MIGRATION_V7_STEPS[] = {
+    "CREATE TRIGGER IF NOT EXISTS packet_resp_ts_ai AFTER INSERT ON packet "
+    "WHEN new.packet_type = 4 AND new." PACKET_DB_RESP_TS_COL " IS NULL "
+    "  AND length(new.payload) >= 9 BEGIN "
+    "  UPDATE packet SET " PACKET_DB_RESP_TS_COL " = " RESP_TS_SQL("new.payload")
+    "    WHERE id = new.id; "
+    "END",
+    "UPDATE packet SET " PACKET_DB_RESP_TS_COL " = " RESP_TS_SQL("payload")
+    "  WHERE " TCMD_RESP_SQL_IS " AND " PACKET_DB_RESP_TS_COL " IS NULL "
+    "  AND length(payload) >= 9",
+    NULL
+};
+
+// V7 -> V8 migration: the V5 update trigger re-tokenizes a row whenever
+// one of its columns is assigned, even to the value it already holds, so
+// an observer backfill that re-stamps geometry and writes back the same
+// session_dir / tle_id paid for a full FTS delete + insert per row. The
+// replacement fires only when an indexed value actually changed. Applied
+// only where V5 built the index (packet_db_open probes for it first).
+static const char *const MIGRATION_V8_STEPS[] = {
+    "DROP TRIGGER IF EXISTS packet_fts_au",
+    "CREATE TRIGGER packet_fts_au AFTER UPDATE OF "
+    "  ts_received, satellite, packet_type_name, decoded_summary, "
+    "  source_tool, source_run, session_dir, capture_origin, tle_id "
+    "ON packet WHEN old.ts_received IS NOT new.ts_received "
+    "  OR old.satellite IS NOT new.satellite "
+    "  OR old.packet_type_name IS NOT new.packet_type_name "
+    "  OR old.decoded_summary IS NOT new.decoded_summary "
+    "  OR old.source_tool IS NOT new.source_tool "
+    "  OR old.source_run IS NOT new.source_run "
+    "  OR old.session_dir IS NOT new.session_dir "
+    "  OR old.capture_origin IS NOT new.capture_origin "
+    "  OR old.tle_id IS NOT new.tle_id BEGIN "
+    "  INSERT INTO " PACKET_DB_FTS_TABLE "(" PACKET_DB_FTS_TABLE ", rowid, " FTS_COLS ") "
+    "    VALUES ('delete', old.id, " FTS_COLS_OLD "); "
+    "  INSERT INTO " PACKET_DB_FTS_TABLE "(rowid, " FTS_COLS ") "
+    "    VALUES (new.id, " FTS_COLS_NEW "); "
+    "END",
+    NULL
+};
+
 static const char INSERT_SQL[] =
     "INSERT OR IGNORE INTO packet ("
     "  ts_received, satellite, packet_type, packet_type_name,"
@@ -289,7 +497,7 @@ static const char INSERT_SQL[] =
     "  golay_errs, rs_errs, hmac_ok, crc_status,"
     "  source_tool, source_run, audio_offset_s, decoded_summary,"
     "  az_deg, el_deg, range_km, range_rate_km_s, doppler_hz_offset,"
-    "  tle_id, session_dir, capture_origin"
+    "  tle_id, session_dir, capture_origin, " PACKET_DB_RESP_TS_COL
     ") VALUES ("
     "  ?1, ?2, ?3, ?4,"
     "  ?5, ?6, ?7, ?8, ?9, ?10,"
@@ -297,7 +505,7 @@ static const char INSERT_SQL[] =
     "  ?13, ?14, ?15, ?16,"
     "  ?17, ?18, ?19, ?20,"
     "  ?21, ?22, ?23, ?24, ?25,"
-    "  ?26, ?27, ?28"
+    "  ?26, ?27, ?28, ?29"
     ");";
 
 // UPDATE for the rx_replay backfill path. Fills observer / tle / dir
@@ -332,6 +540,48 @@ static const char UPDATE_REPLAY_TS_SQL[] =
     "  ts_received = ?1, audio_offset_s = ?2"
     " WHERE payload_sha1 = ?3 AND source_tool = 'rx_replay';";
 
+// Bulk form of the three updates above (packet_db_update_observer_many).
+// The batch is staged in a per-connection temp table, one row per payload
+// SHA1, and each UPDATE joins it against packet in a single statement.
+// The "payload_sha1 IN (SELECT sha ...)" term is redundant with the join
+// but makes the planner drive from the (small) batch through the sha1
+// index; without it, it scans the whole packet table and probes the batch.
+#define BULK_TABLE "temp.packet_db_bulk_update"
+#define BULK_JOIN \
+    " FROM " BULK_TABLE " AS u WHERE packet.payload_sha1 = u.sha" \
+    " AND packet.payload_sha1 IN (SELECT sha FROM " BULK_TABLE ")"
+static const char BULK_CREATE_SQL[] =
+    "CREATE TEMP TABLE IF NOT EXISTS packet_db_bulk_update ("
+    "  sha BLOB PRIMARY KEY, az REAL, el REAL, range_km REAL, rate REAL,"
+    "  doppler REAL, tle_id INTEGER, session_dir TEXT,"
+    "  ts_received TEXT, audio_offset_s REAL"
+    ") WITHOUT ROWID;";
+static const char BULK_INSERT_SQL[] =
+    "INSERT INTO " BULK_TABLE " VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10);";
+static const char BULK_GAPS_SQL[] =
+    "UPDATE packet SET"
+    "  az_deg = COALESCE(packet.az_deg, u.az),"
+    "  el_deg = COALESCE(packet.el_deg, u.el),"
+    "  range_km = COALESCE(packet.range_km, u.range_km),"
+    "  range_rate_km_s = COALESCE(packet.range_rate_km_s, u.rate),"
+    "  doppler_hz_offset = COALESCE(packet.doppler_hz_offset, u.doppler),"
+    "  tle_id = COALESCE(packet.tle_id, u.tle_id),"
+    "  session_dir = COALESCE(packet.session_dir, u.session_dir)"
+    BULK_JOIN ";";
+static const char BULK_FORCE_SQL[] =
+    "UPDATE packet SET"
+    "  az_deg = u.az, el_deg = u.el, range_km = u.range_km,"
+    "  range_rate_km_s = u.rate, doppler_hz_offset = u.doppler,"
+    "  tle_id = u.tle_id, session_dir = u.session_dir"
+    BULK_JOIN ";";
+static const char BULK_REPLAY_TS_SQL[] =
+    "UPDATE packet SET"
+    "  ts_received = u.ts_received, audio_offset_s = u.audio_offset_s"
+    BULK_JOIN " AND u.ts_received IS NOT NULL"
+    " AND packet.source_tool = 'rx_replay';";
+static const char BULK_CLEAR_SQL[] =
+    "DELETE FROM " BULK_TABLE ";";
+
 static const char REGISTER_TLE_SQL[] =
     "INSERT OR IGNORE INTO tle ("
     "  satellite, catalog_number, epoch_year, epoch_day,"
@@ -347,6 +597,45 @@ static const char INSERT_SENT_TCMD_SQL[] =
     "  source_tool, source_run, ts_transmitted"
     ") VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8);";
 
+static int read_user_version(sqlite3 *raw)
+{
+    int v = 0;
+    sqlite3_stmt *uv = NULL;
+    if (sqlite3_prepare_v2(raw, "PRAGMA user_version;", -1, &uv, NULL)
+            == SQLITE_OK
+        && sqlite3_step(uv) == SQLITE_ROW) {
+        v = sqlite3_column_int(uv, 0);
+    }
+    sqlite3_finalize(uv);
+    return v;
+}
+
+// The stored join key for a tcmd_response payload: ts_sent as a signed
+// 64-bit integer (the same cast sent_tcmd.ts_sent_ms gets), or -1 when
+// the payload is too short to carry one.
+static int resp_ts_sent_ms(const uint8_t *payload, size_t len, sqlite3_int64 *out)
+{
+    uint64_t v = 0;
+    if (tcmd_resp_ts_sent_u64(payload, len, &v) != 0) return -1;
+    *out = (sqlite3_int64) v;
+    return 0;
+}
+
+// packet_db_resp_ts_sent(payload): SQL face of resp_ts_sent_ms() for the
+// V6 backfill, NULL for a short payload. Registered per connection, so it
+// exists only on writer handles opened here; nothing stored depends on it.
+static void resp_ts_sent_fn(sqlite3_context *ctx, int argc, sqlite3_value **argv)
+{
+    (void) argc;
+    sqlite3_int64 v = 0;
+    const uint8_t *pl = sqlite3_value_blob(argv[0]);
+    if (pl != NULL
+        && resp_ts_sent_ms(pl, (size_t) sqlite3_value_bytes(argv[0]), &v) == 0)
+        sqlite3_result_int64(ctx, v);
+    else
+        sqlite3_result_null(ctx);
+}
+
 packet_db_t *packet_db_open(const char *path)
 {
     if (path == NULL || path[0] == '\0') return NULL;
@@ -409,16 +698,7 @@ packet_db_t *packet_db_open(const char *path)
     // including every short-lived tool launch that contends with a live
     // receiver. A new DB reports 0 and migrates once; thereafter the version
     // matches and the ladder is skipped.
-    int user_version = 0;
-    {
-        sqlite3_stmt *uv = NULL;
-        if (sqlite3_prepare_v2(raw, "PRAGMA user_version;", -1, &uv, NULL)
-                == SQLITE_OK
-            && sqlite3_step(uv) == SQLITE_ROW) {
-            user_version = sqlite3_column_int(uv, 0);
-        }
-        sqlite3_finalize(uv);
-    }
+    int user_version = read_user_version(raw);
 
     // V1 -> V2 migration: idempotent ALTER TABLE ADD COLUMNs. SQLite
     // returns "duplicate column name" when the column already exists;
@@ -494,6 +774,111 @@ packet_db_t *packet_db_open(const char *path)
         (void) sqlite3_exec(raw, "PRAGMA user_version = 4;", NULL, NULL, NULL);
     }
 
+    // V4 -> V5: the FTS5 search index. Unlike the steps above this one is
+    // all-or-nothing in one transaction, because the backfill is the slow
+    // part (tens of seconds on a full mission archive) and a second
+    // process opening the DB meanwhile must not repeat it: it waits on
+    // BEGIN IMMEDIATE, then sees V5 and commits an empty transaction.
+    // Failure is not fatal (see MIGRATION_V5_STEPS).
+    if (user_version < 5
+        && sqlite3_exec(raw, "BEGIN IMMEDIATE", NULL, NULL, NULL) == SQLITE_OK) {
+        int ok = 1;
+        if (read_user_version(raw) < 5) {
+            for (int i = 0; ok && MIGRATION_V5_STEPS[i] != NULL; i++) {
+                char *m_err = NULL;
+                if (sqlite3_exec(raw, MIGRATION_V5_STEPS[i], NULL, NULL, &m_err)
+                    != SQLITE_OK) {
+                    fprintf(stderr, "packet_db: full-text index not built "
+                            "(%s); free-text search stays a LIKE scan\n",
+                            m_err ? m_err : "(unknown)");
+                    ok = 0;
+                }
+                sqlite3_free(m_err);
+            }
+            if (ok) ok = sqlite3_exec(raw, "PRAGMA user_version = 5;",
+                                      NULL, NULL, NULL) == SQLITE_OK;
+        }
+        (void) sqlite3_exec(raw, ok ? "COMMIT" : "ROLLBACK", NULL, NULL, NULL);
+    }
+
+    // V5 -> V6: the stored tcmd_response join key. Runs even when V5 was
+    // skipped for lack of FTS5 - readers probe for each feature rather
+    // than trusting the version number.
+    if (user_version < 6) {
+        (void) sqlite3_create_function(raw, "packet_db_resp_ts_sent", 1,
+                                       SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                       NULL, resp_ts_sent_fn, NULL, NULL);
+        for (int i = 0; MIGRATION_V6_STEPS[i] != NULL; i++) {
+            char *m_err = NULL;
+            if (sqlite3_exec(raw, MIGRATION_V6_STEPS[i], NULL, NULL, &m_err)
+                != SQLITE_OK) {
+                int dup = (m_err != NULL
+                           && strstr(m_err, "duplicate column name") != NULL);
+                if (!dup) {
+                    fprintf(stderr, "packet_db: migration step '%s' failed: "
+                            "%s\n", MIGRATION_V6_STEPS[i],
+                            m_err ? m_err : "(unknown)");
+                    sqlite3_free(m_err);
+                    sqlite3_close(raw);
+                    errno = EIO;
+                    return NULL;
+                }
+                sqlite3_free(m_err);
+            }
+        }
+        (void) sqlite3_exec(raw, "PRAGMA user_version = 6;", NULL, NULL, NULL);
+    }
+
+    // V6 -> V7: the trigger that keeps resp_ts_sent_ms filled for writers
+    // that don't set it. Both steps are idempotent.
+    if (user_version < 7) {
+        for (int i = 0; MIGRATION_V7_STEPS[i] != NULL; i++) {
+            char *m_err = NULL;
+            if (sqlite3_exec(raw, MIGRATION_V7_STEPS[i], NULL, NULL, &m_err)
+                != SQLITE_OK) {
+                fprintf(stderr, "packet_db: migration step '%s' failed: "
+                        "%s\n", MIGRATION_V7_STEPS[i],
+                        m_err ? m_err : "(unknown)");
+                sqlite3_free(m_err);
+                sqlite3_close(raw);
+                errno = EIO;
+                return NULL;
+            }
+        }
+        (void) sqlite3_exec(raw, "PRAGMA user_version = 7;", NULL, NULL, NULL);
+    }
+
+    // V7 -> V8: swap in the change-only FTS update trigger. Drop and
+    // create go in one transaction so no UPDATE can slip in between and
+    // leave the index stale; a DB without the index (V5 skipped) has no
+    // trigger to replace and is just stamped.
+    if (user_version < 8
+        && sqlite3_exec(raw, "BEGIN IMMEDIATE", NULL, NULL, NULL) == SQLITE_OK) {
+        int ok = 1;
+        if (read_user_version(raw) < 8) {
+            sqlite3_stmt *probe = NULL;
+            int has_fts = 0;
+            if (sqlite3_prepare_v2(raw, PACKET_DB_SQL_HAS_FTS, -1, &probe, NULL)
+                == SQLITE_OK) {
+                has_fts = (sqlite3_step(probe) == SQLITE_ROW);
+                sqlite3_finalize(probe);
+            }
+            for (int i = 0; ok && has_fts && MIGRATION_V8_STEPS[i] != NULL; i++) {
+                char *m_err = NULL;
+                if (sqlite3_exec(raw, MIGRATION_V8_STEPS[i], NULL, NULL, &m_err)
+                    != SQLITE_OK) {
+                    fprintf(stderr, "packet_db: FTS update trigger not "
+                            "replaced (%s)\n", m_err ? m_err : "(unknown)");
+                    ok = 0;
+                }
+                sqlite3_free(m_err);
+            }
+            if (ok) ok = sqlite3_exec(raw, "PRAGMA user_version = 8;",
+                                      NULL, NULL, NULL) == SQLITE_OK;
+        }
+        (void) sqlite3_exec(raw, ok ? "COMMIT" : "ROLLBACK", NULL, NULL, NULL);
+    }
+
     packet_db_t *db = (packet_db_t *)calloc(1, sizeof *db);
     if (db == NULL) {
         sqlite3_close(raw);
@@ -501,6 +886,7 @@ packet_db_t *packet_db_open(const char *path)
         return NULL;
     }
     db->db = raw;
+    db->sha_ctx = EVP_MD_CTX_new();   // NULL just means one-shot digests
 
     struct { const char *sql; sqlite3_stmt **out; } stmts[] = {
         { INSERT_SQL,                &db->insert_stmt           },
@@ -594,6 +980,36 @@ static void batch_clear(packet_db_t *db)
     db->batch_cap = 0;
 }
 
+// Deep-copy *src into *d: scalars by value, every borrowed string/blob
+// into an owned allocation. Returns -1 (with *d released) when any copy
+// fails, so a row is reported lost rather than stored truncated.
+static int copy_record(packet_db_record_t *d, const packet_db_record_t *src)
+{
+    *d = *src;
+    d->ts_received      = dup_str(src->ts_received);
+    d->satellite        = dup_str(src->satellite);
+    d->packet_type_name = dup_str(src->packet_type_name);
+    d->source_tool      = dup_str(src->source_tool);
+    d->source_run       = dup_str(src->source_run);
+    d->decoded_summary  = dup_str(src->decoded_summary);
+    d->session_dir      = dup_str(src->session_dir);
+    d->capture_origin   = dup_str(src->capture_origin);
+    d->payload          = dup_bytes(src->payload, src->payload_len);
+    // A NULL copy of a field whose source was non-NULL means malloc failed.
+    int oom = (d->ts_received == NULL || d->packet_type_name == NULL
+               || d->source_tool == NULL || d->payload == NULL
+               || (src->satellite       != NULL && d->satellite       == NULL)
+               || (src->source_run      != NULL && d->source_run      == NULL)
+               || (src->decoded_summary != NULL && d->decoded_summary == NULL)
+               || (src->session_dir     != NULL && d->session_dir     == NULL)
+               || (src->capture_origin  != NULL && d->capture_origin  == NULL));
+    if (oom) {
+        free_record(d);
+        return -1;
+    }
+    return 0;
+}
+
 static int batch_append(packet_db_t *db, const packet_db_record_t *rec)
 {
     if (db->batch_count == db->batch_cap) {
@@ -604,31 +1020,8 @@ static int batch_append(packet_db_t *db, const packet_db_record_t *rec)
         db->batch = nb;
         db->batch_cap = ncap;
     }
-    packet_db_record_t *d = &db->batch[db->batch_count];
-    // Copy scalars, then replace every borrowed pointer with an owned copy.
-    *d = *rec;
-    d->ts_received      = dup_str(rec->ts_received);
-    d->satellite        = dup_str(rec->satellite);
-    d->packet_type_name = dup_str(rec->packet_type_name);
-    d->source_tool      = dup_str(rec->source_tool);
-    d->source_run       = dup_str(rec->source_run);
-    d->decoded_summary  = dup_str(rec->decoded_summary);
-    d->session_dir      = dup_str(rec->session_dir);
-    d->capture_origin   = dup_str(rec->capture_origin);
-    d->payload          = dup_bytes(rec->payload, rec->payload_len);
-    // A NULL copy of a field whose source was non-NULL means malloc failed.
-    // Fail the whole append so the row is reported lost, not stored truncated.
-    int oom = (d->ts_received == NULL || d->packet_type_name == NULL
-               || d->source_tool == NULL || d->payload == NULL
-               || (rec->satellite       != NULL && d->satellite       == NULL)
-               || (rec->source_run      != NULL && d->source_run      == NULL)
-               || (rec->decoded_summary != NULL && d->decoded_summary == NULL)
-               || (rec->session_dir     != NULL && d->session_dir     == NULL)
-               || (rec->capture_origin  != NULL && d->capture_origin  == NULL));
-    if (oom) {
-        free_record(d);
+    if (copy_record(&db->batch[db->batch_count], rec) != 0)
         return PACKET_DB_INSERT_ERROR;
-    }
     db->batch_count++;
     return PACKET_DB_INSERT_OK;
 }
@@ -643,7 +1036,7 @@ static int insert_bound(packet_db_t *db, const packet_db_record_t *rec)
     // SHA1 of the raw payload, used for dedup. 20 bytes; stored as a
     // BLOB rather than hex so the index entries stay small.
     uint8_t sha[PACKET_DB_SHA1_LEN];
-    sha1_digest(rec->payload, rec->payload_len, sha);
+    sha1_digest(db->sha_ctx, rec->payload, rec->payload_len, sha);
 
     sqlite3_reset(s);
     sqlite3_clear_bindings(s);
@@ -678,6 +1071,12 @@ static int insert_bound(packet_db_t *db, const packet_db_record_t *rec)
     else sqlite3_bind_null(s, 26);
     bind_text_or_null(s, 27, rec->session_dir);
     bind_text_or_null(s, 28, rec->capture_origin);
+    sqlite3_int64 resp_ts = 0;
+    if (rec->packet_type == TCMD_RESP_PACKET_TYPE
+        && resp_ts_sent_ms(rec->payload, rec->payload_len, &resp_ts) == 0)
+        sqlite3_bind_int64(s, 29, resp_ts);
+    else
+        sqlite3_bind_null(s, 29);
 
     int rc = sqlite3_step(s);
     if (rc != SQLITE_DONE) {
@@ -694,6 +1093,9 @@ static int insert_bound(packet_db_t *db, const packet_db_record_t *rec)
     return PACKET_DB_INSERT_OK;
 }
 
+static int writer_enqueue(struct packet_db_writer *w,
+                          const packet_db_record_t *rec);
+
 int packet_db_insert(packet_db_t *db, const packet_db_record_t *rec)
 {
     if (db == NULL || db->db == NULL || db->insert_stmt == NULL) return 0;
@@ -702,9 +1104,15 @@ int packet_db_insert(packet_db_t *db, const packet_db_record_t *rec)
         || rec->packet_type_name == NULL) {
         return -1;
     }
+    // Async writer: queue an owned copy for the writer thread. Only a
+    // failed copy (OOM) falls through to the synchronous write below.
+    if (db->writer != NULL && writer_enqueue(db->writer, rec) == 0)
+        return PACKET_DB_INSERT_OK;
     // Batch mode: stash an owned copy now, write it at flush time.
-    if (db->batch_mode) return batch_append(db, rec);
-    return insert_bound(db, rec);
+    if (db->writer == NULL && db->batch_mode) return batch_append(db, rec);
+    int rc = insert_bound(db, rec);
+    if (rc == PACKET_DB_INSERT_OK) lat_trace_mark(LAT_DB, rec->trace_t0_ns);
+    return rc;
 }
 
 void packet_db_set_batch(packet_db_t *db, int enabled)
@@ -767,6 +1175,321 @@ int packet_db_flush(packet_db_t *db)
     return result;
 }
 
+// --- Async writer -----------------------------------------------------
+//
+// Producer/consumer ring drained by one writer pthread, the same shape as
+// sso_audit's. The producer (the RX worker, via packet_db_insert) deep-
+// copies the record off-lock and holds w->mu only to drop it into the
+// ring, so its critical section is a struct copy and an index bump — it
+// never waits on SQLite. The writer takes the lock briefly to pull up to
+// group_rows records out, then writes them on its own connection (the
+// caller's handle stays free for the TX thread's sent_tcmd rows and the
+// operator's TLE registration). Unlike sso_audit there is no drop-oldest:
+// a full ring blocks the producer, because a packet is not a log line.
+
+typedef struct packet_db_writer {
+    packet_db_t        *conn;        // writer-owned connection
+    pthread_t           thread;
+    pthread_mutex_t     mu;
+    pthread_cond_t      not_empty;
+    pthread_cond_t      not_full;
+    packet_db_record_t *ring;
+    int                 cap;
+    int                 head;        // next slot to write
+    int                 tail;        // next slot to read
+    int                 count;
+    int                 inflight;    // pulled from the ring, not committed
+    int                 group_rows;
+    int                 group_ms;
+    int                 stop;
+    packet_db_record_t *group;       // writer-thread scratch, group_rows
+    unsigned char      *failed;      // long, so the loop never allocates
+    packet_db_writer_stats_t st;     // guarded by mu
+} packet_db_writer_t;
+
+static double mono_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec * 1e-6;
+}
+
+static int writer_enqueue(packet_db_writer_t *w, const packet_db_record_t *rec)
+{
+    packet_db_record_t copy;
+    if (copy_record(&copy, rec) != 0) return -1;
+    pthread_mutex_lock(&w->mu);
+    if (w->count == w->cap) w->st.producer_waits++;
+    while (w->count == w->cap) pthread_cond_wait(&w->not_full, &w->mu);
+    w->ring[w->head] = copy;
+    w->head = (w->head + 1) % w->cap;
+    w->count++;
+    long depth = (long)(w->count + w->inflight);
+    if (depth > w->st.queue_max_depth) w->st.queue_max_depth = depth;
+    // Wake the writer on the first row of a group (it starts the group_ms
+    // clock) and when a full group is ready; rows in between just land.
+    if (w->count == 1 || w->count == w->group_rows)
+        pthread_cond_signal(&w->not_empty);
+    pthread_mutex_unlock(&w->mu);
+    return 0;
+}
+
+// Count one BUSY retry and report whether the writer should give up:
+// only once stop is requested, and then after PACKET_DB_WRITER_DRAIN_S
+// (*give_up_at starts negative and is armed on the first call).
+static int writer_busy_give_up(packet_db_writer_t *w, double *give_up_at)
+{
+    pthread_mutex_lock(&w->mu);
+    w->st.busy_retries++;
+    int stop = w->stop;
+    pthread_mutex_unlock(&w->mu);
+    if (!stop) return 0;
+    double now = mono_ms();
+    if (*give_up_at < 0.0) {
+        *give_up_at = now + PACKET_DB_WRITER_DRAIN_S * 1e3;
+        return 0;
+    }
+    return now >= *give_up_at;
+}
+
+// The group's transaction failed hard (BEGIN or COMMIT refused for a
+// reason other than the lock). Insert the rows one by one in autocommit
+// instead, as the synchronous path would, so only a row that fails on
+// its own is lost rather than the whole group. Returns the rows lost,
+// including those already marked failed.
+static long writer_commit_rows(packet_db_writer_t *w, int n, double *give_up_at)
+{
+    packet_db_record_t *recs   = w->group;
+    unsigned char      *failed = w->failed;
+    long lost = 0;
+    int  landed = 0;
+    for (int i = 0; i < n; i++) {
+        if (!failed[i]) {
+            int irc;
+            while ((irc = insert_bound(w->conn, &recs[i])) == PACKET_DB_INSERT_BUSY
+                   && !writer_busy_give_up(w, give_up_at)) {}
+            if (irc == PACKET_DB_INSERT_OK) {
+                lat_trace_mark(LAT_DB, recs[i].trace_t0_ns);
+                landed++;
+            } else {
+                failed[i] = 1;
+            }
+        }
+        if (failed[i]) lost++;
+    }
+    if (lost > 0)
+        fprintf(stderr, "packet_db: writer lost %ld of %d row(s) after the "
+                "group transaction failed\n", lost, n);
+    pthread_mutex_lock(&w->mu);
+    w->st.commits += (uint64_t) landed;
+    w->st.rows_committed += (uint64_t) landed;
+    pthread_mutex_unlock(&w->mu);
+    return lost;
+}
+
+// Write recs[0..n) in one transaction on the writer's connection. A BUSY
+// on BEGIN/COMMIT (the busy_timeout is group_ms here, so the thread stays
+// responsive) rolls back and retries the whole group; a row that fails
+// hard is marked done and the group retried without it, since a failed
+// statement can take the transaction down with it. A hard failure of the
+// transaction itself falls back to writer_commit_rows. Returns the number
+// of rows lost. Once stop is requested, BUSY retries are bounded by
+// PACKET_DB_WRITER_DRAIN_S.
+static long writer_commit(packet_db_writer_t *w, int n)
+{
+    packet_db_record_t *recs   = w->group;
+    unsigned char      *failed = w->failed;
+    sqlite3 *raw = w->conn->db;
+    double give_up_at = -1.0;
+    long   lost = 0;
+    memset(failed, 0, (size_t)n);
+    for (;;) {
+        double t0 = mono_ms();
+        int busy = 0, hard = 0, redo = 0;
+        int rc = sqlite3_exec(raw, "BEGIN IMMEDIATE;", NULL, NULL, NULL);
+        if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+            busy = 1;
+        } else if (rc != SQLITE_OK) {
+            hard = 1;
+        } else {
+            for (int i = 0; i < n && !busy && !redo; i++) {
+                if (failed[i]) continue;
+                int irc = insert_bound(w->conn, &recs[i]);
+                if (irc == PACKET_DB_INSERT_BUSY) busy = 1;
+                else if (irc != PACKET_DB_INSERT_OK) {
+                    failed[i] = 1;
+                    lost++;
+                    if (sqlite3_get_autocommit(raw)) redo = 1;  // txn gone
+                }
+            }
+            if (!busy && !redo) {
+                rc = sqlite3_exec(raw, "COMMIT;", NULL, NULL, NULL);
+                if (rc == SQLITE_OK) {
+                    double dt = mono_ms() - t0;
+                    uint64_t now_ns = lat_now_ns();
+                    for (int i = 0; i < n; i++)
+                        if (!failed[i]) lat_trace_mark_at(LAT_DB, recs[i].trace_t0_ns, now_ns);
+                    pthread_mutex_lock(&w->mu);
+                    w->st.commits++;
+                    w->st.rows_committed += n - lost;
+                    w->st.last_commit_ms = dt;
+                    if (dt > w->st.max_commit_ms) w->st.max_commit_ms = dt;
+                    pthread_mutex_unlock(&w->mu);
+                    return lost;
+                }
+                if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED) busy = 1;
+                else hard = 1;
+            }
+            (void) sqlite3_exec(raw, "ROLLBACK;", NULL, NULL, NULL);
+        }
+        if (hard) {
+            fprintf(stderr, "packet_db: writer transaction failed (%s); "
+                    "retrying its rows one by one\n", sqlite3_errmsg(raw));
+            return writer_commit_rows(w, n, &give_up_at);
+        }
+        if (busy && writer_busy_give_up(w, &give_up_at)) {
+            fprintf(stderr, "packet_db: writer gave up on %d queued "
+                    "row(s): write lock still held after %d s\n",
+                    n, PACKET_DB_WRITER_DRAIN_S);
+            return n;
+        }
+    }
+}
+
+static void *writer_thread_fn(void *arg)
+{
+    packet_db_writer_t *w = (packet_db_writer_t *)arg;
+    pthread_mutex_lock(&w->mu);
+    for (;;) {
+        while (w->count == 0 && !w->stop)
+            pthread_cond_wait(&w->not_empty, &w->mu);
+        if (w->count == 0 && w->stop) break;
+        // The oldest queued row waits at most group_ms for company before
+        // it is committed; a full group (or shutdown) goes straight away.
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec  += w->group_ms / 1000;
+        deadline.tv_nsec += (long)(w->group_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (w->count < w->group_rows && !w->stop) {
+            if (pthread_cond_timedwait(&w->not_empty, &w->mu, &deadline)
+                == ETIMEDOUT) break;
+        }
+        int n = w->count < w->group_rows ? w->count : w->group_rows;
+        for (int i = 0; i < n; i++) {
+            w->group[i] = w->ring[w->tail];
+            w->tail = (w->tail + 1) % w->cap;
+        }
+        w->count    -= n;
+        w->inflight  = n;
+        pthread_cond_broadcast(&w->not_full);
+        pthread_mutex_unlock(&w->mu);
+
+        long lost = writer_commit(w, n);
+        for (int i = 0; i < n; i++) free_record(&w->group[i]);
+
+        pthread_mutex_lock(&w->mu);
+        w->inflight = 0;
+        w->st.rows_failed += lost;
+    }
+    pthread_mutex_unlock(&w->mu);
+    return NULL;
+}
+
+static void writer_free(packet_db_writer_t *w)
+{
+    packet_db_close(w->conn);
+    free(w->failed);
+    free(w->group);
+    free(w->ring);
+    free(w);
+}
+
+int packet_db_start_writer(packet_db_t *db, int queue_cap,
+                           int group_rows, int group_ms)
+{
+    if (db == NULL || db->db == NULL) return -1;
+    if (db->writer != NULL) return 0;
+    // The writer needs its own connection to the same file; an in-memory
+    // or temp DB has no path another connection could open.
+    const char *path = sqlite3_db_filename(db->db, "main");
+    if (path == NULL || path[0] == '\0') return -1;
+
+    packet_db_writer_t *w = (packet_db_writer_t *)calloc(1, sizeof *w);
+    if (w == NULL) return -1;
+    w->cap        = queue_cap  > 0 ? queue_cap  : PACKET_DB_WRITER_QUEUE_CAP;
+    w->group_rows = group_rows > 0 ? group_rows : PACKET_DB_WRITER_GROUP_ROWS;
+    w->group_ms   = group_ms   > 0 ? group_ms   : PACKET_DB_WRITER_GROUP_MS;
+    if (w->group_rows > w->cap) w->group_rows = w->cap;
+    w->ring   = (packet_db_record_t *)calloc((size_t)w->cap, sizeof *w->ring);
+    w->group  = (packet_db_record_t *)calloc((size_t)w->group_rows,
+                                             sizeof *w->group);
+    w->failed = (unsigned char *)malloc((size_t)w->group_rows);
+    w->conn   = packet_db_open(path);
+    if (w->ring == NULL || w->group == NULL || w->failed == NULL
+        || w->conn == NULL) {
+        writer_free(w);
+        return -1;
+    }
+    // A short timeout keeps each BEGIN attempt inside one group window, so
+    // contention shows up in busy_retries instead of one silent 60 s wait.
+    sqlite3_busy_timeout(w->conn->db, w->group_ms);
+    w->st.active    = 1;
+    w->st.queue_cap = w->cap;
+    pthread_mutex_init(&w->mu, NULL);
+    pthread_cond_init(&w->not_empty, NULL);
+    pthread_cond_init(&w->not_full, NULL);
+    if (pthread_create(&w->thread, NULL, writer_thread_fn, w) != 0) {
+        pthread_cond_destroy(&w->not_full);
+        pthread_cond_destroy(&w->not_empty);
+        pthread_mutex_destroy(&w->mu);
+        writer_free(w);
+        return -1;
+    }
+    db->writer = w;
+    return 0;
+}
+
+long packet_db_stop_writer(packet_db_t *db)
+{
+    if (db == NULL || db->writer == NULL) return 0;
+    packet_db_writer_t *w = db->writer;
+    pthread_mutex_lock(&w->mu);
+    w->stop = 1;
+    pthread_cond_signal(&w->not_empty);
+    pthread_mutex_unlock(&w->mu);
+    pthread_join(w->thread, NULL);
+
+    db->writer_last = w->st;
+    db->writer_last.active      = 0;
+    db->writer_last.queue_depth = 0;
+    db->writer = NULL;
+    pthread_cond_destroy(&w->not_full);
+    pthread_cond_destroy(&w->not_empty);
+    pthread_mutex_destroy(&w->mu);
+    writer_free(w);
+    return db->writer_last.rows_failed;
+}
+
+void packet_db_writer_stats(packet_db_t *db, packet_db_writer_stats_t *out)
+{
+    if (out == NULL) return;
+    memset(out, 0, sizeof *out);
+    if (db == NULL) return;
+    packet_db_writer_t *w = db->writer;
+    if (w == NULL) {
+        *out = db->writer_last;
+        return;
+    }
+    pthread_mutex_lock(&w->mu);
+    *out = w->st;
+    out->queue_depth = (long)(w->count + w->inflight);
+    pthread_mutex_unlock(&w->mu);
+}
+
 int packet_db_insert_sent_tcmd(packet_db_t *db, const sent_tcmd_record_t *rec)
 {
     if (db == NULL || db->db == NULL || db->insert_sent_tcmd_stmt == NULL)
@@ -804,6 +1527,8 @@ int packet_db_insert_sent_tcmd(packet_db_t *db, const sent_tcmd_record_t *rec)
 void packet_db_close(packet_db_t *db)
 {
     if (db == NULL) return;
+    // Drain the async writer first so every queued row reaches the file.
+    (void) packet_db_stop_writer(db);
     // Drop any unflushed batch (caller forgot to flush, or a flush left it
     // empty — batch_clear is a no-op then).
     batch_clear(db);
@@ -814,6 +1539,12 @@ void packet_db_close(packet_db_t *db)
     if (db->register_tle_stmt     != NULL) sqlite3_finalize(db->register_tle_stmt);
     if (db->select_tle_id_stmt    != NULL) sqlite3_finalize(db->select_tle_id_stmt);
     if (db->insert_sent_tcmd_stmt != NULL) sqlite3_finalize(db->insert_sent_tcmd_stmt);
+    if (db->bulk_insert_stmt      != NULL) sqlite3_finalize(db->bulk_insert_stmt);
+    if (db->bulk_gaps_stmt        != NULL) sqlite3_finalize(db->bulk_gaps_stmt);
+    if (db->bulk_force_stmt       != NULL) sqlite3_finalize(db->bulk_force_stmt);
+    if (db->bulk_replay_ts_stmt   != NULL) sqlite3_finalize(db->bulk_replay_ts_stmt);
+    if (db->bulk_clear_stmt       != NULL) sqlite3_finalize(db->bulk_clear_stmt);
+    EVP_MD_CTX_free(db->sha_ctx);
     if (db->db != NULL) sqlite3_close(db->db);
     free(db);
 }
@@ -957,7 +1688,7 @@ int packet_db_update_replay_ts(packet_db_t *db,
     if (s == NULL) return -1;
 
     uint8_t sha[PACKET_DB_SHA1_LEN];
-    sha1_digest(payload, payload_len, sha);
+    sha1_digest(db->sha_ctx, payload, payload_len, sha);
 
     sqlite3_reset(s);
     sqlite3_clear_bindings(s);
@@ -988,7 +1719,7 @@ int packet_db_update_observer(packet_db_t *db,
     if (s == NULL) return -1;
 
     uint8_t sha[PACKET_DB_SHA1_LEN];
-    sha1_digest(payload, payload_len, sha);
+    sha1_digest(db->sha_ctx, payload, payload_len, sha);
 
     sqlite3_reset(s);
     sqlite3_clear_bindings(s);
@@ -1011,6 +1742,144 @@ int packet_db_update_observer(packet_db_t *db,
     return sqlite3_changes(db->db);
 }
 
+// One record's SHA1 plus its index in the caller's array, sorted so all
+// records for one payload sit together in call order.
+typedef struct {
+    uint8_t sha[PACKET_DB_SHA1_LEN];
+    size_t  idx;
+} bulk_key_t;
+
+static int cmp_bulk_key(const void *a, const void *b)
+{
+    const bulk_key_t *x = a, *y = b;
+    int c = memcmp(x->sha, y->sha, PACKET_DB_SHA1_LEN);
+    if (c != 0) return c;
+    return (x->idx > y->idx) - (x->idx < y->idx);
+}
+
+// Prepare the temp table and its statements on first use.
+static int bulk_prepare(packet_db_t *db)
+{
+    if (db->bulk_clear_stmt != NULL) return 0;
+    if (sqlite3_exec(db->db, BULK_CREATE_SQL, NULL, NULL, NULL) != SQLITE_OK)
+        return -1;
+    struct { const char *sql; sqlite3_stmt **out; } stmts[] = {
+        { BULK_INSERT_SQL,    &db->bulk_insert_stmt    },
+        { BULK_GAPS_SQL,      &db->bulk_gaps_stmt      },
+        { BULK_FORCE_SQL,     &db->bulk_force_stmt     },
+        { BULK_REPLAY_TS_SQL, &db->bulk_replay_ts_stmt },
+        { BULK_CLEAR_SQL,     &db->bulk_clear_stmt     },
+    };
+    for (size_t i = 0; i < sizeof stmts / sizeof stmts[0]; i++) {
+        if (sqlite3_prepare_v2(db->db, stmts[i].sql, -1, stmts[i].out, NULL)
+            != SQLITE_OK) {
+            fprintf(stderr, "packet_db: prepare '%s' failed: %s\n",
+                    stmts[i].sql, sqlite3_errmsg(db->db));
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Step a statement with no result rows; 0 on SQLITE_DONE.
+static int step_done(sqlite3_stmt *s)
+{
+    sqlite3_reset(s);
+    int rc = sqlite3_step(s);
+    sqlite3_reset(s);
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+int packet_db_update_observer_many(packet_db_t *db,
+                                   const packet_db_observer_update_t *recs,
+                                   size_t n, int force)
+{
+    if (db == NULL || db->db == NULL) return 0;
+    if (n == 0) return 0;
+    if (recs == NULL || bulk_prepare(db) != 0) return -1;
+
+    bulk_key_t *keys = malloc(n * sizeof *keys);
+    if (keys == NULL) return -1;
+    size_t nk = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (recs[i].payload == NULL) continue;
+        sha1_digest(db->sha_ctx, recs[i].payload, recs[i].payload_len,
+                    keys[nk].sha);
+        keys[nk++].idx = i;
+    }
+    qsort(keys, nk, sizeof *keys, cmp_bulk_key);
+
+    // BEGIN IMMEDIATE takes the write lock up front (waiting out the busy
+    // timeout) rather than failing mid-batch on the lock upgrade.
+    if (sqlite3_exec(db->db, "BEGIN IMMEDIATE", NULL, NULL, NULL) != SQLITE_OK) {
+        fprintf(stderr, "packet_db: update_observer_many: begin failed: %s\n",
+                sqlite3_errmsg(db->db));
+        free(keys);
+        return -1;
+    }
+    int ok = step_done(db->bulk_clear_stmt) == 0;
+
+    // Fold each payload's records into one staged row, the way repeated
+    // single calls would leave the packet row: in gaps mode each column
+    // keeps the first known value, in force mode the last record wins
+    // outright, and the timestamp rewrite always takes the last record
+    // that carries one.
+    sqlite3_stmt *ins = db->bulk_insert_stmt;
+    for (size_t g = 0; ok && g < nk; ) {
+        size_t e = g + 1;
+        while (e < nk && memcmp(keys[e].sha, keys[g].sha, PACKET_DB_SHA1_LEN) == 0)
+            e++;
+        double    v[5] = { NAN, NAN, NAN, NAN, NAN };
+        long long tle_id = 0;
+        const char *dir = NULL, *ts = NULL;
+        double aoff = NAN;
+        for (size_t k = g; k < e; k++) {
+            const packet_db_observer_update_t *r = &recs[keys[k].idx];
+            const double rv[5] = { r->az_deg, r->el_deg, r->range_km,
+                                   r->range_rate_km_s, r->doppler_hz_offset };
+            if (force) {
+                memcpy(v, rv, sizeof v);
+                tle_id = r->tle_id;
+                dir = r->session_dir;
+            } else {
+                for (int c = 0; c < 5; c++) if (isnan(v[c])) v[c] = rv[c];
+                if (tle_id <= 0) tle_id = r->tle_id;
+                if (dir == NULL) dir = r->session_dir;
+            }
+            if (r->ts_received != NULL) {
+                ts = r->ts_received;
+                aoff = r->audio_offset_s;
+            }
+        }
+        sqlite3_reset(ins);
+        sqlite3_clear_bindings(ins);
+        sqlite3_bind_blob(ins, 1, keys[g].sha, PACKET_DB_SHA1_LEN, SQLITE_STATIC);
+        for (int c = 0; c < 5; c++) bind_double_or_null(ins, 2 + c, v[c]);
+        if (tle_id > 0) sqlite3_bind_int64(ins, 7, tle_id);
+        bind_text_or_null(ins, 8, dir);
+        bind_text_or_null(ins, 9, ts);
+        bind_double_or_null(ins, 10, aoff);
+        ok = sqlite3_step(ins) == SQLITE_DONE;
+        g = e;
+    }
+    sqlite3_reset(ins);
+
+    int updated = 0;
+    if (ok) {
+        ok = step_done(force ? db->bulk_force_stmt : db->bulk_gaps_stmt) == 0;
+        updated = sqlite3_changes(db->db);
+    }
+    if (ok) ok = step_done(db->bulk_replay_ts_stmt) == 0;
+    if (ok) ok = step_done(db->bulk_clear_stmt) == 0;
+    if (!ok)
+        fprintf(stderr, "packet_db: update_observer_many failed: %s\n",
+                sqlite3_errmsg(db->db));
+    if (ok) ok = sqlite3_exec(db->db, "COMMIT", NULL, NULL, NULL) == SQLITE_OK;
+    if (!ok) (void) sqlite3_exec(db->db, "ROLLBACK", NULL, NULL, NULL);
+    free(keys);
+    return ok ? updated : -1;
+}
+
 #else // WITH_SQLITE3 not defined — stub mode
 
 struct packet_db { int unused; };
@@ -1085,6 +1954,33 @@ int packet_db_update_replay_ts(packet_db_t *db,
     return 0;
 }
 
+int packet_db_update_observer_many(packet_db_t *db,
+                                   const packet_db_observer_update_t *recs,
+                                   size_t n, int force)
+{
+    (void)db; (void)recs; (void)n; (void)force;
+    return 0;
+}
+
+int packet_db_start_writer(packet_db_t *db, int queue_cap,
+                           int group_rows, int group_ms)
+{
+    (void)db; (void)queue_cap; (void)group_rows; (void)group_ms;
+    return -1;
+}
+
+long packet_db_stop_writer(packet_db_t *db)
+{
+    (void)db;
+    return 0;
+}
+
+void packet_db_writer_stats(packet_db_t *db, packet_db_writer_stats_t *out)
+{
+    (void)db;
+    if (out != NULL) memset(out, 0, sizeof *out);
+}
+
 void packet_db_close(packet_db_t *db)
 {
     (void)db;
@@ -9,7 +9,11 @@
 
     The DB has one table, `packet`, with the raw payload bytes plus the
     pre-rendered firmware-interpreted body so LIKE queries against the
-    text work without a binary decode step.
+    text work without a binary decode step. Schema V5 adds `packet_fts`,
+    a trigram full-text index over the text columns that turns those
+    substring searches into index lookups (see packet_db_fts_match).
+    Schema V6 stores each tcmd_response's ts_sent as an indexed column
+    so a response joins to its command without decoding payloads.
 
     Default DB path: $SSO_PACKET_DB if set, else <root>/packet_db.sqlite
     where <root> is $FRONTIERSAT_ROOT if set, else /FrontierSat. Each
@@ -89,6 +93,9 @@ typedef struct {
     // unknown (legacy rows / no flag supplied). Distinct from
     // source_tool, which identifies the decoder.
     const char *capture_origin;
+    // lat_trace origin of the frame (0 = untraced). The row's commit
+    // marks LAT_DB against it; never stored.
+    uint64_t    trace_t0_ns;
 } packet_db_record_t;
 
 // One transmitted telecommand, recorded so a received tcmd_response can
@@ -146,8 +153,9 @@ int packet_db_insert(packet_db_t *db, const packet_db_record_t *rec);
 // Enabling batch mode does NOT hold the write lock — rows sit in process
 // memory until flush, so concurrent writers and a live capture run
 // unblocked during the (often multi-second) decode. Intended for the
-// offline/replay path; the live receiver leaves it off so each packet is
-// visible to readers as it arrives. Single inserting thread only.
+// offline/replay path; the live receiver uses the async writer below so
+// each packet is visible to readers within a group window of arriving.
+// Single inserting thread only.
 void packet_db_set_batch(packet_db_t *db, int enabled);
 
 // Flush all buffered rows (batch mode) in one transaction. Returns
@@ -166,6 +174,59 @@ int packet_db_flush(packet_db_t *db);
 // flush call). 0 in non-batch mode, after a flush, or with no DB.
 size_t packet_db_batch_pending(packet_db_t *db);
 
+// Asynchronous writer, for the live receiver. Once started,
+// packet_db_insert deep-copies the record into a bounded in-memory queue
+// and returns PACKET_DB_INSERT_OK immediately; a dedicated thread drains
+// the queue on its OWN connection in short group transactions (up to
+// group_rows rows, or whatever arrived within group_ms of the oldest
+// queued row). The RX worker therefore never waits on the SQLite write
+// lock — a packet_query or backfill holding it used to stall the pump for
+// up to the 60 s busy_timeout and overflow the SDR.
+//
+// Nothing is dropped: a full queue blocks the producer until the writer
+// catches up, a contended write lock is retried until it is won (during
+// packet_db_stop_writer's drain, for up to PACKET_DB_WRITER_DRAIN_S), and
+// a record that can't be copied (OOM) falls back to a synchronous insert.
+// The only other loss is a hard DB error (disk full, corrupt file); both
+// are tallied in rows_failed. Batch mode is ignored while the writer runs.
+//
+// queue_cap / group_rows / group_ms <= 0 select the PACKET_DB_WRITER_*
+// defaults. Returns 0 when the writer is running (or already was), -1 if
+// it couldn't be started; inserts then stay synchronous.
+#define PACKET_DB_WRITER_QUEUE_CAP  4096
+#define PACKET_DB_WRITER_GROUP_ROWS 64
+#define PACKET_DB_WRITER_GROUP_MS   200
+#define PACKET_DB_WRITER_DRAIN_S    60
+int packet_db_start_writer(packet_db_t *db, int queue_cap,
+                           int group_rows, int group_ms);
+
+// Drain the queue, join the writer thread and return to synchronous
+// inserts. Returns the number of rows that could not be stored (0 on a
+// clean drain). packet_db_close calls this, so an explicit stop is only
+// needed to read the final counters. Call it from the thread that
+// started the writer, once no other thread is inserting.
+long packet_db_stop_writer(packet_db_t *db);
+
+// Writer health counters, all cumulative since packet_db_start_writer
+// except the queue depth. All zero when no writer has been started.
+typedef struct {
+    int      active;           // 1 while the writer thread is running
+    long     queue_depth;      // rows queued, not yet committed
+    long     queue_max_depth;  // high-water mark of queue_depth
+    long     queue_cap;
+    long     producer_waits;   // inserts that blocked on a full queue
+    long     rows_committed;   // rows stored (or deduped) by the writer
+    long     rows_failed;      // rows lost to a hard DB error
+    long     commits;          // group transactions committed
+    long     busy_retries;     // BEGIN/COMMIT attempts that hit BUSY
+    double   last_commit_ms;   // wall time of the latest group transaction
+    double   max_commit_ms;
+} packet_db_writer_stats_t;
+
+// Copy the writer counters into *out. Safe from any thread while the
+// writer runs.
+void packet_db_writer_stats(packet_db_t *db, packet_db_writer_stats_t *out);
+
 // Insert one transmitted-telecommand row. Silently ignores duplicates
 // (same ts_sent_ms + source_run) so a repeated burst of the same command
 // in one pass records a single row. Returns 0 on success or silent dedup,
@@ -214,8 +275,94 @@ int packet_db_update_replay_ts(packet_db_t *db,
                                const char *ts_iso,
                                double audio_offset_s);
 
+// One row of a bulk backfill (packet_db_update_observer_many): the
+// arguments of packet_db_update_observer and, when ts_received is
+// non-NULL, of packet_db_update_replay_ts for the same payload.
+typedef struct {
+    const uint8_t *payload;
+    size_t         payload_len;
+    double         az_deg;
+    double         el_deg;
+    double         range_km;
+    double         range_rate_km_s;
+    double         doppler_hz_offset;
+    long long      tle_id;
+    const char    *session_dir;
+    const char    *ts_received;      // NULL: leave ts_received alone
+    double         audio_offset_s;
+} packet_db_observer_update_t;
+
+// Apply n backfills in ONE transaction: the rows land in a temp table
+// keyed by payload SHA1 and a single UPDATE ... FROM per kind joins it
+// against packet, so re-stamping an archive costs one write lock and one
+// index probe per payload instead of one statement (and one commit) per
+// row. Same effect as calling packet_db_update_observer(..., force) and
+// then packet_db_update_replay_ts on each record in order - several
+// records for one payload fold the way those repeated calls would (gaps:
+// first known value wins; force and timestamps: last wins). All or
+// nothing: returns the number of rows the observer update touched, or -1
+// on a DB error (busy included), in which case nothing was applied.
+int packet_db_update_observer_many(packet_db_t *db,
+                                   const packet_db_observer_update_t *recs,
+                                   size_t n, int force);
+
 void packet_db_close(packet_db_t *db);
 
+// The FTS5 trigram index over packet's text columns (schema V5), and a
+// probe for it. The index may be missing - a DB no writer has opened
+// since V5, or a sqlite without FTS5 - so a reader runs
+// PACKET_DB_SQL_HAS_FTS once and keeps its LIKE scan when it returns no
+// row.
+#define PACKET_DB_FTS_TABLE   "packet_fts"
+#define PACKET_DB_SQL_HAS_FTS \
+    "SELECT 1 FROM sqlite_master WHERE type='table' AND name='" PACKET_DB_FTS_TABLE "'"
+
+// The stored tcmd_response join key (schema V6): a tcmd_response row's
+// ts_sent decoded to unix-ms, NULL on every other row. packet_db_insert
+// fills it and the migration backfills older rows; the partial index
+// idx_packet_resp_ts (resp_ts_sent_ms, ts_received) makes "responses to
+// this command" an index range instead of a substr(payload,2,8) scan of
+// every tcmd_response, and matches sent_tcmd.ts_sent_ms (idx_sent_tcmd_ts)
+// index to index. A reader on a DB no writer has opened since V6 finds
+// no such column: probe with PACKET_DB_SQL_HAS_RESP_TS once and keep the
+// TCMD_RESP_SQL_TS_SENT blob match when it returns no row. Match on the
+// column alone: only response rows carry it, and adding TCMD_RESP_SQL_IS
+// steers the planner onto idx_packet_type, a scan of every response.
+#define PACKET_DB_RESP_TS_COL "resp_ts_sent_ms"
+#define PACKET_DB_SQL_HAS_RESP_TS \
+    "SELECT 1 FROM pragma_table_info('packet') WHERE name='" PACKET_DB_RESP_TS_COL "'"
+
+// Every tcmd_response fragment, grouped by ts_sent and then by arrival -
+// the walk gnss_reports, gnss_opm and mag_reports reassemble from. Bind
+// ?1 = TCMD_RESP_PACKET_TYPE, ?2 = minimum payload length. The V6 form
+// reads idx_packet_resp_ts in order, so there is no sort (the type is
+// implied by the key being set, leaving ?1 unused); the LEGACY form sorts
+// every response on its payload slice. A reader prepares the V6 form and
+// falls back to LEGACY when that fails. Needs tcmd_response.h.
+#define PACKET_DB_SQL_RESP_FRAGS \
+    "SELECT id, ts_received, payload FROM packet " \
+    "WHERE " PACKET_DB_RESP_TS_COL " IS NOT NULL AND length(payload) >= ?2 " \
+    "ORDER BY " PACKET_DB_RESP_TS_COL ", ts_received, id"
+#define PACKET_DB_SQL_RESP_FRAGS_LEGACY \
+    "SELECT id, ts_received, payload FROM packet " \
+    "WHERE packet_type=?1 AND length(payload) >= ?2 " \
+    "ORDER BY " TCMD_RESP_SQL_TS_SENT ", ts_received, id"
+
+// Build an FTS5 MATCH expression that pre-filters the rows a
+// `col LIKE like_pattern` can match: each literal run of 3+ characters
+// between the pattern's % / _ wildcards becomes a quoted phrase, ANDed
+// together, restricted to `columns` (a space-separated column list such
+// as "decoded_summary session_dir", or NULL for every indexed column).
+// Every row the LIKE matches also matches the expression, so
+//   ... WHERE id IN (SELECT rowid FROM packet_fts WHERE packet_fts MATCH ?)
+//             AND (<the original LIKE test>)
+// returns exactly the LIKE's rows while reading only the index hits.
+// Returns the number of phrases written to `out` (> 0: use it), 0 when no
+// run is long enough for a trigram lookup (keep the plain LIKE), or -1 if
+// `out` is too small.
+int packet_db_fts_match(const char *like_pattern, const char *columns,
+                        char *out, size_t cap);
+
 // Resolve the default DB path into `buf`. Order of preference:
 //   1. $SSO_PACKET_DB if set and non-empty.
 //   2. <root>/packet_db.sqlite, where <root> is $FRONTIERSAT_ROOT if
@@ -0,0 +1,272 @@
+/*
+
+   Simple Satellite Operations  channelizer.c
+
+   Parallel NCO + decimator branches over one wideband IQ stream. See
+   channelizer.h.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+
+#include "channelizer.h"
+#include "fir_decim.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    sw_nco_t        shift;       // carrier -> DC, at fs_in
+    fir_decim_iq_t *decim;
+    sw_nco_t        dop;         // Doppler, at fs_in / M
+    sw_nco_track_t *track;
+    int             track_live;
+    int16_t        *wide;        // shifted copy of the chunk, max_in pairs
+    int16_t        *out;         // decimated output, max_out pairs
+    size_t          n_out;
+} branch_t;
+
+struct channelizer {
+    double   fs_in;
+    double   fs_out;
+    unsigned M;
+    double   fc_hz;
+    unsigned ntaps;
+    size_t   max_in;
+    size_t   max_out;
+    branch_t br[CHANNELIZER_MAX];
+    int      n;
+
+    // The chunk in flight and the claim state, all under mu. next is the
+    // first unclaimed branch, pending the branches not finished yet.
+    pthread_mutex_t mu;
+    pthread_cond_t  go;
+    pthread_cond_t  done;
+    const int16_t  *in;
+    size_t          n_in;
+    double          t0_s;
+    int             clock_valid;
+    int             next;
+    int             pending;
+    uint64_t        gen;
+    int             stop;
+
+    pthread_t threads[CHANNELIZER_MAX];
+    unsigned  n_threads;
+    unsigned  max_threads;
+};
+
+static void branch_run(channelizer_t *ch, branch_t *b, const int16_t *in,
+                       size_t n_in, double t0_s, int clock_valid)
+{
+    memcpy(b->wide, in, n_in * 2 * sizeof(int16_t));
+    sw_nco_apply(&b->shift, b->wide, n_in);
+    b->n_out = fir_decim_iq_push(b->decim, b->wide, n_in, b->out, ch->max_out);
+
+    // Same ramp as the core's primary Doppler step: the trajectory at
+    // the chunk's two edges, linear in between.
+    int live = 0;
+    if (b->track != NULL && clock_valid) {
+        double t1 = t0_s + (double) n_in / ch->fs_in;
+        double f0, f1;
+        if (sw_nco_track_eval(b->track, t0_s, &f0) == 0
+            && sw_nco_track_eval(b->track, t1, &f1) == 0) {
+            sw_nco_set_freq(&b->dop, f0);
+            sw_nco_apply_ramp(&b->dop, b->out, b->n_out, f1);
+            live = 1;
+        }
+    }
+    if (!live) sw_nco_apply(&b->dop, b->out, b->n_out);
+    b->track_live = live;
+}
+
+// Claim and run branches of the current chunk until none are left.
+// Called with mu held; returns with it held.
+static void claim_locked(channelizer_t *ch)
+{
+    while (ch->next < ch->n) {
+        int i = ch->next++;
+        const int16_t *in = ch->in;
+        size_t n_in = ch->n_in;
+        double t0 = ch->t0_s;
+        int valid = ch->clock_valid;
+        pthread_mutex_unlock(&ch->mu);
+        branch_run(ch, &ch->br[i], in, n_in, t0, valid);
+        pthread_mutex_lock(&ch->mu);
+        if (--ch->pending == 0) pthread_cond_signal(&ch->done);
+    }
+}
+
+static void *worker_fn(void *arg)
+{
+    channelizer_t *ch = arg;
+    pthread_mutex_lock(&ch->mu);
+    uint64_t seen = ch->gen;
+    for (;;) {
+        while (!ch->stop && ch->gen == seen) pthread_cond_wait(&ch->go, &ch->mu);
+        if (ch->stop) break;
+        seen = ch->gen;
+        claim_locked(ch);
+    }
+    pthread_mutex_unlock(&ch->mu);
+    return NULL;
+}
+
+channelizer_t *channelizer_new(double fs_in_hz, unsigned M, double fc_hz,
+                               unsigned ntaps, size_t max_in_pairs,
+                               unsigned max_threads)
+{
+    if (!(fs_in_hz > 0.0) || M < 2u || ntaps == 0 || max_in_pairs == 0) return NULL;
+    if (!(fc_hz > 0.0) || fc_hz >= fs_in_hz / 2.0) return NULL;
+    channelizer_t *ch = calloc(1, sizeof *ch);
+    if (ch == NULL) return NULL;
+    ch->fs_in   = fs_in_hz;
+    ch->fs_out  = fs_in_hz / (double) M;
+    ch->M       = M;
+    ch->fc_hz   = fc_hz;
+    ch->ntaps   = ntaps;
+    ch->max_in  = max_in_pairs;
+    ch->max_out = max_in_pairs / M + 1u;
+    ch->max_threads = max_threads < CHANNELIZER_MAX ? max_threads : CHANNELIZER_MAX;
+    pthread_mutex_init(&ch->mu, NULL);
+    pthread_cond_init(&ch->go, NULL);
+    pthread_cond_init(&ch->done, NULL);
+    return ch;
+}
+
+void channelizer_free(channelizer_t *ch)
+{
+    if (ch == NULL) return;
+    pthread_mutex_lock(&ch->mu);
+    ch->stop = 1;
+    pthread_cond_broadcast(&ch->go);
+    pthread_mutex_unlock(&ch->mu);
+    for (unsigned t = 0; t < ch->n_threads; t++) pthread_join(ch->threads[t], NULL);
+    for (int i = 0; i < ch->n; i++) {
+        fir_decim_iq_free(ch->br[i].decim);
+        sw_nco_track_free(ch->br[i].track);
+        free(ch->br[i].wide);
+        free(ch->br[i].out);
+    }
+    pthread_cond_destroy(&ch->done);
+    pthread_cond_destroy(&ch->go);
+    pthread_mutex_destroy(&ch->mu);
+    free(ch);
+}
+
+int channelizer_add(channelizer_t *ch, double shift_hz)
+{
+    if (ch == NULL || ch->n >= CHANNELIZER_MAX) return -1;
+    // The whole output band has to sit inside the capture, or its edge
+    // would alias back in from the far side.
+    if (!(fabs(shift_hz) + ch->fs_out / 2.0 <= ch->fs_in / 2.0)) return -1;
+    branch_t *b = &ch->br[ch->n];
+    memset(b, 0, sizeof *b);
+    b->decim = fir_decim_iq_new(ch->fs_in, ch->fc_hz, ch->ntaps, ch->M);
+    b->wide  = malloc(ch->max_in * 2 * sizeof(int16_t));
+    b->out   = malloc(ch->max_out * 2 * sizeof(int16_t));
+    if (b->decim == NULL || b->wide == NULL || b->out == NULL) {
+        fir_decim_iq_free(b->decim);
+        free(b->wide);
+        free(b->out);
+        memset(b, 0, sizeof *b);
+        return -1;
+    }
+    sw_nco_init(&b->shift, ch->fs_in);
+    sw_nco_set_freq(&b->shift, shift_hz);
+    sw_nco_init(&b->dop, ch->fs_out);
+    int idx = ch->n++;
+    // One worker per branch up to the cap; a failed start only means
+    // the caller's wait does more of the work.
+    if (ch->n_threads < ch->max_threads && ch->n_threads < (unsigned) ch->n) {
+        if (pthread_create(&ch->threads[ch->n_threads], NULL, worker_fn, ch) == 0)
+            ch->n_threads++;
+    }
+    return idx;
+}
+
+int channelizer_count(const channelizer_t *ch)
+{
+    return ch ? ch->n : 0;
+}
+
+double channelizer_out_rate(const channelizer_t *ch)
+{
+    return ch ? ch->fs_out : 0.0;
+}
+
+void channelizer_set_shift(channelizer_t *ch, int idx, double shift_hz)
+{
+    if (ch == NULL || idx < 0 || idx >= ch->n) return;
+    sw_nco_set_freq(&ch->br[idx].shift, shift_hz);
+}
+
+void channelizer_set_doppler(channelizer_t *ch, int idx, double offset_hz)
+{
+    if (ch == NULL || idx < 0 || idx >= ch->n) return;
+    sw_nco_set_freq(&ch->br[idx].dop, offset_hz);
+}
+
+void channelizer_set_track(channelizer_t *ch, int idx, sw_nco_track_t *track)
+{
+    if (ch == NULL || idx < 0 || idx >= ch->n) {
+        sw_nco_track_free(track);
+        return;
+    }
+    sw_nco_track_free(ch->br[idx].track);
+    ch->br[idx].track = track;
+    if (track == NULL) ch->br[idx].track_live = 0;
+}
+
+int channelizer_track_live(const channelizer_t *ch, int idx)
+{
+    if (ch == NULL || idx < 0 || idx >= ch->n) return 0;
+    return ch->br[idx].track_live;
+}
+
+void channelizer_start(channelizer_t *ch, const int16_t *iq_in, size_t n_in,
+                       double t0_s, int clock_valid)
+{
+    if (ch == NULL) return;
+    if (n_in > ch->max_in) n_in = ch->max_in;
+    pthread_mutex_lock(&ch->mu);
+    ch->in          = iq_in;
+    ch->n_in        = iq_in != NULL ? n_in : 0;
+    ch->t0_s        = t0_s;
+    ch->clock_valid = clock_valid;
+    ch->next        = 0;
+    ch->pending     = ch->n;
+    ch->gen++;
+    if (ch->n_threads > 0) pthread_cond_broadcast(&ch->go);
+    pthread_mutex_unlock(&ch->mu);
+}
+
+void channelizer_wait(channelizer_t *ch)
+{
+    if (ch == NULL) return;
+    pthread_mutex_lock(&ch->mu);
+    claim_locked(ch);
+    while (ch->pending > 0) pthread_cond_wait(&ch->done, &ch->mu);
+    pthread_mutex_unlock(&ch->mu);
+}
+
+void channelizer_push(channelizer_t *ch, const int16_t *iq_in, size_t n_in,
+                      double t0_s, int clock_valid)
+{
+    channelizer_start(ch, iq_in, n_in, t0_s, clock_valid);
+    channelizer_wait(ch);
+}
+
+const int16_t *channelizer_out(const channelizer_t *ch, int idx, size_t *n_pairs)
+{
+    if (n_pairs != NULL) *n_pairs = 0;
+    if (ch == NULL || idx < 0 || idx >= ch->n) return NULL;
+    if (n_pairs != NULL) *n_pairs = ch->br[idx].n_out;
+    return ch->br[idx].out;
+}
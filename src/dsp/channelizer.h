@@ -0,0 +1,116 @@
+/*
+
+   Simple Satellite Operations  channelizer.h
+
+   Extra receive channels carved out of one wideband IQ stream. The B210
+   captures 480 kS/s around its LO but the RX chain decimates straight
+   down to the one carrier it is tuned to, so a second satellite passing
+   inside the same capture bandwidth was thrown away by the FIR. Each
+   branch here re-reads the shared wideband chunk and runs its own
+
+     shift NCO      rotates the branch's carrier from shift_hz to DC, at
+                    the wideband rate
+     FIR decimator  the same design as the primary chain's, down to the
+                    post-decim rate
+     Doppler NCO    a fixed offset, or a whole-pass trajectory ramped
+                    across each chunk exactly like the core's own
+                    (sw_nco_apply_ramp), at the post-decim rate
+
+   so its output has the same shape as the primary decode tap: sc16 IQ,
+   carrier at DC, at fs_in / M.
+
+   N parallel NCO + decimator branches rather than a polyphase bank: we
+   want two to four channels at arbitrary offsets, not a uniform grid,
+   and each branch reuses the tested sw_nco / fir_decim pieces.
+
+   Branches run on a small pool of worker threads. channelizer_start
+   hands a chunk to the pool and returns, so the caller can run the
+   primary chain on the same chunk meanwhile; channelizer_wait then
+   works through any branch no worker has claimed yet and blocks until
+   all are done. With no worker threads (one CPU) wait runs every branch
+   itself. The input buffer must stay untouched between the two calls.
+
+   Not thread-safe beyond that: one thread (the RX pump) drives a
+   channelizer.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHANNELIZER_H
+#define CHANNELIZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw_nco.h"
+
+#define CHANNELIZER_MAX 8
+
+typedef struct channelizer channelizer_t;
+
+// fs_in_hz / M / fc_hz / ntaps: the branch decimator, as for
+// fir_decim_iq_new (M >= 2). max_in_pairs bounds one chunk. max_threads
+// caps the worker pool; workers are started as branches are added, one
+// per branch up to the cap, and 0 keeps everything on the caller.
+// NULL on bad parameters or OOM.
+channelizer_t *channelizer_new(double fs_in_hz, unsigned M, double fc_hz,
+                               unsigned ntaps, size_t max_in_pairs,
+                               unsigned max_threads);
+
+// Stops and joins the workers. NULL is a no-op.
+void channelizer_free(channelizer_t *ch);
+
+// Add a branch for the carrier at shift_hz in the wideband baseband.
+// Returns its index, or -1 when the table is full, the carrier plus the
+// branch's output band would fall off the wideband edge, or on OOM.
+int channelizer_add(channelizer_t *ch, double shift_hz);
+
+int    channelizer_count(const channelizer_t *ch);
+double channelizer_out_rate(const channelizer_t *ch);
+
+// Move a branch's carrier (e.g. the primary chain's LO compensation
+// changed underneath it). Phase-continuous, like sw_nco_set_freq.
+void channelizer_set_shift(channelizer_t *ch, int idx, double shift_hz);
+
+// Doppler correction for one branch: offset_hz applies whenever the
+// trajectory doesn't cover the chunk. The branch takes ownership of
+// `track` and frees the previous one; NULL removes it.
+void channelizer_set_doppler(channelizer_t *ch, int idx, double offset_hz);
+void channelizer_set_track(channelizer_t *ch, int idx, sw_nco_track_t *track);
+// 1 while the branch's last chunk was corrected from its trajectory.
+int  channelizer_track_live(const channelizer_t *ch, int idx);
+
+// Run every branch over n_in wideband pairs. t0_s is the time of the
+// chunk's first sample on the trajectories' clock; clock_valid 0 means
+// there is no clock yet and the fixed offsets apply. start returns as
+// soon as the pool has the chunk; wait finishes it. Every start needs
+// its wait before the next start, before iq_in changes and before
+// reading any output.
+void channelizer_start(channelizer_t *ch, const int16_t *iq_in, size_t n_in,
+                       double t0_s, int clock_valid);
+void channelizer_wait(channelizer_t *ch);
+
+// Start + wait.
+void channelizer_push(channelizer_t *ch, const int16_t *iq_in, size_t n_in,
+                      double t0_s, int clock_valid);
+
+// A branch's output from the last completed chunk: sc16 interleaved,
+// carrier at DC, *n_pairs pairs at channelizer_out_rate. Valid until
+// the next start.
+const int16_t *channelizer_out(const channelizer_t *ch, int idx,
+                               size_t *n_pairs);
+
+#endif // CHANNELIZER_H
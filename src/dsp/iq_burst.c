@@ -46,6 +46,8 @@ struct iq_burst {
     int           last_bright_bins;
     double        last_peak_excess_db;
     unsigned long frame_count;
+    // Largest bright_bins since the last iq_burst_take_peak_bins.
+    int           peak_bright_bins;
 };
 
 static int is_pow2(unsigned n)
@@ -195,6 +197,7 @@ static void process_frame(iq_burst_t *b)
     }
     b->last_bright_bins    = bright;
     b->last_peak_excess_db = (double) peak_excess;
+    if (bright > b->peak_bright_bins) b->peak_bright_bins = bright;
     b->frame_count++;
 }
 
@@ -228,6 +231,14 @@ double iq_burst_peak_excess_db(const iq_burst_t *b)
     return b ? b->last_peak_excess_db : -INFINITY;
 }
 
+int iq_burst_take_peak_bins(iq_burst_t *b)
+{
+    if (!b) return 0;
+    int peak = b->peak_bright_bins;
+    b->peak_bright_bins = 0;
+    return peak;
+}
+
 unsigned long iq_burst_frame_count(const iq_burst_t *b)
 {
     return b ? b->frame_count : 0;
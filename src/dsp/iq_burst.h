@@ -71,6 +71,13 @@ int iq_burst_bright_bins(const iq_burst_t *b);
 // completed frame. -INFINITY when no frame has completed yet.
 double iq_burst_peak_excess_db(const iq_burst_t *b);
 
+// Largest bright_bins of any frame completed since the previous call
+// (or since init), then starts over. A push spans many FFT frames, and
+// the last one alone can miss a short packet; the burst gate in front
+// of the demod chains reads this once per push. Same thread as the
+// pushes.
+int iq_burst_take_peak_bins(iq_burst_t *b);
+
 // Number of FFT frames processed since init. Useful for testing.
 unsigned long iq_burst_frame_count(const iq_burst_t *b);
 
@@ -75,17 +75,22 @@ static double fsk_iq_lpf_cutoff_hz(double param_hz)
     if (param_hz > 0.0)
         return (param_hz >= 1000.0 && param_hz <= 22000.0) ? param_hz : 12000.0;
 
+    // Atomic so rx_replay's segment threads can race on the first
+    // lookup; they all compute the same value.
     static double env_cached = -1.0;
-    if (env_cached < 0.0) {
+    double hz;
+    __atomic_load(&env_cached, &hz, __ATOMIC_RELAXED);
+    if (hz < 0.0) {
         const char *env = getenv("FSK_IQ_LPF_HZ");
         if (env != NULL && *env != '\0') {
-            env_cached = atof(env);
-            if (env_cached < 1000.0 || env_cached > 22000.0) env_cached = 12000.0;
+            hz = atof(env);
+            if (hz < 1000.0 || hz > 22000.0) hz = 12000.0;
         } else {
-            env_cached = 12000.0;
+            hz = 12000.0;
         }
+        __atomic_store(&env_cached, &hz, __ATOMIC_RELAXED);
     }
-    return env_cached;
+    return hz;
 }
 
 
@@ -13,6 +13,8 @@
 #include "sw_nco.h"
 
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -37,6 +39,36 @@ double sw_nco_get_freq(const sw_nco_t *nco)
     return nco ? nco->freq_hz : 0.0;
 }
 
+// Rotate one sample by `phase`, saturating to int16 — the rotated
+// magnitude equals the input magnitude exactly, but rounding can push a
+// full-scale sample ±1 past the int16 limit.
+static inline void rotate_sample(int16_t *iq, double phase)
+{
+    double cp = cos(phase);
+    double sp = sin(phase);
+    double I = (double) iq[0];
+    double Q = (double) iq[1];
+    double rotI = I * cp - Q * sp;
+    double rotQ = I * sp + Q * cp;
+    if (rotI >  32767.0) rotI =  32767.0;
+    else if (rotI < -32768.0) rotI = -32768.0;
+    if (rotQ >  32767.0) rotQ =  32767.0;
+    else if (rotQ < -32768.0) rotQ = -32768.0;
+    iq[0] = (int16_t) rotI;
+    iq[1] = (int16_t) rotQ;
+}
+
+// Wrap once per chunk; cumulative drift over a 10-minute pass at
+// 96 kSPS is ~5.8e7 samples × 2π × |f|/fs, which would otherwise
+// grow into ~1e6 radians and start to lose precision.
+static double wrap_phase(double phase)
+{
+    phase = fmod(phase, 2.0 * M_PI);
+    if (phase >  M_PI) phase -= 2.0 * M_PI;
+    if (phase < -M_PI) phase += 2.0 * M_PI;
+    return phase;
+}
+
 void sw_nco_apply(sw_nco_t *nco, int16_t *iq_inout, size_t n_pairs)
 {
     if (nco == NULL || iq_inout == NULL || n_pairs == 0) return;
@@ -54,28 +86,71 @@ void sw_nco_apply(sw_nco_t *nco, int16_t *iq_inout, size_t n_pairs)
     // and sw_nco_selftest both rely on. Evaluating per sample makes each
     // output a pure function of its absolute phase, independent of chunking.
     for (size_t i = 0; i < n_pairs; ++i) {
-        double cp = cos(phase);
-        double sp = sin(phase);
-        double I = (double) iq_inout[i * 2 + 0];
-        double Q = (double) iq_inout[i * 2 + 1];
-        double rotI = I * cp - Q * sp;
-        double rotQ = I * sp + Q * cp;
-        // Saturate to int16 — the rotated magnitude equals the input
-        // magnitude exactly, but rounding can push a full-scale sample
-        // ±1 past the int16 limit.
-        if (rotI >  32767.0) rotI =  32767.0;
-        else if (rotI < -32768.0) rotI = -32768.0;
-        if (rotQ >  32767.0) rotQ =  32767.0;
-        else if (rotQ < -32768.0) rotQ = -32768.0;
-        iq_inout[i * 2 + 0] = (int16_t) rotI;
-        iq_inout[i * 2 + 1] = (int16_t) rotQ;
+        rotate_sample(&iq_inout[i * 2], phase);
         phase += dphi;
     }
-    // Wrap once per chunk; cumulative drift over a 10-minute pass at
-    // 96 kSPS is ~5.8e7 samples × 2π × |f|/fs, which would otherwise
-    // grow into ~1e6 radians and start to lose precision.
-    phase = fmod(phase, 2.0 * M_PI);
-    if (phase >  M_PI) phase -= 2.0 * M_PI;
-    if (phase < -M_PI) phase += 2.0 * M_PI;
+    phase = wrap_phase(phase);
     nco->phase_rad = phase;
 }
+
+void sw_nco_apply_ramp(sw_nco_t *nco, int16_t *iq_inout, size_t n_pairs,
+                       double f_end_hz)
+{
+    if (nco == NULL) return;
+    const double f0 = nco->freq_hz;
+    nco->freq_hz = f_end_hz;
+    if (iq_inout == NULL || n_pairs == 0) return;
+    if (nco->sample_rate_hz <= 0.0) return;
+    if (f0 == 0.0 && f_end_hz == 0.0) return;  // pass-through fast path
+
+    // Per-sample increment grows linearly from f0 to f_end across the
+    // chunk: dphi_i = -2π (f0 + i·df) / fs.
+    const double k     = -2.0 * M_PI / nco->sample_rate_hz;
+    const double dphi0 = k * f0;
+    const double ddphi = k * (f_end_hz - f0) / (double) n_pairs;
+    double phase = nco->phase_rad;
+    for (size_t i = 0; i < n_pairs; ++i) {
+        rotate_sample(&iq_inout[i * 2], phase);
+        phase += dphi0 + ddphi * (double) i;
+    }
+    nco->phase_rad = wrap_phase(phase);
+}
+
+sw_nco_track_t *sw_nco_track_new(double t0_s, double step_s,
+                                 const double *offset_hz, size_t n)
+{
+    if (offset_hz == NULL || n < 2 || !(step_s > 0.0)) return NULL;
+    sw_nco_track_t *t = calloc(1, sizeof *t);
+    if (t == NULL) return NULL;
+    t->offset_hz = malloc(n * sizeof *t->offset_hz);
+    if (t->offset_hz == NULL) {
+        free(t);
+        return NULL;
+    }
+    memcpy(t->offset_hz, offset_hz, n * sizeof *t->offset_hz);
+    t->t0_s   = t0_s;
+    t->step_s = step_s;
+    t->n      = n;
+    return t;
+}
+
+void sw_nco_track_free(sw_nco_track_t *track)
+{
+    if (track == NULL) return;
+    free(track->offset_hz);
+    free(track);
+}
+
+int sw_nco_track_eval(const sw_nco_track_t *track, double t_s,
+                      double *freq_hz)
+{
+    if (track == NULL || track->n < 2) return -1;
+    double x = (t_s - track->t0_s) / track->step_s;
+    if (!(x >= 0.0) || x > (double) (track->n - 1)) return -1;
+    size_t i = (size_t) x;
+    if (i > track->n - 2) i = track->n - 2;
+    double frac = x - (double) i;
+    if (freq_hz) *freq_hz = track->offset_hz[i]
+                          + (track->offset_hz[i + 1] - track->offset_hz[i]) * frac;
+    return 0;
+}
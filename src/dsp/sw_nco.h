@@ -58,6 +58,37 @@ double sw_nco_get_freq(const sw_nco_t *nco);
 // ±32767). Safe to call with n_pairs == 0.
 void   sw_nco_apply(sw_nco_t *nco, int16_t *iq_inout, size_t n_pairs);
 
+// Same as sw_nco_apply, but the rotation frequency moves linearly from
+// the NCO's current freq_hz (sample 0) towards f_end_hz across the
+// chunk, and freq_hz is left at f_end_hz — i.e. a linear chirp. Feeding
+// consecutive chunks with the trajectory value at each chunk boundary
+// gives a piecewise-linear, phase-continuous frequency track with no
+// steps. Unlike sw_nco_apply the output is only chunking-independent
+// to within floating-point rounding of the ramp.
+void   sw_nco_apply_ramp(sw_nco_t *nco, int16_t *iq_inout, size_t n_pairs,
+                         double f_end_hz);
+
+// Time-stamped NCO frequency trajectory: offset_hz[i] is the rotation
+// frequency at t0_s + i * step_s (any consistent clock; the RX path uses
+// UNIX seconds). Supplied once per pass so the sample pump can evaluate
+// the Doppler correction from its own sample clock.
+typedef struct {
+    double  t0_s;
+    double  step_s;
+    size_t  n;
+    double *offset_hz;
+} sw_nco_track_t;
+
+// Copy `n` (>= 2) samples into a new trajectory. NULL on bad args / OOM.
+sw_nco_track_t *sw_nco_track_new(double t0_s, double step_s,
+                                 const double *offset_hz, size_t n);
+void            sw_nco_track_free(sw_nco_track_t *track);
+
+// Linear interpolation at t_s. Returns 0 and writes *freq_hz when t_s
+// lies inside the trajectory, -1 outside it (caller keeps its own freq).
+int             sw_nco_track_eval(const sw_nco_track_t *track, double t_s,
+                                  double *freq_hz);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,8 +5,9 @@
    Device-agnostic RX/TX chain. Pulls raw IQ from a pluggable SDR
    backend (src/hw/sdr_backend.h) and runs the shared DSP: optional FIR
    decimation, software Doppler NCO, a carrier-to-DC NCO, an atan2 FM
-   discriminator, an IQ level meter, and a broadband-burst detector. TX
-   bursts are delegated to the backend (RX-only backends have none).
+   discriminator, an IQ level meter, a broadband-burst detector, and any
+   extra receive channels cut from the same wideband read. TX bursts are
+   delegated to the backend (RX-only backends have none).
 
    The UHD-specific device I/O that used to live here now lives in
    src/hw/sdr_uhd.c; this file keeps its name and public API so callers
@@ -25,7 +26,9 @@
 */
 
 #include "b210_rx_tx_core.h"
+#include "channelizer.h"
 #include "sdr_backend.h"
+#include "sdr_capture.h"
 #include "fir_decim.h"
 #include "fm_demod.h"
 #include "iq_burst.h"
@@ -35,10 +38,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 struct b210_rx_tx_core {
     sdr_backend_t          *backend;         // device I/O (UHD, RTL-SDR, ...)
 
+    // Capture thread + sample ring between the backend and the pump, once
+    // b210_rx_tx_core_start_capture has run; NULL => the pump reads the
+    // backend itself. stream_next_s is the host time of the sample after
+    // the last one pumped, from the ring's stamps.
+    sdr_capture_t          *capture;
+    double                  stream_next_s;
+    int                     stream_time_valid;
+
     // Raw-IQ input buffer (the backend's read_iq fills this).
     int16_t                *iq_chunk;        // sc16 interleaved, max_iq_in pairs
     size_t                  max_iq_in;       // backend's max IQ pairs per read
@@ -81,11 +93,31 @@ struct b210_rx_tx_core {
     double                  tune_residual_hz;      // target − actual, per retune
     double                  carrier_trim_hz;       // per-host TCXO calibration
 
+    // Pump-owned Doppler trajectory + the post-decim sample clock it is
+    // evaluated on: sample k is at dop_clock_t0_s + (k - dop_clock_k0) /
+    // actual_rate. See b210_rx_tx_core_set_doppler_track.
+    sw_nco_track_t         *dop_track;
+    uint64_t                dop_samples;
+    uint64_t                dop_clock_k0;
+    double                  dop_clock_t0_s;
+    int                     dop_clock_valid;
+    int                     dop_track_live;
+
     // Broadband-burst detector — FFTs the post-NCO IQ and counts bright
     // bins. Narrowband ⇒ few; wideband ⇒ many.
     struct iq_burst        *iq_burst_det;
     int                     last_burst_bright_bins;
+    int                     pump_burst_peak_bins;   // -1: no detector
     double                  last_burst_peak_excess_db;
+
+    // Extra receive channels off the same wideband read (channelizer.h),
+    // built on the first add_channel with the primary decimator's design.
+    // chan_offset_hz[i] is channel i's carrier minus the primary's; the
+    // branch shift adds the fm_lo_nco rotation so both land at DC together.
+    channelizer_t          *chan;
+    double                  chan_offset_hz[CHANNELIZER_MAX];
+    double                  decim_fc_hz;
+    unsigned                decim_taps;
 };
 
 // Recompute the fm_lo_nco rotation from the current operator offset
@@ -99,6 +131,9 @@ static void refresh_fm_lo_nco(b210_rx_tx_core_t *c)
     double f = -c->fm_lo_compensation_hz + c->tune_residual_hz + c->carrier_trim_hz;
     sw_nco_set_freq(&c->fm_lo_nco, f);
     c->fm_lo_nco_active = (f != 0.0);
+    for (int i = 0; i < channelizer_count(c->chan); i++) {
+        channelizer_set_shift(c->chan, i, c->chan_offset_hz[i] + f);
+    }
 }
 
 int b210_rx_tx_core_open(const b210_rx_tx_core_params_t *p, b210_rx_tx_core_t **out)
@@ -142,6 +177,9 @@ int b210_rx_tx_core_open(const b210_rx_tx_core_params_t *p, b210_rx_tx_core_t **
         .uhd_args_override   = p->uhd_args_override,
         .fpga_image_path     = p->fpga_image_path,
         .device_index        = p->device_index,
+        .rtl_xfers           = p->rtl_xfers,
+        .rtl_xfer_bytes      = p->rtl_xfer_bytes,
+        .replay              = p->replay,
     };
     if (sdr_backend_open(p->backend_type, &sp, &c->backend) != 0) goto fail;
 
@@ -183,6 +221,7 @@ int b210_rx_tx_core_open(const b210_rx_tx_core_params_t *p, b210_rx_tx_core_t **
                 "ribbon will not report broadband-burst counts.\n");
     }
     c->last_burst_bright_bins    = 0;
+    c->pump_burst_peak_bins      = -1;
     c->last_burst_peak_excess_db = 0.0;
 
     // Initial tune residual: the backend tuned to p->freq_hz in open;
@@ -208,6 +247,8 @@ int b210_rx_tx_core_open(const b210_rx_tx_core_params_t *p, b210_rx_tx_core_t **
             ? p->decim_cutoff_hz
             : 0.4 * c->actual_rate;
         c->decim = fir_decim_iq_new(c->input_rate, fc_hz, decim_taps, decim_M);
+        c->decim_fc_hz = fc_hz;
+        c->decim_taps  = decim_taps;
         if (c->decim == NULL) {
             fprintf(stderr, "b210_rx_tx_core: failed to build IQ decimator "
                             "(fs=%.0f fc=%.0f taps=%u M=%u)\n",
@@ -241,15 +282,46 @@ fail:
 void b210_rx_tx_core_close(b210_rx_tx_core_t *c)
 {
     if (c == NULL) return;
+    sdr_capture_stop(c->capture);   // before the backend it reads from
     if (c->backend != NULL) sdr_backend_close(c->backend);
+    channelizer_free(c->chan);
     if (c->decim   != NULL) fir_decim_iq_free(c->decim);
     if (c->iq_burst_det != NULL) iq_burst_free(c->iq_burst_det);
+    sw_nco_track_free(c->dop_track);
     free(c->iq_chunk);
     free(c->iq_decim);
     free(c->iq_for_decode);
     free(c);
 }
 
+// How long one pump waits on an empty capture ring: the same bound UHD's
+// own recv timeout puts on a direct read.
+#define CAPTURE_WAIT_S 1.0
+
+int b210_rx_tx_core_start_capture(b210_rx_tx_core_t *c, double ring_s)
+{
+    if (c == NULL) return -1;
+    if (c->capture != NULL) return 0;
+    if (sdr_backend_caps(c->backend)->unpaced) return 0;
+    c->capture = sdr_capture_start(c->backend, c->input_rate, ring_s, c->max_iq_in);
+    return c->capture != NULL ? 0 : -1;
+}
+
+int b210_rx_tx_core_capture_stats(const b210_rx_tx_core_t *c, sdr_capture_stats_t *out)
+{
+    if (out != NULL) memset(out, 0, sizeof *out);
+    if (c == NULL || c->capture == NULL) return -1;
+    sdr_capture_stats(c->capture, out);
+    return 0;
+}
+
+int b210_rx_tx_core_stream_time(const b210_rx_tx_core_t *c, double *t_unix_s)
+{
+    if (c == NULL || !c->stream_time_valid) return -1;
+    if (t_unix_s != NULL) *t_unix_s = c->stream_next_s;
+    return 0;
+}
+
 ssize_t b210_rx_tx_core_pump(b210_rx_tx_core_t *c, int16_t *pcm_out, size_t pcm_cap,
                              int16_t *iq_raw_out,    size_t iq_raw_cap,
                              size_t  *out_iq_raw_pairs,
@@ -271,11 +343,34 @@ ssize_t b210_rx_tx_core_pump(b210_rx_tx_core_t *c, int16_t *pcm_out, size_t pcm_
         want_iq = pcm_cap < c->max_iq_in ? pcm_cap : c->max_iq_in;
     }
 
-    ssize_t got = sdr_backend_read_iq(c->backend, c->iq_chunk, want_iq);
+    ssize_t got;
+    if (c->capture != NULL) {
+        sdr_capture_stamp_t st;
+        got = sdr_capture_read(c->capture, c->iq_chunk, want_iq,
+                               CAPTURE_WAIT_S, &st);
+        if (got > 0) {
+            c->stream_next_s     = st.host_time_s + (double)got / c->input_rate;
+            c->stream_time_valid = 1;
+        }
+    } else {
+        got = sdr_backend_read_iq(c->backend, c->iq_chunk, want_iq);
+    }
     if (got < 0) return -1;   // fatal
     if (got == 0) return 0;   // transient — keep looping
     size_t n_recv = (size_t)got;
 
+    // Extra channels: hand the wideband chunk to the channelizer's pool
+    // now and collect it before returning, so the branches run alongside
+    // the primary chain below. iq_chunk stays read-only until the wait
+    // (channels require the decimator, so the Doppler step below works
+    // on iq_decim). The chunk's first sample sits on the same clock the
+    // primary trajectory is evaluated on.
+    if (c->chan != NULL) {
+        double t0 = c->dop_clock_t0_s
+                  + (double)(c->dop_samples - c->dop_clock_k0) / c->actual_rate;
+        channelizer_start(c->chan, c->iq_chunk, n_recv, t0, c->dop_clock_valid);
+    }
+
     // Push through the IQ decimator if configured. The result is a
     // narrowband sc16 IQ stream at actual_rate (== input_rate / M).
     int16_t *iq_demod_buf = c->iq_chunk;
@@ -284,13 +379,35 @@ ssize_t b210_rx_tx_core_pump(b210_rx_tx_core_t *c, int16_t *pcm_out, size_t pcm_
         n_demod = fir_decim_iq_push(c->decim, c->iq_chunk, n_recv,
                                     c->iq_decim, c->max_iq_out);
         iq_demod_buf = c->iq_decim;
-        if (n_demod == 0) return 0;
+        if (n_demod == 0) {
+            channelizer_wait(c->chan);
+            return 0;
+        }
     }
     // Software Doppler correction — applied in place on the post-decim
     // buffer so both the IQ tap and the decode path see the same
     // Doppler-tracked stream. The carrier is parked at the operator's
     // +lo_offset baseband in iq_demod_buf after this step.
-    sw_nco_apply(&c->sw_nco, iq_demod_buf, n_demod);
+    //
+    // With a trajectory installed the frequency comes from the sample
+    // clock instead: a linear ramp between the trajectory values at this
+    // chunk's edges, independent of how often the UI updates.
+    int live = 0;
+    if (c->dop_track != NULL && c->dop_clock_valid) {
+        double t0 = c->dop_clock_t0_s
+                  + (double)(c->dop_samples - c->dop_clock_k0) / c->actual_rate;
+        double t1 = t0 + (double)n_demod / c->actual_rate;
+        double f0, f1;
+        if (sw_nco_track_eval(c->dop_track, t0, &f0) == 0
+            && sw_nco_track_eval(c->dop_track, t1, &f1) == 0) {
+            sw_nco_set_freq(&c->sw_nco, f0);
+            sw_nco_apply_ramp(&c->sw_nco, iq_demod_buf, n_demod, f1);
+            live = 1;
+        }
+    }
+    if (!live) sw_nco_apply(&c->sw_nco, iq_demod_buf, n_demod);
+    c->dop_track_live = live;
+    c->dop_samples += n_demod;
 
     // Decode-path buffer: rotated to DC for FM discriminator + shadow
     // IQ decoder + IQ-burst detector + level meter. When fm_lo_nco is
@@ -310,6 +427,7 @@ ssize_t b210_rx_tx_core_pump(b210_rx_tx_core_t *c, int16_t *pcm_out, size_t pcm_
         iq_burst_push(c->iq_burst_det, iq_demod, n_demod);
         c->last_burst_bright_bins    = iq_burst_bright_bins(c->iq_burst_det);
         c->last_burst_peak_excess_db = iq_burst_peak_excess_db(c->iq_burst_det);
+        c->pump_burst_peak_bins      = iq_burst_take_peak_bins(c->iq_burst_det);
     }
 
     // IQ level meter on the decode-path buffer.
@@ -366,9 +484,71 @@ ssize_t b210_rx_tx_core_pump(b210_rx_tx_core_t *c, int16_t *pcm_out, size_t pcm_
         c->prev_I = I;
         c->prev_Q = Q;
     }
+    channelizer_wait(c->chan);
     return (ssize_t)out_n;
 }
 
+int b210_rx_tx_core_add_channel(b210_rx_tx_core_t *c, double offset_hz)
+{
+    if (c == NULL || c->decim == NULL) return -1;
+    if (c->chan == NULL) {
+        // One pool thread per channel, leaving a CPU for the pump itself.
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        unsigned threads = cpus > 1 ? (unsigned)(cpus - 1) : 0u;
+        c->chan = channelizer_new(c->input_rate, fir_decim_iq_M(c->decim),
+                                  c->decim_fc_hz, c->decim_taps,
+                                  c->max_iq_in, threads);
+        if (c->chan == NULL) return -1;
+    }
+    double f_lo = sw_nco_get_freq(&c->fm_lo_nco);
+    int idx = channelizer_add(c->chan, offset_hz + f_lo);
+    if (idx < 0) {
+        fprintf(stderr, "b210_rx_tx_core: channel at %+.1f kHz doesn't fit "
+                        "the %.0f kS/s capture (or %d channels already)\n",
+                offset_hz / 1e3, c->input_rate / 1e3, CHANNELIZER_MAX);
+        return -1;
+    }
+    c->chan_offset_hz[idx] = offset_hz;
+    return idx;
+}
+
+int b210_rx_tx_core_n_channels(const b210_rx_tx_core_t *c)
+{
+    return c ? channelizer_count(c->chan) : 0;
+}
+
+void b210_rx_tx_core_set_channel_doppler_offset(b210_rx_tx_core_t *c, int ch,
+                                                double offset_hz)
+{
+    if (c == NULL) return;
+    channelizer_set_doppler(c->chan, ch, offset_hz);
+}
+
+void b210_rx_tx_core_set_channel_doppler_track(b210_rx_tx_core_t *c, int ch,
+                                               sw_nco_track_t *track)
+{
+    if (c == NULL) {
+        sw_nco_track_free(track);
+        return;
+    }
+    channelizer_set_track(c->chan, ch, track);
+}
+
+int b210_rx_tx_core_channel_track_live(const b210_rx_tx_core_t *c, int ch)
+{
+    return c ? channelizer_track_live(c->chan, ch) : 0;
+}
+
+const int16_t *b210_rx_tx_core_channel_iq(const b210_rx_tx_core_t *c, int ch,
+                                          size_t *out_pairs)
+{
+    if (c == NULL) {
+        if (out_pairs != NULL) *out_pairs = 0;
+        return NULL;
+    }
+    return channelizer_out(c->chan, ch, out_pairs);
+}
+
 int b210_rx_tx_core_set_freq(b210_rx_tx_core_t *c, double freq_hz)
 {
     if (c == NULL) return -1;
@@ -401,6 +581,42 @@ double b210_rx_tx_core_get_doppler_offset(const b210_rx_tx_core_t *c)
     return c ? sw_nco_get_freq(&c->sw_nco) : 0.0;
 }
 
+// Sample-clock vs wall-clock disagreement tolerated before re-anchoring.
+// Well above pump-return jitter (a chunk is a few tens of ms), well below
+// anything that matters: at a steep 150 Hz/s Doppler rate 0.1 s is 15 Hz,
+// inside the demod's capture range.
+#define DOPPLER_CLOCK_TOLERANCE_S 0.1
+
+void b210_rx_tx_core_set_doppler_track(b210_rx_tx_core_t *c,
+                                       sw_nco_track_t *track)
+{
+    if (c == NULL) {
+        sw_nco_track_free(track);
+        return;
+    }
+    sw_nco_track_free(c->dop_track);
+    c->dop_track = track;
+    if (track == NULL) c->dop_track_live = 0;
+}
+
+void b210_rx_tx_core_sync_doppler_clock(b210_rx_tx_core_t *c, double t_unix_s)
+{
+    if (c == NULL || c->actual_rate <= 0.0) return;
+    if (c->dop_clock_valid) {
+        double t_clock = c->dop_clock_t0_s
+            + (double)(c->dop_samples - c->dop_clock_k0) / c->actual_rate;
+        if (fabs(t_clock - t_unix_s) <= DOPPLER_CLOCK_TOLERANCE_S) return;
+    }
+    c->dop_clock_t0_s  = t_unix_s;
+    c->dop_clock_k0    = c->dop_samples;
+    c->dop_clock_valid = 1;
+}
+
+int b210_rx_tx_core_doppler_track_live(const b210_rx_tx_core_t *c)
+{
+    return c ? c->dop_track_live : 0;
+}
+
 void b210_rx_tx_core_set_fm_lo_compensation(b210_rx_tx_core_t *c,
                                             double lo_offset_hz)
 {
@@ -435,6 +651,12 @@ int b210_rx_tx_core_burst_snapshot(const b210_rx_tx_core_t *c,
     return 0;
 }
 
+int b210_rx_tx_core_pump_burst_peak(const b210_rx_tx_core_t *c)
+{
+    if (c == NULL || c->iq_burst_det == NULL) return -1;
+    return c->pump_burst_peak_bins;
+}
+
 int b210_rx_tx_core_burst(b210_rx_tx_core_t *c,
                           const b210_rx_tx_core_burst_params_t *p)
 {
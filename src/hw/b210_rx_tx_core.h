@@ -37,6 +37,8 @@
 #include <sys/types.h>
 
 #include "sdr_backend.h"
+#include "sdr_capture.h"
+#include "sw_nco.h"
 
 typedef struct b210_rx_tx_core_params {
     double      freq_hz;          // initial center freq
@@ -126,6 +128,9 @@ typedef struct b210_rx_tx_core_params {
     const char        *uhd_args_override;
     const char        *fpga_image_path;
     int                device_index;   // RTL-SDR dongle index (0 = first)
+    int                rtl_xfers;      // RTL-SDR USB transfers queued (0 = default)
+    int                rtl_xfer_bytes; // RTL-SDR bytes per transfer (0 = default)
+    const sdr_replay_params_t *replay; // file backend: recording or synthetic bursts
 } b210_rx_tx_core_params_t;
 
 typedef struct b210_rx_tx_core b210_rx_tx_core_t;
@@ -173,6 +178,29 @@ ssize_t b210_rx_tx_core_pump(b210_rx_tx_core_t *core,
                           int16_t *iq_decode_out, size_t iq_decode_cap,
                           size_t  *out_iq_decode_pairs);
 
+// Move device reads onto a dedicated capture thread feeding a ring
+// ring_s seconds deep (see sdr_capture.h); pump then drains the ring
+// instead of reading the backend. Call before the first pump (or from the
+// pump thread). Returns 0 (also if already running), -1
+// if the thread or ring couldn't be set up -- pump keeps reading the
+// backend directly then. An unpaced backend (caps.unpaced: file replay
+// at full speed) is always read directly, so it waits on the chain
+// instead of overflowing the ring; that returns 0 too.
+int b210_rx_tx_core_start_capture(b210_rx_tx_core_t *core, double ring_s);
+
+// Capture-ring counters (overflows, lag, high-water). Lock-free, safe
+// from any thread while the core is open. -1 (and *out zeroed) without a
+// capture thread.
+int b210_rx_tx_core_capture_stats(const b210_rx_tx_core_t *core,
+                                  sdr_capture_stats_t *out);
+
+// Host UNIX time of the sample after the last pumped chunk, from the
+// capture stamps -- not "now", which lags it by whatever sits in the
+// ring. -1 without a capture thread or before the first chunk. Pump
+// thread only.
+int b210_rx_tx_core_stream_time(const b210_rx_tx_core_t *core,
+                                double *t_unix_s);
+
 // Issue a tune request on RX channel 0. The streamer keeps running.
 // Return: 0 on success, -1 on UHD error.
 int b210_rx_tx_core_set_freq(b210_rx_tx_core_t *core, double freq_hz);
@@ -196,6 +224,28 @@ void   b210_rx_tx_core_set_doppler_offset(b210_rx_tx_core_t *core,
                                           double offset_hz);
 double b210_rx_tx_core_get_doppler_offset(const b210_rx_tx_core_t *core);
 
+// Pump-owned Doppler trajectory. While a trajectory is installed and
+// covers the current chunk, the pump evaluates it at the chunk's first
+// and one-past-last sample times (from its own post-decim sample
+// counter, pinned to wall time by sync_doppler_clock) and applies the
+// correction as a linear ramp between them, so the NCO follows the pass
+// without per-tick steps. Outside the trajectory the last
+// set_doppler_offset value applies as before. The core takes ownership
+// of `track` and frees the previous one; NULL removes it. Pump thread
+// only.
+void   b210_rx_tx_core_set_doppler_track(b210_rx_tx_core_t *core,
+                                         sw_nco_track_t *track);
+// Tell the sample clock that the next post-decim sample is at
+// t_unix_s. The first call anchors the clock; later calls re-anchor only
+// when the sample clock has drifted past a tolerance (dropped samples
+// on an overflow, oscillator ppm), so pump-latency jitter in the wall
+// reading doesn't wobble the trajectory. Pump thread only.
+void   b210_rx_tx_core_sync_doppler_clock(b210_rx_tx_core_t *core,
+                                          double t_unix_s);
+// 1 while the last pumped chunk was corrected from the trajectory.
+// Lock-free display-style read (see the meters below).
+int    b210_rx_tx_core_doppler_track_live(const b210_rx_tx_core_t *core);
+
 // Update the FM-path LO-compensation NCO at runtime. lo_offset_hz is
 // the SIGNED operator offset of the hardware LO from nominal (the
 // same value plumbed via fm_lo_compensation_hz at open). Used by the
@@ -208,6 +258,39 @@ double b210_rx_tx_core_get_doppler_offset(const b210_rx_tx_core_t *core);
 void b210_rx_tx_core_set_fm_lo_compensation(b210_rx_tx_core_t *core,
                                             double lo_offset_hz);
 
+// Extra receive channels (channelizer.h). Each one re-reads the same
+// wideband chunk the primary chain decimates, shifts its own carrier to
+// DC, decimates with the primary's FIR design and applies its own
+// Doppler NCO, so one radio follows several downlinks inside its
+// capture bandwidth. The branches run on a worker pool while the pump
+// does the primary chain, and are finished by the time pump returns.
+//
+// add_channel: offset_hz is the channel's nominal carrier minus the
+// primary's. The LO offset, tune residual and carrier trim that bring
+// the primary carrier to DC are folded in (and followed across
+// set_freq / set_fm_lo_compensation). Returns the channel index, or -1
+// without a decimator, past CHANNELIZER_MAX, or when the channel's band
+// falls outside the capture. Call before the first pump, from the
+// thread that pumps.
+//
+// Doppler: same semantics as the primary's set_doppler_offset /
+// set_doppler_track, per channel, on the primary's sample clock (see
+// sync_doppler_clock). The core takes ownership of `track`. Pump thread
+// only.
+//
+// channel_iq: the channel's output from the last pump -- sc16
+// interleaved, carrier at DC, at actual_rate, *out_pairs pairs. Valid
+// until the next pump. NULL (and 0) for an unknown channel.
+int    b210_rx_tx_core_add_channel(b210_rx_tx_core_t *core, double offset_hz);
+int    b210_rx_tx_core_n_channels(const b210_rx_tx_core_t *core);
+void   b210_rx_tx_core_set_channel_doppler_offset(b210_rx_tx_core_t *core,
+                                                  int ch, double offset_hz);
+void   b210_rx_tx_core_set_channel_doppler_track(b210_rx_tx_core_t *core,
+                                                 int ch, sw_nco_track_t *track);
+int    b210_rx_tx_core_channel_track_live(const b210_rx_tx_core_t *core, int ch);
+const int16_t *b210_rx_tx_core_channel_iq(const b210_rx_tx_core_t *core,
+                                          int ch, size_t *out_pairs);
+
 // Read-back accessors (after b210_rx_tx_core_open succeeded).
 //
 // actual_rate:  post-decimation rate (== input_rate when decim_factor is
@@ -249,6 +332,11 @@ int b210_rx_tx_core_burst_snapshot(const b210_rx_tx_core_t *core,
                                    int *out_bright_bins,
                                    double *out_peak_excess_db);
 
+// Peak bright-bin count over the FFT frames of the samples the last
+// pump returned (iq_burst_take_peak_bins), for rx_session's burst gate.
+// -1 when the detector isn't running. Pump thread only.
+int b210_rx_tx_core_pump_burst_peak(const b210_rx_tx_core_t *core);
+
 typedef struct b210_rx_tx_core_burst_params {
     const int16_t *iq;          // pre-built sc16 interleaved, n_samps pairs
     size_t         n_samps;
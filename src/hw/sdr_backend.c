@@ -36,6 +36,12 @@ static const sdr_backend_ops_t *ops_for(sdr_backend_type_t t)
             return sdr_backend_rtlsdr_ops();
 #else
             return NULL;
+#endif
+        case SDR_TYPE_FILE:
+#ifdef WITH_SDR_REPLAY
+            return sdr_backend_file_ops();
+#else
+            return NULL;
 #endif
         default:
             return NULL;
@@ -49,6 +55,10 @@ int sdr_backend_type_from_string(const char *s, sdr_backend_type_t *out)
     if (strcmp(s, "uhd") == 0)    { *out = SDR_TYPE_UHD;    return 0; }
     if (strcmp(s, "rtlsdr") == 0 || strcmp(s, "rtl-sdr") == 0
         || strcmp(s, "rtl") == 0) { *out = SDR_TYPE_RTLSDR; return 0; }
+    if (strcmp(s, "file") == 0 || strcmp(s, "replay") == 0) {
+        *out = SDR_TYPE_FILE;
+        return 0;
+    }
     return -1;
 }
 
@@ -60,13 +70,14 @@ int sdr_backend_open(sdr_backend_type_t type,
     *out = NULL;
 
     // Build the try-order: a single explicit type, or the auto-probe
-    // sequence — every non-AUTO backend in enum order (UHD before RTL-SDR).
+    // sequence — every hardware backend in enum order (UHD before RTL-SDR;
+    // the file backend would always "open", so it is explicit-only).
     // Sized from the enum so adding a backend doesn't need a magic bump here.
     sdr_backend_type_t order[SDR_TYPE__COUNT];
     int n = 0;
     if (type == SDR_TYPE_AUTO) {
         for (int t = SDR_TYPE_AUTO + 1; t < SDR_TYPE__COUNT; ++t)
-            order[n++] = (sdr_backend_type_t)t;
+            if (t != SDR_TYPE_FILE) order[n++] = (sdr_backend_type_t)t;
     } else {
         order[n++] = type;
     }
@@ -107,6 +118,14 @@ ssize_t sdr_backend_read_iq(sdr_backend_t *be, int16_t *out, size_t cap_pairs)
     return be->ops->read_iq(be, out, cap_pairs);
 }
 
+int sdr_backend_rx_meta(sdr_backend_t *be, sdr_rx_meta_t *out)
+{
+    if (out == NULL) return -1;
+    memset(out, 0, sizeof *out);
+    if (be == NULL || be->ops == NULL || be->ops->rx_meta == NULL) return -1;
+    return be->ops->rx_meta(be, out);
+}
+
 int sdr_backend_set_freq(sdr_backend_t *be, double freq_hz)
 {
     if (be == NULL || be->ops == NULL || be->ops->set_freq == NULL) return -1;
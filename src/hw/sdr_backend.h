@@ -38,10 +38,13 @@
 
 // Which backend to open. AUTO probes the compiled-in backends in a
 // fixed order (UHD first, then RTL-SDR) and uses the first that opens.
+// FILE (replay of a recording, or synthetic bursts) is never probed: it
+// must be asked for.
 typedef enum sdr_backend_type {
     SDR_TYPE_AUTO = 0,
     SDR_TYPE_UHD,
     SDR_TYPE_RTLSDR,
+    SDR_TYPE_FILE,
     SDR_TYPE__COUNT,   // sentinel: number of enum values; keep last
 } sdr_backend_type_t;
 
@@ -54,9 +57,28 @@ typedef struct sdr_caps {
     int    has_hw_lo_offset;   // 1 if the LO can be parked off the carrier
     int    sc16_native;        // 1 if read_iq yields native int16 (UHD); 0 if converted (RTL uint8)
     size_t max_rx_pairs;       // upper bound on IQ pairs returned by one read_iq
+    int    unpaced;            // 1 if read_iq has no device clock behind it and returns
+                               // as fast as it is called (file replay at full speed)
     char   name[32];           // friendly device name for banner/audit
 } sdr_caps_t;
 
+// What the file backend streams: a recorded .sso-iq / .iq at its own
+// rate, or (path NULL) an AX100 beacon burst every burst_s seconds,
+// FM-modulated at rate_hz. Noise and a Doppler ramp are added on top of
+// either, so the live chain can be loaded and measured without a radio.
+typedef struct sdr_replay_params {
+    const char *path;            // recording to stream; NULL => synthetic bursts
+    double      speed;           // 1 = real time, N = N x faster, 0 = as fast as possible
+    int         once;            // end the stream at EOF instead of looping
+    double      rate_hz;         // synthetic: native rate (0 => sdr_open_params.rate_hz)
+    double      burst_s;         // synthetic: burst period (0 => 1 s)
+    double      carrier_hz;      // synthetic: RF carrier; it sits at carrier - LO
+                                 // in baseband (0 => at the LO)
+    double      noise_dbfs;      // complex Gaussian noise power (0 => none)
+    double      doppler_hz;      // frequency shift at stream start
+    double      doppler_rate_hz_s; // and its drift per stream second
+} sdr_replay_params_t;
+
 // Open parameters. Superset of what any one backend needs; a backend
 // ignores fields that don't apply to it.
 typedef struct sdr_open_params {
@@ -76,6 +98,9 @@ typedef struct sdr_open_params {
     const char *uhd_args_override;  // UHD: raw device-args passthrough (NULL => none)
     const char *fpga_image_path;    // UHD: force fpga=<path> (NULL => none)
     int         device_index;       // RTL-SDR: dongle index (0 = first)
+    int         rtl_xfers;          // RTL-SDR: USB transfers kept queued (0 => default)
+    int         rtl_xfer_bytes;     // RTL-SDR: bytes per transfer (0 => default)
+    const sdr_replay_params_t *replay; // file: what to stream (NULL => synthetic defaults)
 } sdr_open_params_t;
 
 // Optional per-burst timing breakdown (seconds), filled by the backend's
@@ -110,6 +135,16 @@ typedef struct sdr_tx_burst_params {
     sdr_tx_burst_timing_t *timing;
 } sdr_tx_burst_params_t;
 
+// What the device said about the samples one read_iq returned. Filled by
+// backends whose driver reports it (UHD's rx metadata, the RTL-SDR's own
+// transfer ring); see rx_meta.
+typedef struct sdr_rx_meta {
+    int      overflow;      // the device dropped samples ahead of this read
+    uint64_t dropped;       // how many pairs, when the backend can count them (0 = unknown)
+    int      has_time;      // device_time_s is valid
+    double   device_time_s; // device clock at the first returned sample
+} sdr_rx_meta_t;
+
 typedef struct sdr_backend sdr_backend_t;
 
 // The vtable. open/close/read_iq/set_freq/get_actual_freq/set_gain are
@@ -127,6 +162,11 @@ typedef struct sdr_backend_ops {
     double  (*get_actual_freq)(sdr_backend_t *be);
     int     (*set_gain)(sdr_backend_t *be, double gain_db);
     int     (*tx_burst)(sdr_backend_t *be, const sdr_tx_burst_params_t *p); // NULL => RX-only
+    // Metadata of the last read_iq, called from the thread that made it
+    // (an overflow is reported even when that read returned 0). Returns
+    // 0, or -1 when there is none. NULL => the backend reports nothing
+    // beyond the samples.
+    int     (*rx_meta)(sdr_backend_t *be, sdr_rx_meta_t *out);
 } sdr_backend_ops_t;
 
 // The handle. Not opaque so backends can reach priv/caps directly; the
@@ -141,8 +181,9 @@ struct sdr_backend {
 // struct, or NULL if that backend was not compiled in.
 const sdr_backend_ops_t *sdr_backend_uhd_ops(void);
 const sdr_backend_ops_t *sdr_backend_rtlsdr_ops(void);
+const sdr_backend_ops_t *sdr_backend_file_ops(void);
 
-// Parse a CLI string ("uhd", "rtlsdr", "auto") to a type. Unknown
+// Parse a CLI string ("uhd", "rtlsdr", "file", "auto") to a type. Unknown
 // strings return -1.
 int sdr_backend_type_from_string(const char *s, sdr_backend_type_t *out);
 
@@ -161,6 +202,8 @@ ssize_t sdr_backend_read_iq(sdr_backend_t *be, int16_t *out, size_t cap_pairs);
 int     sdr_backend_set_freq(sdr_backend_t *be, double freq_hz);
 double  sdr_backend_get_actual_freq(sdr_backend_t *be);
 int     sdr_backend_set_gain(sdr_backend_t *be, double gain_db);
+// -1 when the backend has no metadata for the last read (out zeroed).
+int     sdr_backend_rx_meta(sdr_backend_t *be, sdr_rx_meta_t *out);
 // Returns -1 (and logs) when the active backend is RX-only.
 int     sdr_backend_tx_burst(sdr_backend_t *be, const sdr_tx_burst_params_t *p);
 const sdr_caps_t *sdr_backend_caps(const sdr_backend_t *be);
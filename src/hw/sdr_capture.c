@@ -0,0 +1,309 @@
+/*
+
+   Simple Satellite Operations  sdr_capture.c
+
+   The capture thread and its SPSC sample ring. See sdr_capture.h.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+
+#include "sdr_capture.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+// One backend read as it sits in the ring.
+typedef struct {
+    uint64_t sample;        // device-stream index of its first pair
+    size_t   n;             // pairs
+    double   host_end_s;    // UNIX time read_iq returned (~ one past its last pair)
+    int      has_device_time;
+    double   device_time_s; // device clock at its first pair
+} cap_block_t;
+
+struct sdr_capture {
+    sdr_backend_t *be;
+    double         rate_hz;
+    size_t         max_read;
+    int16_t       *scratch;     // producer's read_iq buffer, max_read pairs
+
+    // Sample ring (interleaved I,Q) and the block descriptors that index
+    // it, both written in order by the producer. Heads and tails count
+    // forever; position = count % size. The producer owns *_head, the
+    // consumer *_tail; each side reads the other's with acquire.
+    int16_t       *ring;
+    size_t         ring_pairs;
+    cap_block_t   *blocks;
+    size_t         n_blocks;
+    uint64_t       head, tail;          // pairs
+    uint64_t       blk_head, blk_tail;  // blocks
+    size_t         blk_off;             // consumer: pairs already taken from blk_tail
+
+    // The consumer sleeps here when the ring is empty; the producer
+    // signals only when `waiting` says someone is.
+    pthread_mutex_t mu;
+    pthread_cond_t  cv;
+    int             waiting;
+
+    pthread_t      thread;
+    int            quit;                // set by stop
+    int            dead;                // read_iq reported a fatal error
+    int            running;
+    int            realtime;
+
+    // Producer-side counters (atomic stores, relaxed loads in stats).
+    uint64_t       next_sample;
+    uint64_t       samples_in;
+    uint64_t       samples_dropped;
+    uint64_t       ring_overflows;
+    uint64_t       device_overflows;
+    uint64_t       device_lost;
+    uint64_t       read_errors;
+    uint64_t       high_water;          // pairs
+};
+
+static double unix_now_s(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec * 1e-6;
+}
+
+static void bump(uint64_t *ctr, uint64_t by)
+{
+    __atomic_store_n(ctr, __atomic_load_n(ctr, __ATOMIC_RELAXED) + by, __ATOMIC_RELAXED);
+}
+
+static void wake_consumer(sdr_capture_t *c)
+{
+    // seq_cst pairs with the consumer's store of `waiting` and re-check of
+    // blk_head: one of the two always sees the other's write.
+    if (!__atomic_load_n(&c->waiting, __ATOMIC_SEQ_CST)) return;
+    pthread_mutex_lock(&c->mu);
+    pthread_cond_signal(&c->cv);
+    pthread_mutex_unlock(&c->mu);
+}
+
+// Publish one read into the ring, or drop it whole if it doesn't fit.
+static void push_block(sdr_capture_t *c, size_t got, double host_end_s,
+                       const sdr_rx_meta_t *meta)
+{
+    uint64_t seq = c->next_sample;
+    c->next_sample += got;
+    bump(&c->samples_in, got);
+
+    uint64_t head = c->head;
+    uint64_t tail = __atomic_load_n(&c->tail, __ATOMIC_ACQUIRE);
+    uint64_t bhead = c->blk_head;
+    uint64_t btail = __atomic_load_n(&c->blk_tail, __ATOMIC_ACQUIRE);
+    if (c->ring_pairs - (size_t)(head - tail) < got
+        || bhead - btail >= (uint64_t)c->n_blocks) {
+        bump(&c->ring_overflows, 1);
+        bump(&c->samples_dropped, got);
+        return;
+    }
+
+    size_t pos   = (size_t)(head % c->ring_pairs);
+    size_t first = c->ring_pairs - pos;
+    if (first > got) first = got;
+    memcpy(c->ring + 2 * pos, c->scratch, first * 2 * sizeof(int16_t));
+    if (first < got)
+        memcpy(c->ring, c->scratch + 2 * first, (got - first) * 2 * sizeof(int16_t));
+
+    cap_block_t *b = &c->blocks[bhead % c->n_blocks];
+    b->sample          = seq;
+    b->n               = got;
+    b->host_end_s      = host_end_s;
+    b->has_device_time = meta->has_time;
+    b->device_time_s   = meta->device_time_s;
+
+    __atomic_store_n(&c->head, head + got, __ATOMIC_RELEASE);
+    __atomic_store_n(&c->blk_head, bhead + 1, __ATOMIC_SEQ_CST);
+
+    uint64_t fill = head + got - tail;
+    if (fill > __atomic_load_n(&c->high_water, __ATOMIC_RELAXED))
+        __atomic_store_n(&c->high_water, fill, __ATOMIC_RELAXED);
+    wake_consumer(c);
+}
+
+static void *capture_thread_fn(void *arg)
+{
+    sdr_capture_t *c = arg;
+    while (!__atomic_load_n(&c->quit, __ATOMIC_ACQUIRE)) {
+        ssize_t got = sdr_backend_read_iq(c->be, c->scratch, c->max_read);
+        double  now = unix_now_s();
+        sdr_rx_meta_t meta;
+        sdr_backend_rx_meta(c->be, &meta);
+        if (meta.overflow) bump(&c->device_overflows, 1);
+        if (meta.dropped > 0) {
+            // Counted samples the device lost open a gap in the stream
+            // index, ahead of this read.
+            bump(&c->device_lost, meta.dropped);
+            c->next_sample += meta.dropped;
+        }
+        if (got < 0) {
+            __atomic_store_n(&c->dead, 1, __ATOMIC_RELEASE);
+            break;
+        }
+        if (got == 0) {
+            bump(&c->read_errors, 1);
+            continue;
+        }
+        push_block(c, (size_t)got, now, &meta);
+    }
+    __atomic_store_n(&c->running, 0, __ATOMIC_RELEASE);
+    // Let a sleeping consumer see the loss (or the stop) straight away.
+    pthread_mutex_lock(&c->mu);
+    pthread_cond_signal(&c->cv);
+    pthread_mutex_unlock(&c->mu);
+    return NULL;
+}
+
+static void capture_free(sdr_capture_t *c)
+{
+    free(c->scratch);
+    free(c->ring);
+    free(c->blocks);
+    free(c);
+}
+
+sdr_capture_t *sdr_capture_start(sdr_backend_t *be, double rate_hz,
+                                 double ring_s, size_t max_read_pairs)
+{
+    if (be == NULL || !(rate_hz > 0.0) || !(ring_s > 0.0) || max_read_pairs == 0)
+        return NULL;
+    sdr_capture_t *c = calloc(1, sizeof *c);
+    if (c == NULL) return NULL;
+    c->be       = be;
+    c->rate_hz  = rate_hz;
+    c->max_read = max_read_pairs;
+    c->ring_pairs = (size_t)(rate_hz * ring_s);
+    if (c->ring_pairs < 4 * max_read_pairs) c->ring_pairs = 4 * max_read_pairs;
+    // Backends return close to max_read per call; room for blocks a
+    // sixteenth that size keeps short reads from exhausting descriptors
+    // before samples.
+    size_t min_block = max_read_pairs / 16 ? max_read_pairs / 16 : 1;
+    c->n_blocks = c->ring_pairs / min_block + 1;
+    c->scratch = malloc(max_read_pairs * 2 * sizeof(int16_t));
+    c->ring    = malloc(c->ring_pairs * 2 * sizeof(int16_t));
+    c->blocks  = calloc(c->n_blocks, sizeof *c->blocks);
+    if (c->scratch == NULL || c->ring == NULL || c->blocks == NULL) {
+        fprintf(stderr, "sdr_capture: out of memory for a %.1f s ring\n", ring_s);
+        capture_free(c);
+        return NULL;
+    }
+    pthread_mutex_init(&c->mu, NULL);
+    pthread_cond_init(&c->cv, NULL);
+    c->running = 1;
+    if (pthread_create(&c->thread, NULL, capture_thread_fn, c) != 0) {
+        fprintf(stderr, "sdr_capture: pthread_create failed\n");
+        pthread_cond_destroy(&c->cv);
+        pthread_mutex_destroy(&c->mu);
+        capture_free(c);
+        return NULL;
+    }
+    // Real-time priority for the reader only: it does almost no work, so
+    // it can't starve anything, and it is the one thread whose latency
+    // the device notices. Needs CAP_SYS_NICE or an rtprio limit.
+    struct sched_param sp = { .sched_priority = sched_get_priority_min(SCHED_FIFO) + 10 };
+    int rc = pthread_setschedparam(c->thread, SCHED_FIFO, &sp);
+    c->realtime = (rc == 0);
+    if (rc != 0) {
+        fprintf(stderr, "sdr_capture: no real-time priority for the capture "
+                        "thread (%s); running at normal priority\n", strerror(rc));
+    }
+    return c;
+}
+
+void sdr_capture_stop(sdr_capture_t *c)
+{
+    if (c == NULL) return;
+    __atomic_store_n(&c->quit, 1, __ATOMIC_RELEASE);
+    pthread_join(c->thread, NULL);
+    pthread_cond_destroy(&c->cv);
+    pthread_mutex_destroy(&c->mu);
+    capture_free(c);
+}
+
+ssize_t sdr_capture_read(sdr_capture_t *c, int16_t *out, size_t cap_pairs,
+                         double timeout_s, sdr_capture_stamp_t *stamp)
+{
+    if (c == NULL || out == NULL || cap_pairs == 0) return -1;
+    uint64_t btail = c->blk_tail;
+    if (__atomic_load_n(&c->blk_head, __ATOMIC_ACQUIRE) == btail) {
+        if (__atomic_load_n(&c->dead, __ATOMIC_ACQUIRE)) return -1;
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        long ns = (long)(timeout_s * 1e9);
+        until.tv_sec  += ns / 1000000000L;
+        until.tv_nsec += ns % 1000000000L;
+        if (until.tv_nsec >= 1000000000L) { until.tv_sec++; until.tv_nsec -= 1000000000L; }
+        pthread_mutex_lock(&c->mu);
+        __atomic_store_n(&c->waiting, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&c->blk_head, __ATOMIC_SEQ_CST) == btail
+               && __atomic_load_n(&c->running, __ATOMIC_ACQUIRE)) {
+            if (pthread_cond_timedwait(&c->cv, &c->mu, &until) == ETIMEDOUT) break;
+        }
+        __atomic_store_n(&c->waiting, 0, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&c->mu);
+        if (__atomic_load_n(&c->blk_head, __ATOMIC_ACQUIRE) == btail)
+            return __atomic_load_n(&c->dead, __ATOMIC_ACQUIRE) ? -1 : 0;
+    }
+
+    const cap_block_t *b = &c->blocks[btail % c->n_blocks];
+    size_t left = b->n - c->blk_off;
+    size_t n = left < cap_pairs ? left : cap_pairs;
+    if (stamp != NULL) {
+        stamp->sample          = b->sample + c->blk_off;
+        stamp->host_time_s     = b->host_end_s - (double)(b->n - c->blk_off) / c->rate_hz;
+        stamp->has_device_time = b->has_device_time;
+        stamp->device_time_s   = b->device_time_s + (double)c->blk_off / c->rate_hz;
+    }
+
+    uint64_t tail = c->tail;
+    size_t pos   = (size_t)(tail % c->ring_pairs);
+    size_t first = c->ring_pairs - pos;
+    if (first > n) first = n;
+    memcpy(out, c->ring + 2 * pos, first * 2 * sizeof(int16_t));
+    if (first < n)
+        memcpy(out + 2 * first, c->ring, (n - first) * 2 * sizeof(int16_t));
+
+    c->blk_off += n;
+    if (c->blk_off == b->n) {
+        c->blk_off = 0;
+        __atomic_store_n(&c->blk_tail, btail + 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&c->tail, tail + n, __ATOMIC_RELEASE);
+    return (ssize_t)n;
+}
+
+void sdr_capture_stats(const sdr_capture_t *c, sdr_capture_stats_t *out)
+{
+    if (out == NULL) return;
+    memset(out, 0, sizeof *out);
+    if (c == NULL) return;
+    out->running          = __atomic_load_n(&c->running, __ATOMIC_RELAXED);
+    out->realtime         = c->realtime;
+    out->ring_s           = (double)c->ring_pairs / c->rate_hz;
+    out->samples_in       = __atomic_load_n(&c->samples_in, __ATOMIC_RELAXED);
+    out->samples_dropped  = __atomic_load_n(&c->samples_dropped, __ATOMIC_RELAXED);
+    out->ring_overflows   = __atomic_load_n(&c->ring_overflows, __ATOMIC_RELAXED);
+    out->device_overflows = __atomic_load_n(&c->device_overflows, __ATOMIC_RELAXED);
+    out->device_lost      = __atomic_load_n(&c->device_lost, __ATOMIC_RELAXED);
+    out->read_errors      = __atomic_load_n(&c->read_errors, __ATOMIC_RELAXED);
+    uint64_t head = __atomic_load_n(&c->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = __atomic_load_n(&c->tail, __ATOMIC_ACQUIRE);
+    out->lag_s        = (double)(head >= tail ? head - tail : 0) / c->rate_hz;
+    out->high_water_s = (double)__atomic_load_n(&c->high_water, __ATOMIC_RELAXED) / c->rate_hz;
+}
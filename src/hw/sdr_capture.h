@@ -0,0 +1,98 @@
+/*
+
+   Simple Satellite Operations  sdr_capture.h
+
+   Dedicated SDR capture thread ahead of the DSP chain. The thread does
+   nothing but call the backend's read_iq and copy what it got into a
+   single-producer / single-consumer ring a few seconds deep; the
+   rx_session worker drains the ring through b210_rx_tx_core_pump at
+   whatever pace decimation, the decoders, the WAV/.iq writers and the DB
+   allow. A slow step in the worker now eats ring headroom instead of
+   overflowing the UHD transport or dropping RTL-SDR bytes.
+
+   The ring is lock-free on the data path: the producer publishes with a
+   release store of its head, the consumer with a release store of its
+   tail. The only lock is the one the consumer sleeps on when the ring is
+   empty, and the producer takes it only when the consumer is asleep.
+
+   Each backend read is one block, stamped with its first sample's index
+   in the device stream (counting samples later dropped, and those the
+   backend says the device lost, so a gap shows), the host wall-clock
+   time and, where the backend reports one, the device timestamp. If the
+   ring is full when a read lands the whole block is dropped and counted;
+   the device never waits on the DSP.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDR_CAPTURE_H
+#define SDR_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "sdr_backend.h"
+
+typedef struct sdr_capture sdr_capture_t;
+
+// Where the first pair returned by one sdr_capture_read sits in time.
+typedef struct sdr_capture_stamp {
+    uint64_t sample;           // index in the device stream (drops included)
+    double   host_time_s;      // UNIX time of that sample, from the host clock
+    int      has_device_time;  // backend reported a timestamp for the block
+    double   device_time_s;    // device clock (UHD time_spec) of that sample
+} sdr_capture_stamp_t;
+
+// Counters for the operator panel. Producer-side values are read without
+// a lock, so a snapshot can mix adjacent reads; they are meters, not an
+// audit trail.
+typedef struct sdr_capture_stats {
+    int      running;          // capture thread is reading the device
+    int      realtime;         // it got SCHED_FIFO priority
+    double   ring_s;           // ring capacity (seconds at the native rate)
+    uint64_t samples_in;       // pairs read from the device
+    uint64_t samples_dropped;  // pairs thrown away because the ring was full
+    uint64_t ring_overflows;   // reads dropped because the ring was full
+    uint64_t device_overflows; // reads the backend flagged as overflowed
+    uint64_t device_lost;      // pairs those overflows cost, where the backend counts them
+    uint64_t read_errors;      // transient read_iq failures / timeouts
+    double   lag_s;            // samples queued, in seconds: how far the DSP trails
+    double   high_water_s;     // largest lag_s seen
+} sdr_capture_stats_t;
+
+// Start the capture thread on an open backend. rate_hz is the backend's
+// native rate, ring_s the ring depth in seconds, max_read_pairs the most
+// one read_iq may return. The thread asks for SCHED_FIFO and carries on
+// at normal priority when it isn't allowed. NULL on OOM / thread failure
+// (the caller can keep reading the backend directly).
+sdr_capture_t *sdr_capture_start(sdr_backend_t *be, double rate_hz,
+                                 double ring_s, size_t max_read_pairs);
+
+// Stop and join the thread (it notices within one read_iq timeout) and
+// free the ring. NULL-safe. The backend stays open.
+void sdr_capture_stop(sdr_capture_t *cap);
+
+// Consumer side: copy up to cap_pairs queued pairs, never crossing a
+// block, into out and stamp the first one. Waits up to timeout_s for
+// data. Same return contract as read_iq: >0 pairs, 0 nothing yet (keep
+// looping), <0 the device is gone and the ring has drained.
+ssize_t sdr_capture_read(sdr_capture_t *cap, int16_t *out, size_t cap_pairs,
+                         double timeout_s, sdr_capture_stamp_t *stamp);
+
+void sdr_capture_stats(const sdr_capture_t *cap, sdr_capture_stats_t *out);
+
+#endif // SDR_CAPTURE_H
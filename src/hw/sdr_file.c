@@ -0,0 +1,454 @@
+/*
+
+   Simple Satellite Operations  sdr_file.c
+
+   File backend for the SDR abstraction: software in the loop. Instead of
+   a radio it streams either a recorded .sso-iq / .iq (at the recording's
+   own rate, looping unless told to stop at the end) or synthetic AX100
+   beacon bursts, FM-modulated at a chosen native rate, one every burst_s
+   seconds with silence between. Either can carry added complex Gaussian
+   noise and a linear Doppler ramp, so the whole live path (rx_session
+   worker, decoders, DB tap, IPC, audio relay) runs on a dev host or in
+   CI and can be pushed until it breaks.
+
+   Pacing follows the replay speed: samples come out on a wall-clock
+   schedule at 1x (what a radio does), N times faster, or as fast as the
+   caller reads (speed 0). An unpaced stream has no device clock to keep
+   up with, so its caps say so and the chain reads it directly rather
+   than through the capture ring, which would only drop what it can't
+   hold. On close the backend logs how much signal time went through in
+   how much wall time: at speed 0 that ratio is the chain's real-time
+   headroom.
+
+   RX-only: tx_burst is NULL. Tuning is bookkeeping, except that the
+   synthetic carrier sits at carrier_hz - LO in baseband, so a retune
+   moves it the way it would move a real signal.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+
+#include "sdr_backend.h"
+
+#include "ax100.h"
+#include "beacon_cts1.h"
+#include "csp.h"
+#include "fm_mod.h"
+#include "modem.h"
+#include "sso_iq.h"
+#include "sw_nco.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#define FILE_POST_DECIM_DEFAULT  96000.0   // rate of a raw .iq recording
+#define FILE_BURST_S_DEFAULT     1.0
+#define FILE_DEVIATION_HZ        2400.0    // bit_rate / 4, as the TX path
+#define FILE_RAMP_S              0.001
+#define FILE_NOISE_TABLE         65536     // Gaussian deviates, power of two
+
+struct sdr_file {
+    sdr_replay_params_t rp;
+    char            *path;
+    sso_iq_reader_t *rd;          // recording; NULL => synthetic
+    double           rate;        // native rate
+    double           lo_hz;       // "tuned" frequency
+    size_t           max_pairs;
+
+    // Synthetic bursts: one frame's IQ at the native rate, rebuilt each
+    // period with the beacon counter advanced, then silence.
+    int16_t         *burst;
+    int16_t         *pcm;         // the burst's modem output
+    size_t           burst_pairs;
+    size_t           period_pairs;
+    size_t           period_pos;  // next pair within the current period
+    uint32_t         n_bursts;
+
+    // Frequency shift: synthetic carrier offset plus the Doppler ramp,
+    // applied as one NCO (sw_nco rotates by -f, so it runs at -shift).
+    sw_nco_t         nco;
+
+    // Noise: a table of deviates scaled to the requested power, indexed
+    // by a xorshift generator.
+    int16_t         *noise;
+    uint64_t         rng;
+
+    // Pacing and accounting.
+    uint64_t         pairs_out;   // stream position
+    size_t           last_n;      // pairs the last read returned
+    double           t0_wall;     // monotonic time of the first read
+    int              started;
+    int              ended;
+};
+
+static void file_close(sdr_backend_t *be);
+
+static double mono_now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t xorshift64(uint64_t *s)
+{
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+// Shift (Hz) the stream should carry at stream time t_s.
+static double file_shift_hz(const struct sdr_file *f, double t_s)
+{
+    double shift = f->rp.doppler_hz + f->rp.doppler_rate_hz_s * t_s;
+    if (f->rd == NULL && f->rp.carrier_hz != 0.0) shift += f->rp.carrier_hz - f->lo_hz;
+    return shift;
+}
+
+// The next synthetic burst: a CTS1 basic beacon, counters advanced per
+// burst so the decoded frames differ, framed as the satellite frames it
+// and FM-modulated at the native rate.
+static int file_build_burst(struct sdr_file *f)
+{
+    COMMS_beacon_basic_packet_t b;
+    memset(&b, 0, sizeof b);
+    b.packet_type = COMMS_PACKET_TYPE_BEACON_BASIC;
+    memcpy(b.satellite_name, "CTS1", 4);
+    b.uptime_ms                     = 3600000u + (uint32_t)(f->n_bursts * f->rp.burst_s * 1000.0);
+    b.total_beacon_count_since_boot = 100u + f->n_bursts;
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    b.unix_epoch_time_ms = (uint64_t)tv.tv_sec * 1000u + (uint64_t)tv.tv_usec / 1000u;
+
+    const csp_v1_header_t hdr = {
+        .prio  = CTS1_BEACON_CSP_PRIO,
+        .src   = CTS1_BEACON_CSP_SRC,
+        .dst   = CTS1_BEACON_CSP_DST,
+        .dport = CTS1_BEACON_CSP_DPORT,
+        .sport = CTS1_BEACON_CSP_SPORT,
+        .flags = CTS1_BEACON_CSP_FLAGS,
+    };
+    uint8_t csp_packet[256];
+    ssize_t csp_len = csp_v1_encode(&hdr, (const uint8_t *)&b, sizeof b,
+                                    csp_packet, sizeof csp_packet);
+    if (csp_len < 0) return -1;
+    ax100_opts_t opts;
+    ax100_opts_defaults(&opts);
+    opts.reed_solomon = 1;
+    uint8_t frame[512];
+    ssize_t frame_len = ax100_frame(csp_packet, (size_t)csp_len, &opts,
+                                    frame, sizeof frame);
+    if (frame_len < 0) return -1;
+
+    modem_params_t mp;
+    modem_params_defaults(&mp);
+    mp.samp_rate = (int)f->rate;
+    size_t n = (size_t)frame_len * 8u * (size_t)(mp.samp_rate / mp.bit_rate);
+    if (f->burst == NULL) {
+        // Every beacon frames to the same length: size the buffers once.
+        f->burst = malloc(n * 2 * sizeof(int16_t));
+        f->pcm   = malloc(n * sizeof(int16_t));
+        if (f->burst == NULL || f->pcm == NULL) return -1;
+        f->burst_pairs = n;
+    }
+    if (n != f->burst_pairs) return -1;
+    if (modem_bytes_to_pcm16(frame, (size_t)frame_len, &mp, f->pcm, n) < 0) return -1;
+    fm_mod_t fm;
+    fm_mod_init(&fm);
+    fm_mod_block(&fm, f->pcm, n, FILE_DEVIATION_HZ, f->rate, f->burst);
+    fm_apply_ramp(f->burst, n, (size_t)(FILE_RAMP_S * f->rate));
+    f->n_bursts++;
+    return 0;
+}
+
+// Synthetic stream: the current burst, then zeros to the period's end.
+static int file_synth(struct sdr_file *f, int16_t *out, size_t n)
+{
+    size_t done = 0;
+    while (done < n) {
+        if (f->period_pos == 0 && file_build_burst(f) != 0) return -1;
+        size_t take;
+        if (f->period_pos < f->burst_pairs) {
+            take = f->burst_pairs - f->period_pos;
+            if (take > n - done) take = n - done;
+            memcpy(out + 2 * done, f->burst + 2 * f->period_pos,
+                   take * 2 * sizeof(int16_t));
+        } else {
+            take = f->period_pairs - f->period_pos;
+            if (take > n - done) take = n - done;
+            memset(out + 2 * done, 0, take * 2 * sizeof(int16_t));
+        }
+        done += take;
+        f->period_pos += take;
+        if (f->period_pos >= f->period_pairs) f->period_pos = 0;
+    }
+    return 0;
+}
+
+static void file_add_noise(struct sdr_file *f, int16_t *iq, size_t n_pairs)
+{
+    for (size_t i = 0; i < 2 * n_pairs; i++) {
+        int v = iq[i] + f->noise[xorshift64(&f->rng) >> 48];
+        iq[i] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+    }
+}
+
+static int file_open(sdr_backend_t *be, const sdr_open_params_t *p, sdr_caps_t *caps)
+{
+    if (be == NULL || p == NULL || caps == NULL) return -1;
+
+    struct sdr_file *f = calloc(1, sizeof *f);
+    if (f == NULL) {
+        fprintf(stderr, "sdr_file: out of memory\n");
+        return -1;
+    }
+    be->priv = f;
+    if (p->replay != NULL) f->rp = *p->replay;
+    if (f->rp.speed < 0.0) f->rp.speed = 1.0;
+    f->lo_hz = p->freq_hz;
+    double post = p->target_post_decim_hz > 0.0 ? p->target_post_decim_hz
+                                                : FILE_POST_DECIM_DEFAULT;
+
+    if (f->rp.path != NULL && f->rp.path[0] != '\0') {
+        f->path = strdup(f->rp.path);
+        f->rd = sso_iq_open(f->rp.path);
+        if (f->path == NULL || f->rd == NULL) {
+            fprintf(stderr, "sdr_file: can't open recording %s\n", f->rp.path);
+            goto fail;
+        }
+        if (sso_iq_pairs(f->rd) == 0) {
+            fprintf(stderr, "sdr_file: %s holds no samples\n", f->rp.path);
+            goto fail;
+        }
+        // A .sso-iq knows its rate; a raw .iq is the chain's own output.
+        f->rate = sso_iq_meta(f->rd)->sample_rate_hz;
+        if (!(f->rate > 0.0)) f->rate = post;
+    } else {
+        // Whole multiples of the post-decim rate keep the decimator an
+        // integer, and the modem's samples-per-bit with it.
+        double want = f->rp.rate_hz > 0.0 ? f->rp.rate_hz
+                    : p->rate_hz > 0.0    ? p->rate_hz : 480000.0;
+        long k = lround(want / post);
+        if (k < 1) k = 1;
+        f->rate = post * (double)k;
+        modem_params_t mp;
+        modem_params_defaults(&mp);
+        if ((long)f->rate % mp.bit_rate != 0) {
+            fprintf(stderr, "sdr_file: %.0f Hz is not a multiple of the %d bit/s "
+                            "symbol rate\n", f->rate, mp.bit_rate);
+            goto fail;
+        }
+        if (!(f->rp.burst_s > 0.0)) f->rp.burst_s = FILE_BURST_S_DEFAULT;
+        f->period_pairs = (size_t)llround(f->rp.burst_s * f->rate);
+        if (file_build_burst(f) != 0) {
+            fprintf(stderr, "sdr_file: can't synthesise a beacon burst\n");
+            goto fail;
+        }
+        // Built again at the top of the first period.
+        f->n_bursts = 0;
+        if (f->period_pairs < f->burst_pairs) f->period_pairs = f->burst_pairs;
+    }
+
+    // About 5 ms a read, a UHD-sized bite.
+    f->max_pairs = (size_t)(f->rate / 200.0);
+    f->max_pairs = (f->max_pairs + 63) & ~(size_t)63;
+    if (f->max_pairs < 256)   f->max_pairs = 256;
+    if (f->max_pairs > 65536) f->max_pairs = 65536;
+
+    sw_nco_init(&f->nco, f->rate);
+    sw_nco_set_freq(&f->nco, -file_shift_hz(f, 0.0));
+
+    if (f->rp.noise_dbfs < 0.0) {
+        // dBFS of the complex noise power against a full-scale tone, split
+        // evenly between I and Q.
+        double sigma = 32767.0 * pow(10.0, f->rp.noise_dbfs / 20.0) / sqrt(2.0);
+        f->noise = malloc(FILE_NOISE_TABLE * sizeof(int16_t));
+        if (f->noise == NULL) {
+            fprintf(stderr, "sdr_file: out of memory for the noise table\n");
+            goto fail;
+        }
+        uint64_t s = 0x9E3779B97F4A7C15ull;
+        for (size_t i = 0; i < FILE_NOISE_TABLE; i += 2) {
+            double u1 = ((double)(xorshift64(&s) >> 11) + 1.0) / 9007199254740993.0;
+            double u2 = (double)(xorshift64(&s) >> 11) / 9007199254740992.0;
+            double r = sigma * sqrt(-2.0 * log(u1));
+            double a = r * cos(2.0 * M_PI * u2), b = r * sin(2.0 * M_PI * u2);
+            f->noise[i]     = (int16_t)fmax(-32768.0, fmin(32767.0, lround(a)));
+            f->noise[i + 1] = (int16_t)fmax(-32768.0, fmin(32767.0, lround(b)));
+        }
+        f->rng = 0x2545F4914F6CDD1Dull;
+    }
+
+    caps->can_tx             = 0;
+    caps->native_rate_hz     = f->rate;
+    caps->tune_resolution_hz = 1.0;
+    caps->has_hw_lo_offset   = 1;
+    caps->sc16_native        = 1;
+    caps->max_rx_pairs       = f->max_pairs;
+    caps->unpaced            = f->rp.speed == 0.0;
+    snprintf(caps->name, sizeof caps->name, "%s",
+             f->rd != NULL ? "file replay" : "synthetic bursts");
+
+    char speed[32];
+    if (f->rp.speed == 0.0) snprintf(speed, sizeof speed, "max");
+    else                    snprintf(speed, sizeof speed, "%gx", f->rp.speed);
+    if (f->rd != NULL) {
+        fprintf(stderr, "sdr_file: replaying %s (%.1f s at %.0f Hz), speed %s%s\n",
+                f->path, (double)sso_iq_pairs(f->rd) / f->rate, f->rate, speed,
+                f->rp.once ? ", once" : ", looping");
+    } else {
+        fprintf(stderr, "sdr_file: synthetic beacon every %.2f s at %.0f Hz, "
+                        "speed %s\n", f->rp.burst_s, f->rate, speed);
+    }
+    if (f->noise != NULL)
+        fprintf(stderr, "sdr_file: noise %.1f dBFS\n", f->rp.noise_dbfs);
+    if (f->rp.doppler_hz != 0.0 || f->rp.doppler_rate_hz_s != 0.0)
+        fprintf(stderr, "sdr_file: Doppler %+.0f Hz %+.1f Hz/s\n",
+                f->rp.doppler_hz, f->rp.doppler_rate_hz_s);
+    return 0;
+
+fail:
+    file_close(be);
+    return -1;
+}
+
+static void file_close(sdr_backend_t *be)
+{
+    if (be == NULL) return;
+    struct sdr_file *f = (struct sdr_file *)be->priv;
+    if (f == NULL) return;
+    if (f->started && f->rate > 0.0) {
+        double signal_s = (double)f->pairs_out / f->rate;
+        double wall_s   = mono_now_s() - f->t0_wall;
+        fprintf(stderr, "sdr_file: %.1f s of signal in %.1f s (%.2fx real time)",
+                signal_s, wall_s, wall_s > 0.0 ? signal_s / wall_s : 0.0);
+        if (f->rd == NULL) fprintf(stderr, ", %u bursts", f->n_bursts);
+        fputc('\n', stderr);
+    }
+    sso_iq_close(f->rd);
+    free(f->path);
+    free(f->burst);
+    free(f->pcm);
+    free(f->noise);
+    free(f);
+    be->priv = NULL;
+}
+
+static ssize_t file_read_iq(sdr_backend_t *be, int16_t *out, size_t cap_pairs)
+{
+    struct sdr_file *f = (struct sdr_file *)be->priv;
+    if (f == NULL || out == NULL) return -1;
+    if (f->ended) return -1;
+    if (!f->started) {
+        f->t0_wall = mono_now_s();
+        f->started = 1;
+    }
+
+    size_t n = cap_pairs < f->max_pairs ? cap_pairs : f->max_pairs;
+    if (n == 0) return 0;
+    if (f->rd != NULL) {
+        ssize_t got = sso_iq_read(f->rd, out, n);
+        if (got == 0) {
+            if (f->rp.once) {
+                fprintf(stderr, "sdr_file: end of %s\n", f->path);
+                f->ended = 1;
+                return -1;
+            }
+            if (sso_iq_seek_pair(f->rd, 0) != 0) return -1;
+            got = sso_iq_read(f->rd, out, n);
+        }
+        if (got <= 0) {
+            fprintf(stderr, "sdr_file: read error in %s\n", f->path);
+            return -1;
+        }
+        n = (size_t)got;
+    } else if (file_synth(f, out, n) != 0) {
+        fprintf(stderr, "sdr_file: burst synthesis failed\n");
+        return -1;
+    }
+
+    double t_end = (double)(f->pairs_out + n) / f->rate;
+    double shift_end = file_shift_hz(f, t_end);
+    if (f->rp.doppler_rate_hz_s != 0.0)
+        sw_nco_apply_ramp(&f->nco, out, n, -shift_end);
+    else if (shift_end != 0.0)
+        sw_nco_apply(&f->nco, out, n);
+    if (f->noise != NULL) file_add_noise(f, out, n);
+    f->pairs_out += n;
+    f->last_n     = n;
+
+    // A radio hands over a block once its last sample has arrived.
+    if (f->rp.speed > 0.0) {
+        double due  = f->t0_wall + t_end / f->rp.speed;
+        double wait = due - mono_now_s();
+        if (wait > 0.0) {
+            struct timespec ts;
+            ts.tv_sec  = (time_t)wait;
+            ts.tv_nsec = (long)((wait - (double)ts.tv_sec) * 1e9);
+            nanosleep(&ts, NULL);
+        }
+    }
+    return (ssize_t)n;
+}
+
+static int file_set_freq(sdr_backend_t *be, double freq_hz)
+{
+    struct sdr_file *f = (struct sdr_file *)be->priv;
+    if (f == NULL) return -1;
+    f->lo_hz = freq_hz;
+    if (f->rp.doppler_rate_hz_s == 0.0)
+        sw_nco_set_freq(&f->nco, -file_shift_hz(f, (double)f->pairs_out / f->rate));
+    return 0;
+}
+
+static double file_get_actual_freq(sdr_backend_t *be)
+{
+    struct sdr_file *f = (struct sdr_file *)be->priv;
+    return f ? f->lo_hz : 0.0;
+}
+
+static int file_set_gain(sdr_backend_t *be, double gain_db)
+{
+    (void)be;
+    (void)gain_db;
+    return 0;
+}
+
+// The stream position is the device clock: exact, and it starts at 0
+// like a UHD time_spec that was never set. Stamps the last read's first
+// pair.
+static int file_rx_meta(sdr_backend_t *be, sdr_rx_meta_t *out)
+{
+    struct sdr_file *f = (struct sdr_file *)be->priv;
+    if (f == NULL || f->last_n == 0) return -1;
+    out->has_time      = 1;
+    out->device_time_s = (double)(f->pairs_out - f->last_n) / f->rate;
+    return 0;
+}
+
+static const sdr_backend_ops_t file_ops = {
+    .name            = "file",
+    .open            = file_open,
+    .close           = file_close,
+    .read_iq         = file_read_iq,
+    .set_freq        = file_set_freq,
+    .get_actual_freq = file_get_actual_freq,
+    .set_gain        = file_set_gain,
+    .tx_burst        = NULL,   // RX-only
+    .rx_meta         = file_rx_meta,
+};
+
+const sdr_backend_ops_t *sdr_backend_file_ops(void)
+{
+    return &file_ops;
+}
@@ -9,8 +9,20 @@
    decimator lands on the same post-decim rate the B210 path uses
    (96 kHz). The device-agnostic DSP in b210_rx_tx_core.c does the rest.
 
-   Synchronous reads only (rtlsdr_read_sync) so the rx_session worker
-   stays the single owner of the device — no async callback thread.
+   Streaming is asynchronous: rtlsdr_read_async runs on a private thread
+   with a configurable number of USB bulk transfers always queued, and
+   its callback only copies each finished transfer into a byte ring.
+   read_iq (on the sdr_capture thread) drains that ring and converts the
+   offset-binary bytes to int16 through a 256-entry table in the same
+   pass. The old read_sync loop had no transfer in flight while it
+   converted and returned, which is where the dongle dropped bytes at
+   the higher rates. A transfer that finds the ring full is dropped whole and
+   reported through rx_meta, pair count included, so the loss shows on
+   the capture row. The stream starts on the first read_iq, so bytes the
+   program was never going to read aren't counted as lost.
+
+   Tuning calls still come from the rx_session worker as libusb control
+   transfers, which are safe alongside the bulk transfers.
 
    Copyright (C) 2026  Johnathan K Burchill
 
@@ -22,19 +34,61 @@
 
 #include "sdr_backend.h"
 
+#include <errno.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include <rtl-sdr.h>
 
+// librtlsdr's own defaults are 15 x 256 KiB: 68 ms a transfer at
+// 1.92 MS/s, coarse for a 96 kHz chain. Twice as many at a quarter the
+// size keeps about the same half second queued on the bus.
+#define RTL_XFERS_DEFAULT       32
+#define RTL_XFER_BYTES_DEFAULT  (64 * 1024)
+#define RTL_XFERS_MAX           256
+#define RTL_XFER_BYTES_MAX      (4 * 1024 * 1024)
+#define RTL_RING_S              0.5    // byte ring between callback and read_iq
+#define RTL_READ_TIMEOUT_S      0.25
+
 struct sdr_rtl {
     rtlsdr_dev_t *dev;
     uint32_t      native_rate;   // achieved sample rate
     double        actual_freq;   // last read-back center freq
-    size_t        max_pairs;     // IQ pairs per read_sync
-    uint8_t      *u8buf;         // read_sync byte buffer (max_pairs * 2)
+    size_t        max_pairs;     // IQ pairs per read_iq
+    uint32_t      xfers;         // USB transfers kept queued
+    uint32_t      xfer_bytes;    // bytes per transfer
+
+    // Offset-binary uint8 [0,255] (128 = 0) -> signed int16. << 7 maps
+    // ±128 to roughly ±16384, leaving headroom below sc16 full-scale.
+    int16_t       lut[256];
+
+    // Byte ring: the async callback owns head, read_iq owns tail; both
+    // count forever (position = count % ring_bytes) and each side reads
+    // the other's with acquire. ring_bytes is even, so a pair never
+    // straddles the wrap.
+    uint8_t      *ring;
+    size_t        ring_bytes;
+    uint64_t      head, tail;
+
+    // read_iq sleeps here when the ring is empty; the callback signals
+    // only when `waiting` says it is.
+    pthread_mutex_t mu;
+    pthread_cond_t  cv;
+    int             waiting;
+    int             sync_init;
+
+    pthread_t     thread;        // runs rtlsdr_read_async
+    int           streaming;     // thread started
+    int           stream_done;   // read_async returned: the stream is over
+    int           stream_rc;
+
+    uint64_t      lost_pending;  // pairs dropped since the last rx_meta
+    uint64_t      lost_total;    // pairs dropped since open
+    uint64_t      lost_xfers;    // transfers dropped since open
 };
 
 static void rtl_close(sdr_backend_t *be);
@@ -107,13 +161,27 @@ static int rtl_open(sdr_backend_t *be, const sdr_open_params_t *p, sdr_caps_t *c
     (void)rtlsdr_set_center_freq(r->dev, (uint32_t)llround(p->freq_hz));
     r->actual_freq = (double)rtlsdr_get_center_freq(r->dev);
 
-    r->max_pairs = 16384;  // 32 KiB per read — a clean USB bulk size
-    r->u8buf = (uint8_t *)malloc(r->max_pairs * 2);
-    if (r->u8buf == NULL) {
-        fprintf(stderr, "sdr_rtlsdr: out of memory for read buffer\n");
+    // Transfer geometry: libusb wants multiples of 512 bytes.
+    r->xfers = p->rtl_xfers > 0 ? (uint32_t)p->rtl_xfers : RTL_XFERS_DEFAULT;
+    if (r->xfers < 2) r->xfers = 2;
+    if (r->xfers > RTL_XFERS_MAX) r->xfers = RTL_XFERS_MAX;
+    size_t xb = p->rtl_xfer_bytes > 0 ? (size_t)p->rtl_xfer_bytes : RTL_XFER_BYTES_DEFAULT;
+    if (xb > RTL_XFER_BYTES_MAX) xb = RTL_XFER_BYTES_MAX;
+    xb = (xb + 511) & ~(size_t)511;
+    r->xfer_bytes = (uint32_t)xb;
+
+    r->max_pairs = 16384;  // 32 KiB of bytes per read_iq
+    r->ring_bytes = (size_t)(r->native_rate * 2.0 * RTL_RING_S) & ~(size_t)1;
+    if (r->ring_bytes < 4 * xb) r->ring_bytes = 4 * xb;
+    r->ring = (uint8_t *)malloc(r->ring_bytes);
+    if (r->ring == NULL) {
+        fprintf(stderr, "sdr_rtlsdr: out of memory for the sample ring\n");
         goto fail;
     }
-    (void)rtlsdr_reset_buffer(r->dev);
+    for (int b = 0; b < 256; b++) r->lut[b] = (int16_t)((b - 128) * 128);
+    pthread_mutex_init(&r->mu, NULL);
+    pthread_cond_init(&r->cv, NULL);
+    r->sync_init = 1;
 
     caps->can_tx             = 0;     // RX-only — no tx_burst op
     caps->native_rate_hz     = (double)r->native_rate;
@@ -126,8 +194,10 @@ static int rtl_open(sdr_backend_t *be, const sdr_open_params_t *p, sdr_caps_t *c
         snprintf(caps->name, sizeof caps->name, "RTL-SDR %.20s", nm ? nm : "");
     }
     fprintf(stderr,
-            "sdr_rtlsdr: open index=%u rate=%u Hz freq=%.6f MHz (RX-only)\n",
-            idx, r->native_rate, r->actual_freq / 1e6);
+            "sdr_rtlsdr: open index=%u rate=%u Hz freq=%.6f MHz "
+            "usb %u x %u KiB (RX-only)\n",
+            idx, r->native_rate, r->actual_freq / 1e6,
+            r->xfers, r->xfer_bytes / 1024u);
     return 0;
 
 fail:
@@ -140,41 +210,155 @@ static void rtl_close(sdr_backend_t *be)
     if (be == NULL) return;
     struct sdr_rtl *r = (struct sdr_rtl *)be->priv;
     if (r == NULL) return;
+    if (r->streaming) {
+        // read_async returns once its transfers are cancelled. A cancel
+        // that lands before the stream is up is ignored, so repeat it.
+        while (!__atomic_load_n(&r->stream_done, __ATOMIC_ACQUIRE)) {
+            (void)rtlsdr_cancel_async(r->dev);
+            struct timespec ts = { 0, 10 * 1000000L };
+            nanosleep(&ts, NULL);
+        }
+        pthread_join(r->thread, NULL);
+    }
+    if (r->lost_xfers > 0) {
+        fprintf(stderr, "sdr_rtlsdr: %llu transfers (%llu pairs) dropped "
+                        "with the ring full\n",
+                (unsigned long long)r->lost_xfers,
+                (unsigned long long)r->lost_total);
+    }
     if (r->dev != NULL) rtlsdr_close(r->dev);
-    free(r->u8buf);
+    if (r->sync_init) {
+        pthread_cond_destroy(&r->cv);
+        pthread_mutex_destroy(&r->mu);
+    }
+    free(r->ring);
     free(r);
     be->priv = NULL;
 }
 
+static void rtl_wake_reader(struct sdr_rtl *r)
+{
+    // seq_cst pairs with read_iq's store of `waiting` and re-check of
+    // head: one of the two always sees the other's write.
+    if (!__atomic_load_n(&r->waiting, __ATOMIC_SEQ_CST)) return;
+    pthread_mutex_lock(&r->mu);
+    pthread_cond_signal(&r->cv);
+    pthread_mutex_unlock(&r->mu);
+}
+
+// libusb event context: one finished transfer. Copy it in or drop it
+// whole; the transfer is resubmitted as soon as this returns.
+static void rtl_async_cb(unsigned char *buf, uint32_t len, void *ctx)
+{
+    struct sdr_rtl *r = (struct sdr_rtl *)ctx;
+    len &= ~1u;
+    if (len == 0) return;
+    uint64_t head = r->head;
+    uint64_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    if (r->ring_bytes - (size_t)(head - tail) < len) {
+        __atomic_add_fetch(&r->lost_pending, len / 2, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&r->lost_total, len / 2, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&r->lost_xfers, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    size_t pos   = (size_t)(head % r->ring_bytes);
+    size_t first = r->ring_bytes - pos;
+    if (first > len) first = len;
+    memcpy(r->ring + pos, buf, first);
+    if (first < len) memcpy(r->ring, buf + first, len - first);
+    __atomic_store_n(&r->head, head + len, __ATOMIC_SEQ_CST);
+    rtl_wake_reader(r);
+}
+
+static void *rtl_stream_fn(void *arg)
+{
+    struct sdr_rtl *r = (struct sdr_rtl *)arg;
+    int rc = rtlsdr_read_async(r->dev, rtl_async_cb, r, r->xfers, r->xfer_bytes);
+    __atomic_store_n(&r->stream_rc, rc, __ATOMIC_RELAXED);
+    __atomic_store_n(&r->stream_done, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&r->mu);
+    pthread_cond_signal(&r->cv);
+    pthread_mutex_unlock(&r->mu);
+    return NULL;
+}
+
+static int rtl_start_stream(struct sdr_rtl *r)
+{
+    (void)rtlsdr_reset_buffer(r->dev);
+    if (pthread_create(&r->thread, NULL, rtl_stream_fn, r) != 0) {
+        fprintf(stderr, "sdr_rtlsdr: pthread_create failed\n");
+        return -1;
+    }
+    r->streaming = 1;
+    return 0;
+}
+
+// Wait up to RTL_READ_TIMEOUT_S for the callback to publish more bytes.
+static void rtl_wait_data(struct sdr_rtl *r, uint64_t tail)
+{
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    long ns = (long)(RTL_READ_TIMEOUT_S * 1e9);
+    until.tv_nsec += ns;
+    while (until.tv_nsec >= 1000000000L) { until.tv_sec++; until.tv_nsec -= 1000000000L; }
+    pthread_mutex_lock(&r->mu);
+    __atomic_store_n(&r->waiting, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&r->head, __ATOMIC_SEQ_CST) == tail
+           && !__atomic_load_n(&r->stream_done, __ATOMIC_SEQ_CST)) {
+        if (pthread_cond_timedwait(&r->cv, &r->mu, &until) == ETIMEDOUT) break;
+    }
+    __atomic_store_n(&r->waiting, 0, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&r->mu);
+}
+
+static void rtl_convert(const int16_t *lut, const uint8_t *in, size_t n, int16_t *out)
+{
+    for (size_t i = 0; i < n; i++) out[i] = lut[in[i]];
+}
+
 static ssize_t rtl_read_iq(sdr_backend_t *be, int16_t *out, size_t cap_pairs)
 {
     struct sdr_rtl *r = (struct sdr_rtl *)be->priv;
     if (r == NULL || r->dev == NULL || out == NULL) return -1;
+    if (!r->streaming && rtl_start_stream(r) != 0) return -1;
 
-    size_t pairs = cap_pairs < r->max_pairs ? cap_pairs : r->max_pairs;
-    // libusb bulk transfers want a length that is a multiple of 512
-    // bytes; floor to that (256 pairs), keeping at least one block.
-    size_t bytes = (pairs * 2) & ~((size_t)511);
-    if (bytes == 0) bytes = 512;
-
-    int n_read = 0;
-    int rc = rtlsdr_read_sync(r->dev, r->u8buf, (int)bytes, &n_read);
-    if (rc != 0) {
-        // Transient (USB hiccup); log and let the caller keep looping.
-        fprintf(stderr, "sdr_rtlsdr: read_sync error %d\n", rc);
-        return 0;
+    uint64_t tail = r->tail;
+    uint64_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        rtl_wait_data(r, tail);
+        head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            if (!__atomic_load_n(&r->stream_done, __ATOMIC_ACQUIRE)) return 0;
+            // Dongle unplugged, or the stream never started.
+            fprintf(stderr, "sdr_rtlsdr: read_async ended (%d)\n",
+                    __atomic_load_n(&r->stream_rc, __ATOMIC_RELAXED));
+            return -1;
+        }
     }
-    if (n_read <= 0) return 0;
 
-    size_t got = (size_t)n_read / 2;       // IQ pairs actually read
-    if (got > cap_pairs) got = cap_pairs;
-    // Offset-binary uint8 [0,255] (128 = 0) -> signed int16. << 7 maps
-    // ±128 to roughly ±16384, leaving headroom below sc16 full-scale.
-    for (size_t i = 0; i < got; i++) {
-        out[2 * i + 0] = (int16_t)(((int)r->u8buf[2 * i + 0] - 128) << 7);
-        out[2 * i + 1] = (int16_t)(((int)r->u8buf[2 * i + 1] - 128) << 7);
-    }
-    return (ssize_t)got;
+    size_t pairs = (size_t)(head - tail) / 2;
+    if (pairs > cap_pairs)    pairs = cap_pairs;
+    if (pairs > r->max_pairs) pairs = r->max_pairs;
+    size_t bytes = pairs * 2;
+    size_t pos   = (size_t)(tail % r->ring_bytes);
+    size_t first = r->ring_bytes - pos;
+    if (first > bytes) first = bytes;
+    rtl_convert(r->lut, r->ring + pos, first, out);
+    if (first < bytes) rtl_convert(r->lut, r->ring, bytes - first, out + first);
+    __atomic_store_n(&r->tail, tail + bytes, __ATOMIC_RELEASE);
+    return (ssize_t)pairs;
+}
+
+// Transfers the callback dropped since the last call; the samples read
+// since then sit after the gap, give or take the bytes already queued.
+static int rtl_rx_meta(sdr_backend_t *be, sdr_rx_meta_t *out)
+{
+    struct sdr_rtl *r = (struct sdr_rtl *)be->priv;
+    if (r == NULL) return -1;
+    uint64_t lost = __atomic_exchange_n(&r->lost_pending, 0, __ATOMIC_RELAXED);
+    out->overflow = lost > 0;
+    out->dropped  = lost;
+    return 0;
 }
 
 static int rtl_set_freq(sdr_backend_t *be, double freq_hz)
@@ -208,6 +392,7 @@ static const sdr_backend_ops_t rtl_ops = {
     .get_actual_freq = rtl_get_actual_freq,
     .set_gain        = rtl_set_gain,
     .tx_burst        = NULL,   // RX-only
+    .rx_meta         = rtl_rx_meta,
 };
 
 const sdr_backend_ops_t *sdr_backend_rtlsdr_ops(void)
@@ -61,6 +61,11 @@ struct sdr_uhd {
     unsigned long           recv_err_run;
     unsigned long           md_err_run;
 
+    // What the last recv's metadata said, for rx_meta: an overflow latched
+    // until reported, and the first sample's time_spec.
+    int                     rx_overflow;
+    size_t                  rx_last_n;
+
     // Serializes access to the device handle (the UHD property tree) across
     // the RX worker and the TX-burst thread. The two streamers run
     // full-duplex -- RX recv and TX send touch their own streamer objects
@@ -332,6 +337,7 @@ static ssize_t uhd_read_iq(sdr_backend_t *be, int16_t *out, size_t cap_pairs)
 
     void  *bufs[1] = { out };
     size_t n_recv = 0;
+    u->rx_last_n = 0;
     // 1.0 s timeout: while streaming, recv returns as soon as a chunk is
     // ready (every few ms), so the timeout only bites when the device
     // has stopped delivering — i.e. it was unplugged or the transport
@@ -379,14 +385,37 @@ static ssize_t uhd_read_iq(sdr_backend_t *be, int16_t *out, size_t cap_pairs)
                     u->md_err_run > 0 ? " (repeating)" : "");
         }
         u->md_err_run++;
+        if (mderr == UHD_RX_METADATA_ERROR_CODE_OVERFLOW) u->rx_overflow = 1;
         // Overflow / late-packet are non-fatal — the samples we DID get
         // are already in the buffer; demod them rather than dropping.
     } else {
         u->md_err_run = 0;
     }
+    u->rx_last_n = n_recv;
     return (ssize_t)n_recv;
 }
 
+// Reads u->md, which only the RX thread touches (see uhd_read_iq).
+static int uhd_rx_meta(sdr_backend_t *be, sdr_rx_meta_t *out)
+{
+    struct sdr_uhd *u = (struct sdr_uhd *)be->priv;
+    if (u == NULL || u->md == NULL) return -1;
+    out->overflow  = u->rx_overflow;
+    u->rx_overflow = 0;
+    bool has_time = false;
+    if (u->rx_last_n > 0
+        && uhd_rx_metadata_has_time_spec(u->md, &has_time) == UHD_ERROR_NONE
+        && has_time) {
+        int64_t full = 0;
+        double  frac = 0.0;
+        if (uhd_rx_metadata_time_spec(u->md, &full, &frac) == UHD_ERROR_NONE) {
+            out->has_time      = 1;
+            out->device_time_s = (double)full + frac;
+        }
+    }
+    return 0;
+}
+
 static int uhd_set_freq(sdr_backend_t *be, double freq_hz)
 {
     struct sdr_uhd *u = (struct sdr_uhd *)be->priv;
@@ -692,6 +721,7 @@ static const sdr_backend_ops_t uhd_ops = {
     .get_actual_freq = uhd_get_actual_freq,
     .set_gain        = uhd_set_gain,
     .tx_burst        = uhd_tx_burst,
+    .rx_meta         = uhd_rx_meta,
 };
 
 const sdr_backend_ops_t *sdr_backend_uhd_ops(void)
@@ -211,6 +211,16 @@ typedef struct {
     char    rx_ribbon[SSO_RIBBON_MAX + 1];  // '.' / '-' chars per second + nul
     int8_t  rx_ribbon_peak[SSO_RIBBON_MAX]; // peak dBFS per second (parallel)
     char    rx_warning[80];                  // optional rx-panel warning row
+    // Live bulk_file reassembly (rx_bk_active = 0 => nothing on the wire).
+    int     rx_bk_active;
+    int     rx_bk_file;                      // 1-based file number this session
+    int     rx_bk_eof;                       // 1 => rx_bk_extent is the file size
+    long    rx_bk_present;                   // bytes held
+    long    rx_bk_extent;                    // highest byte seen
+    long    rx_bk_conflicts;
+    int     rx_bk_gaps;                      // missing packet ranges in total
+    double  rx_bk_rate;                      // goodput, bytes/s
+    char    rx_bk_missing[96];               // "offset+len ..." (first ranges)
 
     // Live audio relay — see §9 of docs/VIEWER_STREAM_JSON.md.
     //   audio-ctl    : viewer -> relay (stdin) -> operator (IPC)
@@ -627,6 +627,25 @@ int sso_event_encode(const sso_event_t *evt, char *out, size_t out_size) {
                 if (json_field_str(&p, end, &first, "rx_rb_p", hex) < 0)
                     return -1;
             }
+            // Live bulk_file reassembly, only while a download is in.
+            if (evt->rx_bk_active) {
+                if (json_field_int   (&p, end, &first, "rx_bk_f",  evt->rx_bk_file) < 0) return -1;
+                if (json_field_int   (&p, end, &first, "rx_bk_n",  evt->rx_bk_present) < 0) return -1;
+                if (json_field_int   (&p, end, &first, "rx_bk_x",  evt->rx_bk_extent) < 0) return -1;
+                if (evt->rx_bk_eof) {
+                    if (json_field_bool(&p, end, &first, "rx_bk_eof", 1) < 0) return -1;
+                }
+                if (json_field_int   (&p, end, &first, "rx_bk_g",  evt->rx_bk_gaps) < 0) return -1;
+                if (json_field_double(&p, end, &first, "rx_bk_r",  evt->rx_bk_rate) < 0) return -1;
+                if (evt->rx_bk_conflicts) {
+                    if (json_field_int(&p, end, &first, "rx_bk_c",
+                                       evt->rx_bk_conflicts) < 0) return -1;
+                }
+                if (evt->rx_bk_missing[0]) {
+                    if (json_field_str(&p, end, &first, "rx_bk_m",
+                                       evt->rx_bk_missing) < 0) return -1;
+                }
+            }
         }
     }
     // rx-stats fields
@@ -886,6 +905,18 @@ int sso_event_decode(const char *line, sso_event_t *evt) {
                         sizeof evt->rx_pt_summary[s]);
     }
     json_get_string(line, line_len, "rx_warn", evt->rx_warning, sizeof evt->rx_warning);
+    // rx_bk_f is always present while a bulk download is being tracked.
+    if (json_get_int(line, line_len, "rx_bk_f", &rx_long) > 0) {
+        evt->rx_bk_active = 1;
+        evt->rx_bk_file   = (int) rx_long;
+    }
+    if (json_get_int(line, line_len, "rx_bk_n", &rx_long) > 0) evt->rx_bk_present = rx_long;
+    if (json_get_int(line, line_len, "rx_bk_x", &rx_long) > 0) evt->rx_bk_extent = rx_long;
+    if (json_get_bool(line, line_len, "rx_bk_eof", &rx_flag) > 0) evt->rx_bk_eof = rx_flag;
+    if (json_get_int(line, line_len, "rx_bk_g", &rx_long) > 0) evt->rx_bk_gaps = (int) rx_long;
+    json_get_double(line, line_len, "rx_bk_r", &evt->rx_bk_rate);
+    if (json_get_int(line, line_len, "rx_bk_c", &rx_long) > 0) evt->rx_bk_conflicts = rx_long;
+    json_get_string(line, line_len, "rx_bk_m", evt->rx_bk_missing, sizeof evt->rx_bk_missing);
     if (json_get_string(line, line_len, "rx_rb",
                         evt->rx_ribbon, sizeof evt->rx_ribbon) > 0) {
         evt->rx_ribbon_n = (int) strlen(evt->rx_ribbon);
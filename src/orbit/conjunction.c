@@ -23,7 +23,10 @@
 
 #include "conjunction.h"
 
+#include <float.h>
 #include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 // --- small 3-vector helpers -------------------------------------------------
 
@@ -244,3 +247,200 @@ double conj_foster_pc(const double r_rel[3], const double v_rel[3],
 
     return conj_foster_pc_principal(sqrt(l1), sqrt(l2), xm, ym, R);
 }
+
+// --- TCA refinement ---------------------------------------------------------
+
+// Brent-Dekker: keep a bracket [b, c] with f(b), f(c) of opposite sign, try
+// inverse quadratic interpolation (secant when only two points are distinct),
+// and fall back to bisection whenever the interpolated step would leave the
+// bracket or fails to shrink it fast enough.
+double conj_brent_root(conj_scalar_fn f, void *ctx, double a, double b,
+                       double fa, double fb, double tol, int max_evals)
+{
+    if ((fa > 0.0 && fb > 0.0) || (fa < 0.0 && fb < 0.0)) return NAN;
+    if (fa == 0.0) return a;
+    if (fb == 0.0) return b;
+    double c = b, fc = fb, d = b - a, e = d;
+    for (int it = 0; it < max_evals; ++it) {
+        if ((fb > 0.0 && fc > 0.0) || (fb < 0.0 && fc < 0.0)) {
+            c = a; fc = fa;                 // re-bracket on the old point
+            d = e = b - a;
+        }
+        if (fabs(fc) < fabs(fb)) {          // b is always the best estimate
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+        }
+        double tol1 = 2.0 * DBL_EPSILON * fabs(b) + 0.5 * tol;
+        double xm = 0.5 * (c - b);
+        if (fabs(xm) <= tol1 || fb == 0.0) return b;
+        if (fabs(e) >= tol1 && fabs(fa) > fabs(fb)) {
+            double s = fb / fa, p, q;
+            if (a == c) {
+                p = 2.0 * xm * s;
+                q = 1.0 - s;
+            } else {
+                double qa = fa / fc, r = fb / fc;
+                p = s * (2.0 * xm * qa * (qa - r) - (b - a) * (r - 1.0));
+                q = (qa - 1.0) * (r - 1.0) * (s - 1.0);
+            }
+            if (p > 0.0) q = -q;
+            p = fabs(p);
+            double min1 = 3.0 * xm * q - fabs(tol1 * q);
+            double min2 = fabs(e * q);
+            if (2.0 * p < (min1 < min2 ? min1 : min2)) {
+                e = d;
+                d = p / q;
+            } else {
+                d = xm;
+                e = d;
+            }
+        } else {
+            d = xm;
+            e = d;
+        }
+        a = b;
+        fa = fb;
+        b += fabs(d) > tol1 ? d : (xm > 0.0 ? tol1 : -tol1);
+        fb = f(b, ctx);
+    }
+    return b;
+}
+
+// --- catalog screening ------------------------------------------------------
+
+int conj_shells_overlap(double peri1, double apo1,
+                        double peri2, double apo2, double pad_km)
+{
+    if (peri1 - apo2 > pad_km) return 0;   // object 1 always above object 2
+    if (peri2 - apo1 > pad_km) return 0;   // object 2 always above object 1
+    return 1;
+}
+
+// Open-addressed table of occupied cells; each cell heads a singly linked
+// list of its points through next[]. Cell coordinates are biased into 21
+// bits per axis and packed into one 64-bit key -- 2^20 cells either side of
+// the origin covers GEO at sub-km cell sizes.
+#define GRID_AXIS_BIAS  (1 << 20)
+#define GRID_AXIS_MASK  ((1u << 21) - 1u)
+
+struct conj_grid {
+    size_t    cap;        // max points
+    size_t    mask;       // table size - 1 (power of two >= 2 * cap)
+    uint64_t *keys;       // cell key per slot
+    int32_t  *head;       // first point in the slot's cell, -1 = empty slot
+    int32_t  *next;       // next point in the same cell, -1 = end
+    size_t   *used;       // occupied slot indices, in insertion order
+    size_t    n_used;
+};
+
+static uint64_t grid_key(int64_t ix, int64_t iy, int64_t iz)
+{
+    return ((uint64_t) ((ix + GRID_AXIS_BIAS) & GRID_AXIS_MASK) << 42)
+         | ((uint64_t) ((iy + GRID_AXIS_BIAS) & GRID_AXIS_MASK) << 21)
+         |  (uint64_t) ((iz + GRID_AXIS_BIAS) & GRID_AXIS_MASK);
+}
+
+static size_t grid_slot(const conj_grid_t *g, uint64_t key)
+{
+    uint64_t x = key * 0x9E3779B97F4A7C15ull;
+    size_t h = (size_t) (x ^ (x >> 32)) & g->mask;
+    while (g->head[h] >= 0 && g->keys[h] != key) h = (h + 1) & g->mask;
+    return h;
+}
+
+conj_grid_t *conj_grid_new(size_t max_points)
+{
+    if (max_points == 0 || max_points > (size_t) INT32_MAX / 2) return NULL;
+    conj_grid_t *g = calloc(1, sizeof *g);
+    if (g == NULL) return NULL;
+    size_t tsize = 16;
+    while (tsize < 2 * max_points) tsize <<= 1;
+    g->cap  = max_points;
+    g->mask = tsize - 1;
+    g->keys = malloc(tsize * sizeof *g->keys);
+    g->head = malloc(tsize * sizeof *g->head);
+    g->next = malloc(max_points * sizeof *g->next);
+    g->used = malloc(max_points * sizeof *g->used);
+    if (!g->keys || !g->head || !g->next || !g->used) {
+        conj_grid_free(g);
+        return NULL;
+    }
+    for (size_t i = 0; i < tsize; ++i) g->head[i] = -1;
+    return g;
+}
+
+void conj_grid_free(conj_grid_t *g)
+{
+    if (g == NULL) return;
+    free(g->keys);
+    free(g->head);
+    free(g->next);
+    free(g->used);
+    free(g);
+}
+
+// Half of the 26 neighbouring cell offsets: each touching pair of cells is
+// visited from exactly one side, so every point pair comes out once.
+static const int GRID_FWD[13][3] = {
+    { 1, -1, -1 }, { 1, -1, 0 }, { 1, -1, 1 },
+    { 1,  0, -1 }, { 1,  0, 0 }, { 1,  0, 1 },
+    { 1,  1, -1 }, { 1,  1, 0 }, { 1,  1, 1 },
+    { 0,  1, -1 }, { 0,  1, 0 }, { 0,  1, 1 },
+    { 0,  0,  1 },
+};
+
+static void grid_emit(size_t a, size_t b, conj_pair_fn fn, void *ctx)
+{
+    if (a < b) fn(a, b, ctx);
+    else       fn(b, a, ctx);
+}
+
+int conj_grid_pairs(conj_grid_t *g, const float *xyz, size_t n,
+                    double cell_km, conj_pair_fn fn, void *ctx)
+{
+    if (g == NULL || fn == NULL || n > g->cap || !(cell_km > 0.0)) return -1;
+    double inv = 1.0 / cell_km;
+
+    // Clear only the slots the previous call touched.
+    for (size_t u = 0; u < g->n_used; ++u) g->head[g->used[u]] = -1;
+    g->n_used = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!isfinite(xyz[3 * i]) || !isfinite(xyz[3 * i + 1])
+            || !isfinite(xyz[3 * i + 2])) continue;
+        uint64_t key = grid_key((int64_t) floor(xyz[3 * i + 0] * inv),
+                                (int64_t) floor(xyz[3 * i + 1] * inv),
+                                (int64_t) floor(xyz[3 * i + 2] * inv));
+        size_t h = grid_slot(g, key);
+        if (g->head[h] < 0) {
+            g->keys[h] = key;
+            g->used[g->n_used++] = h;
+        }
+        g->next[i] = g->head[h];
+        g->head[h] = (int32_t) i;
+    }
+
+    for (size_t u = 0; u < g->n_used; ++u) {
+        size_t h = g->used[u];
+        // Pairs inside the cell.
+        for (int32_t a = g->head[h]; a >= 0; a = g->next[a])
+            for (int32_t b = g->next[a]; b >= 0; b = g->next[b])
+                grid_emit((size_t) a, (size_t) b, fn, ctx);
+        // Pairs with the forward half of the neighbourhood.
+        uint64_t key = g->keys[h];
+        int64_t ix = (int64_t) ((key >> 42) & GRID_AXIS_MASK);
+        int64_t iy = (int64_t) ((key >> 21) & GRID_AXIS_MASK);
+        int64_t iz = (int64_t) ( key        & GRID_AXIS_MASK);
+        for (int d = 0; d < 13; ++d) {
+            uint64_t nk = grid_key(ix + GRID_FWD[d][0] - GRID_AXIS_BIAS,
+                                   iy + GRID_FWD[d][1] - GRID_AXIS_BIAS,
+                                   iz + GRID_FWD[d][2] - GRID_AXIS_BIAS);
+            size_t nh = grid_slot(g, nk);
+            if (g->head[nh] < 0) continue;
+            for (int32_t a = g->head[h]; a >= 0; a = g->next[a])
+                for (int32_t b = g->head[nh]; b >= 0; b = g->next[b])
+                    grid_emit((size_t) a, (size_t) b, fn, ctx);
+        }
+    }
+    return 0;
+}
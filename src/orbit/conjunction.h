@@ -29,6 +29,8 @@
 #ifndef SSO_ORBIT_CONJUNCTION_H
 #define SSO_ORBIT_CONJUNCTION_H
 
+#include <stddef.h>
+
 // Build the RTN (radial / along-track / cross-track) unit axes of an object
 // from its ECI position r and velocity v (km, km/s), each written as a 3-vector
 // in ECI:
@@ -86,4 +88,51 @@ double conj_foster_pc_principal(double sx, double sy,
 double conj_foster_pc(const double r_rel[3], const double v_rel[3],
                       const double cov[9], double R);
 
+// ---- TCA refinement ---------------------------------------------------------
+//
+// The time of closest approach is where the range rate r_rel . v_rel crosses
+// zero from below. The propagator hands out velocity with position, so the
+// finder roots that function instead of minimising the distance: Brent's
+// method converges superlinearly on the smooth crossing where golden-section
+// search only shrinks the bracket by 0.618 per evaluation.
+
+typedef double (*conj_scalar_fn)(double x, void *ctx);
+
+// Root of f in [a, b] by Brent's method, given fa = f(a) and fb = f(b) of
+// opposite sign (or either zero). Stops once the bracket is within tol (in
+// x's units) or after max_evals further evaluations of f. Returns NAN when
+// fa and fb have the same sign.
+double conj_brent_root(conj_scalar_fn f, void *ctx, double a, double b,
+                       double fa, double fb, double tol, int max_evals);
+
+// ---- catalog screening ------------------------------------------------------
+//
+// Building blocks for screening one object against many (or all against all)
+// on a shared time grid: a radial shell test that drops pairs whose orbits can
+// never come within reach, and a uniform 3-D spatial hash that turns the
+// O(N^2) pair search at each grid time into "pairs in touching cells".
+
+// 1 if two objects' radial shells [peri, apo] (km from Earth's centre) come
+// within pad_km of each other, i.e. the pair could possibly meet. 0 if one
+// orbit lies wholly above the other by more than pad_km.
+int conj_shells_overlap(double peri1, double apo1,
+                        double peri2, double apo2, double pad_km);
+
+// Reusable spatial hash for up to max_points positions. Allocate once per
+// thread and call conj_grid_pairs at every grid time.
+typedef struct conj_grid conj_grid_t;
+typedef void (*conj_pair_fn)(size_t i, size_t j, void *ctx);
+
+conj_grid_t *conj_grid_new(size_t max_points);
+void         conj_grid_free(conj_grid_t *g);
+
+// Bin the n positions xyz[3*i .. 3*i+2] (km) into cubic cells of side cell_km
+// and call fn(i, j, ctx) once for every unordered pair (i < j) whose cells
+// touch (share a face, edge or corner). That is a superset of the pairs
+// closer than cell_km, so fn applies the exact distance test. Points with a
+// non-finite coordinate (a failed propagation) are skipped. Returns 0, or
+// -1 when n exceeds the grid's capacity or cell_km is not positive.
+int conj_grid_pairs(conj_grid_t *g, const float *xyz, size_t n,
+                    double cell_km, conj_pair_fn fn, void *ctx);
+
 #endif // SSO_ORBIT_CONJUNCTION_H
@@ -0,0 +1,195 @@
+/*
+
+    Simple Satellite Operations  src/orbit/decay.c
+
+    Adaptive-step orbit-decay engine. See decay.h.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "decay.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Lattice points per sgp4_propagate_grid call in the re-entry scan.
+#define DECAY_SCAN_BLOCK 256
+
+// Geodetic altitude of the k-th point of an n-point SoA position block.
+static double soa_altitude(const double *pos, int n, int k, double jul)
+{
+    vector_t p = { pos[k], pos[n + k], pos[2 * n + k], 0.0 };
+    geodetic_t geo;
+    Calculate_LatLonAlt(jul, &p, &geo);
+    return geo.alt;
+}
+
+// NaN (SGP4 past the point of no return) counts as below the threshold.
+static int below(double alt_km, double min_alt_km)
+{
+    return !(alt_km > min_alt_km);
+}
+
+// Sample one revolution starting at jul into *s.
+static void sample_rev(const sgp4_ctx_t *ctx, double jul, double rev_min,
+                       double jul_start, decay_sample_t *s, long *evals)
+{
+    double pos[3 * DECAY_REV_SAMPLES];
+    double dt_sec = rev_min * 60.0 / DECAY_REV_SAMPLES;
+    sgp4_propagate_grid(ctx, jul, dt_sec, DECAY_REV_SAMPLES, pos, NULL);
+    *evals += DECAY_REV_SAMPLES;
+
+    double lo = INFINITY, hi = -INFINITY, sum = 0.0;
+    for (int k = 0; k < DECAY_REV_SAMPLES; ++k) {
+        double alt = soa_altitude(pos, DECAY_REV_SAMPLES, k,
+                                  jul + k * dt_sec / 86400.0);
+        if (isnan(alt)) { lo = alt; break; }
+        if (alt < lo) lo = alt;
+        if (alt > hi) hi = alt;
+        sum += alt;
+    }
+    s->years = (jul - jul_start) / 365.25;
+    s->alt_min_km = lo;
+    s->alt_mean_km = isnan(lo) ? lo : sum / DECAY_REV_SAMPLES;
+    s->alt_max_km = isnan(lo) ? lo : hi;
+}
+
+// Walk the lattice jul_start + k * step from k_lo through k_hi (inclusive)
+// and return the first k at or below the threshold, or -1. The altitude
+// found there goes to *alt_out.
+static long scan_lattice(const sgp4_ctx_t *ctx, double jul_start,
+                         double step_min, long k_lo, long k_hi,
+                         double min_alt_km, double *alt_out, long *evals)
+{
+    double pos[3 * DECAY_SCAN_BLOCK];
+    double step_days = step_min / 1440.0;
+    for (long base = k_lo; base <= k_hi; base += DECAY_SCAN_BLOCK) {
+        int m = (int) ((k_hi - base + 1) < DECAY_SCAN_BLOCK ? (k_hi - base + 1)
+                                                            : DECAY_SCAN_BLOCK);
+        double jul0 = jul_start + (double) base * step_days;
+        sgp4_propagate_grid(ctx, jul0, step_min * 60.0, m, pos, NULL);
+        *evals += m;
+        for (int k = 0; k < m; ++k) {
+            double alt = soa_altitude(pos, m, k,
+                                      jul_start + (double) (base + k) * step_days);
+            if (below(alt, min_alt_km)) {
+                *alt_out = alt;
+                return base + k;
+            }
+        }
+    }
+    return -1;
+}
+
+static int push_sample(decay_result_t *r, size_t *cap, const decay_sample_t *s)
+{
+    if (r->n_samples == *cap) {
+        size_t ncap = *cap ? *cap * 2 : 256;
+        decay_sample_t *grown = realloc(r->samples, ncap * sizeof *grown);
+        if (grown == NULL) return -1;
+        r->samples = grown;
+        *cap = ncap;
+    }
+    r->samples[r->n_samples++] = *s;
+    return 0;
+}
+
+int decay_lifetime(const sgp4_ctx_t *ctx, double jul_start,
+                   const decay_opts_t *opts, decay_result_t *out)
+{
+    memset(out, 0, sizeof *out);
+    if (opts->max_years <= 0.0 || opts->scan_step_min <= 0.0 || ctx->tle.xno <= 0.0)
+        return -1;
+    double max_step = opts->max_step_days > 0.0 ? opts->max_step_days : DECAY_MAX_STEP_DAYS;
+    double step_alt = opts->step_alt_km > 0.0 ? opts->step_alt_km : DECAY_STEP_ALT_KM;
+    double min_alt = opts->min_alt_km;
+
+    // Revolution length from the epoch mean motion (rad/min). Drag only
+    // shortens it, so one sample window always spans a whole revolution.
+    double rev_min = 2.0 * M_PI / ctx->tle.xno;
+    double rev_days = rev_min / 1440.0;
+    double end_days = opts->max_years * 365.25;
+    // Last lattice index still inside max_years, as the brute-force loop
+    // would count it.
+    long k_end = (long) ceil(end_days * 1440.0 / opts->scan_step_min) - 1;
+    size_t cap = 0;
+
+    decay_sample_t s, prev = {0};
+    double t = 0.0, t_prev = 0.0;   // days since jul_start
+    int have_prev = 0;
+    sample_rev(ctx, jul_start, rev_min, jul_start, &s, &out->evaluations);
+    if (push_sample(out, &cap, &s) != 0) goto oom;
+
+    for (;;) {
+        if (below(s.alt_min_km, min_alt) || t >= end_days) {
+            // The crossing lies between the previous sample and the end of
+            // this one's revolution: find it on the fine lattice.
+            long k_lo = have_prev ? (long) floor(t_prev * 1440.0 / opts->scan_step_min) : 0;
+            long k_hi = (long) ceil((t + rev_days) * 1440.0 / opts->scan_step_min);
+            if (k_hi > k_end) k_hi = k_end;
+            double alt = NAN;
+            long k = scan_lattice(ctx, jul_start, opts->scan_step_min, k_lo, k_hi,
+                                  min_alt, &alt, &out->evaluations);
+            if (k >= 0) {
+                decay_sample_t last = { (double) k * opts->scan_step_min / 1440.0 / 365.25,
+                                        alt, alt, alt };
+                if (push_sample(out, &cap, &last) != 0) goto oom;
+                out->years = last.years;
+                out->reentered = 1;
+                return 0;
+            }
+            if (t >= end_days) {
+                out->years = opts->max_years;
+                return 0;
+            }
+            // The revolution sample dipped between lattice points only;
+            // keep going a revolution at a time.
+        }
+
+        double step = rev_days;
+        if (have_prev && s.alt_min_km >= min_alt + DECAY_SCAN_MARGIN_KM) {
+            double rate = (prev.alt_mean_km - s.alt_mean_km) / (t - t_prev);   // km/day
+            if (rate > 0.0) {
+                step = step_alt / rate;
+                // Never jump more than half way to the threshold at this rate.
+                double half_way = 0.5 * (s.alt_min_km - min_alt) / rate;
+                if (step > half_way) step = half_way;
+            } else {
+                step = max_step;
+            }
+            if (step > max_step) step = max_step;
+            if (step < rev_days) step = rev_days;
+        }
+        prev = s;
+        t_prev = t;
+        have_prev = 1;
+        t += step;
+        if (t > end_days) t = end_days;
+        sample_rev(ctx, jul_start + t, rev_min, jul_start, &s, &out->evaluations);
+        if (push_sample(out, &cap, &s) != 0) goto oom;
+    }
+
+oom:
+    decay_result_free(out);
+    return -1;
+}
+
+void decay_result_free(decay_result_t *r)
+{
+    free(r->samples);
+    memset(r, 0, sizeof *r);
+}
@@ -0,0 +1,82 @@
+/*
+
+    Simple Satellite Operations  src/orbit/decay.h
+
+    Adaptive-step orbit-decay engine behind the lifetime tool. Instead of
+    evaluating SGP4 every minute for years, it samples one revolution at
+    each step, steps on the revolution-averaged altitude decay (large steps
+    while the orbit barely changes, single revolutions near re-entry), and
+    finishes with a scan on the caller's fine time lattice so the re-entry
+    time agrees with a minute-by-minute run. The output is a decimated
+    altitude series, one point per step.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SSO_ORBIT_DECAY_H
+#define SSO_ORBIT_DECAY_H
+
+#include <stddef.h>
+#include <sgp4sdp4.h>
+
+// Largest step between revolution samples, days.
+#define DECAY_MAX_STEP_DAYS 10.0
+// Target drop in revolution-mean altitude per step, km.
+#define DECAY_STEP_ALT_KM 1.0
+// Once the lowest altitude of a sampled revolution is within this much of
+// the threshold, step one revolution at a time.
+#define DECAY_SCAN_MARGIN_KM 25.0
+// Points per sampled revolution.
+#define DECAY_REV_SAMPLES 64
+
+// One point of the decimated series: geodetic altitude over one revolution
+// starting at `years` (365.25-day years since the run's start).
+typedef struct {
+    double years;
+    double alt_min_km;
+    double alt_mean_km;
+    double alt_max_km;
+} decay_sample_t;
+
+typedef struct {
+    double max_years;      // stop (and report survival) after this long
+    double min_alt_km;     // re-entry threshold, geodetic altitude
+    double scan_step_min;  // fine lattice for the re-entry scan, minutes
+    double max_step_days;  // 0 => DECAY_MAX_STEP_DAYS
+    double step_alt_km;    // 0 => DECAY_STEP_ALT_KM
+} decay_opts_t;
+
+typedef struct {
+    double years;             // time above min_alt_km, max_years if it survived
+    int reentered;            // 1 if the threshold was crossed within max_years
+    decay_sample_t *samples;  // malloc'd series; free with decay_result_free()
+    size_t n_samples;
+    long evaluations;         // SGP4/SDP4 evaluations spent
+} decay_result_t;
+
+// Run the engine for ctx (from sgp4_ctx_init) starting at Julian date
+// jul_start. The re-entry time is the first point of the lattice
+// jul_start + k * scan_step_min whose geodetic altitude is at or below
+// min_alt_km, as a minute-by-minute loop would find it, provided the dip
+// shows in the revolution sampled at the step that crosses. Uses only the
+// per-thread SGP4/SDP4 state, so separate threads may run separate objects.
+// Returns 0, or -1 on bad options or allocation failure (out left empty).
+int decay_lifetime(const sgp4_ctx_t *ctx, double jul_start,
+                   const decay_opts_t *opts, decay_result_t *out);
+
+void decay_result_free(decay_result_t *r);
+
+#endif // SSO_ORBIT_DECAY_H
@@ -527,9 +527,15 @@ int oem_sample_at(const oem_table_t *t, double jul_utc,
     }
     const oem_sample_t *a = &t->samples[i];
     const oem_sample_t *b = &t->samples[i + 1];
+    if (b->jul_utc - a->jul_utc <= 0.0) return -1;
+    oem_hermite(a, b, jul_utc, r_ecef, v_ecef);
+    return 0;
+}
 
+void oem_hermite(const oem_sample_t *a, const oem_sample_t *b,
+                 double jul_utc, double r_ecef[3], double v_ecef[3])
+{
     double dt_days = b->jul_utc - a->jul_utc;
-    if (dt_days <= 0.0) return -1;
     double dt_sec = dt_days * 86400.0;
     double u = (jul_utc - a->jul_utc) / dt_days;
     if (u < 0.0) u = 0.0;
@@ -559,7 +565,6 @@ int oem_sample_at(const oem_table_t *t, double jul_utc,
                   +  dh01 * b->r_ecef[k]
                   +  dh11 * dt_sec * b->v_ecef[k]) / dt_sec;
     }
-    return 0;
 }
 
 void oem_free(oem_table_t *t)
@@ -63,6 +63,12 @@ int oem_load_from_ssm(const char *trajectory_id, oem_table_t *out);
 int oem_sample_at(const oem_table_t *t, double jul_utc,
                   double r_ecef[3], double v_ecef[3]);
 
+// Cubic Hermite state between two bracketing samples (position, with
+// velocity as its derivative). jul_utc is clamped to [a, b]. Shared by
+// oem_sample_at and prediction.c's per-pass ephemeris cache.
+void oem_hermite(const oem_sample_t *a, const oem_sample_t *b,
+                 double jul_utc, double r_ecef[3], double v_ecef[3]);
+
 void oem_free(oem_table_t *t);
 
 #endif // OEM_H
@@ -20,6 +20,7 @@
 
 #include "prediction.h"
 #include "oem.h"
+#include "tle_catalog.h"
 
 #include <ctype.h>
 #include <math.h>
@@ -38,6 +39,11 @@
 #define WGS84_F   (1.0 / 298.257223563)
 #define WGS84_E2  (2.0 * WGS84_F - WGS84_F * WGS84_F)
 
+// Earth rotation rate, rad/s. Same value as sgp4sdp4's (private) mfactor,
+// which Calculate_Obs uses for the observer velocity, so the pass cache's
+// TEME <-> Earth-fixed velocity terms cancel exactly against it.
+#define EARTH_ROT_RAD_S 7.292115E-5
+
 static void geodetic_to_ecef(double lat_rad, double lon_rad, double alt_km,
                              double out[3])
 {
@@ -135,6 +141,154 @@ static void fill_ephem_from_oem(prediction_t *prediction, double jul_utc)
     se->speed_km_s = sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
 }
 
+// --- Per-pass ephemeris cache ---------------------------------------
+//
+// Uniformly spaced ITRF samples, so a lookup is one division to find the
+// bracketing pair plus one Hermite evaluation. The cache stands in for the
+// SGP4/SDP4 call only: it hands back the same TEME state, and the observer
+// geometry (Calculate_Obs, refraction included) runs exactly as before.
+// The TLE identity (catalog number + epoch) is recorded so a retarget or
+// TLE reload can't be served the previous object's track; a mismatch just
+// falls through to SGP4.
+
+struct pass_cache {
+    double        jul_start;
+    double        step_days;
+    size_t        n;
+    oem_sample_t *samples;
+    int           catnr;
+    double        tle_epoch;
+};
+
+static int pass_cache_matches(const struct pass_cache *c, const tle_t *tle)
+{
+    return c != NULL && c->catnr == tle->catnr && c->tle_epoch == tle->epoch;
+}
+
+// Interpolate the TEME position/velocity (km, km/s) at jul_utc into the
+// satellite ephem. Returns -1, leaving it untouched, outside the window or
+// for a cache built from another TLE.
+static int pass_cache_state(prediction_t *prediction, double jul_utc)
+{
+    const struct pass_cache *c = prediction->pass_cache;
+    if (!pass_cache_matches(c, &prediction->satellite_ephem.tle)) return -1;
+    double x = (jul_utc - c->jul_start) / c->step_days;
+    if (!(x >= 0.0) || x > (double)(c->n - 1)) return -1;
+    size_t i = (size_t)x;
+    if (i >= c->n - 1) i = c->n - 2;
+    double r[3], v[3];
+    oem_hermite(&c->samples[i], &c->samples[i + 1], jul_utc, r, v);
+
+    // Earth-fixed -> TEME: rotate by the Greenwich sidereal angle and add
+    // back the frame rotation, the inverse of the build step.
+    double th = ThetaG_JD(jul_utc);
+    double ct = cos(th), st = sin(th);
+    vector_t *p = &prediction->satellite_ephem.position;
+    vector_t *vel = &prediction->satellite_ephem.velocity;
+    p->x = ct * r[0] - st * r[1];
+    p->y = st * r[0] + ct * r[1];
+    p->z = r[2];
+    vel->x = ct * v[0] - st * v[1] - EARTH_ROT_RAD_S * p->y;
+    vel->y = st * v[0] + ct * v[1] + EARTH_ROT_RAD_S * p->x;
+    vel->z = v[2];
+    return 0;
+}
+
+void prediction_free_pass_cache(prediction_t *prediction)
+{
+    if (prediction == NULL || prediction->pass_cache == NULL) return;
+    free(prediction->pass_cache->samples);
+    free(prediction->pass_cache);
+    prediction->pass_cache = NULL;
+}
+
+int prediction_pass_cache_covers(const prediction_t *prediction,
+                                 double jul_start, double jul_stop)
+{
+    if (prediction == NULL) return 0;
+    const struct pass_cache *c = prediction->pass_cache;
+    if (!pass_cache_matches(c, &prediction->satellite_ephem.tle)) return 0;
+    double last = c->jul_start + (double)(c->n - 1) * c->step_days;
+    return jul_start >= c->jul_start && jul_stop <= last;
+}
+
+int prediction_pass_cache_window(const prediction_t *prediction,
+                                 double *jul_start, double *jul_stop)
+{
+    if (prediction == NULL) return -1;
+    const struct pass_cache *c = prediction->pass_cache;
+    if (!pass_cache_matches(c, &prediction->satellite_ephem.tle)) return -1;
+    if (jul_start) *jul_start = c->jul_start;
+    if (jul_stop)  *jul_stop  = c->jul_start + (double)(c->n - 1) * c->step_days;
+    return 0;
+}
+
+int prediction_build_pass_cache(prediction_t *prediction,
+                                double jul_start, double jul_stop)
+{
+    if (prediction == NULL) return -1;
+    prediction_free_pass_cache(prediction);
+    if (prediction->oem != NULL || !(jul_stop > jul_start)) return -1;
+
+    double step_days = PASS_CACHE_STEP_S / 86400.0;
+    size_t n = (size_t)ceil((jul_stop - jul_start) / step_days) + 1;
+    if (n < 2) n = 2;
+    struct pass_cache *c = calloc(1, sizeof *c);
+    oem_sample_t *samples = calloc(n, sizeof *samples);
+    if (c == NULL || samples == NULL) {
+        free(c);
+        free(samples);
+        return -1;
+    }
+
+    // Propagate on the batch path into a scratch SoA buffer, not through
+    // update_satellite_position: its tail reuses satellite_ephem.position
+    // as scratch for the observer, and the batch path derives the SGP4
+    // constants once for the whole table. SGP4 returns TEME; rotate by the
+    // same sidereal angle Calculate_Obs uses and take out the frame
+    // rotation to get the Earth-fixed state. Propagate at exactly the sample
+    // times the table is labelled with, so the Hermite interpolation sees no
+    // sub-millisecond label skew.
+    tle_t *tle = &prediction->satellite_ephem.tle;
+    double *pos = malloc(7 * n * sizeof *pos);
+    if (pos == NULL) {
+        free(c);
+        free(samples);
+        return -1;
+    }
+    double *vel = pos + 3 * n;
+    double *jul = pos + 6 * n;
+    for (size_t i = 0; i < n; ++i) jul[i] = jul_start + (double)i * step_days;
+    sgp4_ctx_t ctx;
+    sgp4_ctx_init(&ctx, tle, isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0);
+    sgp4_propagate_times(&ctx, jul, (int)n, pos, vel);
+    for (size_t i = 0; i < n; ++i) {
+        double t = jul[i];
+        double px = pos[i], py = pos[n + i], pz = pos[2 * n + i];
+        double th = ThetaG_JD(t);
+        double ct = cos(th), st = sin(th);
+        double vx = vel[i] + EARTH_ROT_RAD_S * py;
+        double vy = vel[n + i] - EARTH_ROT_RAD_S * px;
+        oem_sample_t *sm = &samples[i];
+        sm->jul_utc = t;
+        sm->r_ecef[0] =  ct * px + st * py;
+        sm->r_ecef[1] = -st * px + ct * py;
+        sm->r_ecef[2] =  pz;
+        sm->v_ecef[0] =  ct * vx + st * vy;
+        sm->v_ecef[1] = -st * vx + ct * vy;
+        sm->v_ecef[2] =  vel[2 * n + i];
+    }
+    free(pos);
+    c->jul_start = jul_start;
+    c->step_days = step_days;
+    c->n         = n;
+    c->samples   = samples;
+    c->catnr     = tle->catnr;
+    c->tle_epoch = tle->epoch;
+    prediction->pass_cache = c;
+    return 0;
+}
+
 int tle_default_path(char *out_path, size_t out_cap)
 {
     const char *home = getenv("HOME");
@@ -193,15 +347,22 @@ void update_satellite_position(prediction_t *prediction, double jul_utc)
     prediction->minutes_since_epoch = (jul_utc - prediction->jul_epoch) * 1440.0;
 
     /* Propagate satellite position */
-    /* Call NORAD routines according to deep-space flag */
-    if(isFlagSet(DEEP_SPACE_EPHEM_FLAG)) {
-        SDP4(prediction->minutes_since_epoch, &prediction->satellite_ephem.tle, &prediction->satellite_ephem.position, &prediction->satellite_ephem.velocity);
+    /* Inside the current pass window the precomputed table stands in for
+       the propagator; otherwise call NORAD routines according to the
+       deep-space flag */
+    if (prediction->pass_cache != NULL
+        && pass_cache_state(prediction, jul_utc) == 0) {
+        // Already TEME km, km/s.
     } else {
-        SGP4(prediction->minutes_since_epoch, &prediction->satellite_ephem.tle, &prediction->satellite_ephem.position, &prediction->satellite_ephem.velocity);
-    }
+        if(isFlagSet(DEEP_SPACE_EPHEM_FLAG)) {
+            SDP4(prediction->minutes_since_epoch, &prediction->satellite_ephem.tle, &prediction->satellite_ephem.position, &prediction->satellite_ephem.velocity);
+        } else {
+            SGP4(prediction->minutes_since_epoch, &prediction->satellite_ephem.tle, &prediction->satellite_ephem.position, &prediction->satellite_ephem.velocity);
+        }
 
-    // pos and vel in km, km/s
-    Convert_Sat_State(&prediction->satellite_ephem.position, &prediction->satellite_ephem.velocity);
+        // pos and vel in km, km/s
+        Convert_Sat_State(&prediction->satellite_ephem.position, &prediction->satellite_ephem.velocity);
+    }
     Magnitude(&prediction->satellite_ephem.velocity);
     Calculate_Obs(jul_utc, &prediction->satellite_ephem.position, &prediction->satellite_ephem.velocity, &prediction->observer_ephem.position_geodetic, &prediction->satellite_ephem.observation_set);
     Calculate_LatLonAlt(jul_utc, &prediction->satellite_ephem.position, &prediction->satellite_ephem.position_geodetic);
@@ -219,6 +380,40 @@ void update_satellite_position(prediction_t *prediction, double jul_utc)
     return;
 }
 
+int prediction_look_angles(const prediction_t *prediction, double jul_start,
+                           double step_s, int n, double *az_deg, double *el_deg)
+{
+    if (n <= 0) return 0;
+    if (prediction->oem != NULL) {
+        prediction_t scratch = *prediction;
+        for (int k = 0; k < n; ++k) {
+            fill_ephem_from_oem(&scratch, jul_start + (double)k * step_s / 86400.0);
+            az_deg[k] = scratch.satellite_ephem.azimuth;
+            el_deg[k] = scratch.satellite_ephem.elevation;
+        }
+        return 0;
+    }
+
+    double *pos = malloc(6 * (size_t)n * sizeof *pos);
+    if (pos == NULL) return -1;
+    double *vel = pos + 3 * (size_t)n;
+    sgp4_ctx_t ctx;
+    sgp4_ctx_init(&ctx, &prediction->satellite_ephem.tle,
+                  isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0);
+    sgp4_propagate_grid(&ctx, jul_start, step_s, n, pos, vel);
+    for (int k = 0; k < n; ++k) {
+        vector_t p = { pos[k], pos[n + k], pos[2 * n + k], 0.0 };
+        vector_t v = { vel[k], vel[n + k], vel[2 * n + k], 0.0 };
+        geodetic_t obs = prediction->observer_ephem.position_geodetic;
+        vector_t look;
+        Calculate_Obs(jul_start + (double)k * step_s / 86400.0, &p, &v, &obs, &look);
+        az_deg[k] = Degrees(look.x);
+        el_deg[k] = Degrees(look.y);
+    }
+    free(pos);
+    return 0;
+}
+
 // Overwrites the current satellite position
 void update_pass_predictions(prediction_t *external_prediction, double jul_utc_start, double delta_t_minutes)
 {
@@ -342,6 +537,32 @@ int load_tle(prediction_t *prediction)
                                           : "(no TLE file)");
         return -2;
     }
+
+    // The compiled catalog answers with the same group the line scan below
+    // would find, as long as the groups are regular and the name couldn't
+    // also be a prefix of an element card (the scan tries every line).
+    const char *want = prediction->satellite_ephem.name;
+    const tle_catalog_t *cat = tle_catalog_get(prediction->tles_filename);
+    if (cat != NULL && tle_catalog_regular(cat)
+        && !((want[0] == '1' || want[0] == '2') && (want[1] == '\0' || want[1] == ' '))) {
+        long i = tle_catalog_first_prefix(cat, want);
+        // No name match: a bare NORAD catalog number is looked up by id.
+        if (i < 0 && want[0] != '\0' && strspn(want, "0123456789") == strlen(want)) {
+            i = tle_catalog_find_norad(cat, atoi(want));
+        }
+        if (i < 0) {
+            fprintf(stderr, "Satellite '%s' not found in %s\n", want, prediction->tles_filename);
+            return -2;
+        }
+        const tle_catalog_rec_t *r = tle_catalog_rec(cat, (size_t) i);
+        if (!r->good) {
+            fprintf(stderr, "Invalid TLE\n");
+            return -3;
+        }
+        prediction->satellite_ephem.tle = r->tle;
+        return 0;
+    }
+
     FILE *file = fopen(prediction->tles_filename, "r");
     if (file == NULL) {
         fprintf(stderr, "Error opening %s\n", prediction->tles_filename);
@@ -412,6 +633,13 @@ int pass_sort_latest_first(const void *a, const void *b)
 }
 
 
+static int size_t_ascending(const void *a, const void *b)
+{
+    size_t x = *(const size_t *)a;
+    size_t y = *(const size_t *)b;
+    return (x > y) - (x < y);
+}
+
 // Append a pass_t to the passes list using the prediction's computed
 // pass metrics. Returns 0 on success, -4 on OOM.
 static int append_pass(const char *name, double minutes_until_visible,
@@ -490,16 +718,16 @@ int find_passes(prediction_t *external_prediction, double jul_utc_start, double
         return 0;
     }
 
-    FILE *file = fopen(external_prediction->tles_filename, "r");
-    if (file == NULL) {
+    // Every object comes pre-decoded from the compiled catalog; see
+    // tle_catalog.h for how it mirrors the old line-by-line read.
+    const tle_catalog_t *cat = tle_catalog_get(external_prediction->tles_filename);
+    if (cat == NULL) {
         fprintf(stderr, "Error opening %s\n", external_prediction->tles_filename);
         return -1;
     }
-    
-    char tle[TLE_TWO_LINE_BUF] = {0};
-    char name[128] = {0};
-    char line1[80] = {0};
-    char line2[80] = {0};
+    size_t n_rec = tle_catalog_count(cat);
+
+    char name[TLE_CATALOG_NAME_CHARS] = {0};
 
     prediction_t prediction = {0};
     memcpy(&prediction, external_prediction, sizeof *external_prediction);
@@ -543,30 +771,39 @@ int find_passes(prediction_t *external_prediction, double jul_utc_start, double
     int n_constellations = sizeof constellations / sizeof(char *);
     int skip_this = 0;
 
-    while (read_tle_line(name, sizeof(name), file)) {
-        skip_this = 0;
-        if (!read_tle_line(line1, sizeof(line1), file)) {
-            break;
+    // With a name prefix and no malformed group to stop at, only the
+    // index's matches need visiting (in file order, as the full walk would
+    // append them); *count still covers the whole file.
+    size_t n_visit = n_rec;
+    size_t *visit = NULL;
+    if (criteria->name_prefix != NULL && tle_catalog_bad(cat) == 0) {
+        size_t first = 0;
+        n_visit = tle_catalog_prefix(cat, criteria->name_prefix, &first);
+        visit = malloc((n_visit ? n_visit : 1) * sizeof *visit);
+        if (visit == NULL) {
+            regfree(&pattern);
+            return -4;
         }
-        if (!read_tle_line(line2, sizeof(line2), file)) {
-            break;
+        for (size_t k = 0; k < n_visit; k++) {
+            visit[k] = tle_catalog_by_name(cat, first + k);
         }
-        size_t l1 = strlen(line1);
-        size_t l2 = strlen(line2);
-        if (l1 > TLE_LINE_CHARS) l1 = TLE_LINE_CHARS;
-        if (l2 > TLE_LINE_CHARS) l2 = TLE_LINE_CHARS;
-        memset(tle, 0, sizeof(tle));
-        memcpy(tle, line1, l1);
-        memcpy(tle + TLE_LINE_CHARS, line2, l2);
-        // Calculate minutes away
-        if (!Good_Elements(tle)) {
+        qsort(visit, n_visit, sizeof *visit, size_t_ascending);
+        internal_count = (int) n_rec;
+    }
+
+    for (size_t v = 0; v < n_visit; v++) {
+        const tle_catalog_rec_t *rec = tle_catalog_rec(cat, visit ? visit[v] : v);
+        skip_this = 0;
+        if (!rec->good) {
             fprintf(stderr, "Invalid TLE\n");
             regfree(&pattern);
-            fclose(file);
+            free(visit);
             return -3;
         }
-
-        internal_count++;
+        if (visit == NULL) {
+            internal_count++;
+        }
+        memcpy(name, rec->name, sizeof name);
 
         // Remove trailing whitespace
         int n = strlen(name);
@@ -597,9 +834,12 @@ int find_passes(prediction_t *external_prediction, double jul_utc_start, double
             }
         }
 
-        Convert_Satellite_Data(tle, &prediction.satellite_ephem.tle);
+        // Already through Convert_Satellite_Data + select_ephemeris.
+        prediction.satellite_ephem.tle = rec->ephem;
         ClearFlag(ALL_FLAGS);
-        select_ephemeris(&prediction.satellite_ephem.tle);
+        if (rec->deep_space) {
+            SetFlag(DEEP_SPACE_EPHEM_FLAG);
+        }
         update_satellite_position(&prediction, jul_utc_start);
 
         // TODO filter on perigee / apogee instead of current altitude?
@@ -628,7 +868,7 @@ int find_passes(prediction_t *external_prediction, double jul_utc_start, double
                 int rc = append_pass(name, minutes_until_visible, &prediction);
                 if (rc != 0) {
                     regfree(&pattern);
-                    fclose(file);
+                    free(visit);
                     return rc;
                 }
                 if (find_all == 0) {
@@ -637,7 +877,7 @@ int find_passes(prediction_t *external_prediction, double jul_utc_start, double
             }
         }
     }
-    fclose(file);
+    free(visit);
     regfree(&pattern);
 
     if (count) {
@@ -53,6 +53,8 @@ typedef struct pass
 // Forward decl: when non-NULL on prediction_t, state comes from a
 // pre-propagated ephemeris (ITRF Cartesian), not from SGP4/TLE.
 struct oem_table;
+// Forward decl: per-pass ephemeris cache, see prediction_build_pass_cache.
+struct pass_cache;
 
 typedef struct prediction
 {
@@ -76,6 +78,11 @@ typedef struct prediction
     // Alternative state source. When non-NULL, update_satellite_position
     // interpolates from this table instead of running SGP4.
     struct oem_table *oem;
+    // Dense SGP4 table for the upcoming pass. Inside its window (and for
+    // the TLE it was built from) update_satellite_position interpolates
+    // instead of propagating. Owned by the prediction it was built on;
+    // memcpy'd scratch copies share it read-only and must not free it.
+    struct pass_cache *pass_cache;
 } prediction_t;
 
 /* RAO site observer location in Priddis, SW of Calgary */
@@ -96,6 +103,38 @@ typedef struct prediction
 double julian_date_from_unix_seconds(double unix_seconds);
 
 void update_satellite_position(prediction_t *state, double jul_utc);
+
+// Sky track at the n times jul_start + k * step_s: azimuth and elevation
+// (degrees, same convention and refraction as update_satellite_position)
+// into az_deg[k] / el_deg[k]. TLE predictions propagate the whole track
+// in one sgp4_propagate_grid call; OEM predictions sample the table. state
+// is not modified. Returns 0, or -1 on OOM.
+int prediction_look_angles(const prediction_t *state, double jul_start,
+                           double step_s, int n, double *az_deg, double *el_deg);
+
+// Per-pass ephemeris cache. Propagates the loaded TLE once every
+// PASS_CACHE_STEP_S across [jul_start, jul_stop] and keeps the Earth-fixed
+// position + velocity; afterwards update_satellite_position serves any time
+// in that window by cubic Hermite interpolation (direct index, no SGP4),
+// and the observer-relative az/el/range/range-rate are derived from the
+// interpolated state. At a 10 s step the error is millimetres in range and
+// a few mm/s in range-rate (~0.01 Hz of Doppler at 437 MHz), so the pass
+// finder, pursuit sampler and Doppler see the same geometry as before at a
+// fraction of the cost. Replaces any previous cache. Returns 0 on success,
+// -1 for an OEM-backed prediction, an empty window or OOM (lookups then
+// simply stay on SGP4).
+#define PASS_CACHE_STEP_S 10.0
+int prediction_build_pass_cache(prediction_t *state,
+                                double jul_start, double jul_stop);
+// 1 if a cache for the currently loaded TLE covers [jul_start, jul_stop].
+int prediction_pass_cache_covers(const prediction_t *state,
+                                 double jul_start, double jul_stop);
+// Window [*jul_start, *jul_stop] of the cache for the loaded TLE; -1 if none.
+int prediction_pass_cache_window(const prediction_t *state,
+                                 double *jul_start, double *jul_stop);
+// Drop the cache. Idempotent; call only on the owning prediction.
+void prediction_free_pass_cache(prediction_t *state);
+
 void update_pass_predictions(prediction_t *external_state, double jul_utc_start, double delta_t_minutes);
 void minutes_until_visible(prediction_t *external_state, double jul_utc_start, double jul_utc_stop, double delta_t_minutes);
 // Loads the named satellite's TLE into state->satellite_ephem.tle. The
@@ -0,0 +1,596 @@
+/*
+
+    Simple Satellite Operations  tle_catalog.c
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// tle_catalog.c — see header.
+
+#include "tle_catalog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CAT_MAGIC    "SSOTLEC"
+#define CAT_VERSION  1u
+#define CAT_BOM      0x01020304u   // reads back differently on the other byte order
+#define CAT_MAX      16            // open catalogs / aliases per process
+#define CAT_PATH_MAX 1024
+
+// sgp4sdp4 packs a TLE as two fixed-width 69-char lines, NUL-terminated;
+// same layout prediction.c builds.
+#define TLE_LINE_CHARS   69
+#define TLE_TWO_LINE_BUF (2 * TLE_LINE_CHARS + 1)
+
+// On-disk header. Every section offset is 8-byte aligned so the mapped
+// records can be read in place.
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t bom;
+    uint32_t rec_size;       // sizeof(tle_catalog_rec_t) of the writer
+    uint32_t tle_size;       // sizeof(tle_t) of the writer
+    uint32_t n_rec;
+    uint32_t n_bad;
+    uint32_t regular;
+    uint32_t hash_slots;     // power of two
+    int64_t  src_size;
+    int64_t  src_mtime_s;
+    int64_t  src_mtime_ns;
+    uint64_t src_hash;       // FNV-1a 64 of the source bytes
+    uint64_t off_rec;
+    uint64_t off_names;      // uint32_t[n_rec] record indices in name order
+    uint64_t off_norad;      // uint32_t[hash_slots] record index + 1, 0 empty
+    uint64_t file_size;
+} cat_header_t;
+
+struct tle_catalog {
+    const cat_header_t      *h;
+    const tle_catalog_rec_t *rec;
+    const uint32_t          *names;
+    const uint32_t          *norad;
+    int                      mapped;
+};
+
+// Keyed by source: a derived catalog depends only on the file it came from,
+// whichever tempfile it was converted into this run.
+typedef struct {
+    char          source[CAT_PATH_MAX];
+    int           derived;
+    int64_t       size, mtime_s, mtime_ns;
+    tle_catalog_t cat;
+} open_cat_t;
+
+typedef struct {
+    char path[CAT_PATH_MAX];
+    char source[CAT_PATH_MAX];
+} alias_t;
+
+static open_cat_t g_open[CAT_MAX];
+static int        g_open_n = 0;
+static alias_t    g_alias[CAT_MAX];
+static int        g_alias_n = 0;
+
+// ---- helpers ---------------------------------------------------------------
+
+static uint64_t fnv1a(uint64_t h, const void *p, size_t n)
+{
+    const uint8_t *b = p;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= b[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+#define FNV_OFFSET 0xcbf29ce484222325ull
+
+static uint64_t align8(uint64_t x)
+{
+    return (x + 7u) & ~(uint64_t) 7u;
+}
+
+static uint32_t norad_slot(int catnr, uint32_t mask)
+{
+    return ((uint32_t) catnr * 2654435761u) & mask;
+}
+
+static int64_t st_mtime_ns(const struct stat *st)
+{
+    return (int64_t) st->st_mtim.tv_nsec;
+}
+
+// Hash the whole of an open file from the start.
+static int hash_fd(int fd, uint64_t *out)
+{
+    uint8_t buf[65536];
+    uint64_t h = FNV_OFFSET;
+    if (lseek(fd, 0, SEEK_SET) != 0) return -1;
+    for (;;) {
+        ssize_t r = read(fd, buf, sizeof buf);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (r == 0) break;
+        h = fnv1a(h, buf, (size_t) r);
+    }
+    *out = h;
+    return 0;
+}
+
+// Cache directory, or NULL when caching to disk is off / has no home.
+static const char *cache_dir(void)
+{
+    static char dir[CAT_PATH_MAX];
+    const char *env = getenv("SSO_TLE_CACHE_DIR");
+    if (env != NULL && env[0] != '\0') {
+        if (strcmp(env, "off") == 0) return NULL;
+        snprintf(dir, sizeof dir, "%s", env);
+        return dir;
+    }
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    int n;
+    if (xdg != NULL && xdg[0] != '\0')
+        n = snprintf(dir, sizeof dir, "%s/simple_sat_ops/tle", xdg);
+    else if (home != NULL && home[0] != '\0')
+        n = snprintf(dir, sizeof dir, "%s/.cache/simple_sat_ops/tle", home);
+    else
+        return NULL;
+    if (n < 0 || (size_t) n >= sizeof dir) return NULL;
+    return dir;
+}
+
+// mkdir -p, same walk as pursuit.c / sso_paths.c.
+static int mkdir_p(const char *dir)
+{
+    char tmp[CAT_PATH_MAX];
+    int n = snprintf(tmp, sizeof tmp, "%s", dir);
+    if (n < 0 || (size_t) n >= sizeof tmp) return -1;
+    for (char *p = tmp + 1; *p; ++p) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(tmp, 0755) != 0 && errno != EEXIST) return -1;
+        *p = '/';
+    }
+    if (mkdir(tmp, 0755) != 0 && errno != EEXIST) return -1;
+    return 0;
+}
+
+// Cache file for a source: named by the hash of its absolute path, with a
+// separate name for a catalog derived from it (tle_csv) so a CSV and its
+// converted text never share one.
+static int cache_file(const char *source, int derived, char *out, size_t cap)
+{
+    const char *dir = cache_dir();
+    if (dir == NULL) return -1;
+    char abs[PATH_MAX];
+    const char *key = realpath(source, abs) != NULL ? abs : source;
+    uint64_t h = fnv1a(FNV_OFFSET, key, strlen(key));
+    int n = snprintf(out, cap, "%s/%016llx%s.tlec", dir,
+                     (unsigned long long) h, derived ? "-derived" : "");
+    if (n < 0 || (size_t) n >= cap) return -1;
+    return 0;
+}
+
+// Point the accessors at a laid-out image (mapped or in memory).
+static void bind(tle_catalog_t *c, const void *base, int mapped)
+{
+    const uint8_t *b = base;
+    c->h      = base;
+    c->rec    = (const tle_catalog_rec_t *) (b + c->h->off_rec);
+    c->names  = (const uint32_t *) (b + c->h->off_names);
+    c->norad  = (const uint32_t *) (b + c->h->off_norad);
+    c->mapped = mapped;
+}
+
+// ---- compile ---------------------------------------------------------------
+
+// prediction.c's line reader: fgets, trim CR/LF only.
+static int read_line(char *buf, size_t size, FILE *f)
+{
+    if (fgets(buf, (int) size, f) == NULL) return 0;
+    size_t n = strlen(buf);
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == '\r')) buf[--n] = '\0';
+    return 1;
+}
+
+static const tle_catalog_rec_t *g_sort_rec;
+
+static int by_name(const void *a, const void *b)
+{
+    uint32_t ia = *(const uint32_t *) a, ib = *(const uint32_t *) b;
+    int r = strcmp(g_sort_rec[ia].name, g_sort_rec[ib].name);
+    if (r != 0) return r;
+    return ia < ib ? -1 : ia > ib;
+}
+
+// Compile the text at `path` into a heap image. The header is stamped with
+// `st` / `hash` (the source's, which is `path` itself unless aliased).
+static void *compile(const char *path, const struct stat *st, uint64_t hash)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return NULL;
+
+    tle_catalog_rec_t *recs = NULL;
+    size_t n = 0, cap = 0;
+    uint32_t n_bad = 0, regular = 1;
+    char name[TLE_CATALOG_NAME_CHARS], l1[TLE_CATALOG_LINE_CHARS], l2[TLE_CATALOG_LINE_CHARS];
+    char tle[TLE_TWO_LINE_BUF];
+    // select_ephemeris sets the thread's deep-space flag; put it back after.
+    int deep_was = isFlagSet(DEEP_SPACE_EPHEM_FLAG) != 0;
+
+    while (read_line(name, sizeof name, f)) {
+        if (!read_line(l1, sizeof l1, f)) break;
+        if (!read_line(l2, sizeof l2, f)) break;
+        if (n == cap) {
+            size_t ncap = cap ? cap * 2 : 256;
+            tle_catalog_rec_t *grown = realloc(recs, ncap * sizeof *recs);
+            if (grown == NULL) {
+                free(recs);
+                fclose(f);
+                return NULL;
+            }
+            recs = grown;
+            cap = ncap;
+        }
+        tle_catalog_rec_t *r = &recs[n++];
+        memset(r, 0, sizeof *r);
+        memcpy(r->name, name, sizeof r->name);
+        memcpy(r->line1, l1, sizeof r->line1);
+        memcpy(r->line2, l2, sizeof r->line2);
+        if (l1[0] != '1' || l1[1] != ' ' || l2[0] != '2' || l2[1] != ' ')
+            regular = 0;
+
+        size_t a = strlen(l1), b = strlen(l2);
+        if (a > TLE_LINE_CHARS) a = TLE_LINE_CHARS;
+        if (b > TLE_LINE_CHARS) b = TLE_LINE_CHARS;
+        memset(tle, 0, sizeof tle);
+        memcpy(tle, l1, a);
+        memcpy(tle + TLE_LINE_CHARS, l2, b);
+        if (!Good_Elements(tle)) {
+            n_bad++;
+            continue;
+        }
+        r->good = 1;
+        snprintf(r->tle.sat_name, sizeof r->tle.sat_name, "%s", name);
+        Convert_Satellite_Data(tle, &r->tle);
+        r->ephem = r->tle;
+        select_ephemeris(&r->ephem);
+        r->deep_space = isFlagSet(DEEP_SPACE_EPHEM_FLAG) != 0;
+    }
+    fclose(f);
+    if (deep_was) SetFlag(DEEP_SPACE_EPHEM_FLAG);
+    else          ClearFlag(DEEP_SPACE_EPHEM_FLAG);
+
+    uint32_t slots = 16;
+    while (slots < 2 * n) slots <<= 1;
+    cat_header_t h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, CAT_MAGIC, sizeof CAT_MAGIC);
+    h.version      = CAT_VERSION;
+    h.bom          = CAT_BOM;
+    h.rec_size     = (uint32_t) sizeof(tle_catalog_rec_t);
+    h.tle_size     = (uint32_t) sizeof(tle_t);
+    h.n_rec        = (uint32_t) n;
+    h.n_bad        = n_bad;
+    h.regular      = regular;
+    h.hash_slots   = slots;
+    h.src_size     = (int64_t) st->st_size;
+    h.src_mtime_s  = (int64_t) st->st_mtime;
+    h.src_mtime_ns = st_mtime_ns(st);
+    h.src_hash     = hash;
+    h.off_rec      = align8(sizeof h);
+    h.off_names    = align8(h.off_rec + (uint64_t) n * sizeof *recs);
+    h.off_norad    = align8(h.off_names + (uint64_t) n * sizeof(uint32_t));
+    h.file_size    = h.off_norad + (uint64_t) slots * sizeof(uint32_t);
+
+    uint8_t *img = calloc(1, (size_t) h.file_size);
+    if (img == NULL) {
+        free(recs);
+        return NULL;
+    }
+    memcpy(img, &h, sizeof h);
+    if (n > 0) memcpy(img + h.off_rec, recs, n * sizeof *recs);
+    free(recs);
+
+    const tle_catalog_rec_t *rec = (const tle_catalog_rec_t *) (img + h.off_rec);
+    uint32_t *names = (uint32_t *) (img + h.off_names);
+    for (uint32_t i = 0; i < (uint32_t) n; ++i) names[i] = i;
+    g_sort_rec = rec;
+    qsort(names, n, sizeof *names, by_name);
+
+    // First good record per NORAD id, linear probing.
+    uint32_t *norad = (uint32_t *) (img + h.off_norad);
+    for (uint32_t i = 0; i < (uint32_t) n; ++i) {
+        if (!rec[i].good) continue;
+        uint32_t s = norad_slot(rec[i].tle.catnr, slots - 1);
+        while (norad[s] != 0 && rec[norad[s] - 1].tle.catnr != rec[i].tle.catnr)
+            s = (s + 1) & (slots - 1);
+        if (norad[s] == 0) norad[s] = i + 1;
+    }
+    return img;
+}
+
+// Write the image to the cache atomically (temp file + rename). Failure
+// only means the next run compiles again.
+static void save(const char *file, const void *img)
+{
+    const cat_header_t *h = img;
+    char dir[CAT_PATH_MAX];
+    snprintf(dir, sizeof dir, "%s", file);
+    char *slash = strrchr(dir, '/');
+    if (slash == NULL) return;
+    *slash = '\0';
+    if (mkdir_p(dir) != 0) return;
+
+    char tmp[CAT_PATH_MAX + 16];
+    snprintf(tmp, sizeof tmp, "%s.XXXXXX", file);
+    int fd = mkstemp(tmp);
+    if (fd < 0) return;
+    const uint8_t *p = img;
+    size_t left = (size_t) h->file_size;
+    while (left > 0) {
+        ssize_t w = write(fd, p, left);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) break;
+        p += w;
+        left -= (size_t) w;
+    }
+    if (close(fd) != 0 || left != 0 || rename(tmp, file) != 0)
+        (void) unlink(tmp);
+}
+
+// ---- cache files -----------------------------------------------------------
+
+// Map `file` and check it describes the source `st` / `src_fd`. Returns the
+// mapping or NULL when missing, foreign or stale.
+static void *map_valid(const char *file, const struct stat *st, int src_fd)
+{
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat cst;
+    if (fstat(fd, &cst) != 0 || (size_t) cst.st_size < sizeof(cat_header_t)) {
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, (size_t) cst.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const cat_header_t *h = base;
+    uint64_t len = (uint64_t) cst.st_size;
+    int ok = memcmp(h->magic, CAT_MAGIC, sizeof CAT_MAGIC) == 0
+          && h->version == CAT_VERSION && h->bom == CAT_BOM
+          && h->rec_size == sizeof(tle_catalog_rec_t)
+          && h->tle_size == sizeof(tle_t)
+          && h->file_size == len
+          && h->hash_slots >= 16 && (h->hash_slots & (h->hash_slots - 1)) == 0
+          && h->off_rec + (uint64_t) h->n_rec * h->rec_size <= h->off_names
+          && h->off_names + (uint64_t) h->n_rec * sizeof(uint32_t) <= h->off_norad
+          && h->off_norad + (uint64_t) h->hash_slots * sizeof(uint32_t) <= len
+          && (h->off_rec | h->off_names | h->off_norad) % 8 == 0
+          && h->src_size == (int64_t) st->st_size;
+    if (ok && (h->src_mtime_s != (int64_t) st->st_mtime
+               || h->src_mtime_ns != st_mtime_ns(st))) {
+        // Touched but maybe not changed (a re-download): compare content.
+        uint64_t hash;
+        ok = hash_fd(src_fd, &hash) == 0 && hash == h->src_hash;
+        if (ok) {
+            // Re-stamp so the next run takes the cheap path.
+            int wfd = open(file, O_WRONLY);
+            if (wfd >= 0) {
+                int64_t stamp[2] = { (int64_t) st->st_mtime, st_mtime_ns(st) };
+                ssize_t w = pwrite(wfd, stamp, sizeof stamp,
+                                   (off_t) offsetof(cat_header_t, src_mtime_s));
+                (void) w;
+                close(wfd);
+            }
+        }
+    }
+    if (!ok) {
+        munmap(base, (size_t) len);
+        return NULL;
+    }
+    return base;
+}
+
+static const char *source_of(const char *path)
+{
+    for (int i = 0; i < g_alias_n; ++i)
+        if (strcmp(g_alias[i].path, path) == 0) return g_alias[i].source;
+    return path;
+}
+
+// Remember a catalog for the rest of the process. Superseded catalogs are
+// left mapped: callers may still be walking them.
+static const tle_catalog_t *keep(const char *source, int derived,
+                                 const struct stat *st, const void *base, int mapped)
+{
+    open_cat_t *slot = NULL;
+    for (int i = 0; i < g_open_n; ++i)
+        if (strcmp(g_open[i].source, source) == 0 && g_open[i].derived == derived)
+            slot = &g_open[i];
+    if (slot == NULL && g_open_n < CAT_MAX) slot = &g_open[g_open_n++];
+    if (slot == NULL) {
+        tle_catalog_t *c = malloc(sizeof *c);
+        if (c != NULL) bind(c, base, mapped);
+        return c;
+    }
+    snprintf(slot->source, sizeof slot->source, "%s", source);
+    slot->derived  = derived;
+    slot->size     = (int64_t) st->st_size;
+    slot->mtime_s  = (int64_t) st->st_mtime;
+    slot->mtime_ns = st_mtime_ns(st);
+    bind(&slot->cat, base, mapped);
+    return &slot->cat;
+}
+
+static const tle_catalog_t *find_open(const char *source, int derived,
+                                      const struct stat *st)
+{
+    for (int i = 0; i < g_open_n; ++i) {
+        const open_cat_t *o = &g_open[i];
+        if (strcmp(o->source, source) == 0 && o->derived == derived
+            && o->size == (int64_t) st->st_size
+            && o->mtime_s == (int64_t) st->st_mtime
+            && o->mtime_ns == st_mtime_ns(st))
+            return &o->cat;
+    }
+    return NULL;
+}
+
+// ---- API -------------------------------------------------------------------
+
+const tle_catalog_t *tle_catalog_get(const char *path)
+{
+    if (path == NULL || path[0] == '\0') return NULL;
+    const char *source = source_of(path);
+    int derived = source != path;
+    int fd = open(source, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    const tle_catalog_t *c = find_open(source, derived, &st);
+    if (c != NULL) {
+        close(fd);
+        return c;
+    }
+
+    char file[CAT_PATH_MAX];
+    int have_file = cache_file(source, derived, file, sizeof file) == 0;
+    void *base = have_file ? map_valid(file, &st, fd) : NULL;
+    if (base != NULL) {
+        close(fd);
+        return keep(source, derived, &st, base, 1);
+    }
+
+    uint64_t hash = 0;
+    int hashed = hash_fd(fd, &hash) == 0;
+    close(fd);
+    if (!hashed) return NULL;
+    void *img = compile(path, &st, hash);
+    if (img == NULL) return NULL;
+    if (have_file) save(file, img);
+    return keep(source, derived, &st, img, 0);
+}
+
+const tle_catalog_t *tle_catalog_get_derived(const char *source)
+{
+    if (source == NULL || source[0] == '\0') return NULL;
+    int fd = open(source, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    char file[CAT_PATH_MAX];
+    void *base = NULL;
+    if (fstat(fd, &st) == 0 && cache_file(source, 1, file, sizeof file) == 0)
+        base = map_valid(file, &st, fd);
+    close(fd);
+    if (base == NULL) return NULL;
+    return keep(source, 1, &st, base, 1);
+}
+
+int tle_catalog_alias(const char *path, const char *source)
+{
+    for (int i = 0; i < g_alias_n; ++i) {
+        if (strcmp(g_alias[i].path, path) == 0) {
+            snprintf(g_alias[i].source, sizeof g_alias[i].source, "%s", source);
+            return 0;
+        }
+    }
+    if (g_alias_n >= CAT_MAX) return -1;
+    snprintf(g_alias[g_alias_n].path, sizeof g_alias[0].path, "%s", path);
+    snprintf(g_alias[g_alias_n].source, sizeof g_alias[0].source, "%s", source);
+    g_alias_n++;
+    return 0;
+}
+
+size_t tle_catalog_count(const tle_catalog_t *c)
+{
+    return c->h->n_rec;
+}
+
+size_t tle_catalog_bad(const tle_catalog_t *c)
+{
+    return c->h->n_bad;
+}
+
+const tle_catalog_rec_t *tle_catalog_rec(const tle_catalog_t *c, size_t i)
+{
+    return i < c->h->n_rec ? &c->rec[i] : NULL;
+}
+
+int tle_catalog_regular(const tle_catalog_t *c)
+{
+    return c->h->regular != 0;
+}
+
+int tle_catalog_from_cache(const tle_catalog_t *c)
+{
+    return c->mapped;
+}
+
+size_t tle_catalog_prefix(const tle_catalog_t *c, const char *prefix, size_t *first)
+{
+    size_t lo = 0, hi = c->h->n_rec;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strcmp(c->rec[c->names[mid]].name, prefix) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    size_t plen = strlen(prefix), k = lo;
+    while (k < c->h->n_rec && strncmp(c->rec[c->names[k]].name, prefix, plen) == 0) k++;
+    if (first != NULL) *first = lo;
+    return k - lo;
+}
+
+size_t tle_catalog_by_name(const tle_catalog_t *c, size_t k)
+{
+    return c->names[k];
+}
+
+long tle_catalog_first_prefix(const tle_catalog_t *c, const char *prefix)
+{
+    size_t first = 0;
+    size_t n = tle_catalog_prefix(c, prefix, &first);
+    long best = -1;
+    for (size_t k = 0; k < n; ++k) {
+        long i = (long) c->names[first + k];
+        if (best < 0 || i < best) best = i;
+    }
+    return best;
+}
+
+long tle_catalog_find_norad(const tle_catalog_t *c, int catnr)
+{
+    uint32_t mask = c->h->hash_slots - 1;
+    for (uint32_t s = norad_slot(catnr, mask), probes = 0;
+         c->norad[s] != 0 && probes <= mask; s = (s + 1) & mask, ++probes) {
+        if (c->rec[c->norad[s] - 1].tle.catnr == catnr) return (long) c->norad[s] - 1;
+    }
+    return -1;
+}
@@ -0,0 +1,124 @@
+/*
+
+    Simple Satellite Operations  tle_catalog.h
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// tle_catalog.h — a compiled, memory-mapped form of a 3-line TLE file.
+//
+// load_tle and find_passes used to re-read the text file and run
+// Good_Elements / Convert_Satellite_Data / select_ephemeris on every object
+// on every run; for a 10k-object catalog that is most of next_in_queue's
+// startup. The first tool to open a TLE file now compiles it into a binary
+// catalog under the cache directory: one fixed-size record per group holding
+// the decoded elements both as load_tle returns them and after
+// select_ephemeris, the original lines, a name index sorted for prefix
+// search and a NORAD-id hash. Later runs mmap it read-only and parse nothing.
+//
+// Groups are read exactly as prediction.c always read them: strict
+// name + line 1 + line 2 triples, each line trimmed of CR/LF only, with the
+// same buffer sizes, so a catalog lists the same objects in the same order
+// as the text loop would have found them, malformed groups included (flagged
+// !good so find_passes still stops on them).
+//
+// A cache file is reused while the source's size and mtime match the ones
+// recorded at compile time. If only the mtime moved (a fresh download of the
+// same catalog), the source is hashed and the cache kept when the FNV-1a
+// hash agrees. Anything else -- another size, another hash, a cache written
+// by a build with a different tle_t layout or byte order -- recompiles.
+//
+// Cache directory: $SSO_TLE_CACHE_DIR, else $XDG_CACHE_HOME/simple_sat_ops/tle,
+// else $HOME/.cache/simple_sat_ops/tle. SSO_TLE_CACHE_DIR=off (or a
+// directory that can't be written) keeps the compiled catalog in memory for
+// this process only; nothing else changes.
+//
+// Catalogs returned by tle_catalog_get stay valid until process exit. Not
+// thread-safe: open catalogs from one thread (the lookups on an open catalog
+// are read-only and may be shared).
+
+#ifndef TLE_CATALOG_H
+#define TLE_CATALOG_H
+
+#include <sgp4sdp4.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Line buffers, as prediction.c's reader sizes them.
+#define TLE_CATALOG_NAME_CHARS 128
+#define TLE_CATALOG_LINE_CHARS 80
+
+typedef struct {
+    tle_t   tle;        // as load_tle leaves it: sat_name set, Convert_Satellite_Data
+    tle_t   ephem;      // tle after select_ephemeris (radians, rad/min)
+    int32_t good;       // passed Good_Elements; tle/ephem are zero otherwise
+    int32_t deep_space; // select_ephemeris chose SDP4
+    char    name[TLE_CATALOG_NAME_CHARS];   // name line, CR/LF trimmed
+    char    line1[TLE_CATALOG_LINE_CHARS];
+    char    line2[TLE_CATALOG_LINE_CHARS];
+} tle_catalog_rec_t;
+
+typedef struct tle_catalog tle_catalog_t;
+
+// The compiled catalog for the TLE file at `path`: from this process's open
+// set, else the cache file, else compiled now (and saved). NULL if the file
+// can't be read or memory runs out.
+const tle_catalog_t *tle_catalog_get(const char *path);
+
+// The catalog previously compiled from a file generated out of `source`
+// (see tle_catalog_alias), if its cache file is still valid; never compiles.
+// tle_csv uses it to skip converting an unchanged CSV.
+const tle_catalog_t *tle_catalog_get_derived(const char *source);
+
+// Treat `source` as the file `path` was generated from: the catalog of
+// `path` is keyed and invalidated by `source` (tle_csv's tempfile of a
+// Celestrak CSV). Returns 0, or -1 when the alias table is full.
+int tle_catalog_alias(const char *path, const char *source);
+
+size_t tle_catalog_count(const tle_catalog_t *c);
+// Groups that failed Good_Elements.
+size_t tle_catalog_bad(const tle_catalog_t *c);
+const tle_catalog_rec_t *tle_catalog_rec(const tle_catalog_t *c, size_t i);
+
+// 1 when every group is a name line followed by "1 " and "2 " cards, i.e.
+// the line-by-line matchers elsewhere would see the same groups.
+int tle_catalog_regular(const tle_catalog_t *c);
+
+// Records whose name starts with `prefix` (case-sensitive): returns how many
+// and sets *first to the position of the first in name order; walk them with
+// tle_catalog_by_name(c, *first + k).
+size_t tle_catalog_prefix(const tle_catalog_t *c, const char *prefix, size_t *first);
+// Record index of the k-th name in sorted order.
+size_t tle_catalog_by_name(const tle_catalog_t *c, size_t k);
+// Earliest record in file order whose name starts with `prefix`, or -1.
+long tle_catalog_first_prefix(const tle_catalog_t *c, const char *prefix);
+
+// Earliest good record in file order with this NORAD catalog number, or -1.
+long tle_catalog_find_norad(const tle_catalog_t *c, int catnr);
+
+// 1 if `c` was mapped from a cache file, 0 if compiled in this process.
+int tle_catalog_from_cache(const tle_catalog_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TLE_CATALOG_H
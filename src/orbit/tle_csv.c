@@ -20,6 +20,7 @@
 
 #define _GNU_SOURCE
 #include "tle_csv.h"
+#include "tle_catalog.h"
 
 #include <ctype.h>
 #include <errno.h>
@@ -508,6 +509,25 @@ static int convert_file(const char *csv_path, const char *out_path)
     return 0;
 }
 
+// An unchanged CSV already converted on an earlier run: write its text back
+// out of the compiled catalog (same name / line 1 / line 2 bytes that
+// convert_file produced) rather than parsing the CSV again.
+static int write_from_catalog(const tle_catalog_t *cat, const char *out_path)
+{
+    FILE *fout = fopen(out_path, "w");
+    if (fout == NULL) {
+        fprintf(stderr, "tle_csv: open %s: %s\n", out_path, strerror(errno));
+        return -1;
+    }
+    size_t n = tle_catalog_count(cat);
+    for (size_t i = 0; i < n; i++) {
+        const tle_catalog_rec_t *r = tle_catalog_rec(cat, i);
+        fprintf(fout, "%s\n%s\n%s\n", r->name, r->line1, r->line2);
+    }
+    if (fclose(fout) != 0 || n == 0) return -1;
+    return 0;
+}
+
 char *tle_path_resolve(const char *raw)
 {
     if (raw == NULL || raw[0] == '\0') return (char *) raw;
@@ -540,10 +560,15 @@ char *tle_path_resolve(const char *raw)
     }
     close(fd);
 
-    if (convert_file(raw, tmp_path) != 0) {
+    const tle_catalog_t *cat = tle_catalog_get_derived(raw);
+    int rc = cat != NULL ? write_from_catalog(cat, tmp_path)
+                         : convert_file(raw, tmp_path);
+    if (rc != 0) {
         (void) unlink(tmp_path);
         return (char *) raw;
     }
+    // The tempfile's catalog is keyed and invalidated by the CSV itself.
+    (void) tle_catalog_alias(tmp_path, raw);
 
     if (!g_atexit_registered) {
         atexit(unlink_all_tmp);
@@ -51,6 +51,11 @@
 // unchanged, so upstream load_tle / find_passes will fail with their
 // usual diagnostics.
 //
+// The tempfile is registered with tle_catalog as derived from `raw`, so
+// its compiled catalog is cached across runs against the CSV; when that
+// cache is still valid the tempfile is written straight from it and the
+// CSV is not parsed at all.
+//
 // Returned pointer is owned by tle_csv (string interned in a static
 // table) or borrowed from `raw`; do not free or mutate.
 char *tle_path_resolve(const char *raw);
@@ -0,0 +1,158 @@
+/*
+
+    Simple Satellite Operations  bulk_live.c
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// bulk_live.c — see header.
+
+#include "bulk_live.h"
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+static void clear_bins(bulk_live_t *b)
+{
+    for (int k = 0; k < BULK_LIVE_RATE_BINS; ++k) {
+        b->bin_sec[k]   = -1;
+        b->bin_bytes[k] = 0;
+    }
+}
+
+void bulk_live_init(bulk_live_t *b)
+{
+    memset(b, 0, sizeof *b);
+    reasm_map_init(&b->map, 0x00);
+    b->eof_size = -1;
+    clear_bins(b);
+}
+
+void bulk_live_free(bulk_live_t *b)
+{
+    reasm_map_free(&b->map);
+}
+
+// Drop the current file's bytes and counters; session-wide counters
+// (file_no, rejected) carry over.
+static void start_new_file(bulk_live_t *b, double now_s)
+{
+    reasm_map_free(&b->map);
+    b->file_no++;
+    b->chunks = 0;
+    b->dup_chunks = 0;
+    b->eof_size = -1;
+    b->first_t = now_s;
+    clear_bins(b);
+}
+
+long bulk_live_add(bulk_live_t *b, const uint8_t *pl, size_t pl_len,
+                   int clean, double now_s)
+{
+    long off = 0, dlen = 0;
+    const uint8_t *data = NULL;
+    if (pl_len > INT_MAX
+        || reasm_bulk_chunk(pl, (int) pl_len, &off, &data, &dlen) != 0) {
+        b->rejected++;
+        return -1;
+    }
+    if (b->file_no == 0 || now_s - b->last_t > BULK_LIVE_IDLE_S)
+        start_new_file(b, now_s);
+
+    long conflicts_before = b->map.conflicts;
+    long newly = reasm_map_insert(&b->map, off, data, dlen, clean);
+    if (newly < 0) return -1;
+    // A clean packet that mostly disagrees with clean bytes already held
+    // belongs to a different file: the operator started another download.
+    if (clean && b->map.conflicts - conflicts_before > dlen / 2) {
+        start_new_file(b, now_s);
+        newly = reasm_map_insert(&b->map, off, data, dlen, clean);
+        if (newly < 0) return -1;
+    }
+    // Only the file's last packet is short of a full 195 bytes.
+    if (clean && dlen < REASM_BULK_MAX_DATA) b->eof_size = off + dlen;
+
+    b->chunks++;
+    if (newly == 0) b->dup_chunks++;
+    long sec = (long) floor(now_s);
+    int k = (int) (sec % BULK_LIVE_RATE_BINS);
+    if (b->bin_sec[k] != sec) {
+        b->bin_sec[k]   = sec;
+        b->bin_bytes[k] = 0;
+    }
+    b->bin_bytes[k] += newly;
+    b->last_t = now_s;
+    return newly;
+}
+
+void bulk_live_stats(const bulk_live_t *b, double now_s, bulk_live_stats_t *out)
+{
+    memset(out, 0, sizeof *out);
+    out->rejected = b->rejected;
+    if (b->file_no == 0) return;
+    const reasm_map_t *m = &b->map;
+    out->active     = 1;
+    out->file_no    = b->file_no;
+    out->chunks     = b->chunks;
+    out->dup_chunks = b->dup_chunks;
+    out->present    = m->present;
+    out->extent     = m->size;
+    out->eof_known  = (b->eof_size >= 0 && b->eof_size == m->size);
+    out->missing    = m->size - m->present;
+    out->conflicts  = m->conflicts;
+    out->idle_s     = now_s - b->last_t;
+
+    // Missing runs snapped out to whole packets and coalesced the way
+    // mpi_reconstruct's re-download report does, so the offsets shown can
+    // go straight into comms_bulk_file_downlink_start.
+    const long PKT = REASM_BULK_MAX_DATA;
+    long cs = -1, ce = -1;
+    long a, e = 0;
+    for (long from = 0; (a = reasm_map_next_gap(m, from, &e)) >= 0; from = e) {
+        long sa = (a / PKT) * PKT;
+        long sb = ((e + PKT - 1) / PKT) * PKT;
+        if (sb > m->size) sb = m->size;
+        if (cs >= 0 && sa <= ce) {
+            if (sb > ce) ce = sb;
+            continue;
+        }
+        if (cs >= 0 && out->n_ranges++ < BULK_LIVE_MAX_RANGES) {
+            out->ranges[out->n_ranges - 1].off = cs;
+            out->ranges[out->n_ranges - 1].len = ce - cs;
+        }
+        cs = sa;
+        ce = sb;
+    }
+    if (cs >= 0 && out->n_ranges++ < BULK_LIVE_MAX_RANGES) {
+        out->ranges[out->n_ranges - 1].off = cs;
+        out->ranges[out->n_ranges - 1].len = ce - cs;
+    }
+
+    // Goodput: new bytes over the window, or over the file's life while it
+    // is younger than that so the first seconds of a pass aren't diluted.
+    long now_sec = (long) floor(now_s);
+    long sum = 0;
+    for (int k = 0; k < BULK_LIVE_RATE_BINS; ++k) {
+        long age = now_sec - b->bin_sec[k];
+        if (b->bin_sec[k] >= 0 && age >= 0 && age < BULK_LIVE_RATE_WINDOW_S)
+            sum += b->bin_bytes[k];
+    }
+    double span = now_s - b->first_t;
+    if (span > BULK_LIVE_RATE_WINDOW_S) span = BULK_LIVE_RATE_WINDOW_S;
+    if (span < 1.0) span = 1.0;
+    out->rate_Bps = (double) sum / span;
+}
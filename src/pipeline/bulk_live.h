@@ -0,0 +1,108 @@
+/*
+
+    Simple Satellite Operations  bulk_live.h
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// bulk_live.h — live reassembly of a bulk_file downlink while the pass is
+// still up. rx_session feeds every decoded bulk_file packet in; the RX panel
+// and the viewer STATE show how much of the file has arrived, which 195-byte
+// packets are still missing and the goodput, so the gaps can be re-requested
+// with comms_bulk_file_downlink_start before LOS instead of next pass.
+//
+// The byte map is the same reasm_map_t mpi_reconstruct uses, so the live
+// picture resolves overlaps exactly as the after-the-fact tools will
+// (RS-clean beats uncorrectable, uncorrectable only fills gaps). The DB
+// stays the record of truth; this is a view for the operator.
+//
+// A new file starts when no bulk packet has arrived for BULK_LIVE_IDLE_S
+// (the mpi_reconstruct session gap), or when a clean packet disagrees with
+// the clean bytes already held for most of its length -- a second download
+// in the same pass.
+//
+// Single-threaded: rx_session's worker owns the sink and copies the
+// stats into its snapshot under its own lock.
+
+#ifndef BULK_LIVE_H
+#define BULK_LIVE_H
+
+#include "chunk_reasm.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BULK_LIVE_IDLE_S          (15.0 * 60.0)
+#define BULK_LIVE_RATE_WINDOW_S   30           // goodput averaging window
+#define BULK_LIVE_RATE_BINS       32           // >= window, 1 s per bin
+#define BULK_LIVE_MAX_RANGES      8
+
+// A missing stretch, snapped out to the 195-byte packet grid.
+typedef struct {
+    long off, len;
+} bulk_live_range_t;
+
+typedef struct {
+    int    active;          // 0 until the first bulk packet lands
+    int    file_no;         // 1-based; bumps on each new file
+    long   chunks;          // packets laid into the current file
+    long   dup_chunks;      // ... of which added no new byte
+    long   rejected;        // short payloads / implausible offsets (session)
+    long   present;         // bytes held
+    long   extent;          // highest byte seen, or the size once eof_known
+    int    eof_known;       // a clean short (last) packet has arrived
+    long   missing;         // bytes missing inside [0, extent)
+    long   conflicts;       // clean bytes overwritten by a different clean byte
+    int    n_ranges;        // missing packet runs in total
+    bulk_live_range_t ranges[BULK_LIVE_MAX_RANGES];   // the first n_ranges of them
+    double rate_Bps;        // new bytes/s over the last BULK_LIVE_RATE_WINDOW_S
+    double idle_s;          // since the last bulk packet
+} bulk_live_stats_t;
+
+typedef struct {
+    reasm_map_t map;
+    int         file_no;
+    long        chunks, dup_chunks, rejected;
+    long        eof_size;           // -1 until the last packet arrives
+    double      first_t;            // monotonic s the current file started
+    double      last_t;             // monotonic s of the last packet
+    // Newly-present bytes per whole second, keyed by that second.
+    long        bin_sec[BULK_LIVE_RATE_BINS];
+    long        bin_bytes[BULK_LIVE_RATE_BINS];
+} bulk_live_t;
+
+void bulk_live_init(bulk_live_t *b);
+void bulk_live_free(bulk_live_t *b);
+
+// Lay one bulk_file payload ([packet_type][offset:4 LE][data...], CSP
+// header already stripped) into the current file at monotonic time now_s.
+// clean = RS-clean and CRC-good. Returns the number of newly present bytes,
+// or -1 when the payload was rejected (or on allocation failure).
+long bulk_live_add(bulk_live_t *b, const uint8_t *pl, size_t pl_len,
+                   int clean, double now_s);
+
+// Coverage, the first missing ranges and goodput as of now_s.
+void bulk_live_stats(const bulk_live_t *b, double now_s, bulk_live_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BULK_LIVE_H
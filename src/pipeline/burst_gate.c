@@ -0,0 +1,136 @@
+/*
+
+   Simple Satellite Operations  burst_gate.c
+
+   The energy gate in front of the rx_session demod chains. See
+   burst_gate.h.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+
+#include "burst_gate.h"
+
+#include <stdio.h>
+#include <string.h>
+
+void burst_gate_params_defaults(burst_gate_params_t *p)
+{
+    if (p == NULL) return;
+    p->bins_threshold = 32;
+    p->hold_s         = 1.0;
+    p->preroll_s      = 0.25;
+    p->probe_every    = 2;
+    p->probe_max_ham  = 2;
+}
+
+void burst_gate_init(burst_gate_t *g, const burst_gate_params_t *p, double samp_rate)
+{
+    if (g == NULL) return;
+    memset(g, 0, sizeof *g);
+    if (p != NULL) g->p = *p;
+    else burst_gate_params_defaults(&g->p);
+    if (samp_rate < 0.0) samp_rate = 0.0;
+    g->hold_samples    = g->p.hold_s    > 0.0 ? (uint64_t)(g->p.hold_s * samp_rate) : 0;
+    g->preroll_samples = g->p.preroll_s > 0.0 ? (uint64_t)(g->p.preroll_s * samp_rate) : 0;
+}
+
+void burst_gate_note(burst_gate_t *g, uint64_t start, uint64_t end, int peak_bins)
+{
+    if (g == NULL || end <= start) return;
+    if (peak_bins >= 0 && peak_bins < g->p.bins_threshold) return;
+    // Extend the newest stretch across a gap shorter than the hold: the
+    // windows in between open either way, and the ring then covers a
+    // whole pass's beacons rather than each pump of one.
+    if (g->n_st > 0) {
+        unsigned last = (g->n_st - 1) % BURST_GATE_STRETCHES;
+        if (start <= g->st_end[last] + g->hold_samples) {
+            if (end > g->st_end[last]) g->st_end[last] = end;
+            return;
+        }
+    }
+    unsigned i = g->n_st % BURST_GATE_STRETCHES;
+    g->st_start[i] = start;
+    g->st_end[i]   = end;
+    g->n_st++;
+}
+
+static int active_near(const burst_gate_t *g, uint64_t start, uint64_t end)
+{
+    unsigned n = g->n_st < BURST_GATE_STRETCHES ? g->n_st : BURST_GATE_STRETCHES;
+    for (unsigned k = 0; k < n; k++) {
+        // Stretch widened by the pre-roll in front and the hold behind.
+        uint64_t s = g->st_start[k] > g->preroll_samples
+                   ? g->st_start[k] - g->preroll_samples : 0;
+        uint64_t e = g->st_end[k] + g->hold_samples;
+        if (s < end && e > start) return 1;
+    }
+    return 0;
+}
+
+burst_gate_verdict_t burst_gate_judge(burst_gate_t *g, uint64_t start, uint64_t end)
+{
+    if (g == NULL) return BURST_GATE_OPEN;
+    g->stats.windows++;
+    if (g->p.bins_threshold <= 0 || active_near(g, start, end)) {
+        g->idle_run = 0;
+        g->stats.opened++;
+        return BURST_GATE_OPEN;
+    }
+    unsigned run = g->idle_run++;
+    if (g->p.probe_every > 0 && run % (unsigned) g->p.probe_every == 0) {
+        g->stats.probed++;
+        return BURST_GATE_PROBE;
+    }
+    g->stats.skipped++;
+    return BURST_GATE_SKIP;
+}
+
+void burst_gate_probe_hit(burst_gate_t *g)
+{
+    if (g != NULL) g->stats.probe_opened++;
+}
+
+void burst_gate_frames(burst_gate_t *g, burst_gate_verdict_t v, uint64_t n_frames)
+{
+    if (g == NULL) return;
+    if (v == BURST_GATE_PROBE) g->stats.frames_probe += n_frames;
+    else                       g->stats.frames_open  += n_frames;
+}
+
+void burst_gate_stats_since(const burst_gate_stats_t *now,
+                            const burst_gate_stats_t *base,
+                            burst_gate_stats_t *out)
+{
+    if (now == NULL || out == NULL) return;
+    burst_gate_stats_t zero = {0};
+    if (base == NULL) base = &zero;
+    out->windows      = now->windows      - base->windows;
+    out->opened       = now->opened       - base->opened;
+    out->probed       = now->probed       - base->probed;
+    out->probe_opened = now->probe_opened - base->probe_opened;
+    out->skipped      = now->skipped      - base->skipped;
+    out->frames_open  = now->frames_open  - base->frames_open;
+    out->frames_probe = now->frames_probe - base->frames_probe;
+}
+
+void burst_gate_format(const burst_gate_stats_t *s, char *buf, size_t cap)
+{
+    if (buf == NULL || cap == 0) return;
+    if (s == NULL) { buf[0] = '\0'; return; }
+    // Share of windows that got the full demod chains.
+    double full = s->windows > 0
+                ? 100.0 * (double)(s->opened + s->probe_opened) / (double) s->windows : 0.0;
+    snprintf(buf, cap,
+             "windows=%llu open=%llu probed=%llu probe_open=%llu skipped=%llu "
+             "(%.0f%% demodulated) frames=%llu gate_miss=%llu",
+             (unsigned long long) s->windows, (unsigned long long) s->opened,
+             (unsigned long long) s->probed, (unsigned long long) s->probe_opened,
+             (unsigned long long) s->skipped, full,
+             (unsigned long long)(s->frames_open + s->frames_probe),
+             (unsigned long long) s->frames_probe);
+}
@@ -0,0 +1,121 @@
+/*
+
+    Simple Satellite Operations  burst_gate.h
+
+    Energy gate in front of rx_session's demod chains. Most of a pass is
+    empty noise between beacons, yet every 1.5 s window used to go
+    through all three demodulators (IQ live, PCM and Viterbi shadows),
+    each retrying up to 256 noise syncs. The gate watches the iq_burst
+    detector's bright-bin peaks, one per pump, and judges each window:
+
+      OPEN   burst activity inside the window, within hold_s before it
+             or preroll_s after it: every chain runs as before.
+      PROBE  idle, but due a cheap check: one IQ demod and a strict ASM
+             search (probe_max_ham). A sync escalates the window to a
+             full decode; frames found that way are gate misses, frames
+             the energy detector alone would have lost.
+      SKIP   idle and not due a probe: no demod at all.
+
+    Idle windows are probed every probe_every-th in a run. The default
+    of 2 still sees every frame: windows slide by a third of their
+    length, so a frame no longer than the slide sits whole in at least
+    two consecutive windows.
+
+    The window span itself is the real pre-roll: a window the gate opens
+    still holds the 1.5 s before the detector fired. preroll_s only
+    widens activity already seen (up to the end of the current pump).
+
+    Single-threaded: the rx_session worker owns its gate.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BURST_GATE_H
+#define BURST_GATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BURST_GATE_STRETCHES 8
+
+typedef struct burst_gate_params {
+    int    bins_threshold;  // pump peak bright bins that count as activity; <= 0 = gate off
+    double hold_s;          // hangover: windows starting this long after activity still open
+    double preroll_s;       // windows ending this long before activity still open
+    int    probe_every;     // probe every Nth idle window in a run; 0 = never probe
+    int    probe_max_ham;   // ASM bit errors the probe accepts
+} burst_gate_params_t;
+
+typedef struct burst_gate_stats {
+    uint64_t windows;       // windows judged
+    uint64_t opened;        // gate hits: energy seen, full decode
+    uint64_t probed;        // idle windows given the ASM probe
+    uint64_t probe_opened;  // probes that found a sync, escalated to a full decode
+    uint64_t skipped;       // idle windows not demodulated at all
+    uint64_t frames_open;   // frames decoded in energy-opened windows
+    uint64_t frames_probe;  // gate misses: frames found only through a probe
+} burst_gate_stats_t;
+
+typedef enum {
+    BURST_GATE_OPEN = 0,
+    BURST_GATE_PROBE,
+    BURST_GATE_SKIP,
+} burst_gate_verdict_t;
+
+// Active stretches are absolute sample indices, [start, end).
+typedef struct burst_gate {
+    burst_gate_params_t p;
+    uint64_t hold_samples;
+    uint64_t preroll_samples;
+    uint64_t st_start[BURST_GATE_STRETCHES];
+    uint64_t st_end[BURST_GATE_STRETCHES];
+    unsigned n_st;          // stretches recorded (the ring keeps the newest)
+    unsigned idle_run;      // consecutive idle windows so far
+    burst_gate_stats_t stats;
+} burst_gate_t;
+
+// bins_threshold 32 (half of what a 12 kHz GFSK packet lights in the
+// 512-bin FFT; stationary noise peaks in the low 20s), hold 1.0 s,
+// pre-roll 0.25 s, probe every 2nd idle window at <= 2 ASM bit errors.
+void burst_gate_params_defaults(burst_gate_params_t *p);
+
+void burst_gate_init(burst_gate_t *g, const burst_gate_params_t *p, double samp_rate);
+
+// One pump's worth of samples, [start, end), whose FFT frames peaked at
+// peak_bins bright bins. peak_bins < 0 (no detector) counts as active
+// so a missing detector never silences the decoder.
+void burst_gate_note(burst_gate_t *g, uint64_t start, uint64_t end, int peak_bins);
+
+// Verdict for the window [start, end); counts it in the stats.
+burst_gate_verdict_t burst_gate_judge(burst_gate_t *g, uint64_t start, uint64_t end);
+
+// A PROBE window's sync check came back positive (the caller then
+// decodes the window in full).
+void burst_gate_probe_hit(burst_gate_t *g);
+
+// n_frames new frames came out of a window judged v.
+void burst_gate_frames(burst_gate_t *g, burst_gate_verdict_t v, uint64_t n_frames);
+
+// now - base, field by field (per-pass figures from running totals).
+void burst_gate_stats_since(const burst_gate_stats_t *now,
+                            const burst_gate_stats_t *base,
+                            burst_gate_stats_t *out);
+
+// "windows=N open=N probed=N probe_open=N skipped=N (x% demodulated)
+// frames=N gate_miss=N" -- the burst-gate audit line.
+void burst_gate_format(const burst_gate_stats_t *s, char *buf, size_t cap);
+
+#endif // BURST_GATE_H
@@ -25,6 +25,7 @@
 #include "modem_fsk.h"
 #include "modem_iq.h"
 #include "modem_viterbi.h"
+#include "lat_trace.h"
 #include "packet_db.h"
 
 #include <ctype.h>
@@ -33,6 +34,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 #include <time.h>
 
 // Process-global because emit_frame is called from rx_live, rx_replay,
@@ -45,8 +47,18 @@ static int g_show_headers = 0;
 // Cumulative decode stats, process-global for the same reason as the
 // header toggle. emit_frame tallies the framing-level fields and
 // decode_loop_record_packet tallies the recognized-type fields.
+//
+// Extra receive channels (rx_channel) emit from their own threads
+// alongside the RX worker, so g_emit_mu serializes emit_frame and
+// decode_loop_record_packet end to end: the stats, the text output and
+// the DB insert. Uncontended in the single-threaded tools.
+static pthread_mutex_t g_emit_mu = PTHREAD_MUTEX_INITIALIZER;
 static decode_loop_stats_t g_stats = {0};
 
+// Satellite tag for rows recorded from this thread (see
+// decode_loop_set_thread_satellite). NULL: the primary target.
+static _Thread_local const char *t_satellite;
+
 // Optional packet-DB tap. NULL when no DB is configured (the default —
 // rx_decode without --db, or any receiver run with --no-db). Strings
 // are borrowed, not copied, so callers must keep them alive for the
@@ -149,14 +161,24 @@ int decode_loop_show_headers(void)
     return g_show_headers;
 }
 
+void decode_loop_set_thread_satellite(const char *name)
+{
+    t_satellite = (name != NULL && name[0] != '\0') ? name : NULL;
+}
+
 void decode_loop_reset_stats(void)
 {
+    pthread_mutex_lock(&g_emit_mu);
     memset(&g_stats, 0, sizeof g_stats);
+    pthread_mutex_unlock(&g_emit_mu);
 }
 
 void decode_loop_get_stats(decode_loop_stats_t *out)
 {
-    if (out != NULL) *out = g_stats;
+    if (out == NULL) return;
+    pthread_mutex_lock(&g_emit_mu);
+    *out = g_stats;
+    pthread_mutex_unlock(&g_emit_mu);
 }
 
 static const char *skip_ws(const char *s)
@@ -170,6 +192,18 @@ int decode_loop_try_command(const char *cmd, char *status_buf, size_t cap)
     if (cap > 0 && status_buf != NULL) status_buf[0] = '\0';
     if (cmd == NULL) return 0;
     const char *p = skip_ws(cmd);
+    if (strncmp(p, "stats", 5) == 0 && (p[5] == '\0' || p[5] == ' ' || p[5] == '\t')) {
+        const char *arg = skip_ws(p + 5);
+        if (strcmp(arg, "latency") == 0) {
+            if (status_buf != NULL && cap > 0) lat_trace_format_status(status_buf, cap);
+        } else if (strcmp(arg, "latency reset") == 0) {
+            lat_trace_reset();
+            if (status_buf != NULL && cap > 0) snprintf(status_buf, cap, "latency: reset");
+        } else if (status_buf != NULL && cap > 0) {
+            snprintf(status_buf, cap, "stats: usage `stats latency [reset]`");
+        }
+        return 1;
+    }
     // "packetheaders" or shorthand "ph"
     const char *rest = NULL;
     if (strncmp(p, "packetheaders", 13) == 0
@@ -205,6 +239,24 @@ int decode_loop_try_command(const char *cmd, char *status_buf, size_t cap)
     return 1;
 }
 
+// When the last successful try_decode_window* call on this thread
+// finished demodulating and unframing. rx_session turns these into the
+// LAT_DEMOD / LAT_RS marks once it knows the frame's origin.
+static _Thread_local uint64_t t_demod_ns;
+static _Thread_local uint64_t t_unframe_ns;
+
+static void note_timing(uint64_t demod_ns)
+{
+    t_demod_ns   = demod_ns;
+    t_unframe_ns = lat_now_ns();
+}
+
+void decode_loop_last_timing(uint64_t *demod_ns, uint64_t *unframe_ns)
+{
+    if (demod_ns)   *demod_ns   = t_demod_ns;
+    if (unframe_ns) *unframe_ns = t_unframe_ns;
+}
+
 ssize_t ax100_unframe_with_rescue(const uint8_t *bytes, size_t n_bytes,
                                   const ax100_opts_t *opts,
                                   int allow_partial_rs,
@@ -279,6 +331,7 @@ int try_decode_window(const int16_t *samples, size_t n_samples,
                                      bits_scratch, &n_bits,
                                      &sync_off, &polarity_used);
         if (rc != 0) break;
+        uint64_t t_demod = lat_now_ns();
         ++attempts;
         if (n_bits == 0) {
             min_offset = sync_off + 1;
@@ -305,6 +358,7 @@ int try_decode_window(const int16_t *samples, size_t n_samples,
             continue;
         }
         *out_packet_len = plen;
+        note_timing(t_demod);
         if (out_sync_off) *out_sync_off = sync_off;
         return 1;
     }
@@ -339,6 +393,7 @@ int try_decode_window_iq(const int16_t *iq_pairs, size_t n_pairs,
                                   bits_scratch, &n_bits,
                                   &sync_off, &polarity_used);
         if (rc != 0) break;
+        uint64_t t_demod = lat_now_ns();
         ++attempts;
         if (n_bits == 0) {
             min_offset = sync_off + 1;
@@ -363,6 +418,7 @@ int try_decode_window_iq(const int16_t *iq_pairs, size_t n_pairs,
             continue;
         }
         *out_packet_len = plen;
+        note_timing(t_demod);
         if (out_sync_off) *out_sync_off = sync_off;
         return 1;
     }
@@ -397,6 +453,7 @@ int try_decode_window_fsk(const int16_t *iq_pairs, size_t n_pairs,
                                       bits_scratch, &n_bits,
                                       &sync_off, &polarity_used);
         if (rc != 0) break;
+        uint64_t t_demod = lat_now_ns();
         ++attempts;
         if (n_bits == 0) {
             min_offset = sync_off + 1;
@@ -421,6 +478,7 @@ int try_decode_window_fsk(const int16_t *iq_pairs, size_t n_pairs,
             continue;
         }
         *out_packet_len = plen;
+        note_timing(t_demod);
         if (out_sync_off) *out_sync_off = sync_off;
         return 1;
     }
@@ -455,6 +513,7 @@ int try_decode_window_viterbi(const int16_t *iq_pairs, size_t n_pairs,
                                           bits_scratch, &n_bits,
                                           &sync_off, &polarity_used);
         if (rc != 0) break;
+        uint64_t t_demod = lat_now_ns();
         ++attempts;
         if (n_bits == 0) {
             min_offset = sync_off + 1;
@@ -479,12 +538,85 @@ int try_decode_window_viterbi(const int16_t *iq_pairs, size_t n_pairs,
             continue;
         }
         *out_packet_len = plen;
+        note_timing(t_demod);
         if (out_sync_off) *out_sync_off = sync_off;
         return 1;
     }
     return 0;
 }
 
+int decode_loop_check_crc(const uint8_t *packet, ssize_t *plen,
+                          uint32_t *computed, uint32_t *le, uint32_t *be)
+{
+    uint32_t c = 0, l = 0, b = 0;
+    int status = -1;
+    ssize_t n = *plen;
+    if (n >= 8) {
+        const uint8_t *t = packet + n - 4;
+        c = csp_crc32c(packet, (size_t)(n - 4));
+        l = (uint32_t) t[0] | ((uint32_t) t[1] << 8)
+          | ((uint32_t) t[2] << 16) | ((uint32_t) t[3] << 24);
+        b = ((uint32_t) t[0] << 24) | ((uint32_t) t[1] << 16)
+          | ((uint32_t) t[2] << 8) | (uint32_t) t[3];
+        if (c == l || c == b) {
+            status = 1;
+            *plen = n - 4;
+        } else {
+            status = 0;
+        }
+    }
+    if (computed) *computed = c;
+    if (le)       *le = l;
+    if (be)       *be = b;
+    return status;
+}
+
+void decode_loop_dedup_init(decode_loop_dedup_t *d, uint64_t quant)
+{
+    memset(d, 0, sizeof *d);
+    d->quant = quant ? quant : 1;
+}
+
+int decode_loop_dedup_seen(const decode_loop_dedup_t *d,
+                           uint64_t asm_abs_sample)
+{
+    uint64_t pos_quant = asm_abs_sample / d->quant;
+    int ring_n = d->count < DECODE_LOOP_DEDUP_RING
+               ? d->count : DECODE_LOOP_DEDUP_RING;
+    for (int r = 0; r < ring_n; r++) {
+        if (d->pos_quant[r] == pos_quant) return 1;
+    }
+    return 0;
+}
+
+int decode_loop_dedup_add(decode_loop_dedup_t *d, uint64_t asm_abs_sample)
+{
+    if (decode_loop_dedup_seen(d, asm_abs_sample)) return 0;
+    d->pos_quant[d->idx] = asm_abs_sample / d->quant;
+    d->idx = (d->idx + 1) % DECODE_LOOP_DEDUP_RING;
+    if (d->count < DECODE_LOOP_DEDUP_RING) d->count++;
+    return 1;
+}
+
+void decode_loop_fmt_utc(char *buf, size_t cap)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    struct tm utc;
+    gmtime_r(&tv.tv_sec, &utc);
+    snprintf(buf, cap, "%04d-%02d-%02dT%02d:%02d:%02d.%03ldZ",
+             (utc.tm_year + 1900) % 10000,
+             (utc.tm_mon + 1) % 100, utc.tm_mday % 100,
+             utc.tm_hour % 100, utc.tm_min % 100, utc.tm_sec % 100,
+             (long)(tv.tv_usec / 1000));
+}
+
+static void record_packet_locked(const char *ts,
+                                 const csp_v1_header_t *hdr, int csp_ok,
+                                 const uint8_t *payload, size_t payload_len,
+                                 int golay_errs, int hmac_ok,
+                                 int rs_errs, int crc_status);
+
 void emit_frame(const char *log_path, int quiet, const char *ts,
                 const uint8_t *packet, size_t packet_len,
                 int golay_errs, int hmac_ok,
@@ -495,6 +627,7 @@ void emit_frame(const char *log_path, int quiet, const char *ts,
                 const uint8_t *ref_buf, size_t ref_len,
                 int force_beacon)
 {
+    pthread_mutex_lock(&g_emit_mu);
     char rs_buf[32];
     if (rs_errs == -2)      snprintf(rs_buf, sizeof rs_buf, "UNCORRECTABLE");
     else if (rs_errs < 0)   snprintf(rs_buf, sizeof rs_buf, "off");
@@ -650,10 +783,11 @@ void emit_frame(const char *log_path, int quiet, const char *ts,
     // Record every detected frame, errors or no. csp_ok frames pass the
     // CSP-stripped payload; frames whose CSP didn't decode pass the whole
     // packet so the raw bytes are still captured.
-    decode_loop_record_packet(ts, &hdr, csp_ok,
-                              csp_ok ? payload : packet,
-                              csp_ok ? payload_len : packet_len,
-                              golay_errs, hmac_ok, rs_errs, crc_status);
+    record_packet_locked(ts, &hdr, csp_ok,
+                         csp_ok ? payload : packet,
+                         csp_ok ? payload_len : packet_len,
+                         golay_errs, hmac_ok, rs_errs, crc_status);
+    pthread_mutex_unlock(&g_emit_mu);
 }
 
 void decode_loop_record_packet(const char *ts,
@@ -661,6 +795,19 @@ void decode_loop_record_packet(const char *ts,
                                const uint8_t *payload, size_t payload_len,
                                int golay_errs, int hmac_ok,
                                int rs_errs, int crc_status)
+{
+    pthread_mutex_lock(&g_emit_mu);
+    record_packet_locked(ts, hdr, csp_ok, payload, payload_len,
+                         golay_errs, hmac_ok, rs_errs, crc_status);
+    pthread_mutex_unlock(&g_emit_mu);
+}
+
+// decode_loop_record_packet's body; the caller holds g_emit_mu.
+static void record_packet_locked(const char *ts,
+                                 const csp_v1_header_t *hdr, int csp_ok,
+                                 const uint8_t *payload, size_t payload_len,
+                                 int golay_errs, int hmac_ok,
+                                 int rs_errs, int crc_status)
 {
     if (payload == NULL || payload_len == 0) return;
 
@@ -681,6 +828,7 @@ void decode_loop_record_packet(const char *ts,
         }
     }
     int recognized = (ptype_name != NULL);
+    if (t_satellite != NULL) satellite = t_satellite;
 
     // Tally recognized types. Before the DB-null check so the run
     // summary is right even with --no-db.
@@ -785,6 +933,12 @@ void decode_loop_record_packet(const char *ts,
     const char *obs_session_dir = g_obs_session_dir;
     const char *obs_capture_origin = g_obs_capture_origin;
     pthread_mutex_unlock(&g_obs_mu);
+    // The observer geometry and TLE describe the primary target; a row
+    // from an extra channel leaves them NULL rather than mislabel it.
+    if (t_satellite != NULL) {
+        obs_az = obs_el = obs_range = obs_range_rate = obs_doppler = NAN;
+        obs_tle_id = 0;
+    }
 
     packet_db_record_t rec = {
         .ts_received      = ts_for_db,
@@ -819,6 +973,7 @@ void decode_loop_record_packet(const char *ts,
         .tle_id            = obs_tle_id,
         .session_dir       = obs_session_dir,
         .capture_origin    = obs_capture_origin,
+        .trace_t0_ns       = lat_trace_origin(),
     };
     // Account for the write outcome instead of discarding it. A dropped
     // insert (busy/error) used to vanish here, letting callers mark a
@@ -190,6 +190,44 @@ void emit_frame(const char *log_path, int quiet, const char *ts,
                 const uint8_t *ref_buf, size_t ref_len,
                 int force_beacon);
 
+// CSP CRC32-C trailer check on a decoded packet. With plen >= 8 the
+// last four bytes are compared, in either byte order, against the
+// CRC32-C of the rest; a match strips them from *plen. Returns the
+// crc_status emit_frame takes: 1 matched, 0 mismatched, -1 too short to
+// carry a trailer. computed / le / be (each NULL ok) receive the values
+// emit_frame prints on a mismatch, 0 when the check did not run.
+int decode_loop_check_crc(const uint8_t *packet, ssize_t *plen,
+                          uint32_t *computed, uint32_t *le, uint32_t *be);
+
+// Position-quantised frame dedup. Overlapping windows re-find the same
+// burst, so a frame whose ASM lands in the same bucket of `quant`
+// absolute samples as one of the last DECODE_LOOP_DEDUP_RING accepted
+// frames is a repeat. One ring per decode chain; rx_session,
+// rx_channel and rx_replay all dedup through this.
+#define DECODE_LOOP_DEDUP_RING 64
+
+typedef struct {
+    uint64_t quant;
+    uint64_t pos_quant[DECODE_LOOP_DEDUP_RING];
+    int      idx;
+    int      count;
+} decode_loop_dedup_t;
+
+// Empty the ring and set its bucket width (0 is taken as 1).
+void decode_loop_dedup_init(decode_loop_dedup_t *d, uint64_t quant);
+
+// Whether asm_abs_sample's bucket is already in the ring.
+int decode_loop_dedup_seen(const decode_loop_dedup_t *d,
+                           uint64_t asm_abs_sample);
+
+// Record asm_abs_sample's bucket. Returns 1 if it was new (emit the
+// frame), 0 if it was already there (drop it as a repeat).
+int decode_loop_dedup_add(decode_loop_dedup_t *d, uint64_t asm_abs_sample);
+
+// Wall-clock UTC as "YYYY-MM-DDTHH:MM:SS.mmmZ", the live receivers'
+// emit_frame timestamp.
+void decode_loop_fmt_utc(char *buf, size_t cap);
+
 // Headers toggle. When OFF (the default for live/replay tools), emit_frame
 // hides the AX100 framing line, the CSP v1 header line, the rs_locs and
 // ref_diff lines, the csp_crc32-OK confirmation, and the per-frame hex /
@@ -211,10 +249,18 @@ int  decode_loop_show_headers(void);
 // rx_tui_set_status / stderr / log. Recognised commands:
 //   "packetheaders on"   / "packetheaders off"
 //   "ph on"              / "ph off"
+//   "stats latency"      -- p50/p99 per stage from lat_trace.h
+//   "stats latency reset"
 // Unknown input leaves status_buf empty and returns 0 so the caller can
 // chain its own per-tool commands (sq, spectrum, force-beacon, ...).
 int decode_loop_try_command(const char *cmd, char *status_buf, size_t cap);
 
+// When the last successful try_decode_window* call on the calling
+// thread finished demodulating (sync found, bits out) and unframing
+// (Golay, descrambler, RS done), on lat_now_ns()'s clock. 0 before the
+// first decode. The caller turns these into LAT_DEMOD / LAT_RS marks.
+void decode_loop_last_timing(uint64_t *demod_ns, uint64_t *unframe_ns);
+
 // Forward decl so callers don't need to include packet_db.h here.
 typedef struct packet_db packet_db_t;
 
@@ -245,6 +291,15 @@ void decode_loop_record_packet(const char *ts,
                                int golay_errs, int hmac_ok,
                                int rs_errs, int crc_status);
 
+// Tag every row recorded from the calling thread with `name` as its
+// satellite, overriding the beacon-derived one, and leave the observer
+// geometry / TLE columns NULL (those track the primary target). Used by
+// the extra receive channels (rx_channel), one thread per satellite.
+// The string is borrowed for the thread's lifetime; NULL or "" clears.
+// emit_frame and decode_loop_record_packet are safe to call from
+// several such threads at once.
+void decode_loop_set_thread_satellite(const char *name);
+
 // Cumulative decode stats, tallied by emit_frame and
 // decode_loop_record_packet as a run proceeds. Process-global, like the
 // packet-headers toggle. Lets a caller report the real funnel — how many
@@ -0,0 +1,317 @@
+/*
+
+   Simple Satellite Operations  lat_trace.c
+
+   Frame latency tracing. See lat_trace.h.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+
+#include "lat_trace.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LAT_RING_EVENTS 4096u   // per thread, power of two
+#define LAT_SUB_BITS    5       // 32 sub-buckets an octave: <= 3.1 % wide
+#define LAT_SUB         (1u << LAT_SUB_BITS)
+#define LAT_MAX_BITS    37      // clamp at ~137 s
+#define LAT_MAX_NS      ((UINT64_C(1) << LAT_MAX_BITS) - 1)
+#define LAT_BUCKETS     ((LAT_MAX_BITS - LAT_SUB_BITS + 1) * LAT_SUB)
+#define LAT_STAGE_BITS  3
+
+// One thread's marks, single producer (the owning thread) and single
+// consumer (whoever holds g_mu). An event packs the latency above the
+// stage number. A ring outlives its thread: the thread-exit destructor
+// only releases it, the collector still drains what it left, and the
+// next new thread adopts it.
+typedef struct lat_ring {
+    struct lat_ring *next;
+    int              owned;
+    uint64_t         head;      // producer
+    uint64_t         tail;      // consumer
+    uint64_t         dropped;
+    uint64_t         ev[LAT_RING_EVENTS];
+} lat_ring_t;
+
+typedef struct lat_hist {
+    uint64_t count, sum_ns, min_ns, max_ns;
+    uint64_t bucket[LAT_BUCKETS];
+} lat_hist_t;
+
+static pthread_mutex_t g_mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t  g_once = PTHREAD_ONCE_INIT;
+static pthread_key_t   g_key;
+static lat_ring_t     *g_rings;                 // guarded by g_mu
+static lat_hist_t      g_hist[LAT_STAGE__COUNT]; // guarded by g_mu
+static uint64_t        g_dropped;               // guarded by g_mu
+
+static _Thread_local lat_ring_t *t_ring;
+static _Thread_local uint64_t    t_origin;
+
+static const char *const g_stage_names[LAT_STAGE__COUNT] = {
+    "window", "demod", "rs", "db", "panel", "ipc",
+};
+
+const char *lat_stage_name(lat_stage_t stage)
+{
+    return (unsigned)stage < LAT_STAGE__COUNT ? g_stage_names[stage] : "?";
+}
+
+static void ring_release(void *p)
+{
+    lat_ring_t *r = p;
+    if (r != NULL) __atomic_store_n(&r->owned, 0, __ATOMIC_RELEASE);
+}
+
+static void key_init(void)
+{
+    pthread_key_create(&g_key, ring_release);
+}
+
+static lat_ring_t *ring_get(void)
+{
+    if (t_ring != NULL) return t_ring;
+    pthread_once(&g_once, key_init);
+    pthread_mutex_lock(&g_mu);
+    lat_ring_t *r = g_rings;
+    while (r != NULL && __atomic_load_n(&r->owned, __ATOMIC_ACQUIRE)) r = r->next;
+    if (r == NULL) {
+        r = calloc(1, sizeof *r);
+        if (r != NULL) {
+            r->next = g_rings;
+            g_rings = r;
+        }
+    }
+    if (r != NULL) __atomic_store_n(&r->owned, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&g_mu);
+    if (r != NULL) {
+        t_ring = r;
+        pthread_setspecific(g_key, r);
+    }
+    return r;
+}
+
+void lat_trace_mark_at(lat_stage_t stage, uint64_t t0_ns, uint64_t t_ns)
+{
+    if (t0_ns == 0 || (unsigned)stage >= LAT_STAGE__COUNT) return;
+    lat_ring_t *r = ring_get();
+    if (r == NULL) return;
+    uint64_t ns = t_ns > t0_ns ? t_ns - t0_ns : 0;
+    if (ns > LAT_MAX_NS) ns = LAT_MAX_NS;
+    uint64_t head = r->head;
+    if (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) >= LAT_RING_EVENTS) {
+        __atomic_add_fetch(&r->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    r->ev[head & (LAT_RING_EVENTS - 1)] = (ns << LAT_STAGE_BITS) | (uint64_t)stage;
+    __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void lat_trace_mark(lat_stage_t stage, uint64_t t0_ns)
+{
+    if (t0_ns == 0) return;
+    lat_trace_mark_at(stage, t0_ns, lat_now_ns());
+}
+
+void lat_trace_set_origin(uint64_t t0_ns)
+{
+    t_origin = t0_ns;
+}
+
+uint64_t lat_trace_origin(void)
+{
+    return t_origin;
+}
+
+// Log-linear bucket: exact below 2 * LAT_SUB ns, then LAT_SUB buckets
+// per power of two.
+static unsigned bucket_of(uint64_t ns)
+{
+    if (ns < 2 * LAT_SUB) return (unsigned)ns;
+    unsigned msb = 63u - (unsigned)__builtin_clzll(ns);
+    unsigned e   = msb - LAT_SUB_BITS;
+    return e * LAT_SUB + (unsigned)(ns >> e);
+}
+
+// Largest value that lands in bucket idx.
+static uint64_t bucket_high(unsigned idx)
+{
+    if (idx < 2 * LAT_SUB) return idx;
+    unsigned e = idx / LAT_SUB - 1;
+    uint64_t m = idx - e * LAT_SUB;
+    return ((m + 1) << e) - 1;
+}
+
+static void hist_add(lat_hist_t *h, uint64_t ns)
+{
+    if (h->count == 0 || ns < h->min_ns) h->min_ns = ns;
+    if (ns > h->max_ns) h->max_ns = ns;
+    h->count++;
+    h->sum_ns += ns;
+    h->bucket[bucket_of(ns)]++;
+}
+
+static void collect_locked(void)
+{
+    for (lat_ring_t *r = g_rings; r != NULL; r = r->next) {
+        uint64_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+        uint64_t tail = r->tail;
+        for (; tail != head; tail++) {
+            uint64_t ev = r->ev[tail & (LAT_RING_EVENTS - 1)];
+            unsigned stage = (unsigned)(ev & ((1u << LAT_STAGE_BITS) - 1));
+            if (stage < LAT_STAGE__COUNT) hist_add(&g_hist[stage], ev >> LAT_STAGE_BITS);
+        }
+        __atomic_store_n(&r->tail, tail, __ATOMIC_RELEASE);
+        g_dropped += __atomic_exchange_n(&r->dropped, 0, __ATOMIC_RELAXED);
+    }
+}
+
+void lat_trace_collect(void)
+{
+    pthread_mutex_lock(&g_mu);
+    collect_locked();
+    pthread_mutex_unlock(&g_mu);
+}
+
+void lat_trace_reset(void)
+{
+    pthread_mutex_lock(&g_mu);
+    collect_locked();
+    memset(g_hist, 0, sizeof g_hist);
+    g_dropped = 0;
+    pthread_mutex_unlock(&g_mu);
+}
+
+// Value at or below which a share q of the samples fell (the bucket's
+// top, capped at the true maximum). Caller holds g_mu.
+static uint64_t hist_quantile(const lat_hist_t *h, double q)
+{
+    if (h->count == 0) return 0;
+    uint64_t want = (uint64_t)ceil(q * (double)h->count);
+    if (want < 1) want = 1;
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < LAT_BUCKETS; i++) {
+        seen += h->bucket[i];
+        if (seen >= want) {
+            uint64_t v = bucket_high(i);
+            return v < h->max_ns ? v : h->max_ns;
+        }
+    }
+    return h->max_ns;
+}
+
+static void summary_locked(lat_stage_t stage, lat_summary_t *out)
+{
+    memset(out, 0, sizeof *out);
+    if ((unsigned)stage >= LAT_STAGE__COUNT) return;
+    const lat_hist_t *h = &g_hist[stage];
+    out->count = h->count;
+    if (h->count == 0) return;
+    out->min_ms  = (double)h->min_ns * 1e-6;
+    out->p50_ms  = (double)hist_quantile(h, 0.50)  * 1e-6;
+    out->p90_ms  = (double)hist_quantile(h, 0.90)  * 1e-6;
+    out->p99_ms  = (double)hist_quantile(h, 0.99)  * 1e-6;
+    out->p999_ms = (double)hist_quantile(h, 0.999) * 1e-6;
+    out->max_ms  = (double)h->max_ns * 1e-6;
+    out->mean_ms = (double)h->sum_ns / (double)h->count * 1e-6;
+}
+
+void lat_trace_summary(lat_stage_t stage, lat_summary_t *out)
+{
+    if (out == NULL) return;
+    pthread_mutex_lock(&g_mu);
+    collect_locked();
+    summary_locked(stage, out);
+    pthread_mutex_unlock(&g_mu);
+}
+
+uint64_t lat_trace_dropped(void)
+{
+    pthread_mutex_lock(&g_mu);
+    collect_locked();
+    uint64_t d = g_dropped;
+    pthread_mutex_unlock(&g_mu);
+    return d;
+}
+
+// Short ms figure for the status row: one decimal below 10 ms.
+static void fmt_ms(char *buf, size_t cap, double ms)
+{
+    if (ms < 10.0) snprintf(buf, cap, "%.1f", ms);
+    else           snprintf(buf, cap, "%.0f", ms);
+}
+
+void lat_trace_format_status(char *buf, size_t cap)
+{
+    if (buf == NULL || cap == 0) return;
+    lat_summary_t s[LAT_STAGE__COUNT];
+    pthread_mutex_lock(&g_mu);
+    collect_locked();
+    for (int i = 0; i < LAT_STAGE__COUNT; i++) summary_locked((lat_stage_t)i, &s[i]);
+    uint64_t dropped = g_dropped;
+    pthread_mutex_unlock(&g_mu);
+
+    if (s[LAT_WINDOW].count == 0) {
+        snprintf(buf, cap, "latency: no frames traced yet");
+        return;
+    }
+    size_t len = (size_t)snprintf(buf, cap, "latency ms p50/p99, %llu frames:",
+                                  (unsigned long long)s[LAT_WINDOW].count);
+    for (int i = 0; i < LAT_STAGE__COUNT && len < cap; i++) {
+        if (s[i].count == 0) {
+            len += (size_t)snprintf(buf + len, cap - len, " %s -", g_stage_names[i]);
+            continue;
+        }
+        char a[16], b[16];
+        fmt_ms(a, sizeof a, s[i].p50_ms);
+        fmt_ms(b, sizeof b, s[i].p99_ms);
+        len += (size_t)snprintf(buf + len, cap - len, " %s %s/%s", g_stage_names[i], a, b);
+    }
+    if (dropped > 0 && len < cap)
+        snprintf(buf + len, cap - len, " (%llu marks dropped)", (unsigned long long)dropped);
+}
+
+int lat_trace_write_report(const char *path, const char *title)
+{
+    if (path == NULL) return -1;
+    FILE *f = fopen(path, "w");
+    if (f == NULL) return -1;
+    pthread_mutex_lock(&g_mu);
+    collect_locked();
+    fprintf(f, "# simple_sat_ops frame latency%s%s\n",
+            title && title[0] ? ": " : "", title ? title : "");
+    fprintf(f, "# milliseconds from the frame's last sample reaching the host to each stage\n");
+    fprintf(f, "# %-7s %8s %9s %9s %9s %9s %9s %9s %9s\n",
+            "stage", "frames", "min", "p50", "p90", "p99", "p99.9", "max", "mean");
+    for (int i = 0; i < LAT_STAGE__COUNT; i++) {
+        lat_summary_t s;
+        summary_locked((lat_stage_t)i, &s);
+        fprintf(f, "%-9s %8llu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+                g_stage_names[i], (unsigned long long)s.count, s.min_ms, s.p50_ms,
+                s.p90_ms, s.p99_ms, s.p999_ms, s.max_ms, s.mean_ms);
+    }
+    fprintf(f, "# marks dropped (ring full): %llu\n", (unsigned long long)g_dropped);
+    fprintf(f, "#\n# histogram: stage, bucket top (ms), frames in bucket, cumulative share\n");
+    for (int i = 0; i < LAT_STAGE__COUNT; i++) {
+        const lat_hist_t *h = &g_hist[i];
+        uint64_t seen = 0;
+        for (unsigned b = 0; b < LAT_BUCKETS && seen < h->count; b++) {
+            if (h->bucket[b] == 0) continue;
+            seen += h->bucket[b];
+            fprintf(f, "%s,%.4f,%llu,%.6f\n", g_stage_names[i],
+                    (double)bucket_high(b) * 1e-6, (unsigned long long)h->bucket[b],
+                    (double)seen / (double)h->count);
+        }
+    }
+    pthread_mutex_unlock(&g_mu);
+    return fclose(f) == 0 ? 0 : -1;
+}
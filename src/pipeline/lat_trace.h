@@ -0,0 +1,97 @@
+/*
+
+    Simple Satellite Operations  lat_trace.h
+
+    Frame latency tracing, from the antenna sample to the DB row and the
+    viewer's screen. A traced frame carries its origin: the monotonic
+    time its last sample reached the RX worker (the host time the SDR
+    read landed, so time spent queued in the capture ring counts). Each
+    stage the frame passes marks "now - origin" into a ring owned by the
+    marking thread -- no lock, no allocation after the thread's first
+    mark -- and a collector folds the rings into one log-linear (HDR
+    style, ~3 % buckets) histogram per stage.
+
+    Every stage is measured from the same origin, so the histograms are
+    cumulative: the LAT_IPC row is the whole antenna-to-viewer delay,
+    and a jump between adjacent rows is the cost of that step.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAT_TRACE_H
+#define LAT_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef enum lat_stage {
+    LAT_WINDOW = 0,  // the decode window holding the frame is handed to the decoder
+    LAT_DEMOD,       // demodulator done: bits out, sync found
+    LAT_RS,          // unframed: Golay, descrambler and Reed-Solomon done
+    LAT_DB,          // packet DB row committed
+    LAT_PANEL,       // drawn in the operator's RX panel
+    LAT_IPC,         // STATE carrying it broadcast to connected viewers
+    LAT_STAGE__COUNT
+} lat_stage_t;
+
+// The clock every mark is taken on. 0 never occurs in practice and
+// means "untraced" wherever an origin is passed around.
+static inline uint64_t lat_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Record that the frame with origin t0_ns reached stage now (or at
+// t_ns). No-op for t0_ns == 0. Safe from any thread; a full ring drops
+// the mark and counts it.
+void lat_trace_mark(lat_stage_t stage, uint64_t t0_ns);
+void lat_trace_mark_at(lat_stage_t stage, uint64_t t0_ns, uint64_t t_ns);
+
+// The origin of the frame this thread is handling, for code further
+// down the same call chain (decode_loop_record_packet stamps it on the
+// DB record). 0 when none.
+void     lat_trace_set_origin(uint64_t t0_ns);
+uint64_t lat_trace_origin(void);
+
+// Fold every thread's pending marks into the histograms. Cheap when
+// nothing is pending; the operator loop calls it every tick so a ring
+// never fills. The readers below collect first.
+void lat_trace_collect(void);
+
+// Drop everything recorded so far (e.g. after the per-pass dump).
+void lat_trace_reset(void);
+
+typedef struct lat_summary {
+    uint64_t count;
+    double   min_ms, p50_ms, p90_ms, p99_ms, p999_ms, max_ms, mean_ms;
+} lat_summary_t;
+
+void        lat_trace_summary(lat_stage_t stage, lat_summary_t *out);
+uint64_t    lat_trace_dropped(void);   // marks lost to a full ring
+const char *lat_stage_name(lat_stage_t stage);
+
+// One line for the ":stats latency" status row: p50/p99 per stage.
+void lat_trace_format_status(char *buf, size_t cap);
+
+// Full report: a summary table, then every non-empty histogram bucket
+// with its cumulative share. title goes in the header comment. 0 on
+// success, -1 if the file can't be written.
+int lat_trace_write_report(const char *path, const char *title);
+
+#endif // LAT_TRACE_H
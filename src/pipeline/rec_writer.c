@@ -0,0 +1,638 @@
+/*
+
+   Simple Satellite Operations  rec_writer.c
+
+   The recording writer thread. See rec_writer.h.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+
+#define _GNU_SOURCE  // fallocate, sync_file_range
+
+#include "rec_writer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// io_uring through the raw syscalls: the kernel header is all it takes,
+// so there is no liburing dependency to probe for.
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>) && __has_include(<sys/syscall.h>)
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#      define REC_HAVE_URING 1
+#    endif
+#  endif
+#endif
+
+#define REC_BATCH_MAX 32
+
+enum { OP_DATA, OP_PATCH, OP_CLOSE };
+
+typedef struct rec_block {
+    struct rec_block *next;
+    rec_file_t       *file;
+    int               op;
+    uint64_t          off;   // file offset of data[0] (OP_CLOSE: final size)
+    size_t            len;
+    uint8_t          *data;  // block_bytes, page aligned
+} rec_block_t;
+
+struct rec_file {
+    rec_writer_t *w;
+    int           fd;
+    // Appender side.
+    rec_block_t  *cur;        // block being filled, NULL between blocks
+    uint64_t      size;       // bytes appended
+    // Writer side.
+    uint64_t      alloc_end;  // fallocate'd up to here
+    uint64_t      sync_from;  // writeback started below this
+    uint64_t      sync_prev;  // start of the window before it
+    int           no_fallocate;
+};
+
+#ifdef REC_HAVE_URING
+typedef struct {
+    int                  fd;
+    unsigned            *sq_tail, *sq_mask, *sq_array;
+    unsigned            *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void                *sq_map, *cq_map;
+    size_t               sq_len, cq_len, sqe_len;
+} uring_t;
+#endif
+
+struct rec_writer {
+    size_t          block_bytes;
+    int             n_blocks;
+    rec_block_t    *blocks;
+    uint8_t        *mem;
+    rec_block_t    *free_list;
+    rec_block_t    *q_head, *q_tail;
+    int             open_files;
+
+    pthread_mutex_t mu;
+    pthread_cond_t  cv_work;   // writer: something queued / quit
+    pthread_cond_t  cv_free;   // appenders: a block came back
+    pthread_t       thread;
+    int             quit;
+    rec_writer_stats_t st;     // under mu
+
+    // Writer thread only.
+#ifdef REC_HAVE_URING
+    uring_t         ring;
+#endif
+    int             ring_ok;
+};
+
+static double mono_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e3 + (double) ts.tv_nsec * 1e-6;
+}
+
+static int pwrite_full(int fd, const uint8_t *p, size_t len, uint64_t off)
+{
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, (off_t) off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) {
+            errno = EIO;
+            return -1;
+        }
+        p   += n;
+        off += (uint64_t) n;
+        len -= (size_t) n;
+    }
+    return 0;
+}
+
+// ---- io_uring --------------------------------------------------------------
+
+#ifdef REC_HAVE_URING
+static void uring_free(uring_t *r)
+{
+    if (r->sqes != NULL) munmap(r->sqes, r->sqe_len);
+    if (r->cq_map != NULL && r->cq_map != r->sq_map) munmap(r->cq_map, r->cq_len);
+    if (r->sq_map != NULL) munmap(r->sq_map, r->sq_len);
+    if (r->fd >= 0) close(r->fd);
+    memset(r, 0, sizeof *r);
+    r->fd = -1;
+}
+
+static int uring_init(uring_t *r)
+{
+    struct io_uring_params p;
+    memset(&p, 0, sizeof p);
+    memset(r, 0, sizeof *r);
+    r->fd = (int) syscall(__NR_io_uring_setup, REC_BATCH_MAX, &p);
+    if (r->fd < 0) {
+        r->fd = -1;
+        return -1;
+    }
+    r->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    int single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+        if (r->cq_len > r->sq_len) r->sq_len = r->cq_len;
+        r->cq_len = r->sq_len;
+    }
+    void *sq = mmap(NULL, r->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    r->fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED) goto fail;
+    r->sq_map = sq;
+    void *cq = sq;
+    if (!single) {
+        cq = mmap(NULL, r->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  r->fd, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED) goto fail;
+    }
+    r->cq_map  = cq;
+    r->sqe_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(NULL, r->sqe_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      r->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) goto fail;
+    r->sqes = sqes;
+
+    r->sq_tail  = (unsigned *) ((char *) sq + p.sq_off.tail);
+    r->sq_mask  = (unsigned *) ((char *) sq + p.sq_off.ring_mask);
+    r->sq_array = (unsigned *) ((char *) sq + p.sq_off.array);
+    r->cq_head  = (unsigned *) ((char *) cq + p.cq_off.head);
+    r->cq_tail  = (unsigned *) ((char *) cq + p.cq_off.tail);
+    r->cq_mask  = (unsigned *) ((char *) cq + p.cq_off.ring_mask);
+    r->cqes     = (struct io_uring_cqe *) ((char *) cq + p.cq_off.cqes);
+    return 0;
+
+fail:
+    uring_free(r);
+    return -1;
+}
+
+// Submit one write per block and wait for them all. res[i] receives the
+// completion result, or stays LONG_MIN if that block never went in (the
+// caller pwrites it). Returns -1 when the ring itself failed.
+static int uring_write(uring_t *r, rec_block_t **b, int n, long *res)
+{
+    unsigned tail = *r->sq_tail;   // only this thread moves it
+    for (int i = 0; i < n; ++i) {
+        unsigned idx = tail & *r->sq_mask;
+        struct io_uring_sqe *sqe = &r->sqes[idx];
+        memset(sqe, 0, sizeof *sqe);
+        sqe->opcode    = IORING_OP_WRITE;
+        sqe->fd        = b[i]->file->fd;
+        sqe->addr      = (uint64_t) (uintptr_t) b[i]->data;
+        sqe->len       = (uint32_t) b[i]->len;
+        sqe->off       = b[i]->off;
+        sqe->user_data = (uint64_t) i;
+        r->sq_array[idx] = idx;
+        tail++;
+    }
+    __atomic_store_n(r->sq_tail, tail, __ATOMIC_RELEASE);
+
+    int submitted = 0, reaped = 0, failed = 0;
+    while (reaped < n && !(failed && reaped == submitted)) {
+        unsigned to_submit = failed ? 0u : (unsigned) (n - submitted);
+        long rc = syscall(__NR_io_uring_enter, r->fd, to_submit, 1u,
+                          IORING_ENTER_GETEVENTS, NULL, 0);
+        if (rc < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            // Take back what the kernel never consumed, then only wait
+            // for what is already in flight.
+            if (!failed) {
+                tail -= (unsigned) (n - submitted);
+                __atomic_store_n(r->sq_tail, tail, __ATOMIC_RELEASE);
+                failed = 1;
+                continue;
+            }
+            break;
+        }
+        if (!failed) submitted += (int) rc;
+        unsigned head = *r->cq_head;
+        while (head != __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE)) {
+            const struct io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+            if (cqe->user_data < (uint64_t) n) res[cqe->user_data] = cqe->res;
+            head++;
+            reaped++;
+        }
+        __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    }
+    return failed ? -1 : 0;
+}
+#endif
+
+// ---- writer thread ----------------------------------------------------------
+
+// Grow the file ahead of the data so the filesystem can hand out long
+// extents, without changing the visible size.
+static void prealloc(rec_file_t *f, uint64_t end)
+{
+#ifdef __linux__
+    if (f->no_fallocate || end <= f->alloc_end) return;
+    uint64_t step = REC_WRITER_PREALLOC_BYTES;
+    uint64_t want = end - f->alloc_end > step ? end - f->alloc_end : step;
+    if (fallocate(f->fd, FALLOC_FL_KEEP_SIZE, (off_t) f->alloc_end, (off_t) want) == 0)
+        f->alloc_end += want;
+    else
+        f->no_fallocate = 1;   // unsupported here, or the disk is full
+#else
+    (void) f;
+    (void) end;
+#endif
+}
+
+// Start writeback of each REC_WRITER_SYNC_BYTES window as it completes
+// and wait for the one before it, so the page cache never holds more
+// than two windows of this file dirty.
+static void writeback(rec_file_t *f, uint64_t end)
+{
+#ifdef __linux__
+    if (end - f->sync_from < REC_WRITER_SYNC_BYTES) return;
+    sync_file_range(f->fd, (off_t) f->sync_from, (off_t) (end - f->sync_from),
+                    SYNC_FILE_RANGE_WRITE);
+    if (f->sync_prev < f->sync_from) {
+        sync_file_range(f->fd, (off_t) f->sync_prev, (off_t) (f->sync_from - f->sync_prev),
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE
+                        | SYNC_FILE_RANGE_WAIT_AFTER);
+    }
+    f->sync_prev = f->sync_from;
+    f->sync_from = end;
+#else
+    (void) f;
+    (void) end;
+#endif
+}
+
+static void release(rec_writer_t *w, rec_block_t **b, int n,
+                    uint64_t written, long errors, double batch_ms)
+{
+    pthread_mutex_lock(&w->mu);
+    for (int i = 0; i < n; ++i) {
+        b[i]->next   = w->free_list;
+        b[i]->file   = NULL;
+        w->free_list = b[i];
+    }
+    w->st.queue_depth   -= n;
+    w->st.bytes_written += written;
+    w->st.write_errors  += errors;
+    if (batch_ms >= 0.0) {
+        w->st.last_batch_ms = batch_ms;
+        if (batch_ms > w->st.max_batch_ms) w->st.max_batch_ms = batch_ms;
+    }
+    w->st.uring = w->ring_ok;
+    pthread_cond_broadcast(&w->cv_free);
+    pthread_mutex_unlock(&w->mu);
+}
+
+static void write_batch(rec_writer_t *w, rec_block_t **b, int n)
+{
+    double t0 = mono_ms();
+    long res[REC_BATCH_MAX];
+    for (int i = 0; i < n; ++i) {
+        res[i] = LONG_MIN;
+        prealloc(b[i]->file, b[i]->off + b[i]->len);
+    }
+#ifdef REC_HAVE_URING
+    if (w->ring_ok && uring_write(&w->ring, b, n, res) != 0) {
+        fprintf(stderr, "rec_writer: io_uring failed (%s); using pwrite\n", strerror(errno));
+        uring_free(&w->ring);
+        w->ring_ok = 0;
+    }
+#endif
+    uint64_t written = 0;
+    long errors = 0;
+    for (int i = 0; i < n; ++i) {
+        rec_file_t *f = b[i]->file;
+        size_t done = 0;
+        if (res[i] >= 0) {
+            done = (size_t) res[i] < b[i]->len ? (size_t) res[i] : b[i]->len;
+        } else if (res[i] == -EINVAL && w->ring_ok) {
+            // Kernel older than IORING_OP_WRITE (5.6): stay on pwrite.
+#ifdef REC_HAVE_URING
+            uring_free(&w->ring);
+#endif
+            w->ring_ok = 0;
+        }
+        // Short, failed or never-submitted writes finish synchronously.
+        if (done == b[i]->len
+            || pwrite_full(f->fd, b[i]->data + done, b[i]->len - done, b[i]->off + done) == 0) {
+            written += b[i]->len;
+            writeback(f, b[i]->off + b[i]->len);
+        } else {
+            errors++;
+        }
+    }
+    release(w, b, n, written, errors, mono_ms() - t0);
+}
+
+static void run_control(rec_writer_t *w, rec_block_t *b)
+{
+    rec_file_t *f = b->file;
+    long errors = 0;
+    if (b->op == OP_PATCH) {
+        if (pwrite_full(f->fd, b->data, b->len, b->off) != 0) errors++;
+    } else {
+        // Give back the preallocation past the end of the data.
+        if (f->alloc_end > b->off && ftruncate(f->fd, (off_t) b->off) != 0) errors++;
+        if (close(f->fd) != 0) errors++;
+        free(f);
+    }
+    release(w, &b, 1, 0, errors, -1.0);
+}
+
+static void *writer_fn(void *arg)
+{
+    rec_writer_t *w = arg;
+    pthread_mutex_lock(&w->mu);
+    for (;;) {
+        while (w->q_head == NULL && !w->quit) pthread_cond_wait(&w->cv_work, &w->mu);
+        if (w->q_head == NULL) break;   // quit, and the queue is drained
+        rec_block_t *list = w->q_head;
+        w->q_head = w->q_tail = NULL;
+        pthread_mutex_unlock(&w->mu);
+
+        // Runs of data blocks go out as one batch; a patch or close waits
+        // for the data queued ahead of it.
+        rec_block_t *batch[REC_BATCH_MAX];
+        int nb = 0;
+        while (list != NULL) {
+            rec_block_t *b = list;
+            list = b->next;
+            if (b->op == OP_DATA) {
+                batch[nb++] = b;
+                if (nb == REC_BATCH_MAX) {
+                    write_batch(w, batch, nb);
+                    nb = 0;
+                }
+                continue;
+            }
+            if (nb > 0) {
+                write_batch(w, batch, nb);
+                nb = 0;
+            }
+            run_control(w, b);
+        }
+        if (nb > 0) write_batch(w, batch, nb);
+        pthread_mutex_lock(&w->mu);
+    }
+    w->st.active = 0;
+    pthread_mutex_unlock(&w->mu);
+    return NULL;
+}
+
+// ---- public -----------------------------------------------------------------
+
+rec_writer_t *rec_writer_start(size_t block_bytes, int n_blocks)
+{
+    if (block_bytes == 0) block_bytes = REC_WRITER_BLOCK_BYTES;
+    if (n_blocks <= 0)    n_blocks    = REC_WRITER_BLOCKS;
+    if (n_blocks < 4)     n_blocks    = 4;
+    // Page multiples keep every block's buffer page aligned.
+    block_bytes = (block_bytes + 4095u) & ~(size_t) 4095u;
+
+    rec_writer_t *w = calloc(1, sizeof *w);
+    if (w == NULL) return NULL;
+    w->block_bytes = block_bytes;
+    w->n_blocks    = n_blocks;
+    w->blocks      = calloc((size_t) n_blocks, sizeof *w->blocks);
+    void *mem = NULL;
+    if (w->blocks == NULL
+        || posix_memalign(&mem, 4096, block_bytes * (size_t) n_blocks) != 0) {
+        free(w->blocks);
+        free(w);
+        return NULL;
+    }
+    w->mem = mem;
+    for (int i = n_blocks - 1; i >= 0; --i) {
+        w->blocks[i].data = w->mem + (size_t) i * block_bytes;
+        w->blocks[i].next = w->free_list;
+        w->free_list = &w->blocks[i];
+    }
+
+#ifdef REC_HAVE_URING
+    // SSO_REC_NO_URING=1 forces pwrite, for A/B runs on a slow disk.
+    const char *no = getenv("SSO_REC_NO_URING");
+    w->ring.fd = -1;
+    if (!(no && no[0] == '1') && uring_init(&w->ring) == 0) w->ring_ok = 1;
+#endif
+    w->st.active = 1;
+    w->st.blocks = n_blocks;
+    w->st.uring  = w->ring_ok;
+
+    pthread_mutex_init(&w->mu, NULL);
+    pthread_cond_init(&w->cv_work, NULL);
+    pthread_cond_init(&w->cv_free, NULL);
+    if (pthread_create(&w->thread, NULL, writer_fn, w) != 0) {
+        pthread_cond_destroy(&w->cv_free);
+        pthread_cond_destroy(&w->cv_work);
+        pthread_mutex_destroy(&w->mu);
+#ifdef REC_HAVE_URING
+        if (w->ring_ok) uring_free(&w->ring);
+#endif
+        free(w->mem);
+        free(w->blocks);
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+void rec_writer_stop(rec_writer_t *w)
+{
+    if (w == NULL) return;
+    pthread_mutex_lock(&w->mu);
+    w->quit = 1;
+    pthread_cond_signal(&w->cv_work);
+    pthread_mutex_unlock(&w->mu);
+    pthread_join(w->thread, NULL);
+#ifdef REC_HAVE_URING
+    if (w->ring_ok) uring_free(&w->ring);
+#endif
+    pthread_cond_destroy(&w->cv_free);
+    pthread_cond_destroy(&w->cv_work);
+    pthread_mutex_destroy(&w->mu);
+    free(w->mem);
+    free(w->blocks);
+    free(w);
+}
+
+void rec_writer_stats(rec_writer_t *w, rec_writer_stats_t *out)
+{
+    if (out == NULL) return;
+    if (w == NULL) {
+        memset(out, 0, sizeof *out);
+        return;
+    }
+    pthread_mutex_lock(&w->mu);
+    *out = w->st;
+    pthread_mutex_unlock(&w->mu);
+}
+
+// A free block, waiting for the writer to return one if the pool is dry.
+static rec_block_t *take_block(rec_writer_t *w)
+{
+    pthread_mutex_lock(&w->mu);
+    if (w->free_list == NULL) {
+        double t0 = mono_ms();
+        w->st.producer_waits++;
+        while (w->free_list == NULL) pthread_cond_wait(&w->cv_free, &w->mu);
+        double dt = mono_ms() - t0;
+        w->st.stall_ms += dt;
+        if (dt > w->st.max_stall_ms) w->st.max_stall_ms = dt;
+    }
+    rec_block_t *b = w->free_list;
+    w->free_list = b->next;
+    pthread_mutex_unlock(&w->mu);
+    b->next = NULL;
+    b->len  = 0;
+    return b;
+}
+
+static void queue_block(rec_writer_t *w, rec_block_t *b)
+{
+    pthread_mutex_lock(&w->mu);
+    b->next = NULL;
+    if (w->q_tail != NULL) w->q_tail->next = b;
+    else                   w->q_head = b;
+    w->q_tail = b;
+    w->st.queue_depth++;
+    if (w->st.queue_depth > w->st.queue_max_depth) w->st.queue_max_depth = w->st.queue_depth;
+    if (b->op == OP_DATA) w->st.bytes_queued += b->len;
+    pthread_cond_signal(&w->cv_work);
+    pthread_mutex_unlock(&w->mu);
+}
+
+rec_file_t *rec_file_open(rec_writer_t *w, const char *path)
+{
+    if (w == NULL || path == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+    // Every open file may hold a block it is filling; keep two spare so
+    // the writer always has something to return.
+    pthread_mutex_lock(&w->mu);
+    int full = w->open_files + 2 >= w->n_blocks;
+    if (!full) w->open_files++;
+    pthread_mutex_unlock(&w->mu);
+    if (full) {
+        errno = EMFILE;
+        return NULL;
+    }
+    rec_file_t *f = calloc(1, sizeof *f);
+    int fd = f ? open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : -1;
+    if (fd < 0) {
+        int e = f ? errno : ENOMEM;
+        free(f);
+        pthread_mutex_lock(&w->mu);
+        w->open_files--;
+        pthread_mutex_unlock(&w->mu);
+        errno = e;
+        return NULL;
+    }
+    f->w  = w;
+    f->fd = fd;
+    return f;
+}
+
+int rec_file_write(rec_file_t *f, const void *data, size_t len)
+{
+    if (f == NULL) return -1;
+    rec_writer_t *w = f->w;
+    const uint8_t *p = data;
+    while (len > 0) {
+        if (f->cur == NULL) {
+            f->cur = take_block(w);
+            f->cur->file = f;
+            f->cur->op   = OP_DATA;
+            f->cur->off  = f->size;
+        }
+        size_t room = w->block_bytes - f->cur->len;
+        size_t n = len < room ? len : room;
+        memcpy(f->cur->data + f->cur->len, p, n);
+        f->cur->len += n;
+        f->size     += n;
+        p   += n;
+        len -= n;
+        if (f->cur->len == w->block_bytes) {
+            queue_block(w, f->cur);
+            f->cur = NULL;
+        }
+    }
+    return 0;
+}
+
+int rec_file_printf(rec_file_t *f, const char *fmt, ...)
+{
+    if (f == NULL) return -1;
+    char line[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof line, fmt, ap);
+    va_end(ap);
+    if (n < 0) return -1;
+    if ((size_t) n >= sizeof line) n = (int) sizeof line - 1;
+    return rec_file_write(f, line, (size_t) n);
+}
+
+void rec_file_flush(rec_file_t *f)
+{
+    if (f == NULL || f->cur == NULL || f->cur->len == 0) return;
+    queue_block(f->w, f->cur);
+    f->cur = NULL;
+}
+
+int rec_file_patch(rec_file_t *f, uint64_t off, const void *data, size_t len)
+{
+    if (f == NULL || len > f->w->block_bytes) return -1;
+    rec_file_flush(f);
+    rec_block_t *b = f->cur ? f->cur : take_block(f->w);
+    f->cur  = NULL;
+    b->file = f;
+    b->op   = OP_PATCH;
+    b->off  = off;
+    b->len  = len;
+    memcpy(b->data, data, len);
+    queue_block(f->w, b);
+    return 0;
+}
+
+uint64_t rec_file_size(const rec_file_t *f)
+{
+    return f ? f->size : 0;
+}
+
+void rec_file_close(rec_file_t *f)
+{
+    if (f == NULL) return;
+    rec_writer_t *w = f->w;
+    rec_file_flush(f);
+    rec_block_t *b = f->cur ? f->cur : take_block(w);
+    f->cur  = NULL;
+    b->file = f;
+    b->op   = OP_CLOSE;
+    b->off  = f->size;
+    b->len  = 0;
+    pthread_mutex_lock(&w->mu);
+    w->open_files--;
+    pthread_mutex_unlock(&w->mu);
+    queue_block(w, b);
+}
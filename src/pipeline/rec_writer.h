@@ -0,0 +1,119 @@
+/*
+
+   Simple Satellite Operations  rec_writer.h
+
+   Background writer for the per-pass recordings: the .wav, the raw .iq
+   and the doppler / lo_offset / burst CSV sidecars. Callers append into
+   a large in-memory block per file and hand full blocks to one writer
+   thread, so a slow USB disk or a page cache busy with writeback costs
+   the RX worker a memcpy instead of a blocked fwrite.
+
+   The writer takes whatever blocks are queued, submits them as one
+   io_uring batch where the kernel offers it (plain pwrite otherwise),
+   grows each file ahead of the data with fallocate, and starts writeback
+   with sync_file_range every few MB so dirty pages never pile up into a
+   multi-second flush. The io_uring, fallocate and sync_file_range steps
+   are Linux-only; elsewhere the writer falls back to pwrite.
+
+   Lossless by design: when every block is queued the appending thread
+   waits for one to come back (back-pressure), and the wait is counted
+   so the panel can show it. Write errors are counted, not retried.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef REC_WRITER_H
+#define REC_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rec_writer rec_writer_t;
+typedef struct rec_file   rec_file_t;
+
+// Block size and pool depth when rec_writer_start gets <= 0. 32 x 1 MiB
+// holds ~80 s of the 96 kHz .iq + .wav pair, far more than any disk
+// hiccup worth riding out.
+#define REC_WRITER_BLOCK_BYTES  (1u << 20)
+#define REC_WRITER_BLOCKS       32
+// Preallocation step and writeback window per file.
+#define REC_WRITER_PREALLOC_BYTES (64u << 20)
+#define REC_WRITER_SYNC_BYTES     (8u << 20)
+
+typedef struct {
+    int      active;           // 1 while the writer thread runs
+    int      uring;            // 1 if batches go through io_uring
+    long     blocks;           // pool size
+    long     queue_depth;      // blocks queued or being written
+    long     queue_max_depth;  // high-water mark of queue_depth
+    long     producer_waits;   // appends that found the pool empty
+    double   stall_ms;         // total time appenders spent waiting
+    double   max_stall_ms;     // longest single wait
+    uint64_t bytes_queued;     // handed to the writer
+    uint64_t bytes_written;    // landed in the page cache
+    long     write_errors;     // failed writes (bytes lost = queued - written)
+    double   last_batch_ms;    // wall time of the latest batch
+    double   max_batch_ms;
+} rec_writer_stats_t;
+
+// Start the writer thread with n_blocks buffers of block_bytes each
+// (<= 0 picks the REC_WRITER_* defaults). NULL on OOM / thread failure.
+rec_writer_t *rec_writer_start(size_t block_bytes, int n_blocks);
+
+// Write out everything queued, join the thread and free the pool.
+// NULL-safe. Close every file first; one still open leaks its fd and its
+// unqueued tail.
+void rec_writer_stop(rec_writer_t *w);
+
+// Copy the counters. Safe from any thread; zeroed for a NULL writer.
+void rec_writer_stats(rec_writer_t *w, rec_writer_stats_t *out);
+
+// Create / truncate path for writing. The open itself is synchronous so
+// the caller learns about a bad path at once. NULL on failure (errno).
+rec_file_t *rec_file_open(rec_writer_t *w, const char *path);
+
+// Append len bytes. Returns 0, or -1 on a NULL file. Waits only when the
+// whole pool is queued behind the disk. One thread at a time per file.
+int rec_file_write(rec_file_t *f, const void *data, size_t len);
+
+// printf-style append (lines up to 512 bytes).
+int rec_file_printf(rec_file_t *f, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+// Queue the partly filled block now instead of when it fills, so a CSV
+// row or the last second of audio is not held in memory indefinitely.
+void rec_file_flush(rec_file_t *f);
+
+// Overwrite len bytes (up to one block) at off once everything appended
+// so far is written -- the WAV header's size fields at close.
+int rec_file_patch(rec_file_t *f, uint64_t off, const void *data, size_t len);
+
+// Bytes appended so far (the file's final length, less any patch).
+uint64_t rec_file_size(const rec_file_t *f);
+
+// Queue the tail and the close; returns without waiting for the disk.
+// f is freed by the writer and must not be used again. NULL-safe.
+void rec_file_close(rec_file_t *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REC_WRITER_H
@@ -0,0 +1,280 @@
+/*
+
+    Simple Satellite Operations  rx_channel.c
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// rx_channel.c — see header.
+
+#include "rx_channel.h"
+
+#include "ax100.h"
+#include "decode_loop.h"
+#include "modem.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct rx_channel {
+    char name[32];
+
+    modem_params_t mp;
+    ax100_opts_t   opts;
+    int            sps;
+    int            sync_max_ham;
+    size_t         window_samples;
+    size_t         slide_samples;
+
+    // Queue from the pump (producer) to the decoder thread, in pairs.
+    pthread_mutex_t mu;
+    pthread_cond_t  cv;
+    int16_t        *q;
+    size_t          q_cap;
+    size_t          q_head;      // next write slot
+    size_t          q_count;
+    int             stop;
+    pthread_t       thread;
+
+    // Decoder-thread state.
+    int16_t *iq_window;
+    size_t   iq_window_filled;
+    uint64_t total_window_samples;
+    uint8_t *bits_scratch;
+    size_t   bits_cap;
+    uint8_t *bytes_scratch;
+    size_t   bytes_cap;
+    uint8_t  packet[4200];
+    decode_loop_dedup_t dedup;
+
+    // Counters, under mu.
+    rx_channel_stats_t st;
+};
+
+// Every frame in one window, as rx_session's try_decode_iq_at_window
+// but on the FM-discriminator chain: CRC32 trailer check, dedup on the
+// quantised absolute ASM position, then emit_frame (which also writes
+// the DB row under this thread's satellite tag).
+static uint64_t decode_window(rx_channel_t *c)
+{
+    uint64_t frames = 0;
+    size_t inner_min_offset = 0;
+    for (;;) {
+        ssize_t plen = -1;
+        int golay_errs = 0, hmac_ok = -1;
+        int rs_errs = -1, used_golay_len = -1;
+        int rs_locs[32];
+        size_t sync_off_local = 0;
+        if (!try_decode_window_fsk(c->iq_window, c->window_samples,
+                                   &c->mp, &c->opts,
+                                   c->sync_max_ham,
+                                   /*allow_partial_rs=*/1,
+                                   inner_min_offset,
+                                   c->bits_scratch, c->bits_cap,
+                                   c->bytes_scratch, c->bytes_cap,
+                                   c->packet, sizeof c->packet,
+                                   &plen, &golay_errs, &hmac_ok,
+                                   &rs_errs, &used_golay_len,
+                                   &sync_off_local, rs_locs)) {
+            break;
+        }
+        inner_min_offset = sync_off_local + 1;
+        if (plen < 4 || (size_t) plen > sizeof c->packet) continue;
+
+        uint32_t crc_computed, crc_le, crc_be;
+        int crc_status = decode_loop_check_crc(c->packet, &plen, &crc_computed,
+                                               &crc_le, &crc_be);
+
+        uint64_t window_start_abs =
+            c->total_window_samples - (uint64_t) c->window_samples;
+        uint64_t asm_abs_sample = window_start_abs
+            + (uint64_t) sync_off_local * (uint64_t) c->sps
+            + (uint64_t)(c->sps / 2);
+        if (!decode_loop_dedup_add(&c->dedup, asm_abs_sample)) continue;
+
+        char ts[64];
+        decode_loop_fmt_utc(ts, sizeof ts);
+        emit_frame(NULL, /*quiet=*/1, ts,
+                   c->packet, (size_t) plen,
+                   golay_errs, hmac_ok,
+                   rs_errs, used_golay_len,
+                   crc_status, crc_computed, crc_le, crc_be,
+                   rs_locs,
+                   NULL, 0,
+                   /*force_beacon=*/0);
+        frames++;
+    }
+    return frames;
+}
+
+static void *channel_thread(void *arg)
+{
+    rx_channel_t *c = arg;
+    decode_loop_set_thread_satellite(c->name);
+    pthread_mutex_lock(&c->mu);
+    for (;;) {
+        while (!c->stop && c->q_count == 0) pthread_cond_wait(&c->cv, &c->mu);
+        if (c->q_count == 0) break;  // stop, and the queue is drained
+
+        // Take what the window still needs, oldest first.
+        size_t need = c->window_samples - c->iq_window_filled;
+        size_t take = c->q_count < need ? c->q_count : need;
+        size_t tail = (c->q_head + c->q_cap - c->q_count) % c->q_cap;
+        for (size_t i = 0; i < take; i++) {
+            size_t k = (tail + i) % c->q_cap;
+            c->iq_window[(c->iq_window_filled + i) * 2 + 0] = c->q[k * 2 + 0];
+            c->iq_window[(c->iq_window_filled + i) * 2 + 1] = c->q[k * 2 + 1];
+        }
+        c->q_count -= take;
+        pthread_mutex_unlock(&c->mu);
+
+        c->iq_window_filled     += take;
+        c->total_window_samples += take;
+        uint64_t frames = 0;
+        int decoded = 0;
+        if (c->iq_window_filled >= c->window_samples) {
+            frames = decode_window(c);
+            decoded = 1;
+            memmove(c->iq_window,
+                    c->iq_window + c->slide_samples * 2,
+                    (c->window_samples - c->slide_samples) * 2 * sizeof(int16_t));
+            c->iq_window_filled = c->window_samples - c->slide_samples;
+        }
+
+        pthread_mutex_lock(&c->mu);
+        c->st.frames  += frames;
+        c->st.windows += (uint64_t) decoded;
+    }
+    pthread_mutex_unlock(&c->mu);
+    return NULL;
+}
+
+static void channel_free(rx_channel_t *c)
+{
+    free(c->q);
+    free(c->iq_window);
+    free(c->bits_scratch);
+    free(c->bytes_scratch);
+    pthread_cond_destroy(&c->cv);
+    pthread_mutex_destroy(&c->mu);
+    free(c);
+}
+
+rx_channel_t *rx_channel_open(const rx_channel_params_t *p)
+{
+    if (p == NULL || p->sat_name == NULL || p->sat_name[0] == '\0') return NULL;
+    rx_channel_t *c = calloc(1, sizeof *c);
+    if (c == NULL) return NULL;
+    pthread_mutex_init(&c->mu, NULL);
+    pthread_cond_init(&c->cv, NULL);
+    snprintf(c->name, sizeof c->name, "%s", p->sat_name);
+
+    modem_params_defaults(&c->mp);
+    c->mp.bit_rate  = p->bit_rate > 0 ? p->bit_rate : 9600;
+    c->mp.samp_rate = p->samp_rate;
+    if (p->samp_rate <= 0 || (p->samp_rate % c->mp.bit_rate) != 0) {
+        fprintf(stderr,
+            "rx_channel %s: rate %d S/s is not a multiple of bit_rate %d\n",
+            c->name, p->samp_rate, c->mp.bit_rate);
+        channel_free(c);
+        return NULL;
+    }
+    c->sps = p->samp_rate / c->mp.bit_rate;
+    double window_s = p->window_s > 0.0 ? p->window_s : 1.5;
+    double slide_s  = p->slide_s  > 0.0 ? p->slide_s  : 0.5;
+    if (slide_s > window_s) slide_s = window_s;
+    c->window_samples = (size_t)(window_s * p->samp_rate);
+    c->slide_samples  = (size_t)(slide_s  * p->samp_rate);
+    if (c->slide_samples == 0) c->slide_samples = c->window_samples;
+
+    ax100_opts_defaults(&c->opts);
+    c->opts.reed_solomon = p->use_rs;
+    c->sync_max_ham = p->sync_max_ham > 0 ? p->sync_max_ham : 4;
+    decode_loop_dedup_init(&c->dedup, (uint64_t)(0.1 * (double) p->samp_rate));
+
+    c->q_cap         = (size_t)(RX_CHANNEL_QUEUE_S * p->samp_rate);
+    c->q             = malloc(c->q_cap * 2 * sizeof(int16_t));
+    c->iq_window     = malloc(c->window_samples * 2 * sizeof(int16_t));
+    c->bits_cap      = c->window_samples + 8;
+    c->bits_scratch  = malloc(c->bits_cap);
+    c->bytes_cap     = c->bits_cap / 8 + 1;
+    c->bytes_scratch = malloc(c->bytes_cap);
+    if (!c->q || !c->iq_window || !c->bits_scratch || !c->bytes_scratch) {
+        channel_free(c);
+        return NULL;
+    }
+    if (pthread_create(&c->thread, NULL, channel_thread, c) != 0) {
+        channel_free(c);
+        return NULL;
+    }
+    return c;
+}
+
+void rx_channel_close(rx_channel_t *c)
+{
+    if (c == NULL) return;
+    pthread_mutex_lock(&c->mu);
+    c->stop = 1;
+    pthread_cond_signal(&c->cv);
+    pthread_mutex_unlock(&c->mu);
+    pthread_join(c->thread, NULL);
+    channel_free(c);
+}
+
+void rx_channel_push(rx_channel_t *c, const int16_t *iq, size_t n_pairs)
+{
+    if (c == NULL || iq == NULL || n_pairs == 0) return;
+    pthread_mutex_lock(&c->mu);
+    // More than the whole queue: only the newest q_cap pairs can stay.
+    if (n_pairs > c->q_cap) {
+        c->st.dropped_pairs += n_pairs - c->q_cap;
+        iq      += (n_pairs - c->q_cap) * 2;
+        n_pairs  = c->q_cap;
+    }
+    size_t room = c->q_cap - c->q_count;
+    if (n_pairs > room) {
+        // Drop the oldest: the decoder resumes on fresh samples and a
+        // frame straddling the gap is lost.
+        size_t drop = n_pairs - room;
+        c->q_count -= drop;
+        c->st.dropped_pairs += drop;
+    }
+    for (size_t i = 0; i < n_pairs; i++) {
+        c->q[c->q_head * 2 + 0] = iq[i * 2 + 0];
+        c->q[c->q_head * 2 + 1] = iq[i * 2 + 1];
+        c->q_head = (c->q_head + 1) % c->q_cap;
+    }
+    c->q_count += n_pairs;
+    pthread_cond_signal(&c->cv);
+    pthread_mutex_unlock(&c->mu);
+}
+
+void rx_channel_stats(rx_channel_t *c, rx_channel_stats_t *out)
+{
+    if (out == NULL) return;
+    memset(out, 0, sizeof *out);
+    if (c == NULL) return;
+    pthread_mutex_lock(&c->mu);
+    *out = c->st;
+    pthread_mutex_unlock(&c->mu);
+}
+
+const char *rx_channel_name(const rx_channel_t *c)
+{
+    return c ? c->name : "";
+}
@@ -0,0 +1,89 @@
+/*
+
+    Simple Satellite Operations  rx_channel.h
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// rx_channel.h — decoder for one extra receive channel (see
+// b210_rx_tx_core_add_channel). rx_session's worker pushes each pump's
+// channel IQ in; a thread per channel runs the primary live chain's
+// sliding-window decode (CSP CRC32 check, a 64-slot position dedup
+// ring of its own) and hands each new frame to emit_frame with the
+// channel's satellite name as the DB tag
+// (decode_loop_set_thread_satellite), so one radio fills the packet DB
+// for several simultaneous passes.
+//
+// The demod is try_decode_window_fsk rather than the primary's IQ
+// slicer: it is indifferent to the modulation index, and a second
+// satellite's transmitter need not be an h=0.5 MSK like ours.
+//
+// Deliberately leaner than the primary chain: no PCM / Viterbi shadow
+// counters, no burst gate, no recording, no panel. The primary worker
+// never waits on a channel -- a channel that falls more than
+// RX_CHANNEL_QUEUE_S behind drops the oldest samples and counts them.
+
+#ifndef RX_CHANNEL_H
+#define RX_CHANNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RX_CHANNEL_QUEUE_S 4.0
+
+typedef struct rx_channel rx_channel_t;
+
+typedef struct {
+    const char *sat_name;      // DB satellite tag (copied); required
+    int         samp_rate;     // of the pushed IQ; a multiple of bit_rate
+    int         bit_rate;      // default 9600
+    double      window_s;      // default 1.5
+    double      slide_s;       // default 0.5
+    int         sync_max_ham;  // default 4
+    int         use_rs;
+} rx_channel_params_t;
+
+typedef struct {
+    uint64_t frames;           // frames emitted (after dedup)
+    uint64_t windows;          // windows decoded
+    uint64_t dropped_pairs;    // IQ pairs lost to a full queue
+} rx_channel_stats_t;
+
+// Start the channel's decoder thread. NULL on bad params, OOM or a
+// failed thread start.
+rx_channel_t *rx_channel_open(const rx_channel_params_t *p);
+
+// Stop and join the thread; samples still queued are decoded first.
+// NULL is a no-op.
+void rx_channel_close(rx_channel_t *c);
+
+// Queue n_pairs sc16 IQ pairs (copied). Never blocks on the decoder.
+void rx_channel_push(rx_channel_t *c, const int16_t *iq, size_t n_pairs);
+
+// Counters; safe from any thread.
+void rx_channel_stats(rx_channel_t *c, rx_channel_stats_t *out);
+
+const char *rx_channel_name(const rx_channel_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RX_CHANNEL_H
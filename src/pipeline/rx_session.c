@@ -27,12 +27,17 @@
 #include "ax100.h"
 #include "b210_rx_tx_core.h"
 #include "beacon_cts1.h"
+#include "burst_gate.h"
 #include "csp.h"
 #include "decode_loop.h"
+#include "lat_trace.h"
 #include "modem.h"
 #include "modem_iq.h"
 #include "packet_db.h"
+#include "rx_channel.h"
 #include "sso_audit.h"
+#include "sso_iq.h"
+#include "tle_catalog.h"
 #include "tx_burst.h"
 
 #include <errno.h>
@@ -47,20 +52,22 @@
 #include <time.h>
 #include <unistd.h>
 
-// Streaming WAV writer (mono int16). The header's data/RIFF sizes are
-// patched at close; an interrupted run leaves a "0-length" but otherwise
-// playable file that the receiving tools handle.
+// Streaming WAV writer (mono int16) on the recording writer thread. The
+// header's data/RIFF sizes are patched at close; an interrupted run
+// leaves a "0-length" but otherwise playable file that the receiving
+// tools handle.
 typedef struct {
-    FILE  *fp;
-    size_t n_samples;
-    int    sample_rate;
+    rec_file_t *f;
+    size_t      n_samples;
+    int         sample_rate;
 } wav_w_t;
 
-static int wav_w_open(wav_w_t *w, const char *path, int sample_rate)
+static int wav_w_open(wav_w_t *w, rec_writer_t *rec, const char *path,
+                      int sample_rate)
 {
     memset(w, 0, sizeof *w);
-    w->fp = fopen(path, "wb");
-    if (w->fp == NULL) return -1;
+    w->f = rec_file_open(rec, path);
+    if (w->f == NULL) return -1;
     uint32_t sr  = (uint32_t) sample_rate;
     uint32_t bps = sr * 2;
     uint8_t hdr[44] = {
@@ -73,22 +80,21 @@ static int wav_w_open(wav_w_t *w, const char *path, int sample_rate)
         2,0, 16,0,
         'd','a','t','a', 0,0,0,0,
     };
-    if (fwrite(hdr, 1, 44, w->fp) != 44) { fclose(w->fp); w->fp = NULL; return -1; }
+    rec_file_write(w->f, hdr, sizeof hdr);
     w->sample_rate = sample_rate;
     return 0;
 }
 
 static void wav_w_append(wav_w_t *w, const int16_t *s, size_t n)
 {
-    if (w->fp == NULL || n == 0) return;
-    if (fwrite(s, sizeof(int16_t), n, w->fp) == n) {
-        w->n_samples += n;
-    }
+    if (w->f == NULL || n == 0) return;
+    rec_file_write(w->f, s, n * sizeof(int16_t));
+    w->n_samples += n;
 }
 
 static void wav_w_close(wav_w_t *w)
 {
-    if (w->fp == NULL) return;
+    if (w->f == NULL) return;
     // The RIFF/data chunk sizes are 32-bit, so a WAV can describe at most
     // ~4 GiB. At 96 kHz mono int16 that is ~6.2 hours of audio; a longer
     // pass overruns the header fields. Compute in 64-bit and clamp to the
@@ -100,23 +106,10 @@ static void wav_w_close(wav_w_t *w)
     uint32_t data_sz = (bytes > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t) bytes;
     uint32_t riff_sz = (bytes + 36u > 0xFFFFFFFFu) ? 0xFFFFFFFFu
                                                    : (uint32_t)(bytes + 36u);
-    if (fseek(w->fp, 4,  SEEK_SET) == 0) (void) fwrite(&riff_sz, 4, 1, w->fp);
-    if (fseek(w->fp, 40, SEEK_SET) == 0) (void) fwrite(&data_sz, 4, 1, w->fp);
-    fclose(w->fp);
-    w->fp = NULL;
-}
-
-static void fmt_utc(char *buf, size_t cap)
-{
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    struct tm utc;
-    gmtime_r(&tv.tv_sec, &utc);
-    snprintf(buf, cap, "%04d-%02d-%02dT%02d:%02d:%02d.%03ldZ",
-             (utc.tm_year + 1900) % 10000,
-             (utc.tm_mon + 1) % 100, utc.tm_mday % 100,
-             utc.tm_hour % 100, utc.tm_min % 100, utc.tm_sec % 100,
-             (long)(tv.tv_usec / 1000));
+    rec_file_patch(w->f, 4,  &riff_sz, 4);
+    rec_file_patch(w->f, 40, &data_sz, 4);
+    rec_file_close(w->f);
+    w->f = NULL;
 }
 
 static double monotonic_seconds(void)
@@ -135,6 +128,29 @@ static int read_tle_lines(const char *path, const char *sat_prefix,
                           char *out_line2, size_t line2_n)
 {
     if (path == NULL || sat_prefix == NULL) return -1;
+    // Regular catalogs answer from the compiled name index; the scan below
+    // (which skips '1'/'2' lines as names) stays for odd files.
+    const tle_catalog_t *cat = tle_catalog_get(path);
+    if (cat != NULL && tle_catalog_regular(cat)) {
+        size_t first = 0;
+        size_t n = tle_catalog_prefix(cat, sat_prefix, &first);
+        const tle_catalog_rec_t *best = NULL;
+        size_t best_i = 0;
+        for (size_t k = 0; k < n; ++k) {
+            size_t i = tle_catalog_by_name(cat, first + k);
+            const tle_catalog_rec_t *r = tle_catalog_rec(cat, i);
+            if (r->name[0] == '1' || r->name[0] == '2') continue;
+            if (best == NULL || i < best_i) {
+                best = r;
+                best_i = i;
+            }
+        }
+        if (best == NULL) return -1;
+        snprintf(out_name,  name_n,  "%s", best->name);
+        snprintf(out_line1, line1_n, "%s", best->line1);
+        snprintf(out_line2, line2_n, "%s", best->line2);
+        return 0;
+    }
     FILE *f = fopen(path, "r");
     if (f == NULL) return -1;
     char a[256] = {0}, b[256] = {0}, c[256] = {0};
@@ -188,7 +204,22 @@ static int auto_name_wav(const char *pass_folder, char *out, size_t cap)
     return (n > 0 && (size_t) n < cap) ? 0 : -1;
 }
 
-#define DEDUP_RING_SZ 64
+// SDR capture ring depth (seconds at the native rate): how long the
+// decode / disk / DB side may stall before samples are dropped. ~6 MB
+// for a B210 at 480 kS/s, ~23 MB for an RTL-SDR at 1.92 MS/s.
+#define RX_CAPTURE_RING_S 3.0
+
+// How often the worker hands partly filled recording blocks to the
+// writer: the most audio / IQ a crash can lose.
+#define REC_FLUSH_S 1.0
+
+// Latency tracing (lat_trace.h). The worker remembers when the last
+// RX_TRACE_PUMPS pumps' samples reached the host, so a frame's origin
+// is the arrival of the pump that delivered its last sample, and keeps
+// the origins of the last RX_TRACE_FRAMES frames for the panel / IPC
+// marks made on the main thread.
+#define RX_TRACE_PUMPS  512
+#define RX_TRACE_FRAMES 256
 
 struct rx_session {
     // Modem + AX100 options.
@@ -207,7 +238,6 @@ struct rx_session {
     int      sps;
     size_t   window_samples;
     size_t   slide_samples;
-    uint64_t dedup_quant;
 
     // Allocated scratch.
     int16_t *pcm_chunk;
@@ -240,50 +270,72 @@ struct rx_session {
     // and Viterbi chains keep running in parallel, each with their own
     // dedup ring + counter, purely as A/B shadows the operator can use
     // to spot regressions.
-    uint64_t recent_pos_quant[DEDUP_RING_SZ];
-    int      recent_idx;
-    int      recent_count;
+    decode_loop_dedup_t dedup;
     uint64_t total_window_samples;
     // PCM/FM-audio shadow counter. Same window, independent dedup so
     // any frame both chains catch ticks BOTH frames_total (the IQ
     // primary) and pcm_frames_total — that's the A signal.
-    uint64_t pcm_recent_pos_quant[DEDUP_RING_SZ];
-    int      pcm_recent_idx;
-    int      pcm_recent_count;
+    decode_loop_dedup_t pcm_dedup;
     uint64_t pcm_frames_total;
 
     // Viterbi MSK-MLSE shadow counter. Same role as the PCM shadow —
     // count only, no DB write, no panel update — so an operator who
     // suspects the live chain is missing frames can compare against
     // the other two before believing a regression.
-    uint64_t vit_recent_pos_quant[DEDUP_RING_SZ];
-    int      vit_recent_idx;
-    int      vit_recent_count;
+    decode_loop_dedup_t vit_dedup;
     uint64_t vit_frames_total;
 
-    // Output paths.
+    // Output paths. Every recording below goes through rec, the
+    // background writer, so the worker never waits on the disk unless
+    // the writer's whole block pool is queued behind it.
+    rec_writer_t *rec;
+    double   rec_last_flush_t;     // monotonic_seconds() of the last flush
     wav_w_t  wav;
     char     wav_path[512];
     char     log_path[512];
     char     pass_folder[256];
     int      want_wav;
 
-    // Raw IQ sidecar (interleaved int16 I,Q at samp_rate). Opens/closes
-    // in lockstep with the WAV so each pass produces both a .wav and a
-    // .iq with the same UTC stamp. The .iq feeds gen_waterfall to make
-    // SatNOGS-style waterfalls; the WAV stays as the FM-demoded audio.
-    FILE     *iq_fp;
+    // IQ sidecar (int16 I,Q at samp_rate). Opens/closes in lockstep with
+    // the WAV so each pass produces both a .wav and an IQ recording with
+    // the same UTC stamp. By default that is a .sso-iq container: iq_w
+    // compresses it block by block into iq_f, stamping each block with
+    // its UNIX time and Doppler. raw_iq (--raw-iq) keeps the headerless
+    // .iq instead. Either feeds gen_waterfall / rx_replay; the WAV stays
+    // as the FM-demoded audio.
+    rec_file_t *iq_f;
+    sso_iq_writer_t *iq_w;
+    int       raw_iq;
     char      iq_path[512];
     uint64_t  iq_pairs_written;
+    char      sat_name[32];        // for the container's pass id
 
     // Doppler-trajectory sidecar. Each row: monotonic ms since wav
     // opened, unix_time_ms, doppler_offset_hz. Lets offline tools
     // reverse the in-pump software Doppler correction if they want to
     // apply a different ephemeris.
-    FILE     *doppler_fp;
+    rec_file_t *doppler_f;
     char      doppler_path[512];
     double    doppler_last_log_t;  // monotonic_seconds() at last write
 
+    // Extra receive channels, indexed like params.channels (NULL: that
+    // one did not open). chan_core_idx maps to the core's channel index.
+    // The worker pushes each pump's channel IQ; the decoders run on
+    // their own threads (rx_channel.h).
+    rx_channel_t *chan[RX_SESSION_CHANNELS_MAX];
+    int           chan_core_idx[RX_SESSION_CHANNELS_MAX];
+    int           n_chan;
+
+    // Latency-trace state. pump_* and frame_t0_ns are worker-written;
+    // frame_t0_ns[k % RX_TRACE_FRAMES] is frame k's origin, published
+    // with snap_frames_total under mu. traced_upto (main thread only)
+    // is the frame count already marked for LAT_PANEL / LAT_IPC.
+    uint64_t pump_end_sample[RX_TRACE_PUMPS];
+    uint64_t pump_t_ns[RX_TRACE_PUMPS];
+    unsigned pump_idx;
+    uint64_t frame_t0_ns[RX_TRACE_FRAMES];
+    uint64_t traced_upto[2];
+
     // Frame counters + last-decoded summary.
     uint64_t frames_total;
     char     last_frame_ts[24];
@@ -297,6 +349,9 @@ struct rx_session {
     // Monotonic time of the most-recent decoded frame; 0.0 means
     // "no frame yet".
     double   last_frame_monotonic_s;
+    // Live reassembly of the bulk_file download in progress. Worker-only;
+    // worker_update_snapshot publishes its stats as snap_bulk.
+    bulk_live_t bulk;
 
     // packet_db handle (owned).
     packet_db_t *db;
@@ -339,6 +394,14 @@ struct rx_session {
     double  freq_req_hz;
     int     gain_req_pending;
     double  gain_req_db;
+    // Doppler trajectory handoff: the worker installs dop_track_req into
+    // the core (which then owns it) when dop_track_pending is set; a
+    // NULL request removes the core's trajectory.
+    int             dop_track_pending;
+    sw_nco_track_t *dop_track_req;
+    // Same handoff per extra channel.
+    int             chan_track_pending[RX_SESSION_CHANNELS_MAX];
+    sw_nco_track_t *chan_track_req[RX_SESSION_CHANNELS_MAX];
     int     wav_start_req;
     int     wav_stop_req;
 
@@ -376,6 +439,7 @@ struct rx_session {
     int      snap_per_type_last_len[RX_PT_COUNT];
     uint8_t  snap_per_type_last_payload[RX_PT_COUNT][RX_LAST_PAYLOAD_MAX];
     char     snap_per_type_last_summary[RX_PT_COUNT][RX_LAST_SUMMARY_MAX];
+    bulk_live_stats_t snap_bulk;
     char     snap_wav_path[512];
     int64_t  snap_wav_n_samples;
     char     snap_iq_path[512];
@@ -386,16 +450,16 @@ struct rx_session {
     // lo_offset.csv sidecar: same lifecycle as doppler.csv (opens with
     // the WAV, closes with it). One row per change of lo_offset_hz so
     // offline reprocessing of the .iq can replay the exact LO history.
-    FILE     *lo_offset_fp;
+    rec_file_t *lo_offset_f;
     char      lo_offset_path[512];
 
     // burst.csv sidecar: wideband-burst events. Same lifecycle as the
     // doppler/lo_offset CSVs. Lets the operator A/B the waterfall
-    // against "what the detector thought looked like a packet" — a
-    // foundation for gating the decoder on bursts later. State below
-    // is a small debouncer so a brief mid-burst dropout doesn't split
-    // one beacon into two rows.
-    FILE     *burst_fp;
+    // against "what the detector thought looked like a packet" (the
+    // decoder itself is gated by `gate` below). State below is a small
+    // debouncer so a brief mid-burst dropout doesn't split one beacon
+    // into two rows.
+    rec_file_t *burst_f;
     char      burst_path[512];
     int       burst_in_progress;
     int       burst_bins_threshold;   // min bright_bins to start a burst
@@ -404,6 +468,13 @@ struct rx_session {
     long long burst_start_unix_ms;
     int       burst_peak_bins;
     double    burst_peak_excess_db;
+
+    // Energy gate in front of the demod chains (burst_gate.h); worker-
+    // only. gate_on is 0 with --no-burst-gate. gate_pass_base holds the
+    // totals when the recording opened, so each pass logs its own line.
+    int                gate_on;
+    burst_gate_t       gate;
+    burst_gate_stats_t gate_pass_base;
 };
 
 static void *rx_session_thread_fn(void *arg);
@@ -417,6 +488,7 @@ int rx_session_open(rx_session_t **out, const rx_session_params_t *p,
 
     rx_session_t *rxs = calloc(1, sizeof(*rxs));
     if (rxs == NULL) return -1;
+    bulk_live_init(&rxs->bulk);
 
     modem_params_defaults(&rxs->mp);
     rxs->mp.bit_rate  = p->bit_rate > 0 ? p->bit_rate : 9600;
@@ -434,6 +506,9 @@ int rx_session_open(rx_session_t **out, const rx_session_params_t *p,
     // we see how the log lines up with the waterfall.
     rxs->burst_bins_threshold = 16;
     rxs->burst_min_quiet      = 5;
+    burst_gate_params_t gp;
+    burst_gate_params_defaults(&gp);
+    rxs->gate_on = !p->no_burst_gate;
     double actual_rate = b210_rx_tx_core_actual_rate(core);
     rxs->samp_rate    = (int) actual_rate;
     rxs->mp.samp_rate = rxs->samp_rate;
@@ -446,6 +521,7 @@ int rx_session_open(rx_session_t **out, const rx_session_params_t *p,
         return -1;
     }
     rxs->sps          = rxs->samp_rate / rxs->mp.bit_rate;
+    burst_gate_init(&rxs->gate, &gp, rxs->samp_rate);
     double window_s   = p->window_s > 0.0 ? p->window_s : 1.5;
     double slide_s    = p->slide_s  > 0.0 ? p->slide_s  : 0.5;
     if (slide_s > window_s) slide_s = window_s;
@@ -485,12 +561,21 @@ int rx_session_open(rx_session_t **out, const rx_session_params_t *p,
         return -1;
     }
 
-    rxs->dedup_quant = (uint64_t)(0.1 * (double) rxs->samp_rate);
-    if (rxs->dedup_quant == 0) rxs->dedup_quant = 1;
+    uint64_t dedup_quant = (uint64_t)(0.1 * (double) rxs->samp_rate);
+    decode_loop_dedup_init(&rxs->dedup, dedup_quant);
+    decode_loop_dedup_init(&rxs->pcm_dedup, dedup_quant);
+    decode_loop_dedup_init(&rxs->vit_dedup, dedup_quant);
 
     // packet_db registration + TLE id + session dir.
     rxs->db = packet_db_setup(p->db_path, p->no_db,
                               rxs->db_run_id, sizeof rxs->db_run_id);
+    // Live inserts go through the async writer so a reader or backfill
+    // holding the write lock can't stall the pump. If it can't start, the
+    // synchronous path still works — just without that isolation.
+    if (rxs->db != NULL && packet_db_start_writer(rxs->db, 0, 0, 0) != 0) {
+        fprintf(stderr, "rx_session: DB writer thread unavailable; "
+                        "inserting on the RX worker\n");
+    }
     decode_loop_set_packet_db(rxs->db, "simple_sat_ops", rxs->db_run_id);
     if (rxs->db != NULL && p->tle_path && p->sat_name) {
         char tle_name[128] = {0}, tle_line1[128] = {0}, tle_line2[128] = {0};
@@ -507,12 +592,24 @@ int rx_session_open(rx_session_t **out, const rx_session_params_t *p,
         decode_loop_set_session_dir(p->session_dir);
     }
 
-    // Defer the WAV open until the caller arms a pass.
+    // Defer the WAV open until the caller arms a pass. The recording
+    // writer thread starts now so the first pass doesn't pay for it;
+    // without it there is nothing to record into.
     rxs->want_wav = p->want_wav;
+    if (rxs->want_wav) {
+        rxs->rec = rec_writer_start(0, 0);
+        if (rxs->rec == NULL) {
+            fprintf(stderr, "rx_session: recording writer unavailable; "
+                            "WAV/IQ recording disabled\n");
+            rxs->want_wav = 0;
+        }
+    }
     if (p->pass_folder && p->pass_folder[0]) {
         snprintf(rxs->pass_folder, sizeof rxs->pass_folder,
                  "%s", p->pass_folder);
     }
+    rxs->raw_iq = p->raw_iq;
+    if (p->sat_name) snprintf(rxs->sat_name, sizeof rxs->sat_name, "%s", p->sat_name);
 
     // Threading: rx_session takes ownership of the core. The worker
     // pumps UHD RX continuously and services freq retunes / WAV
@@ -520,6 +617,41 @@ int rx_session_open(rx_session_t **out, const rx_session_params_t *p,
     // TX bursts so a transmit never blocks the RX pump.
     rxs->core = core;
     rxs->lo_offset_hz = p->lo_offset_hz;
+    // Extra channels share the DB and decode settings of the primary
+    // chain; each gets a branch in the core and a decoder thread.
+    rxs->n_chan = p->n_channels < RX_SESSION_CHANNELS_MAX
+                ? p->n_channels : RX_SESSION_CHANNELS_MAX;
+    for (int k = 0; k < rxs->n_chan; k++) {
+        const rx_session_channel_t *pc = &p->channels[k];
+        int idx = b210_rx_tx_core_add_channel(core, pc->offset_hz);
+        if (idx < 0) {
+            fprintf(stderr, "rx_session: channel %s at %+.0f Hz unavailable\n",
+                    pc->sat_name ? pc->sat_name : "?", pc->offset_hz);
+            continue;
+        }
+        rx_channel_params_t cp = {
+            .sat_name     = pc->sat_name,
+            .samp_rate    = rxs->samp_rate,
+            .bit_rate     = rxs->mp.bit_rate,
+            .window_s     = window_s,
+            .slide_s      = slide_s,
+            .sync_max_ham = rxs->sync_max_ham,
+            .use_rs       = p->use_rs,
+        };
+        rxs->chan[k] = rx_channel_open(&cp);
+        rxs->chan_core_idx[k] = idx;
+        if (rxs->chan[k] == NULL) {
+            fprintf(stderr, "rx_session: channel %s decoder failed to start\n",
+                    pc->sat_name ? pc->sat_name : "?");
+        }
+    }
+    // Device reads go to their own thread ahead of the worker, so a slow
+    // decode / disk / DB step drains ring headroom instead of overflowing
+    // the SDR. Without it the worker reads the device itself, as before.
+    if (b210_rx_tx_core_start_capture(core, RX_CAPTURE_RING_S) != 0) {
+        fprintf(stderr, "rx_session: no capture thread; reading the SDR "
+                        "from the worker\n");
+    }
     // lo_offset_hz is SIGNED: positive → LO above nominal, negative
     // → LO below. Hardware LO = nominal + lo_offset_hz, so to recover
     // the nominal carrier from the actual hardware tune we subtract.
@@ -558,42 +690,98 @@ int rx_session_open(rx_session_t **out, const rx_session_params_t *p,
     return 0;
 }
 
+// sso_iq sink onto a recording file.
+static int iq_rec_sink(void *ctx, const void *data, size_t len)
+{
+    return rec_file_write((rec_file_t *) ctx, data, len);
+}
+
+// One "burst-gate" audit row for the windows judged since the last row:
+// scope "pass" covers a recording, "idle" the stretch between them.
+static void gate_log(rx_session_t *rxs, const char *scope)
+{
+    if (!rxs->gate_on) return;
+    burst_gate_stats_t d;
+    burst_gate_stats_since(&rxs->gate.stats, &rxs->gate_pass_base, &d);
+    if (d.windows == 0) return;
+    char det[256];
+    int n = snprintf(det, sizeof det, "%s ", scope);
+    burst_gate_format(&d, det + n, sizeof det - (size_t) n);
+    sso_audit_event("burst-gate", det);
+    rxs->gate_pass_base = rxs->gate.stats;
+}
+
+// Close one extra channel, leaving an "rx-channel" audit row with what
+// it decoded.
+static void rx_channel_close_logged(rx_channel_t *c)
+{
+    rx_channel_stats_t st;
+    rx_channel_stats(c, &st);
+    char det[160];
+    snprintf(det, sizeof det, "%s frames=%llu windows=%llu dropped=%llu",
+             rx_channel_name(c),
+             (unsigned long long) st.frames,
+             (unsigned long long) st.windows,
+             (unsigned long long) st.dropped_pairs);
+    rx_channel_close(c);
+    sso_audit_event("rx-channel", det);
+}
+
 // Worker-internal: open/close the WAV file. Called only from the
 // thread, so no locking needed for the wav_w_t itself.
 static void worker_wav_start(rx_session_t *rxs)
 {
-    if (!rxs->want_wav || rxs->wav.fp != NULL) return;
+    if (!rxs->want_wav || rxs->wav.f != NULL) return;
+    gate_log(rxs, "idle");  // the stretch before this recording
     if (auto_name_wav(rxs->pass_folder[0] ? rxs->pass_folder : NULL,
                       rxs->wav_path, sizeof rxs->wav_path) != 0
-        || wav_w_open(&rxs->wav, rxs->wav_path, rxs->samp_rate) != 0) {
+        || wav_w_open(&rxs->wav, rxs->rec, rxs->wav_path, rxs->samp_rate) != 0) {
         // Can't write to stderr while ncurses owns the screen — it
         // corrupts the operator UI. The wav_path[0]='\0' below leaves
-        // wav.fp NULL, so the next snapshot reports wav_active = 0 and
+        // wav.f NULL, so the next snapshot reports wav_active = 0 and
         // the operator's [REC] indicator stays dark, which is the
         // visible signal that the open failed.
         rxs->wav_path[0] = '\0';
         return;
     }
-    // Open the IQ sidecar — same base name, .iq extension. Raw int16
-    // I,Q pairs at samp_rate; gen_waterfall reads them straight. If the
-    // open fails we keep the WAV open (so the audio path still works)
-    // and just leave iq_fp NULL so subsequent pumps skip the write.
-    // Both buffers are 512; ".iq" needs 3 bytes + nul, so cap the
-    // path-portion at 508 so the suffix always fits and GCC can prove
-    // the snprintf won't truncate.
+    // Open the IQ sidecar — same base name, .sso-iq extension (.iq with
+    // --raw-iq). If the open fails we keep the WAV open (so the audio
+    // path still works) and just leave iq_f NULL so subsequent pumps
+    // skip the write. Both buffers are 512; ".sso-iq" needs 7 bytes +
+    // nul, so cap the path-portion at 504 so the suffix always fits and
+    // GCC can prove the snprintf won't truncate.
+    const char *iq_ext = rxs->raw_iq ? ".iq" : SSO_IQ_EXT;
     size_t wlen = strlen(rxs->wav_path);
-    if (wlen >= 4 && strcmp(rxs->wav_path + wlen - 4, ".wav") == 0) {
-        int base_len = (int)(wlen - 4);
-        if (base_len > 508) base_len = 508;
-        snprintf(rxs->iq_path, sizeof rxs->iq_path,
-                 "%.*s.iq", base_len, rxs->wav_path);
-    } else {
-        snprintf(rxs->iq_path, sizeof rxs->iq_path,
-                 "%.508s.iq", rxs->wav_path);
-    }
-    rxs->iq_fp = fopen(rxs->iq_path, "wb");
+    int base_len = (int) wlen;
+    if (wlen >= 4 && strcmp(rxs->wav_path + wlen - 4, ".wav") == 0) base_len -= 4;
+    if (base_len > 504) base_len = 504;
+    snprintf(rxs->iq_path, sizeof rxs->iq_path,
+             "%.*s%s", base_len, rxs->wav_path, iq_ext);
+    rxs->iq_f = rec_file_open(rxs->rec, rxs->iq_path);
     rxs->iq_pairs_written = 0;
-    if (rxs->iq_fp == NULL) rxs->iq_path[0] = '\0';
+    if (rxs->iq_f != NULL && !rxs->raw_iq) {
+        sso_iq_meta_t meta;
+        memset(&meta, 0, sizeof meta);
+        meta.sample_rate_hz = rxs->samp_rate;
+        meta.center_freq_hz = b210_rx_tx_core_actual_freq(rxs->core);
+        meta.lo_offset_hz   = rxs->lo_offset_hz;
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        meta.start_unix_s = (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+        const char *stem = strrchr(rxs->wav_path, '/');
+        stem = stem ? stem + 1 : rxs->wav_path;
+        int stem_len = (int) strlen(stem);
+        if (stem_len >= 4 && strcmp(stem + stem_len - 4, ".wav") == 0) stem_len -= 4;
+        snprintf(meta.pass_id, sizeof meta.pass_id, "%s%s%.*s",
+                 rxs->sat_name, rxs->sat_name[0] ? " " : "", stem_len, stem);
+        snprintf(meta.source, sizeof meta.source, "simple_sat_ops");
+        rxs->iq_w = sso_iq_writer_new(&meta, iq_rec_sink, rxs->iq_f);
+        if (rxs->iq_w == NULL) {
+            rec_file_close(rxs->iq_f);
+            rxs->iq_f = NULL;
+        }
+    }
+    if (rxs->iq_f == NULL) rxs->iq_path[0] = '\0';
 
     // Doppler-trajectory sidecar (same base name + .doppler.csv).
     // Records the software-NCO offset over time so an offline tool can
@@ -611,10 +799,10 @@ static void worker_wav_start(rx_session_t *rxs)
         snprintf(rxs->doppler_path, sizeof rxs->doppler_path,
                  "%.499s.doppler.csv", rxs->wav_path);
     }
-    rxs->doppler_fp = fopen(rxs->doppler_path, "w");
+    rxs->doppler_f = rec_file_open(rxs->rec, rxs->doppler_path);
     rxs->doppler_last_log_t = 0.0;
-    if (rxs->doppler_fp != NULL) {
-        fputs("# unix_time_ms,doppler_offset_hz\n", rxs->doppler_fp);
+    if (rxs->doppler_f != NULL) {
+        rec_file_printf(rxs->doppler_f, "# unix_time_ms,doppler_offset_hz\n");
     } else {
         rxs->doppler_path[0] = '\0';
     }
@@ -638,14 +826,19 @@ static void worker_wav_start(rx_session_t *rxs)
         snprintf(rxs->lo_offset_path, sizeof rxs->lo_offset_path,
                  "%.497s.lo_offset.csv", rxs->wav_path);
     }
-    rxs->lo_offset_fp = fopen(rxs->lo_offset_path, "w");
-    if (rxs->lo_offset_fp != NULL) {
-        fputs("# unix_time_ms,lo_offset_hz\n", rxs->lo_offset_fp);
+    // rx_session_set_lo_offset appends from the main thread under mu, so
+    // publish the handle under mu too.
+    rec_file_t *lo_f = rec_file_open(rxs->rec, rxs->lo_offset_path);
+    if (lo_f != NULL) {
+        pthread_mutex_lock(&rxs->mu);
+        rec_file_printf(lo_f, "# unix_time_ms,lo_offset_hz\n");
         struct timeval tv;
         gettimeofday(&tv, NULL);
         long long unix_ms = (long long) tv.tv_sec * 1000LL + tv.tv_usec / 1000;
-        fprintf(rxs->lo_offset_fp, "%lld,%.6f\n", unix_ms, rxs->lo_offset_hz);
-        fflush(rxs->lo_offset_fp);
+        rec_file_printf(lo_f, "%lld,%.6f\n", unix_ms, rxs->lo_offset_hz);
+        rec_file_flush(lo_f);
+        rxs->lo_offset_f = lo_f;
+        pthread_mutex_unlock(&rxs->mu);
     } else {
         rxs->lo_offset_path[0] = '\0';
     }
@@ -661,12 +854,11 @@ static void worker_wav_start(rx_session_t *rxs)
         snprintf(rxs->burst_path, sizeof rxs->burst_path,
                  "%.501s.burst.csv", rxs->wav_path);
     }
-    rxs->burst_fp = fopen(rxs->burst_path, "w");
-    if (rxs->burst_fp != NULL) {
-        fputs("# event,unix_time_ms,bright_bins,peak_excess_db,"
-              "duration_ms\n",
-              rxs->burst_fp);
-        fflush(rxs->burst_fp);
+    rxs->burst_f = rec_file_open(rxs->rec, rxs->burst_path);
+    if (rxs->burst_f != NULL) {
+        rec_file_printf(rxs->burst_f,
+                        "# event,unix_time_ms,bright_bins,peak_excess_db,"
+                        "duration_ms\n");
     } else {
         rxs->burst_path[0] = '\0';
     }
@@ -682,20 +874,25 @@ static void worker_wav_start(rx_session_t *rxs)
 
 static void worker_wav_stop(rx_session_t *rxs)
 {
-    if (rxs->wav.fp != NULL) wav_w_close(&rxs->wav);
-    if (rxs->iq_fp != NULL) {
-        fclose(rxs->iq_fp);
-        rxs->iq_fp = NULL;
-    }
-    if (rxs->doppler_fp != NULL) {
-        fclose(rxs->doppler_fp);
-        rxs->doppler_fp = NULL;
-    }
-    if (rxs->lo_offset_fp != NULL) {
-        fclose(rxs->lo_offset_fp);
-        rxs->lo_offset_fp = NULL;
-    }
-    if (rxs->burst_fp != NULL) {
+    // Per-pass gate figures: a gate_miss above zero means frames came
+    // only through the ASM probe, i.e. the energy threshold is too high.
+    if (rxs->wav.f != NULL) gate_log(rxs, "pass");
+    // Closes only queue the tail; the writer finishes them in the
+    // background.
+    wav_w_close(&rxs->wav);
+    // The container's tail block and index go through iq_f, so the
+    // writer closes before the file does.
+    sso_iq_writer_close(rxs->iq_w);
+    rxs->iq_w = NULL;
+    rec_file_close(rxs->iq_f);
+    rxs->iq_f = NULL;
+    rec_file_close(rxs->doppler_f);
+    rxs->doppler_f = NULL;
+    pthread_mutex_lock(&rxs->mu);
+    rec_file_close(rxs->lo_offset_f);
+    rxs->lo_offset_f = NULL;
+    pthread_mutex_unlock(&rxs->mu);
+    if (rxs->burst_f != NULL) {
         // Close any in-flight burst as an "end" row so a clean exit
         // doesn't lose the last event. Duration is current_time - start.
         if (rxs->burst_in_progress) {
@@ -703,16 +900,15 @@ static void worker_wav_stop(rx_session_t *rxs)
             gettimeofday(&tv, NULL);
             long long now_ms =
                 (long long) tv.tv_sec * 1000LL + tv.tv_usec / 1000;
-            fprintf(rxs->burst_fp,
+            rec_file_printf(rxs->burst_f,
                 "burst_end,%lld,%d,%.2f,%lld\n",
                 now_ms, rxs->burst_peak_bins,
                 rxs->burst_peak_excess_db,
                 now_ms - rxs->burst_start_unix_ms);
-            fflush(rxs->burst_fp);
             rxs->burst_in_progress = 0;
         }
-        fclose(rxs->burst_fp);
-        rxs->burst_fp = NULL;
+        rec_file_close(rxs->burst_f);
+        rxs->burst_f = NULL;
     }
 }
 
@@ -793,6 +989,22 @@ uint64_t rx_session_viterbi_frames(const rx_session_t *rxs)
     return v;
 }
 
+void rx_session_trace_delivered(rx_session_t *rxs, lat_stage_t stage)
+{
+    if (rxs == NULL || (stage != LAT_PANEL && stage != LAT_IPC)) return;
+    uint64_t *upto = &rxs->traced_upto[stage == LAT_PANEL ? 0 : 1];
+    uint64_t now = lat_now_ns();
+    pthread_mutex_lock(&rxs->mu);
+    uint64_t frames = rxs->snap_frames_total;
+    if (frames < *upto) *upto = frames;
+    uint64_t k = *upto;
+    if (frames - k > RX_TRACE_FRAMES) k = frames - RX_TRACE_FRAMES;
+    for (; k < frames; k++)
+        lat_trace_mark_at(stage, rxs->frame_t0_ns[k % RX_TRACE_FRAMES], now);
+    *upto = frames;
+    pthread_mutex_unlock(&rxs->mu);
+}
+
 uint64_t rx_session_pcm_frames(const rx_session_t *rxs)
 {
     if (rxs == NULL) return 0;
@@ -820,6 +1032,61 @@ void rx_session_set_doppler_offset(rx_session_t *rxs, double offset_hz)
     b210_rx_tx_core_set_doppler_offset(rxs->core, offset_hz);
 }
 
+int rx_session_set_doppler_track(rx_session_t *rxs, double t0_unix_s,
+                                 double step_s, const double *offset_hz,
+                                 size_t n)
+{
+    if (rxs == NULL) return -1;
+    sw_nco_track_t *track = NULL;
+    if (n > 0) {
+        track = sw_nco_track_new(t0_unix_s, step_s, offset_hz, n);
+        if (track == NULL) return -1;
+    }
+    // Hand the copy to the worker; it swaps it into the core between
+    // pumps. A newer request replaces one the worker hasn't taken yet.
+    pthread_mutex_lock(&rxs->mu);
+    sw_nco_track_free(rxs->dop_track_req);
+    rxs->dop_track_req     = track;
+    rxs->dop_track_pending = 1;
+    pthread_cond_broadcast(&rxs->cv);
+    pthread_mutex_unlock(&rxs->mu);
+    return 0;
+}
+
+int rx_session_doppler_track_live(const rx_session_t *rxs)
+{
+    if (rxs == NULL || rxs->core == NULL) return 0;
+    return b210_rx_tx_core_doppler_track_live(rxs->core);
+}
+
+int rx_session_set_channel_doppler_track(rx_session_t *rxs, int ch,
+                                         double t0_unix_s, double step_s,
+                                         const double *offset_hz, size_t n)
+{
+    if (rxs == NULL || ch < 0 || ch >= rxs->n_chan || rxs->chan[ch] == NULL)
+        return -1;
+    sw_nco_track_t *track = NULL;
+    if (n > 0) {
+        track = sw_nco_track_new(t0_unix_s, step_s, offset_hz, n);
+        if (track == NULL) return -1;
+    }
+    pthread_mutex_lock(&rxs->mu);
+    sw_nco_track_free(rxs->chan_track_req[ch]);
+    rxs->chan_track_req[ch]     = track;
+    rxs->chan_track_pending[ch] = 1;
+    pthread_cond_broadcast(&rxs->cv);
+    pthread_mutex_unlock(&rxs->mu);
+    return 0;
+}
+
+uint64_t rx_session_channel_frames(rx_session_t *rxs, int ch)
+{
+    if (rxs == NULL || ch < 0 || ch >= rxs->n_chan) return 0;
+    rx_channel_stats_t st;
+    rx_channel_stats(rxs->chan[ch], &st);
+    return st.frames;
+}
+
 void rx_session_set_gain(rx_session_t *rxs, double gain_db)
 {
     if (rxs == NULL) return;
@@ -864,12 +1131,12 @@ void rx_session_set_lo_offset(rx_session_t *rxs,
     // the WAV isn't open (sidecar lifecycle matches the .iq we'd be
     // re-tuning against).
     pthread_mutex_lock(&rxs->mu);
-    if (rxs->lo_offset_fp != NULL) {
+    if (rxs->lo_offset_f != NULL) {
         struct timeval tv;
         gettimeofday(&tv, NULL);
         long long unix_ms = (long long) tv.tv_sec * 1000LL + tv.tv_usec / 1000;
-        fprintf(rxs->lo_offset_fp, "%lld,%.6f\n", unix_ms, new_lo_offset_hz);
-        fflush(rxs->lo_offset_fp);
+        rec_file_printf(rxs->lo_offset_f, "%lld,%.6f\n", unix_ms, new_lo_offset_hz);
+        rec_file_flush(rxs->lo_offset_f);
     }
     pthread_mutex_unlock(&rxs->mu);
 }
@@ -1034,13 +1301,46 @@ void rx_session_close(rx_session_t *rxs)
         pthread_mutex_destroy(&rxs->mu);
     }
     // Worker exited, so we own the wav/iq/core/db scratch outright.
-    if (rxs->wav.fp) wav_w_close(&rxs->wav);
-    if (rxs->iq_fp)  { fclose(rxs->iq_fp); rxs->iq_fp = NULL; }
+    gate_log(rxs, rxs->wav.f != NULL ? "pass" : "idle");
+    sw_nco_track_free(rxs->dop_track_req);
+    rxs->dop_track_req = NULL;
+    // Channel decoders finish what is queued while the DB is still
+    // plugged in below.
+    for (int k = 0; k < rxs->n_chan; k++) {
+        sw_nco_track_free(rxs->chan_track_req[k]);
+        rxs->chan_track_req[k] = NULL;
+        if (rxs->chan[k] == NULL) continue;
+        rx_channel_t *c = rxs->chan[k];
+        rxs->chan[k] = NULL;
+        rx_channel_close_logged(c);
+    }
+    // Close whatever recording is still open, then let the writer drain
+    // it to disk before the process moves on.
+    wav_w_close(&rxs->wav);
+    sso_iq_writer_close(rxs->iq_w);
+    rxs->iq_w = NULL;
+    rec_file_close(rxs->iq_f);
+    rec_file_close(rxs->doppler_f);
+    rec_file_close(rxs->lo_offset_f);
+    rec_file_close(rxs->burst_f);
+    rxs->iq_f = rxs->doppler_f = rxs->lo_offset_f = rxs->burst_f = NULL;
+    rec_writer_stop(rxs->rec);
+    rxs->rec = NULL;
     // After a device loss the SDR is gone, so closing it (stream stop +
     // device free) could fault on the dead device. Leak the handle — the
     // process is exiting anyway — rather than risk a crash on the way out.
     if (rxs->core && !rxs->device_lost) b210_rx_tx_core_close(rxs->core);
-    if (rxs->db)     packet_db_close(rxs->db);
+    if (rxs->db) {
+        // Drain the writer before closing so no queued frame is lost, and
+        // say so if the drain couldn't store everything.
+        decode_loop_set_packet_db(NULL, NULL, NULL);
+        long lost = packet_db_stop_writer(rxs->db);
+        if (lost > 0) {
+            fprintf(stderr, "rx_session: %ld packet row(s) could not be "
+                            "written to the DB\n", lost);
+        }
+        packet_db_close(rxs->db);
+    }
     free(rxs->pcm_chunk);
     free(rxs->iq_chunk);
     free(rxs->iq_decode_chunk);
@@ -1049,6 +1349,7 @@ void rx_session_close(rx_session_t *rxs)
     free(rxs->bits_scratch);
     free(rxs->bytes_scratch);
     free(rxs->audio_ring);
+    bulk_live_free(&rxs->bulk);
     free(rxs);
 }
 
@@ -1087,30 +1388,36 @@ static void try_decode_at_window(rx_session_t *rxs)
         uint64_t asm_abs_sample = window_start_abs
             + (uint64_t) sync_off_local * (uint64_t) rxs->sps
             + (uint64_t)(rxs->sps / 2);
-        uint64_t pos_quant = asm_abs_sample / rxs->dedup_quant;
-        int seen = 0;
-        int ring_n = rxs->pcm_recent_count < DEDUP_RING_SZ
-                   ? rxs->pcm_recent_count : DEDUP_RING_SZ;
-        for (int r = 0; r < ring_n; r++) {
-            if (rxs->pcm_recent_pos_quant[r] == pos_quant) { seen = 1; break; }
-        }
-        if (seen) continue;
-        rxs->pcm_recent_pos_quant[rxs->pcm_recent_idx] = pos_quant;
-        rxs->pcm_recent_idx = (rxs->pcm_recent_idx + 1) % DEDUP_RING_SZ;
-        if (rxs->pcm_recent_count < DEDUP_RING_SZ) rxs->pcm_recent_count++;
+        if (!decode_loop_dedup_add(&rxs->pcm_dedup, asm_abs_sample)) continue;
 
         rxs->pcm_frames_total++;
     }
 }
 
+// Arrival time of the sample at absolute index end_sample: the oldest
+// remembered pump whose block reached past it (the oldest one at all if
+// the frame is older than the history).
+static uint64_t trace_arrival(const rx_session_t *rxs, uint64_t end_sample)
+{
+    uint64_t t = 0;
+    for (unsigned k = 1; k <= RX_TRACE_PUMPS; k++) {
+        unsigned i = (rxs->pump_idx - k) % RX_TRACE_PUMPS;
+        if (rxs->pump_t_ns[i] == 0) break;
+        if (rxs->pump_end_sample[i] < end_sample) break;
+        t = rxs->pump_t_ns[i];
+    }
+    return t;
+}
+
 // IQ-domain decoder — the LIVE primary chain. Runs the IQ-slicer on
 // post-decim IQ (~14 dB SNR-better than the FM-discriminator path),
-// dedupes via the main `recent_pos_quant` ring, then emits to the DB
+// dedupes via the main `dedup` ring, then emits to the DB
 // and packet log, updates per-type bookkeeping + last-frame state,
 // and bumps frames_total. The PCM and Viterbi chains are shadow
 // counters — see try_decode_at_window / try_decode_viterbi_at_window.
 static void try_decode_iq_at_window(rx_session_t *rxs)
 {
+    uint64_t t_window = lat_now_ns();
     size_t inner_min_offset = 0;
     for (;;) {
         ssize_t plen = -1;
@@ -1134,32 +1441,16 @@ static void try_decode_iq_at_window(rx_session_t *rxs)
         inner_min_offset = sync_off_local + 1;
         if (plen < 4 || (size_t) plen > sizeof rxs->packet) continue;
 
-        int       crc_status   = -1;
-        uint32_t  crc_computed = 0, crc_le = 0, crc_be = 0;
         // Always validate the AX100 downlink's CSP CRC32 trailer. A match
         // strips the 4 trailing bytes; a mismatch is recorded (crc_status=0)
         // but the frame is still kept, so low-SNR / partly-corrupted
         // telemetry stays visible rather than being silently dropped.
-        if (plen >= 8) {
-            crc_computed = csp_crc32c(rxs->packet, (size_t)(plen - 4));
-            crc_le = (uint32_t) rxs->packet[plen - 4]
-                   | ((uint32_t) rxs->packet[plen - 3] << 8)
-                   | ((uint32_t) rxs->packet[plen - 2] << 16)
-                   | ((uint32_t) rxs->packet[plen - 1] << 24);
-            crc_be = ((uint32_t) rxs->packet[plen - 4] << 24)
-                   | ((uint32_t) rxs->packet[plen - 3] << 16)
-                   | ((uint32_t) rxs->packet[plen - 2] <<  8)
-                   |  (uint32_t) rxs->packet[plen - 1];
-            if (crc_computed == crc_le || crc_computed == crc_be) {
-                crc_status = 1;
-                plen -= 4;
-            } else {
-                crc_status = 0;
-            }
-        }
+        uint32_t crc_computed, crc_le, crc_be;
+        int crc_status = decode_loop_check_crc(rxs->packet, &plen, &crc_computed,
+                                               &crc_le, &crc_be);
 
         // Dedup by quantised absolute ASM sample index. Uses the main
-        // recent_pos_quant ring (shared with the live emit path) so
+        // dedup ring (shared with the live emit path) so
         // the same physical frame caught in two overlapping windows
         // only writes once.
         uint64_t window_start_abs =
@@ -1167,20 +1458,25 @@ static void try_decode_iq_at_window(rx_session_t *rxs)
         uint64_t asm_abs_sample = window_start_abs
             + (uint64_t) sync_off_local * (uint64_t) rxs->sps
             + (uint64_t)(rxs->sps / 2);
-        uint64_t pos_quant = asm_abs_sample / rxs->dedup_quant;
-        int seen = 0;
-        int ring_n = rxs->recent_count < DEDUP_RING_SZ
-                   ? rxs->recent_count : DEDUP_RING_SZ;
-        for (int r = 0; r < ring_n; r++) {
-            if (rxs->recent_pos_quant[r] == pos_quant) { seen = 1; break; }
-        }
-        if (seen) continue;
-        rxs->recent_pos_quant[rxs->recent_idx] = pos_quant;
-        rxs->recent_idx = (rxs->recent_idx + 1) % DEDUP_RING_SZ;
-        if (rxs->recent_count < DEDUP_RING_SZ) rxs->recent_count++;
+        if (!decode_loop_dedup_add(&rxs->dedup, asm_abs_sample)) continue;
+
+        // Frame end: ASM, Golay length field, then the coded body (the
+        // Golay length when it decoded, else payload plus RS parity).
+        size_t   inner_bytes = used_golay_len > 0 ? (size_t) used_golay_len
+                                                  : (size_t) plen + 32;
+        uint64_t frame_end = asm_abs_sample
+            + (uint64_t)(32 + 24 + inner_bytes * 8) * (uint64_t) rxs->sps;
+        if (frame_end > rxs->total_window_samples) frame_end = rxs->total_window_samples;
+        uint64_t t0 = trace_arrival(rxs, frame_end);
+        uint64_t t_demod = 0, t_unframe = 0;
+        decode_loop_last_timing(&t_demod, &t_unframe);
+        lat_trace_mark_at(LAT_WINDOW, t0, t_window);
+        lat_trace_mark_at(LAT_DEMOD, t0, t_demod);
+        lat_trace_mark_at(LAT_RS, t0, t_unframe);
 
         char ts[64];
-        fmt_utc(ts, sizeof ts);
+        decode_loop_fmt_utc(ts, sizeof ts);
+        lat_trace_set_origin(t0);  // the DB row marks LAT_DB against it
         emit_frame(rxs->log_path[0] ? rxs->log_path : NULL,
                    /*quiet=*/1, ts,
                    rxs->packet, (size_t) plen,
@@ -1190,6 +1486,8 @@ static void try_decode_iq_at_window(rx_session_t *rxs)
                    rs_locs,
                    NULL, 0,
                    rxs->force_beacon);
+        lat_trace_set_origin(0);
+        rxs->frame_t0_ns[rxs->frames_total % RX_TRACE_FRAMES] = t0;
         rxs->frames_total++;
         snprintf(rxs->last_frame_ts, sizeof rxs->last_frame_ts,
                  "%.*s", (int)(sizeof rxs->last_frame_ts - 1), ts);
@@ -1224,6 +1522,17 @@ static void try_decode_iq_at_window(rx_session_t *rxs)
             rxs->last_frame_monotonic_s =
                 (double) mono.tv_sec + (double) mono.tv_nsec * 1e-9;
         }
+
+        // Live bulk-file coverage. The CSP payload starts after the 4-byte
+        // header; a CRC mismatch leaves the trailer on, so drop it here.
+        // Only RS-clean, CRC-good packets may overwrite bytes already held.
+        if (slot == RX_PT_BULK_FILE && plen > 4) {
+            size_t pl_len = (size_t) plen - 4;
+            if (crc_status == 0 && pl_len > 4) pl_len -= 4;
+            bulk_live_add(&rxs->bulk, rxs->packet + 4, pl_len,
+                          rs_errs >= 0 && crc_status != 0,
+                          rxs->last_frame_monotonic_s);
+        }
     }
 }
 
@@ -1260,17 +1569,7 @@ static void try_decode_viterbi_at_window(rx_session_t *rxs)
         uint64_t asm_abs_sample = window_start_abs
             + (uint64_t) sync_off_local * (uint64_t) rxs->sps
             + (uint64_t)(rxs->sps / 2);
-        uint64_t pos_quant = asm_abs_sample / rxs->dedup_quant;
-        int seen = 0;
-        int ring_n = rxs->vit_recent_count < DEDUP_RING_SZ
-                   ? rxs->vit_recent_count : DEDUP_RING_SZ;
-        for (int r = 0; r < ring_n; r++) {
-            if (rxs->vit_recent_pos_quant[r] == pos_quant) { seen = 1; break; }
-        }
-        if (seen) continue;
-        rxs->vit_recent_pos_quant[rxs->vit_recent_idx] = pos_quant;
-        rxs->vit_recent_idx = (rxs->vit_recent_idx + 1) % DEDUP_RING_SZ;
-        if (rxs->vit_recent_count < DEDUP_RING_SZ) rxs->vit_recent_count++;
+        if (!decode_loop_dedup_add(&rxs->vit_dedup, asm_abs_sample)) continue;
 
         rxs->vit_frames_total++;
     }
@@ -1339,6 +1638,42 @@ size_t rx_session_read_audio(rx_session_t *rxs, int16_t *out, size_t max_samples
     return take;
 }
 
+// The gate's PROBE: one IQ demod over the window and an ASM search at
+// the probe's strict Hamming limit. 1 when a sync turned up.
+static int gate_probe(rx_session_t *rxs)
+{
+    size_t n_bits = 0, sync_off = 0;
+    int ham = rxs->gate.p.probe_max_ham;
+    if (ham > rxs->sync_max_ham) ham = rxs->sync_max_ham;
+    return modem_iq_to_bits(rxs->iq_window, rxs->window_samples, &rxs->mp,
+                            0, ham, 0, rxs->bits_scratch, &n_bits,
+                            &sync_off, NULL) == 0 && n_bits > 0;
+}
+
+// One full window: run the chains the gate lets through.
+static void try_decode_windows(rx_session_t *rxs)
+{
+    int iq_ready = rxs->iq_window_filled >= rxs->window_samples;
+    burst_gate_verdict_t v = BURST_GATE_OPEN;
+    if (rxs->gate_on) {
+        v = burst_gate_judge(&rxs->gate,
+                             rxs->total_window_samples - (uint64_t) rxs->window_samples,
+                             rxs->total_window_samples);
+        if (v == BURST_GATE_SKIP) return;
+        if (v == BURST_GATE_PROBE) {
+            if (!iq_ready || !gate_probe(rxs)) return;
+            burst_gate_probe_hit(&rxs->gate);
+        }
+    }
+    uint64_t before = rxs->frames_total;
+    try_decode_at_window(rxs);
+    if (iq_ready) {
+        try_decode_iq_at_window(rxs);
+        try_decode_viterbi_at_window(rxs);
+    }
+    if (rxs->gate_on) burst_gate_frames(&rxs->gate, v, rxs->frames_total - before);
+}
+
 static int worker_pump_once(rx_session_t *rxs)
 {
     // Two IQ taps from the core: iq_chunk is raw post-Doppler IQ with
@@ -1358,22 +1693,66 @@ static int worker_pump_once(rx_session_t *rxs)
                                      rxs->max_chunk * 2,
                                      &iq_decode_pairs);
     if (n < 0) return -1;
+    // The channel branches decimate on their own FIR, so they can have
+    // output on a pump where the primary chain has none.
+    for (int k = 0; k < rxs->n_chan; k++) {
+        if (rxs->chan[k] == NULL) continue;
+        size_t pairs = 0;
+        const int16_t *iq = b210_rx_tx_core_channel_iq(rxs->core,
+                                                       rxs->chan_core_idx[k],
+                                                       &pairs);
+        rx_channel_push(rxs->chan[k], iq, pairs);
+    }
     if (n == 0) return 0;
-    if (rxs->wav.fp) wav_w_append(&rxs->wav, rxs->pcm_chunk, (size_t) n);
+    // Keep the core's Doppler sample clock pinned to UNIX time (it
+    // re-anchors only on real drift, e.g. a block dropped from a full
+    // capture ring). The ring stamps each block with the host time it
+    // was read, so use that; reading the device directly, the pump has
+    // just drained the newest samples and the next one is roughly "now".
+    double t_next;
+    if (b210_rx_tx_core_stream_time(rxs->core, &t_next) != 0) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        t_next = (double) tv.tv_sec + (double) tv.tv_usec * 1e-6;
+    }
+    b210_rx_tx_core_sync_doppler_clock(rxs->core, t_next);
+    // When this block reached the host, on the lat_trace clock: the
+    // capture ring's read stamp (t_next, UNIX) carried across, so time
+    // spent queued in the ring counts against the frame.
+    {
+        uint64_t t_arrive = lat_now_ns();
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        double lag_s = (double) tv.tv_sec + (double) tv.tv_usec * 1e-6 - t_next;
+        if (lag_s > 0.0 && lag_s < 60.0) t_arrive -= (uint64_t)(lag_s * 1e9);
+        unsigned i = rxs->pump_idx++ % RX_TRACE_PUMPS;
+        rxs->pump_end_sample[i] = rxs->total_window_samples + (uint64_t) n;
+        rxs->pump_t_ns[i]       = t_arrive;
+    }
+    burst_gate_note(&rxs->gate, rxs->total_window_samples,
+                    rxs->total_window_samples + (uint64_t) n,
+                    b210_rx_tx_core_pump_burst_peak(rxs->core));
+    if (rxs->wav.f) wav_w_append(&rxs->wav, rxs->pcm_chunk, (size_t) n);
     // Live-audio relay: copy PCM into the ring when a viewer is listening.
     if (rxs->audio_tap_on) audio_ring_push(rxs, rxs->pcm_chunk, (size_t) n);
-    if (rxs->iq_fp && iq_pairs > 0) {
-        size_t want = iq_pairs * 2;  // int16 count
-        if (fwrite(rxs->iq_chunk, sizeof(int16_t), want, rxs->iq_fp) == want) {
-            rxs->iq_pairs_written += iq_pairs;
+    if (rxs->iq_f && iq_pairs > 0) {
+        if (rxs->iq_w != NULL) {
+            // The chunk ends where the stream clock now points.
+            sso_iq_writer_set_time(rxs->iq_w,
+                                   t_next - (double) iq_pairs / rxs->samp_rate,
+                                   b210_rx_tx_core_get_doppler_offset(rxs->core));
+            sso_iq_writer_write(rxs->iq_w, rxs->iq_chunk, iq_pairs);
+        } else {
+            rec_file_write(rxs->iq_f, rxs->iq_chunk, iq_pairs * 2 * sizeof(int16_t));
         }
+        rxs->iq_pairs_written += iq_pairs;
     }
     // Doppler-trajectory sidecar: one line per ~1 s of recording. Lets
     // an offline tool reverse the in-pump NCO if it wants to try a
     // different ephemeris. Stamped with wall-clock UNIX ms (the values
     // we tag the WAV/.iq filenames with), monotonic-aligned by sample
     // count so the sidecar replays without time drift.
-    if (rxs->doppler_fp && rxs->core != NULL) {
+    if (rxs->doppler_f && rxs->core != NULL) {
         double t_now_mono = monotonic_seconds();
         if (rxs->doppler_last_log_t == 0.0
             || (t_now_mono - rxs->doppler_last_log_t) >= 1.0) {
@@ -1382,11 +1761,23 @@ static int worker_pump_once(rx_session_t *rxs)
             long long unix_ms =
                 (long long) tv.tv_sec * 1000LL + tv.tv_usec / 1000;
             double offset = b210_rx_tx_core_get_doppler_offset(rxs->core);
-            fprintf(rxs->doppler_fp, "%lld,%.6f\n", unix_ms, offset);
-            fflush(rxs->doppler_fp);
+            rec_file_printf(rxs->doppler_f, "%lld,%.6f\n", unix_ms, offset);
             rxs->doppler_last_log_t = t_now_mono;
         }
     }
+    // Hand the partly filled blocks to the writer about once a second, so
+    // a crash or power cut loses at most that much of the recording
+    // rather than a whole block.
+    if (rxs->wav.f != NULL) {
+        double t_now_mono = monotonic_seconds();
+        if (t_now_mono - rxs->rec_last_flush_t >= REC_FLUSH_S) {
+            rec_file_flush(rxs->wav.f);
+            rec_file_flush(rxs->iq_f);
+            rec_file_flush(rxs->doppler_f);
+            rec_file_flush(rxs->burst_f);
+            rxs->rec_last_flush_t = t_now_mono;
+        }
+    }
 
     // iq_window feeds the shadow IQ + Viterbi decoders, both of which
     // are calibrated for carrier-at-DC. Source bytes come from the
@@ -1413,11 +1804,7 @@ static int worker_pump_once(rx_session_t *rxs)
         }
         rxs->total_window_samples++;
         if (rxs->window_filled < rxs->window_samples) continue;
-        try_decode_at_window(rxs);
-        if (rxs->iq_window_filled >= rxs->window_samples) {
-            try_decode_iq_at_window(rxs);
-            try_decode_viterbi_at_window(rxs);
-        }
+        try_decode_windows(rxs);
         memmove(rxs->window, rxs->window + rxs->slide_samples,
                 (rxs->window_samples - rxs->slide_samples) * sizeof(int16_t));
         rxs->window_filled = rxs->window_samples - rxs->slide_samples;
@@ -1440,7 +1827,7 @@ static int worker_pump_once(rx_session_t *rxs)
 // per pump iteration — sample cadence matches snapshot cadence.
 static void burst_log_step(rx_session_t *rxs, int bins, double excess_db)
 {
-    if (rxs->burst_fp == NULL) return;
+    if (rxs->burst_f == NULL) return;
 
     struct timeval tv;
     gettimeofday(&tv, NULL);
@@ -1453,10 +1840,9 @@ static void burst_log_step(rx_session_t *rxs, int bins, double excess_db)
             rxs->burst_peak_bins      = bins;
             rxs->burst_peak_excess_db = excess_db;
             rxs->burst_quiet_frames   = 0;
-            fprintf(rxs->burst_fp,
+            rec_file_printf(rxs->burst_f,
                 "burst_start,%lld,%d,%.2f,\n",
                 now_ms, bins, excess_db);
-            fflush(rxs->burst_fp);
         } else {
             if (bins > rxs->burst_peak_bins) rxs->burst_peak_bins = bins;
             if (excess_db > rxs->burst_peak_excess_db) {
@@ -1467,11 +1853,10 @@ static void burst_log_step(rx_session_t *rxs, int bins, double excess_db)
     } else if (rxs->burst_in_progress) {
         rxs->burst_quiet_frames++;
         if (rxs->burst_quiet_frames >= rxs->burst_min_quiet) {
-            fprintf(rxs->burst_fp,
+            rec_file_printf(rxs->burst_f,
                 "burst_end,%lld,%d,%.2f,%lld\n",
                 now_ms, rxs->burst_peak_bins, rxs->burst_peak_excess_db,
                 now_ms - rxs->burst_start_unix_ms);
-            fflush(rxs->burst_fp);
             rxs->burst_in_progress    = 0;
             rxs->burst_quiet_frames   = 0;
             rxs->burst_peak_bins      = 0;
@@ -1498,7 +1883,14 @@ static void worker_update_snapshot(rx_session_t *rxs)
     // like the old hardware-retune scheme.
     double core_freq = b210_rx_tx_core_actual_freq(rxs->core);
     double doppler   = b210_rx_tx_core_get_doppler_offset(rxs->core);
-    int wav_active = (rxs->wav.fp != NULL);
+    int wav_active = (rxs->wav.f != NULL);
+    // Missing-range walk runs outside the lock; the worker owns rxs->bulk.
+    bulk_live_stats_t bulk;
+    struct timespec mono;
+    double now_s = 0.0;
+    if (clock_gettime(CLOCK_MONOTONIC, &mono) == 0)
+        now_s = (double) mono.tv_sec + (double) mono.tv_nsec * 1e-9;
+    bulk_live_stats(&rxs->bulk, now_s, &bulk);
     pthread_mutex_lock(&rxs->mu);
     // lo_offset_hz is written by the main thread under mu; read it here
     // inside the lock and finish the carrier math.
@@ -1537,6 +1929,7 @@ static void worker_update_snapshot(rx_session_t *rxs)
            sizeof rxs->snap_per_type_last_payload);
     memcpy(rxs->snap_per_type_last_summary, rxs->per_type_last_summary,
            sizeof rxs->snap_per_type_last_summary);
+    rxs->snap_bulk = bulk;
     pthread_mutex_unlock(&rxs->mu);
 }
 
@@ -1567,7 +1960,7 @@ static void worker_record_sent_tcmd(rx_session_t *rxs,
     agenda_parse_directive_ms(cmd, "@tsexec=", &tsexec_ms);
 
     char ts_tx[40];
-    fmt_utc(ts_tx, sizeof ts_tx);
+    decode_loop_fmt_utc(ts_tx, sizeof ts_tx);
 
     sent_tcmd_record_t rec = {0};
     rec.ts_sent_ms     = ts_sent_ms;
@@ -1663,18 +2056,44 @@ static void *rx_session_thread_fn(void *arg)
         double new_freq   = rxs->freq_req_hz;
         int gain_change   = rxs->gain_req_pending;
         double new_gain   = rxs->gain_req_db;
+        int dop_change    = rxs->dop_track_pending;
+        sw_nco_track_t *new_track = rxs->dop_track_req;
+        int chan_change[RX_SESSION_CHANNELS_MAX];
+        sw_nco_track_t *chan_track[RX_SESSION_CHANNELS_MAX];
+        for (int k = 0; k < RX_SESSION_CHANNELS_MAX; k++) {
+            chan_change[k] = rxs->chan_track_pending[k];
+            chan_track[k]  = rxs->chan_track_req[k];
+            rxs->chan_track_pending[k] = 0;
+            rxs->chan_track_req[k]     = NULL;
+        }
         int do_wav_start  = rxs->wav_start_req;
         int do_wav_stop   = rxs->wav_stop_req;
         // TX bursts are handled by the tx_thread, NOT here — the worker
         // must never block on a transmit or the RX transport starves.
         rxs->freq_req_pending = 0;
         rxs->gain_req_pending = 0;
+        rxs->dop_track_pending = 0;
+        rxs->dop_track_req    = NULL;
         rxs->wav_start_req    = 0;
         rxs->wav_stop_req     = 0;
         pthread_mutex_unlock(&rxs->mu);
 
-        if (stop) break;
+        if (stop) {
+            sw_nco_track_free(new_track);
+            for (int k = 0; k < RX_SESSION_CHANNELS_MAX; k++)
+                sw_nco_track_free(chan_track[k]);
+            break;
+        }
 
+        if (dop_change) {
+            b210_rx_tx_core_set_doppler_track(rxs->core, new_track);
+        }
+        for (int k = 0; k < RX_SESSION_CHANNELS_MAX; k++) {
+            if (!chan_change[k]) continue;
+            b210_rx_tx_core_set_channel_doppler_track(rxs->core,
+                                                      rxs->chan_core_idx[k],
+                                                      chan_track[k]);
+        }
         if (freq_change) {
             b210_rx_tx_core_set_freq(rxs->core, new_freq);
         }
@@ -1771,8 +2190,23 @@ void rx_session_update_observer(rx_session_t *rxs,
 
 void rx_session_stats_snapshot(const rx_session_t *rxs,
                                rx_packet_type_stats_t out_stats[],
-                               double *out_seconds_since_last_frame)
+                               double *out_seconds_since_last_frame,
+                               packet_db_writer_stats_t *out_db,
+                               bulk_live_stats_t *out_bulk,
+                               sdr_capture_stats_t *out_capture,
+                               rec_writer_stats_t *out_rec)
 {
+    // The recording writer keeps its counters under its own lock; rxs->rec
+    // lives from open to close, like rxs->db.
+    if (out_rec) rec_writer_stats(rxs ? rxs->rec : NULL, out_rec);
+    // Capture counters are lock-free reads off the core; it stays open
+    // until rx_session_close.
+    if (out_capture) {
+        b210_rx_tx_core_capture_stats(rxs ? rxs->core : NULL, out_capture);
+    }
+    // The writer keeps its own counters under its own lock; rxs->db is set
+    // at open and only cleared in close, after the UI has stopped polling.
+    if (out_db) packet_db_writer_stats(rxs ? rxs->db : NULL, out_db);
     if (rxs == NULL) {
         if (out_stats) {
             memset(out_stats, 0,
@@ -1781,10 +2215,12 @@ void rx_session_stats_snapshot(const rx_session_t *rxs,
         if (out_seconds_since_last_frame) {
             *out_seconds_since_last_frame = -1.0;
         }
+        if (out_bulk) memset(out_bulk, 0, sizeof *out_bulk);
         return;
     }
     pthread_mutex_lock((pthread_mutex_t *)&rxs->mu);
     double last_mono = rxs->snap_last_frame_monotonic_s;
+    if (out_bulk) *out_bulk = rxs->snap_bulk;
     if (out_stats) {
         for (int i = 0; i < RX_PT_COUNT; ++i) {
             out_stats[i].count = rxs->snap_per_type_count[i];
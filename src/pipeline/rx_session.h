@@ -30,6 +30,11 @@
 #ifndef RX_SESSION_H
 #define RX_SESSION_H
 
+#include "bulk_live.h"
+#include "lat_trace.h"
+#include "packet_db.h"
+#include "rec_writer.h"
+#include "sdr_capture.h"
 #include "tx_burst.h"
 
 #include <stddef.h>
@@ -44,6 +49,17 @@ typedef struct b210_rx_tx_core b210_rx_tx_core_t;
 
 typedef struct rx_session rx_session_t;
 
+// Extra receive channels (rx_session_params_t.channels): another
+// satellite inside the SDR's capture bandwidth, decoded alongside the
+// primary target from the same stream and tagged with sat_name in the
+// packet DB. offset_hz is its nominal downlink minus the primary's.
+#define RX_SESSION_CHANNELS_MAX 4
+
+typedef struct {
+    const char *sat_name;
+    double      offset_hz;
+} rx_session_channel_t;
+
 // Values 0..3 mirror tx_burst.h's tx_burst_result_t so the worker can cast
 // a tx_burst result straight across. RX_BURST_ABORTED is RX-only (never cast
 // from a tx_burst result): the sync submit path returns it when the session
@@ -69,6 +85,7 @@ typedef struct {
     int            no_db;
     const char    *pass_folder; // base dir for WAV / log; NULL = cwd
     int            want_wav;    // 1 = honour rx_session_wav_start; 0 = stub
+    int            raw_iq;      // 1 = headerless .iq instead of .sso-iq
     const char    *tle_path;
     const char    *sat_name;
     const char    *session_dir; // for packet_db (typically pass_folder)
@@ -78,6 +95,15 @@ typedef struct {
     // needs the same value so the snapshot can reconstruct the effective
     // (Doppler-shifted) carrier frequency for the operator panel.
     double         lo_offset_hz;
+    // 1 = demodulate every window; 0 (default) = skip windows the
+    // iq_burst energy gate calls idle, bar a cheap ASM probe
+    // (burst_gate.h).
+    int            no_burst_gate;
+    // Extra receive channels (see RX_SESSION_CHANNELS_MAX). One that the
+    // core can't place (outside the capture band) is skipped with a
+    // warning; the rest of the session runs regardless.
+    rx_session_channel_t channels[RX_SESSION_CHANNELS_MAX];
+    int                  n_channels;
 } rx_session_params_t;
 
 // rx_session takes ownership of `core` and spawns a worker thread that
@@ -109,6 +135,32 @@ void rx_session_set_lo_offset(rx_session_t *rxs,
 // signal. Pass 0.0 to disable correction entirely.
 void rx_session_set_doppler_offset(rx_session_t *rxs, double offset_hz);
 
+// Hand the worker a whole-pass Doppler trajectory: offset_hz[i] (Hz,
+// same sense as set_doppler_offset) at t0_unix_s + i * step_s. The pump
+// then evaluates it from its own sample clock every chunk and ramps the
+// NCO linearly across the chunk, so the correction no longer depends on
+// the UI tick; set_doppler_offset only applies outside the trajectory.
+// The samples are copied. n == 0 removes the trajectory. Returns 0, or
+// -1 on bad args / OOM (the previous trajectory stays installed).
+int rx_session_set_doppler_track(rx_session_t *rxs, double t0_unix_s,
+                                 double step_s, const double *offset_hz,
+                                 size_t n);
+
+// 1 while the worker is correcting from the trajectory (the last chunk
+// fell inside it), so the caller can stop pushing per-tick offsets.
+int rx_session_doppler_track_live(const rx_session_t *rxs);
+
+// Same as set_doppler_track, for extra channel `ch` (its index in
+// params.channels). Offsets are for that channel's own satellite and
+// carrier. Returns -1 also for a channel that did not open.
+int rx_session_set_channel_doppler_track(rx_session_t *rxs, int ch,
+                                         double t0_unix_s, double step_s,
+                                         const double *offset_hz, size_t n);
+
+// Frames the extra channel `ch` has emitted so far; 0 for one that did
+// not open.
+uint64_t rx_session_channel_frames(rx_session_t *rxs, int ch);
+
 // Change the AD9361 RX gain at runtime. Routed through the worker
 // thread (same handoff pattern as freq retunes) so the UHD streamer
 // isn't touched from the caller's thread. Brief noise discontinuity
@@ -178,8 +230,9 @@ void rx_session_wav_snapshot(const rx_session_t *rxs,
                              int      *out_sample_rate,
                              int      *out_active);
 
-// Companion snapshot for the IQ sidecar (raw interleaved int16 I,Q at
-// the post-decim sample rate). Pairs counts complex samples written.
+// Companion snapshot for the IQ sidecar (.sso-iq, or the raw .iq with
+// --raw-iq; int16 I,Q at the post-decim sample rate). Pairs counts
+// complex samples written; a .sso-iq reader sees them in whole blocks.
 // Same path-persistence semantics as wav_snapshot.
 void rx_session_iq_snapshot(const rx_session_t *rxs,
                             char *out_path, size_t path_cap,
@@ -197,6 +250,12 @@ uint64_t rx_session_pcm_frames(const rx_session_t *rxs);
 // only B signal on the same IQ window the live IQ chain uses.
 uint64_t rx_session_viterbi_frames(const rx_session_t *rxs);
 
+// Latency tracing: mark LAT_PANEL or LAT_IPC for every frame decoded
+// since the last call for that stage. The operator loop calls it right
+// after the RX panel is drawn / a STATE goes out to viewers. Other
+// stages are ignored.
+void rx_session_trace_delivered(rx_session_t *rxs, lat_stage_t stage);
+
 // Sync: hand a TX burst request to the worker, block until it pauses
 // RX, transmits, and resumes RX. Returns the burst's outcome plus a
 // short one-line summary suitable for the operator's TX log.
@@ -280,10 +339,23 @@ typedef struct {
 // Per-type stats snapshot + monotonic time of the last frame in any
 // slot. out_seconds_since_last_frame is negative when no frame has
 // arrived yet (or rxs is NULL). out_stats[] must point at an array
-// of RX_PT_COUNT entries.
+// of RX_PT_COUNT entries. out_db receives the async DB writer's queue
+// depth, commit latency and BUSY-retry counters (all zero with --no-db
+// or when the writer couldn't start). out_bulk receives the live
+// reassembly of the bulk_file download in progress (coverage, the first
+// missing packet ranges, goodput; active = 0 before any bulk packet).
+// out_capture receives the SDR capture ring's overflow, lag and
+// high-water counters (all zero when the worker reads the SDR itself).
+// out_rec receives the recording writer's queue depth, back-pressure
+// waits and write errors (all zero when recording is off).
+// Any out pointer may be NULL.
 void rx_session_stats_snapshot(const rx_session_t *rxs,
                                rx_packet_type_stats_t out_stats[],
-                               double *out_seconds_since_last_frame);
+                               double *out_seconds_since_last_frame,
+                               packet_db_writer_stats_t *out_db,
+                               bulk_live_stats_t *out_bulk,
+                               sdr_capture_stats_t *out_capture,
+                               rec_writer_stats_t *out_rec);
 // Human-readable label for a packet-type slot ("beacon", "log", ...).
 const char *rx_packet_type_label(rx_packet_type_slot_t slot);
 
@@ -0,0 +1,878 @@
+/*
+
+   Simple Satellite Operations  sso_iq.c
+
+   .sso-iq writer and reader, and the raw .iq fallback. See sso_iq.h.
+
+   Layout (all little-endian):
+
+     header   256 B   "SSOIQ\r\n\x1a", u16 version, u16 header bytes,
+                      u32 block pairs, f64 rate / centre / LO offset /
+                      start time, u8 shift, pass id [64] @64, source [64] @128
+     block     40 B   "IQB1", u32 payload bytes, u32 pairs, u32 CRC-32 of
+                      the payload, u64 first pair, f64 UNIX time, f64 Doppler
+              payload I channel then Q channel, MSB-first bit stream
+     index            "IQX1", u32 blocks, then per block its u64 file
+                      offset and the 36 header bytes after its magic
+     footer    16 B   u64 index offset, "SSOIQEND"
+
+   One channel: u2 predictor order p, p warm-up samples (16 bits each),
+   then the residuals in partitions of RICE_PART samples (counted from
+   sample 0, so the first partition is p shorter): u5 Rice parameter k,
+   each zigzagged residual as unary(u >> k) + k low bits; k = 31 escapes
+   to u5 width + raw values.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+*/
+
+#include "sso_iq.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HDR_BYTES    256
+#define BLK_HDR      40
+#define IDX_ENTRY    44
+#define FOOTER_BYTES 16
+#define RICE_PART    256
+#define RICE_ESCAPE  31
+#define MAX_BLOCK_PAIRS (1u << 24)
+
+static const char MAGIC[8]  = { 'S', 'S', 'O', 'I', 'Q', '\r', '\n', 0x1a };
+static const char FOOTER[8] = { 'S', 'S', 'O', 'I', 'Q', 'E', 'N', 'D' };
+
+// ---- little-endian fields ---------------------------------------------------
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = (uint8_t) v; p[1] = (uint8_t) (v >> 8); }
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t) (v >> (8 * i));
+}
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) p[i] = (uint8_t) (v >> (8 * i));
+}
+static void put_f64(uint8_t *p, double d)
+{
+    uint64_t v;
+    memcpy(&v, &d, 8);
+    put_u64(p, v);
+}
+static uint16_t get_u16(const uint8_t *p) { return (uint16_t) (p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+static uint64_t get_u64(const uint8_t *p)
+{
+    return (uint64_t) get_u32(p) | (uint64_t) get_u32(p + 4) << 32;
+}
+static double get_f64(const uint8_t *p)
+{
+    uint64_t v = get_u64(p);
+    double d;
+    memcpy(&d, &v, 8);
+    return d;
+}
+
+static uint32_t crc32_buf(const uint8_t *p, size_t n)
+{
+    static uint32_t table[256];
+    static int ready = 0;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = 1;
+    }
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; ++i) c = table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+// ---- bit streams --------------------------------------------------------------
+
+typedef struct {
+    uint8_t *p;
+    uint64_t acc;    // pending bits, left-aligned
+    int      nb;
+} bitw_t;
+
+static void bw_put(bitw_t *w, uint32_t v, int n)
+{
+    if (n == 0) return;
+    while (w->nb >= 8) {
+        *w->p++ = (uint8_t) (w->acc >> 56);
+        w->acc <<= 8;
+        w->nb -= 8;
+    }
+    w->acc |= (uint64_t) (n == 32 ? v : v & ((1u << n) - 1)) << (64 - w->nb - n);
+    w->nb += n;
+}
+
+static void bw_unary(bitw_t *w, uint32_t q)
+{
+    while (q >= 32) {
+        bw_put(w, 0xFFFFFFFFu, 32);
+        q -= 32;
+    }
+    bw_put(w, ((1u << q) - 1u) << 1, (int) q + 1);
+}
+
+static size_t bw_finish(bitw_t *w, uint8_t *start)
+{
+    while (w->nb > 0) {
+        *w->p++ = (uint8_t) (w->acc >> 56);
+        w->acc <<= 8;
+        w->nb -= 8;
+    }
+    w->nb = 0;
+    return (size_t) (w->p - start);
+}
+
+typedef struct {
+    const uint8_t *p, *end;
+    uint64_t acc;
+    int      nb;
+    int      err;
+} bitr_t;
+
+static void br_refill(bitr_t *r)
+{
+    while (r->nb <= 56 && r->p < r->end) {
+        r->acc |= (uint64_t) *r->p++ << (56 - r->nb);
+        r->nb += 8;
+    }
+}
+
+static uint32_t br_get(bitr_t *r, int n)
+{
+    if (n == 0) return 0;
+    br_refill(r);
+    if (r->nb < n) {
+        r->err = 1;
+        return 0;
+    }
+    uint32_t v = (uint32_t) (r->acc >> (64 - n));
+    r->acc <<= n;
+    r->nb -= n;
+    return v;
+}
+
+static uint32_t br_unary(bitr_t *r)
+{
+    uint32_t q = 0;
+    for (;;) {
+        br_refill(r);
+        if (r->nb == 0 || q > (1u << 21)) {
+            r->err = 1;
+            return 0;
+        }
+        uint64_t inv = ~r->acc;
+        int ones = inv ? __builtin_clzll(inv) : 64;
+        if (ones < r->nb) {
+            q += (uint32_t) ones;
+            r->acc <<= ones + 1;
+            r->nb -= ones + 1;
+            return q;
+        }
+        q += (uint32_t) r->nb;
+        r->acc = 0;
+        r->nb = 0;
+    }
+}
+
+static int bitlen(uint32_t v) { return v ? 32 - __builtin_clz(v) : 0; }
+
+// ---- channel codec --------------------------------------------------------------
+
+static int32_t predict(const int32_t *x, size_t i, int order)
+{
+    switch (order) {
+        case 1:  return x[i - 1];
+        case 2:  return 2 * x[i - 1] - x[i - 2];
+        default: return 0;
+    }
+}
+
+static void encode_channel(bitw_t *w, const int32_t *x, size_t n, uint32_t *u)
+{
+    // Order by the sum of absolute residuals over the common range.
+    uint64_t s[3] = { 0, 0, 0 };
+    for (size_t i = 2; i < n; ++i) {
+        s[0] += (uint64_t) llabs(x[i]);
+        s[1] += (uint64_t) llabs((long long) x[i] - x[i - 1]);
+        s[2] += (uint64_t) llabs((long long) x[i] - 2LL * x[i - 1] + x[i - 2]);
+    }
+    int order = 0;
+    if (s[1] < s[order]) order = 1;
+    if (s[2] < s[order]) order = 2;
+    if ((size_t) order > n) order = (int) n;
+    bw_put(w, (uint32_t) order, 2);
+    for (int i = 0; i < order; ++i) bw_put(w, (uint16_t) x[i], 16);
+
+    for (size_t i = (size_t) order; i < n; ++i) {
+        int32_t e = x[i] - predict(x, i, order);
+        u[i] = ((uint32_t) e << 1) ^ (uint32_t) (e >> 31);
+    }
+    for (size_t p0 = 0; p0 < n; p0 += RICE_PART) {
+        size_t a = p0 < (size_t) order ? (size_t) order : p0;
+        size_t b = p0 + RICE_PART < n ? p0 + RICE_PART : n;
+        if (a >= b) continue;
+        uint64_t len = b - a, sum = 0;
+        uint32_t max = 0;
+        for (size_t i = a; i < b; ++i) {
+            sum += u[i];
+            if (u[i] > max) max = u[i];
+        }
+        int width = bitlen(max);
+        uint64_t best_bits = 10 + len * (uint64_t) width;
+        int best_k = RICE_ESCAPE;
+        int k0 = bitlen((uint32_t) (sum / len));
+        for (int k = k0 > 1 ? k0 - 2 : 0; k <= k0 + 1 && k < RICE_ESCAPE; ++k) {
+            uint64_t bits = 5 + len * (uint64_t) (k + 1);
+            for (size_t i = a; i < b; ++i) bits += u[i] >> k;
+            if (bits < best_bits) {
+                best_bits = bits;
+                best_k = k;
+            }
+        }
+        bw_put(w, (uint32_t) best_k, 5);
+        if (best_k == RICE_ESCAPE) {
+            bw_put(w, (uint32_t) width, 5);
+            for (size_t i = a; i < b; ++i) bw_put(w, u[i], width);
+        } else {
+            for (size_t i = a; i < b; ++i) {
+                bw_unary(w, u[i] >> best_k);
+                bw_put(w, u[i], best_k);
+            }
+        }
+    }
+}
+
+static int decode_channel(bitr_t *r, int32_t *x, size_t n, int shift)
+{
+    int order = (int) br_get(r, 2);
+    if (order > 2 || (size_t) order > n) return -1;
+    for (int i = 0; i < order; ++i) x[i] = (int16_t) br_get(r, 16);
+    int32_t lo = -32768 >> shift, hi = 32767 >> shift;
+    for (size_t p0 = 0; p0 < n && !r->err; p0 += RICE_PART) {
+        size_t a = p0 < (size_t) order ? (size_t) order : p0;
+        size_t b = p0 + RICE_PART < n ? p0 + RICE_PART : n;
+        if (a >= b) continue;
+        int k = (int) br_get(r, 5);
+        int width = k == RICE_ESCAPE ? (int) br_get(r, 5) : 0;
+        for (size_t i = a; i < b; ++i) {
+            uint32_t u;
+            if (k == RICE_ESCAPE) {
+                u = br_get(r, width);
+            } else {
+                uint32_t q = br_unary(r);
+                if (((uint64_t) q << k) >= (1u << 21)) return -1;
+                u = (q << k) | br_get(r, k);
+            }
+            int32_t e = (int32_t) (u >> 1) ^ -(int32_t) (u & 1);
+            int64_t v = (int64_t) e + predict(x, i, order);
+            if (v < lo || v > hi) return -1;
+            x[i] = (int32_t) v;
+        }
+    }
+    return r->err ? -1 : 0;
+}
+
+// Worst case for one block: escape coding everywhere, plus headers.
+static size_t payload_bound(size_t n)
+{
+    return 2 * ((2 + 32 + (n / RICE_PART + 2) * 10 + n * 21) / 8 + 8);
+}
+
+// ---- writer ---------------------------------------------------------------------
+
+typedef struct {
+    uint64_t off;
+    uint64_t first_pair;
+    uint32_t n_pairs;
+    uint32_t payload_bytes;
+    uint32_t crc;
+    double   unix_s;
+    double   doppler_hz;
+} blk_ent_t;
+
+// The 36 bytes after a block's magic, shared with the index entries.
+static void put_ent(uint8_t *p, const blk_ent_t *e)
+{
+    put_u32(p, e->payload_bytes);
+    put_u32(p + 4, e->n_pairs);
+    put_u32(p + 8, e->crc);
+    put_u64(p + 12, e->first_pair);
+    put_f64(p + 20, e->unix_s);
+    put_f64(p + 28, e->doppler_hz);
+}
+
+static void get_ent(const uint8_t *p, blk_ent_t *e)
+{
+    e->payload_bytes = get_u32(p);
+    e->n_pairs       = get_u32(p + 4);
+    e->crc           = get_u32(p + 8);
+    e->first_pair    = get_u64(p + 12);
+    e->unix_s        = get_f64(p + 20);
+    e->doppler_hz    = get_f64(p + 28);
+}
+
+struct sso_iq_writer {
+    sso_iq_meta_t  meta;
+    sso_iq_sink_fn sink;
+    void          *ctx;
+    FILE          *own_fp;
+    int            failed;
+    uint64_t       offset;       // bytes emitted
+
+    uint32_t       block_pairs;
+    int16_t       *blk;          // the block being filled, interleaved
+    size_t         fill;
+    int32_t       *chan;
+    uint32_t      *resid;
+    uint8_t       *out;
+
+    uint64_t       pairs;
+    int            have_anchor;
+    double         anchor_unix;
+    uint64_t       anchor_pair;
+    double         doppler_hz;
+    double         blk_unix;
+    double         blk_doppler;
+
+    blk_ent_t     *idx;
+    size_t         n_idx, cap_idx;
+};
+
+static void emit(sso_iq_writer_t *w, const void *data, size_t len)
+{
+    if (w->failed) return;
+    if (w->sink(w->ctx, data, len) != 0) w->failed = 1;
+    w->offset += len;
+}
+
+static int file_sink(void *ctx, const void *data, size_t len)
+{
+    return fwrite(data, 1, len, (FILE *) ctx) == len ? 0 : -1;
+}
+
+sso_iq_writer_t *sso_iq_writer_new(const sso_iq_meta_t *meta,
+                                   sso_iq_sink_fn sink, void *ctx)
+{
+    if (meta == NULL || sink == NULL || !(meta->sample_rate_hz > 0.0)
+        || meta->shift < 0 || meta->shift > SSO_IQ_MAX_SHIFT) return NULL;
+    sso_iq_writer_t *w = calloc(1, sizeof *w);
+    if (w == NULL) return NULL;
+    w->meta = *meta;
+    if (!(w->meta.block_s > 0.0)) w->meta.block_s = SSO_IQ_BLOCK_S;
+    double bp = floor(w->meta.sample_rate_hz * w->meta.block_s + 0.5);
+    if (bp < RICE_PART) bp = RICE_PART;
+    if (bp > MAX_BLOCK_PAIRS) bp = MAX_BLOCK_PAIRS;
+    w->block_pairs = (uint32_t) bp;
+    w->meta.block_s = bp / w->meta.sample_rate_hz;
+    w->sink = sink;
+    w->ctx  = ctx;
+    w->blk   = malloc((size_t) w->block_pairs * 2 * sizeof *w->blk);
+    w->chan  = malloc((size_t) w->block_pairs * sizeof *w->chan);
+    w->resid = malloc((size_t) w->block_pairs * sizeof *w->resid);
+    w->out   = malloc(payload_bound(w->block_pairs));
+    if (w->blk == NULL || w->chan == NULL || w->resid == NULL || w->out == NULL) {
+        free(w->blk);
+        free(w->chan);
+        free(w->resid);
+        free(w->out);
+        free(w);
+        return NULL;
+    }
+
+    uint8_t h[HDR_BYTES];
+    memset(h, 0, sizeof h);
+    memcpy(h, MAGIC, 8);
+    put_u16(h + 8, 1);
+    put_u16(h + 10, HDR_BYTES);
+    put_u32(h + 12, w->block_pairs);
+    put_f64(h + 16, w->meta.sample_rate_hz);
+    put_f64(h + 24, w->meta.center_freq_hz);
+    put_f64(h + 32, w->meta.lo_offset_hz);
+    put_f64(h + 40, w->meta.start_unix_s);
+    h[48] = (uint8_t) w->meta.shift;
+    memcpy(h + 64,  w->meta.pass_id, strnlen(w->meta.pass_id, 63));
+    memcpy(h + 128, w->meta.source,  strnlen(w->meta.source, 63));
+    emit(w, h, sizeof h);
+    return w;
+}
+
+sso_iq_writer_t *sso_iq_writer_open(const char *path, const sso_iq_meta_t *meta)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) return NULL;
+    sso_iq_writer_t *w = sso_iq_writer_new(meta, file_sink, fp);
+    if (w == NULL) {
+        fclose(fp);
+        return NULL;
+    }
+    w->own_fp = fp;
+    return w;
+}
+
+void sso_iq_writer_set_time(sso_iq_writer_t *w, double unix_s, double doppler_hz)
+{
+    if (w == NULL) return;
+    w->have_anchor = 1;
+    w->anchor_unix = unix_s;
+    w->anchor_pair = w->pairs;
+    w->doppler_hz  = doppler_hz;
+}
+
+static void flush_block(sso_iq_writer_t *w)
+{
+    size_t n = w->fill;
+    if (n == 0) return;
+    bitw_t bw = { w->out, 0, 0 };
+    for (int c = 0; c < 2; ++c) {
+        for (size_t i = 0; i < n; ++i) w->chan[i] = w->blk[2 * i + (size_t) c] >> w->meta.shift;
+        encode_channel(&bw, w->chan, n, w->resid);
+    }
+    size_t len = bw_finish(&bw, w->out);
+
+    blk_ent_t e = {
+        .off = w->offset, .first_pair = w->pairs - n, .n_pairs = (uint32_t) n,
+        .payload_bytes = (uint32_t) len, .crc = crc32_buf(w->out, len),
+        .unix_s = w->blk_unix, .doppler_hz = w->blk_doppler,
+    };
+    uint8_t h[BLK_HDR];
+    memcpy(h, "IQB1", 4);
+    put_ent(h + 4, &e);
+    emit(w, h, sizeof h);
+    emit(w, w->out, len);
+
+    if (w->n_idx == w->cap_idx) {
+        size_t cap = w->cap_idx ? 2 * w->cap_idx : 256;
+        blk_ent_t *p = realloc(w->idx, cap * sizeof *p);
+        if (p == NULL) {
+            w->failed = 1;   // no index: a reader rebuilds it by scanning
+            w->fill = 0;
+            return;
+        }
+        w->idx = p;
+        w->cap_idx = cap;
+    }
+    w->idx[w->n_idx++] = e;
+    w->fill = 0;
+}
+
+int sso_iq_writer_write(sso_iq_writer_t *w, const int16_t *iq, size_t n_pairs)
+{
+    if (w == NULL) return -1;
+    while (n_pairs > 0) {
+        if (w->fill == 0) {
+            // Stamp the block with its first pair.
+            if (w->have_anchor)
+                w->blk_unix = w->anchor_unix
+                            + (double) (w->pairs - w->anchor_pair) / w->meta.sample_rate_hz;
+            else if (w->meta.start_unix_s > 0.0)
+                w->blk_unix = w->meta.start_unix_s + (double) w->pairs / w->meta.sample_rate_hz;
+            else
+                w->blk_unix = 0.0;
+            w->blk_doppler = w->doppler_hz;
+        }
+        size_t room = w->block_pairs - w->fill;
+        size_t n = n_pairs < room ? n_pairs : room;
+        memcpy(w->blk + 2 * w->fill, iq, n * 2 * sizeof *iq);
+        w->fill  += n;
+        w->pairs += n;
+        iq       += 2 * n;
+        n_pairs  -= n;
+        if (w->fill == w->block_pairs) flush_block(w);
+    }
+    return w->failed ? -1 : 0;
+}
+
+uint64_t sso_iq_writer_pairs(const sso_iq_writer_t *w)
+{
+    return w ? w->pairs : 0;
+}
+
+int sso_iq_writer_close(sso_iq_writer_t *w)
+{
+    if (w == NULL) return 0;
+    flush_block(w);
+    if (!w->failed) {
+        uint64_t idx_off = w->offset;
+        uint8_t h[8];
+        memcpy(h, "IQX1", 4);
+        put_u32(h + 4, (uint32_t) w->n_idx);
+        emit(w, h, 8);
+        for (size_t i = 0; i < w->n_idx; ++i) {
+            const blk_ent_t *e = &w->idx[i];
+            uint8_t b[IDX_ENTRY];
+            put_u64(b, e->off);
+            put_ent(b + 8, e);
+            emit(w, b, sizeof b);
+        }
+        uint8_t f[FOOTER_BYTES];
+        put_u64(f, idx_off);
+        memcpy(f + 8, FOOTER, 8);
+        emit(w, f, sizeof f);
+    }
+    int rc = w->failed ? -1 : 0;
+    if (w->own_fp != NULL && fclose(w->own_fp) != 0) rc = -1;
+    free(w->idx);
+    free(w->blk);
+    free(w->chan);
+    free(w->resid);
+    free(w->out);
+    free(w);
+    return rc;
+}
+
+// ---- reader ---------------------------------------------------------------------
+
+struct sso_iq_reader {
+    int            fd;
+    int            container;
+    sso_iq_meta_t  meta;
+    uint32_t       block_pairs;
+    uint64_t       n_pairs;
+
+    blk_ent_t     *idx;          // container: the blocks known so far
+    size_t         n_idx, cap_idx;
+    uint64_t       scan_off;     // next block header to look for
+    int            complete;     // index / footer seen: nothing more to come
+
+    long           cached;       // block decoded into cache, -1 = none
+    int16_t       *cache;
+    int32_t       *chan;
+    uint8_t       *payload;
+    size_t         payload_cap;
+
+    uint64_t       pos;
+};
+
+static int pread_full(int fd, void *buf, size_t len, uint64_t off)
+{
+    uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = pread(fd, p, len, (off_t) off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p   += n;
+        off += (uint64_t) n;
+        len -= (size_t) n;
+    }
+    return 0;
+}
+
+static uint64_t file_size(int fd)
+{
+    struct stat st;
+    return fstat(fd, &st) == 0 && st.st_size > 0 ? (uint64_t) st.st_size : 0;
+}
+
+static int push_ent(sso_iq_reader_t *r, const blk_ent_t *e)
+{
+    if (r->n_idx == r->cap_idx) {
+        size_t cap = r->cap_idx ? 2 * r->cap_idx : 256;
+        blk_ent_t *p = realloc(r->idx, cap * sizeof *p);
+        if (p == NULL) return -1;
+        r->idx = p;
+        r->cap_idx = cap;
+    }
+    r->idx[r->n_idx++] = *e;
+    r->n_pairs = e->first_pair + e->n_pairs;
+    return 0;
+}
+
+// A block entry the rest of the reader can trust: in sequence, in bounds.
+static int ent_sane(const sso_iq_reader_t *r, const blk_ent_t *e, uint64_t size)
+{
+    return e->n_pairs > 0 && e->n_pairs <= r->block_pairs
+        && e->payload_bytes <= payload_bound(r->block_pairs)
+        && e->first_pair == r->n_pairs
+        && e->off >= HDR_BYTES && e->off + BLK_HDR + e->payload_bytes <= size;
+}
+
+// Trailing index, if the writer got as far as closing the file.
+static int load_index(sso_iq_reader_t *r, uint64_t size)
+{
+    uint8_t f[FOOTER_BYTES];
+    if (size < HDR_BYTES + 8 + FOOTER_BYTES
+        || pread_full(r->fd, f, sizeof f, size - FOOTER_BYTES) != 0
+        || memcmp(f + 8, FOOTER, 8) != 0) return -1;
+    uint64_t off = get_u64(f);
+    uint8_t h[8];
+    if (off < HDR_BYTES || off + 8 + FOOTER_BYTES > size
+        || pread_full(r->fd, h, 8, off) != 0 || memcmp(h, "IQX1", 4) != 0) return -1;
+    uint64_t n = get_u32(h + 4);
+    if (off + 8 + n * IDX_ENTRY + FOOTER_BYTES != size) return -1;
+    uint8_t *buf = malloc(n * IDX_ENTRY + 1);
+    if (buf == NULL || pread_full(r->fd, buf, n * IDX_ENTRY, off + 8) != 0) {
+        free(buf);
+        return -1;
+    }
+    int rc = 0;
+    for (uint64_t i = 0; i < n && rc == 0; ++i) {
+        blk_ent_t e;
+        e.off = get_u64(buf + i * IDX_ENTRY);
+        get_ent(buf + i * IDX_ENTRY + 8, &e);
+        if (!ent_sane(r, &e, off) || push_ent(r, &e) != 0) rc = -1;
+    }
+    free(buf);
+    if (rc != 0) {
+        r->n_idx = 0;
+        r->n_pairs = 0;
+        return -1;
+    }
+    r->scan_off = off;
+    r->complete = 1;
+    return 0;
+}
+
+// Walk block headers from scan_off, checking each payload's CRC. Stops
+// quietly at the first block that is short or damaged: on a live file it
+// is still being written, and the next refresh tries it again.
+static int scan_blocks(sso_iq_reader_t *r)
+{
+    uint64_t size = file_size(r->fd);
+    while (!r->complete && r->scan_off + BLK_HDR <= size) {
+        uint8_t h[BLK_HDR];
+        if (pread_full(r->fd, h, sizeof h, r->scan_off) != 0) return -1;
+        if (memcmp(h, "IQX1", 4) == 0) {
+            r->complete = 1;
+            break;
+        }
+        if (memcmp(h, "IQB1", 4) != 0) break;
+        blk_ent_t e;
+        e.off = r->scan_off;
+        get_ent(h + 4, &e);
+        if (!ent_sane(r, &e, size)) break;
+        if (r->payload_cap < e.payload_bytes) break;
+        if (pread_full(r->fd, r->payload, e.payload_bytes, e.off + BLK_HDR) != 0) return -1;
+        if (crc32_buf(r->payload, e.payload_bytes) != e.crc) break;
+        if (push_ent(r, &e) != 0) return -1;
+        r->scan_off = e.off + BLK_HDR + e.payload_bytes;
+    }
+    return 0;
+}
+
+sso_iq_reader_t *sso_iq_open(const char *path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    sso_iq_reader_t *r = calloc(1, sizeof *r);
+    if (r == NULL) {
+        close(fd);
+        return NULL;
+    }
+    r->fd = fd;
+    r->cached = -1;
+
+    uint8_t h[HDR_BYTES];
+    uint64_t size = file_size(fd);
+    if (size < HDR_BYTES || pread_full(fd, h, sizeof h, 0) != 0 || memcmp(h, MAGIC, 8) != 0) {
+        r->n_pairs = size / 4;
+        return r;
+    }
+
+    r->container = 1;
+    r->block_pairs = get_u32(h + 12);
+    r->meta.sample_rate_hz = get_f64(h + 16);
+    r->meta.center_freq_hz = get_f64(h + 24);
+    r->meta.lo_offset_hz   = get_f64(h + 32);
+    r->meta.start_unix_s   = get_f64(h + 40);
+    r->meta.shift          = h[48];
+    memcpy(r->meta.pass_id, h + 64, 63);
+    memcpy(r->meta.source, h + 128, 63);
+    if (get_u16(h + 8) != 1 || get_u16(h + 10) != HDR_BYTES
+        || r->block_pairs == 0 || r->block_pairs > MAX_BLOCK_PAIRS
+        || !(r->meta.sample_rate_hz > 0.0) || r->meta.shift > SSO_IQ_MAX_SHIFT) {
+        sso_iq_close(r);
+        return NULL;
+    }
+    r->meta.block_s = r->block_pairs / r->meta.sample_rate_hz;
+    r->payload_cap = payload_bound(r->block_pairs);
+    r->payload = malloc(r->payload_cap);
+    r->cache = malloc((size_t) r->block_pairs * 2 * sizeof *r->cache);
+    r->chan = malloc((size_t) r->block_pairs * sizeof *r->chan);
+    r->scan_off = HDR_BYTES;
+    if (r->payload == NULL || r->cache == NULL || r->chan == NULL
+        || (load_index(r, size) != 0 && scan_blocks(r) != 0)) {
+        sso_iq_close(r);
+        return NULL;
+    }
+    return r;
+}
+
+void sso_iq_close(sso_iq_reader_t *r)
+{
+    if (r == NULL) return;
+    close(r->fd);
+    free(r->idx);
+    free(r->cache);
+    free(r->chan);
+    free(r->payload);
+    free(r);
+}
+
+int sso_iq_is_container(const sso_iq_reader_t *r) { return r && r->container; }
+const sso_iq_meta_t *sso_iq_meta(const sso_iq_reader_t *r) { return &r->meta; }
+uint64_t sso_iq_pairs(const sso_iq_reader_t *r) { return r ? r->n_pairs : 0; }
+uint64_t sso_iq_tell(const sso_iq_reader_t *r) { return r ? r->pos : 0; }
+
+long long sso_iq_refresh(sso_iq_reader_t *r)
+{
+    if (r == NULL) return -1;
+    uint64_t before = r->n_pairs;
+    if (!r->container) {
+        r->n_pairs = file_size(r->fd) / 4;
+        if (r->n_pairs < before) r->n_pairs = before;   // truncated under us: keep what we had
+    } else if (scan_blocks(r) != 0) {
+        return -1;
+    }
+    return (long long) (r->n_pairs - before);
+}
+
+// Block holding a pair: the grid gives it directly, since every block but
+// the last is full; the search only runs on a file that breaks that.
+static long block_of(const sso_iq_reader_t *r, uint64_t pair)
+{
+    if (pair >= r->n_pairs || r->n_idx == 0) return -1;
+    size_t b = (size_t) (pair / r->block_pairs);
+    if (b < r->n_idx && r->idx[b].first_pair <= pair
+        && pair < r->idx[b].first_pair + r->idx[b].n_pairs) return (long) b;
+    size_t lo = 0, hi = r->n_idx;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (r->idx[mid].first_pair <= pair) lo = mid;
+        else hi = mid;
+    }
+    return (long) lo;
+}
+
+static int decode_block(sso_iq_reader_t *r, long b)
+{
+    if (r->cached == b) return 0;
+    const blk_ent_t *e = &r->idx[b];
+    if (pread_full(r->fd, r->payload, e->payload_bytes, e->off + BLK_HDR) != 0
+        || crc32_buf(r->payload, e->payload_bytes) != e->crc) return -1;
+    bitr_t br = { r->payload, r->payload + e->payload_bytes, 0, 0, 0 };
+    for (int c = 0; c < 2; ++c) {
+        if (decode_channel(&br, r->chan, e->n_pairs, r->meta.shift) != 0) return -1;
+        for (uint32_t i = 0; i < e->n_pairs; ++i)
+            r->cache[2 * i + (size_t) c] = (int16_t) (r->chan[i] * (1 << r->meta.shift));
+    }
+    r->cached = b;
+    return 0;
+}
+
+int sso_iq_seek_pair(sso_iq_reader_t *r, uint64_t pair)
+{
+    if (r == NULL || pair > r->n_pairs) return -1;
+    r->pos = pair;
+    return 0;
+}
+
+int sso_iq_seek_time(sso_iq_reader_t *r, double unix_s)
+{
+    if (r == NULL || !r->container || r->n_idx == 0 || r->idx[0].unix_s <= 0.0) return -1;
+    double rate = r->meta.sample_rate_hz;
+    double k = floor((unix_s - r->idx[0].unix_s) / r->meta.block_s);
+    size_t b = k <= 0.0 ? 0 : k >= (double) r->n_idx ? r->n_idx - 1 : (size_t) k;
+    // The stamps follow the capture clock, not the nominal rate; step to
+    // the block whose stamp really brackets the time (one step at most in
+    // practice).
+    while (b > 0 && r->idx[b].unix_s > unix_s) --b;
+    while (b + 1 < r->n_idx && r->idx[b + 1].unix_s <= unix_s) ++b;
+    const blk_ent_t *e = &r->idx[b];
+    double off = (unix_s - e->unix_s) * rate;
+    if (off < 0.0) off = 0.0;
+    if (off >= (double) e->n_pairs) {
+        if (b + 1 == r->n_idx) return -1;
+        off = (double) e->n_pairs - 1;
+    }
+    r->pos = e->first_pair + (uint64_t) off;
+    return 0;
+}
+
+ssize_t sso_iq_read(sso_iq_reader_t *r, int16_t *out, size_t max_pairs)
+{
+    if (r == NULL) return -1;
+    size_t got = 0;
+    while (got < max_pairs && r->pos < r->n_pairs) {
+        size_t want = max_pairs - got;
+        if (r->n_pairs - r->pos < want) want = (size_t) (r->n_pairs - r->pos);
+        if (!r->container) {
+            if (pread_full(r->fd, out + 2 * got, want * 4, r->pos * 4) != 0) return -1;
+            r->pos += want;
+            got    += want;
+            continue;
+        }
+        long b = block_of(r, r->pos);
+        if (b < 0 || decode_block(r, b) != 0) return -1;
+        const blk_ent_t *e = &r->idx[b];
+        size_t at = (size_t) (r->pos - e->first_pair);
+        size_t n = e->n_pairs - at;
+        if (n > want) n = want;
+        memcpy(out + 2 * got, r->cache + 2 * at, n * 2 * sizeof *out);
+        r->pos += n;
+        got    += n;
+    }
+    return (ssize_t) got;
+}
+
+int sso_iq_stamp(const sso_iq_reader_t *r, uint64_t pair,
+                 double *unix_s, double *doppler_hz)
+{
+    if (r == NULL || !r->container) return -1;
+    long b = block_of(r, pair);
+    if (b < 0) return -1;
+    const blk_ent_t *e = &r->idx[b];
+    if (unix_s) {
+        *unix_s = e->unix_s > 0.0
+                ? e->unix_s + (double) (pair - e->first_pair) / r->meta.sample_rate_hz
+                : 0.0;
+    }
+    if (doppler_hz) *doppler_hz = e->doppler_hz;
+    return 0;
+}
+
+int16_t *sso_iq_load(const char *path, size_t *n_pairs, sso_iq_meta_t *meta_out)
+{
+    sso_iq_reader_t *r = sso_iq_open(path);
+    if (r == NULL) return NULL;
+    size_t n = (size_t) r->n_pairs;
+    int16_t *buf = malloc((n ? n : 1) * 2 * sizeof *buf);
+    if (buf != NULL && sso_iq_read(r, buf, n) != (ssize_t) n) {
+        free(buf);
+        buf = NULL;
+    }
+    if (buf != NULL) {
+        *n_pairs = n;
+        if (meta_out) *meta_out = r->meta;
+    }
+    sso_iq_close(r);
+    return buf;
+}
+
+int sso_iq_path_is_iq(const char *path)
+{
+    size_t n = path ? strlen(path) : 0;
+    size_t e = strlen(SSO_IQ_EXT);
+    return (n > e && strcmp(path + n - e, SSO_IQ_EXT) == 0)
+        || (n > 3 && strcmp(path + n - 3, ".iq") == 0);
+}
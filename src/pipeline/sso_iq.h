@@ -0,0 +1,143 @@
+/*
+
+   Simple Satellite Operations  sso_iq.h
+
+   .sso-iq: the compressed IQ recording container, and one reader for
+   both it and the legacy headerless int16 .iq files.
+
+   A .sso-iq file is a 256-byte header (sample rate, centre frequency,
+   LO offset, start time, pass id), then fixed-duration blocks of
+   interleaved int16 I,Q pairs, then a block index and a footer. Each
+   block carries its first pair's index, UNIX time and the Doppler
+   correction in force, so the Doppler trajectory travels with the
+   samples. I and Q are coded separately with the best of three fixed
+   FLAC-style predictors (orders 0-2) and Rice-coded residuals, 256
+   samples per Rice parameter. The coding is lossless unless the writer
+   asks to drop low bits (meta.shift), which the reader scales back.
+
+   The writer streams: nothing is ever rewritten, so it can feed a pipe
+   or the rec_writer thread. A file without its index -- still being
+   written, or cut short by a crash -- is read by scanning the block
+   headers; a torn last block fails its CRC and is left out.
+
+   Copyright (C) 2026  Johnathan K Burchill
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SSO_IQ_H
+#define SSO_IQ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SSO_IQ_EXT       ".sso-iq"
+#define SSO_IQ_BLOCK_S   0.5     // default block duration
+#define SSO_IQ_MAX_SHIFT 8       // most low bits a writer may drop
+
+typedef struct {
+    double sample_rate_hz;   // 0 = unknown (legacy .iq)
+    double center_freq_hz;   // hardware LO the IQ was captured at
+    double lo_offset_hz;     // signed LO offset from the nominal carrier
+    double start_unix_s;     // UNIX time of pair 0 (0 = unknown)
+    double block_s;          // block duration; writer: <= 0 -> SSO_IQ_BLOCK_S
+    int    shift;            // low bits dropped before coding (0 = lossless)
+    char   pass_id[64];
+    char   source[64];       // writing program
+} sso_iq_meta_t;
+
+// ---- writer ---------------------------------------------------------------
+
+typedef struct sso_iq_writer sso_iq_writer_t;
+
+// Where encoded bytes go, in order. Returns 0, or -1 to fail the write.
+typedef int (*sso_iq_sink_fn)(void *ctx, const void *data, size_t len);
+
+// Start a stream; the header is emitted at once. NULL on a bad rate or
+// shift, or on OOM.
+sso_iq_writer_t *sso_iq_writer_new(const sso_iq_meta_t *meta,
+                                   sso_iq_sink_fn sink, void *ctx);
+// The same onto a file of its own (created / truncated).
+sso_iq_writer_t *sso_iq_writer_open(const char *path, const sso_iq_meta_t *meta);
+
+// UNIX time of the next pair written, and the Doppler correction now in
+// force; stamped into the block that pair starts or lands in. Optional:
+// without it blocks are timed from meta.start_unix_s at the nominal rate.
+void sso_iq_writer_set_time(sso_iq_writer_t *w, double unix_s, double doppler_hz);
+
+// Append interleaved pairs; a block is encoded and emitted each time one
+// fills. 0, or -1 once the sink has failed (later writes are dropped).
+int sso_iq_writer_write(sso_iq_writer_t *w, const int16_t *iq, size_t n_pairs);
+
+uint64_t sso_iq_writer_pairs(const sso_iq_writer_t *w);
+
+// Emit the partial block, the index and the footer, close the file if
+// the writer opened it, and free. 0 if every write succeeded. NULL-safe.
+int sso_iq_writer_close(sso_iq_writer_t *w);
+
+// ---- reader ---------------------------------------------------------------
+
+typedef struct sso_iq_reader sso_iq_reader_t;
+
+// Open a .sso-iq (recognised by its magic, whatever the name) or a raw
+// int16 I,Q file. NULL if it can't be opened or is a damaged container.
+sso_iq_reader_t *sso_iq_open(const char *path);
+void sso_iq_close(sso_iq_reader_t *r);
+
+int sso_iq_is_container(const sso_iq_reader_t *r);
+// Container metadata; all zero for a raw file (rate unknown).
+const sso_iq_meta_t *sso_iq_meta(const sso_iq_reader_t *r);
+// Pairs readable now.
+uint64_t sso_iq_pairs(const sso_iq_reader_t *r);
+
+// Pick up whatever was appended since open / the last refresh (live
+// capture). Returns the number of new pairs, or -1 on a read error.
+long long sso_iq_refresh(sso_iq_reader_t *r);
+
+// Position for the next sso_iq_read. Seeking by time is a division on
+// the fixed block grid plus the block's own stamp: no scan. -1 if the
+// target is past the end (or the file has no time base).
+int sso_iq_seek_pair(sso_iq_reader_t *r, uint64_t pair);
+int sso_iq_seek_time(sso_iq_reader_t *r, double unix_s);
+uint64_t sso_iq_tell(const sso_iq_reader_t *r);
+
+// Copy up to max_pairs from the current position. Pairs read, 0 at the
+// end, -1 on a read or decode error.
+ssize_t sso_iq_read(sso_iq_reader_t *r, int16_t *out, size_t max_pairs);
+
+// UNIX time and Doppler correction at a pair, from its block's stamp.
+// -1 for a raw file or a pair past the end.
+int sso_iq_stamp(const sso_iq_reader_t *r, uint64_t pair,
+                 double *unix_s, double *doppler_hz);
+
+// Whole file into memory (malloc'd, interleaved), for the tools that
+// process a recording end to end. *meta_out (optional) gets the header,
+// zeros for a raw file. NULL on error; an empty file gives a non-NULL
+// buffer and *n_pairs = 0.
+int16_t *sso_iq_load(const char *path, size_t *n_pairs, sso_iq_meta_t *meta_out);
+
+// 1 if path ends in ".sso-iq" or ".iq": the IQ-recording names the
+// tools auto-detect. Content still decides how it is read.
+int sso_iq_path_is_iq(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSO_IQ_H
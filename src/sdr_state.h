@@ -30,6 +30,15 @@
 // rx_session.h (which next_in_queue, a state.h consumer, never links).
 typedef struct rx_session rx_session_t;
 
+// --rx-channel=<sat>@<MHz>: another satellite decoded from the same SDR
+// stream as the primary target. Mirrors RX_SESSION_CHANNELS_MAX.
+#define SDR_RX_CHANNELS_MAX 4
+
+typedef struct {
+    char   name[32];       // TLE catalog name, and the DB satellite tag
+    double freq_hz;        // nominal downlink
+} sdr_rx_channel_t;
+
 typedef struct sdr {
     // SDR backend selection + the live RX session. simple_sat_ops is the
     // single process that opens the SDR; without_b210 (--without-b210, or a
@@ -44,8 +53,24 @@ typedef struct sdr {
     // rx_session opens and keep it open until shutdown, ignoring the usual
     // per-pass elevation gate. For bench characterisation runs.
     int                always_record;
+    // --raw-iq: record the legacy headerless .iq instead of .sso-iq.
+    int                raw_iq;
+    // --no-burst-gate: run the demod chains over every window, not just
+    // where the iq_burst detector sees energy.
+    int                no_burst_gate;
+    sdr_rx_channel_t   rx_channels[SDR_RX_CHANNELS_MAX];
+    int                n_rx_channels;
     sdr_backend_type_t sdr_type;
     char               sdr_device[128];
+    // --rtl-usb=<n>[x<KiB>]: RTL-SDR async USB transfers kept queued and
+    // their size (0 = backend default).
+    int                rtl_xfers;
+    int                rtl_xfer_kib;
+    // --sdr-type=file and the --replay* flags: what the file backend
+    // streams instead of a radio (replay.path points at replay_path, or
+    // is NULL for synthetic bursts). Load testing without hardware.
+    sdr_replay_params_t replay;
+    char               replay_path[512];
     char               uhd_args[256];
     char               sdr_fpga[512];
     rx_session_t      *rx_session;
@@ -50,6 +50,11 @@ typedef struct track {
     double doppler_uplink_frequency_hz;
     double doppler_downlink_frequency_hz;
     int doppler_correction_enabled;
+    // Set by tracking_refresh_pass_cache (and retarget_to_tle) whenever
+    // the per-pass ephemeris table is built, rebuilt or dropped; main.c
+    // then re-sends the RX worker's Doppler trajectory
+    // (tracking_doppler_trajectory) and clears it.
+    int doppler_track_stale;
 } track_t;
 
 #endif // TRACK_STATE_H
@@ -22,6 +22,7 @@
 #include "state.h"
 
 #include "auto_tcmd.h"
+#include "decode_loop.h"
 #include "live_waterfall.h"
 #include "spectrogram.h"
 #include "sso_audit.h"
@@ -198,7 +199,8 @@ static void cmd_insert_str(state_t *state, const char *s)
 // Command names, for first-token completion.
 static const char *const g_cmd_names[] = {
     "help", "tx", "auto", "track", "stop", "home", "retarget",
-    "freq", "rs", "spectrum", "lo_offset", "lo_bandwidth", "gain", "quit",
+    "freq", "rs", "spectrum", "lo_offset", "lo_bandwidth", "gain", "stats",
+    "quit",
 };
 
 // Tab completion at the cursor. The first token completes against
@@ -352,7 +354,7 @@ static void cmd_dispatch(state_t *state)
         cmd_set_status(&state->cmd, "commands: help tx track stop home quit "
                        "retarget <tle-file> "
                        "freq <MHz> lo_offset <signed_kHz> lo_bandwidth <kHz> "
-                       "gain <dB> rs on|off spectrum <sec>");
+                       "gain <dB> rs on|off spectrum <sec> stats latency");
     } else if (strcmp(cmd, "quit") == 0 || strcmp(cmd, "q") == 0
                || strcmp(cmd, "exit") == 0) {
         state->app.running = 0;
@@ -651,6 +653,12 @@ static void cmd_dispatch(state_t *state)
             cmd_set_status(&state->cmd, "gain: this build has no USRP support");
 #endif
         }
+    } else if (strcmp(cmd, "stats") == 0) {
+        // ":stats latency [reset]" -- decode_loop owns the parse so the
+        // headless receivers' REPLs accept the same verb.
+        char status[sizeof state->cmd.status];
+        decode_loop_try_command(state->cmd.buf, status, sizeof status);
+        cmd_set_status(&state->cmd, "%s", status);
     } else {
         cmd_set_status(&state->cmd, "unknown command '%s' (try :help)", cmd);
     }
@@ -215,7 +215,62 @@ void rx_panel_collect_local(state_t *state, rx_panel_data_t *d)
     d->frames_pcm = rx_session_pcm_frames(state->sdr.rx_session);
     d->frames_vit = rx_session_viterbi_frames(state->sdr.rx_session);
     rx_packet_type_stats_t pts[RX_PT_COUNT];
-    rx_session_stats_snapshot(state->sdr.rx_session, pts, &d->age_s);
+    packet_db_writer_stats_t dbw;
+    bulk_live_stats_t bulk;
+    sdr_capture_stats_t cap;
+    rec_writer_stats_t rec;
+    rx_session_stats_snapshot(state->sdr.rx_session, pts, &d->age_s, &dbw,
+                              &bulk, &cap, &rec);
+    d->cap_active         = cap.ring_s > 0.0;
+    d->cap_realtime       = cap.realtime;
+    d->cap_ring_s         = cap.ring_s;
+    d->cap_lag_s          = cap.lag_s;
+    d->cap_high_s         = cap.high_water_s;
+    d->cap_dev_overflows  = (long) cap.device_overflows;
+    d->cap_dev_lost       = (long) cap.device_lost;
+    d->cap_ring_overflows = (long) cap.ring_overflows;
+    d->recw_active        = rec.active;
+    d->recw_uring          = rec.uring;
+    d->recw_queue_depth    = rec.queue_depth;
+    d->recw_queue_max      = rec.queue_max_depth;
+    d->recw_blocks         = rec.blocks;
+    d->recw_waits          = rec.producer_waits;
+    d->recw_max_stall_ms   = rec.max_stall_ms;
+    d->recw_max_batch_ms   = rec.max_batch_ms;
+    d->recw_write_errors   = rec.write_errors;
+    d->db_active        = dbw.active;
+    d->db_queue_depth   = dbw.queue_depth;
+    d->db_queue_max     = dbw.queue_max_depth;
+    d->db_busy_retries  = dbw.busy_retries;
+    d->db_rows_failed   = dbw.rows_failed;
+    d->db_commit_ms     = dbw.last_commit_ms;
+    d->db_commit_max_ms = dbw.max_commit_ms;
+    d->bulk_active      = bulk.active;
+    d->bulk_file_no     = bulk.file_no;
+    d->bulk_eof_known   = bulk.eof_known;
+    d->bulk_present     = bulk.present;
+    d->bulk_extent      = bulk.extent;
+    d->bulk_conflicts   = bulk.conflicts;
+    d->bulk_n_ranges    = bulk.n_ranges;
+    d->bulk_rate_Bps    = bulk.rate_Bps;
+    size_t bm_len = 0;
+    int shown = bulk.n_ranges < BULK_LIVE_MAX_RANGES
+              ? bulk.n_ranges : BULK_LIVE_MAX_RANGES;
+    for (int r = 0; r < shown; ++r) {
+        int n = snprintf(d->bulk_missing + bm_len,
+                         sizeof d->bulk_missing - bm_len, "%s%ld+%ld",
+                         bm_len ? " " : "",
+                         bulk.ranges[r].off, bulk.ranges[r].len);
+        if (n < 0 || (size_t) n >= sizeof d->bulk_missing - bm_len) {
+            shown = r;
+            break;
+        }
+        bm_len += (size_t) n;
+    }
+    if (bulk.n_ranges > shown) {
+        snprintf(d->bulk_missing + bm_len, sizeof d->bulk_missing - bm_len,
+                 " (+%d more)", bulk.n_ranges - shown);
+    }
     for (int s = 0; s < RX_PT_COUNT; ++s) {
         d->pt_count[s]       = pts[s].count;
         d->pt_payload_len[s] = pts[s].last_payload_len;
@@ -330,6 +385,70 @@ void render_rx_panel(const rx_panel_data_t *d,
              (unsigned long long) d->frames_pcm,
              (unsigned long long) d->frames_vit);
     clrtoeol();
+    // SDR capture ring: lag is how far decoding trails the device. A
+    // device overflow means the SDR itself lost samples; a ring overflow
+    // means the DSP fell the whole ring behind. Red on either.
+    if (d->cap_active) {
+        int bad = d->cap_dev_overflows > 0 || d->cap_ring_overflows > 0;
+        char lost[40] = "";
+        if (d->cap_dev_lost > 0)
+            snprintf(lost, sizeof lost, "  (%ld pairs lost)", d->cap_dev_lost);
+        if (bad) attron(COLOR_PAIR(1) | A_BOLD);
+        mvprintw(row++, col,
+                 "%15s   lag %.2f s (max %.2f / %.0f s)  ovf dev %ld ring %ld%s%s",
+                 "capture", d->cap_lag_s, d->cap_high_s, d->cap_ring_s,
+                 d->cap_dev_overflows, d->cap_ring_overflows, lost,
+                 d->cap_realtime ? "" : "  (no rt prio)");
+        if (bad) attroff(COLOR_PAIR(1) | A_BOLD);
+        clrtoeol();
+    }
+    // Recording writer: blocks queued for the disk out of the pool. Waits
+    // mean the disk fell a whole pool behind and the worker stopped for
+    // it; red only when a write failed (audio/IQ lost).
+    if (d->recw_active) {
+        if (d->recw_write_errors > 0) attron(COLOR_PAIR(1) | A_BOLD);
+        mvprintw(row++, col,
+                 "%15s   q %ld/%ld (max %ld)  write %.0f ms max  waits %ld (%.0f ms)  %s%s",
+                 "rec writer", d->recw_queue_depth, d->recw_blocks, d->recw_queue_max,
+                 d->recw_max_batch_ms, d->recw_waits, d->recw_max_stall_ms,
+                 d->recw_uring ? "io_uring" : "pwrite",
+                 d->recw_write_errors > 0 ? "  WRITE ERRORS" : "");
+        if (d->recw_write_errors > 0) attroff(COLOR_PAIR(1) | A_BOLD);
+        clrtoeol();
+    }
+    // DB writer queue: a growing depth or busy count means another process
+    // is holding the write lock; rows are queued, not lost. Red only when
+    // a row actually failed.
+    if (d->db_active) {
+        if (d->db_rows_failed > 0) attron(COLOR_PAIR(1) | A_BOLD);
+        mvprintw(row++, col,
+                 "%15s   q %ld (max %ld)  commit %.1f ms (max %.0f)  busy %ld%s",
+                 "db writer", d->db_queue_depth, d->db_queue_max,
+                 d->db_commit_ms, d->db_commit_max_ms, d->db_busy_retries,
+                 d->db_rows_failed > 0 ? "  FAILED ROWS" : "");
+        if (d->db_rows_failed > 0) attroff(COLOR_PAIR(1) | A_BOLD);
+        clrtoeol();
+    }
+    // Bulk download in progress: how much of the file is in and which
+    // packets to re-request before LOS. ">=" until the short last packet
+    // has fixed the file size.
+    if (d->bulk_active) {
+        double pct = d->bulk_extent > 0
+                   ? 100.0 * (double) d->bulk_present / (double) d->bulk_extent
+                   : 0.0;
+        mvprintw(row++, col,
+                 "%15s   #%d  %ld/%s%ld B (%.1f%%)  %.0f B/s  %d gap%s%s",
+                 "bulk file", d->bulk_file_no, d->bulk_present,
+                 d->bulk_eof_known ? "" : ">=", d->bulk_extent, pct,
+                 d->bulk_rate_Bps, d->bulk_n_ranges,
+                 d->bulk_n_ranges == 1 ? "" : "s",
+                 d->bulk_conflicts > 0 ? "  CONFLICTS" : "");
+        clrtoeol();
+        if (d->bulk_missing[0]) {
+            mvprintw(row++, col, "%15s   %s", "bulk missing", d->bulk_missing);
+            clrtoeol();
+        }
+    }
     if (d->last_frame_summary[0]) {
         mvprintw(row++, col, "%15s   %s", "last frame", d->last_frame_summary);
         clrtoeol();
@@ -1029,4 +1148,11 @@ void render_operator_screen(state_t *state, double jul_utc, double t_now)
     if (tx_log_row >= legend_bottom + 1) {
         render_tx_log_panel(&state->tx, tx_log_row, 1);
     }
+
+#ifdef SSO_WITH_SDR
+    // Frames that reached the RX panel this tick; the caller refreshes
+    // the terminal right after.
+    if (state->sdr.rx_session != NULL)
+        rx_session_trace_delivered(state->sdr.rx_session, LAT_PANEL);
+#endif
 }
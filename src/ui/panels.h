@@ -92,6 +92,52 @@ typedef struct {
     // diagnostics so the operator can spot a chain regression.
     uint64_t   frames_pcm;
     uint64_t   frames_vit;
+    // Async DB writer health (operator-side only; db_active = 0 hides the
+    // row, which is also what viewers see).
+    int        db_active;
+    long       db_queue_depth;
+    long       db_queue_max;
+    long       db_busy_retries;
+    long       db_rows_failed;
+    double     db_commit_ms;
+    double     db_commit_max_ms;
+    // SDR capture thread + ring ahead of the DSP (operator-side only;
+    // cap_active = 0 hides the row). Lag is how far the DSP trails the
+    // device; overflows are device-side (the SDR dropped samples; lost
+    // counts them when the backend can) and ring-side (the DSP fell a
+    // whole ring behind).
+    int        cap_active;
+    int        cap_realtime;
+    double     cap_ring_s;
+    double     cap_lag_s;
+    double     cap_high_s;
+    long       cap_dev_overflows;
+    long       cap_dev_lost;
+    long       cap_ring_overflows;
+    // Recording writer (operator-side only; recw_active = 0 hides the
+    // row). Queue depth in blocks out of the pool; waits are the times
+    // the RX worker had to stop for the disk.
+    int        recw_active;
+    int        recw_uring;
+    long       recw_queue_depth;
+    long       recw_queue_max;
+    long       recw_blocks;
+    long       recw_waits;
+    double     recw_max_stall_ms;
+    double     recw_max_batch_ms;
+    long       recw_write_errors;
+    // Live bulk_file reassembly (bulk_active = 0 hides the rows).
+    // bulk_missing is the first missing ranges on the 195-byte packet
+    // grid as "offset+len ...", ready for comms_bulk_file_downlink_start.
+    int        bulk_active;
+    int        bulk_file_no;
+    int        bulk_eof_known;         // 0 => bulk_extent is a lower bound
+    long       bulk_present;
+    long       bulk_extent;
+    long       bulk_conflicts;
+    int        bulk_n_ranges;
+    double     bulk_rate_Bps;
+    char       bulk_missing[96];
     // Optional warning row (e.g., low-disk). Empty when no warning.
     char       warning[80];
 } rx_panel_data_t;
@@ -19,6 +19,7 @@
 */
 
 #include "spectrogram.h"
+#include "sso_iq.h"
 #include "state.h"
 
 #include <errno.h>
@@ -45,9 +46,13 @@ int generate_full_iq_waterfall(const char *iq_path, int rate_hz,
 {
     if (iq_path == NULL || rate_hz <= 0) return -1;
     size_t len = strlen(iq_path);
+    size_t ext = strlen(SSO_IQ_EXT);
     char png[640];
     int n;
-    if (len >= 3 && strcmp(iq_path + len - 3, ".iq") == 0) {
+    if (len >= ext && strcmp(iq_path + len - ext, SSO_IQ_EXT) == 0) {
+        n = snprintf(png, sizeof png, "%.*s_waterfall.png",
+                     (int)(len - ext), iq_path);
+    } else if (len >= 3 && strcmp(iq_path + len - 3, ".iq") == 0) {
         n = snprintf(png, sizeof png, "%.*s_waterfall.png",
                      (int)(len - 3), iq_path);
     } else {
@@ -125,43 +130,43 @@ int generate_full_spectrogram(const char *wav_path, char *png_out, size_t png_ca
 }
 
 // IQ-slice branch of spectrum_worker. Snapshots `j->iq_pairs` pairs
-// starting at `j->iq_start_pair` from the live .iq file, then shells
-// out gen_waterfall on the slice. Returns 0 on success, -1 on failure
-// (the worker fills j->status_msg in either case).
+// starting at `j->iq_start_pair` from the live recording (.sso-iq or
+// .iq; a container only shows its completed blocks) into a raw .iq,
+// then shells out gen_waterfall on the slice. Returns 0 on success, -1
+// on failure (the worker fills j->status_msg in either case).
 static int spectrum_worker_iq(spectrum_job_t *j)
 {
     char tmp_iq[700];
     snprintf(tmp_iq, sizeof tmp_iq, "%s.tmp.iq", j->png_out);
 
-    FILE *fin = fopen(j->iq_in, "rb");
-    if (fin == NULL) {
+    sso_iq_reader_t *rin = sso_iq_open(j->iq_in);
+    if (rin == NULL) {
         snprintf(j->status_msg, sizeof j->status_msg,
                  "spectrum: open %s failed: %s", j->iq_in, strerror(errno));
         return -1;
     }
-    if (fseek(fin, j->iq_start_pair * 4, SEEK_SET) != 0) {
+    if (sso_iq_seek_pair(rin, (uint64_t) j->iq_start_pair) != 0) {
         snprintf(j->status_msg, sizeof j->status_msg,
-                 "spectrum: iq seek failed: %s", strerror(errno));
-        fclose(fin); return -1;
+                 "spectrum: iq seek past the end of %s", j->iq_in);
+        sso_iq_close(rin); return -1;
     }
     FILE *fout = fopen(tmp_iq, "wb");
     if (fout == NULL) {
         snprintf(j->status_msg, sizeof j->status_msg,
                  "spectrum: open %s failed: %s", tmp_iq, strerror(errno));
-        fclose(fin); return -1;
+        sso_iq_close(rin); return -1;
     }
     int16_t buf[4096];     // 1024 pairs per read
     long remaining = j->iq_pairs;
     while (remaining > 0) {
-        long want_pairs = remaining > (long)(sizeof buf / 4)
-                        ? (long)(sizeof buf / 4) : remaining;
-        size_t int16_count = (size_t)(want_pairs * 2);
-        size_t got = fread(buf, sizeof(int16_t), int16_count, fin);
-        if (got == 0) break;
-        fwrite(buf, sizeof(int16_t), got, fout);
-        remaining -= (long)(got / 2);
+        size_t want_pairs = remaining > (long)(sizeof buf / 4)
+                          ? sizeof buf / 4 : (size_t) remaining;
+        ssize_t got = sso_iq_read(rin, buf, want_pairs);
+        if (got <= 0) break;
+        fwrite(buf, 4, (size_t) got, fout);
+        remaining -= (long) got;
     }
-    fclose(fin); fclose(fout);
+    sso_iq_close(rin); fclose(fout);
 
     char rate_buf[16];
     snprintf(rate_buf, sizeof rate_buf, "%d", j->iq_sample_rate);
@@ -216,6 +216,16 @@ static void viewer_on_event(sso_ipc_client_t *cli, const sso_event_t *evt,
                  sizeof v->rx_panel.last_frame_summary,
                  "%s", evt->rx_last_frame_summary);
         v->rx_panel.age_s = evt->rx_age_s;
+        v->rx_panel.bulk_active    = evt->rx_bk_active;
+        v->rx_panel.bulk_file_no   = evt->rx_bk_file;
+        v->rx_panel.bulk_eof_known = evt->rx_bk_eof;
+        v->rx_panel.bulk_present   = evt->rx_bk_present;
+        v->rx_panel.bulk_extent    = evt->rx_bk_extent;
+        v->rx_panel.bulk_conflicts = evt->rx_bk_conflicts;
+        v->rx_panel.bulk_n_ranges  = evt->rx_bk_gaps;
+        v->rx_panel.bulk_rate_Bps  = evt->rx_bk_rate;
+        snprintf(v->rx_panel.bulk_missing, sizeof v->rx_panel.bulk_missing,
+                 "%s", evt->rx_bk_missing);
         int slots = RX_PANEL_PT_COUNT < SSO_RX_PT_SLOTS
                   ? RX_PANEL_PT_COUNT : SSO_RX_PT_SLOTS;
         for (int s = 0; s < slots; ++s) {
@@ -0,0 +1,226 @@
+/*
+
+    Simple Satellite Operations  unit_tests/bulk_live_selftest.c
+
+    Tests for src/pipeline/bulk_live.c -- the live bulk_file reassembly
+    rx_session feeds during a pass.
+
+      - Coverage: a file with one packet lost reports the right present /
+        missing counts, the exact size once the short last packet is in,
+        the lost packet as a grid-aligned range, and none once the
+        re-request fills it.
+      - Ranges: adjacent lost packets coalesce, a partly-covered packet is
+        asked for whole, and the list truncates with the total still
+        counted.
+      - Quality: uncorrectable data fills a gap but never beats clean data;
+        duplicates and implausible offsets are counted, not laid.
+      - New file: a long idle gap and a clean packet disagreeing with the
+        bytes held both start file #2.
+      - Goodput over the window, and over the file's life while younger.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "bulk_live.h"
+
+#include <math.h>
+#include <string.h>
+
+#define PKT REASM_BULK_MAX_DATA
+
+// File byte i of test file `seed`.
+static uint8_t file_byte(int seed, long i)
+{
+    return (uint8_t) ((i * 7 + seed * 31) & 0xFF);
+}
+
+// Feed packet k of a file of `size` bytes (the last one short).
+static long feed(bulk_live_t *b, int seed, long size, long k, int clean, double t)
+{
+    uint8_t pl[REASM_BULK_HEADER_SIZE + PKT];
+    long off = k * PKT;
+    long n = size - off < PKT ? size - off : PKT;
+    pl[0] = REASM_BULK_PACKET_TYPE;
+    pl[1] = (uint8_t) off;
+    pl[2] = (uint8_t) (off >> 8);
+    pl[3] = (uint8_t) (off >> 16);
+    pl[4] = (uint8_t) (off >> 24);
+    for (long i = 0; i < n; ++i) pl[REASM_BULK_HEADER_SIZE + i] = file_byte(seed, off + i);
+    return bulk_live_add(b, pl, (size_t) (REASM_BULK_HEADER_SIZE + n), clean, t);
+}
+
+static void test_coverage(void)
+{
+    fprintf(stderr, "coverage:\n");
+    bulk_live_t b;
+    bulk_live_init(&b);
+    bulk_live_stats_t st;
+    bulk_live_stats(&b, 100.0, &st);
+    tap_ok(!st.active && st.n_ranges == 0, "inactive before the first packet");
+
+    const long size = 10 * PKT + 50;     // 11 packets, the last short
+    for (long k = 0; k <= 10; ++k)
+        if (k != 4) feed(&b, 1, size, k, 1, 100.0 + (double) k);
+    bulk_live_stats(&b, 111.0, &st);
+    tap_ok(st.active && st.file_no == 1 && st.chunks == 10, "one file, ten packets");
+    tap_okf(st.extent == size && st.eof_known, "size known from the short last packet (%ld)", st.extent);
+    tap_okf(st.present == size - PKT && st.missing == PKT,
+            "present %ld, missing %ld", st.present, st.missing);
+    tap_ok(st.n_ranges == 1 && st.ranges[0].off == 4 * PKT && st.ranges[0].len == PKT,
+           "lost packet reported on the grid");
+    tap_ok(b.map.bytes[3 * PKT + 5] == file_byte(1, 3 * PKT + 5), "bytes laid at their offsets");
+
+    tap_ok(feed(&b, 1, size, 4, 1, 112.0) == PKT, "re-request fills the gap");
+    bulk_live_stats(&b, 112.0, &st);
+    tap_ok(st.missing == 0 && st.n_ranges == 0, "complete file, no ranges");
+    bulk_live_free(&b);
+}
+
+static void test_ranges(void)
+{
+    fprintf(stderr, "ranges:\n");
+    bulk_live_t b;
+    bulk_live_init(&b);
+    bulk_live_stats_t st;
+    const long size = 40 * PKT;
+    // Lose packets 2 and 3 (adjacent), then every odd packet 11..37.
+    for (long k = 0; k < 40; ++k) {
+        if (k == 2 || k == 3 || (k > 10 && k < 39 && (k & 1))) continue;
+        feed(&b, 2, size, k, 1, 10.0);
+    }
+    bulk_live_stats(&b, 10.0, &st);
+    tap_ok(st.ranges[0].off == 2 * PKT && st.ranges[0].len == 2 * PKT,
+           "adjacent lost packets coalesce");
+    tap_okf(st.n_ranges == 1 + 14, "every run counted (%d)", st.n_ranges);
+    tap_ok(st.ranges[BULK_LIVE_MAX_RANGES - 1].off == (11 + 2 * (BULK_LIVE_MAX_RANGES - 2)) * PKT,
+           "list holds the first ranges");
+    tap_ok(!st.eof_known, "no short packet, size not known");
+    bulk_live_free(&b);
+
+    // A packet's tail lost to a shorter overlapping copy still asks for it whole.
+    bulk_live_init(&b);
+    feed(&b, 3, 3 * PKT, 0, 1, 5.0);
+    feed(&b, 3, 3 * PKT, 2, 1, 5.0);
+    uint8_t pl[REASM_BULK_HEADER_SIZE + 100];
+    pl[0] = REASM_BULK_PACKET_TYPE;
+    pl[1] = (uint8_t) PKT; pl[2] = 0; pl[3] = 0; pl[4] = 0;
+    for (long i = 0; i < 100; ++i) pl[REASM_BULK_HEADER_SIZE + i] = file_byte(3, PKT + i);
+    bulk_live_add(&b, pl, sizeof pl, 0, 5.0);
+    bulk_live_stats(&b, 5.0, &st);
+    tap_ok(st.n_ranges == 1 && st.ranges[0].off == PKT && st.ranges[0].len == PKT
+           && st.missing == PKT - 100, "partial packet requested whole");
+    bulk_live_free(&b);
+}
+
+static void test_quality(void)
+{
+    fprintf(stderr, "quality:\n");
+    bulk_live_t b;
+    bulk_live_init(&b);
+    bulk_live_stats_t st;
+    const long size = 4 * PKT;
+    // An uncorrectable copy of packet 1 with a flipped byte fills the gap...
+    uint8_t pl[REASM_BULK_HEADER_SIZE + PKT];
+    pl[0] = REASM_BULK_PACKET_TYPE;
+    pl[1] = (uint8_t) PKT; pl[2] = 0; pl[3] = 0; pl[4] = 0;
+    for (long i = 0; i < PKT; ++i) pl[REASM_BULK_HEADER_SIZE + i] = file_byte(4, PKT + i);
+    pl[REASM_BULK_HEADER_SIZE + 7] ^= 0xFF;
+    tap_ok(bulk_live_add(&b, pl, sizeof pl, 0, 1.0) == PKT, "uncorrectable packet fills a gap");
+    // ...the clean copy replaces it without counting a conflict.
+    tap_ok(feed(&b, 4, size, 1, 1, 2.0) == 0, "clean copy adds no new bytes");
+    tap_ok(b.map.bytes[PKT + 7] == file_byte(4, PKT + 7), "clean beats uncorrectable");
+    // A later uncorrectable copy cannot undo that.
+    bulk_live_add(&b, pl, sizeof pl, 0, 3.0);
+    tap_ok(b.map.bytes[PKT + 7] == file_byte(4, PKT + 7), "uncorrectable never overwrites");
+    bulk_live_stats(&b, 3.0, &st);
+    tap_ok(st.chunks == 3 && st.dup_chunks == 2 && st.conflicts == 0,
+           "duplicates counted, no conflicts");
+
+    pl[4] = 0x7F;   // offset far past any plausible file
+    tap_ok(bulk_live_add(&b, pl, sizeof pl, 1, 4.0) == -1, "implausible offset refused");
+    tap_ok(bulk_live_add(&b, pl, REASM_BULK_HEADER_SIZE, 1, 4.0) == -1, "empty payload refused");
+    bulk_live_stats(&b, 4.0, &st);
+    tap_ok(st.rejected == 2 && st.chunks == 3, "rejections counted, nothing laid");
+    bulk_live_free(&b);
+}
+
+static void test_new_file(void)
+{
+    fprintf(stderr, "new file:\n");
+    bulk_live_t b;
+    bulk_live_init(&b);
+    bulk_live_stats_t st;
+    const long size = 6 * PKT;
+    for (long k = 0; k < 6; ++k) feed(&b, 5, size, k, 1, 10.0);
+    // Same offsets, different content: another file in the same pass.
+    feed(&b, 6, size, 0, 1, 20.0);
+    bulk_live_stats(&b, 20.0, &st);
+    tap_ok(st.file_no == 2 && st.chunks == 1 && st.present == PKT && st.conflicts == 0,
+           "disagreeing clean packet starts file #2");
+    tap_ok(b.map.bytes[10] == file_byte(6, 10), "file #2 holds the new bytes");
+    // An uncorrectable disagreement is just noise: same file.
+    uint8_t pl[REASM_BULK_HEADER_SIZE + PKT];
+    memset(pl, 0x55, sizeof pl);
+    pl[0] = REASM_BULK_PACKET_TYPE;
+    pl[1] = 0; pl[2] = 0; pl[3] = 0; pl[4] = 0;
+    bulk_live_add(&b, pl, sizeof pl, 0, 21.0);
+    bulk_live_stats(&b, 21.0, &st);
+    tap_ok(st.file_no == 2 && st.chunks == 2, "uncorrectable disagreement stays in the file");
+    // A quarter hour of silence: the next packet is a new download.
+    feed(&b, 6, size, 1, 1, 21.0 + BULK_LIVE_IDLE_S + 1.0);
+    bulk_live_stats(&b, 21.0 + BULK_LIVE_IDLE_S + 1.0, &st);
+    tap_ok(st.file_no == 3 && st.chunks == 1 && st.present == PKT,
+           "idle gap starts a new file");
+    tap_ok(st.n_ranges == 1 && st.ranges[0].off == 0 && st.ranges[0].len == PKT,
+           "new file's head reported missing");
+    bulk_live_free(&b);
+}
+
+static void test_rate(void)
+{
+    fprintf(stderr, "goodput:\n");
+    bulk_live_t b;
+    bulk_live_init(&b);
+    bulk_live_stats_t st;
+    const long size = 200 * PKT;
+    // One packet every 0.5 s for 60 s: 390 B/s.
+    for (long k = 0; k < 120; ++k) feed(&b, 7, size, k, 1, 1000.0 + 0.5 * (double) k);
+    bulk_live_stats(&b, 1060.0, &st);
+    tap_okf(fabs(st.rate_Bps - 2.0 * PKT) < 0.05 * 2.0 * PKT,
+            "steady rate over the window (%.1f B/s)", st.rate_Bps);
+    tap_okf(fabs(st.idle_s - 0.5) < 1e-9, "idle since the last packet (%.2f s)", st.idle_s);
+    bulk_live_stats(&b, 1060.0 + BULK_LIVE_RATE_WINDOW_S + 1.0, &st);
+    tap_ok(st.rate_Bps == 0.0, "rate decays to zero once packets stop");
+    bulk_live_free(&b);
+
+    bulk_live_init(&b);
+    for (long k = 0; k < 10; ++k) feed(&b, 8, size, k, 1, 500.0 + 0.5 * (double) k);
+    bulk_live_stats(&b, 505.0, &st);
+    tap_okf(fabs(st.rate_Bps - 10.0 * PKT / 5.0) < 1e-6,
+            "young file averaged over its life (%.1f B/s)", st.rate_Bps);
+    bulk_live_free(&b);
+}
+
+int main(void)
+{
+    test_coverage();
+    test_ranges();
+    test_quality();
+    test_new_file();
+    test_rate();
+    return tap_done();
+}
@@ -0,0 +1,202 @@
+/*
+
+    Simple Satellite Operations  unit_tests/burst_gate_selftest.c
+
+    Tests for src/pipeline/burst_gate.c -- the energy gate that decides
+    which rx_session windows get the demod chains.
+
+      - Quiet: with no activity, idle windows alternate PROBE / SKIP at
+        the default cadence; probe_every 0 skips them all.
+      - Burst: every window overlapping a burst opens, and so do those
+        within the hold after it and the pre-roll before it; the next
+        one out is idle again.
+      - Merging: bursts closer than the hold share one stretch, so the
+        ring of stretches keeps a whole pass of beacons.
+      - No detector: peak_bins < 0 always counts as activity.
+      - Off: bins_threshold 0 opens every window.
+      - Stats: opens, probes, probe hits and gate misses tally, the
+        per-pass delta subtracts, and the audit line reads back.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "burst_gate.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define FS      48000u
+#define PUMP    2040u            // samples a pump
+#define WIN     (FS * 3 / 2)     // 1.5 s window
+#define SLIDE   (FS / 2)         // 0.5 s slide
+
+// Feed pumps from sample `from` up to `to`, marking the ones that
+// overlap [burst_s, burst_e) seconds as lit.
+static void feed(burst_gate_t *g, uint64_t from, uint64_t to, double burst_s, double burst_e)
+{
+    uint64_t bs = (uint64_t)(burst_s * FS), be = (uint64_t)(burst_e * FS);
+    for (uint64_t s = from; s < to; s += PUMP) {
+        uint64_t e = s + PUMP;
+        int lit = burst_e > burst_s && s < be && e > bs;
+        burst_gate_note(g, s, e, lit ? 80 : 12);
+    }
+}
+
+static void test_quiet(void)
+{
+    fprintf(stderr, "quiet:\n");
+    burst_gate_t g;
+    burst_gate_init(&g, NULL, FS);
+    feed(&g, 0, 20 * FS, 0, 0);
+    int probes = 0, skips = 0, opens = 0;
+    burst_gate_verdict_t first = BURST_GATE_OPEN, second = BURST_GATE_OPEN;
+    for (int w = 0; w < 30; w++) {
+        uint64_t end = WIN + (uint64_t) w * SLIDE;
+        burst_gate_verdict_t v = burst_gate_judge(&g, end - WIN, end);
+        if (w == 0) first = v;
+        if (w == 1) second = v;
+        probes += v == BURST_GATE_PROBE;
+        skips  += v == BURST_GATE_SKIP;
+        opens  += v == BURST_GATE_OPEN;
+    }
+    tap_okf(opens == 0 && probes == 15 && skips == 15,
+            "noise-only windows: probe every 2nd (open %d probe %d skip %d)",
+            opens, probes, skips);
+    tap_ok(first == BURST_GATE_PROBE && second == BURST_GATE_SKIP,
+           "first idle window is probed");
+
+    burst_gate_params_t p;
+    burst_gate_params_defaults(&p);
+    p.probe_every = 0;
+    burst_gate_init(&g, &p, FS);
+    feed(&g, 0, 5 * FS, 0, 0);
+    int all_skip = 1;
+    for (int w = 0; w < 6; w++) {
+        uint64_t end = WIN + (uint64_t) w * SLIDE;
+        if (burst_gate_judge(&g, end - WIN, end) != BURST_GATE_SKIP) all_skip = 0;
+    }
+    tap_ok(all_skip, "probe_every 0: idle windows all skipped");
+}
+
+static void test_burst_edges(void)
+{
+    fprintf(stderr, "burst:\n");
+    burst_gate_t g;
+    burst_gate_init(&g, NULL, FS);   // hold 1.0 s, pre-roll 0.25 s
+    // Beacon lit from 10.0 s to 10.3 s; everything pumped up front.
+    feed(&g, 0, 30 * FS, 10.0, 10.3);
+    struct { double start; burst_gate_verdict_t want; const char *what; } cases[] = {
+        {  8.25, BURST_GATE_OPEN, "window ending inside the pre-roll" },
+        {  7.0,  BURST_GATE_PROBE, "window ending before the pre-roll" },
+        {  9.0,  BURST_GATE_OPEN, "window holding the burst" },
+        { 10.2,  BURST_GATE_OPEN, "window starting mid-burst" },
+        { 11.2,  BURST_GATE_OPEN, "window starting inside the hold" },
+        { 11.5,  BURST_GATE_PROBE, "window starting after the hold" },
+    };
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+        burst_gate_init(&g, NULL, FS);
+        feed(&g, 0, 30 * FS, 10.0, 10.3);
+        uint64_t s = (uint64_t)(cases[i].start * FS);
+        burst_gate_verdict_t v = burst_gate_judge(&g, s, s + WIN);
+        tap_okf(v == cases[i].want, "%s (got %d)", cases[i].what, (int) v);
+    }
+}
+
+static void test_merge(void)
+{
+    fprintf(stderr, "merging:\n");
+    burst_gate_t g;
+    burst_gate_init(&g, NULL, FS);
+    // Twenty beacons 0.6 s apart (closer than the 1 s hold), then a
+    // far-off one: two stretches, the early beacons still covered.
+    for (int b = 0; b < 20; b++) {
+        uint64_t s = (uint64_t)((1.0 + 0.6 * b) * FS);
+        burst_gate_note(&g, s, s + PUMP, 90);
+    }
+    burst_gate_note(&g, 100 * FS, 100 * FS + PUMP, 90);
+    tap_okf(g.n_st == 2, "close beacons share a stretch (%u stretches)", g.n_st);
+    tap_ok(burst_gate_judge(&g, 1 * FS, 1 * FS + WIN) == BURST_GATE_OPEN,
+           "first beacon's window still opens after later ones");
+    tap_ok(burst_gate_judge(&g, 50 * FS, 50 * FS + WIN) == BURST_GATE_PROBE,
+           "the gap between stretches is idle");
+}
+
+static void test_no_detector_and_off(void)
+{
+    fprintf(stderr, "no detector / off:\n");
+    burst_gate_t g;
+    burst_gate_init(&g, NULL, FS);
+    for (uint64_t s = 0; s < 10 * FS; s += PUMP) burst_gate_note(&g, s, s + PUMP, -1);
+    tap_ok(burst_gate_judge(&g, 5 * FS, 5 * FS + WIN) == BURST_GATE_OPEN,
+           "peak_bins < 0 counts as activity");
+
+    burst_gate_params_t p;
+    burst_gate_params_defaults(&p);
+    p.bins_threshold = 0;
+    burst_gate_init(&g, &p, FS);
+    feed(&g, 0, 10 * FS, 0, 0);
+    tap_ok(burst_gate_judge(&g, 5 * FS, 5 * FS + WIN) == BURST_GATE_OPEN,
+           "bins_threshold 0 turns the gate off");
+}
+
+static void test_stats(void)
+{
+    fprintf(stderr, "stats:\n");
+    burst_gate_t g;
+    burst_gate_init(&g, NULL, FS);
+    feed(&g, 0, 30 * FS, 20.0, 20.3);
+    burst_gate_stats_t base = g.stats;
+    int open = 0, probe = 0, skip = 0;
+    for (int w = 0; w < 56; w++) {
+        uint64_t s = (uint64_t) w * SLIDE;
+        burst_gate_verdict_t v = burst_gate_judge(&g, s, s + WIN);
+        if (v == BURST_GATE_OPEN) { open++; burst_gate_frames(&g, v, 1); }
+        else if (v == BURST_GATE_PROBE) {
+            probe++;
+            if (w == 4) {      // a weak frame the energy gate missed
+                burst_gate_probe_hit(&g);
+                burst_gate_frames(&g, v, 1);
+            }
+        } else skip++;
+    }
+    burst_gate_stats_t d;
+    burst_gate_stats_since(&g.stats, &base, &d);
+    tap_okf(d.windows == 56 && d.opened == (uint64_t) open && d.probed == (uint64_t) probe
+            && d.skipped == (uint64_t) skip,
+            "window tallies (%d open, %d probed, %d skipped)", open, probe, skip);
+    tap_ok(d.probe_opened == 1 && d.frames_probe == 1 && d.frames_open == (uint64_t) open,
+           "probe hit and gate miss counted");
+    char line[256];
+    burst_gate_format(&d, line, sizeof line);
+    char want[64];
+    snprintf(want, sizeof want, "windows=56 open=%d ", open);
+    tap_okf(strstr(line, want) != NULL && strstr(line, "gate_miss=1") != NULL,
+            "audit line: %s", line);
+    burst_gate_stats_t again;
+    burst_gate_stats_since(&g.stats, &g.stats, &again);
+    tap_ok(again.windows == 0 && again.frames_probe == 0, "delta against itself is zero");
+}
+
+int main(void)
+{
+    test_quiet();
+    test_burst_edges();
+    test_merge();
+    test_no_detector_and_off();
+    test_stats();
+    return tap_done();
+}
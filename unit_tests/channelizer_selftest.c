@@ -0,0 +1,277 @@
+/*
+
+    Simple Satellite Operations  unit_tests/channelizer_selftest.c
+
+    Tests for src/dsp/channelizer.c -- the extra receive channels the
+    B210 core carves out of its wideband read.
+
+      - Parameters: bad constructor arguments give NULL; a branch whose
+        band would fall off the capture edge is refused, as is one past
+        CHANNELIZER_MAX.
+      - Tuning: a tone at a branch's offset comes out at DC at the
+        post-decim rate with unity gain.
+      - Isolation: two branches each keep their own tone and reject the
+        other's by > 40 dB.
+      - Doppler: a fixed offset and a trajectory each pull an
+        offset-plus-Doppler tone to DC; the trajectory only counts as
+        live with a valid clock.
+      - Threads: the pool's output is sample-identical to the serial
+        path, and start / wait split around other work gives the same.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "channelizer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// The live chain's numbers: 480 kS/s in, M=5, 42 kHz cutoff, 256 taps.
+#define FS_IN   480000.0
+#define M_DEC   5u
+#define FC      42000.0
+#define TAPS    256u
+#define CHUNK   2040u
+#define N_CHUNK 40u            // 0.17 s of input
+#define SKIP    (TAPS / M_DEC) // output samples still in the FIR warm-up
+
+// Sum of complex tones (freq Hz, amplitude) into sc16, continuous
+// across chunks through the running sample index k0.
+static void tones(int16_t *iq, size_t n, uint64_t k0,
+                  const double *f, const double *a, int n_tones)
+{
+    for (size_t i = 0; i < n; i++) {
+        double I = 0.0, Q = 0.0;
+        for (int t = 0; t < n_tones; t++) {
+            double ph = 2.0 * M_PI * f[t] * (double)(k0 + i) / FS_IN;
+            I += a[t] * cos(ph);
+            Q += a[t] * sin(ph);
+        }
+        iq[2 * i]     = (int16_t) lrint(I);
+        iq[2 * i + 1] = (int16_t) lrint(Q);
+    }
+}
+
+typedef struct {
+    int16_t *buf[CHANNELIZER_MAX];   // every output sample, per branch
+    size_t   n[CHANNELIZER_MAX];
+} capture_t;
+
+static void capture_free(capture_t *c)
+{
+    for (int i = 0; i < CHANNELIZER_MAX; i++) free(c->buf[i]);
+}
+
+// Push N_CHUNK chunks of the given tones through ch and collect each
+// branch's output. split: drive start / wait separately, doing the
+// next chunk's synthesis in between the way the pump runs the primary
+// chain.
+static void run(channelizer_t *ch, const double *f, const double *a, int n_tones,
+                int clock_valid, int split, capture_t *out)
+{
+    memset(out, 0, sizeof *out);
+    int nb = channelizer_count(ch);
+    for (int b = 0; b < nb; b++) {
+        out->buf[b] = malloc((N_CHUNK * (CHUNK / M_DEC + 1)) * 2 * sizeof(int16_t));
+    }
+    int16_t in[2][CHUNK * 2];
+    tones(in[0], CHUNK, 0, f, a, n_tones);
+    for (unsigned c = 0; c < N_CHUNK; c++) {
+        int16_t *cur = in[c & 1];
+        double t0 = 1000.0 + (double)(c * CHUNK) / FS_IN;
+        if (split) {
+            channelizer_start(ch, cur, CHUNK, t0, clock_valid);
+            tones(in[(c + 1) & 1], CHUNK, (uint64_t)(c + 1) * CHUNK, f, a, n_tones);
+            channelizer_wait(ch);
+        } else {
+            channelizer_push(ch, cur, CHUNK, t0, clock_valid);
+            tones(in[(c + 1) & 1], CHUNK, (uint64_t)(c + 1) * CHUNK, f, a, n_tones);
+        }
+        for (int b = 0; b < nb; b++) {
+            size_t n = 0;
+            const int16_t *o = channelizer_out(ch, b, &n);
+            memcpy(out->buf[b] + out->n[b] * 2, o, n * 2 * sizeof(int16_t));
+            out->n[b] += n;
+        }
+    }
+}
+
+// Mean frequency (Hz) and magnitude past the warm-up.
+static void measure(const int16_t *iq, size_t n, double fs, double *freq, double *mag)
+{
+    double dphi = 0.0, m = 0.0;
+    size_t cnt = 0;
+    for (size_t k = SKIP + 1; k < n; k++) {
+        double I0 = iq[2 * (k - 1)], Q0 = iq[2 * (k - 1) + 1];
+        double I1 = iq[2 * k],       Q1 = iq[2 * k + 1];
+        dphi += atan2(Q1 * I0 - I1 * Q0, I1 * I0 + Q1 * Q0);
+        m    += sqrt(I1 * I1 + Q1 * Q1);
+        cnt++;
+    }
+    *freq = cnt ? dphi / (double) cnt * fs / (2.0 * M_PI) : 0.0;
+    *mag  = cnt ? m / (double) cnt : 0.0;
+}
+
+static double power(const int16_t *iq, size_t n)
+{
+    double p = 0.0;
+    for (size_t k = SKIP; k < n; k++) {
+        p += (double) iq[2 * k] * iq[2 * k] + (double) iq[2 * k + 1] * iq[2 * k + 1];
+    }
+    return n > SKIP ? p / (double)(n - SKIP) : 0.0;
+}
+
+static void test_params(void)
+{
+    fprintf(stderr, "parameters:\n");
+    tap_ok(channelizer_new(0.0, M_DEC, FC, TAPS, CHUNK, 0) == NULL, "zero rate refused");
+    tap_ok(channelizer_new(FS_IN, 1u, FC, TAPS, CHUNK, 0) == NULL, "M < 2 refused");
+    tap_ok(channelizer_new(FS_IN, M_DEC, FS_IN, TAPS, CHUNK, 0) == NULL,
+           "cutoff past Nyquist refused");
+    channelizer_t *ch = channelizer_new(FS_IN, M_DEC, FC, TAPS, CHUNK, 0);
+    tap_ok(ch != NULL && channelizer_out_rate(ch) == FS_IN / M_DEC, "96 kS/s out");
+    tap_ok(channelizer_add(ch, 200000.0) < 0, "band off the capture edge refused");
+    tap_ok(channelizer_add(ch, -192000.0) == 0, "band right at the edge accepted");
+    int last = 0;
+    while (channelizer_add(ch, 0.0) >= 0) last++;
+    tap_okf(channelizer_count(ch) == CHANNELIZER_MAX && last == CHANNELIZER_MAX - 1,
+            "table holds %d branches", channelizer_count(ch));
+    size_t n = 99;
+    tap_ok(channelizer_out(ch, CHANNELIZER_MAX, &n) == NULL && n == 0,
+           "out of range index: no output");
+    channelizer_free(ch);
+    channelizer_free(NULL);
+}
+
+static void test_tuning_and_isolation(void)
+{
+    fprintf(stderr, "tuning / isolation:\n");
+    channelizer_t *ch = channelizer_new(FS_IN, M_DEC, FC, TAPS, CHUNK, 0);
+    channelizer_add(ch, 100000.0);
+    channelizer_add(ch, -60000.0);
+    double f[2] = { 100000.0, -60000.0 }, a[2] = { 8000.0, 8000.0 };
+    capture_t both;
+    run(ch, f, a, 2, 0, 0, &both);
+    double fq, mag;
+    measure(both.buf[0], both.n[0], FS_IN / M_DEC, &fq, &mag);
+    tap_okf(fabs(fq) < 1.0 && fabs(mag - 8000.0) < 160.0,
+            "+100 kHz branch: tone at %.2f Hz, |z| %.0f", fq, mag);
+    measure(both.buf[1], both.n[1], FS_IN / M_DEC, &fq, &mag);
+    tap_okf(fabs(fq) < 1.0 && fabs(mag - 8000.0) < 160.0,
+            "-60 kHz branch: tone at %.2f Hz, |z| %.0f", fq, mag);
+    tap_okf(both.n[0] >= N_CHUNK * CHUNK / M_DEC - 1, "%zu samples out", both.n[0]);
+    capture_free(&both);
+    channelizer_free(ch);
+
+    // The other branch's tone alone: what leaks through the FIR.
+    ch = channelizer_new(FS_IN, M_DEC, FC, TAPS, CHUNK, 0);
+    channelizer_add(ch, 100000.0);
+    capture_t own, other;
+    run(ch, &f[0], &a[0], 1, 0, 0, &own);
+    channelizer_free(ch);
+    ch = channelizer_new(FS_IN, M_DEC, FC, TAPS, CHUNK, 0);
+    channelizer_add(ch, 100000.0);
+    run(ch, &f[1], &a[1], 1, 0, 0, &other);
+    double rej = 10.0 * log10(power(own.buf[0], own.n[0])
+                              / (power(other.buf[0], other.n[0]) + 1e-3));
+    tap_okf(rej > 40.0, "neighbour rejected by %.1f dB", rej);
+    capture_free(&own);
+    capture_free(&other);
+    channelizer_free(ch);
+}
+
+static void test_doppler(void)
+{
+    fprintf(stderr, "doppler:\n");
+    double f = 50000.0 + 3000.0, a = 8000.0;
+    channelizer_t *ch = channelizer_new(FS_IN, M_DEC, FC, TAPS, CHUNK, 0);
+    channelizer_add(ch, 50000.0);
+    channelizer_set_doppler(ch, 0, 3000.0);
+    capture_t out;
+    run(ch, &f, &a, 1, 0, 0, &out);
+    double fq, mag;
+    measure(out.buf[0], out.n[0], FS_IN / M_DEC, &fq, &mag);
+    tap_okf(fabs(fq) < 1.0, "fixed offset: tone at %.2f Hz", fq);
+    tap_ok(!channelizer_track_live(ch, 0), "no trajectory: not live");
+    capture_free(&out);
+
+    double offs[3] = { 3000.0, 3000.0, 3000.0 };
+    channelizer_set_doppler(ch, 0, 0.0);
+    channelizer_set_track(ch, 0, sw_nco_track_new(900.0, 100.0, offs, 3));
+    run(ch, &f, &a, 1, 0, 0, &out);
+    measure(out.buf[0], out.n[0], FS_IN / M_DEC, &fq, &mag);
+    tap_okf(!channelizer_track_live(ch, 0) && fabs(fq - 3000.0) < 1.0,
+            "trajectory without a clock: fixed offset applies (%.2f Hz)", fq);
+    capture_free(&out);
+    run(ch, &f, &a, 1, 1, 0, &out);
+    measure(out.buf[0], out.n[0], FS_IN / M_DEC, &fq, &mag);
+    tap_okf(channelizer_track_live(ch, 0) && fabs(fq) < 1.0,
+            "trajectory with a clock: live, tone at %.2f Hz", fq);
+    capture_free(&out);
+    channelizer_set_track(ch, 0, NULL);
+    tap_ok(!channelizer_track_live(ch, 0), "trajectory removed");
+    channelizer_free(ch);
+}
+
+static void test_threads(void)
+{
+    fprintf(stderr, "threads:\n");
+    double f[3] = { 120000.0, 10000.0, -150000.0 }, a[3] = { 6000.0, 6000.0, 6000.0 };
+    double shifts[4] = { 120000.0, 10000.0, -150000.0, -40000.0 };
+    capture_t ref, par, split;
+    channelizer_t *ch = channelizer_new(FS_IN, M_DEC, FC, TAPS, CHUNK, 0);
+    for (int b = 0; b < 4; b++) channelizer_add(ch, shifts[b]);
+    run(ch, f, a, 3, 0, 0, &ref);
+    channelizer_free(ch);
+
+    ch = channelizer_new(FS_IN, M_DEC, FC, TAPS, CHUNK, 3);
+    for (int b = 0; b < 4; b++) channelizer_add(ch, shifts[b]);
+    run(ch, f, a, 3, 0, 0, &par);
+    channelizer_free(ch);
+
+    ch = channelizer_new(FS_IN, M_DEC, FC, TAPS, CHUNK, 2);
+    for (int b = 0; b < 4; b++) channelizer_add(ch, shifts[b]);
+    run(ch, f, a, 3, 0, 1, &split);
+    channelizer_free(ch);
+
+    int same_par = 1, same_split = 1;
+    for (int b = 0; b < 4; b++) {
+        size_t bytes = ref.n[b] * 2 * sizeof(int16_t);
+        if (par.n[b] != ref.n[b] || memcmp(par.buf[b], ref.buf[b], bytes) != 0) same_par = 0;
+        if (split.n[b] != ref.n[b] || memcmp(split.buf[b], ref.buf[b], bytes) != 0) same_split = 0;
+    }
+    tap_ok(same_par, "3-thread pool matches the serial path");
+    tap_ok(same_split, "start / wait split matches the serial path");
+    capture_free(&ref);
+    capture_free(&par);
+    capture_free(&split);
+}
+
+int main(void)
+{
+    test_params();
+    test_tuning_and_isolation();
+    test_doppler();
+    test_threads();
+    return tap_done();
+}
@@ -0,0 +1,290 @@
+/*
+
+    Simple Satellite Operations  unit_tests/chunk_reasm_selftest.c
+
+    Tests for src/db/chunk_reasm.c -- the offset-addressed reassembly behind
+    mpi_reconstruct and cam_reconstruct's --patch. The oracle for the map is
+    the byte-array reassembly mpi_reconstruct used before the shared engine:
+    RS-clean chunks laid first in order (last wins, disagreements counted),
+    then uncorrectable chunks filling only bytes still missing.
+
+      - Bulk payload parse: offset, CRC-trailer clamp, short and implausible
+        payloads refused.
+      - Map basics: gap/overlap/touching inserts, newly-filled counts,
+        conflicts, clean-over-uncorrectable, gap enumeration.
+      - Map vs the byte-array oracle on randomized overlapping chunk sets:
+        bytes, present count, conflicts, min offset, and the gap list.
+      - Sessions vs the old rescan-every-chunk clustering on randomized
+        time series, including marks inside a previous session's margin.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "chunk_reasm.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Deterministic LCG so failures reproduce.
+static unsigned long rng_state = 12345;
+static unsigned long rnd(unsigned long n)
+{
+    rng_state = rng_state * 6364136223846793005UL + 1442695040888963407UL;
+    return (rng_state >> 33) % n;
+}
+
+// ---- reasm_bulk_chunk --------------------------------------------------
+
+static void test_bulk_chunk(void)
+{
+    fprintf(stderr, "reasm_bulk_chunk:\n");
+    uint8_t pl[5 + 199];
+    memset(pl, 0xAB, sizeof pl);
+    pl[0] = REASM_BULK_PACKET_TYPE;
+    pl[1] = 0x34; pl[2] = 0x12; pl[3] = 0x01; pl[4] = 0x00;   // 0x011234
+    long off = -1, dlen = -1;
+    const uint8_t *data = NULL;
+    int rc = reasm_bulk_chunk(pl, (int) sizeof pl, &off, &data, &dlen);
+    tap_okf(rc == 0 && off == 0x011234, "little-endian offset (%ld)", off);
+    tap_okf(dlen == REASM_BULK_MAX_DATA && data == pl + 5,
+            "data clamped to %d bytes, CRC trailer dropped (%ld)", REASM_BULK_MAX_DATA, dlen);
+    rc = reasm_bulk_chunk(pl, 10, &off, &data, &dlen);
+    tap_ok(rc == 0 && dlen == 5, "short chunk keeps its length");
+    tap_ok(reasm_bulk_chunk(pl, 5, &off, &data, &dlen) == -1, "header-only payload refused");
+    tap_ok(reasm_bulk_chunk(NULL, 0, &off, &data, &dlen) == -1, "NULL payload refused");
+    pl[3] = 0x40;   // 0x401234 > 2 MB
+    tap_ok(reasm_bulk_chunk(pl, (int) sizeof pl, &off, &data, &dlen) == -1,
+           "implausible offset refused");
+}
+
+// ---- map basics -----------------------------------------------------------
+
+static void test_map_basics(void)
+{
+    fprintf(stderr, "reasm_map basics:\n");
+    reasm_map_t m;
+    reasm_map_init(&m, '?');
+    uint8_t a[10], b[10], c[10];
+    memset(a, 'A', sizeof a);
+    memset(b, 'B', sizeof b);
+    memset(c, 'C', sizeof c);
+
+    tap_ok(reasm_map_insert(&m, 10, a, 10, 1) == 10, "first insert fills 10 bytes");
+    tap_ok(m.size == 20 && m.bytes[0] == '?' && m.bytes[10] == 'A' && m.min_off == 10,
+           "bytes before the first chunk hold the fill value");
+    tap_ok(reasm_map_insert(&m, 20, a, 5, 1) == 5 && m.n_runs == 1,
+           "touching insert of the same quality merges into one run");
+    tap_ok(reasm_map_insert(&m, 15, b, 10, 1) == 0 && m.conflicts == 10
+           && m.bytes[15] == 'B' && m.bytes[24] == 'B',
+           "clean over clean: last wins, disagreeing bytes counted");
+    tap_ok(reasm_map_insert(&m, 0, c, 10, 0) == 10 && m.n_runs == 2,
+           "uncorrectable chunk fills a gap as its own run");
+    tap_ok(reasm_map_insert(&m, 5, b, 10, 0) == 0 && m.bytes[5] == 'C' && m.bytes[12] == 'A',
+           "uncorrectable chunk never clobbers present bytes");
+    long conflicts = m.conflicts;
+    tap_ok(reasm_map_insert(&m, 0, a, 3, 1) == 0 && m.bytes[0] == 'A' && m.conflicts == conflicts
+           && m.n_runs == 3,
+           "clean over uncorrectable replaces without a conflict and splits the run");
+    tap_okf(m.present == 25, "present count (%ld)", m.present);
+
+    long end = 0;
+    tap_ok(reasm_map_next_gap(&m, 0, &end) == -1, "no gap when [0, size) is all present");
+    uint8_t d[4] = {1, 2, 3, 4};
+    reasm_map_insert(&m, 40, d, 4, 1);
+    long g = reasm_map_next_gap(&m, 0, &end);
+    tap_okf(g == 25 && end == 40, "gap [25, 40) found (%ld, %ld)", g, end);
+    tap_ok(reasm_map_next_gap(&m, 30, &end) == 30 && end == 40, "gap query from inside a gap");
+    tap_ok(reasm_map_next_gap(&m, 40, &end) == -1, "no gap after the last run");
+    reasm_map_free(&m);
+    tap_ok(m.bytes == NULL && m.n_runs == 0 && m.min_off == -1, "free resets the map");
+}
+
+// ---- map vs byte-array oracle -------------------------------------------
+
+typedef struct {
+    long off, len;
+    int clean;
+    uint8_t data[64];
+} tchunk_t;
+
+static int check_random_map(int trial)
+{
+    int nchunks = 1 + (int) rnd(60);
+    long span = 32 + (long) rnd(400);
+    tchunk_t *cs = calloc((size_t) nchunks, sizeof *cs);
+    for (int k = 0; k < nchunks; ++k) {
+        cs[k].len = 1 + (long) rnd(64);
+        cs[k].off = (long) rnd((unsigned long) span);
+        cs[k].clean = rnd(4) != 0;
+        for (long q = 0; q < cs[k].len; ++q)
+            cs[k].data[q] = (uint8_t) rnd(3);   // few symbols => frequent agreement
+    }
+
+    // Oracle: the old two-phase byte-array reassembly.
+    long size = 0, min_off = -1;
+    for (int k = 0; k < nchunks; ++k) {
+        if (cs[k].off + cs[k].len > size) size = cs[k].off + cs[k].len;
+        if (min_off < 0 || cs[k].off < min_off) min_off = cs[k].off;
+    }
+    uint8_t *buf = malloc((size_t) size);
+    uint8_t *present = calloc((size_t) size, 1);
+    memset(buf, 0xEE, (size_t) size);
+    long conflicts = 0;
+    for (int phase = 0; phase < 2; ++phase)
+        for (int k = 0; k < nchunks; ++k) {
+            if ((phase == 0) != cs[k].clean) continue;
+            for (long q = 0; q < cs[k].len; ++q) {
+                long o = cs[k].off + q;
+                if (present[o]) {
+                    if (phase == 0 && buf[o] != cs[k].data[q]) conflicts++;
+                    if (phase == 1) continue;
+                }
+                buf[o] = cs[k].data[q];
+                present[o] = 1;
+            }
+        }
+    long n_present = 0;
+    for (long o = 0; o < size; ++o) n_present += present[o];
+
+    // Engine: chunks in arrival order, clean and uncorrectable interleaved.
+    reasm_map_t m;
+    reasm_map_init(&m, 0xEE);
+    long newly = 0;
+    for (int k = 0; k < nchunks; ++k)
+        newly += reasm_map_insert(&m, cs[k].off, cs[k].data, cs[k].len, cs[k].clean);
+
+    int ok = m.size == size && m.min_off == min_off && m.present == n_present
+          && newly == n_present && m.conflicts == conflicts
+          && memcmp(m.bytes, buf, (size_t) size) == 0;
+
+    // Runs stay sorted, disjoint and non-empty.
+    for (size_t r = 0; r < m.n_runs; ++r) {
+        if (m.runs[r].end <= m.runs[r].start) ok = 0;
+        if (r > 0 && m.runs[r].start < m.runs[r - 1].end) ok = 0;
+    }
+    // Gap list matches the present[] scan.
+    long from = 0, end = 0, g;
+    long o = 0;
+    while ((g = reasm_map_next_gap(&m, from, &end)) >= 0) {
+        for (; o < g; ++o) if (!present[o]) ok = 0;
+        for (; o < end; ++o) if (present[o]) ok = 0;
+        if (end < size && !present[end]) ok = 0;   // gap must be maximal
+        from = end;
+    }
+    for (; o < size; ++o) if (!present[o]) ok = 0;
+
+    if (!ok)
+        fprintf(stderr, "  trial %d: size %ld/%ld present %ld/%ld conflicts %ld/%ld\n",
+                trial, m.size, size, m.present, n_present, m.conflicts, conflicts);
+    reasm_map_free(&m);
+    free(buf);
+    free(present);
+    free(cs);
+    return ok;
+}
+
+static void test_map_oracle(void)
+{
+    fprintf(stderr, "reasm_map vs byte-array oracle:\n");
+    int bad = 0;
+    for (int t = 0; t < 2000; ++t)
+        if (!check_random_map(t)) bad++;
+    tap_okf(bad == 0, "2000 random overlapping chunk sets agree (%d mismatches)", bad);
+}
+
+// ---- sessions -------------------------------------------------------------
+
+// The old mpi_reconstruct loop: cluster marked chunks, then rescan every
+// chunk for the padded window.
+static long oracle_sessions(const double *ts, const unsigned char *mk, size_t n,
+                            double gap, double margin, reasm_session_t *out)
+{
+    long ns = 0;
+    size_t i = 0;
+    while (i < n) {
+        if (!mk[i]) { i++; continue; }
+        size_t last = i;
+        for (size_t k = i + 1; k < n; ++k) {
+            if (!mk[k]) continue;
+            if (ts[k] - ts[last] > gap) break;
+            last = k;
+        }
+        double wlo = ts[i] - margin, whi = ts[last] + margin;
+        size_t lo = n, hi = 0;
+        for (size_t k = 0; k < n; ++k) {
+            if (ts[k] < wlo || ts[k] > whi) continue;
+            if (lo == n) lo = k;
+            hi = k + 1;
+        }
+        out[ns].lo = lo;
+        out[ns].hi = hi;
+        out[ns].first_mark = i;
+        out[ns].last_mark = last;
+        ns++;
+        i = last + 1;
+    }
+    return ns;
+}
+
+static void test_sessions(void)
+{
+    fprintf(stderr, "reasm_sessions vs rescan oracle:\n");
+    const double gap = 900e3, margin = 120e3;
+    int bad = 0;
+    for (int t = 0; t < 500; ++t) {
+        size_t n = 1 + rnd(300);
+        double *ts = malloc(n * sizeof *ts);
+        unsigned char *mk = malloc(n);
+        double now = 1.7e12;
+        for (size_t k = 0; k < n; ++k) {
+            // Mostly seconds apart, sometimes a pass gap, sometimes a tie.
+            unsigned long r = rnd(20);
+            now += r == 0 ? 0.0 : r < 18 ? 1000.0 * (double) rnd(90) : 1e3 * (double) (600 + rnd(3000));
+            ts[k] = now;
+            mk[k] = rnd(3) == 0;
+        }
+        reasm_session_t *got = NULL;
+        reasm_session_t *want = malloc(n * sizeof *want);
+        long ng = reasm_sessions(ts, mk, n, gap, margin, &got);
+        long nw = oracle_sessions(ts, mk, n, gap, margin, want);
+        int ok = ng == nw;
+        for (long s = 0; ok && s < ng; ++s)
+            ok = got[s].lo == want[s].lo && got[s].hi == want[s].hi
+              && got[s].first_mark == want[s].first_mark && got[s].last_mark == want[s].last_mark;
+        if (!ok) bad++;
+        free(got);
+        free(want);
+        free(ts);
+        free(mk);
+    }
+    tap_okf(bad == 0, "500 random series segment identically (%d mismatches)", bad);
+
+    reasm_session_t *none = NULL;
+    double ts1[3] = {0.0, 1.0, 2.0};
+    unsigned char mk0[3] = {0, 0, 0};
+    tap_ok(reasm_sessions(ts1, mk0, 3, gap, margin, &none) == 0, "no marks, no sessions");
+    free(none);
+}
+
+int main(void)
+{
+    test_bulk_chunk();
+    test_map_basics();
+    test_map_oracle();
+    test_sessions();
+    return tap_done();
+}
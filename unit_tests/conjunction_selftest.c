@@ -23,6 +23,14 @@
       - conj_foster_pc: cross-checks the 3-D encounter-plane projection +
         diagonalisation against direct conj_foster_pc_principal calls for an
         isotropic covariance and an axis-aligned anisotropic one.
+      - conj_brent_root: cos(x) on [1, 2] against pi/2, the range rate of
+        straight-line and curved relative motion against the known TCA (with
+        an evaluation budget golden-section search could not meet), and the
+        non-bracketing / endpoint-root cases.
+      - conj_shells_overlap / conj_grid_pairs: the shell gate's above /
+        below / touching cases, and the spatial hash against a brute-force
+        O(N^2) pair search (same close pairs, none reported twice, cells
+        straddling the origin, grid reuse across calls).
 
     Copyright (C) 2026  Johnathan K Burchill
 
@@ -45,6 +53,8 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 // Independent 2-D oracle for the Foster principal integral: a midpoint grid
 // over the hard-body disk. Crude (O(h) on the circular boundary) but a wholly
@@ -285,11 +295,155 @@ static void test_pc_pipeline(void)
     tap_ok(conj_foster_pc(r_rel, vz, cov_iso, R) == 0.0, "zero relative velocity -> Pc=0");
 }
 
+// Pair collector for the grid test: counts pairs closer than `r` and flags
+// any pair reported twice or out of order.
+// Evaluation-counting wrappers for the Brent tests.
+typedef struct {
+    int    evals;
+    double t0, miss, speed, curv;   // relative-motion model (see test_brent)
+} brent_ctx_t;
+
+static double brent_cos(double x, void *vctx)
+{
+    ((brent_ctx_t *) vctx)->evals++;
+    return cos(x);
+}
+
+// Range rate r . v of a relative trajectory passing its closest point at t0:
+// straight along x at `speed`, miss distance along z, and a curvature term
+// bending the path in y (curv = 0 is straight-line motion).
+static double brent_range_rate(double t, void *vctx)
+{
+    brent_ctx_t *c = vctx;
+    c->evals++;
+    double u = t - c->t0;
+    double r[3] = { c->speed * u, c->curv * u * u, c->miss };
+    double v[3] = { c->speed, 2.0 * c->curv * u, 0.0 };
+    return r[0] * v[0] + r[1] * v[1] + r[2] * v[2];
+}
+
+static void test_brent(void)
+{
+    fprintf(stderr, "conj_brent_root:\n");
+    brent_ctx_t c = {0};
+    double x = conj_brent_root(brent_cos, &c, 1.0, 2.0, cos(1.0), cos(2.0), 1e-12, 100);
+    tap_okf(fabs(x - M_PI / 2.0) < 1e-12, "cos root at pi/2 (err %.2e)", x - M_PI / 2.0);
+
+    // Straight-line encounter, 10 s bracket: the range rate is linear, so
+    // the secant step lands on TCA at once.
+    c = (brent_ctx_t) { 0, 3.7, 0.4, 14.0, 0.0 };
+    double fa = brent_range_rate(-5.0 + 3.7, &c), fb = brent_range_rate(5.0 + 3.7, &c);
+    c.evals = 0;
+    x = conj_brent_root(brent_range_rate, &c, -5.0 + 3.7, 5.0 + 3.7, fa, fb, 1e-4, 100);
+    tap_okf(fabs(x - 3.7) < 1e-4 && c.evals <= 3,
+            "straight-line TCA (err %.2e s, %d evals)", x - 3.7, c.evals);
+
+    // Curved relative path over a 20 s bracket to 0.1 ms: golden-section
+    // needs ~26 evaluations for the same bracket and tolerance.
+    c = (brent_ctx_t) { 0, 1.25, 0.05, 7.5, 0.02 };
+    fa = brent_range_rate(-8.0, &c);
+    fb = brent_range_rate(12.0, &c);
+    c.evals = 0;
+    x = conj_brent_root(brent_range_rate, &c, -8.0, 12.0, fa, fb, 1e-4, 100);
+    tap_okf(fabs(x - 1.25) < 1e-4 && c.evals <= 12,
+            "curved TCA (err %.2e s, %d evals)", x - 1.25, c.evals);
+
+    tap_ok(isnan(conj_brent_root(brent_cos, &c, 0.0, 1.0, 1.0, cos(1.0), 1e-9, 100)),
+           "same-sign endpoints return NAN");
+    tap_ok(conj_brent_root(brent_cos, &c, 2.0, 3.0, 0.0, -1.0, 1e-9, 100) == 2.0,
+           "root at an endpoint returned as is");
+}
+
+typedef struct {
+    const float   *xyz;
+    size_t         n;
+    double         r;
+    unsigned char *seen;     // n*n
+    int            close, dup, bad_order;
+} grid_ctx_t;
+
+static void grid_collect(size_t i, size_t j, void *vctx)
+{
+    grid_ctx_t *c = vctx;
+    if (i >= j) { c->bad_order++; return; }
+    if (c->seen[i * c->n + j]++) c->dup++;
+    double dx = c->xyz[3 * i] - c->xyz[3 * j];
+    double dy = c->xyz[3 * i + 1] - c->xyz[3 * j + 1];
+    double dz = c->xyz[3 * i + 2] - c->xyz[3 * j + 2];
+    if (sqrt(dx * dx + dy * dy + dz * dz) < c->r) c->close++;
+}
+
+static void test_screening(void)
+{
+    fprintf(stderr, "screening (shells + spatial hash):\n");
+    tap_ok(conj_shells_overlap(6800, 6900, 6700, 6790, 5.0) == 0,
+           "shells: object 2 wholly below by more than pad -> no overlap");
+    tap_ok(conj_shells_overlap(6800, 6900, 6700, 6796, 5.0) == 1,
+           "shells: gap within pad -> overlap");
+    tap_ok(conj_shells_overlap(6700, 6710, 6800, 42000, 5.0) == 0,
+           "shells: object 1 wholly below -> no overlap");
+    tap_ok(conj_shells_overlap(6700, 7000, 6800, 6850, 0.0) == 1,
+           "shells: nested ranges overlap");
+
+    // Deterministic pseudo-random cloud spanning the origin on every axis,
+    // dense enough that many cells hold several points.
+    const size_t n = 1500;
+    const double r = 400.0;
+    float *xyz = malloc(3 * n * sizeof *xyz);
+    unsigned char *seen = calloc(n * n, 1);
+    conj_grid_t *g = conj_grid_new(n);
+    if (!xyz || !seen || !g) {
+        tap_bail("oom");
+        free(xyz); free(seen); conj_grid_free(g);
+        return;
+    }
+    unsigned s = 12345u;
+    for (size_t i = 0; i < 3 * n; ++i) {
+        s = s * 1103515245u + 12345u;
+        xyz[i] = (float) ((double) (s >> 8) / (double) (1u << 24) * 8000.0 - 4000.0);
+    }
+    int brute = 0;
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = i + 1; j < n; ++j) {
+            double dx = xyz[3 * i] - xyz[3 * j];
+            double dy = xyz[3 * i + 1] - xyz[3 * j + 1];
+            double dz = xyz[3 * i + 2] - xyz[3 * j + 2];
+            if (sqrt(dx * dx + dy * dy + dz * dz) < r) brute++;
+        }
+
+    for (int pass = 0; pass < 2; ++pass) {
+        grid_ctx_t c = { xyz, n, r, seen, 0, 0, 0 };
+        memset(seen, 0, n * n);
+        int rc = conj_grid_pairs(g, xyz, n, r, grid_collect, &c);
+        tap_okf(rc == 0 && c.close == brute && c.dup == 0 && c.bad_order == 0,
+                "grid pass %d: %d close pairs == brute force %d, "
+                "%d duplicates, %d misordered", pass + 1, c.close, brute,
+                c.dup, c.bad_order);
+        // Second pass reuses the grid on a shifted cloud.
+        for (size_t i = 0; i < 3 * n; ++i) xyz[i] += 137.0f;
+        brute = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = i + 1; j < n; ++j) {
+                double dx = xyz[3 * i] - xyz[3 * j];
+                double dy = xyz[3 * i + 1] - xyz[3 * j + 1];
+                double dz = xyz[3 * i + 2] - xyz[3 * j + 2];
+                if (sqrt(dx * dx + dy * dy + dz * dz) < r) brute++;
+            }
+    }
+    tap_ok(conj_grid_pairs(g, xyz, n + 1, r, grid_collect, NULL) == -1,
+           "grid: more points than capacity is rejected");
+    free(xyz);
+    free(seen);
+    conj_grid_free(g);
+}
+
 int main(void)
 {
     test_rtn();
     test_cov();
     test_pc_principal();
     test_pc_pipeline();
+    test_brent();
+    test_screening();
     return tap_done();
 }
@@ -0,0 +1,217 @@
+/*
+
+    Simple Satellite Operations  unit_tests/decay_selftest.c
+
+    Tests for src/orbit/decay.c -- the adaptive-step engine behind the
+    lifetime tool. The oracle is the tool's old method written out
+    independently: scalar SGP4 every minute until the geodetic altitude
+    first drops to 100 km.
+
+      - Re-entry: for fast-decaying low orbits (circular and slightly
+        eccentric, low and high inclination) the engine lands on the same
+        minute as the brute-force walk, and its series ends on the crossing.
+      - Survival: an orbit that outlives max_years reports exactly
+        max_years, not re-entered, with a decimated series whose steps
+        never exceed DECAY_MAX_STEP_DAYS, for a small fraction of the
+        brute-force propagation count.
+      - Deep space: an SDP4 (HEO) object runs without tripping the
+        threshold and leaves finite altitudes in the series.
+      - Bad options are refused.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "decay.h"
+#include "tap.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Synthetic element sets. DECAY-A..C sit at ~180-280 km with a heavy B*, so
+// they come down within weeks and the minute-by-minute oracle stays cheap.
+// DECAY-D is a ~840 km sun-synchronous orbit that survives the window.
+static const char *const DECAY_A[2] = {
+    "1 00003U 26100A   26290.50000000  .00301000  00000-0  10000-2 0  9993",
+    "2 00003  79.5633 309.6879 0051582 183.2643 133.9417 16.11533482    11",
+};
+static const char *const DECAY_B[2] = {
+    "1 00005U 26100A   26290.50000000  .00301000  00000-0  10000-2 0  9995",
+    "2 00005  41.9375 318.2632 0049810  59.2158  63.8771 16.05923256    15",
+};
+static const char *const DECAY_C[2] = {
+    "1 00001U 26100A   26290.50000000  .00301000  00000-0  10000-2 0  9991",
+    "2 00001   9.0669 129.9807 0007413  60.8701 291.2263 16.37801714    10",
+};
+static const char *const DECAY_D[2] = {
+    "1 90007U 26100A   26290.50000000  .00010000  00000-0  10000-3 0  9994",
+    "2 90007  98.0000 188.3452 0010000 266.8507 241.7081 14.20000000    12",
+};
+// AO-40, a real HEO element set: SDP4.
+static const char *const DECAY_HEO[2] = {
+    "1 26609U 00072B   01098.10193978 -.00000077  00000-0  00000+0 0   623",
+    "2 26609   5.2776 206.5794 8139221 247.7100  15.0295  1.26974654  2011",
+};
+
+// Convert a two-card set and prepare a propagation context for it. The
+// converted elements go to *tle for the scalar oracle.
+static void load_ctx(const char *const cards[2], tle_t *tle, sgp4_ctx_t *ctx)
+{
+    char set[139] = {0};
+    memcpy(set, cards[0], 69);
+    memcpy(set + 69, cards[1], 69);
+    Convert_Satellite_Data(set, tle);
+    ClearFlag(ALL_FLAGS);
+    select_ephemeris(tle);
+    sgp4_ctx_init(ctx, tle, isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0);
+}
+
+// Brute-force oracle: scalar SGP4 at jul_start + k minutes, returning the
+// first k whose geodetic altitude is at or below min_alt_km, or -1 by
+// k_max. tle must be near-earth and fresh from select_ephemeris.
+static long brute_force_minutes(tle_t *tle, double jul_start, double min_alt_km, long k_max)
+{
+    double epoch = Julian_Date_of_Epoch(tle->epoch);
+    ClearFlag(ALL_FLAGS);
+    for (long k = 0; k <= k_max; ++k) {
+        double jul = jul_start + (double) k / 1440.0;
+        vector_t pos, vel;
+        geodetic_t geo;
+        SGP4((jul - epoch) * 1440.0, tle, &pos, &vel);
+        Convert_Sat_State(&pos, &vel);
+        Calculate_LatLonAlt(jul, &pos, &geo);
+        if (!(geo.alt > min_alt_km)) return k;
+    }
+    return -1;
+}
+
+// ------------------------------------------------------------------ re-entry
+
+static void check_reentry(const char *label, const char *const cards[2])
+{
+    tle_t tle;
+    sgp4_ctx_t ctx;
+    load_ctx(cards, &tle, &ctx);
+    double jul_start = ctx.epoch_jul + 0.25;
+
+    decay_opts_t opts = { .max_years = 1.0, .min_alt_km = 100.0, .scan_step_min = 1.0 };
+    decay_result_t res;
+    int rc = decay_lifetime(&ctx, jul_start, &opts, &res);
+    long k_ref = brute_force_minutes(&tle, jul_start, 100.0, 366L * 1440L);
+    double years_ref = (double) k_ref / 1440.0 / 365.25;
+
+    tap_okf(rc == 0 && res.reentered && k_ref > 0,
+            "%s: re-enters within a year (engine %d, oracle minute %ld)", label, res.reentered, k_ref);
+    tap_okf(fabs(res.years - years_ref) * 365.25 * 1440.0 < 0.5,
+            "%s: same minute as the brute-force walk (%.3f vs %.3f days)",
+            label, res.years * 365.25, years_ref * 365.25);
+    tap_okf(res.n_samples >= 2 && res.samples[res.n_samples - 1].years == res.years
+            && !(res.samples[res.n_samples - 1].alt_min_km > 100.0),
+            "%s: series ends on the crossing (%zu points)", label, res.n_samples);
+    decay_result_free(&res);
+}
+
+static void test_reentry(void)
+{
+    fprintf(stderr, "decay_lifetime re-entry vs brute force:\n");
+    check_reentry("high-inclination, e=0.005", DECAY_A);
+    check_reentry("mid-inclination, e=0.005", DECAY_B);
+    check_reentry("low-inclination, near-circular", DECAY_C);
+}
+
+// ------------------------------------------------------------------ survival
+
+static void test_survival(void)
+{
+    fprintf(stderr, "decay_lifetime survival:\n");
+    tle_t tle;
+    sgp4_ctx_t ctx;
+    load_ctx(DECAY_D, &tle, &ctx);
+
+    decay_opts_t opts = { .max_years = 3.0, .min_alt_km = 100.0, .scan_step_min = 1.0 };
+    decay_result_t res;
+    int rc = decay_lifetime(&ctx, ctx.epoch_jul, &opts, &res);
+    tap_okf(rc == 0 && !res.reentered && res.years == 3.0,
+            "survives: years == max_years, not re-entered (%.6f, %d)", res.years, res.reentered);
+
+    int steps_ok = res.n_samples >= 2;
+    for (size_t i = 1; i < res.n_samples; ++i) {
+        double dt = (res.samples[i].years - res.samples[i - 1].years) * 365.25;
+        if (!(dt > 0.0) || dt > DECAY_MAX_STEP_DAYS + 1e-9) steps_ok = 0;
+    }
+    tap_okf(steps_ok, "steps increase and stay within %.0f days (%zu points)",
+            DECAY_MAX_STEP_DAYS, res.n_samples);
+    tap_okf(res.samples[res.n_samples - 1].years * 365.25 > 3.0 * 365.25 - 1e-6,
+            "series reaches the end of the window");
+    tap_okf(res.evaluations < 3.0 * 365.25 * 1440.0 / 20.0,
+            "decimated: %ld propagations for %.0f minutes", res.evaluations, 3.0 * 365.25 * 1440.0);
+    tap_okf(res.samples[0].alt_min_km > 650.0 && res.samples[0].alt_max_km < 850.0
+            && res.samples[0].alt_min_km <= res.samples[0].alt_mean_km
+            && res.samples[0].alt_mean_km <= res.samples[0].alt_max_km,
+            "first revolution: %.1f <= %.1f <= %.1f km", res.samples[0].alt_min_km,
+            res.samples[0].alt_mean_km, res.samples[0].alt_max_km);
+    decay_result_free(&res);
+}
+
+// ------------------------------------------------------------------ deep space
+
+static void test_deep_space(void)
+{
+    fprintf(stderr, "decay_lifetime deep space:\n");
+    tle_t tle;
+    sgp4_ctx_t ctx;
+    load_ctx(DECAY_HEO, &tle, &ctx);
+    tap_ok(ctx.deep_space, "AO-40 goes through SDP4");
+
+    decay_opts_t opts = { .max_years = 0.2, .min_alt_km = 100.0, .scan_step_min = 1.0 };
+    decay_result_t res;
+    int rc = decay_lifetime(&ctx, ctx.epoch_jul, &opts, &res);
+    int finite = res.n_samples > 0;
+    for (size_t i = 0; i < res.n_samples; ++i)
+        if (!isfinite(res.samples[i].alt_min_km) || !isfinite(res.samples[i].alt_max_km)) finite = 0;
+    tap_okf(rc == 0 && !res.reentered && fabs(res.years - 0.2) < 1e-12,
+            "HEO survives the window (%.3f years)", res.years);
+    tap_okf(finite && res.samples[0].alt_max_km > 30000.0,
+            "finite altitudes, apogee %.0f km", res.n_samples ? res.samples[0].alt_max_km : 0.0);
+    decay_result_free(&res);
+}
+
+// ------------------------------------------------------------------ options
+
+static void test_bad_options(void)
+{
+    fprintf(stderr, "decay_lifetime options:\n");
+    tle_t tle;
+    sgp4_ctx_t ctx;
+    load_ctx(DECAY_D, &tle, &ctx);
+    decay_result_t res;
+    decay_opts_t no_window = { .max_years = 0.0, .min_alt_km = 100.0, .scan_step_min = 1.0 };
+    decay_opts_t no_step = { .max_years = 1.0, .min_alt_km = 100.0, .scan_step_min = 0.0 };
+    tap_ok(decay_lifetime(&ctx, ctx.epoch_jul, &no_window, &res) == -1 && res.samples == NULL,
+           "max_years <= 0 refused");
+    tap_ok(decay_lifetime(&ctx, ctx.epoch_jul, &no_step, &res) == -1 && res.samples == NULL,
+           "scan_step_min <= 0 refused");
+}
+
+int main(void)
+{
+    test_reentry();
+    test_survival();
+    test_deep_space();
+    test_bad_options();
+    return tap_done();
+}
@@ -18,6 +18,8 @@
       - Carrier suddenly appearing: bright_bins jumps then settles as
         the floor catches up — slow alpha_up means the rise is gradual.
       - frame_count increments by floor(n_pushed / n_fft).
+      - take_peak_bins reports a burst frame buried mid-push, then
+        starts over.
       - Free survives NULL.
 
     Exit status: 0 = all tests passed, non-zero = failure.
@@ -258,6 +260,38 @@ static void test_frame_count_partial_pushes(void)
     free(iq); iq_burst_free(b);
 }
 
+// ------------------------------------------------------------------
+// 7. take_peak_bins: a burst frame in the middle of one long push is
+//    reported even though the push ends quiet; the next take is low.
+// ------------------------------------------------------------------
+
+static void test_take_peak_bins(void)
+{
+    iq_burst_t *b = iq_burst_new(N_FFT, FS, 10.0, 2.0);
+    if (!b) { tap_bail("ctor"); return; }
+    int16_t *iq = (int16_t *) malloc(N_FFT * 2 * 3 * sizeof(int16_t));
+    if (!iq) { tap_bail("oom"); iq_burst_free(b); return; }
+    xs = 0xfeedf00du;
+    for (int frame = 0; frame < 200; ++frame) {
+        fill_noise(iq, N_FFT, 400.0);
+        iq_burst_push(b, iq, N_FFT);
+    }
+    (void) iq_burst_take_peak_bins(b);
+    // quiet | LOUD | quiet in a single push.
+    fill_noise(iq, N_FFT, 400.0);
+    fill_noise(iq + N_FFT * 2, N_FFT, 12000.0);
+    fill_noise(iq + N_FFT * 4, N_FFT, 400.0);
+    iq_burst_push(b, iq, N_FFT * 3);
+    int last = iq_burst_bright_bins(b);
+    int peak = iq_burst_take_peak_bins(b);
+    tap_okf(peak >= (int)(N_FFT / 4) && last < peak / 4,
+            "take_peak: mid-push burst reported (peak=%d, last=%d)", peak, last);
+    fill_noise(iq, N_FFT, 400.0);
+    iq_burst_push(b, iq, N_FFT);
+    tap_okf(iq_burst_take_peak_bins(b) < peak / 4, "take_peak: starts over after a take");
+    free(iq); iq_burst_free(b);
+}
+
 int main(void)
 {
     test_ctor_validation();
@@ -266,5 +300,6 @@ int main(void)
     test_wideband_burst_lights_many_bins();
     test_post_burst_recovery();
     test_frame_count_partial_pushes();
+    test_take_peak_bins();
     return tap_done();
 }
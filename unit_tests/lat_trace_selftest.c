@@ -0,0 +1,214 @@
+/*
+
+    Simple Satellite Operations  unit_tests/lat_trace_selftest.c
+
+    Tests for src/pipeline/lat_trace.c -- per-thread mark rings folded
+    into per-stage log-linear latency histograms.
+
+      - Percentiles: a known uniform spread of latencies comes back with
+        p50 / p90 / p99 inside the bucket width, exact min and max, and
+        the true mean.
+      - Untraced: marks with a zero origin are ignored.
+      - Threads: marks from several producer threads (each with its own
+        ring) all land, including after a thread exits and its ring is
+        adopted by the next one.
+      - Overflow: a ring filled without collecting drops the excess and
+        counts it.
+      - Output: the ":stats latency" row names every stage, and the
+        report file has the table and the histogram rows.
+      - Reset: clears counts and the dropped tally.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "lat_trace.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int near(double got, double want, double rel)
+{
+    return fabs(got - want) <= rel * want;
+}
+
+// n marks spread evenly over [lo_ms, hi_ms], collected every 1000 so
+// the ring never fills.
+static void mark_uniform(lat_stage_t stage, int n, double lo_ms, double hi_ms)
+{
+    const uint64_t t0 = 1000000000ull;
+    for (int i = 0; i < n; i++) {
+        double ms = lo_ms + (hi_ms - lo_ms) * (double)i / (double)(n - 1);
+        lat_trace_mark_at(stage, t0, t0 + (uint64_t)llround(ms * 1e6));
+        if (i % 1000 == 999) lat_trace_collect();
+    }
+    lat_trace_collect();
+}
+
+static void test_percentiles(void)
+{
+    fprintf(stderr, "percentiles:\n");
+    lat_trace_reset();
+    mark_uniform(LAT_DEMOD, 10000, 1.0, 1001.0);
+    lat_summary_t s;
+    lat_trace_summary(LAT_DEMOD, &s);
+    tap_okf(s.count == 10000, "count (%llu)", (unsigned long long)s.count);
+    tap_okf(near(s.p50_ms, 501.0, 0.035), "p50 within a bucket (%.2f ms)", s.p50_ms);
+    tap_okf(near(s.p90_ms, 901.0, 0.035), "p90 within a bucket (%.2f ms)", s.p90_ms);
+    tap_okf(near(s.p99_ms, 991.0, 0.035), "p99 within a bucket (%.2f ms)", s.p99_ms);
+    tap_okf(s.p999_ms <= s.max_ms && s.p99_ms <= s.p999_ms, "p99 <= p99.9 <= max");
+    tap_okf(fabs(s.min_ms - 1.0) < 1e-6 && fabs(s.max_ms - 1001.0) < 1e-6,
+            "exact min / max (%.3f / %.3f)", s.min_ms, s.max_ms);
+    tap_okf(fabs(s.mean_ms - 501.0) < 1e-3, "exact mean (%.4f)", s.mean_ms);
+
+    lat_trace_summary(LAT_RS, &s);
+    tap_ok(s.count == 0 && s.p50_ms == 0.0, "untouched stage is empty");
+}
+
+static void test_untraced(void)
+{
+    fprintf(stderr, "untraced:\n");
+    lat_trace_reset();
+    lat_trace_mark(LAT_WINDOW, 0);
+    lat_trace_mark_at(LAT_WINDOW, 0, 12345);
+    lat_trace_set_origin(0);
+    lat_trace_mark(LAT_WINDOW, lat_trace_origin());
+    lat_summary_t s;
+    lat_trace_summary(LAT_WINDOW, &s);
+    tap_ok(s.count == 0, "zero origin ignored");
+
+    lat_trace_set_origin(lat_now_ns());
+    tap_ok(lat_trace_origin() != 0, "origin is per call chain");
+    lat_trace_mark(LAT_WINDOW, lat_trace_origin());
+    lat_trace_set_origin(0);
+    lat_trace_summary(LAT_WINDOW, &s);
+    tap_ok(s.count == 1 && s.max_ms < 1000.0, "live mark recorded");
+}
+
+#define N_THREADS 4
+#define N_PER     1500
+
+static void *producer(void *arg)
+{
+    int stage = (int)(intptr_t)arg;
+    const uint64_t t0 = 5000000000ull;
+    for (int i = 0; i < N_PER; i++) {
+        lat_trace_mark_at((lat_stage_t)stage, t0, t0 + 1000000ull);
+        if (i % 500 == 499) usleep(1000);  // let the collector keep up
+    }
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    fprintf(stderr, "threads:\n");
+    lat_trace_reset();
+    for (int round = 0; round < 2; round++) {
+        pthread_t th[N_THREADS];
+        for (int i = 0; i < N_THREADS; i++)
+            pthread_create(&th[i], NULL, producer, (void *)(intptr_t)(LAT_DB + i % 3));
+        for (int k = 0; k < 20; k++) {
+            lat_trace_collect();
+            usleep(500);
+        }
+        for (int i = 0; i < N_THREADS; i++) pthread_join(th[i], NULL);
+    }
+    lat_trace_collect();
+    uint64_t total = 0;
+    for (int s = LAT_DB; s <= LAT_IPC; s++) {
+        lat_summary_t sum;
+        lat_trace_summary((lat_stage_t)s, &sum);
+        total += sum.count;
+    }
+    uint64_t dropped = lat_trace_dropped();
+    tap_okf(total + dropped == 2ull * N_THREADS * N_PER,
+            "every mark landed or was counted (%llu + %llu dropped)",
+            (unsigned long long)total, (unsigned long long)dropped);
+    lat_summary_t db;
+    lat_trace_summary(LAT_DB, &db);
+    tap_okf(db.count > 0 && near(db.p50_ms, 1.0, 0.035), "DB stage p50 ~1 ms (%.3f)", db.p50_ms);
+}
+
+static void test_overflow(void)
+{
+    fprintf(stderr, "overflow:\n");
+    lat_trace_reset();
+    const uint64_t t0 = 1000;
+    for (int i = 0; i < 5000; i++) lat_trace_mark_at(LAT_PANEL, t0, t0 + 2000000);
+    lat_summary_t s;
+    lat_trace_summary(LAT_PANEL, &s);
+    uint64_t dropped = lat_trace_dropped();
+    tap_okf(s.count + dropped == 5000 && dropped > 0,
+            "full ring drops and counts (%llu kept, %llu dropped)",
+            (unsigned long long)s.count, (unsigned long long)dropped);
+    lat_trace_reset();
+    lat_trace_summary(LAT_PANEL, &s);
+    tap_ok(s.count == 0 && lat_trace_dropped() == 0, "reset clears counts and drops");
+}
+
+static void test_output(void)
+{
+    fprintf(stderr, "output:\n");
+    lat_trace_reset();
+    char row[160];
+    lat_trace_format_status(row, sizeof row);
+    tap_okf(strstr(row, "no frames") != NULL, "empty status row (%s)", row);
+
+    for (int s = 0; s < LAT_IPC; s++) mark_uniform((lat_stage_t)s, 200, 5.0 * (s + 1), 50.0 * (s + 1));
+    lat_trace_format_status(row, sizeof row);
+    int all = 1;
+    for (int s = 0; s < LAT_STAGE__COUNT; s++)
+        if (strstr(row, lat_stage_name((lat_stage_t)s)) == NULL) all = 0;
+    tap_okf(all && strstr(row, "ipc -") != NULL && strlen(row) < sizeof row - 1,
+            "status row names every stage and fits (%s)", row);
+
+    const char *path = tap_tmpdir_path("latency.txt");
+    tap_ok(lat_trace_write_report(path, "TEST-SAT 2026-10-18T12:00:00Z") == 0, "report written");
+    FILE *f = fopen(path, "r");
+    int header = 0, table = 0, hist = 0;
+    char line[256];
+    while (f != NULL && fgets(line, sizeof line, f) != NULL) {
+        if (strstr(line, "TEST-SAT") != NULL) header = 1;
+        if (strncmp(line, "window ", 7) == 0) table = 1;
+        if (strncmp(line, "panel,", 6) == 0) hist++;
+    }
+    if (f != NULL) fclose(f);
+    tap_ok(header && table, "report has title and summary table");
+    tap_okf(hist > 5, "report has histogram rows (%d for panel)", hist);
+    tap_ok(lat_trace_write_report(tap_tmpdir_path("no/such/dir.txt"), NULL) == -1,
+           "unwritable path fails");
+}
+
+int main(void)
+{
+    if (tap_tmpdir_make("sso_lat") != 0) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    test_percentiles();
+    test_untraced();
+    test_threads();
+    test_overflow();
+    test_output();
+
+    tap_tmpdir_remove();
+    return tap_done();
+}
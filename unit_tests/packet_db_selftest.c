@@ -10,7 +10,7 @@
 
     What's covered:
       - packet_db_open on a fresh file creates schema and reaches
-        user_version = 4 (current latest after V1→V2→V3→V4 migrations).
+        user_version = 8 (current latest after V1→…→V8 migrations).
       - re-open on the same file is idempotent (re-runs migrations
         without error).
       - open rejects NULL / "" paths.
@@ -39,6 +39,19 @@
         and a concurrent commit by another connection, a batch flush still
         wins the write lock instead of failing with an immediate SQLITE_BUSY
         (the true root cause of the issue #52 parallel-decode loss).
+      - packet_db_fts_match turns a LIKE pattern into trigram phrases
+        (runs of 3+ chars between wildcards, quotes doubled, optional
+        column filter) and reports 0 when nothing is indexable.
+      - the V5 full-text index follows inserts and observer backfills,
+        and the migration backfills rows written before it existed.
+      - V8 replaces the V5 FTS update trigger with the change-only one,
+        both on a fresh open and on a DB last written at V7.
+      - packet_db_update_observer_many applies a batch in one
+        transaction with the same per-payload folding as repeated
+        single-row calls (gaps: first value wins; force / replay ts: last).
+      - the V6 resp_ts_sent_ms column is filled for tcmd_response rows
+        only, backs an index seek, and is backfilled on a pre-V6 DB;
+        the V7 trigger fills it for an INSERT that doesn't name it.
 
     Exit status: 0 = all tests passed, non-zero = failure.
 
@@ -57,6 +70,7 @@
 
 #include "packet_db.h"
 #include "tap.h"
+#include "tcmd_response.h"
 
 #include <ctype.h>
 #include <math.h>
@@ -181,7 +195,7 @@ static void test_open_fresh_creates_schema(void)
             "schema: V4 unique index exists (got count=%ld)", n_origin_idx);
 
     int uv = read_user_version(raw);
-    tap_okf(uv == 4, "user_version reached V4 after open (got %d)", uv);
+    tap_okf(uv == 8, "user_version reached V8 after open (got %d)", uv);
     sqlite3_close(raw);
     unlink(path);
 }
@@ -207,7 +221,7 @@ static void test_open_idempotent(void)
     sqlite3 *raw = NULL;
     sqlite3_open_v2(path, &raw, SQLITE_OPEN_READONLY, NULL);
     int uv = read_user_version(raw);
-    tap_okf(uv == 4, "re-open: user_version still 4 (got %d)", uv);
+    tap_okf(uv == 8, "re-open: user_version still 8 (got %d)", uv);
     sqlite3_close(raw);
     unlink(path);
 }
@@ -982,6 +996,490 @@ static void test_register_tle_no_snapshot_leak(void)
     snapshot_leak_case(1, "already-exists");
 }
 
+// ------------------------------------------------------------------
+// Full-text search: the MATCH-expression builder and the V5 index.
+// ------------------------------------------------------------------
+
+static void test_fts_match_expr(void)
+{
+    char out[256];
+    int n = packet_db_fts_match("%SAFETY%", NULL, out, sizeof out);
+    tap_okf(n == 1 && strcmp(out, "\"SAFETY\"") == 0,
+            "fts_match: %%SAFETY%% -> one phrase (got %d, '%s')", n, out);
+
+    n = packet_db_fts_match("%fs_boomcam%", "decoded_summary session_dir",
+                            out, sizeof out);
+    tap_okf(n == 1
+            && strcmp(out, "{decoded_summary session_dir} : \"boomcam\"") == 0,
+            "fts_match: '_' splits runs, short run skipped, column filter "
+            "applied (got %d, '%s')", n, out);
+
+    n = packet_db_fts_match("%2026-05-08%eps_mode=SAFE%", NULL, out, sizeof out);
+    tap_okf(n == 3
+            && strcmp(out, "\"2026-05-08\" AND \"eps\" AND \"mode=SAFE\"") == 0,
+            "fts_match: runs ANDed (got %d, '%s')", n, out);
+
+    n = packet_db_fts_match("%say \"hi\" ok%", NULL, out, sizeof out);
+    tap_okf(n == 1 && strcmp(out, "\"say \"\"hi\"\" ok\"") == 0,
+            "fts_match: embedded quotes doubled (got %d, '%s')", n, out);
+
+    n = packet_db_fts_match("%ab%", NULL, out, sizeof out);
+    tap_okf(n == 0, "fts_match: nothing 3+ chars long -> 0 (got %d)", n);
+
+    // Three 2-byte UTF-8 characters are one trigram, not six bytes' worth.
+    n = packet_db_fts_match("%\xc3\xa9\xc3\xa9\xc3\xa9%", NULL, out, sizeof out);
+    tap_okf(n == 1, "fts_match: counts UTF-8 characters (got %d)", n);
+    n = packet_db_fts_match("%\xc3\xa9\xc3\xa9%", NULL, out, sizeof out);
+    tap_okf(n == 0, "fts_match: two UTF-8 characters -> 0 (got %d)", n);
+
+    n = packet_db_fts_match("%SAFETY%", NULL, out, 6);
+    tap_okf(n == -1, "fts_match: too-small buffer -> -1 (got %d)", n);
+}
+
+static long fts_hits(sqlite3 *raw, const char *like_pattern, const char *cols)
+{
+    char expr[256];
+    if (packet_db_fts_match(like_pattern, cols, expr, sizeof expr) <= 0)
+        return -1;
+    sqlite3_stmt *s = NULL;
+    if (sqlite3_prepare_v2(raw,
+            "SELECT count(*) FROM " PACKET_DB_FTS_TABLE
+            " WHERE " PACKET_DB_FTS_TABLE " MATCH ?1", -1, &s, NULL)
+        != SQLITE_OK) return -1;
+    sqlite3_bind_text(s, 1, expr, -1, SQLITE_TRANSIENT);
+    long n = -1;
+    if (sqlite3_step(s) == SQLITE_ROW) n = (long) sqlite3_column_int64(s, 0);
+    sqlite3_finalize(s);
+    return n;
+}
+
+// The V8 update trigger is the one with a WHEN clause.
+#define FTS_AU_CHANGE_ONLY \
+    "SELECT 1 FROM sqlite_master WHERE type='trigger' " \
+    "AND name='packet_fts_au' AND sql LIKE '% WHEN old.%'"
+
+static void test_fts_index(void)
+{
+    char path[64];
+    if (make_tmp_db_path(path, sizeof path) != 0) {
+        tap_bail("mkstemp"); return;
+    }
+    packet_db_t *db = packet_db_open(path);
+    if (!db) { tap_bail("open"); return; }
+
+    uint8_t p1[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+    uint8_t p2[8] = {2, 2, 2, 2, 2, 2, 2, 2};
+    packet_db_record_t r1 = make_record(p1, sizeof p1, "selftest");
+    r1.decoded_summary = "beacon eps_mode=SAFETY batt=7.1V";
+    packet_db_record_t r2 = make_record(p2, sizeof p2, "selftest");
+    r2.decoded_summary = "beacon eps_mode=NOMINAL";
+    packet_db_insert(db, &r1);
+    packet_db_insert(db, &r2);
+
+    sqlite3 *raw = NULL;
+    sqlite3_open_v2(path, &raw, SQLITE_OPEN_READWRITE, NULL);
+    long n = fts_hits(raw, "%safety%", NULL);
+    tap_okf(n == 1, "fts: insert trigger indexes decoded_summary, "
+            "case-folded like LIKE (got %ld)", n);
+    n = fts_hits(raw, "%eps_mode=%", NULL);
+    tap_okf(n == 2, "fts: mid-word substring hits both rows (got %ld)", n);
+    n = fts_hits(raw, "%2026-05-18T19%", NULL);
+    tap_okf(n == 2, "fts: ts_received is searchable (got %ld)", n);
+
+    // An observer backfill rewrites session_dir; the update trigger must
+    // move the row's index entry with it.
+    packet_db_update_observer(db, p1, sizeof p1, NAN, NAN, NAN, NAN, NAN,
+                              0, "/archive/satnogs/14391496", 1);
+    n = fts_hits(raw, "%14391496%", "decoded_summary session_dir");
+    tap_okf(n == 1, "fts: update trigger reindexes session_dir (got %ld)", n);
+    n = fts_hits(raw, "%/tmp/test%", "session_dir");
+    tap_okf(n == 1, "fts: only the untouched row still matches the old "
+            "session_dir (got %ld)", n);
+    packet_db_close(db);
+
+    // A DB written before V5: drop the index + triggers and rewind the
+    // version, as if a pre-V5 build had written every row. Re-opening
+    // must rebuild the index over the existing rows.
+    sqlite3_exec(raw,
+        "DROP TRIGGER packet_fts_ai; DROP TRIGGER packet_fts_ad; "
+        "DROP TRIGGER packet_fts_au; DROP TABLE " PACKET_DB_FTS_TABLE "; "
+        "PRAGMA user_version = 4;", NULL, NULL, NULL);
+    tap_ok(count_rows(raw, PACKET_DB_SQL_HAS_FTS) == -1,
+           "fts: index dropped for the pre-V5 case");
+    db = packet_db_open(path);
+    tap_ok(db != NULL, "fts: re-open migrates a V4 DB");
+    packet_db_close(db);
+    tap_ok(count_rows(raw, PACKET_DB_SQL_HAS_FTS) == 1,
+           "fts: PACKET_DB_SQL_HAS_FTS finds the rebuilt index");
+    n = fts_hits(raw, "%SAFETY%", NULL);
+    tap_okf(n == 1, "fts: migration backfilled existing rows (got %ld)", n);
+    int uv = read_user_version(raw);
+    tap_okf(uv == 8, "fts: migrated DB stamped current version (got %d)", uv);
+    tap_ok(count_rows(raw, FTS_AU_CHANGE_ONLY) == 1,
+           "fts: V4 migration ends with the change-only update trigger");
+
+    // A V7 DB still carries the V5 update trigger, which re-tokenizes on
+    // every assignment. Re-opening must swap in the change-only one and
+    // keep the index following real changes.
+    sqlite3_exec(raw,
+        "DROP TRIGGER packet_fts_au; "
+        "CREATE TRIGGER packet_fts_au AFTER UPDATE OF session_dir ON packet "
+        "BEGIN "
+        "  INSERT INTO " PACKET_DB_FTS_TABLE "(" PACKET_DB_FTS_TABLE ", rowid, "
+        "    session_dir) VALUES ('delete', old.id, old.session_dir); "
+        "  INSERT INTO " PACKET_DB_FTS_TABLE "(rowid, session_dir) "
+        "    VALUES (new.id, new.session_dir); "
+        "END; "
+        "PRAGMA user_version = 7;", NULL, NULL, NULL);
+    tap_ok(count_rows(raw, FTS_AU_CHANGE_ONLY) == -1,
+           "fts: V5-style update trigger restored for the V7 case");
+    db = packet_db_open(path);
+    tap_ok(db != NULL, "fts: re-open migrates a V7 DB");
+    tap_ok(count_rows(raw, FTS_AU_CHANGE_ONLY) == 1,
+           "fts: V8 migration replaces the update trigger");
+    packet_db_update_observer(db, p2, sizeof p2, NAN, NAN, NAN, NAN, NAN,
+                              0, "/archive/satnogs/14391497", 1);
+    n = fts_hits(raw, "%14391497%", "session_dir");
+    tap_okf(n == 1, "fts: replaced trigger still reindexes (got %ld)", n);
+    packet_db_close(db);
+    uv = read_user_version(raw);
+    tap_okf(uv == 8, "fts: V7 DB stamped V8 (got %d)", uv);
+    sqlite3_close(raw);
+    unlink(path);
+}
+
+// resp_ts_sent_ms (V6): insert fills it for tcmd_response rows only, the
+// response lookup runs off idx_packet_resp_ts, and a pre-V6 DB gets the
+// column backfilled from the payloads on re-open. The V7 trigger fills
+// it for a row written by something that doesn't know the column.
+static long resp_ts_of(sqlite3 *raw, long long id)
+{
+    sqlite3_stmt *s = NULL;
+    if (sqlite3_prepare_v2(raw, "SELECT IFNULL(" PACKET_DB_RESP_TS_COL ", -1) "
+                           "FROM packet WHERE id=?1", -1, &s, NULL) != SQLITE_OK)
+        return -2;
+    sqlite3_bind_int64(s, 1, id);
+    long v = -3;
+    if (sqlite3_step(s) == SQLITE_ROW) v = (long) sqlite3_column_int64(s, 0);
+    sqlite3_finalize(s);
+    return v;
+}
+
+static void test_resp_ts_column(void)
+{
+    char path[64];
+    if (make_tmp_db_path(path, sizeof path) != 0) {
+        tap_bail("mkstemp"); return;
+    }
+    packet_db_t *db = packet_db_open(path);
+    if (!db) { tap_bail("open"); return; }
+
+    const long long ts = 1778000000123LL;
+    uint8_t resp[TCMD_RESP_HDR_LEN + 4] = {TCMD_RESP_PACKET_TYPE};
+    tcmd_resp_key_from_u64((uint64_t) ts, resp + TCMD_RESP_OFF_TS_SENT);
+    resp[TCMD_RESP_OFF_SEQ] = 1;
+    resp[TCMD_RESP_OFF_MAXSEQ] = 1;
+    uint8_t shortresp[5] = {TCMD_RESP_PACKET_TYPE, 9, 9, 9, 9};
+    uint8_t beacon[sizeof resp];
+    memcpy(beacon, resp, sizeof beacon);
+    beacon[0] = 0x01;
+
+    packet_db_record_t r1 = make_record(resp, sizeof resp, "selftest");
+    r1.packet_type = TCMD_RESP_PACKET_TYPE;
+    r1.packet_type_name = "tcmd_response";
+    packet_db_record_t r2 = make_record(shortresp, sizeof shortresp, "selftest");
+    r2.packet_type = TCMD_RESP_PACKET_TYPE;
+    r2.packet_type_name = "tcmd_response";
+    packet_db_record_t r3 = make_record(beacon, sizeof beacon, "selftest");
+    packet_db_insert(db, &r1);
+    packet_db_insert(db, &r2);
+    packet_db_insert(db, &r3);
+    packet_db_close(db);
+
+    sqlite3 *raw = NULL;
+    sqlite3_open_v2(path, &raw, SQLITE_OPEN_READWRITE, NULL);
+    tap_ok(count_rows(raw, PACKET_DB_SQL_HAS_RESP_TS) == 1,
+           "resp_ts: PACKET_DB_SQL_HAS_RESP_TS finds the V6 column");
+    long v = resp_ts_of(raw, 1);
+    tap_okf(v == ts, "resp_ts: insert stores a response's ts_sent (got %ld)", v);
+    v = resp_ts_of(raw, 2);
+    tap_okf(v == -1, "resp_ts: too-short response stores NULL (got %ld)", v);
+    v = resp_ts_of(raw, 3);
+    tap_okf(v == -1, "resp_ts: non-response row stores NULL (got %ld)", v);
+
+    // The lookup the browsers run must be an index seek, not a scan.
+    sqlite3_stmt *s = NULL;
+    int seek = 0;
+    if (sqlite3_prepare_v2(raw, "EXPLAIN QUERY PLAN SELECT id FROM packet "
+                           "WHERE " PACKET_DB_RESP_TS_COL "=?1", -1, &s, NULL)
+        == SQLITE_OK) {
+        while (sqlite3_step(s) == SQLITE_ROW) {
+            const char *d = (const char *) sqlite3_column_text(s, 3);
+            if (d && strstr(d, "idx_packet_resp_ts")) seek = 1;
+        }
+        sqlite3_finalize(s);
+    }
+    tap_ok(seek, "resp_ts: response lookup uses idx_packet_resp_ts");
+
+    // An older writer's INSERT names no resp_ts_sent_ms; the trigger
+    // decodes it, including a key with the top bit set (int64 wrap).
+    const uint64_t hi = 0xFEDCBA9876543210ULL;
+    uint8_t oldresp[sizeof resp];
+    memcpy(oldresp, resp, sizeof oldresp);
+    tcmd_resp_key_from_u64(hi, oldresp + TCMD_RESP_OFF_TS_SENT);
+    const char *raw_ins =
+        "INSERT INTO packet (ts_received, satellite, packet_type, "
+        "  packet_type_name, payload, payload_sha1, source_tool) "
+        "VALUES ('2026-05-05T00:00:00Z', 'SELFTEST', ?1, 'tcmd_response', "
+        "  ?2, randomblob(20), 'older_writer')";
+    long long raw_ids[2] = {0, 0};
+    const uint8_t *raw_pl[2] = {oldresp, shortresp};
+    const int raw_len[2] = {(int) sizeof oldresp, (int) sizeof shortresp};
+    for (int i = 0; i < 2; i++) {
+        if (sqlite3_prepare_v2(raw, raw_ins, -1, &s, NULL) != SQLITE_OK) break;
+        sqlite3_bind_int(s, 1, TCMD_RESP_PACKET_TYPE);
+        sqlite3_bind_blob(s, 2, raw_pl[i], raw_len[i], SQLITE_STATIC);
+        if (sqlite3_step(s) == SQLITE_DONE)
+            raw_ids[i] = sqlite3_last_insert_rowid(raw);
+        sqlite3_finalize(s);
+    }
+    v = resp_ts_of(raw, raw_ids[0]);
+    tap_okf(raw_ids[0] > 0 && v == (long) (int64_t) hi,
+            "resp_ts: trigger fills the key for an older writer (got %ld)", v);
+    v = resp_ts_of(raw, raw_ids[1]);
+    tap_okf(raw_ids[1] > 0 && v == -1,
+            "resp_ts: trigger leaves a too-short response NULL (got %ld)", v);
+
+    // A DB last written before V6: no column, no index, no trigger,
+    // version 5.
+    sqlite3_exec(raw,
+        "DROP TRIGGER packet_resp_ts_ai; "
+        "DROP INDEX idx_packet_resp_ts; "
+        "ALTER TABLE packet DROP COLUMN " PACKET_DB_RESP_TS_COL "; "
+        "PRAGMA user_version = 5;", NULL, NULL, NULL);
+    tap_ok(count_rows(raw, PACKET_DB_SQL_HAS_RESP_TS) == -1,
+           "resp_ts: column dropped for the pre-V6 case");
+    db = packet_db_open(path);
+    tap_ok(db != NULL, "resp_ts: re-open migrates a V5 DB");
+    packet_db_close(db);
+    v = resp_ts_of(raw, 1);
+    tap_okf(v == ts, "resp_ts: migration backfills ts_sent (got %ld)", v);
+    v = resp_ts_of(raw, 3);
+    tap_okf(v == -1, "resp_ts: backfill leaves non-responses NULL (got %ld)", v);
+    tap_ok(count_rows(raw, "SELECT 1 FROM sqlite_master WHERE type='index' "
+                           "AND name='idx_packet_resp_ts'") == 1,
+           "resp_ts: migration recreates idx_packet_resp_ts");
+    tap_ok(count_rows(raw, "SELECT 1 FROM sqlite_master WHERE type='trigger' "
+                           "AND name='packet_resp_ts_ai'") == 1,
+           "resp_ts: migration recreates packet_resp_ts_ai");
+    v = resp_ts_of(raw, raw_ids[0]);
+    tap_okf(v == (long) (int64_t) hi,
+            "resp_ts: backfill decodes a top-bit key (got %ld)", v);
+    sqlite3_close(raw);
+    unlink(path);
+}
+
+// Read one REAL/TEXT column of the row with this id as text, "NULL" for
+// NULL, so a test can compare any backfilled column against a literal.
+static void col_text(sqlite3 *raw, const char *col, long long id,
+                     char *out, size_t cap)
+{
+    char sql[128];
+    snprintf(sql, sizeof sql, "SELECT IFNULL(CAST(%s AS TEXT), 'NULL') "
+             "FROM packet WHERE id=?1", col);
+    sqlite3_stmt *s = NULL;
+    snprintf(out, cap, "?");
+    if (sqlite3_prepare_v2(raw, sql, -1, &s, NULL) != SQLITE_OK) return;
+    sqlite3_bind_int64(s, 1, id);
+    if (sqlite3_step(s) == SQLITE_ROW)
+        snprintf(out, cap, "%s", (const char *) sqlite3_column_text(s, 0));
+    sqlite3_finalize(s);
+}
+
+static void test_update_observer_many(void)
+{
+    char path[64];
+    if (make_tmp_db_path(path, sizeof path) != 0) {
+        tap_bail("mkstemp"); return;
+    }
+    packet_db_t *db = packet_db_open(path);
+    if (!db) { tap_bail("open"); return; }
+
+    // p1 decoded by two tools (two rows, one SHA1); p2 by rx_replay only.
+    uint8_t p1[6] = {7, 7, 7, 7, 7, 1};
+    uint8_t p2[6] = {7, 7, 7, 7, 7, 2};
+    uint8_t p3[6] = {7, 7, 7, 7, 7, 3};   // never inserted
+    packet_db_record_t r = make_record(p1, sizeof p1, "b210_rx_tx");
+    r.az_deg = r.el_deg = r.range_km = r.range_rate_km_s = NAN;
+    r.doppler_hz_offset = NAN;
+    r.session_dir = NULL;
+    packet_db_insert(db, &r);                       // id 1
+    r.source_tool = "rx_replay";
+    packet_db_insert(db, &r);                       // id 2
+    r.payload = p2;
+    r.az_deg = 10.0;                                // already known
+    packet_db_insert(db, &r);                       // id 3
+
+    packet_db_observer_update_t u[4] = {
+        { .payload = p1, .payload_len = sizeof p1, .az_deg = 1.5, .el_deg = NAN,
+          .range_km = NAN, .range_rate_km_s = NAN, .doppler_hz_offset = NAN,
+          .session_dir = "/pass/a", .ts_received = "2026-06-01T00:00:01.000Z",
+          .audio_offset_s = 1.0 },
+        { .payload = p1, .payload_len = sizeof p1, .az_deg = 2.5, .el_deg = 45.0,
+          .range_km = NAN, .range_rate_km_s = NAN, .doppler_hz_offset = NAN,
+          .session_dir = "/pass/b", .ts_received = "2026-06-01T00:00:02.000Z",
+          .audio_offset_s = 2.0 },
+        { .payload = p2, .payload_len = sizeof p2, .az_deg = 99.0, .el_deg = 5.0,
+          .range_km = NAN, .range_rate_km_s = NAN, .doppler_hz_offset = NAN,
+          .session_dir = "/pass/a" },
+        { .payload = p3, .payload_len = sizeof p3, .az_deg = 1.0, .el_deg = 1.0,
+          .range_km = NAN, .range_rate_km_s = NAN, .doppler_hz_offset = NAN },
+    };
+    int n = packet_db_update_observer_many(db, u, 4, /*force=*/0);
+    tap_okf(n == 3, "update_many: gaps pass touches the 3 matching rows (got %d)", n);
+
+    sqlite3 *raw = NULL;
+    sqlite3_open_v2(path, &raw, SQLITE_OPEN_READONLY, NULL);
+    char v[64];
+    col_text(raw, "az_deg", 1, v, sizeof v);
+    tap_okf(strcmp(v, "1.5") == 0, "update_many: gaps keep the first az for a "
+            "repeated payload (got %s)", v);
+    col_text(raw, "el_deg", 2, v, sizeof v);
+    tap_okf(strcmp(v, "45.0") == 0, "update_many: gaps take a later record's "
+            "value for a column the first left unknown (got %s)", v);
+    col_text(raw, "session_dir", 2, v, sizeof v);
+    tap_okf(strcmp(v, "/pass/a") == 0, "update_many: session_dir first wins "
+            "(got %s)", v);
+    col_text(raw, "az_deg", 3, v, sizeof v);
+    tap_okf(strcmp(v, "10.0") == 0, "update_many: gaps don't trample a known "
+            "az (got %s)", v);
+    col_text(raw, "ts_received", 2, v, sizeof v);
+    tap_okf(strcmp(v, "2026-06-01T00:00:02.000Z") == 0,
+            "update_many: replay ts takes the last record (got %s)", v);
+    col_text(raw, "ts_received", 1, v, sizeof v);
+    tap_okf(strcmp(v, "2026-05-18T19:00:00Z") == 0,
+            "update_many: replay ts leaves non-rx_replay rows alone (got %s)", v);
+    col_text(raw, "ts_received", 3, v, sizeof v);
+    tap_okf(strcmp(v, "2026-05-18T19:00:00Z") == 0,
+            "update_many: a record without ts leaves ts_received (got %s)", v);
+
+    n = packet_db_update_observer_many(db, u, 2, /*force=*/1);
+    tap_okf(n == 2, "update_many: force pass touches both p1 rows (got %d)", n);
+    col_text(raw, "az_deg", 1, v, sizeof v);
+    tap_okf(strcmp(v, "2.5") == 0, "update_many: force takes the last record "
+            "(got %s)", v);
+    col_text(raw, "range_km", 1, v, sizeof v);
+    tap_okf(strcmp(v, "NULL") == 0, "update_many: force writes NaN as NULL "
+            "(got %s)", v);
+    n = packet_db_update_observer_many(db, u, 0, 0);
+    tap_okf(n == 0, "update_many: empty batch is a no-op (got %d)", n);
+    tap_ok(count_rows(raw, "SELECT COUNT(*) FROM packet") == 3,
+           "update_many: never inserts rows");
+    sqlite3_close(raw);
+    packet_db_close(db);
+    unlink(path);
+}
+
+// ------------------------------------------------------------------
+// Async writer. The live receiver queues rows for a writer thread so
+// a second process holding the write lock can't stall the RX worker.
+// Oracle: with the lock held elsewhere every insert still returns 0
+// at once, the rows sit in the queue (depth 6) while the writer logs
+// BUSY retries, the queue owns its copies (the caller's buffer is
+// scribbled after each insert), and once the lock is released every
+// row — including ones that had to wait for queue space — lands. A
+// writer that drops on BUSY or on a full queue fails the final count.
+// ------------------------------------------------------------------
+
+static void test_async_writer(void)
+{
+    char path[64];
+    if (make_tmp_db_path(path, sizeof path) != 0) {
+        tap_bail("mkstemp"); return;
+    }
+    packet_db_t *db = packet_db_open(path);
+    if (!db) { tap_bail("open"); unlink(path); return; }
+    tap_ok(packet_db_start_writer(db, 8, 4, 50) == 0,
+           "writer: starts on a file DB");
+
+    sqlite3 *raw = NULL;
+    sqlite3_open_v2(path, &raw, SQLITE_OPEN_READWRITE, NULL);
+    sqlite3_busy_timeout(raw, 60000);
+    tap_ok(sqlite3_exec(raw, "BEGIN IMMEDIATE;", NULL, NULL, NULL) == SQLITE_OK,
+           "writer: second connection holds the write lock");
+
+    enum { HELD = 6, MORE = 30 };
+    int all_ok = 1;
+    uint8_t pl[4];
+    for (int i = 0; i < HELD; ++i) {
+        pl[0] = 0xA5; pl[1] = (uint8_t)i; pl[2] = 0; pl[3] = 0;
+        packet_db_record_t r = make_record(pl, sizeof pl, "writer");
+        if (packet_db_insert(db, &r) != PACKET_DB_INSERT_OK) all_ok = 0;
+        memset(pl, 0xFF, sizeof pl);
+    }
+    tap_ok(all_ok, "writer: inserts return 0 while the lock is held elsewhere");
+    usleep(300 * 1000);
+
+    packet_db_writer_stats_t st;
+    packet_db_writer_stats(db, &st);
+    tap_okf(st.active == 1 && st.queue_cap == 8,
+            "writer: stats report active, cap 8 (active=%d cap=%ld)",
+            st.active, st.queue_cap);
+    tap_okf(st.queue_depth == HELD,
+            "writer: %d rows queued behind the lock (got %ld)",
+            HELD, st.queue_depth);
+    tap_okf(st.busy_retries > 0,
+            "writer: BUSY retries counted (got %ld)", st.busy_retries);
+    tap_okf(st.rows_committed == 0,
+            "writer: nothing committed yet (got %ld)", st.rows_committed);
+
+    sqlite3_exec(raw, "COMMIT;", NULL, NULL, NULL);
+    for (int i = 0; i < MORE; ++i) {
+        pl[0] = 0xB6; pl[1] = (uint8_t)i; pl[2] = 0; pl[3] = 0;
+        packet_db_record_t r = make_record(pl, sizeof pl, "writer");
+        if (packet_db_insert(db, &r) != PACKET_DB_INSERT_OK) all_ok = 0;
+    }
+    tap_ok(all_ok, "writer: inserts after release return 0");
+
+    long lost = packet_db_stop_writer(db);
+    tap_okf(lost == 0, "writer: drain loses nothing (got %ld)", lost);
+    packet_db_writer_stats(db, &st);
+    tap_okf(st.active == 0 && st.queue_depth == 0,
+            "writer: stopped and empty (active=%d depth=%ld)",
+            st.active, st.queue_depth);
+    tap_okf(st.rows_committed == HELD + MORE && st.rows_failed == 0,
+            "writer: %d rows committed, 0 failed (got %ld / %ld)",
+            HELD + MORE, st.rows_committed, st.rows_failed);
+    tap_okf(st.commits >= (HELD + MORE) / 4 && st.max_commit_ms > 0.0,
+            "writer: grouped commits with latency recorded "
+            "(commits=%ld max=%.2f ms)", st.commits, st.max_commit_ms);
+    tap_okf(st.queue_max_depth >= HELD && st.queue_max_depth <= 8 + 4,
+            "writer: high-water mark within ring + group (got %ld)",
+            st.queue_max_depth);
+
+    long n = count_rows(raw, "SELECT count(*) FROM packet;");
+    tap_okf(n == HELD + MORE, "writer: all %d rows in the DB (got %ld)",
+            HELD + MORE, n);
+    n = count_rows(raw, "SELECT count(*) FROM packet "
+                        "WHERE hex(payload) LIKE 'A5%';");
+    tap_okf(n == HELD, "writer: queued rows kept their own payload copy "
+            "(got %ld of %d)", n, HELD);
+
+    // After the stop, inserts are synchronous again.
+    pl[0] = 0xC7; pl[1] = 0; pl[2] = 0; pl[3] = 0;
+    packet_db_record_t r = make_record(pl, sizeof pl, "writer");
+    tap_ok(packet_db_insert(db, &r) == PACKET_DB_INSERT_OK
+           && count_rows(raw, "SELECT count(*) FROM packet;") == HELD + MORE + 1,
+           "writer: inserts are synchronous after stop");
+
+    sqlite3_close(raw);
+    packet_db_close(db);
+    unlink(path);
+    char side[80];
+    snprintf(side, sizeof side, "%s-wal", path); unlink(side);
+    snprintf(side, sizeof side, "%s-shm", path); unlink(side);
+}
+
 int main(void)
 {
     test_open_fresh_creates_schema();
@@ -1000,5 +1498,10 @@ int main(void)
     test_batch_buffers_until_flush();
     test_batch_parallel_writers();
     test_register_tle_no_snapshot_leak();
+    test_fts_match_expr();
+    test_fts_index();
+    test_resp_ts_column();
+    test_update_observer_many();
+    test_async_writer();
     return tap_done();
 }
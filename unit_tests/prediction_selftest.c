@@ -25,6 +25,12 @@
         list is module-level static state; this exercises the full search,
         the soonest-first / latest-first sort, the get_pass bounds, and the
         free_passes reset.
+      - prediction_build_pass_cache: interpolated lookups agree with SGP4
+        at off-grid times, and fall back to SGP4 outside the window or
+        for another TLE.
+      - sgp4_propagate_grid / _times / _multi: the batch paths reproduce
+        the scalar SGP4 and SDP4 states, and the SDP4 fallback leaves the
+        caller's propagator flags usable.
 
     Where the existence of a result depends on orbit-vs-observer geometry
     rather than on prediction.c (e.g. "is there a visible pass in the next
@@ -615,6 +621,210 @@ static void test_julian_date_from_unix_seconds(const char *tles_path)
             range_good, range_bug);
 }
 
+// Per-pass ephemeris cache. The cache replaces only the SGP4 call, so an
+// interpolated lookup must agree with a fresh propagation at off-grid
+// times (worst case is mid-step) to well under anything the rotator or
+// Doppler could notice. Outside the window, or once the TLE changes, the
+// result must be bit-identical to the uncached path.
+static void test_pass_cache(const char *tles_path)
+{
+    fprintf(stderr, "pass ephemeris cache:\n");
+    prediction_t pred;
+    char name[64];
+    snprintf(name, sizeof name, "OSCAR 7");
+    init_pred(&pred, tles_path, name);
+    if (load_tle(&pred) != 0) {
+        check(0, "load_tle preflight succeeded");
+        return;
+    }
+    prep_propagator(&pred);
+    double j0 = Julian_Date_of_Epoch(pred.satellite_ephem.tle.epoch)
+              + 10.0 / 1440.0;
+    double j1 = j0 + 20.0 / 1440.0;
+
+    check(prediction_build_pass_cache(&pred, j1, j0) != 0
+          && pred.pass_cache == NULL,
+          "an empty window builds no cache");
+    check(prediction_build_pass_cache(&pred, j0, j1) == 0
+          && pred.pass_cache != NULL,
+          "cache builds over a 20 min window");
+    check(prediction_pass_cache_covers(&pred, j0, j1)
+          && !prediction_pass_cache_covers(&pred, j0 - 1.0 / 1440.0, j1),
+          "covers() reports exactly the built window");
+
+    prediction_t plain = pred;
+    plain.pass_cache = NULL;
+    double worst_az = 0.0, worst_el = 0.0, worst_rng = 0.0, worst_rr = 0.0;
+    for (int k = 0; k < 97; ++k) {
+        // 12.37 s stride: never lands on the 10 s grid.
+        double t = j0 + (0.5 + 12.37 * k) / 86400.0;
+        if (t > j1) break;
+        update_satellite_position(&pred, t);
+        update_satellite_position(&plain, t);
+        double daz = fabs(pred.satellite_ephem.azimuth
+                          - plain.satellite_ephem.azimuth);
+        if (daz > 180.0) daz = 360.0 - daz;
+        double del = fabs(pred.satellite_ephem.elevation
+                          - plain.satellite_ephem.elevation);
+        double drg = fabs(pred.satellite_ephem.range_km
+                          - plain.satellite_ephem.range_km);
+        double drr = fabs(pred.satellite_ephem.range_rate_km_s
+                          - plain.satellite_ephem.range_rate_km_s);
+        if (daz > worst_az)  worst_az  = daz;
+        if (del > worst_el)  worst_el  = del;
+        if (drg > worst_rng) worst_rng = drg;
+        if (drr > worst_rr)  worst_rr  = drr;
+    }
+    tap_okf(worst_az < 1e-5 && worst_el < 1e-5,
+            "cached az/el match SGP4 (worst %.2e / %.2e deg)",
+            worst_az, worst_el);
+    tap_okf(worst_rng < 1e-4,
+            "cached range matches SGP4 (worst %.2e km)", worst_rng);
+    // SGP4's analytic velocity is not exactly the derivative of its
+    // position, so the Hermite fit differs by a few mm/s: ~0.01 Hz of
+    // Doppler at 437 MHz.
+    tap_okf(worst_rr < 2e-5,
+            "cached range-rate matches SGP4 (worst %.2e km/s)", worst_rr);
+    tap_okf(fabs(pred.minutes_since_epoch - plain.minutes_since_epoch) < 1e-9,
+            "cached lookup keeps minutes_since_epoch current");
+
+    double tout = j1 + 5.0 / 1440.0;
+    update_satellite_position(&pred, tout);
+    update_satellite_position(&plain, tout);
+    check(pred.satellite_ephem.azimuth == plain.satellite_ephem.azimuth
+          && pred.satellite_ephem.range_km == plain.satellite_ephem.range_km,
+          "outside the window the result is plain SGP4");
+
+    // A different object loaded into the same prediction must not be
+    // served the old track.
+    pred.satellite_ephem.tle.catnr += 1;
+    check(!prediction_pass_cache_covers(&pred, j0, j1),
+          "covers() is false once the TLE changes");
+    plain.satellite_ephem.tle.catnr += 1;
+    double tmid = j0 + 7.77 / 1440.0;
+    update_satellite_position(&pred, tmid);
+    update_satellite_position(&plain, tmid);
+    check(pred.satellite_ephem.azimuth == plain.satellite_ephem.azimuth,
+          "a cache for another TLE is ignored");
+
+    prediction_free_pass_cache(&pred);
+    check(pred.pass_cache == NULL, "free clears the cache");
+    prediction_free_pass_cache(&pred);
+}
+
+// ---------------------------------------------------- batch propagation
+
+// Scalar reference: the state SGP4/SDP4 give at tsince (minutes since
+// epoch), in km and km/s. fresh = 1 re-derives the propagator constants
+// first; a run of calls without it steps one object the way a scalar loop
+// does (SDP4 caches its lunar-solar terms between nearby calls).
+static void scalar_state(tle_t *tle, int deep, int fresh, double tsince,
+                         double r[3], double v[3])
+{
+    if (fresh) {
+        ClearFlag(ALL_FLAGS);
+        if (deep) SetFlag(DEEP_SPACE_EPHEM_FLAG);
+    }
+    vector_t p = {0}, vel = {0};
+    if (deep) SDP4(tsince, tle, &p, &vel);
+    else      SGP4(tsince, tle, &p, &vel);
+    Convert_Sat_State(&p, &vel);
+    r[0] = p.x; r[1] = p.y; r[2] = p.z;
+    v[0] = vel.x; v[1] = vel.y; v[2] = vel.z;
+}
+
+// Largest |grid - scalar| over n grid points, position (km) and velocity (km/s).
+static void grid_vs_scalar(tle_t *tle, const sgp4_ctx_t *ctx, double t0, double dt_s,
+                           int n, double *dr_max, double *dv_max)
+{
+    double *pos = malloc(3 * (size_t) n * sizeof *pos);
+    double *vel = malloc(3 * (size_t) n * sizeof *vel);
+    *dr_max = *dv_max = INFINITY;
+    if (!pos || !vel) { free(pos); free(vel); return; }
+    sgp4_propagate_grid(ctx, t0, dt_s, n, pos, vel);
+    *dr_max = *dv_max = 0.0;
+    for (int k = 0; k < n; ++k) {
+        double r[3], v[3];
+        double tsince = (t0 - ctx->epoch_jul) * 1440.0 + (double) k * (dt_s / 60.0);
+        scalar_state(tle, ctx->deep_space, k == 0, tsince, r, v);
+        for (int c = 0; c < 3; ++c) {
+            double dr = fabs(pos[c * n + k] - r[c]), dv = fabs(vel[c * n + k] - v[c]);
+            if (dr > *dr_max) *dr_max = dr;
+            if (dv > *dv_max) *dv_max = dv;
+        }
+    }
+    free(pos);
+    free(vel);
+}
+
+static void test_batch_propagation(const char *tles_path)
+{
+    fprintf(stderr, "sgp4_propagate_grid / _times / _multi:\n");
+    prediction_t leo, heo;
+    char n_leo[64], n_heo[64];
+    snprintf(n_leo, sizeof n_leo, "OSCAR 7");
+    snprintf(n_heo, sizeof n_heo, "AO-40");
+    init_pred(&leo, tles_path, n_leo);
+    init_pred(&heo, tles_path, n_heo);
+    if (load_tle(&leo) != 0 || load_tle(&heo) != 0) {
+        check(0, "load_tle preflight succeeded for the batch fixtures");
+        return;
+    }
+    prep_propagator(&leo);
+    tle_t t_leo = leo.satellite_ephem.tle;
+    prep_propagator(&heo);
+    tle_t t_heo = heo.satellite_ephem.tle;
+
+    sgp4_ctx_t ctx[2];
+    sgp4_ctx_init(&ctx[0], &t_leo, 0);
+    sgp4_ctx_init(&ctx[1], &t_heo, 1);
+
+    // 300 points spans several SGP4_Batch blocks plus a ragged tail.
+    double dr, dv;
+    double t0 = ctx[0].epoch_jul + 3.25;
+    grid_vs_scalar(&t_leo, &ctx[0], t0, 17.0, 300, &dr, &dv);
+    tap_okf(dr < 1e-9 && dv < 1e-12,
+            "SGP4 grid matches scalar SGP4 (max |dr| %.2e km, |dv| %.2e km/s)", dr, dv);
+    grid_vs_scalar(&t_heo, &ctx[1], ctx[1].epoch_jul + 0.5, 300.0, 150, &dr, &dv);
+    tap_okf(dr < 1e-9 && dv < 1e-12,
+            "SDP4 fallback matches scalar SDP4 (max |dr| %.2e km, |dv| %.2e km/s)", dr, dv);
+
+    // Arbitrary times and the multi-object form agree with the same scalar states.
+    double jul[3] = { t0, t0 + 0.01, t0 - 2.0 };
+    double p3[9], v3[9], r[3], v[3];
+    sgp4_propagate_times(&ctx[0], jul, 3, p3, v3);
+    int ok = 1;
+    for (int k = 0; k < 3; ++k) {
+        scalar_state(&t_leo, 0, 1, (jul[k] - ctx[0].epoch_jul) * 1440.0, r, v);
+        for (int c = 0; c < 3; ++c)
+            ok &= fabs(p3[c * 3 + k] - r[c]) < 1e-9 && fabs(v3[c * 3 + k] - v[c]) < 1e-12;
+    }
+    check(ok, "sgp4_propagate_times matches scalar SGP4 at arbitrary dates");
+
+    double pm[6], vm[6];
+    sgp4_propagate_multi(ctx, 2, t0, pm, vm);
+    ok = 1;
+    for (int j = 0; j < 2; ++j) {
+        scalar_state(j ? &t_heo : &t_leo, j, 1, (t0 - ctx[j].epoch_jul) * 1440.0, r, v);
+        for (int c = 0; c < 3; ++c)
+            ok &= fabs(pm[c * 2 + j] - r[c]) < 1e-9 && fabs(vm[c * 2 + j] - v[c]) < 1e-12;
+    }
+    check(ok, "sgp4_propagate_multi lays out one state per object, SoA");
+
+    // The SDP4 fallback runs through the thread's propagator state. A caller
+    // mid-way through scalar SGP4 calls must keep its flags and its answer.
+    scalar_state(&t_leo, 0, 1, (t0 - ctx[0].epoch_jul) * 1440.0, r, v);
+    double pos1[3];
+    sgp4_propagate_grid(&ctx[1], t0, 60.0, 1, pos1, NULL);
+    check(isFlagSet(SGP4_INITIALIZED_FLAG) && isFlagClear(DEEP_SPACE_EPHEM_FLAG),
+          "SDP4 fallback restores the caller's SGP4 flags");
+    vector_t p = {0}, vel = {0};
+    SGP4((t0 - ctx[0].epoch_jul) * 1440.0, &t_leo, &p, &vel);
+    Convert_Sat_State(&p, &vel);
+    check(p.x == r[0] && p.y == r[1] && p.z == r[2],
+          "scalar SGP4 after an SDP4 batch still returns its own object");
+}
+
 int main(void)
 {
     test_tle_default_path();
@@ -633,6 +843,8 @@ int main(void)
     test_update_satellite_position_deep_space(tles_path);
     test_update_pass_predictions(tles_path);
     test_pass_search_api(tles_path);
+    test_pass_cache(tles_path);
+    test_batch_propagation(tles_path);
 
     unlink(tles_path);
     free(tles_path);
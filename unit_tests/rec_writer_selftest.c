@@ -0,0 +1,227 @@
+/*
+
+    Simple Satellite Operations  unit_tests/rec_writer_selftest.c
+
+    Tests for src/pipeline/rec_writer.c -- the background writer behind
+    the per-pass .wav / .iq / CSV recordings.
+
+      - Round trip: interleaved appends to several files, odd sizes that
+        straddle blocks, printf rows, early flushes and a header patch
+        read back byte for byte, through io_uring where the kernel allows
+        it and through the pwrite fallback.
+      - Back-pressure: a pool of four small blocks forces the appender to
+        wait, loses nothing, and the waits are counted.
+      - Limits: opens beyond what the pool can back fail with EMFILE.
+      - Errors: writes to /dev/full are counted, not retried forever.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "rec_writer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Whole file into a malloc'd buffer; *len gets its size.
+static uint8_t *slurp(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = malloc((size_t) n + 1);
+    if (buf != NULL && fread(buf, 1, (size_t) n, f) != (size_t) n) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = (size_t) n;
+    return buf;
+}
+
+static uint8_t pattern(uint64_t i, int salt)
+{
+    return (uint8_t) ((i * 2654435761u) >> 13 ^ (uint64_t) salt);
+}
+
+static void round_trip(const char *label)
+{
+    fprintf(stderr, "round trip (%s):\n", label);
+    // 64 KiB blocks so a few hundred KiB cross many of them.
+    rec_writer_t *w = rec_writer_start(64 * 1024, 8);
+    tap_ok(w != NULL, "writer started");
+    if (w == NULL) return;
+    rec_file_t *a = rec_file_open(w, tap_tmpdir_path("a.bin"));
+    rec_file_t *b = rec_file_open(w, tap_tmpdir_path("b.bin"));
+    rec_file_t *c = rec_file_open(w, tap_tmpdir_path("c.csv"));
+    tap_ok(a && b && c, "three files open");
+    if (!a || !b || !c) return;
+
+    static uint8_t chunk[70000];
+    uint64_t na = 0, nb = 0;
+    char csv[8192];
+    size_t ncsv = 0;
+    rec_file_write(a, "HDR:0000", 8);
+    na = 8;
+    for (int round = 0; round < 40; ++round) {
+        size_t la = 1 + (size_t) (round * 7919) % sizeof chunk;
+        for (size_t i = 0; i < la; ++i) chunk[i] = pattern(na + i, 1);
+        rec_file_write(a, chunk, la);
+        na += la;
+        size_t lb = 1 + (size_t) (round * 104729) % 5000;
+        for (size_t i = 0; i < lb; ++i) chunk[i] = pattern(nb + i, 2);
+        rec_file_write(b, chunk, lb);
+        nb += lb;
+        int n = snprintf(csv + ncsv, sizeof csv - ncsv, "%d,%.3f\n", round, round * 0.5);
+        rec_file_printf(c, "%d,%.3f\n", round, round * 0.5);
+        ncsv += (size_t) n;
+        if (round % 5 == 0) rec_file_flush(c);
+        if (round % 9 == 0) rec_file_flush(b);
+    }
+    tap_ok(rec_file_size(a) == na && rec_file_size(c) == ncsv, "sizes tracked");
+    rec_file_patch(a, 4, "SIZE", 4);
+    rec_file_close(a);
+    rec_file_close(b);
+    rec_file_close(c);
+    rec_writer_stats_t st;
+    rec_writer_stats(w, &st);
+    fprintf(stderr, "  batches via %s\n", st.uring ? "io_uring" : "pwrite");
+    if (strcmp(label, "pwrite") == 0) tap_ok(!st.uring, "SSO_REC_NO_URING=1 forces pwrite");
+    rec_writer_stop(w);
+
+    size_t len = 0;
+    uint8_t *got = slurp(tap_tmpdir_path("a.bin"), &len);
+    int ok = got != NULL && len == na && memcmp(got, "HDR:SIZE", 8) == 0;
+    for (size_t i = 8; ok && i < len; ++i) ok = got[i] == pattern(i, 1);
+    tap_okf(ok, "a.bin: %zu bytes, header patched after the data", len);
+    free(got);
+    got = slurp(tap_tmpdir_path("b.bin"), &len);
+    ok = got != NULL && len == nb;
+    for (size_t i = 0; ok && i < len; ++i) ok = got[i] == pattern(i, 2);
+    tap_okf(ok, "b.bin: %zu bytes across flushed partial blocks", len);
+    free(got);
+    got = slurp(tap_tmpdir_path("c.csv"), &len);
+    tap_ok(got != NULL && len == ncsv && memcmp(got, csv, len) == 0, "c.csv rows in order");
+    free(got);
+}
+
+static void test_backpressure(void)
+{
+    fprintf(stderr, "back-pressure:\n");
+    rec_writer_t *w = rec_writer_start(4096, 4);
+    rec_file_t *f = w ? rec_file_open(w, tap_tmpdir_path("bp.bin")) : NULL;
+    tap_ok(f != NULL, "one file on a four-block pool");
+    if (f == NULL) {
+        rec_writer_stop(w);
+        return;
+    }
+    static uint8_t buf[4096];
+    uint64_t total = 0;
+    for (int i = 0; i < 2000; ++i) {
+        for (size_t k = 0; k < sizeof buf; ++k) buf[k] = pattern(total + k, 3);
+        rec_file_write(f, buf, sizeof buf);
+        total += sizeof buf;
+    }
+    rec_file_close(f);
+    rec_writer_stats_t st;
+    for (int i = 0; i < 500; ++i) {
+        rec_writer_stats(w, &st);
+        if (st.queue_depth == 0) break;
+        usleep(2000);
+    }
+    tap_okf(st.producer_waits > 0 && st.stall_ms >= 0.0,
+            "appender waited %ld times (%.1f ms)", st.producer_waits, st.stall_ms);
+    tap_okf(st.queue_max_depth <= 4, "queue never deeper than the pool (%ld)", st.queue_max_depth);
+    tap_ok(st.bytes_queued == total && st.bytes_written == total && st.write_errors == 0,
+           "every byte written");
+    rec_writer_stop(w);
+
+    size_t len = 0;
+    uint8_t *got = slurp(tap_tmpdir_path("bp.bin"), &len);
+    int ok = got != NULL && len == total;
+    for (size_t i = 0; ok && i < len; ++i) ok = got[i] == pattern(i, 3);
+    tap_okf(ok, "file intact (%zu bytes)", len);
+    free(got);
+}
+
+static void test_limits(void)
+{
+    fprintf(stderr, "limits:\n");
+    rec_writer_t *w = rec_writer_start(4096, 4);
+    rec_file_t *a = rec_file_open(w, tap_tmpdir_path("l1"));
+    rec_file_t *b = rec_file_open(w, tap_tmpdir_path("l2"));
+    errno = 0;
+    rec_file_t *c = rec_file_open(w, tap_tmpdir_path("l3"));
+    tap_ok(a && b && c == NULL && errno == EMFILE, "third file on four blocks refused");
+    rec_file_close(b);
+    errno = 0;
+    tap_ok(rec_file_open(w, tap_tmpdir_path("no/such/dir")) == NULL && errno == ENOENT,
+           "bad path reported at open");
+    c = rec_file_open(w, tap_tmpdir_path("l3"));
+    tap_ok(c != NULL, "slot comes back on close, and after a failed open");
+    rec_file_close(a);
+    rec_file_close(c);
+    rec_writer_stop(w);
+}
+
+static void test_errors(void)
+{
+    fprintf(stderr, "errors:\n");
+    rec_writer_t *w = rec_writer_start(4096, 4);
+    rec_file_t *f = rec_file_open(w, "/dev/full");
+    if (f == NULL) {
+        tap_ok(1, "# skip: no /dev/full");
+        rec_writer_stop(w);
+        return;
+    }
+    static uint8_t buf[3 * 4096];
+    rec_file_write(f, buf, sizeof buf);
+    rec_file_close(f);
+    rec_writer_stats_t st;
+    for (int i = 0; i < 500; ++i) {
+        rec_writer_stats(w, &st);
+        if (st.queue_depth == 0) break;
+        usleep(2000);
+    }
+    tap_okf(st.write_errors >= 3 && st.bytes_written == 0,
+            "ENOSPC counted (%ld errors)", st.write_errors);
+    rec_writer_stop(w);
+}
+
+int main(void)
+{
+    if (tap_tmpdir_make("sso_recw") != 0) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    round_trip("default");
+    setenv("SSO_REC_NO_URING", "1", 1);
+    round_trip("pwrite");
+    unsetenv("SSO_REC_NO_URING");
+    test_backpressure();
+    test_limits();
+    test_errors();
+
+    tap_tmpdir_remove();
+    return tap_done();
+}
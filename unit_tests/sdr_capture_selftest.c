@@ -0,0 +1,252 @@
+/*
+
+    Simple Satellite Operations  unit_tests/sdr_capture_selftest.c
+
+    Tests for src/hw/sdr_capture.c -- the capture thread and SPSC ring
+    between an SDR backend and b210_rx_tx_core_pump. A scripted fake
+    backend numbers every pair it delivers (I = index, Q = ~index), so
+    the consumer can check the stream sample by sample.
+
+      - Stream: a consumer that keeps up sees every pair in order, each
+        read inside one block, stamped with its stream index, host time
+        and the device time the backend reported.
+      - Overflow: with the consumer stalled, new blocks are dropped whole
+        once the ring is full and the oldest survive intact; the drops,
+        the device overflow and the transient read errors are counted and
+        the high-water mark reaches the ring size.
+      - Counted loss: pairs a backend reports lost open the same gap in
+        the stamps as in the device stream, and are totalled.
+      - Device loss: the consumer drains what was queued, then gets -1.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "sdr_capture.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RATE_HZ  10000.0
+#define BLOCK    100
+
+// Fake device: reads_left blocks of BLOCK pairs, then a fatal error.
+// Every zero_every-th call returns 0 (a timeout); call ovf_at reports an
+// overflow. Call lose_at skips lose_pairs first and reports them lost.
+// pace_us sleeps per read, as a device would.
+typedef struct {
+    int      reads_left;
+    int      calls;
+    int      zero_every;
+    int      ovf_at;
+    int      lose_at;
+    unsigned lose_pairs;
+    unsigned pace_us;
+    uint64_t next;          // index of the next pair delivered
+    uint64_t last_first;    // first index of the last block
+} fake_dev_t;
+
+static ssize_t fake_read(sdr_backend_t *be, int16_t *out, size_t cap_pairs)
+{
+    fake_dev_t *f = be->priv;
+    f->calls++;
+    if (f->pace_us) usleep(f->pace_us);
+    if (f->zero_every && f->calls % f->zero_every == 0) return 0;
+    if (f->reads_left-- <= 0) return -1;
+    size_t n = cap_pairs < BLOCK ? cap_pairs : BLOCK;
+    if (f->calls == f->lose_at) f->next += f->lose_pairs;
+    f->last_first = f->next;
+    for (size_t i = 0; i < n; ++i, ++f->next) {
+        out[2 * i]     = (int16_t) (f->next & 0x7FFF);
+        out[2 * i + 1] = (int16_t) ~(f->next & 0x7FFF);
+    }
+    return (ssize_t) n;
+}
+
+static int fake_meta(sdr_backend_t *be, sdr_rx_meta_t *m)
+{
+    fake_dev_t *f = be->priv;
+    m->overflow      = (f->calls == f->ovf_at || f->calls == f->lose_at);
+    m->dropped       = f->calls == f->lose_at ? f->lose_pairs : 0;
+    m->has_time      = 1;
+    m->device_time_s = 1000.0 + (double) f->last_first / RATE_HZ;
+    return 0;
+}
+
+static const sdr_backend_ops_t fake_ops = {
+    .name    = "fake",
+    .read_iq = fake_read,
+    .rx_meta = fake_meta,
+};
+
+static int pair_ok(const int16_t *iq, uint64_t idx)
+{
+    return iq[0] == (int16_t) (idx & 0x7FFF) && iq[1] == (int16_t) ~(idx & 0x7FFF);
+}
+
+static void test_stream(void)
+{
+    fprintf(stderr, "stream:\n");
+    fake_dev_t f = { .reads_left = 200, .pace_us = 200 };
+    sdr_backend_t be = { .ops = &fake_ops, .priv = &f };
+    sdr_capture_t *cap = sdr_capture_start(&be, RATE_HZ, 1.0, BLOCK);
+    tap_ok(cap != NULL, "capture thread started");
+    if (cap == NULL) return;
+
+    int16_t buf[2 * 64];
+    uint64_t want = 0;
+    int in_order = 1, stamped = 1, one_block = 1, dev_time = 1, reads = 0;
+    double last_host = 0.0;
+    for (;;) {
+        sdr_capture_stamp_t st;
+        ssize_t n = sdr_capture_read(cap, buf, 64, 1.0, &st);
+        if (n < 0) break;
+        if (n == 0) continue;
+        reads++;
+        if (st.sample != want) stamped = 0;
+        if ((st.sample % BLOCK) + (uint64_t) n > BLOCK) one_block = 0;
+        for (ssize_t i = 0; i < n; ++i)
+            if (!pair_ok(buf + 2 * i, want + (uint64_t) i)) in_order = 0;
+        if (!st.has_device_time
+            || fabs(st.device_time_s - (1000.0 + (double) st.sample / RATE_HZ)) > 1e-9)
+            dev_time = 0;
+        if (st.host_time_s < last_host - 0.05) stamped = 0;
+        last_host = st.host_time_s;
+        want += (uint64_t) n;
+    }
+    tap_okf(want == 200 * BLOCK, "every pair delivered (%llu)", (unsigned long long) want);
+    tap_ok(in_order, "pairs in device order");
+    tap_ok(stamped, "stamps carry the stream index, host time non-decreasing");
+    tap_ok(one_block, "no read crosses a block");
+    tap_ok(dev_time, "device time offset to the first returned pair");
+    tap_okf(reads >= 400, "block of 100 split across 64-pair reads (%d reads)", reads);
+
+    sdr_capture_stats_t s;
+    sdr_capture_stats(cap, &s);
+    tap_ok(s.samples_in == 200 * BLOCK && s.samples_dropped == 0 && s.ring_overflows == 0,
+           "nothing dropped with the consumer keeping up");
+    tap_ok(!s.running && fabs(s.ring_s - 1.0) < 1e-9, "thread stopped on device loss, 1 s ring");
+    sdr_capture_stop(cap);
+}
+
+static void test_overflow(void)
+{
+    fprintf(stderr, "overflow:\n");
+    // 0.1 s ring = 1000 pairs = 10 blocks; 50 blocks arrive while the
+    // consumer sleeps.
+    fake_dev_t f = { .reads_left = 50, .zero_every = 7, .ovf_at = 3 };
+    sdr_backend_t be = { .ops = &fake_ops, .priv = &f };
+    sdr_capture_t *cap = sdr_capture_start(&be, RATE_HZ, 0.1, BLOCK);
+    if (cap == NULL) {
+        tap_ok(0, "capture thread started");
+        return;
+    }
+    sdr_capture_stats_t s;
+    for (int i = 0; i < 200; ++i) {
+        sdr_capture_stats(cap, &s);
+        if (!s.running) break;
+        usleep(5000);
+    }
+    tap_ok(!s.running, "producer ran to the end of the device");
+    tap_okf(fabs(s.lag_s - 0.1) < 1e-9 && fabs(s.high_water_s - 0.1) < 1e-9,
+            "ring full: lag %.3f s, high water %.3f s", s.lag_s, s.high_water_s);
+    tap_okf(s.ring_overflows == 40 && s.samples_dropped == 40 * BLOCK,
+            "40 whole blocks dropped (%llu)", (unsigned long long) s.ring_overflows);
+    tap_ok(s.device_overflows == 1, "device overflow counted");
+    tap_okf(s.read_errors == (uint64_t) (f.calls / 7), "transient reads counted (%llu)",
+            (unsigned long long) s.read_errors);
+
+    int16_t buf[2 * BLOCK];
+    uint64_t got = 0, first = UINT64_MAX;
+    int ok = 1;
+    ssize_t n;
+    sdr_capture_stamp_t st;
+    while ((n = sdr_capture_read(cap, buf, BLOCK, 0.1, &st)) != -1) {
+        if (n <= 0) continue;
+        if (first == UINT64_MAX) first = st.sample;
+        if (!pair_ok(buf, st.sample)) ok = 0;
+        got += (uint64_t) n;
+    }
+    tap_okf(got == 10 * BLOCK && first == 0 && ok,
+            "the ten oldest blocks survive intact (%llu pairs)", (unsigned long long) got);
+    tap_ok(st.sample == 9 * BLOCK, "later blocks were the ones lost");
+    sdr_capture_stop(cap);
+}
+
+static void test_counted_loss(void)
+{
+    fprintf(stderr, "counted loss:\n");
+    fake_dev_t f = { .reads_left = 6, .lose_at = 4, .lose_pairs = 250 };
+    sdr_backend_t be = { .ops = &fake_ops, .priv = &f };
+    sdr_capture_t *cap = sdr_capture_start(&be, RATE_HZ, 1.0, BLOCK);
+    if (cap == NULL) {
+        tap_ok(0, "capture thread started");
+        return;
+    }
+    int16_t buf[2 * BLOCK];
+    uint64_t firsts[6];
+    int blocks = 0, ok = 1;
+    ssize_t n;
+    sdr_capture_stamp_t st;
+    while ((n = sdr_capture_read(cap, buf, BLOCK, 1.0, &st)) != -1) {
+        if (n <= 0) continue;
+        if (!pair_ok(buf, st.sample)) ok = 0;
+        if (blocks < 6) firsts[blocks] = st.sample;
+        blocks++;
+    }
+    tap_okf(blocks == 6 && ok, "every block's stamp matches its pairs (%d blocks)", blocks);
+    tap_okf(blocks == 6 && firsts[2] == 2 * BLOCK && firsts[3] == 3 * BLOCK + 250
+            && firsts[5] == 5 * BLOCK + 250,
+            "stamps jump by the 250 lost pairs at the fourth read");
+    sdr_capture_stats_t s;
+    sdr_capture_stats(cap, &s);
+    tap_okf(s.device_overflows == 1 && s.device_lost == 250 && s.samples_in == 6 * BLOCK,
+            "lost pairs totalled apart from those read (%llu)",
+            (unsigned long long) s.device_lost);
+    sdr_capture_stop(cap);
+}
+
+static void test_loss(void)
+{
+    fprintf(stderr, "device loss:\n");
+    fake_dev_t f = { .reads_left = 3 };
+    sdr_backend_t be = { .ops = &fake_ops, .priv = &f };
+    sdr_capture_t *cap = sdr_capture_start(&be, RATE_HZ, 1.0, BLOCK);
+    if (cap == NULL) {
+        tap_ok(0, "capture thread started");
+        return;
+    }
+    int16_t buf[2 * BLOCK];
+    usleep(20000);
+    ssize_t a = sdr_capture_read(cap, buf, BLOCK, 1.0, NULL);
+    ssize_t b = sdr_capture_read(cap, buf, BLOCK, 1.0, NULL);
+    ssize_t c = sdr_capture_read(cap, buf, BLOCK, 1.0, NULL);
+    ssize_t d = sdr_capture_read(cap, buf, BLOCK, 1.0, NULL);
+    tap_ok(a == BLOCK && b == BLOCK && c == BLOCK, "queued blocks drain after the loss");
+    tap_ok(d == -1, "then the loss is reported");
+    sdr_capture_stop(cap);
+}
+
+int main(void)
+{
+    test_stream();
+    test_overflow();
+    test_counted_loss();
+    test_loss();
+    return tap_done();
+}
@@ -0,0 +1,351 @@
+/*
+
+    Simple Satellite Operations  unit_tests/sdr_file_selftest.c
+
+    Tests for src/hw/sdr_file.c -- the file SDR backend, opened through
+    the sdr_backend dispatcher as the live chain opens it.
+
+      - Replay: a .sso-iq and a raw .iq stream back bit-exact at their
+        own rate, loop at the end (or end the stream with once), and
+        stamp each read with its stream time. An unpaced (speed 0)
+        stream says so in its caps.
+      - Explicit only: AUTO never falls back to the file backend.
+      - Synthetic: each burst FM-demodulates and unframes to a CTS1
+        beacon, with the beacon counter advancing burst to burst and
+        silence between.
+      - Shift: the synthetic carrier sits at carrier - LO, follows a
+        retune, and a Doppler ramp moves a replayed tone on schedule.
+      - Noise: the added noise has the requested power.
+      - Pacing: 1x delivers samples at the sample rate, 4x four times
+        faster.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "ax100.h"
+#include "beacon_cts1.h"
+#include "csp.h"
+#include "modem.h"
+#include "sdr_backend.h"
+#include "sso_iq.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RATE  48000.0
+#define NPAIR 30000
+
+static int16_t g_iq[2 * NPAIR];
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static int write_raw(const char *path, const int16_t *iq, size_t n)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return -1;
+    size_t w = fwrite(iq, 2 * sizeof(int16_t), n, f);
+    return fclose(f) == 0 && w == n ? 0 : -1;
+}
+
+static sdr_backend_t *open_file(const sdr_replay_params_t *rp, double freq_hz)
+{
+    sdr_open_params_t p;
+    memset(&p, 0, sizeof p);
+    p.freq_hz              = freq_hz;
+    p.rate_hz              = 480000.0;
+    p.target_post_decim_hz = 96000.0;
+    p.replay               = rp;
+    sdr_backend_t *be = NULL;
+    return sdr_backend_open(SDR_TYPE_FILE, &p, &be) == 0 ? be : NULL;
+}
+
+// Read exactly n pairs (the backend returns at most max_rx_pairs a call).
+static size_t read_n(sdr_backend_t *be, int16_t *out, size_t n)
+{
+    size_t got = 0;
+    while (got < n) {
+        ssize_t r = sdr_backend_read_iq(be, out + 2 * got, n - got);
+        if (r <= 0) break;
+        got += (size_t) r;
+    }
+    return got;
+}
+
+// Mean instantaneous frequency (Hz) over pairs [a, b).
+static double mean_freq(const int16_t *iq, size_t a, size_t b, double rate)
+{
+    double sum = 0.0;
+    for (size_t k = a + 1; k < b; ++k) {
+        double I = iq[2 * k], Q = iq[2 * k + 1];
+        double pI = iq[2 * k - 2], pQ = iq[2 * k - 1];
+        sum += atan2(Q * pI - I * pQ, I * pI + Q * pQ);
+    }
+    return sum / (double) (b - a - 1) * rate / (2.0 * M_PI);
+}
+
+static void test_replay(void)
+{
+    fprintf(stderr, "replay:\n");
+    uint32_t s = 777;
+    for (int i = 0; i < 2 * NPAIR; ++i) {
+        s = s * 1664525u + 1013904223u;
+        g_iq[i] = (int16_t) (s >> 16);
+    }
+    sso_iq_meta_t m;
+    memset(&m, 0, sizeof m);
+    m.sample_rate_hz = RATE;
+    sso_iq_writer_t *w = sso_iq_writer_open(tap_tmpdir_path("rec.sso-iq"), &m);
+    int wrote = w != NULL && sso_iq_writer_write(w, g_iq, NPAIR) == 0;
+    wrote = sso_iq_writer_close(w) == 0 && wrote;
+    wrote = write_raw(tap_tmpdir_path("rec.iq"), g_iq, NPAIR) == 0 && wrote;
+    tap_ok(wrote, "recordings written");
+
+    static int16_t buf[2 * (NPAIR + 1000)];
+    sdr_replay_params_t rp = { .path = tap_tmpdir_path("rec.sso-iq"), .speed = 0.0 };
+    sdr_backend_t *be = open_file(&rp, 436.5e6);
+    tap_ok(be != NULL, "file backend opens a .sso-iq");
+    if (be == NULL) return;
+    const sdr_caps_t *c = sdr_backend_caps(be);
+    tap_okf(c->native_rate_hz == RATE && !c->can_tx && c->unpaced,
+            "native rate from the header (%.0f), RX-only, unpaced", c->native_rate_hz);
+    ssize_t first = sdr_backend_read_iq(be, buf, NPAIR);
+    sdr_rx_meta_t meta;
+    sdr_backend_rx_meta(be, &meta);
+    tap_ok(first > 0 && (size_t) first <= c->max_rx_pairs && meta.has_time
+           && meta.device_time_s == 0.0, "first read stamped at stream time 0");
+    size_t got = (size_t) first + read_n(be, buf + 2 * first, NPAIR + 1000 - (size_t) first);
+    sdr_backend_rx_meta(be, &meta);
+    tap_okf(got == NPAIR + 1000 && memcmp(buf, g_iq, sizeof g_iq) == 0
+            && memcmp(buf + 2 * NPAIR, g_iq, 2000 * sizeof(int16_t)) == 0,
+            "bit-exact, then loops to the start (%zu pairs)", got);
+    tap_ok(meta.device_time_s > 0.0 && meta.device_time_s < (NPAIR + 1000) / RATE,
+           "later reads stamped with their first pair's stream time");
+    sdr_backend_close(be);
+
+    rp.path = tap_tmpdir_path("rec.iq");
+    rp.once = 1;
+    be = open_file(&rp, 436.5e6);
+    tap_ok(be != NULL, "file backend opens a raw .iq");
+    if (be == NULL) return;
+    got = read_n(be, buf, NPAIR + 1000);
+    tap_okf(sdr_backend_caps(be)->native_rate_hz == 96000.0 && got == NPAIR
+            && memcmp(buf, g_iq, sizeof g_iq) == 0,
+            "raw .iq at the post-decim rate, once: the stream ends at EOF (%zu)", got);
+    tap_ok(sdr_backend_read_iq(be, buf, 100) < 0, "and stays ended");
+    sdr_backend_close(be);
+}
+
+static void test_auto(void)
+{
+    fprintf(stderr, "explicit only:\n");
+    sdr_open_params_t p;
+    memset(&p, 0, sizeof p);
+    sdr_backend_t *be = NULL;
+    sdr_backend_type_t t;
+    tap_ok(sdr_backend_type_from_string("file", &t) == 0 && t == SDR_TYPE_FILE,
+           "\"file\" parses");
+    tap_ok(sdr_backend_open(SDR_TYPE_AUTO, &p, &be) != 0 && be == NULL,
+           "auto with no radio does not open the file backend");
+}
+
+// Unframe the burst that starts at pair a of a synthetic stream.
+static int decode_burst(const int16_t *iq, size_t a, size_t n, double rate,
+                        COMMS_beacon_basic_packet_t *out)
+{
+    int16_t *pcm = calloc(n, sizeof *pcm);
+    uint8_t *bits = calloc(n, 1);
+    uint8_t bytes[1024], pkt[512];
+    int ok = -1;
+    if (pcm == NULL || bits == NULL) goto done;
+    for (size_t k = 1; k < n; ++k) {
+        double I = iq[2 * (a + k)], Q = iq[2 * (a + k) + 1];
+        double pI = iq[2 * (a + k) - 2], pQ = iq[2 * (a + k) - 1];
+        pcm[k] = (int16_t) lround(atan2(Q * pI - I * pQ, I * pI + Q * pQ) * 8000.0);
+    }
+    modem_params_t mp;
+    modem_params_defaults(&mp);
+    mp.samp_rate = (int) rate;
+    size_t n_bits = 0, off = 0;
+    if (modem_pcm16_to_bits(pcm, n, &mp, 0, 0, 0, bits, &n_bits, &off, NULL) != 0) goto done;
+    size_t nb = modem_bits_to_bytes(bits, n_bits, bytes);
+    if (nb > sizeof bytes) goto done;
+    ax100_opts_t opts;
+    ax100_opts_defaults(&opts);
+    opts.reed_solomon = 1;
+    ssize_t len = ax100_unframe(bytes, nb, &opts, pkt, sizeof pkt,
+                                NULL, NULL, NULL, NULL, NULL);
+    csp_v1_header_t hdr;
+    if (len != (ssize_t) (4 + sizeof *out) || csp_v1_decode(pkt, &hdr) != 0
+        || hdr.src != CTS1_BEACON_CSP_SRC || hdr.dport != CTS1_BEACON_CSP_DPORT) goto done;
+    memcpy(out, pkt + 4, sizeof *out);
+    ok = 0;
+done:
+    free(pcm);
+    free(bits);
+    return ok;
+}
+
+static void test_synthetic(void)
+{
+    fprintf(stderr, "synthetic:\n");
+    const double rate = 96000.0;
+    const size_t period = 48000;   // 0.5 s
+    sdr_replay_params_t rp = { .speed = 0.0, .rate_hz = rate, .burst_s = 0.5 };
+    sdr_backend_t *be = open_file(&rp, 436.5e6);
+    tap_ok(be != NULL, "synthetic source opens");
+    if (be == NULL) return;
+    tap_okf(sdr_backend_caps(be)->native_rate_hz == rate, "at the requested rate");
+    static int16_t buf[2 * 2 * 48000];
+    size_t got = read_n(be, buf, 2 * period);
+    sdr_backend_close(be);
+
+    // The burst is the frame's bits at 10 samples each; the rest is zero.
+    size_t burst = 0;
+    for (size_t k = 0; k < period; ++k)
+        if (buf[2 * k] != 0 || buf[2 * k + 1] != 0) burst = k + 1;
+    int silent = 1;
+    for (size_t k = burst; k < period; ++k)
+        if (buf[2 * k] != 0 || buf[2 * k + 1] != 0) silent = 0;
+    tap_okf(got == 2 * period && burst > 10000 && burst < period / 2 && silent,
+            "a %zu-pair burst, then silence to the period's end", burst);
+
+    COMMS_beacon_basic_packet_t b0, b1;
+    int d0 = decode_burst(buf, 0, burst, rate, &b0);
+    int d1 = decode_burst(buf, period, burst, rate, &b1);
+    tap_ok(d0 == 0 && b0.packet_type == COMMS_PACKET_TYPE_BEACON_BASIC
+           && memcmp(b0.satellite_name, "CTS1", 4) == 0,
+           "the burst demodulates to a CTS1 basic beacon");
+    tap_okf(d0 == 0 && d1 == 0 && b1.total_beacon_count_since_boot
+                                  == b0.total_beacon_count_since_boot + 1,
+            "the next burst is the next beacon (%u, %u)",
+            (unsigned) b0.total_beacon_count_since_boot,
+            (unsigned) b1.total_beacon_count_since_boot);
+}
+
+static void test_shift(void)
+{
+    fprintf(stderr, "shift:\n");
+    // The 0xAA preamble is a square wave in frequency: its mean is the
+    // carrier. 32 bytes at 10 samples a bit.
+    static int16_t buf[2 * 48000];
+    sdr_replay_params_t rp = { .speed = 0.0, .rate_hz = 96000.0, .burst_s = 0.25,
+                               .carrier_hz = 436.5e6 };
+    sdr_backend_t *be = open_file(&rp, 436.5e6 - 25000.0);
+    if (be == NULL) {
+        tap_ok(0, "synthetic source opens");
+        return;
+    }
+    read_n(be, buf, 24000);
+    double f0 = mean_freq(buf, 0, 2400, 96000.0);
+    sdr_backend_set_freq(be, 436.5e6 - 10000.0);
+    read_n(be, buf, 24000);
+    double f1 = mean_freq(buf, 0, 2400, 96000.0);
+    sdr_backend_close(be);
+    tap_okf(fabs(f0 - 25000.0) < 50.0, "carrier at carrier - LO (%.0f Hz)", f0);
+    tap_okf(fabs(f1 - 10000.0) < 50.0, "a retune moves it (%.0f Hz)", f1);
+
+    // A DC tone replayed with a ramp from +1000 Hz at +500 Hz/s.
+    for (int i = 0; i < NPAIR; ++i) { g_iq[2 * i] = 10000; g_iq[2 * i + 1] = 0; }
+    write_raw(tap_tmpdir_path("tone.iq"), g_iq, NPAIR);
+    sdr_replay_params_t tp = { .path = tap_tmpdir_path("tone.iq"), .speed = 0.0,
+                               .doppler_hz = 1000.0, .doppler_rate_hz_s = 500.0 };
+    be = open_file(&tp, 436.5e6);
+    if (be == NULL) {
+        tap_ok(0, "tone replay opens");
+        return;
+    }
+    static int16_t tone[2 * 96000];
+    read_n(be, tone, 96000);    // 1 s at 96 kHz
+    sdr_backend_close(be);
+    double a = mean_freq(tone, 0, 960, 96000.0);          // t ~ 5 ms
+    double z = mean_freq(tone, 95040, 96000, 96000.0);    // t ~ 995 ms
+    tap_okf(fabs(a - 1002.5) < 5.0 && fabs(z - 1497.5) < 5.0,
+            "Doppler ramp %.1f -> %.1f Hz over 1 s", a, z);
+}
+
+static void test_noise(void)
+{
+    fprintf(stderr, "noise:\n");
+    memset(g_iq, 0, sizeof g_iq);
+    write_raw(tap_tmpdir_path("zero.iq"), g_iq, NPAIR);
+    sdr_replay_params_t rp = { .path = tap_tmpdir_path("zero.iq"), .speed = 0.0,
+                               .noise_dbfs = -20.0 };
+    sdr_backend_t *be = open_file(&rp, 436.5e6);
+    if (be == NULL) {
+        tap_ok(0, "noise replay opens");
+        return;
+    }
+    static int16_t buf[2 * NPAIR];
+    size_t got = read_n(be, buf, NPAIR);
+    sdr_backend_close(be);
+    double p = 0.0, mean = 0.0;
+    for (size_t i = 0; i < 2 * got; ++i) {
+        p += (double) buf[i] * buf[i];
+        mean += buf[i];
+    }
+    double dbfs = 10.0 * log10(p / (double) got / (32767.0 * 32767.0));
+    tap_okf(got == NPAIR && fabs(dbfs + 20.0) < 0.3 && fabs(mean / (2.0 * got)) < 50.0,
+            "noise power %.2f dBFS, zero mean", dbfs);
+}
+
+static void test_pacing(void)
+{
+    fprintf(stderr, "pacing:\n");
+    static int16_t buf[2 * 9600];
+    double took[2];
+    const double speeds[2] = { 1.0, 4.0 };
+    for (int i = 0; i < 2; ++i) {
+        sdr_replay_params_t rp = { .path = tap_tmpdir_path("zero.iq"), .speed = speeds[i] };
+        sdr_backend_t *be = open_file(&rp, 436.5e6);
+        took[i] = -1.0;
+        if (be == NULL) continue;
+        if (sdr_backend_caps(be)->unpaced) { sdr_backend_close(be); continue; }
+        double t0 = now_s();
+        size_t got = read_n(be, buf, 9600);      // 0.1 s at 96 kHz
+        took[i] = got == 9600 ? now_s() - t0 : -1.0;
+        sdr_backend_close(be);
+    }
+    tap_okf(took[0] >= 0.095 && took[0] < 0.2, "1x: 0.1 s of samples in %.3f s", took[0]);
+    tap_okf(took[1] >= 0.024 && took[1] < 0.1, "4x: in %.3f s", took[1]);
+}
+
+int main(void)
+{
+    if (tap_tmpdir_make("sdr_file") != 0) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    test_replay();
+    test_auto();
+    test_synthetic();
+    test_shift();
+    test_noise();
+    test_pacing();
+
+    tap_tmpdir_remove();
+    return tap_done();
+}
@@ -182,6 +182,10 @@ int main(void)
         memcpy(e.rx_ribbon, ".-.-", 5);  // includes the nul
         e.rx_ribbon_peak[0] = -90; e.rx_ribbon_peak[1] = -30;
         e.rx_ribbon_peak[2] = 0;   e.rx_ribbon_peak[3] = 12;
+        e.rx_bk_active = 1; e.rx_bk_file = 2; e.rx_bk_eof = 1;
+        e.rx_bk_present = 39000; e.rx_bk_extent = 40004; e.rx_bk_gaps = 2;
+        e.rx_bk_rate = 812.5;
+        snprintf(e.rx_bk_missing, sizeof e.rx_bk_missing, "390+195 5850+390");
 
         sso_event_t d;
         tap_ok(sso_event_encode(&e, line, sizeof line) == 0, "encode STATE+rx returns 0");
@@ -201,6 +205,12 @@ int main(void)
         tap_ok(d.rx_ribbon_peak[0] == -90 && d.rx_ribbon_peak[1] == -30
                && d.rx_ribbon_peak[2] == 0 && d.rx_ribbon_peak[3] == 12,
                "ribbon negative peak dBFS preserved (two's-complement hex)");
+        tap_ok(d.rx_bk_active && d.rx_bk_file == 2 && d.rx_bk_eof
+               && d.rx_bk_present == 39000 && d.rx_bk_extent == 40004
+               && d.rx_bk_gaps == 2 && d.rx_bk_conflicts == 0
+               && deq(d.rx_bk_rate, 812.5), "live bulk coverage preserved");
+        tap_ok(strcmp(d.rx_bk_missing, "390+195 5850+390") == 0,
+               "live bulk missing ranges preserved");
     }
 
     // --- TX event round-trip ------------------------------------------
@@ -0,0 +1,295 @@
+/*
+
+    Simple Satellite Operations  unit_tests/sso_iq_selftest.c
+
+    Tests for src/pipeline/sso_iq.c -- the .sso-iq recording container
+    and the shared IQ reader.
+
+      - Round trip: noise plus a tone, a full-scale step and a short tail
+        block come back bit-exact, in less space than raw int16.
+      - Shift: meta.shift = 4 keeps the top 12 bits of every sample.
+      - Damage: with the index stripped the blocks are found by scanning,
+        and a torn last block is dropped.
+      - Seek: by pair and by time (on a clock that drifts from the
+        nominal rate), with the block stamps and Doppler read back.
+      - Raw: a headerless .iq reads through the same API.
+      - Live: a growing file is picked up block by block on refresh.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "sso_iq.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RATE  48000.0
+#define NPAIR 100000   // four 0.5 s blocks and a 4000-pair tail
+
+static int16_t g_iq[2 * NPAIR];
+
+static long fsize(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? (long) st.st_size : -1;
+}
+
+static void make_signal(void)
+{
+    uint32_t s = 12345;
+    for (int i = 0; i < NPAIR; ++i) {
+        double ph = 2.0 * M_PI * 1234.5 * i / RATE;
+        for (int c = 0; c < 2; ++c) {
+            s = s * 1664525u + 1013904223u;
+            double v = 6000.0 * (c ? sin(ph) : cos(ph)) + (double) ((int) (s >> 22) - 512);
+            g_iq[2 * i + c] = (int16_t) v;
+        }
+    }
+    // Full-scale edges exercise the escape path.
+    for (int i = 30000; i < 30010; ++i) {
+        g_iq[2 * i]     = (i & 1) ? 32767 : -32768;
+        g_iq[2 * i + 1] = (i & 1) ? -32768 : 32767;
+    }
+}
+
+static sso_iq_meta_t meta_of(double start, int shift)
+{
+    sso_iq_meta_t m;
+    memset(&m, 0, sizeof m);
+    m.sample_rate_hz = RATE;
+    m.center_freq_hz = 436.5e6;
+    m.lo_offset_hz   = -25e3;
+    m.start_unix_s   = start;
+    m.shift          = shift;
+    snprintf(m.pass_id, sizeof m.pass_id, "SAT-1_20260101T000000");
+    snprintf(m.source, sizeof m.source, "sso_iq_selftest");
+    return m;
+}
+
+// Write g_iq in uneven chunks, stamping each with a clock that runs
+// 100 ppm fast and a Doppler ramp.
+static int write_file(const char *path, int shift)
+{
+    sso_iq_meta_t m = meta_of(1.7e9, shift);
+    sso_iq_writer_t *w = sso_iq_writer_open(path, &m);
+    if (w == NULL) return -1;
+    size_t at = 0;
+    for (int k = 0; at < NPAIR; ++k) {
+        size_t n = 1000 + (size_t) (k * 7919) % 9000;
+        if (n > NPAIR - at) n = NPAIR - at;
+        sso_iq_writer_set_time(w, 1.7e9 + at / RATE * 1.0001, -100.0 * (double) at / RATE);
+        if (sso_iq_writer_write(w, g_iq + 2 * at, n) != 0) break;
+        at += n;
+    }
+    return sso_iq_writer_close(w);
+}
+
+static void test_round_trip(void)
+{
+    fprintf(stderr, "round trip:\n");
+    const char *p = tap_tmpdir_path("rt.sso-iq");
+    tap_ok(write_file(p, 0) == 0, "writer closes cleanly");
+    size_t n = 0;
+    sso_iq_meta_t m;
+    int16_t *got = sso_iq_load(p, &n, &m);
+    tap_ok(got != NULL && n == NPAIR && memcmp(got, g_iq, sizeof g_iq) == 0,
+           "samples bit-exact");
+    tap_ok(m.sample_rate_hz == RATE && m.center_freq_hz == 436.5e6 && m.lo_offset_hz == -25e3
+           && strcmp(m.pass_id, "SAT-1_20260101T000000") == 0
+           && fabs(m.block_s - 0.5) < 1e-12, "metadata carried in the header");
+    tap_okf(fsize(p) < (long) sizeof g_iq * 3 / 4, "%ld bytes vs %zu raw", fsize(p), sizeof g_iq);
+    free(got);
+}
+
+static void test_shift(void)
+{
+    fprintf(stderr, "shift:\n");
+    const char *p = tap_tmpdir_path("sh.sso-iq");
+    tap_ok(write_file(p, 4) == 0, "shifted file written");
+    size_t n = 0;
+    int16_t *got = sso_iq_load(p, &n, NULL);
+    int ok = got != NULL && n == NPAIR;
+    for (size_t i = 0; ok && i < 2 * NPAIR; ++i) ok = got[i] == (int16_t) ((g_iq[i] >> 4) * 16);
+    tap_okf(ok, "top 12 bits kept, %ld bytes", fsize(p));
+    free(got);
+}
+
+static void test_damage(void)
+{
+    fprintf(stderr, "damage:\n");
+    const char *src = tap_tmpdir_path("rt.sso-iq");
+    const char *dst = tap_tmpdir_path("cut.sso-iq");
+    long full = fsize(src);
+    FILE *in = fopen(src, "rb");
+    uint8_t *buf = malloc((size_t) full);
+    if (in == NULL || buf == NULL || fread(buf, 1, (size_t) full, in) != (size_t) full) {
+        tap_ok(0, "read source");
+        if (in) fclose(in);
+        free(buf);
+        return;
+    }
+    fclose(in);
+    // Index offset from the footer: everything before it is blocks.
+    uint64_t idx = 0;
+    for (int i = 7; i >= 0; --i) idx = idx << 8 | buf[full - 16 + i];
+
+    FILE *out = fopen(dst, "wb");
+    fwrite(buf, 1, (size_t) idx, out);
+    fclose(out);
+    sso_iq_reader_t *r = sso_iq_open(dst);
+    tap_ok(r != NULL && sso_iq_pairs(r) == NPAIR, "no index: all blocks found by scanning");
+    sso_iq_close(r);
+
+    out = fopen(dst, "wb");
+    fwrite(buf, 1, (size_t) idx - 100, out);
+    fclose(out);
+    size_t n = 0;
+    int16_t *got = sso_iq_load(dst, &n, NULL);
+    tap_okf(got != NULL && n == 96000 && memcmp(got, g_iq, n * 4) == 0,
+            "torn tail block dropped, %zu pairs kept", n);
+    free(got);
+
+    buf[idx - 50] ^= 0x5a;   // inside the last payload, index intact
+    out = fopen(dst, "wb");
+    fwrite(buf, 1, (size_t) full, out);
+    fclose(out);
+    r = sso_iq_open(dst);
+    int16_t tmp[2 * 100];
+    int ok = r != NULL && sso_iq_seek_pair(r, 50) == 0 && sso_iq_read(r, tmp, 100) == 100;
+    ok = ok && sso_iq_seek_pair(r, NPAIR - 10) == 0 && sso_iq_read(r, tmp, 10) < 0;
+    tap_ok(ok, "corrupt payload fails its CRC on read, other blocks fine");
+    sso_iq_close(r);
+    free(buf);
+}
+
+static void test_seek(void)
+{
+    fprintf(stderr, "seek:\n");
+    sso_iq_reader_t *r = sso_iq_open(tap_tmpdir_path("rt.sso-iq"));
+    if (r == NULL) {
+        tap_ok(0, "open");
+        return;
+    }
+    int16_t tmp[2 * 5000];
+    int ok = sso_iq_seek_pair(r, 23999) == 0 && sso_iq_read(r, tmp, 5000) == 5000
+          && memcmp(tmp, g_iq + 2 * 23999, 5000 * 4) == 0 && sso_iq_tell(r) == 28999;
+    tap_ok(ok, "seek by pair, read across a block edge");
+
+    // The stamps run 100 ppm fast, so t = start + 1.5 s sits a little
+    // before pair 72000.
+    double t = 1.7e9 + 1.5;
+    ok = sso_iq_seek_time(r, t) == 0;
+    uint64_t p = sso_iq_tell(r);
+    double at = 0.0, dop = 0.0;
+    ok = ok && sso_iq_stamp(r, p, &at, &dop) == 0;
+    tap_okf(ok && fabs(at - t) < 1.5 / RATE && p < 72000 && p > 71980,
+            "seek by time lands on pair %llu", (unsigned long long) p);
+    // Block 2 starts at pair 48000, inside a chunk of at most 10000 pairs
+    // whose set_time carried the Doppler.
+    tap_okf(fabs(dop + 100.0 * 48000 / RATE) < 100.0 * 10000 / RATE,
+            "Doppler stamp %.1f Hz follows the ramp", dop);
+    tap_ok(sso_iq_seek_time(r, 1.7e9 + 10.0) < 0 && sso_iq_seek_pair(r, NPAIR + 1) < 0,
+           "seeks past the end refused");
+    sso_iq_close(r);
+}
+
+static void test_raw(void)
+{
+    fprintf(stderr, "raw:\n");
+    const char *p = tap_tmpdir_path("legacy.iq");
+    FILE *f = fopen(p, "wb");
+    fwrite(g_iq, 4, 3000, f);
+    fclose(f);
+    sso_iq_reader_t *r = sso_iq_open(p);
+    int16_t tmp[2 * 1000];
+    int ok = r != NULL && !sso_iq_is_container(r) && sso_iq_pairs(r) == 3000
+          && sso_iq_meta(r)->sample_rate_hz == 0.0
+          && sso_iq_seek_pair(r, 1500) == 0 && sso_iq_read(r, tmp, 1000) == 1000
+          && memcmp(tmp, g_iq + 3000, 4000) == 0;
+    tap_ok(ok, "headerless int16 read and seeked");
+    tap_ok(r != NULL && sso_iq_stamp(r, 0, NULL, NULL) < 0 && sso_iq_seek_time(r, 1.0) < 0,
+           "no time base on a raw file");
+    sso_iq_close(r);
+    tap_ok(sso_iq_path_is_iq("a/b.sso-iq") && sso_iq_path_is_iq("x.iq")
+           && !sso_iq_path_is_iq("x.wav") && !sso_iq_path_is_iq(".iq"),
+           "recording names recognised");
+}
+
+typedef struct {
+    FILE *fp;
+} live_ctx_t;
+
+static int live_sink(void *ctx, const void *data, size_t len)
+{
+    live_ctx_t *c = ctx;
+    int rc = fwrite(data, 1, len, c->fp) == len ? 0 : -1;
+    fflush(c->fp);
+    return rc;
+}
+
+static void test_live(void)
+{
+    fprintf(stderr, "live:\n");
+    const char *p = tap_tmpdir_path("live.sso-iq");
+    live_ctx_t c = { fopen(p, "wb") };
+    sso_iq_meta_t m = meta_of(0.0, 0);
+    sso_iq_writer_t *w = sso_iq_writer_new(&m, live_sink, &c);
+    sso_iq_reader_t *r = sso_iq_open(p);
+    tap_ok(w != NULL && r != NULL && sso_iq_is_container(r) && sso_iq_pairs(r) == 0,
+           "reader opens a file with only its header");
+    if (w == NULL || r == NULL) return;
+
+    sso_iq_writer_write(w, g_iq, 30000);
+    long long n1 = sso_iq_refresh(r);
+    sso_iq_writer_write(w, g_iq + 2 * 30000, 30000);
+    long long n2 = sso_iq_refresh(r);
+    tap_okf(n1 == 24000 && n2 == 24000, "whole blocks appear as they are written (%lld, %lld)",
+            n1, n2);
+    sso_iq_writer_close(w);
+    fclose(c.fp);
+    long long n3 = sso_iq_refresh(r);
+    int16_t *got = malloc(60000 * 4);
+    int ok = n3 == 12000 && sso_iq_pairs(r) == 60000
+          && sso_iq_read(r, got, 60000) == 60000 && memcmp(got, g_iq, 60000 * 4) == 0;
+    tap_ok(ok, "tail block and index picked up after close");
+    tap_ok(sso_iq_refresh(r) == 0, "refresh after the footer finds nothing new");
+    free(got);
+    sso_iq_close(r);
+}
+
+int main(void)
+{
+    if (tap_tmpdir_make("sso_iq") != 0) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    make_signal();
+    test_round_trip();
+    test_shift();
+    test_damage();
+    test_seek();
+    test_raw();
+    test_live();
+
+    tap_tmpdir_remove();
+    return tap_done();
+}
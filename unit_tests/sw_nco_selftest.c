@@ -21,6 +21,9 @@
       - Set-freq mid-stream: with a step in frequency, the phase
         accumulator stays continuous (no audible click). Verified by
         the residual carrier never excursing past a bounded delta.
+      - Trajectory ramp: a chirping carrier, corrected chunk-by-chunk by
+        a linear ramp between sw_nco_track_eval samples, lands at DC in
+        every chunk.
 
     Exit status: 0 if all TAP assertions ok, non-zero otherwise.
 
@@ -273,6 +276,79 @@ static void test_phase_wrap_stays_bounded(void)
             "(phase=%.6f rad after 1000 chunks)", nco.phase_rad);
 }
 
+// ------------------------------------------------------------------
+// 6. Trajectory-driven linear ramp tracks a chirping carrier.
+// ------------------------------------------------------------------
+
+static void test_track_ramp_follows_chirp(void)
+{
+    // A carrier sweeping at rate r (Hz/s) — an exaggerated high-pass
+    // Doppler rate — sampled into a coarse trajectory and applied per
+    // chunk as a ramp between the trajectory values at the chunk edges.
+    // Every chunk should land at DC. The step-per-chunk alternative
+    // (set_freq at the chunk start) leaves each chunk off by ~r·T/2.
+    const double fs = 96000.0;
+    const double fa = 3000.0;
+    const double r  = 2000.0;
+    const size_t n  = 96000;
+    const size_t chunk = 4800;  // 50 ms
+    int16_t *iq   = (int16_t *) malloc(n * 2 * sizeof(int16_t));
+    int16_t *step = (int16_t *) malloc(n * 2 * sizeof(int16_t));
+    if (!iq || !step) { tap_bail("oom"); free(iq); free(step); return; }
+    for (size_t i = 0; i < n; ++i) {
+        double t = (double) i / fs;
+        double ph = 2.0 * M_PI * (fa * t + 0.5 * r * t * t);
+        iq[i * 2 + 0] = (int16_t) (16000.0 * cos(ph));
+        iq[i * 2 + 1] = (int16_t) (16000.0 * sin(ph));
+    }
+    memcpy(step, iq, n * 2 * sizeof(int16_t));
+
+    double tab[11];
+    for (int k = 0; k <= 10; ++k) tab[k] = fa + r * 0.1 * k;
+    sw_nco_track_t *trk = sw_nco_track_new(0.0, 0.1, tab, 11);
+    if (trk == NULL) { tap_bail("oom"); free(iq); free(step); return; }
+
+    double f = 0.0;
+    tap_ok(sw_nco_track_eval(trk, 0.25, &f) == 0 && fabs(f - 3500.0) < 1e-9,
+           "track: interpolates between samples");
+    tap_ok(sw_nco_track_eval(trk, 1.0, &f) == 0 && fabs(f - 5000.0) < 1e-9,
+           "track: last sample is inside");
+    tap_ok(sw_nco_track_eval(trk, -0.01, &f) != 0
+           && sw_nco_track_eval(trk, 1.01, &f) != 0,
+           "track: outside the window reports -1");
+
+    sw_nco_t ramp_nco, step_nco;
+    sw_nco_init(&ramp_nco, fs);
+    sw_nco_init(&step_nco, fs);
+    double worst_ramp = 0.0, best_step = 1e9;
+    for (size_t i0 = 0; i0 < n; i0 += chunk) {
+        double t0 = (double) i0 / fs;
+        double t1 = (double) (i0 + chunk) / fs;
+        double f0 = 0.0, f1 = 0.0;
+        sw_nco_track_eval(trk, t0, &f0);
+        sw_nco_track_eval(trk, t1, &f1);
+        sw_nco_set_freq(&ramp_nco, f0);
+        sw_nco_apply_ramp(&ramp_nco, iq + i0 * 2, chunk, f1);
+        sw_nco_set_freq(&step_nco, f0);
+        sw_nco_apply(&step_nco, step + i0 * 2, chunk);
+        double rr = fabs(estimate_residual_hz(iq + i0 * 2, chunk, fs, 16));
+        double rs = fabs(estimate_residual_hz(step + i0 * 2, chunk, fs, 16));
+        if (rr > worst_ramp) worst_ramp = rr;
+        if (rs < best_step)  best_step  = rs;
+    }
+    tap_okf(worst_ramp < 0.5,
+            "ramp: every chunk of a %.0f Hz/s chirp lands at DC "
+            "(worst residual %.3f Hz)", r, worst_ramp);
+    tap_okf(best_step > 10.0,
+            "step-per-chunk leaves a residual the ramp removes "
+            "(best %.1f Hz)", best_step);
+    tap_okf(fabs(sw_nco_get_freq(&ramp_nco) - 5000.0) < 1e-9,
+            "ramp: NCO left at the trajectory end frequency");
+    sw_nco_track_free(trk);
+    free(iq);
+    free(step);
+}
+
 int main(void)
 {
     test_zero_freq_passthrough();
@@ -280,5 +356,6 @@ int main(void)
     test_phase_continuity_across_chunks();
     test_freq_step_phase_continuous();
     test_phase_wrap_stays_bounded();
+    test_track_ramp_follows_chirp();
     return tap_done();
 }
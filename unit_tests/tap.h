@@ -23,6 +23,10 @@
     Single-TU usage only — the helpers are `static`, so every selftest
     binary gets its own counters with no link conflicts.
 
+    Selftests that write files use the scratch-directory helpers at the
+    bottom: tap_tmpdir_make() once in main(), tap_tmpdir_path(name) for
+    every file, tap_tmpdir_remove() before tap_done().
+
     Copyright (C) 2026  Johnathan K Burchill
 
     This program is free software: you can redistribute it and/or modify
@@ -39,8 +43,13 @@
 #ifndef SSO_UNIT_TESTS_TAP_H
 #define SSO_UNIT_TESTS_TAP_H
 
+#include <dirent.h>
+#include <errno.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 static int tap_seq  = 0;
 static int tap_fail = 0;
@@ -100,4 +109,84 @@ static int tap_done(void)
     return tap_fail ? 1 : 0;
 }
 
+// Scratch directory: a fresh mkdtemp() directory under $TMPDIR (or /tmp).
+// tap_tmpdir_path() hands out "<dir>/<name>" from a small ring of
+// buffers, so a few paths can be live at once, and remembers the name.
+// tap_tmpdir_remove() unlinks the remembered names, newest first, then
+// rmdir()s the directory. A name that turns out to be a subdirectory
+// (one the code under test fills with files named for it, like the TLE
+// cache) has its plain files unlinked and is rmdir()ed; nothing deeper
+// is touched. Whatever is left keeps the directory, and is reported.
+#define TAP_TMPDIR_NAMES 32
+
+static struct {
+    char dir[256];
+    char names[TAP_TMPDIR_NAMES][64];
+    int  n;
+} tap_tmpdir;
+
+__attribute__((unused))
+static int tap_tmpdir_make(const char *tag)
+{
+    const char *tmp = getenv("TMPDIR");
+    snprintf(tap_tmpdir.dir, sizeof tap_tmpdir.dir, "%s/%s_XXXXXX",
+             tmp && tmp[0] ? tmp : "/tmp", tag);
+    tap_tmpdir.n = 0;
+    return mkdtemp(tap_tmpdir.dir) != NULL ? 0 : -1;
+}
+
+__attribute__((unused))
+static const char *tap_tmpdir_path(const char *name)
+{
+    static char path[8][512];
+    static int k = 0;
+    int known = 0;
+    for (int i = 0; i < tap_tmpdir.n && !known; i++)
+        known = strcmp(tap_tmpdir.names[i], name) == 0;
+    if (!known && tap_tmpdir.n < TAP_TMPDIR_NAMES)
+        snprintf(tap_tmpdir.names[tap_tmpdir.n++], sizeof tap_tmpdir.names[0],
+                 "%s", name);
+    char *p = path[k++ % 8];
+    snprintf(p, sizeof path[0], "%s/%s", tap_tmpdir.dir, name);
+    return p;
+}
+
+// Empty one level of `dir` (plain files only) and remove it.
+__attribute__((unused))
+static int tap_tmpdir_rmdir_flat(const char *dir)
+{
+    DIR *d = opendir(dir);
+    if (d != NULL) {
+        char p[800];
+        for (struct dirent *e; (e = readdir(d)) != NULL; ) {
+            if (strcmp(e->d_name, ".") == 0 || strcmp(e->d_name, "..") == 0)
+                continue;
+            snprintf(p, sizeof p, "%s/%s", dir, e->d_name);
+            (void) unlink(p);
+        }
+        closedir(d);
+    }
+    return rmdir(dir);
+}
+
+__attribute__((unused))
+static int tap_tmpdir_remove(void)
+{
+    if (tap_tmpdir.dir[0] == '\0') return 0;
+    char p[512];
+    for (int i = tap_tmpdir.n - 1; i >= 0; i--) {
+        snprintf(p, sizeof p, "%s/%s", tap_tmpdir.dir, tap_tmpdir.names[i]);
+        if (unlink(p) != 0 && (errno == EISDIR || errno == EPERM))
+            (void) tap_tmpdir_rmdir_flat(p);
+    }
+    tap_tmpdir.n = 0;
+    if (rmdir(tap_tmpdir.dir) != 0) {
+        fprintf(stderr, "could not remove %s: %s\n", tap_tmpdir.dir,
+                strerror(errno));
+        return -1;
+    }
+    tap_tmpdir.dir[0] = '\0';
+    return 0;
+}
+
 #endif
@@ -0,0 +1,242 @@
+/*
+
+    Simple Satellite Operations  unit_tests/tle_catalog_selftest.c
+
+    Tests for src/orbit/tle_catalog.c -- the compiled, mmap'd TLE catalog
+    load_tle / find_passes read through.
+
+      - Decode: each record matches Good_Elements + Convert_Satellite_Data
+        (+ select_ephemeris) run on the text by hand, bit for bit, with the
+        deep-space choice recorded; a malformed group is kept, flagged bad.
+      - Lookup: name prefixes resolve to the earliest group in file order,
+        NORAD ids through the hash, misses return -1.
+      - Cache: a touched-but-unchanged source is served from the cache file
+        after a hash check; changed content or size recompiles.
+      - Irregular files are flagged so callers keep their own line scan.
+      - CSV: a converted Celestrak CSV's catalog is found again by the CSV.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tap.h"
+#include "tle_catalog.h"
+#include "tle_csv.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define AO7_L1  "1 07530U 74089B   25043.01160017 -.00000030  00000+0  10217-3 0  9990"
+#define AO7_L2  "2 07530 101.9936  46.0237 0012129 347.8272  22.1887 12.53686098299338"
+#define FS_L1   "1 69015U 26100AM  26178.44954691  .00009529  00000-0  42160-3 0  9997"
+#define FS_L2   "2 69015  97.4002  76.1415 0008606  21.7363 338.4236 15.21853485  8381"
+#define SM_L1   "1 61049U 24163E   26178.48346241  .00014240  00000-0  65032-3 0  9992"
+#define SM_L2   "2 61049  52.9683 261.5812 0008657 170.3223 189.7940 15.20818387 99339"
+
+// AO-7's line 2 with a 12-hour mean motion, checksum recomputed.
+static const char *deep_line2(void)
+{
+    static char l2[70];
+    snprintf(l2, sizeof l2, "%s", AO7_L2);
+    memcpy(l2 + 52, " 2.00563574", 11);
+    int sum = 0;
+    for (int i = 0; i < 68; ++i) {
+        if (l2[i] >= '0' && l2[i] <= '9') sum += l2[i] - '0';
+        else if (l2[i] == '-')            sum += 1;
+    }
+    l2[68] = (char) ('0' + sum % 10);
+    return l2;
+}
+
+static const char *write_file(const char *name, const char *content)
+{
+    const char *p = tap_tmpdir_path(name);
+    FILE *f = fopen(p, "w");
+    if (f == NULL) return NULL;
+    fputs(content, f);
+    fclose(f);
+    return p;
+}
+
+// Push the mtime forward so the cache sees the file as touched.
+static void touch_later(const char *path, int dt)
+{
+    struct stat st;
+    stat(path, &st);
+    struct timeval tv[2] = { { st.st_atime + dt, 0 }, { st.st_mtime + dt, 0 } };
+    utimes(path, tv);
+}
+
+static int count_cache_files(void)
+{
+    DIR *d = opendir(tap_tmpdir_path("cache"));
+    if (d == NULL) return 0;
+    int n = 0;
+    for (struct dirent *e; (e = readdir(d)) != NULL; ) {
+        size_t len = strlen(e->d_name);
+        if (len > 5 && strcmp(e->d_name + len - 5, ".tlec") == 0) n++;
+    }
+    closedir(d);
+    return n;
+}
+
+static char g_catalog[2048];
+
+static void test_decode(void)
+{
+    fprintf(stderr, "decode:\n");
+    char bad_l2[] = AO7_L2;
+    bad_l2[68] = bad_l2[68] == '0' ? '1' : '0';    // break the checksum
+    snprintf(g_catalog, sizeof g_catalog,
+             "OSCAR 7 (AO-7)\n%s\n%s\n"
+             "FrontierSat\r\n%s\r\n%s\r\n"
+             "BROKEN\n%s\n%s\n"
+             "DEEP TEST\n%s\n%s\n"
+             "SPACEMOBILE-004\n%s\n%s\n",
+             AO7_L1, AO7_L2, FS_L1, FS_L2, AO7_L1, bad_l2,
+             AO7_L1, deep_line2(), SM_L1, SM_L2);
+    const char *path = write_file("cat.tle", g_catalog);
+    const tle_catalog_t *c = tle_catalog_get(path);
+    tap_ok(c != NULL, "catalog compiled");
+    if (c == NULL) return;
+    tap_okf(tle_catalog_count(c) == 5 && tle_catalog_bad(c) == 1,
+            "five groups, one bad (%zu, %zu)", tle_catalog_count(c), tle_catalog_bad(c));
+    tap_ok(tle_catalog_regular(c), "3-line file is regular");
+    tap_ok(!tle_catalog_from_cache(c), "first open compiles");
+    tap_ok(count_cache_files() == 1, "cache file written");
+
+    // The same decode load_tle / find_passes do on the text.
+    char set[139];
+    memset(set, 0, sizeof set);
+    memcpy(set, FS_L1, 69);
+    memcpy(set + 69, FS_L2, 69);
+    tle_t want;
+    memset(&want, 0, sizeof want);
+    snprintf(want.sat_name, sizeof want.sat_name, "%s", "FrontierSat");
+    Convert_Satellite_Data(set, &want);
+    const tle_catalog_rec_t *r = tle_catalog_rec(c, 1);
+    tap_ok(r->good && memcmp(&r->tle, &want, sizeof want) == 0,
+           "elements identical to Convert_Satellite_Data");
+    tap_ok(strcmp(r->name, "FrontierSat") == 0 && strcmp(r->line1, FS_L1) == 0,
+           "name and lines kept, CR/LF trimmed");
+    SetFlag(DEEP_SPACE_EPHEM_FLAG);
+    select_ephemeris(&want);
+    tap_ok(memcmp(&r->ephem, &want, sizeof want) == 0 && !r->deep_space,
+           "select_ephemeris applied, near-earth");
+    tap_ok(tle_catalog_rec(c, 3)->deep_space, "12-hour orbit marked deep space");
+    tap_ok(!tle_catalog_rec(c, 2)->good && strcmp(tle_catalog_rec(c, 2)->name, "BROKEN") == 0,
+           "malformed group kept in place, flagged");
+}
+
+static void test_lookup(void)
+{
+    fprintf(stderr, "lookup:\n");
+    const tle_catalog_t *c = tle_catalog_get(write_file("cat.tle", g_catalog));
+    if (c == NULL) return;
+    tap_ok(tle_catalog_first_prefix(c, "Frontier") == 1, "prefix finds FrontierSat");
+    tap_ok(tle_catalog_first_prefix(c, "") == 0, "empty prefix is the first group");
+    tap_ok(tle_catalog_first_prefix(c, "frontier") == -1, "prefix is case-sensitive");
+    tap_ok(tle_catalog_first_prefix(c, "ZZZ") == -1, "miss returns -1");
+    size_t first = 0;
+    size_t n = tle_catalog_prefix(c, "S", &first);
+    tap_ok(n == 1 && tle_catalog_by_name(c, first) == 4, "sorted index walk");
+    tap_ok(tle_catalog_find_norad(c, 61049) == 4, "NORAD id via the hash");
+    tap_ok(tle_catalog_find_norad(c, 7530) == 0, "duplicate id gives the earliest good group");
+    tap_ok(tle_catalog_find_norad(c, 12345) == -1, "unknown NORAD id");
+}
+
+static void test_cache(void)
+{
+    fprintf(stderr, "cache:\n");
+    const char *path = write_file("cat.tle", g_catalog);
+    // write_file rewrote identical bytes; push the mtime so it differs.
+    touch_later(path, 10);
+    const tle_catalog_t *c = tle_catalog_get(path);
+    tap_ok(c != NULL && tle_catalog_from_cache(c), "touched, same bytes: mapped from cache");
+    tap_ok(c != NULL && tle_catalog_get(path) == c, "second open reuses the mapping");
+
+    // Same size, different content.
+    char *changed = strdup(g_catalog);
+    memcpy(strstr(changed, "DEEP TEST"), "DEEP TES2", 9);
+    write_file("cat.tle", changed);
+    touch_later(path, 20);
+    c = tle_catalog_get(path);
+    tap_ok(c != NULL && !tle_catalog_from_cache(c)
+           && strcmp(tle_catalog_rec(c, 3)->name, "DEEP TES2") == 0,
+           "changed content recompiles");
+    free(changed);
+
+    char grown[2200];
+    snprintf(grown, sizeof grown, "%sEXTRA\n%s\n%s\n", g_catalog, FS_L1, FS_L2);
+    write_file("cat.tle", grown);
+    c = tle_catalog_get(path);
+    tap_ok(c != NULL && tle_catalog_count(c) == 6, "grown file recompiles");
+    tap_ok(count_cache_files() == 1, "one cache file per source");
+}
+
+static void test_irregular(void)
+{
+    fprintf(stderr, "irregular:\n");
+    char text[512];
+    snprintf(text, sizeof text, "%s\n%s\n\nFrontierSat\n%s\n%s\n", AO7_L1, AO7_L2, FS_L1, FS_L2);
+    const tle_catalog_t *c = tle_catalog_get(write_file("bare.tle", text));
+    tap_ok(c != NULL && !tle_catalog_regular(c), "2-line file flagged irregular");
+}
+
+static void test_csv(void)
+{
+    fprintf(stderr, "csv:\n");
+    const char *csv = write_file("sats.csv",
+        "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,"
+        "RA_OF_ASC_NODE,ARG_OF_PERICENTER,MEAN_ANOMALY,EPHEMERIS_TYPE,"
+        "CLASSIFICATION_TYPE,NORAD_CAT_ID,ELEMENT_SET_NO,REV_AT_EPOCH,"
+        "BSTAR,MEAN_MOTION_DOT,MEAN_MOTION_DDOT\n"
+        "TEST SAT,2024-001A,2024-01-15T12:00:00.000000,15.50312345,"
+        "0.0001234,51.6432,123.4567,234.5678,345.6789,0,U,"
+        "99999,123,1234,0.00001234,-.00000123,0.0\n");
+    tap_ok(tle_catalog_get_derived(csv) == NULL, "nothing cached before the first convert");
+    const char *tle = tle_path_resolve(csv);
+    const tle_catalog_t *c = tle_catalog_get(tle);
+    tap_ok(c != NULL && tle_catalog_count(c) == 1
+           && strncmp(tle_catalog_rec(c, 0)->name, "TEST SAT", 8) == 0,
+           "converted tempfile compiles");
+    const tle_catalog_t *d = tle_catalog_get_derived(csv);
+    tap_ok(d != NULL && tle_catalog_from_cache(d) && tle_catalog_count(d) == 1
+           && tle_catalog_find_norad(d, 99999) == 0,
+           "next run finds it by the CSV");
+}
+
+int main(void)
+{
+    if (tap_tmpdir_make("sso_tlecat") != 0) {
+        perror("mkdtemp");
+        return 1;
+    }
+    setenv("SSO_TLE_CACHE_DIR", tap_tmpdir_path("cache"), 1);
+
+    test_decode();
+    test_lookup();
+    test_cache();
+    test_irregular();
+    test_csv();
+
+    tap_tmpdir_remove();
+    return tap_done();
+}
@@ -0,0 +1,213 @@
+/*
+
+    Simple Satellite Operations  unit_tests/tracking_selftest.c
+
+    Coverage for the pass-table / Doppler-trajectory handoff in
+    src/control/tracking.c. While a pass is tracked the RX worker ramps
+    its NCO along a trajectory sampled from the tracked prediction's pass
+    table; main.c re-sends that trajectory whenever
+    track.doppler_track_stale is set. If the table is dropped without the
+    flag, the worker keeps following a curve that no longer matches the
+    target -- after a :retarget, the old satellite's.
+
+    The rest of tracking.c reaches into the rotator worker, the command
+    line, the sky scan, the audit log and the pass panel; none of that is
+    under test, so those entry points are stubbed below and the linker
+    resolves tracking.c against them.
+
+    What's covered:
+      - building the pass table flags the trajectory stale and yields a
+        non-empty tracking_doppler_trajectory.
+      - retarget_to_tle mid-pass drops the table, flags the trajectory
+        stale, and the trajectory main.c would then send is empty.
+      - past LOS the trajectory is flagged stale when a table is dropped,
+        and not on later ticks with no table left (main.c would otherwise
+        re-send an empty trajectory every tick between passes).
+
+    Exit status: 0 = all tests passed, non-zero = failure.
+
+    Copyright (C) 2026  Johnathan K Burchill
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+*/
+
+#include "tap.h"
+#include "tracking.h"
+#include "state.h"
+#include "antenna_rotator_async.h"
+#include "cmd_line.h"
+#include "panels.h"
+#include "prediction.h"
+#include "scan_sky.h"
+#include "sso_audit.h"
+
+#include <sgp4sdp4.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// ---------------------------------------------------------------- stubs
+
+void antenna_rotator_async_submit_set(antenna_rotator_async_t *ar,
+                                      double az_unwrapped, double elevation)
+{ (void) ar; (void) az_unwrapped; (void) elevation; }
+void antenna_rotator_async_submit_stop(antenna_rotator_async_t *ar) { (void) ar; }
+void antenna_rotator_async_kick_status(antenna_rotator_async_t *ar) { (void) ar; }
+void antenna_rotator_async_snapshot(const antenna_rotator_async_t *ar,
+                                    double *out_az, double *out_el,
+                                    int *out_ok, int *out_stale_ms,
+                                    int *out_set_in_flight)
+{
+    (void) ar; (void) out_az; (void) out_el; (void) out_stale_ms;
+    (void) out_set_in_flight;
+    if (out_ok) *out_ok = 0;
+}
+int antenna_rotator_async_wait_next_good_status(antenna_rotator_async_t *ar,
+                                                int timeout_ms)
+{ (void) ar; (void) timeout_ms; return -1; }
+void cmd_set_status(cmdline_t *cmd, const char *fmt, ...) { (void) cmd; (void) fmt; }
+void scan_sky_tick(state_t *state, double t_now) { (void) state; (void) t_now; }
+int sso_audit_event(const char *event, const char *detail)
+{ (void) event; (void) detail; return 0; }
+// The pass panel's AOS/LOS search. The test pins the window itself, so
+// a retarget keeps it rather than searching for the new object's pass.
+void compute_predictions(track_t *track, double jul_utc)
+{ (void) track; (void) jul_utc; }
+
+// ------------------------------------------------------------- fixtures
+
+// Two frozen 3-line TLEs (see prediction_selftest.c): retarget_to_tle
+// takes the first satellite in each file.
+static const char *TLE_AO7 =
+    "OSCAR 7 (AO-7)\n"
+    "1 07530U 74089B   25043.01160017 -.00000030  00000+0  10217-3 0  9990\n"
+    "2 07530 101.9936  46.0237 0012129 347.8272  22.1887 12.53686098299338\n";
+static const char *TLE_AO40 =
+    "AO-40\n"
+    "1 26609U 00072B   01098.10193978 -.00000077  00000-0  00000+0 0   623\n"
+    "2 26609   5.2776 206.5794 8139221 247.7100  15.0295  1.26974654  2011\n";
+
+static int write_tle(char *path, size_t cap, const char *text)
+{
+    const char *tmpdir = getenv("TMPDIR");
+    if (!tmpdir || !tmpdir[0]) tmpdir = "/tmp";
+    int n = snprintf(path, cap, "%s/sso_track_test_XXXXXX.tle", tmpdir);
+    if (n < 0 || (size_t) n >= cap) return -1;
+    int fd = mkstemps(path, 4);
+    if (fd < 0) return -1;
+    FILE *f = fdopen(fd, "w");
+    if (!f) { close(fd); unlink(path); return -1; }
+    fputs(text, f);
+    fclose(f);
+    return 0;
+}
+
+static double jul_now(void)
+{
+    struct tm utc;
+    struct timeval tv;
+    UTC_Calendar_Now(&utc, &tv);
+    return Julian_Date(&utc, &tv);
+}
+
+static size_t trajectory_len(const track_t *track)
+{
+    double t0 = 0.0;
+    double *offsets = NULL;
+    size_t n = tracking_doppler_trajectory(track, 1.0, &t0, &offsets);
+    free(offsets);
+    return n;
+}
+
+// The whole state is large; keep it off the stack.
+static state_t g_state;
+
+// ----------------------------------------------------------------- tests
+
+static void test_retarget_drops_trajectory(const char *path_a,
+                                           const char *path_b)
+{
+    state_t *st = &g_state;
+    st->track.doppler_correction_enabled    = 1;
+    st->track.nominal_downlink_frequency_hz = 437.0e6;
+
+    int rc = retarget_to_tle(st, path_a);
+    tap_okf(rc == RETARGET_OK, "retarget to the first target (rc=%d)", rc);
+
+    // Mid-pass: AOS two minutes ago, LOS in eight.
+    double now = jul_now();
+    st->track.prediction.predicted_ascension_jul_utc = now - 2.0 / 1440.0;
+    st->track.prediction.predicted_descent_jul_utc   = now + 8.0 / 1440.0;
+    st->track.doppler_track_stale = 0;
+    tracking_refresh_pass_cache(st, now);
+    tap_ok(st->track.prediction.pass_cache != NULL,
+           "mid-pass refresh builds the pass table");
+    tap_ok(st->track.doppler_track_stale == 1,
+           "building the table flags the trajectory stale");
+    size_t n = trajectory_len(&st->track);
+    tap_okf(n > 0, "trajectory sampled from the table (n=%zu)", n);
+
+    // main.c has sent it; now swap targets mid-pass.
+    st->track.doppler_track_stale = 0;
+    rc = retarget_to_tle(st, path_b);
+    tap_okf(rc == RETARGET_OK, "retarget mid-pass (rc=%d)", rc);
+    tap_ok(st->track.prediction.pass_cache == NULL,
+           "retarget drops the old target's pass table");
+    tap_ok(st->track.doppler_track_stale == 1,
+           "retarget flags the trajectory stale");
+    n = trajectory_len(&st->track);
+    tap_okf(n == 0, "trajectory re-sent after retarget is empty (n=%zu)", n);
+
+    // The next tick rebuilds the table for the new target.
+    st->track.doppler_track_stale = 0;
+    tracking_refresh_pass_cache(st, now);
+    tap_ok(st->track.prediction.pass_cache != NULL
+           && st->track.doppler_track_stale == 1,
+           "next refresh rebuilds the table for the new target");
+
+    // Past LOS: the table goes and the flag is raised once; a later tick
+    // with no table left to drop leaves it alone.
+    double past = st->track.prediction.predicted_descent_jul_utc + 1.0;
+    st->track.doppler_track_stale = 0;
+    tracking_refresh_pass_cache(st, past);
+    tap_ok(st->track.prediction.pass_cache == NULL
+           && st->track.doppler_track_stale == 1,
+           "after LOS the table is dropped and the trajectory flagged");
+    st->track.doppler_track_stale = 0;
+    tracking_refresh_pass_cache(st, past);
+    tap_ok(st->track.doppler_track_stale == 0,
+           "after LOS a tick with no table held leaves the flag clear");
+    tap_ok(trajectory_len(&st->track) == 0, "no trajectory after LOS");
+
+    prediction_free_pass_cache(&st->track.prediction);
+}
+
+int main(void)
+{
+    char path_a[512], path_b[512];
+    if (write_tle(path_a, sizeof path_a, TLE_AO7) != 0) {
+        tap_bail("cannot write fixture TLE");
+        return 1;
+    }
+    if (write_tle(path_b, sizeof path_b, TLE_AO40) != 0) {
+        unlink(path_a);
+        tap_bail("cannot write fixture TLE");
+        return 1;
+    }
+
+    test_retarget_drops_trajectory(path_a, path_b);
+
+    unlink(path_a);
+    unlink(path_b);
+    return tap_done();
+}
@@ -50,6 +50,7 @@
 #include "frontiersat.h"   // FRONTIERSAT_CARRIER_HZ
 #include "carrier_trim.h"
 #include "fm_demod.h"
+#include "sso_iq.h"
 #include "sw_nco.h"
 
 #include <ctype.h>
@@ -180,7 +181,7 @@ static int parse_args(b210_rx_capture_args_t *a, int argc, char **argv, int help
             matched = 1;
         }
         if (starts_with(arg, "--raw-iq=") || help) {
-            if (help) parse_help_line(OPTW, "--raw-iq=<path>", "interleaved int16 IQ (sc16), no header; independent of --demod");
+            if (help) parse_help_line(OPTW, "--raw-iq=<path>", "interleaved int16 IQ (sc16): .sso-iq container, else no header; independent of --demod");
             else a->raw_iq_path = arg + 9;
             matched = 1;
         }
@@ -732,10 +733,25 @@ int main(int argc, char **argv)
     }
 
     if (raw_iq_path != NULL) {
-        FILE *fp = fopen(raw_iq_path, "wb");
-        if (fp == NULL) { perror("fopen --raw-iq"); rc = 1; goto done_md; }
-        size_t wrote = fwrite(iq, sizeof(int16_t) * 2, got, fp);
-        fclose(fp);
+        size_t plen = strlen(raw_iq_path), xlen = strlen(SSO_IQ_EXT);
+        size_t wrote = 0;
+        if (plen >= xlen && strcmp(raw_iq_path + plen - xlen, SSO_IQ_EXT) == 0) {
+            // Compressed container carrying the rate and tune.
+            sso_iq_meta_t meta;
+            memset(&meta, 0, sizeof meta);
+            meta.sample_rate_hz = actual_rate;
+            meta.center_freq_hz = freq_hz + trim_hz;   // RF at DC after centering
+            snprintf(meta.source, sizeof meta.source, "b210_rx_capture");
+            sso_iq_writer_t *w = sso_iq_writer_open(raw_iq_path, &meta);
+            if (w == NULL) { perror("open --raw-iq"); rc = 1; goto done_md; }
+            int werr = sso_iq_writer_write(w, iq, got);
+            if (sso_iq_writer_close(w) == 0 && werr == 0) wrote = got;
+        } else {
+            FILE *fp = fopen(raw_iq_path, "wb");
+            if (fp == NULL) { perror("fopen --raw-iq"); rc = 1; goto done_md; }
+            wrote = fwrite(iq, sizeof(int16_t) * 2, got, fp);
+            fclose(fp);
+        }
         if (wrote != got) {
             fprintf(stderr, "b210_rx_capture: short write to %s\n", raw_iq_path);
             rc = 1;
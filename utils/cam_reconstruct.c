@@ -97,6 +97,7 @@
 #endif
 
 #include "cam_jpeg.h"
+#include "chunk_reasm.h"
 
 // Bulk-downlink chunk size: the firmware sends this many file bytes per RF
 // packet (BULK_FILE_DOWNLINK_PACKET_MAX_DATA_BYTES_PER_PACKET), so file
@@ -106,11 +107,6 @@
 
 #define GAP_CHAR                '?'    // simple_sat_ops fills lost bytes with this
 
-// A bulk_file packet payload is [packet_type:1][file_offset:4 LE][data...].
-// Same geometry packet_browser uses to place download chunks by file offset.
-#define BULK_FILE_PACKET_TYPE   16
-#define BULK_FILE_HEADER_SIZE   5
-
 // Most --patch ids a single image can need: a 25 KB capture is ~129 chunks, so
 // this is comfortably above any real run and bounds the fixed id array.
 #define MAX_PATCH_IDS           1024
@@ -154,18 +150,13 @@ static uint8_t *read_file(const char *path, long *out_len)
 
 #ifdef WITH_SQLITE3
 
-// Little-endian uint32 file_offset out of a bulk_file payload.
-static long bulk_file_offset(const uint8_t *pl)
-{
-    return (long) pl[1] | ((long) pl[2] << 8)
-         | ((long) pl[3] << 16) | ((long) pl[4] << 24);
-}
-
 // Lay the re-downloaded bulk_file packets named by `ids` over the raw camera
 // file in `buf`, overwriting the '?' gap bytes the first download missed. Each
 // packet's data goes at its own file_offset -- exactly where simple_sat_ops
-// left a gap. A missing id, a non-bulk_file id, or an offset outside the file
-// is warned and skipped, not fatal. Returns the number of gap bytes filled, or
+// left a gap. The payload is split by reasm_bulk_chunk, the same parse
+// mpi_reconstruct uses, so the CSP CRC32 trailer the ground appends is not
+// laid over the next chunk's bytes. A missing id, a non-bulk_file id, or an
+// offset outside the file is warned and skipped, not fatal. Returns the number of gap bytes filled, or
 // -1 if the DB itself could not be opened.
 static long apply_patches(const char *db_path, uint8_t *buf, long len,
                           const long *ids, int n_ids, int quiet)
@@ -200,22 +191,25 @@ static long apply_patches(const char *db_path, uint8_t *buf, long len,
             continue;
         }
         int ptype = sqlite3_column_int(stmt, 0);
-        if (ptype != BULK_FILE_PACKET_TYPE) {
+        if (ptype != REASM_BULK_PACKET_TYPE) {
             fprintf(stderr, "  id %ld: packet_type %d is not bulk_file (%d) -- skipped\n",
-                    ids[i], ptype, BULK_FILE_PACKET_TYPE);
+                    ids[i], ptype, REASM_BULK_PACKET_TYPE);
             continue;
         }
         const uint8_t *pl = (const uint8_t *) sqlite3_column_blob(stmt, 1);
         int pl_len = sqlite3_column_bytes(stmt, 1);
-        if (pl == NULL || pl_len <= BULK_FILE_HEADER_SIZE) {
+        if (pl == NULL || pl_len <= REASM_BULK_HEADER_SIZE) {
             fprintf(stderr, "  id %ld: payload too short (%d bytes) -- skipped\n",
                     ids[i], pl_len);
             continue;
         }
-        long off = bulk_file_offset(pl);
-        long dl = pl_len - BULK_FILE_HEADER_SIZE;
-        const uint8_t *src = pl + BULK_FILE_HEADER_SIZE;
-        if (off < 0 || off >= len) {
+        long off = -1, dl = 0;
+        const uint8_t *src = NULL;
+        if (reasm_bulk_chunk(pl, pl_len, &off, &src, &dl) != 0) {
+            fprintf(stderr, "  id %ld: implausible file offset (bit flip?) -- skipped\n", ids[i]);
+            continue;
+        }
+        if (off >= len) {
             fprintf(stderr, "  id %ld: file offset %ld is outside the file (0..%ld) -- skipped\n",
                     ids[i], off, len);
             continue;
@@ -49,6 +49,7 @@
 #include "modem_viterbi.h"
 #include "pdf_writer.h"
 #include "rs.h"
+#include "sso_iq.h"
 #include "sw_nco.h"
 #include "waterfall_core.h"
 
@@ -874,7 +875,7 @@ static void fmt_hhmmss_filename(double t_s, char *buf, size_t cap)
 }
 
 // ---------------------------------------------------------------------------
-// IQ-sample buffer. The whole .iq file is mmap'd or read into memory
+// IQ-sample buffer. The whole .iq / .sso-iq file is read into memory
 // once so the waveform panel can slice into it for any selected box
 // without re-reading the file.
 // ---------------------------------------------------------------------------
@@ -885,63 +886,54 @@ typedef struct {
     int      samp_rate;
 } iq_buf_t;
 
-// Reads a raw int16 I/Q file into b->samples. When `progress_pct_out`
-// is non-NULL, the function writes a 0..1 fraction to it after each
-// chunk so a UI thread can render a progress bar — the file is read in
-// 8 MB chunks rather than one big fread() to make the granularity
-// useful on multi-hundred-MB passes.
-// tail_bytes > 0: only load the last tail_bytes (rounded down to an
-// IQ-pair multiple) from the file. Use this to start --live mode
-// already on the most-recent window instead of loading the whole
-// pass and then sliding it down to the window — the user sees only
-// the window from frame 0. tail_bytes == 0 loads the entire file
-// (legacy behaviour).
+// Reads an IQ recording (.sso-iq decoded, or raw int16 I/Q) into
+// b->samples. When `progress_pct_out` is non-NULL, the function writes
+// a 0..1 fraction to it after each chunk so a UI thread can render a
+// progress bar — the file is read in 2 M-pair (8 MB) chunks rather than
+// one big read to make the granularity useful on multi-hundred-MB passes.
+// tail_bytes > 0: only load the last tail_bytes / 4 pairs from the file.
+// Use this to start --live mode already on the most-recent window
+// instead of loading the whole pass and then sliding it down to the
+// window — the user sees only the window from frame 0. tail_bytes == 0
+// loads the entire file (legacy behaviour).
 static int iq_buf_load_progress(iq_buf_t *b, const char *path, int samp_rate,
                                 size_t tail_bytes,
                                 volatile float *progress_pct_out)
 {
-    FILE *fp = fopen(path, "rb");
-    if (fp == NULL) {
+    sso_iq_reader_t *rd = sso_iq_open(path);
+    if (rd == NULL) {
         fprintf(stderr, "decode_inspector: open %s: %s\n",
-                path, strerror(errno));
+                path, errno ? strerror(errno) : "damaged .sso-iq");
         return -1;
     }
-    fseek(fp, 0, SEEK_END);
-    long sz = ftell(fp);
-    if (sz <= 0) { fclose(fp); return -1; }
-    size_t total = (size_t) sz;
-    size_t offset = 0;
-    if (tail_bytes > 0 && total > tail_bytes) {
-        // Round the offset DOWN to a 4-byte IQ-pair boundary so we
-        // never split an int16 I/Q pair.
-        offset = (total - tail_bytes) & ~(size_t)3;
-        total = (size_t) sz - offset;
-    }
-    if (fseek(fp, (long) offset, SEEK_SET) != 0) {
-        fclose(fp); return -1;
+    size_t total = (size_t) sso_iq_pairs(rd);
+    if (total == 0) { sso_iq_close(rd); return -1; }
+    size_t tail_pairs = tail_bytes / 4u;
+    if (tail_pairs > 0 && total > tail_pairs) {
+        sso_iq_seek_pair(rd, total - tail_pairs);
+        total = tail_pairs;
     }
-    b->samples = (int16_t *) malloc(total);
-    if (b->samples == NULL) { fclose(fp); return -1; }
+    b->samples = (int16_t *) malloc(total * 4u);
+    if (b->samples == NULL) { sso_iq_close(rd); return -1; }
 
-    const size_t chunk = 8u * 1024u * 1024u;
+    const size_t chunk = 2u * 1024u * 1024u;
     size_t read_total = 0;
-    char  *dst        = (char *) b->samples;
     while (read_total < total) {
         size_t want = chunk;
         if (read_total + want > total) want = total - read_total;
-        size_t got = fread(dst + read_total, 1, want, fp);
-        if (got == 0) {
-            fclose(fp);
+        ssize_t got = sso_iq_read(rd, b->samples + 2u * read_total, want);
+        if (got <= 0) {
+            sso_iq_close(rd);
             free(b->samples); b->samples = NULL;
             return -1;
         }
-        read_total += got;
+        read_total += (size_t) got;
         if (progress_pct_out != NULL) {
             *progress_pct_out = (float)((double) read_total / (double) total);
         }
     }
-    fclose(fp);
-    b->n_pairs   = total / 4;
+    sso_iq_close(rd);
+    b->n_pairs   = total;
     b->samp_rate = samp_rate;
     if (progress_pct_out != NULL) *progress_pct_out = 1.0f;
     return 0;
@@ -1981,7 +1973,16 @@ int main(int argc, char **argv)
     int n_passthru = cfg.n_passthru;
     for (int i = 0; i < n_passthru; ++i) passthru[i] = cfg.passthru[i];
 
-    // Auto-detect rate from companion .wav.
+    // Auto-detect rate: a .sso-iq carries it, a .iq has a companion .wav.
+    sso_iq_reader_t *probe = sso_iq_open(iq_path);
+    if (probe == NULL) {
+        fprintf(stderr, "decode_inspector: open %s: %s\n", iq_path,
+                errno ? strerror(errno) : "damaged .sso-iq");
+        return 1;
+    }
+    if (samp_rate <= 0 && sso_iq_meta(probe)->sample_rate_hz > 0.0) {
+        samp_rate = (int) lround(sso_iq_meta(probe)->sample_rate_hz);
+    }
     if (samp_rate <= 0) {
         size_t plen = strlen(iq_path);
         if (plen > 3 && strcmp(iq_path + plen - 3, ".iq") == 0) {
@@ -1994,14 +1995,9 @@ int main(int argc, char **argv)
     }
     fprintf(stderr, "decode_inspector: rate=%d Hz\n", samp_rate);
 
-    // Compute duration from file size.
-    struct stat st;
-    if (stat(iq_path, &st) != 0) {
-        fprintf(stderr, "decode_inspector: stat %s: %s\n",
-                iq_path, strerror(errno));
-        return 1;
-    }
-    size_t n_pairs = (size_t) st.st_size / 4;
+    // Duration from the pair count (file size / 4 for a raw .iq).
+    size_t n_pairs = (size_t) sso_iq_pairs(probe);
+    sso_iq_close(probe);
     double duration_s = (double) n_pairs / (double) samp_rate;
     {
         char pb[32];
@@ -2328,16 +2324,16 @@ int main(int argc, char **argv)
             / (double) wf_opt.out_rows;
     }
     // For tail-loaded captures (--live on a file already bigger
-    // than the window), live_last_iq_size is the FULL file size at
-    // load time — not iqb.n_pairs*4. Otherwise the first refresh
-    // would see "file grew by everything we skipped" and re-read
-    // megabytes of bytes that are already represented in iqb.
-    size_t live_last_iq_size = (size_t) iqb.n_pairs * 4u;
+    // than the window), live_last_iq_pairs is the FULL pair count at
+    // load time — not iqb.n_pairs. Otherwise the first refresh would
+    // see "file grew by everything we skipped" and re-read megabytes
+    // of samples that are already represented in iqb. live_rd stays
+    // open so each refresh only looks at what was appended.
+    size_t live_last_iq_pairs = (size_t) iqb.n_pairs;
+    sso_iq_reader_t *live_rd = NULL;
     if (live_mode_cli) {
-        struct stat lst;
-        if (stat(iq_path, &lst) == 0 && lst.st_size > 0) {
-            live_last_iq_size = (size_t) lst.st_size;
-        }
+        live_rd = sso_iq_open(iq_path);
+        if (live_rd != NULL) live_last_iq_pairs = (size_t) sso_iq_pairs(live_rd);
     }
     double live_last_check_time = GetTime();
     if (live_mode) {
@@ -2689,7 +2685,7 @@ int main(int argc, char **argv)
         Vector2 m = GetMousePosition();
 
         // ----- live refresh -----
-        // If --live, every live_interval_s seconds stat the .iq.
+        // If --live, every live_interval_s seconds refresh the reader.
         // When it grows by at least ~0.25 s of new IQ, append the
         // new bytes to iqb.samples (sliding out the oldest to keep
         // the rolling window at live_window_s), FFT only the new
@@ -2700,23 +2696,21 @@ int main(int argc, char **argv)
         if (live_mode && iqb.samples != NULL
             && (GetTime() - live_last_check_time) >= live_interval_s) {
             live_last_check_time = GetTime();
-            struct stat lst;
-            if (stat(iq_path, &lst) == 0
-                && lst.st_size > 0
-                && (size_t) lst.st_size > live_last_iq_size) {
-                size_t new_size = (size_t) lst.st_size;
-                size_t new_bytes = new_size - live_last_iq_size;
-                size_t new_pairs = new_bytes / 4u;
+            if (live_rd != NULL
+                && sso_iq_refresh(live_rd) >= 0
+                && (size_t) sso_iq_pairs(live_rd) > live_last_iq_pairs) {
+                size_t new_total = (size_t) sso_iq_pairs(live_rd);
+                size_t new_pairs = new_total - live_last_iq_pairs;
+                size_t new_bytes = new_pairs * 4u;
                 size_t min_new_pairs =
                     (size_t) (0.25 * (double) iqb.samp_rate);
                 if (new_pairs >= min_new_pairs) {
-                    FILE *fp = fopen(iq_path, "rb");
                     int16_t *tmp = (int16_t *) malloc(new_bytes);
-                    if (fp != NULL && tmp != NULL
-                        && fseek(fp, (long) live_last_iq_size,
-                                 SEEK_SET) == 0
-                        && fread(tmp, 1, new_bytes, fp)
-                           == new_bytes) {
+                    if (tmp != NULL
+                        && sso_iq_seek_pair(live_rd,
+                                            live_last_iq_pairs) == 0
+                        && sso_iq_read(live_rd, tmp, new_pairs)
+                           == (ssize_t) new_pairs) {
                         // Apply the same LO shift the initial load
                         // applied so the live data stays aligned
                         // with the existing spec rows.
@@ -2843,10 +2837,9 @@ int main(int argc, char **argv)
                             }
                             free(chunk_db);
                         }
-                        live_last_iq_size = new_size;
+                        live_last_iq_pairs = new_total;
                     }
                     free(tmp);
-                    if (fp != NULL) fclose(fp);
                 }
             }
         }
@@ -6740,6 +6733,7 @@ int main(int argc, char **argv)
     UnloadShader(wf_shader);
     free(spec_db);
     iq_buf_free(&iqb);
+    sso_iq_close(live_rd);
     free(decode_text);
     decmode_diag_free(&decmode_diag);
     free(decmode_out_scratch);
@@ -40,6 +40,7 @@
 #define _GNU_SOURCE
 
 #include "argparse.h"
+#include "sso_iq.h"
 #include "sw_nco.h"
 #include "waterfall_core.h"
 
@@ -1251,7 +1252,8 @@ static int parse_int_opt(const char *arg, const char *prefix, int *out)
 typedef struct {
     // Up to three positional tokens. main() maps them by file extension:
     // .iq/.raw -> <iq_path> <sample_rate_hz> [<out_png>]; .ogg has no
-    // sample-rate arg so it is <audio.ogg> [<out_png>].
+    // sample-rate arg so it is <audio.ogg> [<out_png>]; a .sso-iq carries
+    // its rate, so the rate positional is optional there.
     const char *pos1;
     const char *pos2;
     const char *pos3;
@@ -1287,11 +1289,11 @@ static int parse_args(gw_args_t *a, int argc, char **argv, int help)
         // token to pos2, and so on -- one filename filled all three slots and
         // the real rate fell through as an "unknown option".
         if ((a->pos1 == NULL && (arg[0] != '-' || strcmp(arg, "-") == 0)) || help) {
-            if (help) parse_help_line(OPTW, "<iq_path>", "raw int16 I,Q file, or a SatNOGS .ogg audio recording");
+            if (help) parse_help_line(OPTW, "<iq_path>", ".sso-iq or raw int16 I,Q file, or a SatNOGS .ogg audio recording");
             else { a->pos1 = arg; matched = 1; }
         }
         if ((!matched && a->pos1 != NULL && a->pos2 == NULL && (arg[0] != '-' || strcmp(arg, "-") == 0)) || help) {
-            if (help) parse_help_line(OPTW, "<sample_rate_hz>", "IQ sample rate in Hz (omit for .ogg; read from file)");
+            if (help) parse_help_line(OPTW, "<sample_rate_hz>", "IQ sample rate in Hz (omit for .ogg / .sso-iq; read from file)");
             else { a->pos2 = arg; matched = 1; }
         }
         if ((!matched && a->pos2 != NULL && a->pos3 == NULL && (arg[0] != '-' || strcmp(arg, "-") == 0)) || help) {
@@ -1550,8 +1552,12 @@ int main(int argc, char **argv)
     // output PNG is positional arg 2. For .iq/.raw the rate stays
     // positional arg 2 and the PNG arg 3. Explicit extension beats inferred,
     // exactly as before — parse_args only captured the raw tokens.
+    // A .sso-iq takes either form: a numeric arg 2 is a rate (which
+    // overrides the header), anything else is the PNG.
     size_t ipl = strlen(iq_path);
+    size_t sxl = strlen(SSO_IQ_EXT);
     int is_ogg = (ipl >= 4 && strcmp(iq_path + ipl - 4, ".ogg") == 0);
+    int is_sso = (ipl >= sxl && strcmp(iq_path + ipl - sxl, SSO_IQ_EXT) == 0);
     int sample_rate = 0;
     if (is_ogg) {
         out_png = cfg.pos2;               // optional PNG, or NULL for PDF-only
@@ -1559,6 +1565,9 @@ int main(int argc, char **argv)
             fprintf(stderr, "gen_waterfall: unknown option '%s'\n", cfg.pos3);
             return 2;
         }
+    } else if (is_sso && cfg.pos2 != NULL && cfg.pos3 == NULL
+               && strspn(cfg.pos2, "0123456789.") != strlen(cfg.pos2)) {
+        out_png = cfg.pos2;
     } else {
         sample_rate = (cfg.pos2 != NULL) ? atoi(cfg.pos2) : 0;
         out_png = cfg.pos3;               // optional PNG, or NULL for PDF-only
@@ -1580,7 +1589,7 @@ int main(int argc, char **argv)
 
     if (opt.hop == 0) opt.hop = opt.fft_size / 2;
 
-    if (!is_ogg && sample_rate <= 0) {
+    if (!is_ogg && !is_sso && sample_rate <= 0) {
         fprintf(stderr, "gen_waterfall: invalid sample rate %d\n", sample_rate);
         return 2;
     }
@@ -1647,34 +1656,30 @@ int main(int argc, char **argv)
         return 1;
 #endif
     } else {
-        FILE *f = fopen(iq_path, "rb");
-        if (!f) {
-            fprintf(stderr, "gen_waterfall: open %s: %s\n",
-                    iq_path, strerror(errno));
+        // .sso-iq (decoded) or raw int16 I,Q; the reader goes by content.
+        sso_iq_meta_t meta;
+        errno = 0;
+        iq = sso_iq_load(iq_path, &n_pairs, &meta);
+        if (!iq) {
+            fprintf(stderr, "gen_waterfall: read %s: %s\n", iq_path,
+                    errno ? strerror(errno) : "damaged .sso-iq");
             return 1;
         }
-        if (fseek(f, 0, SEEK_END) != 0) {
-            fprintf(stderr, "gen_waterfall: seek failed\n");
-            fclose(f); return 1;
-        }
-        long fsize = ftell(f);
-        if (fsize < 0) {
-            fprintf(stderr, "gen_waterfall: ftell failed\n");
-            fclose(f); return 1;
-        }
-        fseek(f, 0, SEEK_SET);
-        n_pairs = (size_t) fsize / 4;  // 2 bytes per int16 × 2 (I,Q)
         if (n_pairs == 0) {
             fprintf(stderr, "gen_waterfall: %s is empty\n", iq_path);
-            fclose(f); return 1;
+            free(iq); return 1;
         }
-        iq = (int16_t *) malloc((size_t) fsize);
-        if (!iq) { fprintf(stderr, "gen_waterfall: oom\n"); fclose(f); return 1; }
-        if (fread(iq, 1, (size_t) fsize, f) != (size_t) fsize) {
-            fprintf(stderr, "gen_waterfall: short read\n");
-            free(iq); fclose(f); return 1;
+        if (sample_rate <= 0) sample_rate = (int) lround(meta.sample_rate_hz);
+        if (sample_rate <= 0) {
+            fprintf(stderr, "gen_waterfall: no sample rate for %s\n", iq_path);
+            free(iq); return 2;
+        }
+        opt.sample_rate = sample_rate;
+        // The container's own start time beats the one in its name.
+        if (!cfg.start_utc_overridden && meta.start_unix_s > 0.0) {
+            opt.start_utc = (time_t) floor(meta.start_unix_s);
+            opt.start_utc_subsec = meta.start_unix_s - floor(meta.start_unix_s);
         }
-        fclose(f);
     }
 
     if (lo_shift_hz != 0.0) {
@@ -519,12 +519,12 @@ int main(int argc, char **argv)
         return 1;
     }
 
-    const char *sql =
-        "SELECT id, ts_received, payload FROM packet "
-        "WHERE packet_type=?1 AND length(payload) >= ?2 "
-        "ORDER BY " TCMD_RESP_SQL_TS_SENT ", ts_received, id";
+    // Indexed by the V6 ts_sent column when the DB has it, else sorted on
+    // the payload slice (see PACKET_DB_SQL_RESP_FRAGS).
     sqlite3_stmt *st = NULL;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, NULL) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, PACKET_DB_SQL_RESP_FRAGS, -1, &st, NULL) != SQLITE_OK
+        && sqlite3_prepare_v2(db, PACKET_DB_SQL_RESP_FRAGS_LEGACY, -1, &st, NULL)
+           != SQLITE_OK) {
         fprintf(stderr, "gnss_opm: query failed: %s\n", sqlite3_errmsg(db));
         sqlite3_close(db);
         return 1;
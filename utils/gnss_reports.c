@@ -39,6 +39,7 @@
 #include "argparse.h"
 #include "beacon_cts1.h"
 #include "bestxyz.h"
+#include "chunk_reasm.h"
 #include "gnss_frag.h"
 #include "packet_db.h"
 #include "sso_version.h"
@@ -431,18 +432,16 @@ int main(int argc, char **argv)
 
     // Pull every tcmd_response fragment, grouped by ts_sent then ordered by
     // arrival, so we can split duplicate receptions and reassemble each.
-    const char *sql =
-        "SELECT id, ts_received, payload FROM packet "
-        "WHERE packet_type=?1 AND length(payload) >= ?2 "
-        "ORDER BY " TCMD_RESP_SQL_TS_SENT ", ts_received, id";
-    sqlite3_stmt *st = NULL;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, NULL) != SQLITE_OK) {
-        fprintf(stderr, "gnss_reports: query failed: %s\n", sqlite3_errmsg(db));
+    // Indexed by the V6 ts_sent column when the DB has it, else sorted on
+    // the payload slice (see PACKET_DB_SQL_RESP_FRAGS).
+    reasm_cursor_t cur;
+    if (reasm_cursor_open(&cur, db, PACKET_DB_SQL_RESP_FRAGS, NULL) != 0
+        && reasm_cursor_open(&cur, db, PACKET_DB_SQL_RESP_FRAGS_LEGACY, "gnss_reports") != 0) {
         sqlite3_close(db);
         return 1;
     }
-    sqlite3_bind_int(st, 1, TCMD_RESP_PACKET_TYPE);
-    sqlite3_bind_int(st, 2, TCMD_RESP_HDR_LEN + 1);
+    sqlite3_bind_int(cur.st, 1, TCMD_RESP_PACKET_TYPE);
+    sqlite3_bind_int(cur.st, 2, TCMD_RESP_HDR_LEN + 1);
 
     // Group by ts_sent key; within a group, a new reception starts whenever
     // the sequence number does not advance (seq <= last seq seen).
@@ -459,9 +458,9 @@ int main(int argc, char **argv)
         } \
     } while (0)
 
-    while (sqlite3_step(st) == SQLITE_ROW) {
-        const unsigned char *pl = sqlite3_column_blob(st, 2);
-        int pl_len = sqlite3_column_bytes(st, 2);
+    while (reasm_cursor_next(&cur) == 1) {
+        const unsigned char *pl = cur.payload;
+        int pl_len = cur.payload_len;
         if (pl == NULL || pl_len < TCMD_RESP_HDR_LEN + 1) continue;
         int seq = tcmd_resp_seq(pl, (size_t) pl_len);
         if (seq < 1) continue;
@@ -476,9 +475,9 @@ int main(int argc, char **argv)
         if (nrecv >= (int)(sizeof recv / sizeof recv[0])) FLUSH();
 
         gnss_frag_t *f = &recv[nrecv++];
-        f->id = sqlite3_column_int64(st, 0);
+        f->id = cur.id;
         snprintf(f->ts_received, sizeof f->ts_received, "%s",
-                 (const char *)sqlite3_column_text(st, 1));
+                 cur.ts_received ? cur.ts_received : "");
         memcpy(f->tskey, key, 8);
         f->seq = seq;
         f->max_seq = tcmd_resp_max_seq(pl, (size_t) pl_len);
@@ -491,7 +490,7 @@ int main(int argc, char **argv)
         last_seq = seq;
     }
     FLUSH();
-    sqlite3_finalize(st);
+    reasm_cursor_close(&cur);
     sqlite3_close(db);
 
     // Print the collected responses in chronological order (--reverse flips to
@@ -2,7 +2,7 @@
 
     Simple Satellite Operations  utils/live_waterfall.c
 
-    Real-time spectrogram viewer for an .iq capture in progress. Tails
+    Real-time spectrogram viewer for an .sso-iq / .iq capture in progress. Tails
     the file simple_sat_ops is writing, FFTs new IQ samples as they
     arrive, and renders a viridis spectrogram in a tall narrow raylib
     window beside the terminal UI. Newest row at the top; older rows
@@ -30,6 +30,7 @@
 #include <raylib.h>
 
 #include "argparse.h"
+#include "sso_iq.h"
 #include "waterfall_core.h"
 
 #include <errno.h>
@@ -50,36 +51,30 @@
 #endif
 
 // --------------------------------------------------------------------
-// Tailer: keep an FD open on the .iq file, read whatever new bytes
-// have landed since the last poll. Detects truncation (recording
-// restarted) by stat()ing periodically.
+// Tailer: keep a reader open on the recording and pick up whatever
+// has landed since the last poll -- whole blocks of a .sso-iq, any
+// complete pairs of a raw .iq. Detects truncation (recording restarted)
+// by stat()ing each poll.
 // --------------------------------------------------------------------
 
 typedef struct {
-    char    path[1024];
-    FILE   *fp;
-    off_t   read_pos;          // bytes consumed from the file
-    time_t  last_size_check;
+    char             path[1024];
+    sso_iq_reader_t *rd;
+    off_t            last_size;    // file size at the last poll
 } iq_tail_t;
 
 static int iq_tail_open(iq_tail_t *t, const char *path)
 {
     snprintf(t->path, sizeof t->path, "%s", path);
-    t->fp = fopen(t->path, "rb");
-    if (t->fp == NULL) {
-        return -1;
-    }
-    t->read_pos = 0;
-    t->last_size_check = time(NULL);
-    return 0;
+    t->rd = sso_iq_open(t->path);
+    t->last_size = 0;
+    return t->rd != NULL ? 0 : -1;
 }
 
 static void iq_tail_close(iq_tail_t *t)
 {
-    if (t->fp != NULL) {
-        fclose(t->fp);
-        t->fp = NULL;
-    }
+    sso_iq_close(t->rd);
+    t->rd = NULL;
 }
 
 // Returns number of new IQ pairs read into `buf` (which must hold at
@@ -88,35 +83,33 @@ static void iq_tail_close(iq_tail_t *t)
 // internal state).
 static int iq_tail_read(iq_tail_t *t, int16_t *buf, size_t cap_pairs)
 {
-    if (t->fp == NULL) {
+    if (t->rd == NULL) {
         // Try to (re)open. Quiet on failure — the operator may have
         // not started recording yet.
-        t->fp = fopen(t->path, "rb");
-        if (t->fp == NULL) return -1;
-        t->read_pos = 0;
+        t->rd = sso_iq_open(t->path);
+        if (t->rd == NULL) return -1;
+        t->last_size = 0;
     }
 
     // Detect truncation by stat (a re-opened recording would start the
-    // file fresh; we'd want to re-seek to 0).
+    // file fresh; reopen so the reader starts over at pair 0).
     struct stat st;
     if (stat(t->path, &st) == 0) {
-        if ((off_t) st.st_size < t->read_pos) {
-            // File got smaller — truncated. Reset.
-            t->read_pos = 0;
-            rewind(t->fp);
+        if (st.st_size < t->last_size) {
+            iq_tail_close(t);
             return -2;
         }
+        t->last_size = st.st_size;
     }
 
-    // Seek to where we left off (handles other writers; harmless if
-    // we're already there).
-    if (fseeko(t->fp, t->read_pos, SEEK_SET) != 0) {
-        fclose(t->fp); t->fp = NULL;
+    if (sso_iq_refresh(t->rd) < 0) {
+        iq_tail_close(t);
         return -1;
     }
-    size_t got = fread(buf, sizeof(int16_t) * 2, cap_pairs, t->fp);
-    if (got > 0) {
-        t->read_pos += (off_t)(got * sizeof(int16_t) * 2);
+    ssize_t got = sso_iq_read(t->rd, buf, cap_pairs);
+    if (got < 0) {
+        iq_tail_close(t);
+        return -1;
     }
     return (int) got;
 }
@@ -416,7 +409,7 @@ static int parse_args(wf_args_t *a, int argc, char **argv, int help)
         // <iq_path>: first non-option token. A lone "-" counts as a
         // positional. Declared first so it lists above the --options in help.
         if ((a->iq_path == NULL && (arg[0] != '-' || strcmp(arg, "-") == 0)) || help) {
-            if (help) parse_help_line(OPTW, "<iq_path>", "IQ capture to tail (.iq, interleaved S16_LE)");
+            if (help) parse_help_line(OPTW, "<iq_path>", "IQ capture to tail (.sso-iq, or .iq interleaved S16_LE)");
             else a->iq_path = arg;
             matched = 1;
         }
@@ -692,8 +685,8 @@ int main(int argc, char **argv)
         ClearBackground(BLACK);
 
         // ---- Top status bar -----------------------------------------
-        const char *status = (tail.fp != NULL) ? "REC" : "(waiting for .iq)";
-        Color status_col = (tail.fp != NULL) ? (Color){80, 200, 80, 255}
+        const char *status = (tail.rd != NULL) ? "REC" : "(waiting for IQ)";
+        Color status_col = (tail.rd != NULL) ? (Color){80, 200, 80, 255}
                                               : (Color){200, 180, 80, 255};
         DrawText(status, left_pad, 4, 14, status_col);
 
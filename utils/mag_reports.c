@@ -290,6 +290,10 @@ typedef struct {
     int64_t   epoch_ms;
     char      line1[80];
     char      line2[80];
+#ifdef WITH_SGP4SDP4
+    int        ctx_state;           // 0 = not built yet, 1 = ready, -1 = bad elements
+    sgp4_ctx_t ctx;                 // converted once, reused for every reading
+#endif
 } tle_row_t;
 
 static tle_row_t *g_tles = NULL;
@@ -339,6 +343,9 @@ static int load_tles(sqlite3 *db, const args_t *a)
         r->epoch_ms = epoch_ms;
         snprintf(r->line1, sizeof r->line1, "%s", (const char *)sqlite3_column_text(st, 4));
         snprintf(r->line2, sizeof r->line2, "%s", (const char *)sqlite3_column_text(st, 5));
+#ifdef WITH_SGP4SDP4
+        r->ctx_state = 0;
+#endif
         g_tle_epochs[g_ntles] = epoch_ms;
         g_ntles++;
 
@@ -356,38 +363,46 @@ static int load_tles(sqlite3 *db, const args_t *a)
 #define TLE_LINE_CHARS   69
 #define TLE_TWO_LINE_BUF (2 * TLE_LINE_CHARS + 1)
 
-// Sub-satellite geodetic point for one TLE at a unix-ms instant. Each call
-// reconverts the elements and resets sgp4sdp4's module-level flags before
-// select_ephemeris: the flags and select_ephemeris's in-place unit rewrite
-// are not per-object, so reusing one converted TLE across different element
-// sets would cross-contaminate. Returns 0 on success, -1 on bad elements.
-static int tle_subpoint(const char *line1, const char *line2, int64_t unix_ms,
+// Sub-satellite geodetic point for one TLE row at a unix-ms instant. The
+// first call converts the row's elements (select_ephemeris, with
+// sgp4sdp4's flags reset first since its in-place unit rewrite and flags
+// are not per-object) into a batch-propagation context cached on the row,
+// so later readings that pick the same TLE just propagate. Returns 0 on
+// success, -1 on bad elements.
+static int tle_subpoint(tle_row_t *row, int64_t unix_ms,
                         double *lat_deg, double *lon_deg, double *alt_km)
 {
-    char tle[TLE_TWO_LINE_BUF] = {0};
-    size_t l1 = strlen(line1), l2 = strlen(line2);
-    if (l1 > TLE_LINE_CHARS) l1 = TLE_LINE_CHARS;
-    if (l2 > TLE_LINE_CHARS) l2 = TLE_LINE_CHARS;
-    memcpy(tle, line1, l1);
-    memcpy(tle + TLE_LINE_CHARS, line2, l2);
-    if (!Good_Elements(tle)) return -1;
-
-    prediction_t pred = {0};
-    pred.observer_ephem.position_geodetic.lat = RAO_LATITUDE  * M_PI / 180.0;
-    pred.observer_ephem.position_geodetic.lon = RAO_LONGITUDE * M_PI / 180.0;
-    pred.observer_ephem.position_geodetic.alt = RAO_ALTITUDE  / 1000.0;
-    Convert_Satellite_Data(tle, &pred.satellite_ephem.tle);
-    ClearFlag(ALL_FLAGS);
-    select_ephemeris(&pred.satellite_ephem.tle);
+    if (row->ctx_state == 0) {
+        char tle[TLE_TWO_LINE_BUF] = {0};
+        size_t l1 = strlen(row->line1), l2 = strlen(row->line2);
+        if (l1 > TLE_LINE_CHARS) l1 = TLE_LINE_CHARS;
+        if (l2 > TLE_LINE_CHARS) l2 = TLE_LINE_CHARS;
+        memcpy(tle, row->line1, l1);
+        memcpy(tle + TLE_LINE_CHARS, row->line2, l2);
+        row->ctx_state = -1;
+        if (!Good_Elements(tle)) return -1;
+
+        tle_t elements;
+        Convert_Satellite_Data(tle, &elements);
+        ClearFlag(ALL_FLAGS);
+        select_ephemeris(&elements);
+        sgp4_ctx_init(&row->ctx, &elements, isFlagSet(DEEP_SPACE_EPHEM_FLAG) ? 1 : 0);
+        row->ctx_state = 1;
+    }
+    if (row->ctx_state < 0) return -1;
 
     double jul_utc = 2440587.5 + (double)unix_ms / 86400000.0;
-    update_satellite_position(&pred, jul_utc);
+    double pos[3];
+    sgp4_propagate_times(&row->ctx, &jul_utc, 1, pos, NULL);
+    vector_t p = { pos[0], pos[1], pos[2], 0.0 };
+    geodetic_t geo;
+    Calculate_LatLonAlt(jul_utc, &p, &geo);
 
-    double lon = pred.satellite_ephem.longitude;
+    double lon = Degrees(geo.lon);
     if (lon > 180.0) lon -= 360.0;
-    *lat_deg = pred.satellite_ephem.latitude;
+    *lat_deg = Degrees(geo.lat);
     *lon_deg = lon;
-    *alt_km  = pred.satellite_ephem.altitude_km;
+    *alt_km  = geo.alt;
     return 0;
 }
 #endif // WITH_SGP4SDP4
@@ -508,7 +523,7 @@ static void emit_reading(rec_kind_t kind, const adcs_mag_vec_t *v,
         r->tle_norad    = g_tles[idx].catalog;
         r->tle_epoch_ms = g_tles[idx].epoch_ms;
 #ifdef WITH_SGP4SDP4
-        if (tle_subpoint(g_tles[idx].line1, g_tles[idx].line2, r->meas_ms,
+        if (tle_subpoint(&g_tles[idx], r->meas_ms,
                          &r->lat, &r->lon, &r->alt_km) == 0)
             r->have_pos = 1;
 #endif
@@ -1025,12 +1040,12 @@ int main(int argc, char **argv)
                         "cannot be computed.\n");
 #endif
 
-    const char *sql =
-        "SELECT id, ts_received, payload FROM packet "
-        "WHERE packet_type=?1 AND length(payload) >= ?2 "
-        "ORDER BY " TCMD_RESP_SQL_TS_SENT ", ts_received, id";
+    // Indexed by the V6 ts_sent column when the DB has it, else sorted on
+    // the payload slice (see PACKET_DB_SQL_RESP_FRAGS).
     sqlite3_stmt *st = NULL;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, NULL) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, PACKET_DB_SQL_RESP_FRAGS, -1, &st, NULL) != SQLITE_OK
+        && sqlite3_prepare_v2(db, PACKET_DB_SQL_RESP_FRAGS_LEGACY, -1, &st, NULL)
+           != SQLITE_OK) {
         fprintf(stderr, "mag_reports: query failed: %s\n", sqlite3_errmsg(db));
         sqlite3_close(db);
         return 1;
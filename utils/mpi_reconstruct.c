@@ -33,10 +33,13 @@
     with the firmware streaming the bytes between their offsets at 9600 baud.
 
     What this tool does:
-      1. Loads every bulk_file chunk with a sane file offset, splits them into
-         download bursts by time, and reassembles each burst by offset (a byte
-         is a gap until a chunk fills it; RS-clean chunks win, uncorrectable
-         chunks only fill still-missing bytes).
+      1. Indexes every bulk_file chunk with a sane file offset (time, id and
+         whether it carries the sync word -- not its data), splits them into
+         download sessions by time, and streams each session's chunks back
+         out of the DB into an offset map (a byte is a gap until a chunk
+         fills it; RS-clean chunks win, uncorrectable chunks only fill
+         still-missing bytes). The reassembly is src/db/chunk_reasm.c, shared
+         with cam_reconstruct.
       2. For each burst that looks like MPI science data (>= 20000 bytes and the
          0C FF FF 0C sync word seen repeatedly), writes MPI_yyyymmddThhmmss.bin
          to the output directory (the CWD by default). The timestamp is the UTC
@@ -47,12 +50,20 @@
          comms_bulk_file_downlink_start commands to re-fetch them. Feed those
          re-fetched chunks back into the DB and re-run to close the gaps.
 
+    Re-runs are incremental. The output directory keeps a small state file
+    (.mpi_reconstruct.state) recording, per session, the packets it was built
+    from (first/last reception time, packet count, highest packet id) and the
+    fill / min-sync it was built with. A session whose packets are the same as
+    last time and whose .bin is still on disk is reported as unchanged without
+    touching its chunk data; only sessions that gained packets since the last
+    run are reassembled and rewritten. --rebuild ignores the state.
+
     Read-only on the DB -- safe to run while a receiver is filling it.
 
     Usage:
       mpi_reconstruct [--db=<packet_db.sqlite>] [--since=<spec>] [--until=<spec>]
                       [--dir=<out-dir>] [--file-path=<sat-path>]
-                      [--fill=00|ff] [--min-sync=<n>] [--quiet]
+                      [--fill=00|ff] [--min-sync=<n>] [--rebuild] [--quiet]
 
     With no --db the default store is used ($SSO_PACKET_DB, else the FrontierSat
     root's packet_db.sqlite). --since/--until scope the search (24h | 7d | 30m |
@@ -78,6 +89,7 @@
 */
 
 #include "argparse.h"
+#include "chunk_reasm.h"
 #include "gnss_frag.h"
 #include "packet_db.h"
 #include "sso_version.h"
@@ -102,15 +114,9 @@ int main(int argc, char **argv)
 
 #include <sqlite3.h>
 
-// Bulk-file packet geometry (mirrors packet_browser.c / beacon_cts1.h). A
-// bulk_file payload is [packet_type:1][file_offset:4 LE][data...]; the firmware
-// sends at most 195 file bytes per packet, so a lost byte range is always a
-// whole multiple of the chunk size, and the ground appends a 4-byte CSP CRC32
-// trailer we drop by clamping the data to 195.
-#define BULK_FILE_PACKET_TYPE      16
-#define BULK_FILE_HEADER_SIZE      5
-#define BULK_FILE_MAX_DATA         195
-#define BULK_FILE_MAX_PLAUSIBLE    (2 * 1024 * 1024)   // firmware caps a download at 1 MB
+// Bulk-file packet geometry lives in chunk_reasm.h: the firmware sends at most
+// REASM_BULK_MAX_DATA (195) file bytes per packet, so a lost byte range is
+// always a whole multiple of the chunk size.
 
 // A single comms_bulk_file_downlink telecommand can re-fetch at most this much
 // contiguous data: the firmware clamps max_bytes to
@@ -140,16 +146,27 @@ int main(int argc, char **argv)
 #define MPI_SESSION_GAP_MS         (15.0 * 60.0 * 1000.0)   // 15 minutes
 #define MPI_SESSION_MARGIN_MS      (120.0 * 1000.0)         // 2 minutes
 
+// Incremental state kept in the output directory (see the header comment).
+#define MPI_STATE_FILE             ".mpi_reconstruct.state"
+
+// One bulk_file chunk in the time index. The data bytes stay in the DB until
+// a session that needs them is reassembled.
 typedef struct {
-    double   ts_ms;    // reception time, unix ms
-    long     off;      // file offset (sane: 0 .. BULK_FILE_MAX_PLAUSIBLE)
-    int      rs;       // rs_errs: >=0 clean/corrected, -2 uncorrectable
-    long     dlen;     // data bytes (clamped to BULK_FILE_MAX_DATA)
-    int      has_sync; // this chunk's own bytes contain the MPI sync word
-    uint8_t *data;     // owned copy of the chunk's data bytes
-    char     ts_iso[32];
+    double    ts_ms;    // reception time, unix ms
+    long long id;       // packet row id
+    char      ts_iso[32];
 } chunk_t;
 
+// What a session was built from, as recorded in the state file. path is the
+// .bin written, or "-" for a session that did not hold enough MPI.
+typedef struct {
+    char      first_ts[32], last_ts[32];
+    long      n_packets;
+    long long max_id;
+    int       fill, min_sync;
+    char      path[1200];
+} session_sig_t;
+
 typedef struct {
     const char *db_path;
     const char *since;
@@ -159,6 +176,7 @@ typedef struct {
     uint8_t     fill;
     int         min_sync;
     long        max_dl;   // per-command re-download cap (firmware's max_bytes)
+    int         rebuild;  // ignore the incremental state
     int         quiet;
 } args_t;
 
@@ -224,14 +242,19 @@ static int parse_args(args_t *a, int argc, char **argv, int help)
             if (help) parse_help_line(OPTW, "--max-download=<n>", "per-command re-download cap in bytes (default 1000000)");
             else {
                 long v = strtol(arg + 15, NULL, 0);
-                if (v < BULK_FILE_MAX_DATA) {
-                    fprintf(stderr, "mpi_reconstruct: --max-download must be >= %d\n", BULK_FILE_MAX_DATA);
+                if (v < REASM_BULK_MAX_DATA) {
+                    fprintf(stderr, "mpi_reconstruct: --max-download must be >= %d\n", REASM_BULK_MAX_DATA);
                     return PARSE_ERROR;
                 }
                 a->max_dl = v;
             }
             matched = 1;
         }
+        if (strcmp(arg, "--rebuild") == 0 || help) {
+            if (help) parse_help_line(OPTW, "--rebuild", "reassemble every session, ignoring the last run's state");
+            else a->rebuild = 1;
+            matched = 1;
+        }
         if (strcmp(arg, "--quiet") == 0 || help) {
             if (help) parse_help_line(OPTW, "--quiet", "only print the files written");
             else a->quiet = 1;
@@ -250,138 +273,119 @@ static int parse_args(args_t *a, int argc, char **argv, int help)
     return help ? PARSE_HELP : PARSE_OK;
 }
 
-// Little-endian uint32 file offset out of a bulk_file payload.
-static long bulk_offset(const uint8_t *pl)
-{
-    return (long) pl[1] | ((long) pl[2] << 8)
-         | ((long) pl[3] << 16) | ((long) pl[4] << 24);
-}
-
-// Load every bulk_file chunk with a sane offset (optionally within the
-// since/until window), oldest first. Returns a malloc'd array in *out and its
-// length; -1 on error.
-static int load_chunks(sqlite3 *db, const char *since_iso, const char *until_iso,
-                       chunk_t **out, int *out_n)
+// Index every bulk_file chunk with a sane offset (optionally within the
+// since/until window), oldest first: time, id and whether the chunk's own bytes
+// carry the MPI sync word, which is all the session split needs. The payload is
+// cut to its header in the query, so no chunk data is copied here. Returns a
+// malloc'd array in *out (with the parallel ts_ms / has_sync arrays
+// reasm_sessions takes) and its length; -1 on error.
+static int load_index(sqlite3 *db, const char *since_iso, const char *until_iso,
+                      chunk_t **out, double **out_ts, unsigned char **out_sync, size_t *out_n)
 {
     // ts_ms as unix ms, same expression packet_browser uses for burst timing.
+    // aux is the full payload length; column 6 flags the sync word inside the
+    // (CRC-trailer-free) data bytes.
     const char *sql =
-        "SELECT (julianday(ts_received) - 2440587.5) * 86400000.0, "
-        "       ts_received, payload, rs_errs "
+        "SELECT id, ts_received, substr(payload, 1, 5), rs_errs, "
+        "       (julianday(ts_received) - 2440587.5) * 86400000.0, "
+        "       length(payload), "
+        "       instr(substr(payload, 6, 195), X'0CFFFF0C') > 0 "
         "FROM packet WHERE packet_type=16 "
         "  AND (?1 = '' OR ts_received >= ?1) "
         "  AND (?2 = '' OR ts_received <= ?2) "
         "ORDER BY ts_received, id";
-    sqlite3_stmt *st = NULL;
-    if (sqlite3_prepare_v2(db, sql, -1, &st, NULL) != SQLITE_OK) {
-        fprintf(stderr, "mpi_reconstruct: query failed: %s\n", sqlite3_errmsg(db));
-        return -1;
-    }
-    sqlite3_bind_text(st, 1, since_iso ? since_iso : "", -1, SQLITE_STATIC);
-    sqlite3_bind_text(st, 2, until_iso ? until_iso : "", -1, SQLITE_STATIC);
+    reasm_cursor_t cur;
+    if (reasm_cursor_open(&cur, db, sql, "mpi_reconstruct") != 0) return -1;
+    sqlite3_bind_text(cur.st, 1, since_iso ? since_iso : "", -1, SQLITE_STATIC);
+    sqlite3_bind_text(cur.st, 2, until_iso ? until_iso : "", -1, SQLITE_STATIC);
 
     chunk_t *cs = NULL;
-    int n = 0, cap = 0;
-    while (sqlite3_step(st) == SQLITE_ROW) {
-        const uint8_t *pl = (const uint8_t *) sqlite3_column_blob(st, 2);
-        int pl_len = sqlite3_column_bytes(st, 2);
-        if (pl == NULL || pl_len < BULK_FILE_HEADER_SIZE + 1) continue;
-        long off = bulk_offset(pl);
-        if (off < 0 || off > BULK_FILE_MAX_PLAUSIBLE) continue;   // bit-flipped offset
-
-        long dlen = pl_len - BULK_FILE_HEADER_SIZE;
-        if (dlen > BULK_FILE_MAX_DATA) dlen = BULK_FILE_MAX_DATA;  // drop CSP CRC32 trailer
-        if (off + dlen > BULK_FILE_MAX_PLAUSIBLE) continue;
+    double *ts = NULL;
+    unsigned char *sync = NULL;
+    size_t n = 0, cap = 0;
+    int row;
+    while ((row = reasm_cursor_next(&cur)) == 1) {
+        // Run the header through the same checks the reassembly applies, with
+        // the real payload length in place of the truncated one.
+        long off, dlen;
+        const uint8_t *data;
+        if (cur.payload_len < REASM_BULK_HEADER_SIZE
+            || reasm_bulk_chunk(cur.payload, (int) cur.aux, &off, &data, &dlen) != 0)
+            continue;
 
         if (n == cap) {
-            int ncap = cap ? cap * 2 : 256;
-            chunk_t *t = (chunk_t *) realloc(cs, (size_t) ncap * sizeof *cs);
-            if (t == NULL) { fprintf(stderr, "out of memory\n"); goto fail; }
-            cs = t; cap = ncap;
+            size_t ncap = cap ? cap * 2 : 256;
+            chunk_t *t = realloc(cs, ncap * sizeof *cs);
+            if (t) cs = t;
+            double *t2 = realloc(ts, ncap * sizeof *ts);
+            if (t2) ts = t2;
+            unsigned char *t3 = realloc(sync, ncap);
+            if (t3) sync = t3;
+            if (t == NULL || t2 == NULL || t3 == NULL) { fprintf(stderr, "out of memory\n"); goto fail; }
+            cap = ncap;
         }
         chunk_t *c = &cs[n];
-        memset(c, 0, sizeof *c);
-        c->ts_ms = sqlite3_column_double(st, 0);
-        c->off   = off;
-        c->rs    = sqlite3_column_int(st, 3);
-        c->dlen  = dlen;
-        c->data  = (uint8_t *) malloc((size_t) dlen);
-        if (c->data == NULL) { fprintf(stderr, "out of memory\n"); goto fail; }
-        memcpy(c->data, pl + BULK_FILE_HEADER_SIZE, (size_t) dlen);
-        // Does this chunk's own bytes carry the MPI sync word? Used to find the
-        // download that is MPI and scope it in time (see the session loop).
-        c->has_sync = 0;
-        for (long k = 0; k + MPI_SYNC_WORD_LEN <= dlen; k++)
-            if (memcmp(c->data + k, MPI_SYNC_WORD, MPI_SYNC_WORD_LEN) == 0) { c->has_sync = 1; break; }
-        const char *ts = (const char *) sqlite3_column_text(st, 1);
-        snprintf(c->ts_iso, sizeof c->ts_iso, "%s", ts ? ts : "");
+        c->ts_ms = cur.ts_ms;
+        c->id = cur.id;
+        snprintf(c->ts_iso, sizeof c->ts_iso, "%s", cur.ts_received ? cur.ts_received : "");
+        ts[n] = cur.ts_ms;
+        sync[n] = (unsigned char) sqlite3_column_int(cur.st, 6);
         n++;
     }
-    sqlite3_finalize(st);
+    if (row < 0) {
+        fprintf(stderr, "mpi_reconstruct: query failed: %s\n", sqlite3_errmsg(db));
+        goto fail;
+    }
+    reasm_cursor_close(&cur);
     *out = cs;
+    *out_ts = ts;
+    *out_sync = sync;
     *out_n = n;
     return 0;
 
 fail:
-    for (int i = 0; i < n; i++) free(cs[i].data);
-    free(cs);
-    sqlite3_finalize(st);
+    free(cs); free(ts); free(sync);
+    reasm_cursor_close(&cur);
     return -1;
 }
 
-// Reassemble the chunks named by idx[0..nidx) by absolute file offset into a
-// freshly allocated buffer. Bulk offsets are absolute file positions, so chunks
-// from different passes of the same download merge here regardless of when they
-// arrived. Every byte starts as a gap; RS-clean chunks are placed first
-// (phase 0) and uncorrectable chunks (rs_errs == -2) fill only bytes still
-// missing (phase 1), so good data is never clobbered. present[] marks filled
-// bytes. *out_min_off is the lowest offset that carried data (start of the
-// received region). *out_conflicts counts bytes where two RS-clean chunks
-// disagreed -- a sign the window mixes more than one file. Returns the buffer
-// size (file span), or -1 on error; *out_buf / *out_present are owned by the
-// caller.
-static long reassemble(const chunk_t *cs, const int *idx, int nidx, uint8_t fill,
-                       uint8_t **out_buf, uint8_t **out_present, long *out_min_off,
-                       long *out_conflicts)
+// Stream the chunks of one session -- reception times first_ts .. last_ts,
+// ids up to max_id so rows a receiver adds mid-run wait for the next run --
+// into *m by absolute file offset. Bulk offsets are absolute file positions,
+// so chunks from different passes of the same download merge here regardless
+// of when they arrived. RS-clean chunks win; uncorrectable chunks (rs_errs ==
+// -2) fill only bytes still missing, so good data is never clobbered. Two
+// RS-clean chunks that disagree show up in m->conflicts -- a sign the window
+// mixes more than one file. Returns the number of chunks laid, or -1.
+static long reassemble(sqlite3 *db, const char *first_ts, const char *last_ts,
+                       long long max_id, reasm_map_t *m)
 {
-    long size = 0, min_off = -1;
-    for (int j = 0; j < nidx; j++) {
-        const chunk_t *c = &cs[idx[j]];
-        if (c->off + c->dlen > size) size = c->off + c->dlen;
-    }
-    if (size <= 0) return -1;
-
-    uint8_t *buf     = (uint8_t *) malloc((size_t) size);
-    uint8_t *present = (uint8_t *) calloc((size_t) size, 1);
-    if (buf == NULL || present == NULL) { free(buf); free(present); return -1; }
-    memset(buf, fill, (size_t) size);
-
-    long conflicts = 0;
-    for (int phase = 0; phase < 2; phase++) {
-        for (int j = 0; j < nidx; j++) {
-            const chunk_t *c = &cs[idx[j]];
-            int clean = (c->rs >= 0);              // rs_errs == -2 is uncorrectable
-            if ((phase == 0) != clean) continue;    // phase 0 clean, phase 1 the rest
-            long off = c->off;
-            for (long k = 0; k < c->dlen && off + k < size; k++) {
-                if (present[off + k]) {
-                    // Two RS-clean chunks landing different bytes here means the
-                    // window holds more than one file at this offset.
-                    if (phase == 0 && buf[off + k] != c->data[k]) conflicts++;
-                    if (phase == 1) continue;        // never clobber good data
-                }
-                buf[off + k] = c->data[k];
-                present[off + k] = 1;
-            }
-            if (min_off < 0 || off < min_off) min_off = off;
+    const char *sql =
+        "SELECT id, ts_received, payload, rs_errs "
+        "FROM packet WHERE packet_type=16 "
+        "  AND ts_received >= ?1 AND ts_received <= ?2 AND id <= ?3 "
+        "ORDER BY ts_received, id";
+    reasm_cursor_t cur;
+    if (reasm_cursor_open(&cur, db, sql, "mpi_reconstruct") != 0) return -1;
+    sqlite3_bind_text(cur.st, 1, first_ts, -1, SQLITE_STATIC);
+    sqlite3_bind_text(cur.st, 2, last_ts, -1, SQLITE_STATIC);
+    sqlite3_bind_int64(cur.st, 3, (sqlite3_int64) max_id);
+
+    long n = 0;
+    int row;
+    while ((row = reasm_cursor_next(&cur)) == 1) {
+        long off, dlen;
+        const uint8_t *data;
+        if (reasm_bulk_chunk(cur.payload, cur.payload_len, &off, &data, &dlen) != 0) continue;
+        if (reasm_map_insert(m, off, data, dlen, cur.rs_errs >= 0) < 0) {
+            fprintf(stderr, "out of memory\n");
+            break;
         }
+        n++;
     }
-    if (min_off < 0) min_off = 0;
-
-    *out_buf = buf;
-    *out_present = present;
-    *out_min_off = min_off;
-    *out_conflicts = conflicts;
-    return size;
+    if (row < 0) fprintf(stderr, "mpi_reconstruct: query failed: %s\n", sqlite3_errmsg(db));
+    reasm_cursor_close(&cur);
+    return row == 0 ? n : -1;
 }
 
 // Count non-overlapping MPI sync words in buf.
@@ -463,40 +467,33 @@ static void emit_run(const char *sat_file_path, long cs, long ce, long size,
 // non-multiple of 195 is the command reaching the file's genuinely partial last
 // packet. (The download's chunks came from passes on different 195-byte grids,
 // which is why raw gaps land off-grid; the re-download uses the canonical grid.)
-static void report_gaps(const uint8_t *present, long size,
+static void report_gaps(const reasm_map_t *m,
                         const char *sat_file_path, long max_dl, int quiet)
 {
-    const long PKT = BULK_FILE_MAX_DATA;         // 195 bytes per downlink packet
+    const long PKT = REASM_BULK_MAX_DATA;        // 195 bytes per downlink packet
     long tile = (max_dl / PKT) * PKT;            // per-command cap, whole packets
     if (tile < PKT) tile = PKT;
+    long size = m->size;
 
     if (!quiet) printf("  re-download (fewest telecommands, whole 195-byte packets):\n");
     long n_cmds = 0, missing = 0, download = 0;
-    long run_start = -1;
     long cs = -1, ce = -1;   // pending request [cs, ce), snapped to the packet grid
 
-    // Iterate one past the end so a gap that runs to EOF is closed.
-    for (long i = 0; i <= size; i++) {
-        int gap = (i < size) && !present[i];
-        if (gap && run_start < 0) {
-            run_start = i;
-        } else if (!gap && run_start >= 0) {
-            long a = run_start, b = i;
-            missing += b - a;
-            long sa = (a / PKT) * PKT;                    // snap down to a packet start
-            long sb = ((b + PKT - 1) / PKT) * PKT;        // snap up to a packet end
-            if (sb > size) sb = size;                     // last packet is partial at EOF
-            if (cs < 0) {
-                cs = sa; ce = sb;
-            } else if (sa <= ce) {
-                // Same or adjacent packet(s) as the pending request: coalesce.
-                // A fully-received packet in between makes sa > ce, so it splits.
-                if (sb > ce) ce = sb;
-            } else {
-                emit_run(sat_file_path, cs, ce, size, tile, quiet, &download, &n_cmds);
-                cs = sa; ce = sb;
-            }
-            run_start = -1;
+    long a, b = 0;
+    for (long from = 0; (a = reasm_map_next_gap(m, from, &b)) >= 0; from = b) {
+        missing += b - a;
+        long sa = (a / PKT) * PKT;                    // snap down to a packet start
+        long sb = ((b + PKT - 1) / PKT) * PKT;        // snap up to a packet end
+        if (sb > size) sb = size;                     // last packet is partial at EOF
+        if (cs < 0) {
+            cs = sa; ce = sb;
+        } else if (sa <= ce) {
+            // Same or adjacent packet(s) as the pending request: coalesce.
+            // A fully-received packet in between makes sa > ce, so it splits.
+            if (sb > ce) ce = sb;
+        } else {
+            emit_run(sat_file_path, cs, ce, size, tile, quiet, &download, &n_cmds);
+            cs = sa; ce = sb;
         }
     }
     if (cs >= 0)
@@ -509,6 +506,77 @@ static void report_gaps(const uint8_t *present, long size,
     }
 }
 
+// Read the state file left by the last run into a malloc'd array. A missing
+// file, or one written for a different DB, yields no entries.
+static size_t load_state(const char *path, const char *db_path, session_sig_t **out)
+{
+    *out = NULL;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return 0;
+    char line[1600];
+    session_sig_t *ss = NULL;
+    size_t n = 0, cap = 0;
+    int same_db = 0;
+    while (fgets(line, sizeof line, f)) {
+        line[strcspn(line, "\n")] = '\0';
+        if (strncmp(line, "db ", 3) == 0) { same_db = strcmp(line + 3, db_path) == 0; continue; }
+        if (!same_db || strncmp(line, "session ", 8) != 0) continue;
+        session_sig_t s;
+        int used = 0;
+        if (sscanf(line + 8, "%31s %31s %ld %lld %d %d %n", s.first_ts, s.last_ts,
+                   &s.n_packets, &s.max_id, &s.fill, &s.min_sync, &used) != 6 || used == 0)
+            continue;
+        snprintf(s.path, sizeof s.path, "%s", line + 8 + used);
+        if (n == cap) {
+            size_t ncap = cap ? cap * 2 : 16;
+            session_sig_t *t = realloc(ss, ncap * sizeof *t);
+            if (t == NULL) break;
+            ss = t; cap = ncap;
+        }
+        ss[n++] = s;
+    }
+    fclose(f);
+    *out = ss;
+    return n;
+}
+
+// The last run's entry for a session built from exactly the same packets and
+// options, or NULL.
+static const session_sig_t *find_state(const session_sig_t *ss, size_t n, const session_sig_t *s)
+{
+    for (size_t i = 0; i < n; ++i)
+        if (strcmp(ss[i].first_ts, s->first_ts) == 0 && strcmp(ss[i].last_ts, s->last_ts) == 0
+            && ss[i].n_packets == s->n_packets && ss[i].max_id == s->max_id
+            && ss[i].fill == s->fill && ss[i].min_sync == s->min_sync)
+            return &ss[i];
+    return NULL;
+}
+
+static int file_exists(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return 0;
+    fclose(f);
+    return 1;
+}
+
+// Rewrite the state file with this run's sessions. A failure only costs the
+// next run its shortcut, so it is a warning.
+static void save_state(const char *path, const char *db_path, const session_sig_t *ss, size_t n)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "mpi_reconstruct: warning: cannot write %s; the next run rebuilds every session\n", path);
+        return;
+    }
+    fprintf(f, "# mpi_reconstruct state: session <first_ts> <last_ts> <packets> <max_id> <fill> <min_sync> <file|->\n");
+    fprintf(f, "db %s\n", db_path);
+    for (size_t i = 0; i < n; ++i)
+        fprintf(f, "session %s %s %ld %lld %d %d %s\n", ss[i].first_ts, ss[i].last_ts,
+                ss[i].n_packets, ss[i].max_id, ss[i].fill, ss[i].min_sync, ss[i].path);
+    fclose(f);
+}
+
 int main(int argc, char **argv)
 {
     if (sso_version_handle(argc, argv, "mpi_reconstruct")) return 0;
@@ -553,103 +621,135 @@ int main(int argc, char **argv)
     }
 
     chunk_t *cs = NULL;
-    int n = 0;
-    if (load_chunks(db, since_iso, until_iso, &cs, &n) != 0) {
+    double *ts = NULL;
+    unsigned char *has_sync = NULL;
+    size_t n = 0;
+    if (load_index(db, since_iso, until_iso, &cs, &ts, &has_sync, &n) != 0) {
         sqlite3_close(db);
         return 1;
     }
-    sqlite3_close(db);
 
     if (n == 0) {
         fprintf(stderr, "mpi_reconstruct: no bulk_file packets found%s.\n",
                 (cfg.since || cfg.until) ? " in that time window" : "");
-        free(cs);
+        free(cs); free(ts); free(has_sync);
+        sqlite3_close(db);
         return 1;
     }
 
-    // Reusable index buffer for the chunks gathered into one session's window.
-    int *idx = (int *) malloc((size_t) n * sizeof *idx);
-    if (idx == NULL) {
+    // Cluster the sync-bearing chunks into download sessions (a gap over
+    // MPI_SESSION_GAP_MS between two sync-bearing chunks starts a new session --
+    // a later download of another file). Each session is one MPI file; its
+    // chunks may still span several passes, all merged by absolute offset.
+    // Chunks belonging to other files (a camera or ASCII log pulled at a
+    // different time) carry no sync word and fall outside every session
+    // window, so they are never mixed in. The window is the sync span padded
+    // by the margin, so the download's sync-free lead-in and tail-out chunks
+    // come along too.
+    reasm_session_t *sessions = NULL;
+    long n_sessions = reasm_sessions(ts, has_sync, n, MPI_SESSION_GAP_MS,
+                                     MPI_SESSION_MARGIN_MS, &sessions);
+    free(ts); free(has_sync);
+    if (n_sessions < 0) {
         fprintf(stderr, "out of memory\n");
-        for (int i = 0; i < n; i++) free(cs[i].data);
         free(cs);
+        sqlite3_close(db);
         return 1;
     }
 
-    // Walk the time-ordered chunks and cluster the sync-bearing ones into
-    // download sessions (a gap over MPI_SESSION_GAP_MS between two sync-bearing
-    // chunks starts a new session -- a later download of another file). Each
-    // session is one MPI file; its chunks may still span several passes, all
-    // merged by absolute offset. Chunks belonging to other files (a camera or
-    // ASCII log pulled at a different time) carry no sync word and fall outside
-    // every session window, so they are never mixed in.
+    char state_path[1200];
+    snprintf(state_path, sizeof state_path, "%s/%s",
+             (cfg.out_dir && cfg.out_dir[0]) ? cfg.out_dir : ".", MPI_STATE_FILE);
+    session_sig_t *prev = NULL;
+    size_t n_prev = cfg.rebuild ? 0 : load_state(state_path, db_path, &prev);
+    session_sig_t *now = calloc((size_t) n_sessions + 1, sizeof *now);
+
     int rc = 0, n_files = 0;
-    int i = 0;
-    while (i < n) {
-        if (!cs[i].has_sync) { i++; continue; }
-
-        double first_sync = cs[i].ts_ms, last_sync = cs[i].ts_ms;
-        int last_i = i;
-        for (int k = i + 1; k < n; k++) {
-            if (!cs[k].has_sync) continue;
-            if (cs[k].ts_ms - last_sync > MPI_SESSION_GAP_MS) break;
-            last_sync = cs[k].ts_ms; last_i = k;
+    size_t n_now = 0;
+    for (long si = 0; now != NULL && si < n_sessions; si++) {
+        const reasm_session_t *s = &sessions[si];
+        const chunk_t *first = &cs[s->lo], *last = &cs[s->hi - 1];
+        long npk = (long) (s->hi - s->lo);
+
+        session_sig_t *sig = &now[n_now];
+        snprintf(sig->first_ts, sizeof sig->first_ts, "%s", first->ts_iso);
+        snprintf(sig->last_ts, sizeof sig->last_ts, "%s", last->ts_iso);
+        sig->n_packets = npk;
+        sig->max_id = 0;
+        for (size_t k = s->lo; k < s->hi; k++)
+            if (cs[k].id > sig->max_id) sig->max_id = cs[k].id;
+        sig->fill = cfg.fill;
+        sig->min_sync = cfg.min_sync;
+
+        // Same packets as last run and the file still on disk: nothing to do.
+        const session_sig_t *old = find_state(prev, n_prev, sig);
+        if (old && (strcmp(old->path, "-") == 0 || file_exists(old->path))) {
+            snprintf(sig->path, sizeof sig->path, "%s", old->path);
+            n_now++;
+            if (strcmp(old->path, "-") == 0) continue;
+            if (cfg.quiet) printf("%s\n", old->path);
+            else printf("MPI file    : %s (unchanged, %ld packets)\n\n", old->path, npk);
+            n_files++;
+            continue;
         }
 
-        // Gather every chunk within the sync span padded by the margin, so the
-        // download's sync-free lead-in and tail-out chunks come along too.
-        double wlo = first_sync - MPI_SESSION_MARGIN_MS;
-        double whi = last_sync + MPI_SESSION_MARGIN_MS;
-        int nidx = 0, first = -1, last = -1;
-        for (int k = 0; k < n; k++) {
-            if (cs[k].ts_ms < wlo || cs[k].ts_ms > whi) continue;
-            idx[nidx++] = k;
-            if (first < 0) first = k;
-            last = k;
+        reasm_map_t m;
+        reasm_map_init(&m, cfg.fill);
+        if (reassemble(db, first->ts_iso, last->ts_iso, sig->max_id, &m) < 0) {
+            reasm_map_free(&m);
+            rc = 1;
+            continue;
         }
-        i = last_i + 1;   // resume after this session's sync chunks
-
-        uint8_t *buf = NULL, *present = NULL;
-        long min_off = 0, conflicts = 0;
-        long size = reassemble(cs, idx, nidx, cfg.fill, &buf, &present, &min_off, &conflicts);
-        long sync = (size > 0) ? count_sync(buf, size) : 0;
+        long size = m.size;
+        long sync = (size > 0) ? count_sync(m.bytes, size) : 0;
         if (size < MPI_MIN_FILE_BYTES || sync < cfg.min_sync) {
-            free(buf); free(present);
+            reasm_map_free(&m);
+            snprintf(sig->path, sizeof sig->path, "-");
+            n_now++;
             continue;   // this cluster does not hold enough MPI to be a file
         }
 
-        long present_bytes = 0;
-        for (long b = 0; b < size; b++) if (present[b]) present_bytes++;
-
         char stamp[32];
-        stamp_from_iso(cs[first].ts_iso, stamp, sizeof stamp);
+        stamp_from_iso(first->ts_iso, stamp, sizeof stamp);
         char out_path[1200];
-        if (write_mpi_file(cfg.out_dir, stamp, buf, size, out_path, sizeof out_path) != 0) {
+        if (write_mpi_file(cfg.out_dir, stamp, m.bytes, size, out_path, sizeof out_path) != 0) {
             rc = 1;
-        } else if (cfg.quiet) {
+            reasm_map_free(&m);
+            continue;
+        }
+        snprintf(sig->path, sizeof sig->path, "%s", out_path);
+        n_now++;
+        if (cfg.quiet) {
             printf("%s\n", out_path);
-            n_files++;
         } else {
             printf("MPI file    : %s\n", out_path);
-            printf("  received  : %.24s .. %.24s, %d packets, %ld sync words\n",
-                   cs[first].ts_iso, cs[last].ts_iso, nidx, sync);
+            printf("  received  : %.24s .. %.24s, %ld packets, %ld sync words\n",
+                   first->ts_iso, last->ts_iso, npk, sync);
             printf("  file      : %ld bytes (offset 0 .. %ld)\n", size, size);
             printf("  recovered : %ld of %ld bytes (%.1f%%); data spans offset %ld .. %ld\n",
-                   present_bytes, size,
-                   100.0 * (double) present_bytes / (double) size, min_off, size);
-            if (conflicts > 0)
+                   m.present, size,
+                   100.0 * (double) m.present / (double) size, m.min_off, size);
+            if (m.conflicts > 0)
                 printf("  warning   : %ld byte(s) where two clean chunks disagree -- this window\n"
                        "              may mix more than one file; scope it with --since/--until\n",
-                       conflicts);
-            report_gaps(present, size, cfg.sat_file_path, cfg.max_dl, cfg.quiet);
+                       m.conflicts);
+            report_gaps(&m, cfg.sat_file_path, cfg.max_dl, cfg.quiet);
             printf("\n");
-            n_files++;
         }
-        free(buf); free(present);
+        n_files++;
+        reasm_map_free(&m);
+    }
+    sqlite3_close(db);
+    if (now == NULL) {
+        fprintf(stderr, "out of memory\n");
+        rc = 1;
+    } else {
+        save_state(state_path, db_path, now, n_now);
     }
 
-    free(idx);
-    for (int i2 = 0; i2 < n; i2++) free(cs[i2].data);
+    free(now);
+    free(prev);
+    free(sessions);
     free(cs);
 
     if (n_files == 0) {
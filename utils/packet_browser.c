@@ -5,7 +5,9 @@
     Curses TUI over the packet DB written by the live and offline AX100
     receivers. Reads only — never writes — so it's safe to run alongside
     a receiver that's filling the same DB. Polls the DB at ~1 Hz so live
-    decodes appear in the list without the operator hitting reload.
+    decodes appear in the list without the operator hitting reload; a
+    poll only fetches the rows committed since the last one, and the
+    list pages in from the DB as it scrolls (see "Main-list window").
 
     Layout:
 
@@ -26,7 +28,9 @@
                        packets sharing that command's ts_sent, plus the
                        same-run log/bulk_file packets that follow); Esc /
                        Left / Backspace step back
-      r                reload now (auto-poll happens every ~1 s anyway)
+      r                reload from the newest packet (auto-poll picks up
+                       new rows every ~1 s anyway; `r` also re-reads rows
+                       updated in place, e.g. an rx_replay --update)
       t / T            cycle type filter: all → beacon → tcmd_response →
                        log → bulk_file → all (T cycles the other way)
       o                cycle origin filter: all → cts_ground → satnogs → all
@@ -98,7 +102,19 @@ int main(int argc, char **argv)
 #include <ncurses.h>
 #include <sqlite3.h>
 
-#define MAX_ROWS 1000
+// Rows fetched per keyset page of the main list, and the cap on the
+// command-group sub-view (a single command's responses + related rows).
+#define PAGE_ROWS        500
+#define GROUP_MAX_ROWS   1000
+// Page in another PAGE_ROWS once the selection is this close to either
+// end of the loaded window. Well under PAGE_ROWS so a trim (which keeps
+// PAGE_ROWS either side of the selection) never re-triggers a fetch.
+#define PAGE_TRIGGER     (PAGE_ROWS / 4)
+// Row-cache budget for the main list (--cache-mb=). A row_t is ~2.7 KB
+// plus its payload, so the default holds roughly 20k rows. The floor
+// keeps at least a page either side of the selection resident.
+#define CACHE_MB_DEFAULT 64
+#define CACHE_MB_MIN     4
 
 typedef struct {
     sqlite3_int64 id;
@@ -146,10 +162,13 @@ static const int ORIGIN_CYCLE_N = sizeof ORIGIN_CYCLE / sizeof ORIGIN_CYCLE[0];
 // sub-view (Enter on a tcmd_response). `rows` points at whichever is
 // active, so every render/scroll path that uses rows[]/n_rows/sel/top
 // works unchanged for both views. The inactive store keeps its rows and
-// payloads alive so returning from the sub-view is instant.
-static row_t   main_rows[MAX_ROWS];
-static row_t   group_rows[MAX_ROWS];
-static row_t  *rows = main_rows;
+// payloads alive so returning from the sub-view is instant. main_rows is
+// a growable window onto the filtered result (see "Main-list window"),
+// so `rows` is re-pointed whenever it is reallocated.
+static row_t  *main_rows = NULL;
+static int     main_cap = 0;
+static row_t   group_rows[GROUP_MAX_ROWS];
+static row_t  *rows = NULL;
 static int     n_rows = 0;
 static int     sel    = 0;
 static int     top    = 0;
@@ -222,6 +241,12 @@ static int      recon_is_cam = 0;       // reassembled bulk_file is a START_CAM
 static char     recon_cam_name[256] = ""; // auto JPEG filename offered by `c`
 
 static int     g_have_color = 0;
+// The DB carries the V5 full-text index (probed once at start-up); the
+// `/` search then pre-filters through it instead of scanning every row.
+static int     g_have_fts = 0;
+// The DB carries the V6 resp_ts_sent_ms column (probed likewise), so a
+// command's responses are an index seek rather than a payload scan.
+static int     g_have_resp_ts = 0;
 // draw_detail adds a "station: ..." line for satnogs rows, pulling the
 // station name and lat/lng/alt out of the obs's meta.json on demand. A
 // one-entry cache keyed by session_dir keeps the fopen/parse off the
@@ -462,48 +487,239 @@ static void fill_row(sqlite3_stmt *stmt, row_t *r)
     trim_tcmd_crc_trailer(r);
 }
 
-// Run the current filter against the DB and refresh `rows` / `n_rows`.
-// Selection (`sel`) is preserved by row id where possible — feeling
-// like the row "stays in place" across reloads is more important than
-// always landing on the freshest packet. If the previously-selected id
-// is gone, fall back to position 0. Only ever called for the main view
-// (the command-group sub-view has its own loader), so `rows` is
-// main_rows here.
-static void run_query(sqlite3 *db)
+// ---- Main-list window ----------------------------------------------------
+//
+// The main list is a window onto the filtered result in display order
+// (ts_received DESC, id DESC) rather than a fixed LIMIT snapshot, so a DB
+// with hundreds of thousands of packets scrolls as fast as an empty one
+// while a receiver is writing to it:
+//
+//   - Keyset paging. A page of PAGE_ROWS is fetched when the selection
+//     nears either end of the window, seeking past the (ts_received, id)
+//     of the edge row. idx_packet_ts (ts_received, with the rowid as its
+//     implicit tail) serves both the seek and the ORDER BY, so a page
+//     costs the same at row 500 as at row 500000.
+//   - Tail-follow. packet.id is AUTOINCREMENT, so everything committed
+//     since the last poll has id > hw_id. A poll first reads PRAGMA
+//     data_version, which sqlite bumps whenever another connection
+//     commits (no inotify on the -wal needed, and it works on every
+//     platform), and only if it moved fetches the id > hw_id rows that
+//     pass the filter and merges each into its sorted place. The paging
+//     queries are bounded to id <= hw_id, so a row reaches the window by
+//     exactly one of the two paths.
+//   - A memory budget (--cache-mb=). Once the window's rows + payloads
+//     exceed it, whole pages are evicted from the end farther from the
+//     selection; scrolling back there re-fetches them.
+//
+// Rows already in the window aren't re-read, so an in-place UPDATE of an
+// old row (an rx_replay --update geometry backfill) shows after `r`,
+// which reloads from the head.
+enum { PAGE_HEAD = 0, PAGE_OLDER, PAGE_NEWER, PAGE_BOTTOM, PAGE_TAIL };
+
+static long          main_base = 0;        // filtered rows above main_rows[0]
+static int           main_more_above = 0;  // newer rows exist but aren't loaded
+static int           main_more_below = 0;  // older rows exist but aren't loaded
+static size_t        main_bytes = 0;       // rows + payloads held in the window
+static size_t        cache_budget = (size_t) CACHE_MB_DEFAULT << 20;
+static sqlite3_int64 hw_id = 0;            // every id <= hw_id is accounted for
+static sqlite3_int64 last_data_version = -1;
+// One page of freshly fetched rows, staged before it's merged into the
+// window (which takes ownership of the payloads) or freed.
+static row_t         page_buf[PAGE_ROWS];
+
+// The main view reads rows/n_rows like the group view does; re-point them
+// after anything that can move or resize main_rows. Paging and
+// tail-follow only run while the main list is up.
+static void main_sync(void)
 {
-    sqlite3_int64 prev_id = (n_rows > 0) ? rows[sel].id : -1;
+    rows = main_rows;
+    n_rows = main_n;
+}
 
-    char sql[1024];
+static size_t row_bytes(const row_t *r)
+{
+    return sizeof *r + (size_t) r->payload_len;
+}
+
+// 1 if `a` lists above `b`: newer ts_received first, ties broken by id.
+// strcmp on the ISO strings is the same BINARY collation sqlite's ORDER
+// BY uses, so the C merge and the SQL keyset agree on every tie.
+static int row_newer(const row_t *a, const row_t *b)
+{
+    int c = strcmp(a->ts, b->ts);
+    return c > 0 || (c == 0 && a->id > b->id);
+}
+
+static int cmp_display_order(const void *pa, const void *pb)
+{
+    const row_t *a = pa, *b = pb;
+    if (row_newer(a, b)) return -1;
+    if (row_newer(b, a)) return 1;
+    return 0;
+}
+
+static void reverse_rows(row_t *arr, int n)
+{
+    for (int i = 0, j = n - 1; i < j; i++, j--) {
+        row_t t = arr[i];
+        arr[i] = arr[j];
+        arr[j] = t;
+    }
+}
+
+static int main_reserve(int need)
+{
+    if (need <= main_cap) return 0;
+    int cap = main_cap > 0 ? main_cap : PAGE_ROWS;
+    while (cap < need) cap *= 2;
+    row_t *p = realloc(main_rows, (size_t) cap * sizeof *p);
+    if (p == NULL) return -1;
+    main_rows = p;
+    main_cap = cap;
+    return 0;
+}
+
+static void main_clear(void)
+{
+    free_rows(main_rows, main_n);
+    main_n = 0;
+    main_bytes = 0;
+    main_base = 0;
+    main_more_above = 0;
+    main_more_below = 0;
+}
+
+// Merge `k` rows, already in display order, into the window and take
+// ownership of their payloads. One backward pass, so only the rows after
+// the first insertion point move. The selection stays on the same row;
+// so does the viewport, unless it's showing the head of the list, where
+// it stays put so new decodes scroll into view (the old full-reload feel).
+// Returns 0, or -1 (batch freed) if the window can't grow.
+static int main_merge(row_t *batch, int k)
+{
+    if (k <= 0) return 0;
+    if (main_reserve(main_n + k) != 0) {
+        free_rows(batch, k);
+        return -1;
+    }
+    int pin_top = (top == 0 && !main_more_above);
+    int new_sel = sel, new_top = top;
+    int i = main_n - 1, j = k - 1, w = main_n + k - 1;
+    while (j >= 0) {
+        if (i >= 0 && row_newer(&batch[j], &main_rows[i])) {
+            if (i == sel) new_sel = w;
+            if (i == top) new_top = w;
+            main_rows[w--] = main_rows[i--];
+        } else {
+            main_bytes += row_bytes(&batch[j]);
+            main_rows[w--] = batch[j--];
+        }
+    }
+    if (main_n > 0) {
+        sel = new_sel;
+        top = pin_top ? 0 : new_top;
+    }
+    main_n += k;
+    return 0;
+}
+
+static void main_drop_head(int k)
+{
+    for (int i = 0; i < k; i++) main_bytes -= row_bytes(&main_rows[i]);
+    free_rows(main_rows, k);
+    memmove(main_rows, main_rows + k, (size_t) (main_n - k) * sizeof *main_rows);
+    main_n -= k;
+    main_base += k;
+    main_more_above = 1;
+    sel -= k;
+    top -= k;
+    if (sel < 0) sel = 0;
+    if (top < 0) top = 0;
+}
+
+static void main_drop_tail(int k)
+{
+    for (int i = main_n - k; i < main_n; i++) main_bytes -= row_bytes(&main_rows[i]);
+    free_rows(main_rows + main_n - k, k);
+    main_n -= k;
+    main_more_below = 1;
+}
+
+// Evict up to a page at a time from whichever end of the window is
+// farther from the selection until it fits the budget again. PAGE_ROWS
+// stay resident either side of sel, so a trim never leaves the selection
+// inside PAGE_TRIGGER of an evicted edge.
+static void main_trim(void)
+{
+    while (main_bytes > cache_budget) {
+        int head_slack = sel - PAGE_ROWS;
+        int tail_slack = main_n - 1 - sel - PAGE_ROWS;
+        if (head_slack <= 0 && tail_slack <= 0) break;
+        if (head_slack >= tail_slack)
+            main_drop_head(head_slack < PAGE_ROWS ? head_slack : PAGE_ROWS);
+        else
+            main_drop_tail(tail_slack < PAGE_ROWS ? tail_slack : PAGE_ROWS);
+    }
+}
+
+// Single-value helper for the PRAGMA / MAX(id) / COUNT probes. Returns
+// -1 on any failure so callers can leave their state alone and retry.
+static sqlite3_int64 query_int64(sqlite3 *db, const char *sql,
+                                 const char *const *param_text, int n_params,
+                                 sqlite3_int64 id_param)
+{
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) return -1;
+    for (int i = 0; i < n_params; i++)
+        sqlite3_bind_text(stmt, i + 1, param_text[i], -1, SQLITE_TRANSIENT);
+    if (id_param >= 0) sqlite3_bind_int64(stmt, n_params + 1, id_param);
+    sqlite3_int64 v = -1;
+    if (sqlite3_step(stmt) == SQLITE_ROW) v = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return v;
+}
+
+// The current main-list filters as SQL: `head` followed by one
+// " AND ..." clause per active filter, with their text parameters bound
+// as ?1..?n_params. Shared by every page query and the count, so a page
+// fetched by scrolling always agrees with the head and the tail-follow.
+typedef struct {
+    char        sql[1536];
+    int         off;
+    int         n_params;
+    const char *param_text[6];
+    char        like_pattern[256];
+    char        fts_expr[600];
+} main_sql_t;
+
+static void main_sql_filters(main_sql_t *q, const char *head)
+{
     // Clamp off after each append: snprintf returns the would-be length, so a
     // truncated write leaves off past sizeof sql, and the next "sizeof sql -
     // off" (size_t) would wrap huge and sql + off go out of bounds.
-    int off = snprintf(sql, sizeof sql,
-        PACKET_SELECT_COLS
-        "FROM packet WHERE 1=1");
-    if (off < 0 || off > (int) sizeof sql) off = (int) sizeof sql;
-    int n_params = 0;
-    const char *param_text[5] = {0};
-    char like_pattern[256];
+    q->n_params = 0;
+    q->off = snprintf(q->sql, sizeof q->sql, "%s WHERE 1=1", head);
+    if (q->off < 0 || q->off > (int) sizeof q->sql) q->off = (int) sizeof q->sql;
     if (type_filter() != NULL) {
-        off += snprintf(sql + off, sizeof sql - off,
-                        " AND packet_type_name = ?%d", n_params + 1);
-        if (off > (int) sizeof sql) off = (int) sizeof sql;
-        param_text[n_params++] = type_filter();
+        q->off += snprintf(q->sql + q->off, sizeof q->sql - q->off,
+                           " AND packet_type_name = ?%d", q->n_params + 1);
+        if (q->off > (int) sizeof q->sql) q->off = (int) sizeof q->sql;
+        q->param_text[q->n_params++] = type_filter();
     }
     if (origin_filter() != NULL) {
-        off += snprintf(sql + off, sizeof sql - off,
-                        " AND capture_origin = ?%d", n_params + 1);
-        if (off > (int) sizeof sql) off = (int) sizeof sql;
-        param_text[n_params++] = origin_filter();
+        q->off += snprintf(q->sql + q->off, sizeof q->sql - q->off,
+                           " AND capture_origin = ?%d", q->n_params + 1);
+        if (q->off > (int) sizeof q->sql) q->off = (int) sizeof q->sql;
+        q->param_text[q->n_params++] = origin_filter();
     }
     if (hide_errors) {
         // Mirror row_has_error(): drop RS-uncorrectable / HMAC-mismatch /
         // CRC-fail rows. These columns are always stored as ints (the
         // -1 "not checked" sentinel included), never NULL, so a plain
         // boolean test is safe — no COALESCE needed.
-        off += snprintf(sql + off, sizeof sql - off,
-                        " AND NOT (rs_errs = -2 OR hmac_ok = 0 OR crc_status = 0)");
-        if (off > (int) sizeof sql) off = (int) sizeof sql;
+        q->off += snprintf(q->sql + q->off, sizeof q->sql - q->off,
+                           " AND NOT (rs_errs = -2 OR hmac_ok = 0 OR crc_status = 0)");
+        if (q->off > (int) sizeof q->sql) q->off = (int) sizeof q->sql;
     }
     if (like_text[0] != '\0') {
         // A substring search over the decoded body, OR'd with a match on
@@ -513,52 +729,225 @@ static void run_query(sqlite3 *db)
         // decoded text like any other term and also surfaces its
         // observation. ?N is the %like% pattern (decoded_summary), ?N+1 is
         // the raw text (obs id), reused twice and so bound once.
-        snprintf(like_pattern, sizeof like_pattern, "%%%s%%", like_text);
-        off += snprintf(sql + off, sizeof sql - off,
-                        " AND (decoded_summary LIKE ?%d"
-                        " OR session_dir = ?%d OR session_dir LIKE '%%/' || ?%d)",
-                        n_params + 1, n_params + 2, n_params + 2);
-        if (off > (int) sizeof sql) off = (int) sizeof sql;
-        param_text[n_params++] = like_pattern;
-        param_text[n_params++] = like_text;
-    }
-    snprintf(sql + off, sizeof sql - off,
-             " ORDER BY ts_received DESC LIMIT %d", MAX_ROWS);
+        snprintf(q->like_pattern, sizeof q->like_pattern, "%%%s%%", like_text);
+        // With the V5 full-text index, read only its hits and let the LIKE
+        // below re-check them (same rows, no scan); see packet_db_fts_match.
+        if (g_have_fts
+            && packet_db_fts_match(q->like_pattern, "decoded_summary session_dir",
+                                   q->fts_expr, sizeof q->fts_expr) > 0) {
+            q->off += snprintf(q->sql + q->off, sizeof q->sql - q->off,
+                               " AND id IN (SELECT rowid FROM " PACKET_DB_FTS_TABLE
+                               " WHERE " PACKET_DB_FTS_TABLE " MATCH ?%d)",
+                               q->n_params + 1);
+            if (q->off > (int) sizeof q->sql) q->off = (int) sizeof q->sql;
+            q->param_text[q->n_params++] = q->fts_expr;
+        }
+        q->off += snprintf(q->sql + q->off, sizeof q->sql - q->off,
+                           " AND (decoded_summary LIKE ?%d"
+                           " OR session_dir = ?%d OR session_dir LIKE '%%/' || ?%d)",
+                           q->n_params + 1, q->n_params + 2, q->n_params + 2);
+        if (q->off > (int) sizeof q->sql) q->off = (int) sizeof q->sql;
+        q->param_text[q->n_params++] = q->like_pattern;
+        q->param_text[q->n_params++] = like_text;
+    }
+}
+
+// Fetch one page of the filtered result into page_buf. `mode` picks the
+// slice: PAGE_HEAD / PAGE_BOTTOM are the newest / oldest PAGE_ROWS,
+// PAGE_OLDER / PAGE_NEWER seek past `edge` (the window's last / first
+// row), PAGE_TAIL is the rows with lo_id < id in id order. Every mode is
+// bounded to id <= hi_id. PAGE_NEWER and PAGE_BOTTOM come back oldest
+// first; the caller reverses them. Returns the row count or -1.
+static int fetch_page(sqlite3 *db, int mode, const row_t *edge,
+                      sqlite3_int64 lo_id, sqlite3_int64 hi_id)
+{
+    main_sql_t q;
+    main_sql_filters(&q, PACKET_SELECT_COLS "FROM packet");
+    int h = q.n_params + 1;   // ?h = hi_id, ?h+1 / ?h+2 = the seek key
+    const char *tail = "";
+    switch (mode) {
+    case PAGE_HEAD:
+        tail = " AND id <= ?%d ORDER BY ts_received DESC, id DESC LIMIT %d";
+        break;
+    case PAGE_OLDER:
+        tail = " AND id <= ?%d AND (ts_received, id) < (?%d, ?%d)"
+               " ORDER BY ts_received DESC, id DESC LIMIT %d";
+        break;
+    case PAGE_NEWER:
+        tail = " AND id <= ?%d AND (ts_received, id) > (?%d, ?%d)"
+               " ORDER BY ts_received ASC, id ASC LIMIT %d";
+        break;
+    case PAGE_BOTTOM:
+        tail = " AND id <= ?%d ORDER BY ts_received ASC, id ASC LIMIT %d";
+        break;
+    case PAGE_TAIL:
+        tail = " AND id <= ?%d AND id > ?%d ORDER BY id LIMIT %d";
+        break;
+    }
+    int seek = (mode == PAGE_OLDER || mode == PAGE_NEWER);
+    if (seek)
+        snprintf(q.sql + q.off, sizeof q.sql - q.off, tail, h, h + 1, h + 2, PAGE_ROWS);
+    else if (mode == PAGE_TAIL)
+        snprintf(q.sql + q.off, sizeof q.sql - q.off, tail, h, h + 1, PAGE_ROWS);
+    else
+        snprintf(q.sql + q.off, sizeof q.sql - q.off, tail, h, PAGE_ROWS);
 
     sqlite3_stmt *stmt = NULL;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        // Leave the existing rows in place rather than clearing — a
-        // transient prepare failure shouldn't blank the screen.
-        return;
+    if (sqlite3_prepare_v2(db, q.sql, -1, &stmt, NULL) != SQLITE_OK) return -1;
+    for (int i = 0; i < q.n_params; i++)
+        sqlite3_bind_text(stmt, i + 1, q.param_text[i], -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, h, hi_id);
+    if (seek) {
+        sqlite3_bind_text(stmt, h + 1, edge->ts, -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, h + 2, edge->id);
+    } else if (mode == PAGE_TAIL) {
+        sqlite3_bind_int64(stmt, h + 1, lo_id);
+    }
+    int k = 0;
+    int rc = SQLITE_DONE;
+    while (k < PAGE_ROWS && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        fill_row(stmt, &page_buf[k]);
+        k++;
     }
-    for (int i = 0; i < n_params; i++) {
-        sqlite3_bind_text(stmt, i + 1, param_text[i], -1, SQLITE_TRANSIENT);
+    sqlite3_finalize(stmt);
+    if (k < PAGE_ROWS && rc != SQLITE_DONE) {
+        // Busy / error mid-page: don't report a short page as the end of
+        // the result. Drop it and let the caller retry on the next pass.
+        free_rows(page_buf, k);
+        return -1;
     }
+    return k;
+}
 
-    // Free payloads from the previous load (the rows array is reused
-    // across reloads) so re-querying doesn't leak.
-    free_rows(rows, n_rows);
+// Reload the window from the head of the filtered result and refresh
+// `rows` / `n_rows`. Selection (`sel`) is preserved by row id where the
+// row is in the first page — feeling like the row "stays in place"
+// across a reload is more important than always landing on the freshest
+// packet — else it falls back to position 0. Called on start-up, `r`,
+// `g`/Home past the window, and every filter change; the 1 Hz poll is
+// follow_tail(). Only ever called for the main view (the command-group
+// sub-view has its own loader).
+static void run_query(sqlite3 *db)
+{
+    sqlite3_int64 prev_id = (n_rows > 0) ? rows[sel].id : -1;
 
-    int new_n = 0;
-    while (new_n < MAX_ROWS && sqlite3_step(stmt) == SQLITE_ROW) {
-        fill_row(stmt, &rows[new_n]);
-        new_n++;
+    sqlite3_int64 hw = query_int64(db, "SELECT COALESCE(MAX(id), 0) FROM packet",
+                                   NULL, 0, -1);
+    int k = (hw >= 0) ? fetch_page(db, PAGE_HEAD, NULL, 0, hw) : -1;
+    if (k < 0) {
+        // Leave the existing rows in place rather than clearing — a
+        // transient prepare failure shouldn't blank the screen.
+        return;
     }
-    sqlite3_finalize(stmt);
-    n_rows = new_n;
-    main_n = new_n;  // keep the main count current for the sub-view save/restore
+    main_clear();
+    hw_id = hw;
+    main_more_below = (k == PAGE_ROWS);
+    sel = 0;
+    top = 0;
+    main_merge(page_buf, k);
+    main_sync();
 
     // Re-seat the selection on the same id when possible.
-    sel = 0;
     if (prev_id >= 0) {
         for (int i = 0; i < n_rows; i++) {
             if (rows[i].id == prev_id) { sel = i; break; }
         }
     }
-    if (sel < 0) sel = 0;
     if (sel >= n_rows) sel = n_rows > 0 ? n_rows - 1 : 0;
 }
 
+// Jump the window to the oldest page of the filtered result (End / G).
+// One COUNT under the filter gives the list position of the first row
+// for the "#" column; the scan is the price of jumping to the far end
+// and is only paid on this explicit key.
+static void load_bottom(sqlite3 *db)
+{
+    if (!main_more_below) {
+        sel = n_rows > 0 ? n_rows - 1 : 0;
+        return;
+    }
+    main_sql_t q;
+    main_sql_filters(&q, "SELECT COUNT(*) FROM packet");
+    snprintf(q.sql + q.off, sizeof q.sql - q.off, " AND id <= ?%d", q.n_params + 1);
+    sqlite3_int64 total = query_int64(db, q.sql, q.param_text, q.n_params, hw_id);
+    int k = (total >= 0) ? fetch_page(db, PAGE_BOTTOM, NULL, 0, hw_id) : -1;
+    if (k < 0) return;
+    reverse_rows(page_buf, k);
+    main_clear();
+    sel = 0;
+    top = 0;
+    main_merge(page_buf, k);
+    main_base = (total > k) ? (long) (total - k) : 0;
+    main_more_above = main_base > 0;
+    main_sync();
+    sel = n_rows > 0 ? n_rows - 1 : 0;
+}
+
+// Page in older rows once the selection nears the bottom of the window,
+// newer ones once it nears the top, trimming the far end to the budget.
+static void page_window(sqlite3 *db)
+{
+    if (main_more_below && main_n > 0 && main_n - 1 - sel < PAGE_TRIGGER) {
+        int k = fetch_page(db, PAGE_OLDER, &main_rows[main_n - 1], 0, hw_id);
+        if (k >= 0) {
+            main_more_below = (k == PAGE_ROWS);
+            main_merge(page_buf, k);
+            main_trim();
+        }
+    }
+    if (main_more_above && main_n > 0 && sel < PAGE_TRIGGER) {
+        int k = fetch_page(db, PAGE_NEWER, &main_rows[0], 0, hw_id);
+        if (k >= 0) {
+            reverse_rows(page_buf, k);
+            main_merge(page_buf, k);
+            main_more_above = (k == PAGE_ROWS);
+            main_base -= k;
+            // A short page is the true head: main_base is exactly 0 even
+            // if tail-follow's running count drifted.
+            if (!main_more_above || main_base < 0) main_base = 0;
+            main_trim();
+        }
+    }
+    main_sync();
+}
+
+// 1 Hz poll: merge rows committed since the last one. A row that sorts
+// above an evicted head only bumps main_base; one below an unloaded tail
+// is left for paging (both queries see it, exactly one delivers it).
+static void follow_tail(sqlite3 *db)
+{
+    sqlite3_int64 dv = query_int64(db, "PRAGMA data_version", NULL, 0, -1);
+    if (dv >= 0 && dv == last_data_version) return;
+    sqlite3_int64 hw = query_int64(db, "SELECT COALESCE(MAX(id), 0) FROM packet",
+                                   NULL, 0, -1);
+    if (hw < 0) return;
+    while (hw > hw_id) {
+        int k = fetch_page(db, PAGE_TAIL, NULL, hw_id, hw);
+        if (k < 0) break;   // retry from hw_id on the next poll
+        sqlite3_int64 last = (k > 0) ? page_buf[k - 1].id : hw;
+        qsort(page_buf, (size_t) k, sizeof page_buf[0], cmp_display_order);
+        int keep = 0;
+        for (int i = 0; i < k; i++) {
+            row_t *r = &page_buf[i];
+            int skip = 0;
+            if (main_n > 0 && main_more_above && row_newer(r, &main_rows[0])) {
+                main_base++;
+                skip = 1;
+            } else if (main_n > 0 && main_more_below
+                       && row_newer(&main_rows[main_n - 1], r)) {
+                skip = 1;
+            }
+            if (skip) free_rows(r, 1);
+            else      page_buf[keep++] = *r;
+        }
+        main_merge(page_buf, keep);
+        hw_id = (k < PAGE_ROWS) ? hw : last;
+    }
+    if (hw_id >= hw) last_data_version = dv;
+    main_trim();
+    main_sync();
+}
+
 // ---- Command-group sub-view (Enter on a tcmd_response) -----------------
 
 // How long after a command's first response a same-run log / bulk_file
@@ -577,6 +966,23 @@ static int row_ts_sent(const row_t *r, uint64_t *out_ms)
     return tcmd_resp_ts_sent_u64(r->payload, (size_t) r->payload_len, out_ms) == 0;
 }
 
+// WHERE term selecting one command's tcmd_responses by ts_sent, with the
+// key in ?1 (bind it with bind_resp_key): the indexed V6 column when the
+// DB has it, else the substr(payload,2,8) blob match older DBs need.
+static const char *resp_key_where(void)
+{
+    return g_have_resp_ts ? PACKET_DB_RESP_TS_COL "=?1"
+                          : TCMD_RESP_SQL_IS " AND " TCMD_RESP_SQL_TS_SENT "=?1";
+}
+
+static void bind_resp_key(sqlite3_stmt *stmt, const uint8_t key[8])
+{
+    if (g_have_resp_ts)
+        sqlite3_bind_int64(stmt, 1, (sqlite3_int64) tcmd_resp_key_to_u64(key));
+    else
+        sqlite3_bind_blob(stmt, 1, key, 8, SQLITE_TRANSIENT);
+}
+
 
 // Search the agenda files under the data root for "@tssent=<ms>" and
 // copy the first matching line into `out`. Best-effort fallback used
@@ -661,7 +1067,7 @@ static int group_append(sqlite3 *db, const char *sql,
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) return 0;
     if (bind) bind(stmt, ctx);
     int added = 0;
-    while (group_n < MAX_ROWS && sqlite3_step(stmt) == SQLITE_ROW) {
+    while (group_n < GROUP_MAX_ROWS && sqlite3_step(stmt) == SQLITE_ROW) {
         fill_row(stmt, &group_rows[group_n]);
         group_n++;
         added++;
@@ -673,8 +1079,7 @@ static int group_append(sqlite3 *db, const char *sql,
 static void bind_group_confirmed(sqlite3_stmt *stmt, void *ctx)
 {
     (void)ctx;
-    // The 8 raw ts_sent bytes match the BLOB slice substr(payload,2,8).
-    sqlite3_bind_blob(stmt, 1, group_key, 8, SQLITE_TRANSIENT);
+    bind_resp_key(stmt, group_key);
 }
 
 static void bind_group_related(sqlite3_stmt *stmt, void *ctx)
@@ -701,11 +1106,11 @@ static void build_group(sqlite3 *db)
 
     // Confirmed: every tcmd_response sharing this exact ts_sent, in
     // response-sequence order (response_seq_num), then by arrival time.
-    group_append(db,
-        PACKET_SELECT_COLS
-        "FROM packet WHERE " TCMD_RESP_SQL_IS " AND " TCMD_RESP_SQL_TS_SENT "=?1 "
-        "ORDER BY " TCMD_RESP_SQL_SEQ ", ts_received",
-        bind_group_confirmed, NULL);
+    char sql[1024];
+    snprintf(sql, sizeof sql,
+             PACKET_SELECT_COLS "FROM packet WHERE %s "
+             "ORDER BY " TCMD_RESP_SQL_SEQ ", ts_received", resp_key_where());
+    group_append(db, sql, bind_group_confirmed, NULL);
     group_confirmed_n = group_n;
 
     // Anchor the heuristic window at the earliest confirmed packet.
@@ -1139,13 +1544,13 @@ static void recon_build_tcmd(sqlite3 *db)
     uint8_t key[8];
     tcmd_resp_ts_sent(rows[sel].payload, (size_t) rows[sel].payload_len, key);  // ts_sent
 
-    const char *sql =
-        "SELECT payload FROM packet "
-        "WHERE " TCMD_RESP_SQL_IS " AND " TCMD_RESP_SQL_TS_SENT "=?1 "
-        "ORDER BY " TCMD_RESP_SQL_SEQ ", ts_received";
+    char sql[256];
+    snprintf(sql, sizeof sql,
+             "SELECT payload FROM packet WHERE %s "
+             "ORDER BY " TCMD_RESP_SQL_SEQ ", ts_received", resp_key_where());
     sqlite3_stmt *st = NULL;
     if (sqlite3_prepare_v2(db, sql, -1, &st, NULL) != SQLITE_OK) return;
-    sqlite3_bind_blob(st, 1, key, 8, SQLITE_TRANSIENT);
+    bind_resp_key(st, key);
 
     // Pass 1: size the buffer and read the expected fragment count.
     long size = 0; int maxseq = 0;
@@ -1307,9 +1712,10 @@ static int row_has_error(const row_t *r)
 // just show more whitespace at the end. The decoded_summary's first
 // line, after the leading "<type>: " prefix, is the most useful body
 // preview to show inline. `index_1based` is the row's position in the
-// current sorted view (1 = newest, n_rows = oldest) so the operator
-// can read off the total without computing it.
-static void format_list_line(const row_t *r, int index_1based,
+// current sorted view (1 = newest) so the operator can read off the
+// total without computing it; in the main list it counts from the head
+// of the whole filtered result, not the loaded window.
+static void format_list_line(const row_t *r, long index_1based,
                               char *out, size_t outn)
 {
     const char *summary_first = r->summary;
@@ -1323,7 +1729,7 @@ static void format_list_line(const row_t *r, int index_1based,
     int body_len = eol ? (int)(eol - summary_first) : (int)strlen(summary_first);
     char ts_disp[40];
     format_ts(r->ts, show_local_time, ts_disp, sizeof ts_disp);
-    snprintf(out, outn, "%6d  %-30.30s  %-13s  %-10s  %-13s  %-9s  %.*s",
+    snprintf(out, outn, "%6ld  %-30.30s  %-13s  %-10s  %-13s  %-9s  %.*s",
              index_1based,
              ts_disp, r->tool,
              r->origin[0] ? r->origin : "-",
@@ -1342,12 +1748,22 @@ static void draw_top_bar(int cols)
     if (in_group) {
         snprintf(buf, sizeof buf, " packet_browser  %s", group_header);
     } else {
+        // The whole result when it's all loaded, else the window's slice
+        // of it ("+" = older rows still to page in).
+        char count[64];
+        if (main_more_above || main_more_below)
+            snprintf(count, sizeof count, "rows %ld-%ld%s",
+                     main_base + 1, main_base + n_rows,
+                     main_more_below ? "+" : "");
+        else
+            snprintf(count, sizeof count, "%d row%s",
+                     n_rows, n_rows == 1 ? "" : "s");
         snprintf(buf, sizeof buf,
-                 " packet_browser  filter: type=%-13s origin=%-10s errors=%-6s  search=\"%s\"  | %d row%s",
+                 " packet_browser  filter: type=%-13s origin=%-10s errors=%-6s  search=\"%s\"  | %s",
                  type_filter() ? type_filter() : "all",
                  origin_filter() ? origin_filter() : "all",
                  hide_errors ? "hidden" : "shown",
-                 like_text, n_rows, n_rows == 1 ? "" : "s");
+                 like_text, count);
     }
     mvaddnstr(0, 0, buf, cols);
     if (g_have_color) attroff(COLOR_PAIR(PAIR_BAR));
@@ -1383,7 +1799,8 @@ static void draw_list(int list_top, int list_h, int cols)
         if (ridx >= n_rows) continue;
         row_t *r = &rows[ridx];
         char line[512];
-        format_list_line(r, ridx + 1, line, sizeof line);
+        format_list_line(r, (in_group ? 0 : main_base) + ridx + 1,
+                         line, sizeof line);
 
         int is_sel = (ridx == sel);
         int color = color_for_type(r->type_name);
@@ -2114,11 +2531,12 @@ static int prompt_search(int rows_total, int cols)
 // Parsed command-line configuration. parse_args() fills this; main() reads it.
 typedef struct {
     const char *db_path;
+    int         cache_mb;
 } pbr_args_t;
 
-// Option column width: the widest label below ("--db=<path>") + a small
-// margin. See src/cli/argparse.h for the parse_args convention.
-#define OPTW 13
+// Option column width: the widest label below ("--cache-mb=<MB>") + a
+// small margin. See src/cli/argparse.h for the parse_args convention.
+#define OPTW 17
 
 // Parse argv into *a (help == 0), or print one right-aligned help line per
 // option and return (help != 0). Each option is one self-contained block whose
@@ -2145,12 +2563,25 @@ static int parse_args(pbr_args_t *a, int argc, char **argv, int help)
             else a->db_path = arg + 5;
             matched = 1;
         }
+        if (starts_with(arg, "--cache-mb=") || help) {
+            if (help) parse_help_line(OPTW, "--cache-mb=<MB>", "main-list row cache budget (default 64, min 4); older pages are re-fetched on scroll");
+            else {
+                char *end = NULL;
+                long mb = strtol(arg + 11, &end, 10);
+                if (end == arg + 11 || *end != '\0' || mb < CACHE_MB_MIN || mb > 65536) {
+                    fprintf(stderr, "packet_browser: --cache-mb wants %d..65536, got '%s'\n",
+                            CACHE_MB_MIN, arg + 11);
+                    return PARSE_ERROR;
+                }
+                a->cache_mb = (int) mb;
+            }
+            matched = 1;
+        }
 
         if (!matched && !help) {
             // Original behaviour: any unrecognized argument prints usage to
-            // stderr and fails. The only option is --db=; anything else lands
-            // here.
-            fprintf(stderr, "usage: %s [--db=<path>]\n", argv[0]);
+            // stderr and fails.
+            fprintf(stderr, "usage: %s [--db=<path>] [--cache-mb=<MB>]\n", argv[0]);
             return PARSE_ERROR;
         }
     }
@@ -2158,7 +2589,9 @@ static int parse_args(pbr_args_t *a, int argc, char **argv, int help)
     if (help >= HELP_FULL) {
         printf("\nKeys:\n"
                "  q | Q | Esc      quit (in the command group, step back to the list)\n"
-               "  arrows / PgUp / PgDn / Home / End   scroll the list\n"
+               "  arrows / PgUp / PgDn / Home / End   scroll the list. The list\n"
+               "                   pages in from the DB as you scroll; End jumps to\n"
+               "                   the oldest matching packet\n"
                "  Enter            bulk_file: open the reconstructed-file viewer -\n"
                "                   the pass's chunks reassembled by file_offset, with\n"
                "                   any missing bytes shown as '?'. tcmd_response:\n"
@@ -2179,7 +2612,9 @@ static int parse_args(pbr_args_t *a, int argc, char **argv, int help)
                "                   (offered as fs_boomcam_<date>_<time>.jpg). Lost\n"
                "                   packets leave gaps a tolerant viewer skips past.\n"
                "    Esc / q        back to the list\n"
-               "  r                reload (rebuilds the group when one is open)\n"
+               "  r                reload (rebuilds the group when one is open; in\n"
+               "                   the list, reloads from the newest packet and\n"
+               "                   picks up rows updated in place, e.g. backfills)\n"
                "  t / T            cycle type filter (all -> beacon -> tcmd_response\n"
                "                   -> log -> bulk_file -> all; T cycles backward)\n"
                "  o                cycle capture-origin filter (all -> cts_ground\n"
@@ -2213,6 +2648,7 @@ int main(int argc, char **argv)
         case PARSE_ERROR: return 1;
     }
     const char *db_path = cfg.db_path;
+    if (cfg.cache_mb > 0) cache_budget = (size_t) cfg.cache_mb << 20;
 
     char default_db[1024];
     if (db_path == NULL) {
@@ -2238,6 +2674,8 @@ int main(int argc, char **argv)
         return 1;
     }
     sqlite3_busy_timeout(db, 5000);
+    g_have_fts     = query_int64(db, PACKET_DB_SQL_HAS_FTS, NULL, 0, -1) == 1;
+    g_have_resp_ts = query_int64(db, PACKET_DB_SQL_HAS_RESP_TS, NULL, 0, -1) == 1;
 
     if (initscr() == NULL) {
         sqlite3_close(db);
@@ -2390,6 +2828,7 @@ int main(int argc, char **argv)
                 // viewer; a tcmd_response opens its command group, and Enter
                 // again inside the group reassembles the full response.
                 // No-op on other rows.
+                if (n_rows == 0) break;
                 if (rows[sel].packet_type == BULK_FILE_PACKET_TYPE)
                     enter_recon(db);
                 else if (rows[sel].packet_type == TCMD_RESP_PACKET_TYPE) {
@@ -2447,9 +2886,20 @@ int main(int argc, char **argv)
                 if (sel < 0) sel = 0;
                 break;
             }
-            case KEY_HOME: case 'g': sel = 0; break;
+            case KEY_HOME: case 'g':
+                // Past an evicted head, reload from the newest row.
+                if (!in_group && main_more_above) {
+                    run_query(db);
+                    last_query = monotonic_seconds();
+                }
+                sel = 0;
+                break;
             case KEY_END:  case 'G':
-                sel = n_rows > 0 ? n_rows - 1 : 0; break;
+                // The main list jumps to the true oldest row, not just
+                // the end of what's loaded.
+                if (!in_group) load_bottom(db);
+                else           sel = n_rows > 0 ? n_rows - 1 : 0;
+                break;
             case 'z': {
                 // vim z-prefix: zz center, zt top, zb bottom (of viewport).
                 // Brief blocking wait so the next keystroke is captured;
@@ -2538,14 +2988,16 @@ int main(int argc, char **argv)
             }
         }
 
-        // 1 Hz auto-poll so live decodes from a running receiver appear
-        // without manual reload. The dedup in the DB means we always
-        // see the same rows in the same order. Suspended while the
+        // Page the window as the selection nears either end, then the
+        // 1 Hz tail-follow so live decodes from a running receiver appear
+        // without manual reload. Both are suspended while the
         // command-group sub-view is up so it doesn't clobber group_rows
-        // (and so the parked main view stays put for an instant return).
+        // (and so the parked main view stays put for an instant return);
+        // the first poll after leaving catches up on everything missed.
+        if (!in_group && !in_recon) page_window(db);
         double now = monotonic_seconds();
         if (!in_group && !in_recon && now - last_query >= 1.0) {
-            run_query(db);
+            follow_tail(db);
             last_query = now;
         }
     }
@@ -2554,7 +3006,8 @@ int main(int argc, char **argv)
     // Free both backing stores. While the sub-view is up the main store
     // still holds its parked rows; in the main view group_rows was freed
     // on the last leave_group (group_n == 0). free(NULL) is safe either way.
-    free_rows(main_rows, in_group ? main_n : n_rows);
+    free_rows(main_rows, main_n);
+    free(main_rows);
     free_rows(group_rows, group_n);
     recon_free();
     sqlite3_close(db);
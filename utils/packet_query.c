@@ -490,6 +490,21 @@ int main(int argc, char **argv)
     }
     sqlite3_busy_timeout(db, 5000);
 
+    // The V5 full-text index, when a writer has built it. Each text
+    // search below then reads only the index hits (an `id IN (... MATCH
+    // ...)` pre-filter) and re-checks them with its original LIKE, so
+    // the result is exactly the LIKE's, minus the scan of every row.
+    // Without it, or for a pattern with no 3-character literal run to
+    // look up, the LIKE runs alone as before.
+    int have_fts = 0;
+    {
+        sqlite3_stmt *probe = NULL;
+        if (sqlite3_prepare_v2(db, PACKET_DB_SQL_HAS_FTS, -1, &probe, NULL) == SQLITE_OK) {
+            have_fts = sqlite3_step(probe) == SQLITE_ROW;
+            sqlite3_finalize(probe);
+        }
+    }
+
     // Generous: the base SELECT plus up to MAX_TERMS free-text groups
     // (~330 chars each) and the option clauses fit with room to spare.
     // snprintf below underflows its size argument if sql_off ever passes
@@ -516,6 +531,10 @@ int main(int argc, char **argv)
     // SQLITE_TRANSIENT copies at bind time, but the pointers handed to
     // ADD_PARAM_TXT must stay valid until then, so these live in main's frame.
     char term_pat[MAX_TERMS][512];
+    // Same lifetime rule for the FTS5 MATCH expressions (a doubled '"'
+    // can grow a term, hence the extra room over term_pat).
+    char term_fts[MAX_TERMS][1100];
+    char like_fts[1100];
 
 #define ADD_PARAM_TXT(s) do { \
         param_kind[n_params] = TXT; \
@@ -563,6 +582,13 @@ int main(int argc, char **argv)
         ADD_PARAM_TXT(capture_origin);
     }
     if (like_arg != NULL) {
+        if (have_fts && packet_db_fts_match(like_arg, "decoded_summary session_dir",
+                                            like_fts, sizeof like_fts) > 0) {
+            sql_off += snprintf(sql + sql_off, sizeof sql - sql_off,
+                                " AND id IN (SELECT rowid FROM " PACKET_DB_FTS_TABLE
+                                " WHERE " PACKET_DB_FTS_TABLE " MATCH ?%d)", n_params + 1);
+            ADD_PARAM_TXT(like_fts);
+        }
         // Substring-match the decoded body, OR'd with a match on the
         // capture's SatNOGS observation id — the trailing component of
         // session_dir, anchored on the '/' so a longer number can't
@@ -585,6 +611,13 @@ int main(int argc, char **argv)
     // term; multiple terms are AND'd, narrowing the result.
     for (int i = 0; i < n_terms; i++) {
         snprintf(term_pat[i], sizeof term_pat[i], "%%%s%%", terms[i]);
+        if (have_fts && packet_db_fts_match(term_pat[i], NULL, term_fts[i],
+                                            sizeof term_fts[i]) > 0) {
+            sql_off += snprintf(sql + sql_off, sizeof sql - sql_off,
+                                " AND id IN (SELECT rowid FROM " PACKET_DB_FTS_TABLE
+                                " WHERE " PACKET_DB_FTS_TABLE " MATCH ?%d)", n_params + 1);
+            ADD_PARAM_TXT(term_fts[i]);
+        }
         int p = n_params + 1;
         sql_off += snprintf(sql + sql_off, sizeof sql - sql_off,
                             " AND ("
@@ -603,7 +636,8 @@ int main(int argc, char **argv)
     }
 
     sql_off += snprintf(sql + sql_off, sizeof sql - sql_off,
-                        " ORDER BY ts_received %s",
+                        " ORDER BY ts_received %s, id %s",
+                        order_desc ? "DESC" : "ASC",
                         order_desc ? "DESC" : "ASC");
     if (limit > 0) {
         sql_off += snprintf(sql + sql_off, sizeof sql - sql_off,
@@ -48,6 +48,7 @@
 #include "rx_tui.h"
 #include "sso_audit.h"
 #include "sso_base64.h"
+#include "sso_iq.h"
 #include "sw_nco.h"
 #include "tle_csv.h"
 #include "wav_read.h"
@@ -65,6 +66,7 @@
 #include <errno.h>
 #include <libgen.h>
 #include <math.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -72,6 +74,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 static volatile sig_atomic_t g_stop = 0;
 
@@ -356,6 +359,14 @@ static int read_audio_sndfile(const char *path, int16_t **out_samples,
 }
 #endif
 
+// --sweep axes: lo-shift-khz, sync-threshold, chain, lpf-khz.
+#define RXR_SWEEP_AXES 4
+
+// Position-dedup bucket width in samples (mirrors rx_live), shared by a
+// normal run's emit ring and --sweep's per-hypothesis tallies so the
+// sweep counts frames the way a real decode would.
+#define DEDUP_QUANT_SAMPLES 4800
+
 // Parsed command-line configuration. parse_args() fills this; main() copies
 // the fields out into working locals so the (large) decode body is unchanged.
 typedef struct {
@@ -408,6 +419,10 @@ typedef struct {
     const char *anchor_csv_arg;
     double anchor_window_s;
     double anchor_pre_s;
+    int jobs;
+    int jobs_explicit;
+    const char *sweep[RXR_SWEEP_AXES];
+    int n_sweep;
 } rxr_args_t;
 
 // Option column width: the widest label below ("--burst-bins-threshold=<n>") +
@@ -442,7 +457,7 @@ static int parse_args(rxr_args_t *a, int argc, char **argv, int help)
             matched = 1;
         }
         if (strcmp(arg, "--iq") == 0 || help) {
-            if (help) parse_help_line(OPTW, "--iq", "treat <path> as headerless int16 I,Q pairs (auto for .iq)");
+            if (help) parse_help_line(OPTW, "--iq", "treat <path> as int16 I,Q pairs (auto for .iq / .sso-iq)");
             else { a->iq_mode = 1; a->iq_mode_explicit = 1; }
             matched = 1;
         }
@@ -715,6 +730,27 @@ static int parse_args(rxr_args_t *a, int argc, char **argv, int help)
             matched = 1;
         }
 
+        if (starts_with(arg, "--jobs=") || help) {
+            if (help) parse_help_line(OPTW, "--jobs=<n>", "decode segments of the file on n threads (default 1; 0 = one per CPU)");
+            else {
+                a->jobs = atoi(arg + 7);
+                if (a->jobs < 0) a->jobs = 1;
+                a->jobs_explicit = 1;
+            }
+            matched = 1;
+        }
+        if (starts_with(arg, "--sweep=") || help) {
+            if (help) parse_help_line(OPTW, "--sweep=<axis>=<v,..>", "decode once per grid point, print a comparison table (repeatable: lo-shift-khz, sync-threshold, chain, lpf-khz; a:b:step ranges)");
+            else {
+                if (a->n_sweep == RXR_SWEEP_AXES) {
+                    fprintf(stderr, "rx_replay: at most %d --sweep axes\n", RXR_SWEEP_AXES);
+                    return PARSE_ERROR;
+                }
+                a->sweep[a->n_sweep++] = arg + 8;
+            }
+            matched = 1;
+        }
+
         if (!matched && !help) {
             if (arg[0] == '-' && strcmp(arg, "-") != 0)
                 fprintf(stderr, "rx_replay: unknown option '%s'\n", arg);
@@ -726,6 +762,51 @@ static int parse_args(rxr_args_t *a, int argc, char **argv, int help)
     return PARSE_OK;
 }
 
+// --update mode's backfills, one per emitted frame, collected during the
+// decode and applied together by packet_db_update_observer_many after it:
+// one transaction per file instead of two UPDATE statements (each its own
+// commit) per frame. Each entry owns its payload and timestamp copies.
+typedef struct {
+    packet_db_observer_update_t *v;
+    size_t                       n, cap;
+} rx_update_buf_t;
+
+static int update_buf_push(rx_update_buf_t *b,
+                           const packet_db_observer_update_t *u)
+{
+    if (b->n == b->cap) {
+        size_t cap = b->cap ? b->cap * 2 : 256;
+        packet_db_observer_update_t *nv = realloc(b->v, cap * sizeof *nv);
+        if (nv == NULL) return -1;
+        b->v = nv;
+        b->cap = cap;
+    }
+    packet_db_observer_update_t *d = &b->v[b->n];
+    *d = *u;
+    uint8_t *pl = malloc(u->payload_len ? u->payload_len : 1);
+    char *ts = u->ts_received ? strdup(u->ts_received) : NULL;
+    if (pl == NULL || (u->ts_received && ts == NULL)) {
+        free(pl); free(ts);
+        return -1;
+    }
+    memcpy(pl, u->payload, u->payload_len);
+    d->payload = pl;
+    d->ts_received = ts;
+    b->n++;
+    return 0;
+}
+
+static void update_buf_free(rx_update_buf_t *b)
+{
+    for (size_t i = 0; i < b->n; i++) {
+        free((void *) b->v[i].payload);
+        free((void *) b->v[i].ts_received);
+    }
+    free(b->v);
+    b->v = NULL;
+    b->n = b->cap = 0;
+}
+
 // Bundle of per-run state the emit helper needs. Built once in main()
 // and shared by pass-1 (slicer sliding window) and pass-2 (anchored
 // Viterbi) so the same dedup ring, observer geometry, and packet-DB
@@ -745,6 +826,7 @@ typedef struct {
     long long       tle_id;
     const char     *session_dir;
     packet_db_t    *db;
+    rx_update_buf_t *updates;
     const char     *log_path;
     int             quiet;
     int             use_tui;
@@ -756,11 +838,7 @@ typedef struct {
     int             force_beacon;
     const uint8_t  *ref_buf;
     size_t          ref_buf_len;
-    uint64_t       *recent_pos_quant;
-    int            *recent_idx;
-    int            *recent_count;
-    int             dedup_ring_sz;
-    uint64_t        dedup_quant_samples;
+    decode_loop_dedup_t *dedup;
     int            *n_emitted_p;
 } rx_emit_ctx_t;
 
@@ -839,33 +917,12 @@ static int rx_emit_decoded(rx_emit_ctx_t *ctx,
     // Validate the AX100 downlink's CSP CRC32 trailer (on by default). A
     // match strips the 4 trailing bytes; a mismatch is recorded but the
     // frame is still emitted so weak telemetry stays visible.
-    if (ctx->csp_crc32 && plen >= 8) {
-        crc_computed = csp_crc32c(packet, (size_t)(plen - 4));
-        crc_le = (uint32_t)packet[plen - 4]
-               | ((uint32_t)packet[plen - 3] << 8)
-               | ((uint32_t)packet[plen - 2] << 16)
-               | ((uint32_t)packet[plen - 1] << 24);
-        crc_be = ((uint32_t)packet[plen - 4] << 24)
-               | ((uint32_t)packet[plen - 3] << 16)
-               | ((uint32_t)packet[plen - 2] <<  8)
-               |  (uint32_t)packet[plen - 1];
-        if (crc_computed == crc_le || crc_computed == crc_be) {
-            crc_status = 1;
-            plen -= 4;
-        } else {
-            crc_status = 0;
-        }
+    if (ctx->csp_crc32) {
+        crc_status = decode_loop_check_crc(packet, &plen, &crc_computed,
+                                           &crc_le, &crc_be);
     }
 
-    uint64_t pos_quant = asm_abs_sample / ctx->dedup_quant_samples;
-    int ring_n = *ctx->recent_count < ctx->dedup_ring_sz
-        ? *ctx->recent_count : ctx->dedup_ring_sz;
-    for (int r = 0; r < ring_n; ++r) {
-        if (ctx->recent_pos_quant[r] == pos_quant) return 0;
-    }
-    ctx->recent_pos_quant[*ctx->recent_idx] = pos_quant;
-    *ctx->recent_idx = (*ctx->recent_idx + 1) % ctx->dedup_ring_sz;
-    if (*ctx->recent_count < ctx->dedup_ring_sz) (*ctx->recent_count)++;
+    if (!decode_loop_dedup_add(ctx->dedup, asm_abs_sample)) return 0;
 
     char ts[32];
     double t_sec = (double)asm_abs_sample / (double)ctx->samp_rate;
@@ -948,11 +1005,14 @@ static int rx_emit_decoded(rx_emit_ctx_t *ctx,
 
     if (ctx->update_mode && ctx->db != NULL && plen >= 4) {
         size_t pl = (size_t)plen;
-        packet_db_update_observer(ctx->db, packet + 4, pl - 4,
-                                  az_deg, el_deg, range_km,
-                                  range_rate_km_s, doppler_hz,
-                                  ctx->tle_id, ctx->session_dir,
-                                  /*force=*/0);
+        packet_db_observer_update_t u = {
+            .payload = packet + 4, .payload_len = pl - 4,
+            .az_deg = az_deg, .el_deg = el_deg, .range_km = range_km,
+            .range_rate_km_s = range_rate_km_s, .doppler_hz_offset = doppler_hz,
+            .tle_id = ctx->tle_id, .session_dir = ctx->session_dir,
+            .audio_offset_s = NAN,
+        };
+        char ts_iso[40];
         if (ctx->have_start_utc) {
             double abs_t = ctx->start_utc_seconds + t_sec;
             time_t epoch = (time_t)floor(abs_t);
@@ -961,7 +1021,6 @@ static int rx_emit_decoded(rx_emit_ctx_t *ctx,
             if (ms_long >= 1000) { ms_long = 0; epoch += 1; }
             struct tm utc;
             gmtime_r(&epoch, &utc);
-            char ts_iso[40];
             snprintf(ts_iso, sizeof ts_iso,
                      "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
                      (utc.tm_year + 1900) % 10000,
@@ -971,9 +1030,12 @@ static int rx_emit_decoded(rx_emit_ctx_t *ctx,
                      utc.tm_min  % 100,
                      utc.tm_sec  % 100,
                      (int)(ms_long % 1000));
-            packet_db_update_replay_ts(ctx->db, packet + 4, pl - 4,
-                                       ts_iso, t_sec);
+            u.ts_received = ts_iso;
+            u.audio_offset_s = t_sec;
         }
+        if (update_buf_push(ctx->updates, &u) != 0)
+            fprintf(stderr, "rx_replay: out of memory queueing the --update "
+                    "backfill; this frame's row is left as-is\n");
     }
     if (ctx->use_tui) {
         rx_tui_observe_frame(ts, packet, (size_t)plen,
@@ -984,6 +1046,622 @@ static int rx_emit_decoded(rx_emit_ctx_t *ctx,
     return 1;
 }
 
+// --jobs: the sliding-window passes split into segments of consecutive
+// windows, each decoded on a worker thread with its own scratch. A
+// segment reads its windows' samples plus the window-length tail past
+// its last start, so every window decodes exactly as in the serial walk.
+// Workers only collect candidates; main() then hands them to
+// rx_emit_decoded in segment order, which is the serial order, so the
+// position dedup (and with it every emitted frame) matches a --jobs=1
+// run.
+
+// Pass-1 demod chains, chosen once in main().
+typedef enum {
+    RXR_CHAIN_PCM = 0,   // modem_pcm16 (FM audio)
+    RXR_CHAIN_IQ,        // modem_iq slicer
+    RXR_CHAIN_FSK,       // modem_fsk discriminator (RX_REPLAY_USE_FSK)
+    RXR_CHAIN_VITERBI,   // modem_viterbi MLSE
+} rxr_chain_t;
+
+typedef int (*rxr_window_fn)(const int16_t *, size_t,
+                             const modem_params_t *, const ax100_opts_t *,
+                             int, int, size_t,
+                             uint8_t *, size_t, uint8_t *, size_t,
+                             uint8_t *, size_t, ssize_t *,
+                             int *, int *, int *, int *,
+                             size_t *, int *);
+
+// Read-only decode setup; shared by the serial walk and every worker.
+typedef struct {
+    rxr_chain_t           chain;
+    const modem_params_t *mp;
+    const ax100_opts_t   *opts;
+    int                   sync_max_ham;
+    int                   allow_partial_rs;
+    int                   sps;
+    const int16_t        *samples;
+    size_t                n_frames;
+    int                   iq_mode;
+    size_t                window_samples;
+    size_t                slide_samples;
+    size_t                bits_cap;
+    size_t                bytes_cap;
+    size_t                p2_window_pairs;   // pass-2 tight window
+    size_t                p2_pre_pairs;      // pass-2 pre-ASM cushion
+} rxr_decoder_t;
+
+// One pass-1 frame, or one pass-2 slicer sync and its tight-window
+// retry. For pass 2, key is the sync's absolute sample (what the dedup
+// ring is checked against), attempted is 0 when the tight window came
+// out too short, and decoded 0 when the retry failed.
+typedef struct {
+    uint64_t asm_abs;
+    uint64_t key;
+    int      attempted;
+    int      decoded;
+    ssize_t  plen;
+    int      golay_errs, hmac_ok, rs_errs, used_golay_len;
+    int      rs_locs[32];
+    uint8_t *packet;     // owned copy, collected candidates only
+} rxr_cand_t;
+
+static const int16_t *rxr_window(const rxr_decoder_t *d, size_t window_start)
+{
+    // PCM windows index by sample; IQ windows index by pair, where
+    // each pair occupies 2 int16s in the underlying buffer.
+    return d->iq_mode ? d->samples + window_start * 2u
+                      : d->samples + window_start;
+}
+
+// One pass-1 attempt on the window at window_start, from bit offset
+// min_off. Returns 0 when the chain found nothing more; otherwise
+// *sync_off is where to continue from and c->decoded says whether the
+// packet is usable.
+static int rxr_decode_at(const rxr_decoder_t *d, size_t window_start,
+                         size_t min_off, uint8_t *bits, uint8_t *bytes,
+                         uint8_t *packet, size_t packet_cap,
+                         rxr_cand_t *c, size_t *sync_off)
+{
+    rxr_window_fn fn = d->chain == RXR_CHAIN_VITERBI ? try_decode_window_viterbi
+                     : d->chain == RXR_CHAIN_FSK     ? try_decode_window_fsk
+                     : d->chain == RXR_CHAIN_IQ      ? try_decode_window_iq
+                     :                                 try_decode_window;
+    memset(c, 0, sizeof *c);
+    c->plen = -1;
+    c->hmac_ok = -1;
+    c->rs_errs = -1;
+    c->used_golay_len = -1;
+    *sync_off = 0;
+    if (!fn(rxr_window(d, window_start), d->window_samples, d->mp, d->opts,
+            d->sync_max_ham, d->allow_partial_rs, min_off,
+            bits, d->bits_cap, bytes, d->bytes_cap, packet, packet_cap,
+            &c->plen, &c->golay_errs, &c->hmac_ok,
+            &c->rs_errs, &c->used_golay_len, sync_off, c->rs_locs))
+        return 0;
+    c->decoded = c->plen >= 4 && (size_t) c->plen <= packet_cap;
+    c->asm_abs = (uint64_t) window_start
+               + (uint64_t) *sync_off * (uint64_t) d->sps
+               + (uint64_t)(d->sps / 2);
+    return 1;
+}
+
+// Next pass-2 slicer sync in the window at window_start, from
+// *inner_min on. Returns 0 when there is none; otherwise advances
+// *inner_min and stores the sync's absolute sample.
+static int rxr_p2_next_sync(const rxr_decoder_t *d, size_t window_start,
+                            size_t *inner_min, uint8_t *bits,
+                            uint64_t *asm_abs)
+{
+    size_t n_bits_sym = 0, sync_off_bits = 0;
+    int polarity_used = -1;
+    if (modem_fsk_iq_to_bits(rxr_window(d, window_start), d->window_samples,
+                             d->mp, 0, d->sync_max_ham, *inner_min,
+                             bits, &n_bits_sym, &sync_off_bits,
+                             &polarity_used) != 0)
+        return 0;
+    *inner_min = sync_off_bits + 1;
+    *asm_abs = (uint64_t) window_start
+             + (uint64_t) sync_off_bits * (uint64_t) d->sps
+             + (uint64_t)(d->sps / 2);
+    return 1;
+}
+
+// Pass-2 retry for the slicer sync at asm_abs: the FSK chain on a tight
+// window anchored on it. The tight window lets AGC + HPF settle on
+// signal-dominated samples rather than mostly-noise — sometimes
+// recovers a frame that pass-1's wide-window FSK partial-RS'd or that
+// pass-1 missed entirely. The Viterbi MLSE is reserved for h=0.5 AWGN
+// tests where its 2 dB coherent gain matters; on FrontierSat's h≈2/3
+// FSK its 4-state trellis is wrong and finds zero syncs.
+static void rxr_p2_retry(const rxr_decoder_t *d, uint64_t asm_abs,
+                         uint8_t *bits, uint8_t *bytes,
+                         uint8_t *packet, size_t packet_cap, rxr_cand_t *c)
+{
+    memset(c, 0, sizeof *c);
+    c->key = asm_abs;
+    c->plen = -1;
+    c->hmac_ok = -1;
+    c->rs_errs = -1;
+    c->used_golay_len = -1;
+    size_t n_frames = d->n_frames;
+    uint64_t tight_start = (asm_abs > (uint64_t) d->p2_pre_pairs)
+        ? (asm_abs - (uint64_t) d->p2_pre_pairs) : 0;
+    if (tight_start + d->p2_window_pairs > n_frames) {
+        tight_start = (n_frames > d->p2_window_pairs)
+            ? (n_frames - d->p2_window_pairs) : 0;
+    }
+    size_t tw_pairs = (tight_start + d->p2_window_pairs <= n_frames)
+        ? d->p2_window_pairs : (n_frames - (size_t) tight_start);
+    if (tw_pairs < (size_t)(64 * d->sps)) return;
+    c->attempted = 1;
+
+    size_t sync_off = 0;
+    if (!try_decode_window_fsk(d->samples + tight_start * 2u, tw_pairs,
+                               d->mp, d->opts,
+                               d->sync_max_ham, d->allow_partial_rs, 0,
+                               bits, d->bits_cap, bytes, d->bytes_cap,
+                               packet, packet_cap,
+                               &c->plen, &c->golay_errs, &c->hmac_ok,
+                               &c->rs_errs, &c->used_golay_len,
+                               &sync_off, c->rs_locs))
+        return;
+    c->decoded = c->plen >= 4 && (size_t) c->plen <= packet_cap;
+    c->asm_abs = tight_start
+               + (uint64_t) sync_off * (uint64_t) d->sps
+               + (uint64_t)(d->sps / 2);
+}
+
+// Windows of slide_samples cadence that fit in the file.
+static size_t rxr_n_windows(const rxr_decoder_t *d)
+{
+    if (d->n_frames < d->window_samples) return 0;
+    return (d->n_frames - d->window_samples) / d->slide_samples + 1;
+}
+
+// Windows [w0, w1) and the candidates a worker collected from them.
+typedef struct {
+    size_t      w0, w1;
+    rxr_cand_t *v;
+    size_t      n, cap;
+    int         oom;
+} rxr_segment_t;
+
+typedef struct {
+    const rxr_decoder_t *d;
+    int                  pass;     // 1: sliding window, 2: anchored FSK
+    rxr_segment_t       *segs;
+    size_t               n_segs;
+    size_t               next;     // next segment to claim (atomic)
+} rxr_par_t;
+
+static int rxr_segment_push(rxr_segment_t *seg, const rxr_cand_t *c,
+                            const uint8_t *packet)
+{
+    if (seg->n == seg->cap) {
+        size_t cap = seg->cap ? seg->cap * 2 : 16;
+        rxr_cand_t *nv = realloc(seg->v, cap * sizeof *nv);
+        if (nv == NULL) return -1;
+        seg->v = nv;
+        seg->cap = cap;
+    }
+    rxr_cand_t *d = &seg->v[seg->n];
+    *d = *c;
+    d->packet = NULL;
+    if (c->decoded) {
+        d->packet = malloc((size_t) c->plen);
+        if (d->packet == NULL) return -1;
+        memcpy(d->packet, packet, (size_t) c->plen);
+    }
+    seg->n++;
+    return 0;
+}
+
+static void rxr_segments_free(rxr_segment_t *segs, size_t n_segs)
+{
+    for (size_t k = 0; k < n_segs; k++) {
+        for (size_t i = 0; i < segs[k].n; i++) free(segs[k].v[i].packet);
+        free(segs[k].v);
+    }
+    free(segs);
+}
+
+// Claim segments until none are left; each one walks its windows the
+// way main()'s serial loops do, minus the dedup (applied at the merge).
+static void *rxr_segment_worker(void *arg)
+{
+    rxr_par_t *par = (rxr_par_t *) arg;
+    const rxr_decoder_t *d = par->d;
+    uint8_t *bits  = (uint8_t *) malloc(d->bits_cap);
+    uint8_t *bytes = (uint8_t *) malloc(d->bytes_cap);
+    uint8_t packet[4100];
+    for (;;) {
+        size_t k = __atomic_fetch_add(&par->next, 1, __ATOMIC_RELAXED);
+        if (k >= par->n_segs) break;
+        rxr_segment_t *seg = &par->segs[k];
+        if (bits == NULL || bytes == NULL) { seg->oom = 1; continue; }
+        for (size_t w = seg->w0; w < seg->w1 && !g_stop && !seg->oom; ++w) {
+            size_t window_start = w * d->slide_samples;
+            size_t inner = 0;
+            rxr_cand_t c;
+            if (par->pass == 1) {
+                size_t sync_off = 0;
+                while (rxr_decode_at(d, window_start, inner, bits, bytes,
+                                     packet, sizeof packet, &c, &sync_off)) {
+                    inner = sync_off + 1;
+                    if (c.decoded && rxr_segment_push(seg, &c, packet) != 0) {
+                        seg->oom = 1;
+                        break;
+                    }
+                }
+            } else {
+                uint64_t asm_abs = 0;
+                for (int tries = 0; tries < 64; ++tries) {
+                    if (!rxr_p2_next_sync(d, window_start, &inner, bits, &asm_abs))
+                        break;
+                    rxr_p2_retry(d, asm_abs, bits, bytes, packet, sizeof packet, &c);
+                    if (rxr_segment_push(seg, &c, packet) != 0) {
+                        seg->oom = 1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    free(bits);
+    free(bytes);
+    return NULL;
+}
+
+// Run one pass over the whole file on `jobs` threads. Segments are
+// a few per thread so a beacon-dense stretch doesn't leave the rest
+// idle. Returns the segments in file order (caller frees), or NULL
+// with *n_segs 0 on failure.
+static rxr_segment_t *rxr_run_segments(const rxr_decoder_t *d, int pass,
+                                       int jobs, size_t *n_segs)
+{
+    *n_segs = 0;
+    size_t n_win = rxr_n_windows(d);
+    size_t n = (size_t) jobs * 4u;
+    if (n > n_win) n = n_win;
+    if (n == 0) return NULL;
+    rxr_segment_t *segs = (rxr_segment_t *) calloc(n, sizeof *segs);
+    if (segs == NULL) return NULL;
+    for (size_t k = 0; k < n; k++) {
+        segs[k].w0 = n_win * k / n;
+        segs[k].w1 = n_win * (k + 1) / n;
+    }
+    rxr_par_t par = { .d = d, .pass = pass, .segs = segs, .n_segs = n };
+    int n_threads = jobs < (int) n ? jobs : (int) n;
+    pthread_t *tids = (pthread_t *) calloc((size_t) n_threads, sizeof *tids);
+    int started = 0;
+    if (tids != NULL) {
+        for (; started < n_threads; started++) {
+            if (pthread_create(&tids[started], NULL, rxr_segment_worker, &par) != 0)
+                break;
+        }
+    }
+    // Whatever no thread claimed (or every segment, if none started)
+    // runs here.
+    rxr_segment_worker(&par);
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    free(tids);
+    for (size_t k = 0; k < n; k++) {
+        if (segs[k].oom) {
+            rxr_segments_free(segs, n);
+            return NULL;
+        }
+    }
+    *n_segs = n;
+    return segs;
+}
+
+// --sweep: one decode per point of a parameter grid, for tuning. Each
+// --sweep=<axis>=<values> flag adds an axis; values are a comma list
+// whose items may be start:stop:step ranges. The file is read once and
+// each distinct lo-shift is NCO-mixed once, then every hypothesis runs
+// the normal passes through rxr_run_segments on all --jobs threads.
+// Frames are tallied with the same position dedup rx_emit_decoded
+// applies, but nothing is printed per frame and the DB is never
+// touched; the result is one comparison table on stdout.
+#define RXR_SWEEP_MAX_VALUES  64
+#define RXR_SWEEP_MAX_HYP     4096
+
+typedef enum {
+    RXR_AX_LO = 0,   // lo-shift-khz: NCO shift applied to the IQ first
+    RXR_AX_SYNC,     // sync-threshold: max ASM bit errors
+    RXR_AX_CHAIN,    // chain: iq | fsk | viterbi
+    RXR_AX_LPF,      // lpf-khz: modem_fsk IQ low-pass cutoff (0 = default)
+} rxr_axis_kind_t;
+
+static const char *const RXR_AXIS_NAMES[RXR_SWEEP_AXES] = {
+    "lo-shift-khz", "sync-threshold", "chain", "lpf-khz",
+};
+
+static const char *const RXR_CHAIN_NAMES[] = { "pcm", "iq", "fsk", "viterbi" };
+
+typedef struct {
+    rxr_axis_kind_t kind;
+    int             n;
+    double          v[RXR_SWEEP_MAX_VALUES];
+} rxr_axis_t;
+
+// Parse "<axis>=<v>[,<v>|,<a>:<b>:<step>...]" into ax. Returns 0, or
+// -1 with a message on stderr.
+static int rxr_sweep_parse_axis(const char *spec, rxr_axis_t *ax)
+{
+    const char *eq = strchr(spec, '=');
+    int kind = -1;
+    for (int k = 0; eq != NULL && k < RXR_SWEEP_AXES; k++) {
+        if ((size_t)(eq - spec) == strlen(RXR_AXIS_NAMES[k])
+            && strncmp(spec, RXR_AXIS_NAMES[k], (size_t)(eq - spec)) == 0)
+            kind = k;
+    }
+    if (kind < 0) {
+        fprintf(stderr, "rx_replay: --sweep=%s: want <axis>=<values> with "
+                "axis lo-shift-khz, sync-threshold, chain or lpf-khz\n", spec);
+        return -1;
+    }
+    ax->kind = (rxr_axis_kind_t) kind;
+    ax->n = 0;
+    char buf[512];
+    snprintf(buf, sizeof buf, "%s", eq + 1);
+    char *save = NULL;
+    for (char *tok = strtok_r(buf, ",", &save); tok != NULL;
+         tok = strtok_r(NULL, ",", &save)) {
+        if (kind == RXR_AX_CHAIN) {
+            int c = -1;
+            for (int k = RXR_CHAIN_IQ; k <= RXR_CHAIN_VITERBI; k++)
+                if (strcmp(tok, RXR_CHAIN_NAMES[k]) == 0) c = k;
+            if (c < 0) {
+                fprintf(stderr, "rx_replay: --sweep chain '%s': want iq, "
+                        "fsk or viterbi\n", tok);
+                return -1;
+            }
+            if (ax->n == RXR_SWEEP_MAX_VALUES) goto too_many;
+            ax->v[ax->n++] = c;
+            continue;
+        }
+        double a, b, step;
+        char tail;
+        int got = sscanf(tok, "%lf:%lf:%lf%c", &a, &b, &step, &tail);
+        if (got != 3) {
+            got = sscanf(tok, "%lf%c", &a, &tail);
+            if (got != 1) {
+                fprintf(stderr, "rx_replay: --sweep %s: bad value '%s'\n",
+                        RXR_AXIS_NAMES[kind], tok);
+                return -1;
+            }
+            b = a;
+            step = 1.0;
+        }
+        if (step <= 0.0 || b < a) {
+            fprintf(stderr, "rx_replay: --sweep %s: range '%s' needs "
+                    "start <= stop and step > 0\n", RXR_AXIS_NAMES[kind], tok);
+            return -1;
+        }
+        // Count steps rather than accumulate, so 0:1:0.1 ends on 1.
+        long n_steps = lround(floor((b - a) / step + 1e-9));
+        for (long i = 0; i <= n_steps; i++) {
+            double v = a + (double) i * step;
+            if (kind == RXR_AX_SYNC && (v < 0.0 || v > 8.0 || v != floor(v))) {
+                fprintf(stderr, "rx_replay: --sweep sync-threshold %g: want "
+                        "an integer in [0,8]\n", v);
+                return -1;
+            }
+            if (ax->n == RXR_SWEEP_MAX_VALUES) goto too_many;
+            ax->v[ax->n++] = v;
+        }
+    }
+    if (ax->n == 0) {
+        fprintf(stderr, "rx_replay: --sweep %s: no values\n", RXR_AXIS_NAMES[kind]);
+        return -1;
+    }
+    return 0;
+too_many:
+    fprintf(stderr, "rx_replay: --sweep %s: more than %d values\n",
+            RXR_AXIS_NAMES[kind], RXR_SWEEP_MAX_VALUES);
+    return -1;
+}
+
+// Distinct payload hashes (FNV-1a over the CRC-stripped frame).
+typedef struct {
+    uint64_t *v;
+    size_t    n, cap;
+} rxr_hashset_t;
+
+static uint64_t rxr_payload_hash(const uint8_t *p, size_t n)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Adds h; returns 1 when it was new, 0 when already present, -1 on OOM.
+static int rxr_hashset_add(rxr_hashset_t *s, uint64_t h)
+{
+    for (size_t i = 0; i < s->n; i++) if (s->v[i] == h) return 0;
+    if (s->n == s->cap) {
+        size_t cap = s->cap ? s->cap * 2 : 64;
+        uint64_t *nv = realloc(s->v, cap * sizeof *nv);
+        if (nv == NULL) return -1;
+        s->v = nv;
+        s->cap = cap;
+    }
+    s->v[s->n++] = h;
+    return 1;
+}
+
+// One hypothesis's results, tallied in merge order through its own
+// position dedup ring, as rx_emit_decoded does for a normal run.
+typedef struct {
+    decode_loop_dedup_t dedup;
+    rxr_hashset_t       payloads;
+    int                 frames, crc_ok, rs_corrected, rs_failed, p2_rescued;
+    double              secs;
+} rxr_tally_t;
+
+// Count c unless its position was already counted; returns 1 if counted.
+static int rxr_tally_add(rxr_tally_t *t, const rxr_cand_t *c, int csp_crc32,
+                         rxr_hashset_t *all)
+{
+    if (!decode_loop_dedup_add(&t->dedup, c->asm_abs)) return 0;
+
+    ssize_t plen = c->plen;
+    if (csp_crc32 && decode_loop_check_crc(c->packet, &plen,
+                                           NULL, NULL, NULL) == 1)
+        t->crc_ok++;
+    t->frames++;
+    if (c->rs_errs > 0)   t->rs_corrected++;
+    if (c->rs_errs == -2) t->rs_failed++;
+    uint64_t h = rxr_payload_hash(c->packet, (size_t) plen);
+    rxr_hashset_add(&t->payloads, h);
+    if (all != NULL) rxr_hashset_add(all, h);
+    return 1;
+}
+
+static double rxr_mono_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+// Run the grid. base is the decoder main() built from the command
+// line; each hypothesis overrides its swept fields. Returns the exit
+// code.
+static int rxr_sweep_run(const rxr_axis_t *axes, int n_axes,
+                         const rxr_decoder_t *base, int jobs, int two_pass,
+                         int csp_crc32, uint64_t quant, int samp_rate,
+                         const char *input_path)
+{
+    size_t n_hyp = 1;
+    for (int a = 0; a < n_axes; a++) n_hyp *= (size_t) axes[a].n;
+    if (n_hyp > RXR_SWEEP_MAX_HYP) {
+        fprintf(stderr, "rx_replay: --sweep: %zu hypotheses (max %d)\n",
+                n_hyp, RXR_SWEEP_MAX_HYP);
+        return 1;
+    }
+
+    // Shared stage: one NCO-mixed copy of the IQ per distinct lo-shift
+    // (0 uses the loaded samples as they are).
+    const rxr_axis_t *lo_ax = NULL;
+    for (int a = 0; a < n_axes; a++) if (axes[a].kind == RXR_AX_LO) lo_ax = &axes[a];
+    int n_lo = lo_ax ? lo_ax->n : 1;
+    int16_t **shifted = (int16_t **) calloc((size_t) n_lo, sizeof *shifted);
+    rxr_tally_t *tally = (rxr_tally_t *) calloc(n_hyp, sizeof *tally);
+    rxr_hashset_t all = {0};
+    int rc = 1;
+    if (shifted == NULL || tally == NULL) goto oom;
+    for (size_t h = 0; h < n_hyp; h++) decode_loop_dedup_init(&tally[h].dedup, quant);
+    int n_nco = 0;
+    for (int i = 0; lo_ax != NULL && i < n_lo; i++) {
+        if (lo_ax->v[i] == 0.0) continue;
+        size_t n16 = base->n_frames * 2u;
+        shifted[i] = (int16_t *) malloc(n16 * sizeof(int16_t));
+        if (shifted[i] == NULL) goto oom;
+        memcpy(shifted[i], base->samples, n16 * sizeof(int16_t));
+        sw_nco_t nco;
+        sw_nco_init(&nco, (double) samp_rate);
+        sw_nco_set_freq(&nco, lo_ax->v[i] * 1000.0);
+        sw_nco_apply(&nco, shifted[i], base->n_frames);
+        n_nco++;
+    }
+
+    fprintf(stderr, "rx_replay: sweep over %zu hypothes%s of %s "
+            "(%d NCO output%s shared, %d thread%s)\n",
+            n_hyp, n_hyp == 1 ? "is" : "es", input_path,
+            n_nco, n_nco == 1 ? "" : "s", jobs, jobs == 1 ? "" : "s");
+
+    for (size_t h = 0; h < n_hyp && !g_stop; h++) {
+        rxr_decoder_t d = *base;
+        modem_params_t mp = *base->mp;
+        d.mp = &mp;
+        size_t rest = h;
+        // Mixed radix, last axis fastest, so the table reads like nested loops.
+        for (int a = n_axes - 1; a >= 0; a--) {
+            int i = (int)(rest % (size_t) axes[a].n);
+            rest /= (size_t) axes[a].n;
+            double v = axes[a].v[i];
+            switch (axes[a].kind) {
+                case RXR_AX_LO:    if (shifted[i] != NULL) d.samples = shifted[i]; break;
+                case RXR_AX_SYNC:  d.sync_max_ham = (int) v; break;
+                case RXR_AX_CHAIN: d.chain = (rxr_chain_t) v; break;
+                case RXR_AX_LPF:   mp.fsk_iq_lpf_hz = v * 1000.0; break;
+            }
+        }
+        rxr_tally_t *t = &tally[h];
+        double t0 = rxr_mono_s();
+        size_t n_segs = 0;
+        rxr_segment_t *segs = rxr_run_segments(&d, 1, jobs, &n_segs);
+        if (segs == NULL && rxr_n_windows(&d) > 0) goto oom;
+        for (size_t k = 0; k < n_segs; k++)
+            for (size_t i = 0; i < segs[k].n; i++)
+                rxr_tally_add(t, &segs[k].v[i], csp_crc32, &all);
+        rxr_segments_free(segs, n_segs);
+        // Pass 2 as in a normal run: not after a Viterbi pass 1.
+        if (d.iq_mode && two_pass && d.chain != RXR_CHAIN_VITERBI && !g_stop) {
+            segs = rxr_run_segments(&d, 2, jobs, &n_segs);
+            if (segs == NULL && rxr_n_windows(&d) > 0) goto oom;
+            for (size_t k = 0; k < n_segs; k++) {
+                for (size_t i = 0; i < segs[k].n; i++) {
+                    const rxr_cand_t *c = &segs[k].v[i];
+                    if (decode_loop_dedup_seen(&t->dedup, c->key) || !c->decoded) continue;
+                    t->p2_rescued += rxr_tally_add(t, c, csp_crc32, &all);
+                }
+            }
+            rxr_segments_free(segs, n_segs);
+        }
+        t->secs = rxr_mono_s() - t0;
+    }
+
+    // The table: swept columns first, then the tallies. '*' marks the
+    // hypothesis with the most distinct payloads (ties: most frames).
+    size_t best = 0;
+    for (size_t h = 1; h < n_hyp; h++) {
+        if (tally[h].payloads.n > tally[best].payloads.n
+            || (tally[h].payloads.n == tally[best].payloads.n
+                && tally[h].frames > tally[best].frames))
+            best = h;
+    }
+    printf("  #  ");
+    for (int a = 0; a < n_axes; a++) printf("%15s ", RXR_AXIS_NAMES[axes[a].kind]);
+    printf("frames crc_ok rs_corr rs_fail p2_rescued unique    secs\n");
+    for (size_t h = 0; h < n_hyp; h++) {
+        printf("%c%3zu  ", h == best && !g_stop ? '*' : ' ', h + 1);
+        size_t rest = h;
+        int idx[RXR_SWEEP_AXES];
+        for (int a = n_axes - 1; a >= 0; a--) {
+            idx[a] = (int)(rest % (size_t) axes[a].n);
+            rest /= (size_t) axes[a].n;
+        }
+        for (int a = 0; a < n_axes; a++) {
+            double v = axes[a].v[idx[a]];
+            if (axes[a].kind == RXR_AX_CHAIN) printf("%15s ", RXR_CHAIN_NAMES[(int) v]);
+            else                              printf("%15g ", v);
+        }
+        printf("%6d %6d %7d %7d %10d %6zu %7.2f\n",
+               tally[h].frames, tally[h].crc_ok, tally[h].rs_corrected,
+               tally[h].rs_failed, tally[h].p2_rescued,
+               tally[h].payloads.n, tally[h].secs);
+    }
+    printf("distinct payloads across all hypotheses: %zu\n", all.n);
+    fflush(stdout);
+    rc = 0;
+    goto out;
+oom:
+    fprintf(stderr, "rx_replay: --sweep: out of memory\n");
+out:
+    for (int i = 0; shifted != NULL && i < n_lo; i++) free(shifted[i]);
+    free(shifted);
+    for (size_t h = 0; tally != NULL && h < n_hyp; h++) free(tally[h].payloads.v);
+    free(tally);
+    free(all.v);
+    return rc;
+}
+
 // -V / --version support (commit baked in at build time).
 #include "sso_version.h"
 
@@ -1010,6 +1688,7 @@ int main(int argc, char **argv)
         .nominal_freq_hz = 436150000.0, // FrontierSat carrier
         .anchor_window_s = 0.40,     // tight window around each anchor
         .anchor_pre_s    = 0.05,     // pre-anchor cushion for M&M lock
+        .jobs            = 1,
     };
     switch (parse_args(&cfg, argc, argv, HELP_OFF)) {
         case PARSE_HELP:  return 0;
@@ -1128,6 +1807,42 @@ int main(int argc, char **argv)
     const char *anchor_csv_arg = cfg.anchor_csv_arg;
     double anchor_window_s = cfg.anchor_window_s;     // tight window around each anchor
     double anchor_pre_s    = cfg.anchor_pre_s;        // pre-anchor cushion for M&M lock
+    // Segment-parallel decode threads (see rxr_run_segments); 1 keeps
+    // the streaming serial walk. 0 = one per online CPU.
+    int jobs = cfg.jobs;
+    if (jobs == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = cpus > 0 ? (int) cpus : 1;
+    }
+    if (jobs > 256) jobs = 256;
+    // --sweep: parsed axes. The table is the whole output: the sweep
+    // returns before the DB, the burst.csv pass and the frame printer.
+    rxr_axis_t axes[RXR_SWEEP_AXES];
+    int n_axes = cfg.n_sweep;
+    for (int a = 0; a < n_axes; a++) {
+        if (rxr_sweep_parse_axis(cfg.sweep[a], &axes[a]) != 0) return 1;
+        for (int b = 0; b < a; b++) {
+            if (axes[b].kind == axes[a].kind) {
+                fprintf(stderr, "rx_replay: --sweep %s given twice\n",
+                        RXR_AXIS_NAMES[axes[a].kind]);
+                return 1;
+            }
+        }
+        // Swept shifts replace --lo-shift-khz rather than stack on it.
+        if (axes[a].kind == RXR_AX_LO) lo_shift_hz = 0.0;
+    }
+    if (n_axes > 0) {
+        if (forensics || update_mode || use_tui || anchor_csv_arg != NULL) {
+            fprintf(stderr, "rx_replay: --sweep prints its own table; it "
+                    "can't be combined with --forensics-report, --update, "
+                    "--ui or --anchor-csv\n");
+            return 1;
+        }
+        if (!cfg.jobs_explicit) {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            jobs = cpus > 0 ? (int) cpus : 1;
+        }
+    }
 
     // --forensics-report is a read-only research/scoring mode: stdout is
     // nothing but newline-delimited JSON (one object per decoded frame, a
@@ -1205,8 +1920,7 @@ int main(int argc, char **argv)
         if (plen >= 4 && strcmp(input_path + plen - 4, ".raw") == 0) raw_mode = 1;
     }
     if (!iq_mode_explicit) {
-        size_t plen = strlen(input_path);
-        if (plen >= 3 && strcmp(input_path + plen - 3, ".iq") == 0) iq_mode = 1;
+        if (sso_iq_path_is_iq(input_path)) iq_mode = 1;
     }
     // .ogg (SatNOGS audio) -> decode to PCM and run the FM-audio chain.
     // Only when not already raw/iq.
@@ -1257,18 +1971,37 @@ int main(int argc, char **argv)
     int samp_rate = 0;
     int channels = 1;
     if (iq_mode) {
-        if (read_raw_pcm16(input_path, &samples, &n_samples) != 0)
-            return forensics ? forensics_fail(fn_json,
-                "could not read input as raw int16 IQ") : 1;
-        samp_rate = raw_rate;
-        if ((n_samples & 1u) != 0) {
+        // A .sso-iq is decoded and brings its own rate (an explicit
+        // --rate still wins); anything else is headerless int16 I,Q.
+        // A raw file has no framing to check it against, so keep the
+        // whole-pairs test sso_iq_load would otherwise paper over by
+        // dropping the odd trailing sample.
+        sso_iq_reader_t *probe = sso_iq_open(input_path);
+        int raw_iq = probe != NULL && !sso_iq_is_container(probe);
+        sso_iq_close(probe);
+        struct stat iq_st;
+        if (raw_iq && stat(input_path, &iq_st) == 0
+            && (((size_t) iq_st.st_size / 2u) & 1u) != 0) {
             fprintf(stderr,
                     "rx_replay: --iq file has odd int16 count (%zu); "
-                    "not interleaved I,Q?\n", n_samples);
-            free(samples);
+                    "not interleaved I,Q?\n", (size_t) iq_st.st_size / 2u);
             return forensics ? forensics_fail(fn_json,
                 "IQ file has an odd int16 count (not interleaved I,Q?)") : 1;
         }
+        sso_iq_meta_t iq_meta;
+        size_t n_pairs = 0;
+        samples = sso_iq_load(input_path, &n_pairs, &iq_meta);
+        if (samples == NULL || n_pairs == 0) {
+            fprintf(stderr, "rx_replay: could not read IQ from %s\n", input_path);
+            free(samples);
+            return forensics ? forensics_fail(fn_json,
+                "could not read input as int16 IQ") : 1;
+        }
+        n_samples = 2 * n_pairs;
+        samp_rate = raw_rate;
+        if (iq_meta.sample_rate_hz > 0.0 && !raw_rate_explicit) {
+            samp_rate = (int) lround(iq_meta.sample_rate_hz);
+        }
         // Apply --lo-shift-khz BEFORE the decode loop. sw_nco_apply
         // rotates by exp(-j 2π f · n/fs), so positive lo_shift_hz
         // moves a signal at +lo_shift_hz baseband down to DC. Default
@@ -1369,6 +2102,62 @@ int main(int argc, char **argv)
             "out of memory allocating decode scratch buffers") : 1;
     }
 
+    // Pass-1 chain. In iq_mode the
+    // default chain is modem_iq (complex-differential slicer with
+    // 2nd-power bias removal) — same chain the live rx_session uses,
+    // so "rx_replay on the .iq" reproduces live decodes by default.
+    // FrontierSat's modulation is MSK h=0.5 (dev=2400 Hz at 9600 baud)
+    // — modem_iq's MSK-tuned arg(z[n]·conj(z[n-sps])) front-end is the
+    // right match. Set RX_REPLAY_USE_FSK=1 to switch to modem_fsk's
+    // FM-discriminator chain (modulation-index-agnostic; preferred
+    // when the bird is not MSK). When two_pass is on, pass-1 always
+    // uses the slicer family — the Viterbi runs in pass 2.
+    int pass1_use_viterbi = (iq_mode && two_pass) ? 0 : use_viterbi;
+    int pass1_use_fsk = iq_mode && getenv("RX_REPLAY_USE_FSK") != NULL
+                        && !pass1_use_viterbi;
+    // Pass-2 tight Viterbi window: one max-length AX100 frame plus
+    // pre-ASM cushion for M&M timing-loop settling.
+    // Max AX100 payload = ~256 B RS-coded + framing ≈ 2300 bits
+    // ≈ 240 ms @ 9600 baud. Pre-ASM cushion = 50 ms.
+    const double p2_window_s = 0.40;
+    const double p2_pre_anchor_s = 0.05;
+    rxr_decoder_t dec = {
+        .chain = !iq_mode ? RXR_CHAIN_PCM
+               : pass1_use_viterbi ? RXR_CHAIN_VITERBI
+               : pass1_use_fsk ? RXR_CHAIN_FSK : RXR_CHAIN_IQ,
+        .mp = &mp,
+        .opts = &opts,
+        .sync_max_ham = sync_max_ham,
+        .allow_partial_rs = allow_partial_rs,
+        .sps = sps,
+        .samples = samples,
+        .n_frames = n_frames,
+        .iq_mode = iq_mode,
+        .window_samples = window_samples,
+        .slide_samples = slide_samples,
+        .bits_cap = bits_cap,
+        .bytes_cap = bytes_cap,
+        .p2_window_pairs = (size_t)(p2_window_s * (double)samp_rate),
+        .p2_pre_pairs = (size_t)(p2_pre_anchor_s * (double)samp_rate),
+    };
+
+    if (n_axes > 0) {
+        int rc = 0;
+        for (int a = 0; a < n_axes && !iq_mode; a++) {
+            if (axes[a].kind != RXR_AX_SYNC) {
+                fprintf(stderr, "rx_replay: --sweep %s needs an IQ input; "
+                        "FM audio sweeps sync-threshold only\n",
+                        RXR_AXIS_NAMES[axes[a].kind]);
+                rc = 1;
+            }
+        }
+        if (rc == 0)
+            rc = rxr_sweep_run(axes, n_axes, &dec, jobs, two_pass, csp_crc32,
+                               DEDUP_QUANT_SAMPLES, samp_rate, input_path);
+        free(bits_scratch); free(bytes_scratch); free(samples);
+        return rc;
+    }
+
     decode_loop_set_show_headers(show_packet_headers);
 
     char db_run_id[24];
@@ -1661,12 +2450,9 @@ int main(int argc, char **argv)
                 "the only thing to backfill would be session_dir\n");
     }
 
-    // Position-quantised dedup ring (mirrors rx_live).
-    enum { DEDUP_RING_SZ = 64 };
-    enum { DEDUP_QUANT_SAMPLES = 4800 };
-    uint64_t recent_pos_quant[DEDUP_RING_SZ] = {0};
-    int recent_idx = 0;
-    int recent_count = 0;
+    // Position-quantised dedup ring.
+    decode_loop_dedup_t dedup;
+    decode_loop_dedup_init(&dedup, DEDUP_QUANT_SAMPLES);
 
     // Same sizing rationale as rx_live: input_path can be long; the
     // TUI truncates to terminal width on render, so oversized is fine.
@@ -1708,6 +2494,7 @@ int main(int argc, char **argv)
     sigaction(SIGTERM, &sa, NULL);
 
     int n_emitted = 0;
+    rx_update_buf_t updates = {0};
     // Candidate frames handed to rx_emit_decoded across all passes,
     // before its position dedup. The gap to n_emitted is how many were
     // dropped as same-position duplicates.
@@ -1730,6 +2517,7 @@ int main(int argc, char **argv)
         .tle_id = tle_id,
         .session_dir = session_dir_buf,
         .db = db,
+        .updates = &updates,
         .log_path = log_path,
         .quiet = quiet,
         .use_tui = use_tui,
@@ -1741,106 +2529,59 @@ int main(int argc, char **argv)
         .force_beacon = force_beacon,
         .ref_buf = ref_buf_len > 0 ? ref_buf : NULL,
         .ref_buf_len = ref_buf_len,
-        .recent_pos_quant = recent_pos_quant,
-        .recent_idx = &recent_idx,
-        .recent_count = &recent_count,
-        .dedup_ring_sz = DEDUP_RING_SZ,
-        .dedup_quant_samples = DEDUP_QUANT_SAMPLES,
+        .dedup = &dedup,
         .n_emitted_p = &n_emitted,
     };
 
-    // Pass 1: the original sliding-window decode. In iq_mode the
-    // default chain is modem_iq (complex-differential slicer with
-    // 2nd-power bias removal) — same chain the live rx_session uses,
-    // so "rx_replay on the .iq" reproduces live decodes by default.
-    // FrontierSat's modulation is MSK h=0.5 (dev=2400 Hz at 9600 baud)
-    // — modem_iq's MSK-tuned arg(z[n]·conj(z[n-sps])) front-end is the
-    // right match. Set RX_REPLAY_USE_FSK=1 to switch to modem_fsk's
-    // FM-discriminator chain (modulation-index-agnostic; preferred
-    // when the bird is not MSK). When two_pass is on, pass-1 always
-    // uses the slicer family — the Viterbi runs in pass 2.
-    //
+    // Pass 1: the sliding-window decode, on the chain picked above.
     // Skipped entirely when --anchor-csv is set: anchored-decode mode
     // is "decode only the boxed parts", not "boxed parts in addition
     // to a full sweep".
-    int pass1_use_viterbi = (iq_mode && two_pass) ? 0 : use_viterbi;
-    int pass1_use_fsk = iq_mode && getenv("RX_REPLAY_USE_FSK") != NULL
-                        && !pass1_use_viterbi;
     int anchored_only = (anchor_csv_arg != NULL);
+    size_t n_segs_run = 0;
+    if (jobs > 1 && !anchored_only) {
+        rxr_segment_t *segs = rxr_run_segments(&dec, 1, jobs, &n_segs_run);
+        if (segs == NULL && rxr_n_windows(&dec) > 0) {
+            fprintf(stderr, "rx_replay: --jobs: out of memory collecting "
+                    "pass-1 frames\n");
+            if (use_tui) rx_tui_close();
+            update_buf_free(&updates);
+            free(bits_scratch); free(bytes_scratch); free(samples);
+            return forensics ? forensics_fail(fn_json,
+                "out of memory collecting segment decodes") : 1;
+        }
+        for (size_t k = 0; k < n_segs_run; k++) {
+            for (size_t i = 0; i < segs[k].n; i++) {
+                rxr_cand_t *c = &segs[k].v[i];
+                raw_decodes++;
+                rx_emit_decoded(&ectx, c->asm_abs, c->packet, c->plen,
+                                c->golay_errs, c->hmac_ok, c->rs_errs,
+                                c->used_golay_len, c->rs_locs);
+            }
+            if (use_tui && rx_tui_tick()) {
+                rxr_segments_free(segs, n_segs_run);
+                goto done;
+            }
+        }
+        rxr_segments_free(segs, n_segs_run);
+    }
     for (size_t window_start = 0;
          window_start + window_samples <= n_frames && !g_stop
-         && !anchored_only;
+         && !anchored_only && jobs <= 1;
          window_start += slide_samples)
     {
-        // PCM windows index by sample; IQ windows index by pair, where
-        // each pair occupies 2 int16s in the underlying buffer.
-        const int16_t *win = iq_mode
-            ? samples + window_start * 2u
-            : samples + window_start;
         size_t inner_min_offset = 0;
-        for (;;) {
-            ssize_t plen = -1;
-            int golay_errs = 0, hmac_ok = -1;
-            int rs_errs = -1, used_golay_len = -1;
-            int rs_locs[32];
-            size_t sync_off_local = 0;
-            int decoded;
-            if (iq_mode && pass1_use_viterbi) {
-                decoded = try_decode_window_viterbi(
-                    win, window_samples, &mp, &opts,
-                    sync_max_ham, allow_partial_rs,
-                    inner_min_offset,
-                    bits_scratch, bits_cap,
-                    bytes_scratch, bytes_cap,
-                    packet, sizeof packet,
-                    &plen, &golay_errs, &hmac_ok,
-                    &rs_errs, &used_golay_len,
-                    &sync_off_local, rs_locs);
-            } else if (iq_mode && pass1_use_fsk) {
-                decoded = try_decode_window_fsk(
-                    win, window_samples, &mp, &opts,
-                    sync_max_ham, allow_partial_rs,
-                    inner_min_offset,
-                    bits_scratch, bits_cap,
-                    bytes_scratch, bytes_cap,
-                    packet, sizeof packet,
-                    &plen, &golay_errs, &hmac_ok,
-                    &rs_errs, &used_golay_len,
-                    &sync_off_local, rs_locs);
-            } else if (iq_mode) {
-                decoded = try_decode_window_iq(
-                    win, window_samples, &mp, &opts,
-                    sync_max_ham, allow_partial_rs,
-                    inner_min_offset,
-                    bits_scratch, bits_cap,
-                    bytes_scratch, bytes_cap,
-                    packet, sizeof packet,
-                    &plen, &golay_errs, &hmac_ok,
-                    &rs_errs, &used_golay_len,
-                    &sync_off_local, rs_locs);
-            } else {
-                decoded = try_decode_window(
-                    win, window_samples, &mp, &opts,
-                    sync_max_ham, allow_partial_rs,
-                    inner_min_offset,
-                    bits_scratch, bits_cap,
-                    bytes_scratch, bytes_cap,
-                    packet, sizeof packet,
-                    &plen, &golay_errs, &hmac_ok,
-                    &rs_errs, &used_golay_len,
-                    &sync_off_local, rs_locs);
-            }
-            if (!decoded) break;
+        size_t sync_off_local = 0;
+        rxr_cand_t c;
+        while (rxr_decode_at(&dec, window_start, inner_min_offset,
+                             bits_scratch, bytes_scratch,
+                             packet, sizeof packet, &c, &sync_off_local)) {
             inner_min_offset = sync_off_local + 1;
-            if (plen < 4 || (size_t)plen > sizeof packet) continue;
-
-            uint64_t asm_abs_sample = (uint64_t)window_start
-                + (uint64_t)sync_off_local * (uint64_t)sps
-                + (uint64_t)(sps / 2);
+            if (!c.decoded) continue;
             raw_decodes++;
-            rx_emit_decoded(&ectx, asm_abs_sample, packet, plen,
-                            golay_errs, hmac_ok, rs_errs,
-                            used_golay_len, rs_locs);
+            rx_emit_decoded(&ectx, c.asm_abs, packet, c.plen,
+                            c.golay_errs, c.hmac_ok, c.rs_errs,
+                            c.used_golay_len, c.rs_locs);
         }
         if (use_tui && rx_tui_tick()) goto done;
     }
@@ -1850,93 +2591,57 @@ int main(int argc, char **argv)
     // pass-1 didn't already emit. Only meaningful in iq_mode with
     // --no-two-pass not set. Tight window so the Viterbi's 4th-power
     // φ_0 estimate is dominated by signal rather than the seconds of
-    // silence around each burst.
+    // silence around each burst. With --jobs the workers retry every
+    // sync up front and the merge drops the ones the ring has seen.
     int p2_attempts = 0, p2_emitted = 0;
-    if (iq_mode && two_pass && !g_stop && !anchored_only) {
-        // Tight Viterbi window: one max-length AX100 frame plus
-        // pre-ASM cushion for M&M timing-loop settling.
-        // Max AX100 payload = ~256 B RS-coded + framing ≈ 2300 bits
-        // ≈ 240 ms @ 9600 baud. Pre-ASM cushion = 50 ms.
-        const double p2_window_s = 0.40;
-        const double p2_pre_anchor_s = 0.05;
-        const size_t p2_window_pairs =
-            (size_t)(p2_window_s * (double)samp_rate);
-        const size_t p2_pre_pairs    =
-            (size_t)(p2_pre_anchor_s * (double)samp_rate);
-
+    if (iq_mode && two_pass && !g_stop && !anchored_only && jobs > 1) {
+        size_t n_segs = 0;
+        rxr_segment_t *segs = rxr_run_segments(&dec, 2, jobs, &n_segs);
+        if (segs == NULL && rxr_n_windows(&dec) > 0) {
+            fprintf(stderr, "rx_replay: --jobs: out of memory collecting "
+                    "pass-2 candidates; pass 2 skipped\n");
+        }
+        for (size_t k = 0; k < n_segs; k++) {
+            for (size_t i = 0; i < segs[k].n; i++) {
+                rxr_cand_t *c = &segs[k].v[i];
+                if (decode_loop_dedup_seen(ectx.dedup, c->key) || !c->attempted) continue;
+                ++p2_attempts;
+                if (!c->decoded) continue;
+                raw_decodes++;
+                if (rx_emit_decoded(&ectx, c->asm_abs, c->packet, c->plen,
+                                    c->golay_errs, c->hmac_ok, c->rs_errs,
+                                    c->used_golay_len, c->rs_locs)) {
+                    ++p2_emitted;
+                }
+            }
+            if (use_tui && rx_tui_tick()) {
+                rxr_segments_free(segs, n_segs);
+                goto done;
+            }
+        }
+        rxr_segments_free(segs, n_segs);
+    } else if (iq_mode && two_pass && !g_stop && !anchored_only) {
         for (size_t window_start = 0;
              window_start + window_samples <= n_frames && !g_stop;
              window_start += slide_samples)
         {
-            const int16_t *win = samples + window_start * 2u;
             size_t inner_min = 0;
+            uint64_t asm_abs_sample = 0;
             for (int tries = 0; tries < 64; ++tries) {
-                size_t n_bits_sym = 0, sync_off_bits = 0;
-                int polarity_used = -1;
-                int rc = modem_fsk_iq_to_bits(win, window_samples, &mp,
-                                          0, sync_max_ham, inner_min,
-                                          bits_scratch, &n_bits_sym,
-                                          &sync_off_bits, &polarity_used);
-                if (rc != 0) break;
-                inner_min = sync_off_bits + 1;
-
-                uint64_t asm_abs_sample = (uint64_t)window_start
-                    + (uint64_t)sync_off_bits * (uint64_t)sps
-                    + (uint64_t)(sps / 2);
-                uint64_t pos_quant = asm_abs_sample / DEDUP_QUANT_SAMPLES;
-                int seen = 0;
-                int ring_n = recent_count < DEDUP_RING_SZ
-                    ? recent_count : DEDUP_RING_SZ;
-                for (int r = 0; r < ring_n; ++r) {
-                    if (recent_pos_quant[r] == pos_quant) { seen = 1; break; }
-                }
-                if (seen) continue;
-
-                // Anchor a tight window around the candidate ASM.
-                uint64_t tight_start = (asm_abs_sample > (uint64_t)p2_pre_pairs)
-                    ? (asm_abs_sample - (uint64_t)p2_pre_pairs) : 0;
-                if (tight_start + p2_window_pairs > n_frames) {
-                    tight_start = (n_frames > p2_window_pairs)
-                        ? (n_frames - p2_window_pairs) : 0;
-                }
-                size_t tw_pairs = (tight_start + p2_window_pairs <= n_frames)
-                    ? p2_window_pairs : (n_frames - (size_t)tight_start);
-                if (tw_pairs < (size_t)(64 * sps)) continue;
-                const int16_t *tw = samples + tight_start * 2u;
-
-                ssize_t plen2 = -1;
-                int golay2 = 0, hmac2 = -1, rs2 = -1, glen2 = -1;
-                int rs_locs2[32];
-                size_t sync_off2 = 0;
-                // Pass-2 retry uses the FSK chain on a tight window
-                // centered on the sync candidate. The tight window
-                // lets AGC + HPF settle on signal-dominated samples
-                // rather than mostly-noise — sometimes recovers a
-                // frame that pass-1's wide-window FSK partial-RS'd
-                // or that pass-1 missed entirely. The Viterbi MLSE
-                // is reserved for h=0.5 AWGN tests where its 2 dB
-                // coherent gain matters; on FrontierSat's h≈2/3 FSK
-                // its 4-state trellis is wrong and finds zero syncs.
-                int dec2 = try_decode_window_fsk(
-                    tw, tw_pairs, &mp, &opts,
-                    sync_max_ham, allow_partial_rs,
-                    0,
-                    bits_scratch, bits_cap,
-                    bytes_scratch, bytes_cap,
-                    packet, sizeof packet,
-                    &plen2, &golay2, &hmac2,
-                    &rs2, &glen2,
-                    &sync_off2, rs_locs2);
+                if (!rxr_p2_next_sync(&dec, window_start, &inner_min,
+                                      bits_scratch, &asm_abs_sample))
+                    break;
+                if (decode_loop_dedup_seen(ectx.dedup, asm_abs_sample)) continue;
+                rxr_cand_t c;
+                rxr_p2_retry(&dec, asm_abs_sample, bits_scratch, bytes_scratch,
+                             packet, sizeof packet, &c);
+                if (!c.attempted) continue;
                 ++p2_attempts;
-                if (!dec2) continue;
-                if (plen2 < 4 || (size_t)plen2 > sizeof packet) continue;
-
-                uint64_t asm_abs_v = tight_start
-                    + (uint64_t)sync_off2 * (uint64_t)sps
-                    + (uint64_t)(sps / 2);
+                if (!c.decoded) continue;
                 raw_decodes++;
-                if (rx_emit_decoded(&ectx, asm_abs_v, packet, plen2,
-                                    golay2, hmac2, rs2, glen2, rs_locs2)) {
+                if (rx_emit_decoded(&ectx, c.asm_abs, packet, c.plen,
+                                    c.golay_errs, c.hmac_ok, c.rs_errs,
+                                    c.used_golay_len, c.rs_locs)) {
                     ++p2_emitted;
                 }
             }
@@ -2086,6 +2791,12 @@ done:
     int    db_flush_rc  = packet_db_flush(db);
     long   db_flush_lost =
         (db_flush_rc != PACKET_DB_INSERT_OK) ? (long)db_pending : 0;
+    // --update: apply the file's queued backfills, also all-or-nothing.
+    long db_update_lost = 0;
+    if (updates.n > 0
+        && packet_db_update_observer_many(db, updates.v, updates.n, /*force=*/0) < 0)
+        db_update_lost = (long) updates.n;
+    update_buf_free(&updates);
 
     // --forensics-report keeps stdout a clean JSON stream and stays
     // silent on stderr too — the decode summary below is suppressed so
@@ -2108,7 +2819,8 @@ done:
         }
         decode_loop_stats_t st;
         decode_loop_get_stats(&st);
-        long db_failed = st.db_busy + st.db_error + db_flush_lost;
+        long db_failed = st.db_busy + st.db_error + db_flush_lost
+                       + db_update_lost;
         fprintf(stderr, "rx_replay: decode summary (chain=%s):\n", chain);
         fprintf(stderr, "  candidate frames (pre-dedup)   : %ld\n", raw_decodes);
         const char *db_note = !db ? "— DB not written"
@@ -2142,6 +2854,11 @@ done:
                     "tried %d candidate(s) and rescued %d.\n",
                     pass1_n_emitted, p2_attempts, p2_emitted);
         }
+        if (n_segs_run > 0) {
+            fprintf(stderr,
+                    "rx_replay: --jobs=%d decoded %zu segment(s) in parallel.\n",
+                    jobs, n_segs_run);
+        }
     }
     // --forensics-report always produces at least one JSON line per file:
     // a file that decoded nothing still emits a filename-only object so a
@@ -2162,7 +2879,10 @@ done:
     // stay 0 and this path returns 0.
     decode_loop_stats_t fin;
     decode_loop_get_stats(&fin);
-    long db_failed = fin.db_busy + fin.db_error + db_flush_lost;
+    long db_failed = fin.db_busy + fin.db_error + db_flush_lost + db_update_lost;
+    if (db_update_lost > 0)
+        fprintf(stderr, "rx_replay: the --update backfill of %ld packet(s) "
+                "was not applied.\n", db_update_lost);
     if (db_failed > 0) {
         fprintf(stderr,
                 "rx_replay: %ld decoded packet(s) were NOT stored "
@@ -12,8 +12,10 @@
 
     Correlation key: the satellite echoes a command's @tssent value
     (ts_sent, unix-ms) in every response, stored as 8 little-endian bytes
-    at offset 1 of a tcmd_response payload. Matching is the same
-    substr(payload,2,8) blob-equality packet_browser uses.
+    at offset 1 of a tcmd_response payload. Schema V6 also stores it in
+    the indexed packet.resp_ts_sent_ms column, which both the response
+    counts and the response view join on; an older DB falls back to the
+    substr(payload,2,8) blob-equality packet_browser uses there too.
 
     Copyright (C) 2026  Johnathan K Burchill
 
@@ -121,10 +123,21 @@ static resp_t resps[MAX_RESP];
 static int    resp_n = 0, resp_sel = 0, resp_top = 0;
 static char   resp_header[768] = "";
 
-// Sorted index of every tcmd_response's ts_sent, so a command's response
-// count is a binary-search bounds lookup rather than a per-row scan.
-static uint64_t g_resp_ts[MAX_RESP_TS];
-static int      g_resp_ts_n = 0;
+// The DB carries the V6 resp_ts_sent_ms column (probed once at start-up):
+// response counts come from one grouped query over its index and the
+// g_resp_ts index below is never built.
+static int           g_have_resp_ts = 0;
+// Pre-V6 fallback: sorted index of every tcmd_response's ts_sent, so a
+// command's response count is a binary-search bounds lookup rather than a
+// per-row scan. Built incrementally: packet.id is AUTOINCREMENT, so g_resp_hw_id marks how far
+// the index has read and each refresh only decodes the responses after it.
+static uint64_t      g_resp_ts[MAX_RESP_TS];
+static int           g_resp_ts_n = 0;
+static sqlite3_int64 g_resp_hw_id = 0;
+// PRAGMA data_version at the last poll; it changes whenever another
+// connection (a receiver, tcmd_import) commits, so an idle poll is one
+// pragma instead of a full reload.
+static sqlite3_int64 g_data_version = -1;
 
 enum {
     PAIR_BAR = 1, PAIR_SEL, PAIR_DIM, PAIR_OK, PAIR_ERR, PAIR_NONE,
@@ -149,32 +162,56 @@ static int cmp_u64(const void *a, const void *b)
     return (x > y) - (x < y);
 }
 
-// Scan every tcmd_response payload once, decode its ts_sent (8 LE bytes
-// at offset 1), and build a sorted array so resp_count_for() is a fast
-// bounds lookup.
+// Decode the ts_sent (8 LE bytes at offset 1) of every tcmd_response
+// added since the last call and fold it into the sorted array, so
+// resp_count_for() stays a fast bounds lookup. The first call reads them
+// all; after that a poll only touches the new responses
+// (idx_packet_type's implicit rowid tail makes "id > ?" a range seek).
 static void build_resp_index(sqlite3 *db)
 {
-    g_resp_ts_n = 0;
+    static int warned = 0;
     sqlite3_stmt *st = NULL;
     if (sqlite3_prepare_v2(db,
-            "SELECT payload FROM packet WHERE " TCMD_RESP_SQL_IS, -1, &st, NULL)
+            "SELECT id, payload FROM packet WHERE " TCMD_RESP_SQL_IS
+            " AND id > ?1 ORDER BY id", -1, &st, NULL)
         != SQLITE_OK) return;
+    sqlite3_bind_int64(st, 1, g_resp_hw_id);
+    int added = 0;
     while (g_resp_ts_n < MAX_RESP_TS && sqlite3_step(st) == SQLITE_ROW) {
-        const uint8_t *pl = sqlite3_column_blob(st, 0);
-        int n = sqlite3_column_bytes(st, 0);
+        g_resp_hw_id = sqlite3_column_int64(st, 0);
+        const uint8_t *pl = sqlite3_column_blob(st, 1);
+        int n = sqlite3_column_bytes(st, 1);
         uint64_t v = 0;
         if (tcmd_resp_ts_sent_u64(pl, (size_t) n, &v) != 0) continue;
         g_resp_ts[g_resp_ts_n++] = v;
+        added++;
     }
     // If we stopped on the cap rather than running out of rows, the response
-    // counts shown for some commands will be undercounted — say so instead of
-    // silently truncating the index.
-    if (g_resp_ts_n == MAX_RESP_TS && sqlite3_step(st) == SQLITE_ROW) {
+    // counts shown for some commands will be undercounted — say so (once)
+    // instead of silently truncating the index.
+    if (!warned && g_resp_ts_n == MAX_RESP_TS && sqlite3_step(st) == SQLITE_ROW) {
         fprintf(stderr, "tcmd_browser: response index hit the %d-entry cap; "
                 "response counts may be undercounted.\n", MAX_RESP_TS);
+        warned = 1;
     }
     sqlite3_finalize(st);
-    qsort(g_resp_ts, g_resp_ts_n, sizeof g_resp_ts[0], cmp_u64);
+    if (added > 0)
+        qsort(g_resp_ts, g_resp_ts_n, sizeof g_resp_ts[0], cmp_u64);
+}
+
+// 1 if another connection has committed since the last call (or on the
+// first call / a failed read, so the caller errs toward refreshing).
+static int db_changed(sqlite3 *db)
+{
+    sqlite3_stmt *st = NULL;
+    sqlite3_int64 dv = -1;
+    if (sqlite3_prepare_v2(db, "PRAGMA data_version", -1, &st, NULL) == SQLITE_OK) {
+        if (sqlite3_step(st) == SQLITE_ROW) dv = sqlite3_column_int64(st, 0);
+        sqlite3_finalize(st);
+    }
+    if (dv >= 0 && dv == g_data_version) return 0;
+    g_data_version = dv;
+    return 1;
 }
 
 // Count responses for a ts_sent via lower/upper bound on the sorted index.
@@ -193,16 +230,27 @@ static int resp_count_for(uint64_t ts)
 static void run_query(sqlite3 *db)
 {
     sqlite3_int64 prev_id = (n_rows > 0) ? rows[sel].id : -1;
-    build_resp_index(db);
+    if (!g_have_resp_ts) build_resp_index(db);
 
-    char sql[512];
+    char sql[1024];
     // Clamp off after each append: a truncated snprintf returns the would-be
     // length, leaving off past sizeof sql so the next "sizeof sql - off"
     // (size_t) wraps huge and sql + off goes out of bounds.
+    //
+    // On a V6 DB the counts join in from one GROUP BY over the
+    // idx_packet_resp_ts partial index (index-only, no payload reads), and
+    // the response filter becomes a WHERE term so the LIMIT applies after
+    // it. Column 9 is -1 on an older DB: count from g_resp_ts instead.
     int off = snprintf(sql, sizeof sql,
         "SELECT id, ts_sent_ms, tsexec_ms, command_text, tx_freq_hz, "
-        "tx_gain_db, source_tool, source_run, ts_transmitted "
-        "FROM sent_tcmd WHERE 1=1");
+        "tx_gain_db, source_tool, source_run, ts_transmitted, %s "
+        "FROM sent_tcmd%s WHERE 1=1",
+        g_have_resp_ts ? "IFNULL(c.n, 0)" : "-1",
+        g_have_resp_ts
+            ? " LEFT JOIN (SELECT " PACKET_DB_RESP_TS_COL " AS k, COUNT(*) AS n "
+              "FROM packet WHERE " PACKET_DB_RESP_TS_COL " IS NOT NULL "
+              "GROUP BY " PACKET_DB_RESP_TS_COL ") c ON c.k = ts_sent_ms"
+            : "");
     if (off < 0 || off > (int) sizeof sql) off = (int) sizeof sql;
     char like_pattern[256];
     int have_like = (like_text[0] != '\0');
@@ -212,6 +260,11 @@ static void run_query(sqlite3 *db)
                         " AND command_text LIKE ?1");
         if (off > (int) sizeof sql) off = (int) sizeof sql;
     }
+    if (g_have_resp_ts && resp_filter != 0) {
+        off += snprintf(sql + off, sizeof sql - off, " AND IFNULL(c.n, 0) %s 0",
+                        resp_filter == 1 ? ">" : "=");
+        if (off > (int) sizeof sql) off = (int) sizeof sql;
+    }
     snprintf(sql + off, sizeof sql - off,
              " ORDER BY ts_transmitted DESC LIMIT %d", MAX_ROWS);
 
@@ -240,10 +293,11 @@ static void run_query(sqlite3 *db)
         snprintf(r->tool,  sizeof r->tool,  "%s", tool ? tool : "");
         snprintf(r->run,   sizeof r->run,   "%s", run  ? run  : "");
         snprintf(r->ts_tx, sizeof r->ts_tx, "%s", tx   ? tx   : "");
-        int rc = resp_count_for(r->ts_sent_ms);
-        // Apply the response filter here (the count isn't a DB column, so
-        // it can't go in the WHERE clause); skipping just leaves the slot
-        // for the next row.
+        int rc = g_have_resp_ts ? sqlite3_column_int(st, 9)
+                                : resp_count_for(r->ts_sent_ms);
+        // Pre-V6, apply the response filter here (the count isn't a DB
+        // column, so it can't go in the WHERE clause); skipping just leaves
+        // the slot for the next row. A no-op when the SQL already filtered.
         if ((resp_filter == 1 && rc == 0) || (resp_filter == 2 && rc > 0))
             continue;
         r->resp_count = rc;
@@ -268,12 +322,18 @@ static void open_responses(sqlite3 *db)
     tcmd_resp_key_from_u64(c->ts_sent_ms, key);
 
     sqlite3_stmt *st = NULL;
-    if (sqlite3_prepare_v2(db,
-            "SELECT id, ts_received, payload FROM packet "
-            "WHERE " TCMD_RESP_SQL_IS " AND " TCMD_RESP_SQL_TS_SENT "=?1 "
-            "ORDER BY " TCMD_RESP_SQL_SEQ ", ts_received", -1, &st, NULL)
+    if (sqlite3_prepare_v2(db, g_have_resp_ts
+            ? "SELECT id, ts_received, payload FROM packet "
+              "WHERE " PACKET_DB_RESP_TS_COL "=?1 "
+              "ORDER BY " TCMD_RESP_SQL_SEQ ", ts_received"
+            : "SELECT id, ts_received, payload FROM packet "
+              "WHERE " TCMD_RESP_SQL_IS " AND " TCMD_RESP_SQL_TS_SENT "=?1 "
+              "ORDER BY " TCMD_RESP_SQL_SEQ ", ts_received", -1, &st, NULL)
         == SQLITE_OK) {
-        sqlite3_bind_blob(st, 1, key, 8, SQLITE_TRANSIENT);
+        if (g_have_resp_ts)
+            sqlite3_bind_int64(st, 1, (sqlite3_int64) c->ts_sent_ms);
+        else
+            sqlite3_bind_blob(st, 1, key, 8, SQLITE_TRANSIENT);
         while (resp_n < MAX_RESP && sqlite3_step(st) == SQLITE_ROW) {
             resp_t *e = &resps[resp_n];
             e->id = sqlite3_column_int64(st, 0);
@@ -590,6 +650,14 @@ int main(int argc, char **argv)
         return 1;
     }
     sqlite3_busy_timeout(db, 5000);
+    {
+        sqlite3_stmt *probe = NULL;
+        if (sqlite3_prepare_v2(db, PACKET_DB_SQL_HAS_RESP_TS, -1, &probe, NULL)
+            == SQLITE_OK) {
+            g_have_resp_ts = sqlite3_step(probe) == SQLITE_ROW;
+            sqlite3_finalize(probe);
+        }
+    }
 
     if (initscr() == NULL) {
         sqlite3_close(db);
@@ -614,6 +682,7 @@ int main(int argc, char **argv)
         g_have_color = 1;
     }
 
+    db_changed(db);   // prime the poll's baseline
     run_query(db);
     double last_query = monotonic_seconds();
     int quit = 0;
@@ -688,10 +757,12 @@ int main(int argc, char **argv)
         }
 
         // 1 Hz auto-poll of the command list (suspended in the responses
-        // view so it doesn't reshuffle under the operator).
+        // view so it doesn't reshuffle under the operator). Skipped
+        // outright when nothing has committed since the last poll.
         double now = monotonic_seconds();
         if (!in_resp && now - last_query >= 1.0) {
-            run_query(db); last_query = now;
+            if (db_changed(db)) run_query(db);
+            last_query = now;
         }
     }
 